@@ -120,6 +120,12 @@ namespace mitk
   * calls ensure that the necessary options are given to the configuration file, and that the initialization
   * of the quantifier is done correctly. This ensures an consistend behavior over all FeatureGeneration Classes.
   *
+  * If several feature classes are calculated for the same image, they can share an IntensityExtremaCache
+  * (<b>SetIntensityExtremaCache</b>), so the extrema that are needed for the initialization of the quantifier are
+  * determined only once. The feature classes do not share any other state, so different feature classes can be
+  * calculated concurrently (<b>CalculateFeatureClasses</b>). They must not use the same image objects though:
+  * feature classes access non-const images, which locks them exclusively for the whole calculation.
+  *
   */
 class MITKCLCORE_EXPORT AbstractGlobalImageFeature : public BaseData
 {
@@ -150,6 +156,21 @@ public:
   */
   virtual void CalculateFeaturesUsingParameters(const Image::Pointer & feature, const Image::Pointer &mask, const Image::Pointer &maskNoNAN, FeatureListType &featureList) = 0;
 
+  /**
+  * \brief Calculates the given feature classes with CalculateFeaturesUsingParameters on numberOfThreads threads
+  * (0 uses the ITK default).
+  *
+  * Each feature class writes to its own list, so the order of the features is the same as for a sequential
+  * calculation. Every additional thread works on its own copies of image, masks and morphological masks, as the
+  * feature classes lock the images they access (in different orders). The copies are registered in the
+  * IntensityExtremaCache of the feature classes. An exception of a feature class is rethrown after all threads
+  * finished.
+  */
+  static void CalculateFeatureClasses(const std::vector<AbstractGlobalImageFeature::Pointer> &features,
+                                      const Image::Pointer &feature, const Image::Pointer &mask, const Image::Pointer &maskNoNAN,
+                                      unsigned int numberOfThreads,
+                                      std::vector<FeatureListType> &featureLists, std::vector<double> &featureTimes);
+
   /**
   * \brief Returns a list of the names of all features that are calculated from this class
   */
@@ -188,6 +209,13 @@ public:
   itkSetMacro(Quantifier, IntensityQuantifier::Pointer);
   itkGetMacro(Quantifier, IntensityQuantifier::Pointer);
 
+  /**
+  * \brief Cache for the intensity extrema that is passed to the quantifier. Feature classes that share
+  * a cache do not scan the same image / mask combination again.
+  */
+  itkSetMacro(IntensityExtremaCache, IntensityExtremaCache::Pointer);
+  itkGetConstMacro(IntensityExtremaCache, IntensityExtremaCache::Pointer);
+
   itkGetConstMacro(Direction, int);
 
   itkSetMacro(MinimumIntensity, double);
@@ -265,6 +293,7 @@ private:
 
   bool m_UseQuantifier = false;
   IntensityQuantifier::Pointer m_Quantifier;
+  IntensityExtremaCache::Pointer m_IntensityExtremaCache;
 
   double m_MinimumIntensity = 0;
   bool m_UseMinimumIntensity = false;
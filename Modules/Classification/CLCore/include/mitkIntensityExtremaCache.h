@@ -0,0 +1,96 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+
+#ifndef mitkIntensityExtremaCache_h
+#define mitkIntensityExtremaCache_h
+
+#include <MitkCLCoreExports.h>
+
+#include <mitkImage.h>
+
+#include <itkObject.h>
+
+#include <future>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace mitk
+{
+  /**
+  * \brief Shares the intensity minima and maxima of images (optionally restricted to a mask) between
+  * several IntensityQuantifier.
+  *
+  * Every feature class initializes its own quantifier and most initialization methods scan the
+  * image for its extrema. If all feature classes of an image get the same cache, every image / mask
+  * combination is scanned only once. The cache can be used concurrently by several threads; if
+  * the extrema are requested while another thread computes them, the call waits for the result.
+  *
+  * Images are identified by their pointer and modification time. The cache keeps references to
+  * the images, so it should be cleared (or released) if the images are not needed anymore.
+  *
+  * Copies of an image (e.g. the copies of a thread that must not lock the original) can be registered
+  * with AddCopy(), so they share the extrema of the original as long as neither of them is modified.
+  */
+  class MITKCLCORE_EXPORT IntensityExtremaCache : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(IntensityExtremaCache, itk::Object)
+    itkFactorylessNewMacro(Self)
+
+    /**
+    * \brief Returns the extrema of the image. If mask is not null, only voxels with a mask value > 0 are considered.
+    */
+    void GetExtrema(const Image::Pointer &image, const Image::Pointer &mask, double &minimum, double &maximum);
+
+    /**
+    * \brief Registers copy as a copy of original with identical pixels. Requests for the copy return the
+    * extrema of the original until the copy is modified.
+    */
+    void AddCopy(const Image::Pointer &original, const Image::Pointer &copy);
+
+    void Clear();
+
+  protected:
+    IntensityExtremaCache() = default;
+    ~IntensityExtremaCache() override = default;
+
+  private:
+    typedef std::pair<const Image *, const Image *> KeyType;
+
+    struct Entry
+    {
+      Image::ConstPointer m_Image;
+      Image::ConstPointer m_Mask;
+      itk::ModifiedTimeType m_ImageMTime;
+      itk::ModifiedTimeType m_MaskMTime;
+      std::shared_future<std::pair<double, double>> m_Extrema;
+    };
+
+    struct Copy
+    {
+      Image::ConstPointer m_Original;
+      Image::ConstPointer m_Copy;
+      itk::ModifiedTimeType m_CopyMTime;
+    };
+
+    /** Returns the original of an unmodified copy or the image itself. Must be called with m_Mutex locked. */
+    const Image *GetOriginal(const Image *image) const;
+
+    std::mutex m_Mutex;
+    std::map<KeyType, Entry> m_Entries;
+    std::map<const Image *, Copy> m_Copies;
+  };
+}
+
+#endif //mitkIntensityExtremaCache_h
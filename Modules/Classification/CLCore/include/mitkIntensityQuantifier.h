@@ -18,6 +18,7 @@ found in the LICENSE file.
 
 #include <mitkBaseData.h>
 #include <mitkImage.h>
+#include <mitkIntensityExtremaCache.h>
 
 namespace mitk
 {
@@ -51,6 +52,17 @@ public:
   double IndexToMeanIntensity(unsigned int index);
   double IndexToMaximumIntensity(unsigned int index);
 
+  /**
+  * \brief If set, the extrema of the images are taken from (and stored in) the cache instead of scanning the image.
+  */
+  itkSetMacro(ExtremaCache, IntensityExtremaCache::Pointer);
+  itkGetConstMacro(ExtremaCache, IntensityExtremaCache::Pointer);
+
+  /**
+  * \brief Calculates the extrema of the image. If mask is not null, only voxels with a mask value > 0 are considered.
+  */
+  static void CalculateExtrema(const mitk::Image::Pointer &image, const mitk::Image::Pointer &mask, double &minimum, double &maximum);
+
   itkGetConstMacro(Initialized, bool);
   itkGetConstMacro(Bins, unsigned int);
   itkGetConstMacro(Binsize, double);
@@ -79,11 +91,14 @@ public:
 
 
 private:
+  void GetExtrema(const mitk::Image::Pointer &image, const mitk::Image::Pointer &mask, double &minimum, double &maximum);
+
   bool m_Initialized;
   unsigned int m_Bins;
   double m_Binsize;
   double m_Minimum;
   double m_Maximum;
+  IntensityExtremaCache::Pointer m_ExtremaCache;
 
 };
 }
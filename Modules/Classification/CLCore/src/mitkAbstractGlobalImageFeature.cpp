@@ -16,6 +16,17 @@ found in the LICENSE file.
 #include <mitkITKImageImport.h>
 #include <iterator>
 
+#include <itkMultiThreader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
 static void
 ExtractSlicesFromImages(mitk::Image::Pointer image, mitk::Image::Pointer mask,
   int direction,
@@ -228,6 +239,7 @@ void  mitk::AbstractGlobalImageFeature::InitializeQuantifierFromParameters(const
 void  mitk::AbstractGlobalImageFeature::InitializeQuantifier(const Image::Pointer & feature, const Image::Pointer &mask, unsigned int defaultBins)
 {
   m_Quantifier = IntensityQuantifier::New();
+  m_Quantifier->SetExtremaCache(m_IntensityExtremaCache);
   if (GetUseMinimumIntensity() && GetUseMaximumIntensity() && GetUseBinsize())
     m_Quantifier->InitializeByBinsizeAndMaximum(GetMinimumIntensity(), GetMaximumIntensity(), GetBinsize());
   else if (GetUseMinimumIntensity() && GetUseBins() && GetUseBinsize())
@@ -400,3 +412,105 @@ mitk::AbstractGlobalImageFeature::FeatureListType mitk::AbstractGlobalImageFeatu
   std::copy(statStd.begin(), statStd.end(), std::back_inserter(result));
   return result;
 }
+
+void mitk::AbstractGlobalImageFeature::CalculateFeatureClasses(const std::vector<AbstractGlobalImageFeature::Pointer> &features,
+                                                                const Image::Pointer &feature, const Image::Pointer &mask, const Image::Pointer &maskNoNAN,
+                                                                unsigned int numberOfThreads,
+                                                                std::vector<FeatureListType> &featureLists, std::vector<double> &featureTimes)
+{
+  featureLists.assign(features.size(), FeatureListType());
+  featureTimes.assign(features.size(), 0.0);
+
+  if (numberOfThreads == 0)
+  {
+    numberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  }
+  numberOfThreads = std::max<unsigned int>(1, std::min<std::size_t>(numberOfThreads, features.size()));
+
+  // The first thread uses the given images, every other thread gets its own copies. The copies are created
+  // before the threads start, as copying needs read access to images that are locked by the feature classes.
+  std::vector<Image::Pointer> images = { feature, mask, maskNoNAN };
+  for (const auto &featureClass : features)
+  {
+    images.push_back(featureClass->GetMorphMask());
+  }
+  std::set<IntensityExtremaCache *> caches;
+  for (const auto &featureClass : features)
+  {
+    if (featureClass->GetIntensityExtremaCache().IsNotNull())
+    {
+      caches.insert(featureClass->GetIntensityExtremaCache().GetPointer());
+    }
+  }
+
+  std::vector<std::map<const Image *, Image::Pointer>> threadImages(numberOfThreads);
+  for (unsigned int thread = 0; thread < numberOfThreads; ++thread)
+  {
+    for (const auto &image : images)
+    {
+      if (image.IsNull() || threadImages[thread].count(image.GetPointer()) > 0)
+      {
+        continue;
+      }
+      Image::Pointer threadImage = image;
+      if (thread > 0)
+      {
+        threadImage = image->Clone();
+        for (auto cache : caches)
+        {
+          cache->AddCopy(image, threadImage);
+        }
+      }
+      threadImages[thread][image.GetPointer()] = threadImage;
+    }
+  }
+
+  std::atomic<std::size_t> nextFeature(0);
+  std::mutex errorMutex;
+  std::exception_ptr error;
+
+  auto worker = [&](unsigned int thread)
+  {
+    auto getImage = [&](const Image::Pointer &image) {
+      return image.IsNull() ? image : threadImages[thread].at(image.GetPointer());
+    };
+
+    for (std::size_t i = nextFeature++; i < features.size(); i = nextFeature++)
+    {
+      const Image::Pointer morphMask = features[i]->GetMorphMask();
+      try
+      {
+        features[i]->SetMorphMask(getImage(morphMask));
+        auto start = std::chrono::steady_clock::now();
+        features[i]->CalculateFeaturesUsingParameters(getImage(feature), getImage(mask), getImage(maskNoNAN), featureLists[i]);
+        featureTimes[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+        {
+          error = std::current_exception();
+        }
+        nextFeature = features.size();
+      }
+      features[i]->SetMorphMask(morphMask);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int thread = 1; thread < numberOfThreads; ++thread)
+  {
+    threads.emplace_back(worker, thread);
+  }
+  worker(0);
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
@@ -0,0 +1,93 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkIntensityExtremaCache.h>
+
+#include <mitkIntensityQuantifier.h>
+
+void mitk::IntensityExtremaCache::GetExtrema(const Image::Pointer &image, const Image::Pointer &mask, double &minimum, double &maximum)
+{
+  std::shared_future<std::pair<double, double>> extrema;
+  std::promise<std::pair<double, double>> promise;
+  bool calculate = false;
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    const KeyType key(this->GetOriginal(image.GetPointer()), this->GetOriginal(mask.GetPointer()));
+    const itk::ModifiedTimeType imageMTime = key.first->GetMTime();
+    const itk::ModifiedTimeType maskMTime = key.second != nullptr ? key.second->GetMTime() : 0;
+
+    auto entry = m_Entries.find(key);
+    if (entry != m_Entries.end() && entry->second.m_ImageMTime == imageMTime && entry->second.m_MaskMTime == maskMTime)
+    {
+      extrema = entry->second.m_Extrema;
+    }
+    else
+    {
+      Entry newEntry;
+      newEntry.m_Image = key.first;
+      newEntry.m_Mask = key.second;
+      newEntry.m_ImageMTime = imageMTime;
+      newEntry.m_MaskMTime = maskMTime;
+      newEntry.m_Extrema = promise.get_future().share();
+      extrema = newEntry.m_Extrema;
+      m_Entries[key] = newEntry;
+      calculate = true;
+    }
+  }
+
+  // The scan is done outside of the lock, so other images can be processed in the meantime.
+  if (calculate)
+  {
+    try
+    {
+      double calculatedMinimum, calculatedMaximum;
+      IntensityQuantifier::CalculateExtrema(image, mask, calculatedMinimum, calculatedMaximum);
+      promise.set_value(std::make_pair(calculatedMinimum, calculatedMaximum));
+    }
+    catch (...)
+    {
+      promise.set_exception(std::current_exception());
+    }
+  }
+
+  const std::pair<double, double> &result = extrema.get();
+  minimum = result.first;
+  maximum = result.second;
+}
+
+void mitk::IntensityExtremaCache::AddCopy(const Image::Pointer &original, const Image::Pointer &copy)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  Copy entry;
+  entry.m_Original = this->GetOriginal(original.GetPointer());
+  entry.m_Copy = copy.GetPointer();
+  entry.m_CopyMTime = copy->GetMTime();
+  m_Copies[copy.GetPointer()] = entry;
+}
+
+const mitk::Image *mitk::IntensityExtremaCache::GetOriginal(const Image *image) const
+{
+  auto copy = m_Copies.find(image);
+  if (copy != m_Copies.end() && copy->second.m_CopyMTime == image->GetMTime())
+  {
+    return copy->second.m_Original;
+  }
+  return image;
+}
+
+void mitk::IntensityExtremaCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Entries.clear();
+  m_Copies.clear();
+}
@@ -77,6 +77,30 @@ mitk::IntensityQuantifier::IntensityQuantifier() :
       m_Maximum(0)
 {}
 
+void mitk::IntensityQuantifier::CalculateExtrema(const mitk::Image::Pointer &image, const mitk::Image::Pointer &mask, double &minimum, double &maximum)
+{
+  if (mask.IsNull())
+  {
+    AccessByItk_2(image, CalculateImageMinMax, minimum, maximum);
+  }
+  else
+  {
+    AccessByItk_3(image, CalculateImageRegionMinMax, mask, minimum, maximum);
+  }
+}
+
+void mitk::IntensityQuantifier::GetExtrema(const mitk::Image::Pointer &image, const mitk::Image::Pointer &mask, double &minimum, double &maximum)
+{
+  if (m_ExtremaCache.IsNotNull())
+  {
+    m_ExtremaCache->GetExtrema(image, mask, minimum, maximum);
+  }
+  else
+  {
+    CalculateExtrema(image, mask, minimum, maximum);
+  }
+}
+
 void mitk::IntensityQuantifier::InitializeByMinimumMaximum(double minimum, double maximum, unsigned int bins) {
   m_Minimum = minimum;
   m_Maximum = maximum;
@@ -103,73 +127,73 @@ void mitk::IntensityQuantifier::InitializeByBinsizeAndMaximum(double minimum, do
 
 void mitk::IntensityQuantifier::InitializeByImage(mitk::Image::Pointer image, unsigned int bins) {
   double minimum, maximum;
-  AccessByItk_2(image, CalculateImageMinMax, minimum, maximum);
+  GetExtrema(image, nullptr, minimum, maximum);
   InitializeByMinimumMaximum(minimum, maximum, bins);
 }
 
 void mitk::IntensityQuantifier::InitializeByImageAndMinimum(mitk::Image::Pointer image, double minimum, unsigned int bins) {
   double tmp, maximum;
-  AccessByItk_2(image, CalculateImageMinMax, tmp, maximum);
+  GetExtrema(image, nullptr, tmp, maximum);
   InitializeByMinimumMaximum(minimum, maximum, bins);
 }
 
 void mitk::IntensityQuantifier::InitializeByImageAndMaximum(mitk::Image::Pointer image, double maximum, unsigned int bins) {
   double minimum, tmp;
-  AccessByItk_2(image, CalculateImageMinMax, minimum, tmp);
+  GetExtrema(image, nullptr, minimum, tmp);
   InitializeByMinimumMaximum(minimum, maximum, bins);
 }
 
 void mitk::IntensityQuantifier::InitializeByImageRegion(mitk::Image::Pointer image, mitk::Image::Pointer mask, unsigned int bins) {
   double minimum, maximum;
-  AccessByItk_3(image, CalculateImageRegionMinMax, mask, minimum, maximum);
+  GetExtrema(image, mask, minimum, maximum);
   InitializeByMinimumMaximum(minimum, maximum, bins);
 }
 
 void mitk::IntensityQuantifier::InitializeByImageRegionAndMinimum(mitk::Image::Pointer image, mitk::Image::Pointer mask, double minimum, unsigned int bins) {
   double tmp, maximum;
-  AccessByItk_3(image, CalculateImageRegionMinMax, mask, tmp, maximum);
+  GetExtrema(image, mask, tmp, maximum);
   InitializeByMinimumMaximum(minimum, maximum, bins);
 }
 
 void mitk::IntensityQuantifier::InitializeByImageRegionAndMaximum(mitk::Image::Pointer image, mitk::Image::Pointer mask, double maximum, unsigned int bins) {
   double minimum, tmp;
-  AccessByItk_3(image, CalculateImageRegionMinMax, mask, minimum, tmp);
+  GetExtrema(image, mask, minimum, tmp);
   InitializeByMinimumMaximum(minimum, maximum, bins);
 }
 
 void mitk::IntensityQuantifier::InitializeByImageAndBinsize(mitk::Image::Pointer image, double binsize) {
   double minimum, maximum;
-  AccessByItk_2(image, CalculateImageMinMax, minimum, maximum);
+  GetExtrema(image, nullptr, minimum, maximum);
   InitializeByBinsizeAndMaximum(minimum, maximum, binsize);
 }
 
 void mitk::IntensityQuantifier::InitializeByImageAndBinsizeAndMinimum(mitk::Image::Pointer image, double minimum, double binsize) {
   double tmp, maximum;
-  AccessByItk_2(image, CalculateImageMinMax, tmp, maximum);
+  GetExtrema(image, nullptr, tmp, maximum);
   InitializeByBinsizeAndMaximum(minimum, maximum, binsize);
 }
 
 void mitk::IntensityQuantifier::InitializeByImageAndBinsizeAndMaximum(mitk::Image::Pointer image, double maximum, double binsize) {
   double minimum, tmp;
-  AccessByItk_2(image, CalculateImageMinMax, minimum, tmp);
+  GetExtrema(image, nullptr, minimum, tmp);
   InitializeByBinsizeAndMaximum(minimum, maximum, binsize);
 }
 
 void mitk::IntensityQuantifier::InitializeByImageRegionAndBinsize(mitk::Image::Pointer image, mitk::Image::Pointer mask, double binsize) {
   double minimum, maximum;
-  AccessByItk_3(image, CalculateImageRegionMinMax, mask, minimum, maximum);
+  GetExtrema(image, mask, minimum, maximum);
   InitializeByBinsizeAndMaximum(minimum, maximum, binsize);
 }
 
 void mitk::IntensityQuantifier::InitializeByImageRegionAndBinsizeAndMinimum(mitk::Image::Pointer image, mitk::Image::Pointer mask, double minimum, double binsize) {
   double tmp, maximum;
-  AccessByItk_3(image, CalculateImageRegionMinMax, mask, tmp, maximum);
+  GetExtrema(image, mask, tmp, maximum);
   InitializeByBinsizeAndMaximum(minimum, maximum, binsize);
 }
 
 void mitk::IntensityQuantifier::InitializeByImageRegionAndBinsizeAndMaximum(mitk::Image::Pointer image, mitk::Image::Pointer mask, double maximum, double binsize) {
   double minimum, tmp;
-  AccessByItk_3(image, CalculateImageRegionMinMax, mask, minimum, tmp);
+  GetExtrema(image, mask, minimum, tmp);
   InitializeByBinsizeAndMaximum(minimum, maximum, binsize);
 }
 
@@ -44,13 +44,17 @@ found in the LICENSE file.
 #include <mitkConvert2Dto3DImageFilter.h>
 
 #include <mitkCLResultWritter.h>
+#include <mitkIntensityExtremaCache.h>
 #include <mitkVersion.h>
 
 #include <iostream>
 #include <locale>
+#include <algorithm>
 
 #include <itkImageDuplicator.h>
 #include <itkImageRegionIterator.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <itkRegionOfInterestImageFilter.h>
 
 
 #include "itkNearestNeighborInterpolateImageFunction.h"
@@ -175,6 +179,102 @@ ResampleMask(itk::Image<TPixel, VImageDimension>* itkMoving, mitk::Image::Pointe
   mitk::GrabItkImageMemory(resampler->GetOutput(), newMask);
 }
 
+template<typename TPixel, unsigned int VImageDimension>
+static void
+CropImage(itk::Image<TPixel, VImageDimension>* itkImage, itk::ImageRegion<VImageDimension> region, mitk::Image::Pointer& newImage)
+{
+  typedef itk::Image<TPixel, VImageDimension> ImageType;
+  typedef itk::RegionOfInterestImageFilter<ImageType, ImageType> FilterType;
+
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(itkImage);
+  filter->SetRegionOfInterest(region);
+  filter->Update();
+
+  newImage->InitializeByItk(filter->GetOutput());
+  mitk::GrabItkImageMemory(filter->GetOutput(), newImage);
+}
+
+static void
+AddMaskToBoundingRegion(mitk::Image::Pointer mask, MaskImageType::IndexType &minIndex, MaskImageType::IndexType &maxIndex, bool &found)
+{
+  MaskImageType::Pointer itkMask = MaskImageType::New();
+  mitk::CastToItkImage(mask, itkMask);
+
+  itk::ImageRegionConstIteratorWithIndex<MaskImageType> iter(itkMask, itkMask->GetLargestPossibleRegion());
+  while (!iter.IsAtEnd())
+  {
+    if (iter.Value() > 0)
+    {
+      auto index = iter.GetIndex();
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        minIndex[i] = (found) ? std::min(minIndex[i], index[i]) : index[i];
+        maxIndex[i] = (found) ? std::max(maxIndex[i], index[i]) : index[i];
+      }
+      found = true;
+    }
+    ++iter;
+  }
+}
+
+// Crops image and masks to the bounding box of the masks (plus margin). All images
+// are expected to share the geometry of the image.
+static void
+CropImagesToMask(mitk::Image::Pointer &image, mitk::Image::Pointer &mask,
+                 mitk::Image::Pointer &maskNoNaN, mitk::Image::Pointer &morphMask, int margin)
+{
+  MaskImageType::IndexType minIndex, maxIndex;
+  bool found = false;
+  AddMaskToBoundingRegion(mask, minIndex, maxIndex, found);
+  if (morphMask != mask)
+  {
+    AddMaskToBoundingRegion(morphMask, minIndex, maxIndex, found);
+  }
+  if (!found)
+  {
+    MITK_WARN << "Mask is empty, the image is not cropped.";
+    return;
+  }
+
+  MaskImageType::Pointer itkMask = MaskImageType::New();
+  mitk::CastToItkImage(mask, itkMask);
+  auto largestRegion = itkMask->GetLargestPossibleRegion();
+  auto lowerIndex = largestRegion.GetIndex();
+  auto upperIndex = largestRegion.GetUpperIndex();
+
+  itk::ImageRegion<3> region;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    auto lower = std::max<itk::IndexValueType>(minIndex[i] - margin, lowerIndex[i]);
+    auto upper = std::min<itk::IndexValueType>(maxIndex[i] + margin, upperIndex[i]);
+    region.SetIndex(i, lower);
+    region.SetSize(i, upper - lower + 1);
+  }
+  MITK_INFO << "Cropping to region " << region.GetIndex() << " " << region.GetSize();
+
+  mitk::Image::Pointer croppedImage = mitk::Image::New();
+  mitk::Image::Pointer croppedMask = mitk::Image::New();
+  mitk::Image::Pointer croppedMaskNoNaN = mitk::Image::New();
+  AccessFixedDimensionByItk_2(image, CropImage, 3, region, croppedImage);
+  AccessFixedDimensionByItk_2(mask, CropImage, 3, region, croppedMask);
+  AccessFixedDimensionByItk_2(maskNoNaN, CropImage, 3, region, croppedMaskNoNaN);
+
+  if (morphMask == mask)
+  {
+    morphMask = croppedMask;
+  }
+  else
+  {
+    mitk::Image::Pointer croppedMorphMask = mitk::Image::New();
+    AccessFixedDimensionByItk_2(morphMask, CropImage, 3, region, croppedMorphMask);
+    morphMask = croppedMorphMask;
+  }
+  image = croppedImage;
+  mask = croppedMask;
+  maskNoNaN = croppedMaskNoNaN;
+}
+
 static void
 ExtractSlicesFromImages(mitk::Image::Pointer image, mitk::Image::Pointer mask,
                         mitk::Image::Pointer maskNoNaN, mitk::Image::Pointer morphMask,
@@ -556,6 +656,19 @@ int main(int argc, char* argv[])
   AccessByItk_2(image, CreateNoNaNMask,  mask, maskNoNaN);
   //CreateNoNaNMask(mask, image, maskNoNaN);
 
+  if (param.cropToMask)
+  {
+    if (image->GetDimension() == 3)
+    {
+      MITK_INFO << "Crop images to mask with margin " << param.cropMargin;
+      CropImagesToMask(image, mask, maskNoNaN, morphMask, param.cropMargin);
+    }
+    else
+    {
+      MITK_WARN << "Cropping is only supported for 3D images, the image is not cropped.";
+    }
+  }
+
 
   bool sliceWise = false;
   int sliceDirection = 0;
@@ -577,6 +690,8 @@ int main(int argc, char* argv[])
     MITK_INFO << "Slice";
   }
 
+  mitk::IntensityExtremaCache::Pointer extremaCache = mitk::IntensityExtremaCache::New();
+
   log << " Configure features -";
   for (auto cFeature : features)
   {
@@ -598,6 +713,7 @@ int main(int argc, char* argv[])
     cFeature->SetParameter(parsedArgs);
     cFeature->SetDirection(direction);
     cFeature->SetEncodeParameters(param.encodeParameter);
+    cFeature->SetIntensityExtremaCache(extremaCache);
   }
 
   bool addDescription = parsedArgs.count("description");
@@ -664,13 +780,30 @@ int main(int argc, char* argv[])
       mitk::IOUtil::Save(cMask, param.analysisMaskPath);
     }
 
-    mitk::AbstractGlobalImageFeature::FeatureListType stats;
+    // The extrema of the previous image / slice are not needed anymore.
+    extremaCache->Clear();
 
     for (auto cFeature : features)
     {
       log << " Calculating " << cFeature->GetFeatureClassName() << " -";
       cFeature->SetMorphMask(cMorphMask);
-      cFeature->CalculateFeaturesUsingParameters(cImage, cMask, cMaskNoNaN, stats);
+    }
+
+    std::vector<mitk::AbstractGlobalImageFeature::FeatureListType> featureStats;
+    std::vector<double> featureTimes;
+    mitk::AbstractGlobalImageFeature::CalculateFeatureClasses(features, cImage, cMask, cMaskNoNaN, std::max(0, param.numberOfThreads), featureStats, featureTimes);
+
+    mitk::AbstractGlobalImageFeature::FeatureListType stats;
+    for (const auto &featureStat : featureStats)
+    {
+      stats.insert(stats.end(), featureStat.begin(), featureStat.end());
+    }
+    if (param.writeFeatureTimes)
+    {
+      for (std::size_t i = 0; i < features.size(); ++i)
+      {
+        stats.push_back(std::make_pair(features[i]->GetFeatureClassName() + "::Calculation Time [s]", featureTimes[i]));
+      }
     }
 
     for (std::size_t i = 0; i < stats.size(); ++i)
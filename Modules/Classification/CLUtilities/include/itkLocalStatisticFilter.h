@@ -51,6 +51,8 @@ namespace itk
       LocalStatisticFilter(const Self &); // purposely not implemented
       void operator=(const Self &); // purposely not implemented
 
+      class StatisticWindow;
+
       int m_Size;
       int m_Bins;
   };
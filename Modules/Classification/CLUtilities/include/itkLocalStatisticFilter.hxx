@@ -3,11 +3,12 @@
 
 #include <itkLocalStatisticFilter.h>
 
-#include <itkNeighborhoodIterator.h>
+#include <itkSlidingWindowNeighborhood.h>
 #include <itkImageRegionIterator.h>
 #include <itkImageIterator.h>
 #include "itkMinimumMaximumImageCalculator.h"
 
+#include <deque>
 #include <limits>
 
 template< class TInputImageType, class TOuputImageType>
@@ -35,62 +36,119 @@ itk::LocalStatisticFilter<TInputImageType, TOuputImageType>::BeforeThreadedGener
 }
 
 template< class TInputImageType, class TOuputImageType>
-void
-itk::LocalStatisticFilter<TInputImageType, TOuputImageType>::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType /*threadId*/)
+class itk::LocalStatisticFilter<TInputImageType, TOuputImageType>::StatisticWindow
 {
-  typedef itk::ImageRegionIterator<TInputImageType> IteratorType;
-  typedef itk::ConstNeighborhoodIterator<TInputImageType> ConstIteratorType;
-
-  typename TInputImageType::SizeType size; size.Fill(m_Size);
-  InputImagePointer input = this->GetInput(0);
+public:
+  typedef itk::ImageRegionIterator<TOuputImageType> IteratorType;
+  typedef typename SlidingWindowNeighborhood<TInputImageType>::PlaneType PlaneType;
 
-  if (TInputImageType::ImageDimension == 3)
+  StatisticWindow(std::vector<IteratorType> &iterVector) :
+    m_IterVector(iterVector)
   {
-    size[2] = 0;
   }
 
-//  MITK_INFO << "Creating output iterator";
-  std::vector<IteratorType> iterVector;
-  for (int i = 0; i < m_Bins; ++i)
+  void Clear()
   {
-    IteratorType iter(this->GetOutput(i), outputRegionForThread);
-    iterVector.push_back(iter);
+    m_Planes.clear();
   }
 
-  ConstIteratorType inputIter(size, input, outputRegionForThread);
-  while (!inputIter.IsAtEnd())
+  void AddPlane(const PlaneType &plane)
   {
-    for (int i = 0; i < m_Bins; ++i)
+    PlaneStatistic statistic;
+    statistic.min = std::numeric_limits<double>::max();
+    statistic.max = std::numeric_limits<double>::lowest();
+    statistic.sum = 0;
+    statistic.squareSum = 0;
+    for (std::size_t i = 0; i < plane.Size(); ++i)
     {
-      iterVector[i].Set(0);
+      double value = plane.GetPixel(i);
+      statistic.min = std::min<double>(statistic.min, value);
+      statistic.max = std::max<double>(statistic.max, value);
+      statistic.sum += value;
+      statistic.squareSum += value*value;
     }
+    statistic.count = plane.Size();
+    m_Planes.push_back(statistic);
+  }
+
+  void RemovePlane(const PlaneType &)
+  {
+    m_Planes.pop_front();
+  }
 
+  void Evaluate()
+  {
     double min = std::numeric_limits<double>::max();
     double max = std::numeric_limits<double>::lowest();
-    double mean = 0;
-    double std = 0;
+    double sum = 0;
+    double squareSum = 0;
+    std::size_t count = 0;
 
-    for (unsigned int i = 0; i < inputIter.Size(); ++i)
+    for (const auto &statistic : m_Planes)
     {
-      double value = inputIter.GetPixel(i);
-      min = std::min<double>(min, value);
-      max = std::max<double>(max, value);
-      mean += value / inputIter.Size();
-      std += (value*value) / inputIter.Size();
+      min = std::min<double>(min, statistic.min);
+      max = std::max<double>(max, statistic.max);
+      sum += statistic.sum;
+      squareSum += statistic.squareSum;
+      count += statistic.count;
     }
 
-    iterVector[0].Value() = min;
-    iterVector[1].Value() = max;
-    iterVector[2].Value() = mean;
-    iterVector[3].Value() = std::sqrt(std - mean*mean);
-    iterVector[4].Value() = max-min;
+    double mean = sum / count;
+    double squareMean = squareSum / count;
 
-    for (int i = 0; i < m_Bins; ++i)
+    m_IterVector[0].Set(min);
+    m_IterVector[1].Set(max);
+    m_IterVector[2].Set(mean);
+    m_IterVector[3].Set(std::sqrt(squareMean - mean*mean));
+    m_IterVector[4].Set(max - min);
+
+    for (auto &iter : m_IterVector)
     {
-      ++(iterVector[i]);
+      ++iter;
     }
-    ++inputIter;
   }
+
+private:
+  struct PlaneStatistic
+  {
+    double min;
+    double max;
+    double sum;
+    double squareSum;
+    std::size_t count;
+  };
+
+  std::vector<IteratorType> &m_IterVector;
+  std::deque<PlaneStatistic> m_Planes;
+};
+
+template< class TInputImageType, class TOuputImageType>
+void
+itk::LocalStatisticFilter<TInputImageType, TOuputImageType>::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType /*threadId*/)
+{
+  typedef itk::ImageRegionIterator<TOuputImageType> IteratorType;
+
+  typename TInputImageType::SizeType size; size.Fill(m_Size);
+  InputImagePointer input = this->GetInput(0);
+
+  if (TInputImageType::ImageDimension == 3)
+  {
+    size[2] = 0;
+  }
+
+//  MITK_INFO << "Creating output iterator";
+  std::vector<IteratorType> iterVector;
+  for (int i = 0; i < m_Bins; ++i)
+  {
+    IteratorType iter(this->GetOutput(i), outputRegionForThread);
+    iterVector.push_back(iter);
+  }
+
+  // Every plane of the neighbourhood is summarized once, the statistic of a pixel
+  // combines the summaries of the planes that are currently in the window.
+  StatisticWindow window(iterVector);
+  SlidingWindowNeighborhood<TInputImageType> neighborhood(input, size);
+  neighborhood.Traverse(outputRegionForThread, window);
 }
 
 template< class TInputImageType, class TOuputImageType>
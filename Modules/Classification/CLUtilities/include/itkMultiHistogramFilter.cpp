@@ -15,7 +15,7 @@ found in the LICENSE file.
 
 #include <itkMultiHistogramFilter.h>
 
-#include <itkNeighborhoodIterator.h>
+#include <itkSlidingWindowNeighborhood.h>
 #include <itkImageRegionIterator.h>
 #include <itkImageIterator.h>
 #include "itkMinimumMaximumImageCalculator.h"
@@ -57,6 +57,65 @@ itk::MultiHistogramFilter<TInputImageType, TOuputImageType>::BeforeThreadedGener
     CreateOutputImage(input, this->GetOutput(i));
   }
 }
+
+template< class TInputImageType, class TOuputImageType>
+class itk::MultiHistogramFilter<TInputImageType, TOuputImageType>::HistogramWindow
+{
+public:
+  typedef itk::ImageRegionIterator<TOuputImageType> IteratorType;
+  typedef typename SlidingWindowNeighborhood<TInputImageType>::PlaneType PlaneType;
+
+  HistogramWindow(std::vector<IteratorType> &iterVector, double offset, double delta, int bins) :
+    m_IterVector(iterVector), m_Counts(bins, 0), m_Offset(offset), m_Delta(delta), m_Bins(bins)
+  {
+  }
+
+  void Clear()
+  {
+    std::fill(m_Counts.begin(), m_Counts.end(), 0);
+  }
+
+  void AddPlane(const PlaneType &plane)
+  {
+    for (std::size_t i = 0; i < plane.Size(); ++i)
+    {
+      ++m_Counts[this->GetBin(plane.GetPixel(i))];
+    }
+  }
+
+  void RemovePlane(const PlaneType &plane)
+  {
+    for (std::size_t i = 0; i < plane.Size(); ++i)
+    {
+      --m_Counts[this->GetBin(plane.GetPixel(i))];
+    }
+  }
+
+  void Evaluate()
+  {
+    for (int i = 0; i < m_Bins; ++i)
+    {
+      m_IterVector[i].Set(m_Counts[i]);
+      ++(m_IterVector[i]);
+    }
+  }
+
+private:
+  int GetBin(double value) const
+  {
+    value -= m_Offset;
+    value /= m_Delta;
+    auto pos = (int)(value);
+    return std::max(0, std::min(m_Bins - 1, pos));
+  }
+
+  std::vector<IteratorType> &m_IterVector;
+  std::vector<int> m_Counts;
+  double m_Offset;
+  double m_Delta;
+  int m_Bins;
+};
+
 template< class TInputImageType, class TOuputImageType>
 void
 itk::MultiHistogramFilter<TInputImageType, TOuputImageType>::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType /*threadId*/)
@@ -64,8 +123,7 @@ itk::MultiHistogramFilter<TInputImageType, TOuputImageType>::ThreadedGenerateDat
   double offset = m_Offset;// -3.0;
   double delta = m_Delta;// 0.6;
 
-  typedef itk::ImageRegionIterator<TInputImageType> IteratorType;
-  typedef itk::ConstNeighborhoodIterator<TInputImageType> ConstIteratorType;
+  typedef itk::ImageRegionIterator<TOuputImageType> IteratorType;
 
   typename TInputImageType::SizeType size; size.Fill(m_Size);
   InputImagePointer input = this->GetInput(0);
@@ -78,30 +136,11 @@ itk::MultiHistogramFilter<TInputImageType, TOuputImageType>::ThreadedGenerateDat
     iterVector.push_back(iter);
   }
 
-  ConstIteratorType inputIter(size, input, outputRegionForThread);
-  while (!inputIter.IsAtEnd())
-  {
-    for (int i = 0; i < m_Bins; ++i)
-    {
-      iterVector[i].Set(0);
-    }
-
-    for (unsigned int i = 0; i < inputIter.Size(); ++i)
-    {
-      double value = inputIter.GetPixel(i);
-      value -=  offset;
-      value /= delta;
-      auto pos = (int)(value);
-      pos = std::max(0, std::min(m_Bins-1, pos));
-      iterVector[pos].Value() += 1;// (iterVector[pos].GetCenterPixel() + 1);
-    }
-
-    for (int i = 0; i < m_Bins; ++i)
-    {
-      ++(iterVector[i]);
-    }
-    ++inputIter;
-  }
+  // The histogram is updated with the planes that enter and leave the neighbourhood
+  // instead of being counted from scratch for every pixel.
+  HistogramWindow window(iterVector, offset, delta, m_Bins);
+  SlidingWindowNeighborhood<TInputImageType> neighborhood(input, size);
+  neighborhood.Traverse(outputRegionForThread, window);
 }
 
 template< class TInputImageType, class TOuputImageType>
@@ -63,6 +63,8 @@ namespace itk
       MultiHistogramFilter(const Self &); // purposely not implemented
       void operator=(const Self &); // purposely not implemented
 
+      class HistogramWindow;
+
       double m_Delta;
       double m_Offset;
       int m_Bins;
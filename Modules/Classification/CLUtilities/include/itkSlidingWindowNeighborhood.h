@@ -0,0 +1,173 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef itkSlidingWindowNeighborhood_h
+#define itkSlidingWindowNeighborhood_h
+
+#include <itkImage.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace itk
+{
+  /** \brief Incremental traversal of a box shaped neighbourhood that slides along the first image dimension.
+  *
+  * A neighbourhood with radius r consists of the 2*r[0]+1 planes (all pixels with the same index in the
+  * first dimension) around the center. When the window moves one pixel further, only the plane that leaves
+  * the window is removed and the plane that enters it is added, so a window does not need to visit all
+  * pixels of the neighbourhood for every center pixel.
+  *
+  * Indices outside of the buffered region are replaced by the nearest index inside (the behaviour of
+  * itk::ZeroFluxNeumannBoundaryCondition, the default of itk::ConstNeighborhoodIterator). A window therefore
+  * sees exactly the pixels a ConstNeighborhoodIterator with the same radius would visit.
+  *
+  * The window type passed to Traverse() has to provide:
+  * - void Clear(): called at the start of every line.
+  * - void AddPlane(const PlaneType &): a plane enters the window.
+  * - void RemovePlane(const PlaneType &): the oldest plane leaves the window.
+  * - void Evaluate(): the window contains the neighbourhood of the next pixel of the region.
+  *
+  * The pixels are evaluated in the order of an itk::ImageRegionIterator over the traversed region, so a
+  * window can write its results to output iterators of the same region. Traverse() does not change the
+  * state of the object, so the regions of ThreadedGenerateData() can be traversed concurrently.
+  */
+  template<typename TImage>
+  class SlidingWindowNeighborhood
+  {
+  public:
+    typedef typename TImage::PixelType     PixelType;
+    typedef typename TImage::RegionType    RegionType;
+    typedef typename TImage::SizeType      SizeType;
+    typedef typename TImage::IndexType     IndexType;
+    typedef typename TImage::OffsetValueType OffsetValueType;
+
+    itkStaticConstMacro(ImageDimension, unsigned int, TImage::ImageDimension);
+
+    /** \brief All pixels of the window with the same index in the first dimension. */
+    class PlaneType
+    {
+    public:
+      std::size_t Size() const { return m_Offsets->size(); }
+      PixelType GetPixel(std::size_t i) const { return m_Buffer[(*m_Offsets)[i]]; }
+
+    private:
+      friend class SlidingWindowNeighborhood;
+
+      const PixelType *m_Buffer;
+      const std::vector<OffsetValueType> *m_Offsets;
+    };
+
+    SlidingWindowNeighborhood(const TImage *image, const SizeType &radius) :
+      m_Image(image), m_Radius(radius)
+    {
+    }
+
+    template<typename TWindow>
+    void Traverse(const RegionType &region, TWindow &window) const
+    {
+      if (region.GetNumberOfPixels() == 0)
+      {
+        return;
+      }
+
+      const IndexType regionLower = region.GetIndex();
+      const IndexType regionUpper = region.GetUpperIndex();
+      const OffsetValueType radius0 = m_Radius[0];
+
+      const PixelType *buffer = m_Image->GetBufferPointer();
+      std::vector<OffsetValueType> planeOffsets;
+      PlaneType plane;
+      plane.m_Offsets = &planeOffsets;
+
+      IndexType lineIndex = regionLower;
+      while (true)
+      {
+        this->ComputePlaneOffsets(lineIndex, planeOffsets);
+
+        window.Clear();
+        for (OffsetValueType column = regionLower[0] - radius0; column <= regionLower[0] + radius0; ++column)
+        {
+          plane.m_Buffer = buffer + this->ColumnOffset(column);
+          window.AddPlane(plane);
+        }
+        window.Evaluate();
+
+        for (OffsetValueType x = regionLower[0] + 1; x <= regionUpper[0]; ++x)
+        {
+          plane.m_Buffer = buffer + this->ColumnOffset(x - 1 - radius0);
+          window.RemovePlane(plane);
+          plane.m_Buffer = buffer + this->ColumnOffset(x + radius0);
+          window.AddPlane(plane);
+          window.Evaluate();
+        }
+
+        // Next line in the order of ImageRegionIterator
+        unsigned int dim = 1;
+        for (; dim < ImageDimension; ++dim)
+        {
+          if (++lineIndex[dim] <= regionUpper[dim])
+          {
+            break;
+          }
+          lineIndex[dim] = regionLower[dim];
+        }
+        if (dim == ImageDimension)
+        {
+          break;
+        }
+      }
+    }
+
+  private:
+    /** Buffer offset of the (clamped) column in the first dimension.*/
+    OffsetValueType ColumnOffset(OffsetValueType column) const
+    {
+      const RegionType &buffered = m_Image->GetBufferedRegion();
+      const OffsetValueType lower = buffered.GetIndex(0);
+      const OffsetValueType upper = lower + static_cast<OffsetValueType>(buffered.GetSize(0)) - 1;
+      return (std::min(std::max(column, lower), upper) - lower) * m_Image->GetOffsetTable()[0];
+    }
+
+    /** Buffer offsets of all pixels of a plane of the line (without the offset of the first dimension).*/
+    void ComputePlaneOffsets(const IndexType &lineIndex, std::vector<OffsetValueType> &planeOffsets) const
+    {
+      const RegionType &buffered = m_Image->GetBufferedRegion();
+      const OffsetValueType *offsetTable = m_Image->GetOffsetTable();
+
+      planeOffsets.assign(1, 0);
+      for (unsigned int dim = 1; dim < ImageDimension; ++dim)
+      {
+        const OffsetValueType lower = buffered.GetIndex(dim);
+        const OffsetValueType upper = lower + static_cast<OffsetValueType>(buffered.GetSize(dim)) - 1;
+        const OffsetValueType radius = m_Radius[dim];
+
+        std::vector<OffsetValueType> extendedOffsets;
+        extendedOffsets.reserve(planeOffsets.size() * (2 * radius + 1));
+        for (OffsetValueType i = -radius; i <= radius; ++i)
+        {
+          const OffsetValueType index = std::min(std::max(lineIndex[dim] + i, lower), upper);
+          for (auto offset : planeOffsets)
+          {
+            extendedOffsets.push_back(offset + (index - lower) * offsetTable[dim]);
+          }
+        }
+        planeOffsets.swap(extendedOffsets);
+      }
+    }
+
+    const TImage *m_Image;
+    SizeType m_Radius;
+  };
+}
+
+#endif // itkSlidingWindowNeighborhood_h
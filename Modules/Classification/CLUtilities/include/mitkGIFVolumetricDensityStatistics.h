@@ -17,6 +17,8 @@ found in the LICENSE file.
 #include <mitkBaseData.h>
 #include <MitkCLUtilitiesExports.h>
 
+#include <itkConfigure.h>
+
 namespace mitk
 {
     /**
@@ -99,6 +101,18 @@ namespace mitk
     * the number of masked voxels \f$ N_v \f$, the intensity of each voxel \f$ x_i \f$,
     * and the mean intensity of all masked voxels \f$ \mu = \frac{1}{N_v} sum x_i \f$:
     * \f[ \textup{Volume Geary's C measure}= \frac{N_v - 1}{2 \sum_i \sum_j w_{ij}} \frac{ \sum_i \sum_j w_{ij} (x_i - x_j)^2 }{\sum_i (x_i - \mu)^2 } \enspace \enspace {; i \neq j} \f]
+    *
+    * By default, the sums over all pairs of voxels that are needed for Moran's I index and Geary's C measure
+    * are calculated as FFT-based convolutions of the (centered) masked image and the mask with the
+    * inverse-distance kernel \f$ w \f$. This gives the same result as the direct calculation in
+    * \f$ O(N \log N) \f$ for the \f$ N \f$ voxels of the bounding box of the mask. The convolution buffers
+    * are padded to twice the extent of the bounding box in every dimension, i.e. to about \f$ 2^d N \f$ voxels
+    * (8 times the bounding box of a 3D mask). Up to six double buffers of this size are alive at the same time,
+    * so the peak memory is about 384 bytes per voxel of the bounding box of a 3D mask (6.4 GB for a 256^3
+    * bounding box). The direct calculation over all pairs of masked voxels needs only memory for the masked
+    * voxels, but \f$ O(N_v^2) \f$ operations. It can be enabled with <b>SetUsePairwiseAutocorrelation</b>
+    * (option <b>::pairwise</b>) for validation and is distributed over <b>SetNumberOfThreads</b> threads
+    * (option <b>::threads</b>, 0 uses the ITK default, at most ITK_MAX_THREADS).
     */
   class MITKCLUTILITIES_EXPORT GIFVolumetricDensityStatistics : public AbstractGlobalImageFeature
   {
@@ -122,7 +136,16 @@ namespace mitk
     void CalculateFeaturesUsingParameters(const Image::Pointer & feature, const Image::Pointer &mask, const Image::Pointer &maskNoNAN, FeatureListType &featureList) override;
     void AddArguments(mitkCommandLineParser &parser) override;
 
+    itkSetMacro(UsePairwiseAutocorrelation, bool);
+    itkGetConstMacro(UsePairwiseAutocorrelation, bool);
+    itkBooleanMacro(UsePairwiseAutocorrelation);
+
+    itkSetClampMacro(NumberOfThreads, unsigned int, 0, ITK_MAX_THREADS);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
   private:
+    bool m_UsePairwiseAutocorrelation;
+    unsigned int m_NumberOfThreads;
   };
 }
 #endif //mitkGIFVolumetricDensityStatistics_h
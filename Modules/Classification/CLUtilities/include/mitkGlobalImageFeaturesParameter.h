@@ -48,6 +48,7 @@ namespace mitk
       std::string analysisMaskPath;
       bool writePNGScreenshots;
       std::string pngScreenshotsPath;
+      bool writeFeatureTimes;
 
       bool useHeader;
       bool useHeaderForFirstLineOnly;
@@ -56,6 +57,8 @@ namespace mitk
       bool resampleMask;
       bool resampleToFixIsotropic;
       double resampleResolution;
+      bool cropToMask;
+      int cropMargin;
 
       bool ignoreMaskForHistogram;
       bool defineGlobalMinimumIntensity;
@@ -67,6 +70,7 @@ namespace mitk
       bool useDecimalPoint;
       char decimalPoint;
       bool encodeParameter;
+      int numberOfThreads;
 
     private:
       void ParseFileLocations(std::map<std::string, us::Any> &parsedArgs);
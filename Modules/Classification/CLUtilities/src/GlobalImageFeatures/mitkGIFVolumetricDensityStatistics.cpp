@@ -23,7 +23,12 @@ found in the LICENSE file.
 #include <itkLabelStatisticsImageFilter.h>
 #include <itkNeighborhoodIterator.h>
 #include <itkImageRegionConstIteratorWithIndex.h>
+#include <itkImageRegionIterator.h>
+#include <itkImageRegionIteratorWithIndex.h>
 #include <itkLabelGeometryImageFilter.h>
+#include <itkRealToHalfHermitianForwardFFTImageFilter.h>
+#include <itkHalfHermitianToRealInverseFFTImageFilter.h>
+#include <itkMultiThreader.h>
 
 // VTK
 #include <vtkSmartPointer.h>
@@ -37,6 +42,7 @@ found in the LICENSE file.
 
 // STL
 #include <limits>
+#include <thread>
 #include <vnl/vnl_math.h>
 
 // Eigen
@@ -46,8 +52,238 @@ struct GIFVolumetricDensityStatisticsParameters
 {
   double volume;
   std::string prefix;
+  bool pairwiseAutocorrelation;
+  unsigned int numberOfThreads;
 };
 
+// Sums over all pairs i != j of masked voxels with intensities x and the inverse distance w
+struct SpatialAutocorrelationSums
+{
+  SpatialAutocorrelationSums() : moranA(0), moranB(0), geary(0), weights(0) {}
+
+  double moranA;  // sum w_ij (x_i - mean) (x_j - mean)
+  double moranB;  // sum (x_i - mean)^2, single sum
+  double geary;   // sum w_ij (x_i - x_j)^2
+  double weights; // sum w_ij
+};
+
+template<typename TPixel, unsigned int VImageDimension>
+SpatialAutocorrelationSums
+CalculateSpatialAutocorrelationPairwise(itk::Image<TPixel, VImageDimension>* itkImage, itk::Image<unsigned short, VImageDimension>* maskImage, double mean, unsigned int numberOfThreads)
+{
+  typedef itk::Image<TPixel, VImageDimension> ImageType;
+  typedef itk::Image<unsigned short, VImageDimension> MaskType;
+
+  std::vector<typename ImageType::PointType> points;
+  std::vector<double> values;
+
+  itk::ImageRegionConstIteratorWithIndex<ImageType> imgA(itkImage, itkImage->GetLargestPossibleRegion());
+  itk::ImageRegionConstIteratorWithIndex<MaskType> maskA(maskImage, maskImage->GetLargestPossibleRegion());
+  typename ImageType::PointType point;
+  while (!imgA.IsAtEnd())
+  {
+    if (maskA.Get() > 0)
+    {
+      itkImage->TransformIndexToPhysicalPoint(imgA.GetIndex(), point);
+      points.push_back(point);
+      values.push_back(imgA.Get() - mean);
+    }
+    ++imgA;
+    ++maskA;
+  }
+
+  if (numberOfThreads == 0)
+    numberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  numberOfThreads = std::min(numberOfThreads, itk::MultiThreader::GetGlobalMaximumNumberOfThreads());
+  numberOfThreads = std::max<unsigned int>(1, std::min<std::size_t>(numberOfThreads, points.size()));
+
+  // Every pair is visited once and counted twice. The rows are interleaved between the threads,
+  // as the number of pairs per row decreases.
+  std::vector<SpatialAutocorrelationSums> threadSums(numberOfThreads);
+  auto calculateRows = [&](unsigned int thread)
+  {
+    SpatialAutocorrelationSums &sums = threadSums[thread];
+    for (std::size_t i = thread; i < points.size(); i += numberOfThreads)
+    {
+      for (std::size_t j = i + 1; j < points.size(); ++j)
+      {
+        double w = 1 / points[i].EuclideanDistanceTo(points[j]);
+        double difference = values[i] - values[j];
+        sums.moranA += 2 * w * values[i] * values[j];
+        sums.geary += 2 * w * difference * difference;
+        sums.weights += 2 * w;
+      }
+      sums.moranB += values[i] * values[i];
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int thread = 1; thread < numberOfThreads; ++thread)
+    threads.emplace_back(calculateRows, thread);
+  calculateRows(0);
+  for (auto &thread : threads)
+    thread.join();
+
+  SpatialAutocorrelationSums result;
+  for (const auto &sums : threadSums)
+  {
+    result.moranA += sums.moranA;
+    result.moranB += sums.moranB;
+    result.geary += sums.geary;
+    result.weights += sums.weights;
+  }
+  return result;
+}
+
+// Smallest even size that is at least minimumSize and has no prime factors larger than 5 (required by the VNL FFT)
+static itk::SizeValueType GetEvenFFTSize(itk::SizeValueType minimumSize)
+{
+  for (itk::SizeValueType size = minimumSize + (minimumSize % 2);; size += 2)
+  {
+    itk::SizeValueType rest = size;
+    for (itk::SizeValueType factor : { 2, 3, 5 })
+    {
+      while (rest % factor == 0)
+        rest /= factor;
+    }
+    if (rest == 1)
+      return size;
+  }
+}
+
+template<typename TPixel, unsigned int VImageDimension>
+SpatialAutocorrelationSums
+CalculateSpatialAutocorrelationByFFT(itk::Image<TPixel, VImageDimension>* itkImage, itk::Image<unsigned short, VImageDimension>* maskImage, const itk::ImageRegion<VImageDimension> &maskRegion, double mean)
+{
+  typedef itk::Image<TPixel, VImageDimension> ImageType;
+  typedef itk::Image<unsigned short, VImageDimension> MaskType;
+  typedef itk::Image<double, VImageDimension> RealImageType;
+  typedef itk::RealToHalfHermitianForwardFFTImageFilter<RealImageType> ForwardFFTType;
+  typedef typename ForwardFFTType::OutputImageType ComplexImageType;
+  typedef itk::HalfHermitianToRealInverseFFTImageFilter<ComplexImageType, RealImageType> InverseFFTType;
+
+  // The images are padded to more than twice the extent of the mask, so that the cyclic convolution
+  // of the FFT gives the linear convolution within the bounding box of the mask. Each buffer therefore
+  // has 2^VImageDimension times the voxels of the bounding box (see the class documentation).
+  typename RealImageType::RegionType paddedRegion;
+  for (unsigned int d = 0; d < VImageDimension; ++d)
+  {
+    paddedRegion.SetIndex(d, 0);
+    paddedRegion.SetSize(d, GetEvenFFTSize(2 * maskRegion.GetSize(d)));
+  }
+
+  auto createImage = [&]()
+  {
+    typename RealImageType::Pointer image = RealImageType::New();
+    image->SetRegions(paddedRegion);
+    image->Allocate();
+    image->FillBuffer(0.0);
+    return image;
+  };
+
+  // Centered intensities x_i - mean and mask indicator, both zero outside of the mask
+  typename RealImageType::Pointer centered = createImage();
+  typename RealImageType::Pointer indicator = createImage();
+  itk::ImageRegionConstIteratorWithIndex<ImageType> imageIter(itkImage, maskRegion);
+  itk::ImageRegionConstIterator<MaskType> maskIter(maskImage, maskRegion);
+  typename RealImageType::IndexType paddedIndex;
+  while (!imageIter.IsAtEnd())
+  {
+    if (maskIter.Get() > 0)
+    {
+      for (unsigned int d = 0; d < VImageDimension; ++d)
+        paddedIndex[d] = imageIter.GetIndex()[d] - maskRegion.GetIndex()[d];
+      centered->SetPixel(paddedIndex, imageIter.Get() - mean);
+      indicator->SetPixel(paddedIndex, 1.0);
+    }
+    ++imageIter;
+    ++maskIter;
+  }
+
+  // Inverse distance kernel with wrapped-around negative offsets, zero for the voxel itself.
+  // The direction matrix is orthonormal, so the distance only depends on the spacing.
+  typename RealImageType::Pointer kernel = createImage();
+  const typename ImageType::SpacingType spacing = itkImage->GetSpacing();
+  itk::ImageRegionIteratorWithIndex<RealImageType> kernelIter(kernel, paddedRegion);
+  while (!kernelIter.IsAtEnd())
+  {
+    double squaredDistance = 0;
+    for (unsigned int d = 0; d < VImageDimension; ++d)
+    {
+      itk::OffsetValueType offset = kernelIter.GetIndex()[d];
+      if (offset >= static_cast<itk::OffsetValueType>(paddedRegion.GetSize(d) / 2))
+        offset -= paddedRegion.GetSize(d);
+      squaredDistance += offset * spacing[d] * offset * spacing[d];
+    }
+    kernelIter.Set(squaredDistance > 0 ? 1.0 / std::sqrt(squaredDistance) : 0.0);
+    ++kernelIter;
+  }
+
+  auto transform = [](RealImageType *image)
+  {
+    typename ForwardFFTType::Pointer fft = ForwardFFTType::New();
+    fft->SetInput(image);
+    fft->Update();
+    typename ComplexImageType::Pointer transformed = fft->GetOutput();
+    transformed->DisconnectPipeline();
+    return transformed;
+  };
+
+  typename ComplexImageType::Pointer transformedKernel = transform(kernel);
+  kernel = nullptr;
+
+  auto convolve = [&](RealImageType *image)
+  {
+    typename ComplexImageType::Pointer transformed = transform(image);
+    itk::ImageRegionIterator<ComplexImageType> transformedIter(transformed, transformed->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<ComplexImageType> kernelFFTIter(transformedKernel, transformedKernel->GetLargestPossibleRegion());
+    while (!transformedIter.IsAtEnd())
+    {
+      transformedIter.Set(transformedIter.Get() * kernelFFTIter.Get());
+      ++transformedIter;
+      ++kernelFFTIter;
+    }
+
+    typename InverseFFTType::Pointer inverseFFT = InverseFFTType::New();
+    inverseFFT->SetInput(transformed);
+    inverseFFT->SetActualXDimensionIsOdd(false);
+    inverseFFT->Update();
+    typename RealImageType::Pointer result = inverseFFT->GetOutput();
+    result->DisconnectPipeline();
+    return result;
+  };
+
+  typename RealImageType::Pointer convolvedCentered = convolve(centered);
+  typename RealImageType::Pointer convolvedIndicator = convolve(indicator);
+
+  // sum w_ij (x_i - x_j)^2 = 2 sum_i (x_i - mean)^2 sum_j w_ij - 2 sum w_ij (x_i - mean) (x_j - mean)
+  typename RealImageType::RegionType sumRegion;
+  sumRegion.SetSize(maskRegion.GetSize());
+  itk::ImageRegionConstIterator<RealImageType> centeredIter(centered, sumRegion);
+  itk::ImageRegionConstIterator<RealImageType> indicatorIter(indicator, sumRegion);
+  itk::ImageRegionConstIterator<RealImageType> convolvedCenteredIter(convolvedCentered, sumRegion);
+  itk::ImageRegionConstIterator<RealImageType> convolvedIndicatorIter(convolvedIndicator, sumRegion);
+
+  SpatialAutocorrelationSums sums;
+  while (!centeredIter.IsAtEnd())
+  {
+    if (indicatorIter.Get() > 0)
+    {
+      double value = centeredIter.Get();
+      sums.moranA += value * convolvedCenteredIter.Get();
+      sums.moranB += value * value;
+      sums.geary += 2 * value * value * convolvedIndicatorIter.Get();
+      sums.weights += convolvedIndicatorIter.Get();
+    }
+    ++centeredIter;
+    ++indicatorIter;
+    ++convolvedCenteredIter;
+    ++convolvedIndicatorIter;
+  }
+  sums.geary -= 2 * sums.moranA;
+  return sums;
+}
+
 template<typename TPixel, unsigned int VImageDimension>
 void
 CalculateVolumeDensityStatistic(itk::Image<TPixel, VImageDimension>* itkImage, mitk::Image::Pointer mask, GIFVolumetricDensityStatisticsParameters params, mitk::GIFVolumetricDensityStatistics::FeatureListType & featureList)
@@ -62,19 +298,15 @@ CalculateVolumeDensityStatistic(itk::Image<TPixel, VImageDimension>* itkImage, m
   mitk::CastToItkImage(mask, maskImage);
 
   itk::ImageRegionConstIteratorWithIndex<ImageType> imgA(itkImage, itkImage->GetLargestPossibleRegion());
-  itk::ImageRegionConstIteratorWithIndex<ImageType> imgB(itkImage, itkImage->GetLargestPossibleRegion());
   itk::ImageRegionConstIteratorWithIndex<MaskType> maskA(maskImage, maskImage->GetLargestPossibleRegion());
-  itk::ImageRegionConstIteratorWithIndex<MaskType> maskB(maskImage, maskImage->GetLargestPossibleRegion());
 
-  double moranA = 0;
-  double moranB = 0;
-  double geary = 0;
   double Nv = 0;
-  double w_ij = 0;
   double mean = 0;
 
-  typename ImageType::PointType pointA;
-  typename ImageType::PointType pointB;
+  typename ImageType::IndexType minimumIndex;
+  typename ImageType::IndexType maximumIndex;
+  minimumIndex.Fill(itk::NumericTraits<itk::IndexValueType>::max());
+  maximumIndex.Fill(itk::NumericTraits<itk::IndexValueType>::NonpositiveMin());
 
   while (!imgA.IsAtEnd())
   {
@@ -82,52 +314,39 @@ CalculateVolumeDensityStatistic(itk::Image<TPixel, VImageDimension>* itkImage, m
     {
       Nv += 1;
       mean += imgA.Get();
+      for (unsigned int d = 0; d < VImageDimension; ++d)
+      {
+        minimumIndex[d] = std::min(minimumIndex[d], imgA.GetIndex()[d]);
+        maximumIndex[d] = std::max(maximumIndex[d], imgA.GetIndex()[d]);
+      }
     }
     ++imgA;
     ++maskA;
   }
   mean /= Nv;
-  imgA.GoToBegin();
-  maskA.GoToBegin();
 
-  while (!imgA.IsAtEnd())
+  SpatialAutocorrelationSums sums;
+  if (Nv > 0)
   {
-    if (maskA.Get() > 0)
+    if (params.pairwiseAutocorrelation)
     {
-      imgB.GoToBegin();
-      maskB.GoToBegin();
-      while (!imgB.IsAtEnd())
-      {
-        if ((imgA.GetIndex() == imgB.GetIndex()) ||
-          (maskB.Get() < 1))
-        {
-          ++imgB;
-          ++maskB;
-          continue;
-        }
-        itkImage->TransformIndexToPhysicalPoint(maskA.GetIndex(), pointA);
-        itkImage->TransformIndexToPhysicalPoint(maskB.GetIndex(), pointB);
-
-        double w = 1 / pointA.EuclideanDistanceTo(pointB);
-        moranA += w*(imgA.Get() - mean)* (imgB.Get() - mean);
-        geary += w * (imgA.Get() - imgB.Get()) * (imgA.Get() - imgB.Get());
-
-        w_ij += w;
-
-        ++imgB;
-        ++maskB;
-      }
-      moranB += (imgA.Get() - mean)* (imgA.Get() - mean);
+      sums = CalculateSpatialAutocorrelationPairwise(itkImage, maskImage.GetPointer(), mean, params.numberOfThreads);
+    }
+    else
+    {
+      typename ImageType::RegionType maskRegion;
+      maskRegion.SetIndex(minimumIndex);
+      for (unsigned int d = 0; d < VImageDimension; ++d)
+        maskRegion.SetSize(d, maximumIndex[d] - minimumIndex[d] + 1);
+      sums = CalculateSpatialAutocorrelationByFFT(itkImage, maskImage.GetPointer(), maskRegion, mean);
     }
-    ++imgA;
-    ++maskA;
   }
 
   MITK_INFO << "Volume: " << volume;
   MITK_INFO << " Mean: " << mean;
   featureList.push_back(std::make_pair(prefix + "Volume integrated intensity", volume* mean));
-  featureList.push_back(std::make_pair(prefix + "Volume Moran's I index", Nv / w_ij * moranA / moranB));
-  featureList.push_back(std::make_pair(prefix + "Volume Geary's C measure", ( Nv -1 ) / 2 / w_ij * geary/ moranB));
+  featureList.push_back(std::make_pair(prefix + "Volume Moran's I index", Nv / sums.weights * sums.moranA / sums.moranB));
+  featureList.push_back(std::make_pair(prefix + "Volume Geary's C measure", ( Nv -1 ) / 2 / sums.weights * sums.geary / sums.moranB));
 }
 
 void calculateMOBB(vtkPointSet *pointset, double &volume, double &surface)
@@ -334,6 +553,8 @@ mitk::GIFVolumetricDensityStatistics::FeatureListType mitk::GIFVolumetricDensity
   GIFVolumetricDensityStatisticsParameters params;
   params.volume = meshVolume;
   params.prefix = prefix;
+  params.pairwiseAutocorrelation = m_UsePairwiseAutocorrelation;
+  params.numberOfThreads = m_NumberOfThreads;
   AccessByItk_3(image, CalculateVolumeDensityStatistic, mask, params, featureList);
 
   //Calculate center of mass shift
@@ -491,7 +712,8 @@ mitk::GIFVolumetricDensityStatistics::FeatureListType mitk::GIFVolumetricDensity
   return featureList;
 }
 
-mitk::GIFVolumetricDensityStatistics::GIFVolumetricDensityStatistics()
+mitk::GIFVolumetricDensityStatistics::GIFVolumetricDensityStatistics() :
+  m_UsePairwiseAutocorrelation(false), m_NumberOfThreads(0)
 {
   SetLongName("volume-density");
   SetShortName("volden");
@@ -510,6 +732,8 @@ void mitk::GIFVolumetricDensityStatistics::AddArguments(mitkCommandLineParser &p
   std::string name = GetOptionPrefix();
 
   parser.addArgument(GetLongName(), name, mitkCommandLineParser::Bool, "Use Volume-Density Statistic", "calculates volume density based features", us::Any());
+  parser.addArgument(name + "::pairwise", name + "::pairwise", mitkCommandLineParser::Bool, "Pairwise Moran's I and Geary's C", "calculates Moran's I and Geary's C over all pairs of voxels instead of by FFT (slow, for validation)", us::Any());
+  parser.addArgument(name + "::threads", name + "::threads", mitkCommandLineParser::Int, "Threads for pairwise calculation", "Number of threads for the pairwise calculation of Moran's I and Geary's C (0 uses all)", us::Any());
 }
 
 void
@@ -519,6 +743,24 @@ mitk::GIFVolumetricDensityStatistics::CalculateFeaturesUsingParameters(const Ima
   if (parsedArgs.count(GetLongName()))
   {
     MITK_INFO << "Start calculating volumetric density features ....";
+    std::string name = GetOptionPrefix();
+    if (parsedArgs.count(name + "::pairwise"))
+    {
+      this->SetUsePairwiseAutocorrelation(us::any_cast<bool>(parsedArgs[name + "::pairwise"]));
+    }
+    if (parsedArgs.count(name + "::threads"))
+    {
+      const int numberOfThreads = us::any_cast<int>(parsedArgs[name + "::threads"]);
+      if (numberOfThreads < 0)
+      {
+        mitkThrow() << name << "::threads must not be negative, but is " << numberOfThreads;
+      }
+      if (numberOfThreads > ITK_MAX_THREADS)
+      {
+        MITK_WARN << name << "::threads is limited to " << ITK_MAX_THREADS << " threads";
+      }
+      this->SetNumberOfThreads(static_cast<unsigned int>(numberOfThreads));
+    }
     auto localResults = this->CalculateFeatures(feature, mask);
     featureList.insert(featureList.end(), localResults.begin(), localResults.end());
     MITK_INFO << "Finished calculating volumetric density features....";
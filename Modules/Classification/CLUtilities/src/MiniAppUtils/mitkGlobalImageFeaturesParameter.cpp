@@ -44,10 +44,12 @@ void mitk::cl::GlobalImageFeaturesParameter::AddParameter(mitkCommandLineParser
   parser.addArgument("header",            "head",    mitkCommandLineParser::Bool, "Add Header (Labels) to output", "", us::Any());
   parser.addArgument("first-line-header", "fl-head", mitkCommandLineParser::Bool, "Add Header (Labels) to first line of output", "", us::Any());
   parser.addArgument("decimal-point", "decimal", mitkCommandLineParser::String, "Decima Point that is used in Conversion", "", us::Any());
+  parser.addArgument("feature-timing", "timing", mitkCommandLineParser::Bool, "Bool", "If true, the calculation time of each feature class is added to the output. ", us::Any());
 
   parser.addArgument("resample-mask",   "rm", mitkCommandLineParser::Bool,  "Bool",  "Resamples the mask to the resolution of the input image ", us::Any());
   parser.addArgument("same-space",      "sp", mitkCommandLineParser::Bool,  "Bool",  "Set the spacing of all images to equal. Otherwise an error will be thrown. ", us::Any());
   parser.addArgument("fixed-isotropic", "fi", mitkCommandLineParser::Float, "Float", "Input image resampled to fixed isotropic resolution given in mm. Should be used with resample-mask ", us::Any());
+  parser.addArgument("crop-to-mask", "crop", mitkCommandLineParser::Int, "Int", "Crops image and masks to the bounding box of the mask, enlarged by the given number of voxels, before the features are calculated. Features that describe the whole image then refer to the cropped image. ", us::Any());
 
   parser.addArgument("minimum-intensity", "minimum", mitkCommandLineParser::Float, "Float", "Minimum intensity. If set, it is overwritten by more specific intensity minima", us::Any());
   parser.addArgument("maximum-intensity", "maximum", mitkCommandLineParser::Float, "Float", "Maximum intensity. If set, it is overwritten by more specific intensity maxima", us::Any());
@@ -55,6 +57,7 @@ void mitk::cl::GlobalImageFeaturesParameter::AddParameter(mitkCommandLineParser
   parser.addArgument("binsize", "binsize", mitkCommandLineParser::Float, "Int", "Size of bins that is used. If set, it is overwritten by more specific bin count", us::Any());
   parser.addArgument("ignore-mask-for-histogram", "ignore-mask", mitkCommandLineParser::Bool, "Bool", "If the whole image is used to calculate the histogram. ", us::Any());
   parser.addArgument("encode-parameter-in-name", "encode-parameter", mitkCommandLineParser::Bool, "Bool", "If true, the parameters used for each feature is encoded in its name. ", us::Any());
+  parser.addArgument("threads", "threads", mitkCommandLineParser::Int, "Int", "Number of feature classes that are calculated in parallel. 0 uses the default number of threads of ITK. ", us::Any());
 }
 
 void mitk::cl::GlobalImageFeaturesParameter::ParseParameter(std::map<std::string, us::Any> parsedArgs)
@@ -137,6 +140,11 @@ void mitk::cl::GlobalImageFeaturesParameter::ParseAdditionalOutputs(std::map<std
       decimalPoint = tmpDecimalPoint.at(0);
     }
   }
+  writeFeatureTimes = false;
+  if (parsedArgs.count("feature-timing"))
+  {
+    writeFeatureTimes = us::any_cast<bool>(parsedArgs["feature-timing"]);
+  }
 
 }
 
@@ -183,6 +191,13 @@ void mitk::cl::GlobalImageFeaturesParameter::ParseMaskAdaptation(std::map<std::s
     resampleToFixIsotropic = true;
     resampleResolution = us::any_cast<float>(parsedArgs["fixed-isotropic"]);
   }
+  cropToMask = false;
+  cropMargin = 0;
+  if (parsedArgs.count("crop-to-mask"))
+  {
+    cropToMask = true;
+    cropMargin = us::any_cast<int>(parsedArgs["crop-to-mask"]);
+  }
 }
 
 void mitk::cl::GlobalImageFeaturesParameter::ParseGlobalFeatureParameter(std::map<std::string, us::Any> &parsedArgs)
@@ -213,4 +228,9 @@ void mitk::cl::GlobalImageFeaturesParameter::ParseGlobalFeatureParameter(std::ma
   {
     encodeParameter = true;
   }
+  numberOfThreads = 0;
+  if (parsedArgs.count("threads"))
+  {
+    numberOfThreads = us::any_cast<int>(parsedArgs["threads"]);
+  }
 }
@@ -13,6 +13,8 @@ found in the LICENSE file.
 #include <mitkTestingMacros.h>
 #include <mitkTestFixture.h>
 #include "mitkIOUtil.h"
+#include <mitkITKImageImport.h>
+#include <itkImageRegionIteratorWithIndex.h>
 #include <cmath>
 
 #include <mitkGIFVolumetricDensityStatistics.h>
@@ -22,6 +24,7 @@ class mitkGIFVolumetricDensityStatisticsTestSuite : public mitk::TestFixture
   CPPUNIT_TEST_SUITE(mitkGIFVolumetricDensityStatisticsTestSuite);
 
   MITK_TEST(ImageDescription_PhantomTest);
+  MITK_TEST(SpatialAutocorrelation_PairwiseEqualsFFT);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -83,6 +86,61 @@ public:
     CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Morphological Density::Surface Volume convex hull with Large IBSI Phantom Image", 1.03, results["Morphological Density::Surface density convex hull"], 0.01);
    }
 
+  void SpatialAutocorrelation_PairwiseEqualsFFT()
+  {
+    typedef itk::Image<double, 3> ImageType;
+    typedef itk::Image<unsigned short, 3> MaskType;
+
+    ImageType::RegionType region;
+    region.SetSize(0, 14);
+    region.SetSize(1, 11);
+    region.SetSize(2, 9);
+    ImageType::SpacingType spacing;
+    spacing[0] = 0.8;
+    spacing[1] = 1.0;
+    spacing[2] = 2.5;
+
+    ImageType::Pointer image = ImageType::New();
+    image->SetRegions(region);
+    image->SetSpacing(spacing);
+    image->Allocate();
+    MaskType::Pointer mask = MaskType::New();
+    mask->SetRegions(region);
+    mask->SetSpacing(spacing);
+    mask->Allocate();
+
+    itk::ImageRegionIteratorWithIndex<ImageType> imageIter(image, region);
+    itk::ImageRegionIteratorWithIndex<MaskType> maskIter(mask, region);
+    while (!imageIter.IsAtEnd())
+    {
+      auto index = imageIter.GetIndex();
+      imageIter.Set(std::sin(0.7 * index[0]) + 0.3 * index[1] - 0.1 * index[0] * index[2]);
+      double dx = index[0] - 6.5;
+      double dy = index[1] - 5.0;
+      double dz = index[2] - 4.0;
+      maskIter.Set((dx * dx / 30 + dy * dy / 20 + dz * dz / 12 < 1) ? 1 : 0);
+      ++imageIter;
+      ++maskIter;
+    }
+
+    mitk::Image::Pointer mitkImage = mitk::GrabItkImageMemory(image.GetPointer());
+    mitk::Image::Pointer mitkMask = mitk::GrabItkImageMemory(mask.GetPointer());
+
+    mitk::GIFVolumetricDensityStatistics::Pointer featureCalculator = mitk::GIFVolumetricDensityStatistics::New();
+    auto fftFeatures = featureCalculator->CalculateFeatures(mitkImage, mitkMask);
+    featureCalculator->SetUsePairwiseAutocorrelation(true);
+    featureCalculator->SetNumberOfThreads(3);
+    auto pairwiseFeatures = featureCalculator->CalculateFeatures(mitkImage, mitkMask);
+
+    std::map<std::string, double> fftResults(fftFeatures.begin(), fftFeatures.end());
+    std::map<std::string, double> pairwiseResults(pairwiseFeatures.begin(), pairwiseFeatures.end());
+    for (std::string name : { "Morphological Density::Volume Moran's I index", "Morphological Density::Volume Geary's C measure" })
+    {
+      MITK_INFO << name << " : " << fftResults[name] << " (FFT), " << pairwiseResults[name] << " (pairwise)";
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(name + " calculated by FFT should equal the pairwise calculation", pairwiseResults[name], fftResults[name], 1e-8);
+    }
+  }
+
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkGIFVolumetricDensityStatistics )
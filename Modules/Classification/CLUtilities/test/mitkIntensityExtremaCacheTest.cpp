@@ -0,0 +1,141 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+#include "mitkIOUtil.h"
+#include <thread>
+
+#include <mitkIntensityExtremaCache.h>
+#include <mitkIntensityQuantifier.h>
+#include <mitkGIFFirstOrderHistogramStatistics.h>
+#include <mitkGIFCooccurenceMatrix2.h>
+#include <mitkGIFFirstOrderStatistics.h>
+#include <mitkGIFVolumetricStatistics.h>
+
+class mitkIntensityExtremaCacheTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkIntensityExtremaCacheTestSuite);
+
+  MITK_TEST(GetExtrema_PhantomTest);
+  MITK_TEST(SharedCache_ConcurrentFeatures_PhantomTest);
+  MITK_TEST(CalculateFeatureClasses_MaskFirstAndImageFirst_PhantomTest);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_IBSI_Phantom_Image_Large;
+  mitk::Image::Pointer m_IBSI_Phantom_Mask_Large;
+
+public:
+
+  void setUp(void) override
+  {
+    m_IBSI_Phantom_Image_Large = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Image_Large.nrrd"));
+    m_IBSI_Phantom_Mask_Large = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Mask_Large.nrrd"));
+  }
+
+  void GetExtrema_PhantomTest()
+  {
+    mitk::IntensityExtremaCache::Pointer cache = mitk::IntensityExtremaCache::New();
+
+    double expectedMinimum, expectedMaximum;
+    mitk::IntensityQuantifier::CalculateExtrema(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large, expectedMinimum, expectedMaximum);
+
+    for (int i = 0; i < 2; ++i)
+    {
+      double minimum, maximum;
+      cache->GetExtrema(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large, minimum, maximum);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Cached minimum should equal the calculated minimum", expectedMinimum, minimum);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Cached maximum should equal the calculated maximum", expectedMaximum, maximum);
+    }
+  }
+
+  void SharedCache_ConcurrentFeatures_PhantomTest()
+  {
+    auto histoReference = mitk::GIFFirstOrderHistogramStatistics::New();
+    auto coocReference = mitk::GIFCooccurenceMatrix2::New();
+    auto histoReferenceList = histoReference->CalculateFeatures(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+    auto coocReferenceList = coocReference->CalculateFeatures(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+
+    mitk::IntensityExtremaCache::Pointer cache = mitk::IntensityExtremaCache::New();
+    auto histoFeature = mitk::GIFFirstOrderHistogramStatistics::New();
+    auto coocFeature = mitk::GIFCooccurenceMatrix2::New();
+    histoFeature->SetIntensityExtremaCache(cache);
+    coocFeature->SetIntensityExtremaCache(cache);
+
+    mitk::AbstractGlobalImageFeature::FeatureListType histoList, coocList;
+    std::thread histoThread([&]() { histoList = histoFeature->CalculateFeatures(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large); });
+    coocList = coocFeature->CalculateFeatures(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+    histoThread.join();
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Shared cache should not change the number of histogram features", histoReferenceList.size(), histoList.size());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Shared cache should not change the number of co-occurence features", coocReferenceList.size(), coocList.size());
+    for (std::size_t i = 0; i < histoList.size(); ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(histoReferenceList[i].first, histoList[i].first);
+      if (histoReferenceList[i].second == histoReferenceList[i].second)
+      {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(histoList[i].first, histoReferenceList[i].second, histoList[i].second, 1e-12);
+      }
+    }
+    for (std::size_t i = 0; i < coocList.size(); ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(coocReferenceList[i].first, coocList[i].first);
+      if (coocReferenceList[i].second == coocReferenceList[i].second)
+      {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(coocList[i].first, coocReferenceList[i].second, coocList[i].second, 1e-12);
+      }
+    }
+  }
+
+  // GIFVolumetricStatistics accesses the mask before the image, GIFFirstOrderStatistics the image before the mask
+  void CalculateFeatureClasses_MaskFirstAndImageFirst_PhantomTest()
+  {
+    mitk::IntensityExtremaCache::Pointer cache = mitk::IntensityExtremaCache::New();
+    std::vector<mitk::AbstractGlobalImageFeature::Pointer> features;
+    features.push_back(mitk::GIFVolumetricStatistics::New().GetPointer());
+    features.push_back(mitk::GIFFirstOrderStatistics::New().GetPointer());
+    for (const auto &feature : features)
+    {
+      mitk::AbstractGlobalImageFeature::ParameterTypes parameter;
+      parameter[feature->GetLongName()] = us::Any(true);
+      feature->SetParameter(parameter);
+      feature->SetIntensityExtremaCache(cache);
+    }
+
+    std::vector<mitk::AbstractGlobalImageFeature::FeatureListType> referenceLists, featureLists;
+    std::vector<double> featureTimes;
+    mitk::AbstractGlobalImageFeature::CalculateFeatureClasses(features, m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large,
+      m_IBSI_Phantom_Mask_Large, 1, referenceLists, featureTimes);
+    cache->Clear();
+    mitk::AbstractGlobalImageFeature::CalculateFeatureClasses(features, m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large,
+      m_IBSI_Phantom_Mask_Large, 2, featureLists, featureTimes);
+
+    CPPUNIT_ASSERT_EQUAL(features.size(), featureLists.size());
+    for (std::size_t i = 0; i < features.size(); ++i)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Feature class should calculate features", !referenceLists[i].empty());
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Concurrent calculation should not change the number of features", referenceLists[i].size(), featureLists[i].size());
+      for (std::size_t j = 0; j < featureLists[i].size(); ++j)
+      {
+        CPPUNIT_ASSERT_EQUAL(referenceLists[i][j].first, featureLists[i][j].first);
+        if (referenceLists[i][j].second == referenceLists[i][j].second)
+        {
+          CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(featureLists[i][j].first, referenceLists[i][j].second, featureLists[i][j].second, 1e-12);
+        }
+      }
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkIntensityExtremaCache )
@@ -0,0 +1,139 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <itkImage.h>
+#include <itkImageRegionIterator.h>
+#include <itkConstNeighborhoodIterator.h>
+#include <itkMultiHistogramFilter.h>
+#include <itkLocalStatisticFilter.h>
+
+class mitkSlidingWindowNeighborhoodTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkSlidingWindowNeighborhoodTestSuite);
+
+  MITK_TEST(MultiHistogramFilter_EqualsNeighborhoodIterator);
+  MITK_TEST(LocalStatisticFilter_EqualsNeighborhoodIterator);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<double, 3> ImageType;
+  typedef itk::ConstNeighborhoodIterator<ImageType> NeighborhoodIteratorType;
+
+  ImageType::Pointer m_Image;
+
+public:
+
+  void setUp(void) override
+  {
+    ImageType::SizeType size;
+    size[0] = 13;
+    size[1] = 9;
+    size[2] = 7;
+
+    m_Image = ImageType::New();
+    m_Image->SetRegions(size);
+    m_Image->Allocate();
+
+    itk::ImageRegionIterator<ImageType> iter(m_Image, m_Image->GetLargestPossibleRegion());
+    while (!iter.IsAtEnd())
+    {
+      auto index = iter.GetIndex();
+      iter.Set((index[0] * 7 + index[1] * 13 + index[2] * 29) % 17 - 5.5);
+      ++iter;
+    }
+  }
+
+  void MultiHistogramFilter_EqualsNeighborhoodIterator()
+  {
+    const int bins = 11;
+    const int radius = 2;
+    const double offset = -5.0;
+    const double delta = 1.5;
+
+    typedef itk::MultiHistogramFilter<ImageType, ImageType> FilterType;
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(m_Image);
+    filter->SetOffset(offset);
+    filter->SetDelta(delta);
+    filter->SetBins(bins);
+    filter->SetSize(radius);
+    filter->SetNumberOfThreads(3);
+    filter->Update();
+
+    ImageType::SizeType radiusSize;
+    radiusSize.Fill(radius);
+    NeighborhoodIteratorType inputIter(radiusSize, m_Image, m_Image->GetLargestPossibleRegion());
+    while (!inputIter.IsAtEnd())
+    {
+      std::vector<double> counts(bins, 0);
+      for (unsigned int i = 0; i < inputIter.Size(); ++i)
+      {
+        auto pos = (int)((inputIter.GetPixel(i) - offset) / delta);
+        counts[std::max(0, std::min(bins - 1, pos))] += 1;
+      }
+      for (int i = 0; i < bins; ++i)
+      {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Local histogram should equal the count of the neighbourhood", counts[i], filter->GetOutput(i)->GetPixel(inputIter.GetIndex()));
+      }
+      ++inputIter;
+    }
+  }
+
+  void LocalStatisticFilter_EqualsNeighborhoodIterator()
+  {
+    const int radius = 3;
+
+    typedef itk::LocalStatisticFilter<ImageType, ImageType> FilterType;
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(m_Image);
+    filter->SetSize(radius);
+    filter->SetNumberOfThreads(3);
+    filter->Update();
+
+    ImageType::SizeType radiusSize;
+    radiusSize.Fill(radius);
+    radiusSize[2] = 0;
+    NeighborhoodIteratorType inputIter(radiusSize, m_Image, m_Image->GetLargestPossibleRegion());
+    while (!inputIter.IsAtEnd())
+    {
+      double min = std::numeric_limits<double>::max();
+      double max = std::numeric_limits<double>::lowest();
+      double mean = 0;
+      double squareMean = 0;
+      for (unsigned int i = 0; i < inputIter.Size(); ++i)
+      {
+        double value = inputIter.GetPixel(i);
+        min = std::min(min, value);
+        max = std::max(max, value);
+        mean += value / inputIter.Size();
+        squareMean += value * value / inputIter.Size();
+      }
+
+      auto index = inputIter.GetIndex();
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Local minimum should be exact", min, filter->GetOutput(0)->GetPixel(index));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Local maximum should be exact", max, filter->GetOutput(1)->GetPixel(index));
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Local mean should be equal", mean, filter->GetOutput(2)->GetPixel(index), 1e-10);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Local standard deviation should be equal", std::sqrt(squareMean - mean * mean), filter->GetOutput(3)->GetPixel(index), 1e-6);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Local range should be exact", max - min, filter->GetOutput(4)->GetPixel(index));
+      ++inputIter;
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkSlidingWindowNeighborhood )
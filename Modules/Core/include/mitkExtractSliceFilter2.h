@@ -34,8 +34,11 @@ namespace mitk
    *
    * This filter is completely based on ITK compared to the VTK-based
    * mitk::ExtractSliceFilter. It is more robust, easy to use, and produces
-   * an mitk::Image with valid geometry. Generally it is not as fast as
-   * mitk::ExtractSliceFilter, though.
+   * an mitk::Image with valid geometry.
+   *
+   * The rows of the output image are split into blocks that are resampled
+   * in parallel. Nearest neighbor and linear interpolation read the input
+   * buffer directly and clip each row to the input volume in advance.
    */
   class MITKCORE_EXPORT ExtractSliceFilter2 final : public ImageToImageFilter
   {
@@ -66,9 +69,10 @@ namespace mitk
     ~ExtractSliceFilter2() override;
 
     void AllocateOutputs() override;
-    // void BeforeThreadedGenerateData() override;
-    // void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
-    void GenerateData() override;
+    void BeforeThreadedGenerateData() override;
+    void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+    void AfterThreadedGenerateData() override;
+    unsigned int SplitRequestedRegion(unsigned int i, unsigned int num, OutputImageRegionType& splitRegion) override;
     void VerifyInputInformation() override;
 
     struct Impl;
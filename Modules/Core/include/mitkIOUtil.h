@@ -25,6 +25,8 @@ found in the LICENSE file.
 #include <mitkIFileWriter.h>
 
 #include <fstream>
+#include <functional>
+#include <memory>
 
 namespace us
 {
@@ -313,6 +315,83 @@ namespace mitk
     static std::vector<BaseData::Pointer> Load(const std::vector<std::string> &paths,
                                                const ReaderOptionsFunctorBase *optionsCallback = nullptr);
 
+    /**
+     * @brief Callback of LoadConcurrently() for each file that has been read.
+     *
+     * It is called from the thread that has read the file. @c errorMessage is empty if the file
+     * has been read successfully.
+     */
+    typedef std::function<void(const LoadInfo &loadInfo, const std::string &errorMessage)> FileReadCallback;
+
+    /**
+     * @brief A load operation that reads files concurrently, see LoadConcurrently().
+     *
+     * Except for Cancel() and IsCancelled(), all methods have to be called from the thread
+     * that has started the operation.
+     */
+    class MITKCORE_EXPORT ConcurrentLoad
+    {
+    public:
+      /** @brief Cancels the operation and waits for the files that are being read. */
+      ~ConcurrentLoad();
+
+      /** @brief Stops reading. Files that are being read are finished, the remaining ones are skipped. */
+      void Cancel();
+
+      bool IsCancelled() const;
+
+      /**
+       * @brief Advances the ProgressBar by the files read since the last call.
+       * @return whether all files have been read or skipped
+       */
+      bool UpdateProgress();
+
+      /** @brief Waits until all files have been read or skipped, advancing the ProgressBar. */
+      void Wait();
+
+      /**
+       * @brief Waits for the operation and adds the loaded data to the given DataStorage.
+       *
+       * The data is added in the order of the paths, independent of the order in which the
+       * files have been read, and is appended to LoadInfo::m_Output. Files that have already
+       * been read as part of a previous path (see IFileReader::GetReadFiles()) are skipped.
+       *
+       * @param nodeResult Set the added nodes are appended to, or nullptr.
+       * @param ds DataStorage the nodes are added to, or nullptr.
+       * @return The error messages of all files that could not be read, empty on success.
+       */
+      std::string Finish(DataStorage::SetOfObjects *nodeResult, DataStorage *ds);
+
+      /** @brief One LoadInfo per path, in the order of the paths. */
+      const std::vector<LoadInfo> &GetLoadInfos() const;
+
+    private:
+      friend class IOUtil;
+
+      ConcurrentLoad();
+
+      struct Impl;
+      std::unique_ptr<Impl> d;
+    };
+
+    /**
+     * @brief Starts reading a list of file paths concurrently and returns immediately.
+     *
+     * The readers are selected on the calling thread, calling \c optionsCallback if necessary
+     * like Load() does. Then the files are read by a pool of threads, each file by its own reader
+     * instance. Use the returned ConcurrentLoad to follow the progress, to cancel and to get the
+     * loaded data.
+     *
+     * @param paths A list of absolute file names including the file extension.
+     * @param optionsCallback Pointer to a callback instance, see Load().
+     * @param fileRead Callback called for each file that has been read, see FileReadCallback.
+     * @param numberOfThreads Maximum number of files read at the same time, 0 for the number of cores.
+     */
+    static std::unique_ptr<ConcurrentLoad> LoadConcurrently(const std::vector<std::string> &paths,
+                                                            const ReaderOptionsFunctorBase *optionsCallback = nullptr,
+                                                            const FileReadCallback &fileRead = FileReadCallback(),
+                                                            unsigned int numberOfThreads = 0);
+
     /**
      * @brief Loads the contents of a us::ModuleResource and returns the corresponding mitk::BaseData
      * @param usResource a ModuleResource, representing a BaseData object
@@ -31,6 +31,8 @@ found in the LICENSE file.
 #include <itkHistogram.h>
 #endif
 
+#include <functional>
+
 class vtkImageData;
 
 namespace itk
@@ -169,15 +171,15 @@ namespace mitk
     // virtual mitkIpPicDescriptor* GetPic();
 
     //##Documentation
-    //## @brief Check whether slice @a s at time @a t in channel @a n is set
+    //## @brief Check whether slice @a s at time @a t in channel @a n is set or is loaded on access (see SetVolumeLoader())
     bool IsSliceSet(int s = 0, int t = 0, int n = 0) const override;
 
     //##Documentation
-    //## @brief Check whether volume at time @a t in channel @a n is set
+    //## @brief Check whether volume at time @a t in channel @a n is set or is loaded on access (see SetVolumeLoader())
     bool IsVolumeSet(int t = 0, int n = 0) const override;
 
     //##Documentation
-    //## @brief Check whether the channel @a n is set
+    //## @brief Check whether the channel @a n is set or is loaded on access (see SetVolumeLoader())
     bool IsChannelSet(int n = 0) const override;
 
     //##Documentation
@@ -257,6 +259,28 @@ namespace mitk
                                   int n = 0,
                                   ImportMemoryManagementType importMemoryManagement = CopyMemory);
 
+    /**
+     * @brief Function that provides the data of volume @a t in channel @a n on its first access.
+     *
+     * The function has to set the data of the volume, e.g. by SetImportVolume(), or of the whole channel by
+     * SetImportChannel(). It is called from the thread that accesses the data while the data arrays of the image are
+     * locked.
+     */
+    typedef std::function<void(Image *image, int t, int n)> VolumeLoaderType;
+
+    /**
+     * @brief Defers loading the image data until it is accessed.
+     *
+     * Slices, volumes and channels that are not set are regarded as set afterwards: GetSliceData(), GetVolumeData(),
+     * GetChannelData() and thus the image accessors call @a loader for each volume that is accessed for the first
+     * time. Setting data by SetImportSlice(), SetImportVolume() etc. replaces data that has not been loaded yet.
+     * The next Initialize() removes the loader.
+     */
+    void SetVolumeLoader(const VolumeLoaderType &loader);
+
+    /** @brief Check whether data that is not set yet is loaded on its first access. @sa SetVolumeLoader */
+    bool HasVolumeLoader() const;
+
     //##Documentation
     //## initialize new (or re-initialize) image information
     //## @warning Initialize() by pic assumes a plane, evenly spaced geometry starting at (0,0,0).
@@ -529,6 +553,9 @@ namespace mitk
       */
     void SetGeometry(BaseGeometry *aGeometry3D) override;
 
+    /** \brief Also tells the statistics holder about the modification, see ImageStatisticsHolder. */
+    void Modified() const override;
+
     /**
     * @warning for internal use only
     */
@@ -683,6 +710,18 @@ namespace mitk
 
     void PrintSelf(std::ostream &os, itk::Indent indent) const override;
 
+    /** \brief Marks the statistics of all time steps as modified, e.g. after setting a channel. */
+    void InvalidateStatisticsOfAllTimeSteps();
+
+    /**
+      \brief Called by ImageWriteAccessor before and after the access to the memory [begin, end) of the image, and by
+      GetData() with nullptr for both, because writes to the returned memory cannot be tracked.
+
+      Tells the statistics holder about the modification. Subclasses holding other data derived from the pixels
+      override this to update it for the written memory only.
+    */
+    virtual void PixelsWritten(const void *begin, const void *end);
+
     mutable ImageDataItemPointerArray m_Channels;
     mutable ImageDataItemPointerArray m_Volumes;
     mutable ImageDataItemPointerArray m_Slices;
@@ -726,6 +765,9 @@ namespace mitk
     bool IsVolumeSet_unlocked(int t, int n) const;
     bool IsChannelSet_unlocked(int n) const;
 
+    /** Loads volumes that are not set on first access, see SetVolumeLoader() */
+    VolumeLoaderType m_VolumeLoader;
+
     /** Stores all existing ImageReadAccessors */
     mutable std::vector<ImageAccessorBase *> m_Readers;
     /** Stores all existing ImageWriteAccessors */
@@ -54,6 +54,7 @@ namespace mitk
     friend class ImagePixelAccessor;
 
     friend class Image;
+    friend class ImageStatisticsHolder;
 
     //  template<class TOutputImage>
     //  friend class ImageToItk;
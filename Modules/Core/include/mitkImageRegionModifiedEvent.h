@@ -0,0 +1,62 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKIMAGEREGIONMODIFIEDEVENT_H
+#define MITKIMAGEREGIONMODIFIEDEVENT_H
+
+#include <MitkCoreExports.h>
+
+#include <mitkBaseGeometry.h>
+#include <mitkTimeGeometry.h>
+
+#include <itkEventObject.h>
+
+namespace mitk
+{
+  /**
+  * \brief Invoked by an image after pixels inside a geometry (e.g. the plane of a slice written by a segmentation
+  * tool or by undo/redo) of one of its time steps were changed.
+  *
+  * Observers can update data derived from the image (e.g. statistics) for the changed region only. The image is
+  * already marked as modified when the event is invoked.
+  */
+  class MITKCORE_EXPORT ImageRegionModifiedEvent : public itk::AnyEvent
+  {
+  public:
+    typedef ImageRegionModifiedEvent Self;
+    typedef itk::AnyEvent Superclass;
+
+    ImageRegionModifiedEvent() : m_TimeStep(0) {}
+    ImageRegionModifiedEvent(const BaseGeometry *geometry, TimeStepType timeStep)
+      : m_Geometry(geometry), m_TimeStep(timeStep)
+    {
+    }
+    ImageRegionModifiedEvent(const Self &s) : Superclass(s), m_Geometry(s.m_Geometry), m_TimeStep(s.m_TimeStep) {}
+    ~ImageRegionModifiedEvent() override {}
+
+    const char *GetEventName() const override { return "ImageRegionModifiedEvent"; }
+    bool CheckEvent(const itk::EventObject *e) const override { return dynamic_cast<const Self *>(e) != nullptr; }
+    itk::EventObject *MakeObject() const override { return new Self(*this); }
+
+    /** \brief Geometry of the changed region in world coordinates. */
+    const BaseGeometry *GetGeometry() const { return m_Geometry; }
+    TimeStepType GetTimeStep() const { return m_TimeStep; }
+
+  private:
+    BaseGeometry::ConstPointer m_Geometry;
+    TimeStepType m_TimeStep;
+
+    void operator=(const Self &);
+  };
+}
+
+#endif
@@ -0,0 +1,150 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkImageSliceCache_h
+#define mitkImageSliceCache_h
+
+#include <MitkCoreExports.h>
+#include <mitkExtractSliceFilter.h>
+
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkSmartPointer.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mitk
+{
+  class Image;
+  class PlaneGeometry;
+
+  /**
+    \brief Size-bounded cache of 2D slices resliced from images, shared by all 2D image mappers.
+
+    Several render windows often show the same plane of the same image (e.g. a slice that is rendered both in a
+    2D and in the 3D window, or render windows that are re-rendered without a change of their geometry). The
+    mappers look up a slice by its Key before reslicing and store what they resliced afterwards, so an unchanged
+    slice is resliced only once.
+
+    A key is made of the image, its modification time, the time step, the interpolation mode and the content of
+    the plane geometry, so a modified image or plane never hits an outdated slice. Outdated slices are dropped
+    when the cache exceeds its maximum size, least recently used first.
+
+    Slices are handed out as shared pointers to const data; they stay valid after they were dropped from the cache
+    and must not be modified. All methods are thread-safe.
+  */
+  class MITKCORE_EXPORT ImageSliceCache
+  {
+  public:
+    /** \brief A resliced 2D image together with the reslice axes and the spacing of the slice. */
+    struct Slice
+    {
+      vtkSmartPointer<vtkImageData> m_Image;
+      vtkSmartPointer<vtkMatrix4x4> m_ResliceAxes;
+      ScalarType m_Spacing[2];
+    };
+
+    typedef std::shared_ptr<const Slice> SlicePointer;
+
+    /** \brief Identifies a slice by everything an ExtractSliceFilter needs to reslice it. */
+    class MITKCORE_EXPORT Key
+    {
+    public:
+      Key(const Image *image,
+          const PlaneGeometry *worldGeometry,
+          unsigned int timeStep,
+          ExtractSliceFilter::ResliceInterpolation interpolationMode,
+          bool inPlaneResampleExtentByGeometry);
+
+      bool operator<(const Key &other) const;
+
+    private:
+      const Image *m_Image;
+      unsigned long m_ImageTime;
+      unsigned int m_TimeStep;
+      int m_InterpolationMode;
+      bool m_InPlaneResampleExtentByGeometry;
+      /** \brief Matrices, offsets and bounds of the plane, its reference geometry and the image geometry */
+      std::vector<ScalarType> m_Geometry;
+    };
+
+    static ImageSliceCache *GetInstance();
+
+    /**
+      \brief Returns the slice stored for key, or nullptr.
+
+      Every call counts as either a hit or a miss.
+    */
+    SlicePointer Find(const Key &key);
+
+    /**
+      \brief Copies the current 2D output of reslicer into the cache.
+
+      The reslicer has to be updated with the parameters key was made of.
+      \return the cached copy
+    */
+    SlicePointer Insert(const Key &key, ExtractSliceFilter *reslicer);
+
+    /**
+      \brief Wraps image and the reslice axes and spacing of the last update of reslicer, without caching them.
+
+      Used for slices that are post-processed after reslicing, like thick slices.
+    */
+    static SlicePointer CreateSlice(ExtractSliceFilter *reslicer, vtkImageData *image);
+
+    /** \brief Sets the maximum size of all cached slices in bytes. 0 disables the cache. */
+    void SetMaximumSize(std::size_t bytes);
+    std::size_t GetMaximumSize() const;
+
+    /** \brief Size of all cached slices in bytes */
+    std::size_t GetSize() const;
+
+    std::size_t GetNumberOfSlices() const;
+
+    unsigned long GetNumberOfHits() const;
+    unsigned long GetNumberOfMisses() const;
+    void ResetStatistics();
+
+    /** \brief Drops all slices. */
+    void Clear();
+
+    ImageSliceCache();
+
+    ImageSliceCache(const ImageSliceCache &) = delete;
+    ImageSliceCache &operator=(const ImageSliceCache &) = delete;
+
+  private:
+    typedef std::list<std::pair<Key, SlicePointer>> SliceList;
+
+    static std::size_t GetSizeOfSlice(const Slice &slice);
+
+    /** \brief Drops the least recently used slices until the cache fits into maximumSize. */
+    void Shrink(std::size_t maximumSize);
+
+    mutable std::mutex m_Mutex;
+
+    /** \brief Most recently used slice first */
+    SliceList m_Slices;
+    std::map<Key, SliceList::iterator> m_Index;
+
+    std::size_t m_Size;
+    std::size_t m_MaximumSize;
+    unsigned long m_NumberOfHits;
+    unsigned long m_NumberOfMisses;
+  };
+}
+
+#endif
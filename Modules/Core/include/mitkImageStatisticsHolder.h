@@ -20,6 +20,10 @@ found in the LICENSE file.
 #include <itkHistogram.h>
 #endif
 
+#include <functional>
+#include <mutex>
+#include <vector>
+
 namespace mitk
 {
   /**
@@ -32,6 +36,17 @@ namespace mitk
     GetStatistics() method in mitk::Image class.
 
     Minimum or maximum might by infinite values. 2nd minimum and maximum are guaranteed to be finite values.
+
+    The extrema of a time step are computed in blocks of slices (rows for 2D images), several blocks in parallel,
+    and kept per block. Writing to the image through an ImageWriteAccessor marks the blocks in the accessed memory
+    as modified, so the next request recomputes only those blocks. The setters of Image (SetVolume(), SetSlice(),
+    SetImportVolume() etc.) invalidate the time steps they write to. All other modifications of the image (e.g.
+    writing to its vtkImageData or to the memory returned by Image::GetData()) invalidate all statistics, like
+    before: every call of Image::Modified() that was not preceded by a tracked write leads to a full recomputation.
+    Code that writes pixels without an accessor should call InvalidateTimeStep() before Modified(), so only the
+    written time step is recomputed.
+
+    Histograms are kept per time step until the statistics of the time step are invalidated.
     */
   class MITKCORE_EXPORT ImageStatisticsHolder
   {
@@ -137,6 +152,31 @@ namespace mitk
 
     bool IsValidTimeStep(int t) const;
 
+    /**
+      \brief Marks the statistics of the pixels in the memory [begin, end) of the image as modified.
+
+      Called by ImageWriteAccessor before and after the access. Invalidates the statistics of all time steps if the
+      memory does not belong to a volume or channel of the image.
+    */
+    void InvalidateMemory(const void *begin, const void *end);
+
+    /** \brief Marks the statistics of time step t as modified, see InvalidateMemory(). */
+    void InvalidateTimeStep(int t);
+
+    /** \brief Invalidates all statistics at the next request, because the pixels may be written untracked.
+
+      Called by Image::GetData(), which hands out a writable pointer to all pixels of the image.
+    */
+    void InvalidateAll();
+
+    /**
+      \brief Called by Image::Modified().
+
+      Invalidates all statistics at the next request, unless the modification was announced by InvalidateMemory()
+      or InvalidateTimeStep() since the previous call.
+    */
+    void ImageModified();
+
     template <typename ItkImageType>
     friend void _ComputeExtremaInItkImage(const ItkImageType *itkImage,
                                           mitk::ImageStatisticsHolder *statisticsHolder,
@@ -149,6 +189,89 @@ namespace mitk
                                                 unsigned int component);
 
   protected:
+    /** \brief Extrema of a part of a time step */
+    struct Extrema
+    {
+      Extrema();
+
+      void Add(ScalarType value)
+      {
+        if (value < m_Min)
+        {
+          m_2ndMin = m_Min;
+          m_Min = value;
+          m_CountOfMin = 1;
+        }
+        else if (value == m_Min)
+        {
+          ++m_CountOfMin;
+        }
+        else if (value < m_2ndMin)
+        {
+          m_2ndMin = value;
+        }
+
+        if (value > m_Max)
+        {
+          m_2ndMax = m_Max;
+          m_Max = value;
+          m_CountOfMax = 1;
+        }
+        else if (value == m_Max)
+        {
+          ++m_CountOfMax;
+        }
+        else if (value > m_2ndMax)
+        {
+          m_2ndMax = value;
+        }
+      }
+
+      /** \brief Combines the extrema of another part, as if its values were added */
+      void Merge(const Extrema &other);
+
+      ScalarType m_Min;
+      ScalarType m_2ndMin;
+      ScalarType m_Max;
+      ScalarType m_2ndMax;
+      unsigned int m_CountOfMin;
+      unsigned int m_CountOfMax;
+    };
+
+    /** \brief Extrema of the blocks of a time step. A block consists of m_SlicesPerBlock slices. */
+    struct TimeStepExtrema
+    {
+      TimeStepExtrema() : m_Component(0), m_NumberOfSlices(0), m_SlicesPerBlock(1) {}
+
+      std::vector<Extrema> m_Blocks;
+      std::vector<bool> m_ModifiedBlocks;
+      unsigned int m_Component;
+      unsigned int m_NumberOfSlices;
+      unsigned int m_SlicesPerBlock;
+    };
+
+    /** \brief Computes the extrema of slices [firstSlice, firstSlice + numberOfSlices) of the time step */
+    typedef std::function<void(unsigned int firstSlice, unsigned int numberOfSlices, Extrema &extrema)>
+      BlockFunctionType;
+
+    /**
+      \brief Recomputes the modified blocks of time step t in parallel and stores the merged extrema.
+
+      \param numberOfSlices the size of the time step along its last dimension
+      \param pixelsPerSlice number of pixels in one of these slices, used to choose the size of the blocks
+    */
+    void ComputeExtremaInBlocks(int t,
+                                unsigned int component,
+                                unsigned int numberOfSlices,
+                                std::size_t pixelsPerSlice,
+                                const BlockFunctionType &blockFunction);
+
+    /** \brief Invalidates all statistics if the image was modified other than through write accessors. */
+    void CheckImageModified();
+
+    /** \brief Checks if the statistics of time step t need to be (partly) recomputed. */
+    bool IsModified(int t, unsigned int component);
+
     virtual void ResetImageStatistics();
 
     virtual void ComputeImageStatistics(int t = 0, unsigned int component = 0);
@@ -170,6 +293,18 @@ namespace mitk
     mutable std::vector<ScalarType> m_Scalar2ndMax;
 
     itk::TimeStamp m_LastRecomputeTimeStamp;
+
+    /** \brief Guards m_TimeStepExtrema, m_Histograms and the modification flags, which write accessors modify */
+    std::mutex m_Mutex;
+    std::vector<TimeStepExtrema> m_TimeStepExtrema;
+    std::vector<HistogramType::ConstPointer> m_Histograms;
+
+    /** \brief Whether blocks were invalidated since the image modification time was checked the last time */
+    bool m_HasInvalidatedBlocks;
+    /** \brief Whether blocks were invalidated since the last call of ImageModified() */
+    bool m_HasPendingTrackedWrite;
+    /** \brief Whether the image was modified untracked since the modification time was checked the last time */
+    bool m_HasUntrackedModification;
   };
 
 } // end namespace
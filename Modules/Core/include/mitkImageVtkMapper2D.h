@@ -19,6 +19,7 @@ found in the LICENSE file.
 // MITK Rendering
 #include "mitkBaseRenderer.h"
 #include "mitkExtractSliceFilter.h"
+#include "mitkImageSliceCache.h"
 #include "mitkVtkMapper.h"
 
 // VTK
@@ -181,7 +182,11 @@ namespace mitk
       itk::TimeStamp m_LastUpdateTime;
 
       /** \brief mmPerPixel relation between pixel and mm. (World spacing).*/
-      mitk::ScalarType *m_mmPerPixel;
+      const mitk::ScalarType *m_mmPerPixel;
+
+      /** \brief Current slice together with its reslice axes, possibly shared with other renderers
+            via the ImageSliceCache. */
+      ImageSliceCache::SlicePointer m_Slice;
 
       /** \brief This filter is used to apply the level window to Grayvalue and RBG(A) images. */
       vtkSmartPointer<vtkMitkLevelWindowFilter> m_LevelWindowFilter;
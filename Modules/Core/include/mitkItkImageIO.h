@@ -33,6 +33,22 @@ namespace mitk
     ItkImageIO(itk::ImageIOBase::Pointer imageIO);
     ItkImageIO(const CustomMimeType &mimeType, itk::ImageIOBase::Pointer imageIO, int rank);
 
+    /**
+     * @brief Reader option that defines when the image data is read.
+     *
+     * One of DATA_LOADING_IMMEDIATELY() (default), DATA_LOADING_ON_ACCESS() or DATA_LOADING_IN_BACKGROUND().
+     * With the latter two, Read() returns after reading the image header and the image reads its data on first
+     * access (see Image::SetVolumeLoader()). Each volume of a 3D+t image is read separately if the ITK ImageIO
+     * supports streamed reading, e.g. for uncompressed files; otherwise the whole file is read at once.
+     * In background mode, all volumes are read by another thread in the order of their time steps, so that
+     * the first time steps can be used before the whole file has been read.
+     */
+    static std::string OPTION_DATA_LOADING();
+    static std::string OPTION_DATA_LOADING_ENUM();
+    static std::string DATA_LOADING_IMMEDIATELY();
+    static std::string DATA_LOADING_ON_ACCESS();
+    static std::string DATA_LOADING_IN_BACKGROUND();
+
     // -------------- AbstractFileReader -------------
 
     using AbstractFileReader::Read;
@@ -52,6 +68,9 @@ namespace mitk
     // Fills the m_DefaultMetaDataKeys vector with default values
     virtual void InitializeDefaultMetaDataKeys();
 
+    // Sets the default reader options, see OPTION_DATA_LOADING()
+    void InitializeDefaultReaderOptions();
+
   private:
     ItkImageIO(const ItkImageIO &other);
 
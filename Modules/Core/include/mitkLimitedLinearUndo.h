@@ -25,6 +25,7 @@ found in the LICENSE file.
 #pragma GCC visibility pop
 
 #include <deque>
+#include <map>
 
 namespace mitk
 {
@@ -99,6 +100,23 @@ namespace mitk
     //## @param limit the maximum number of items on the stack
     void SetUndoLimit(std::size_t limit) override;
 
+    //##Documentation
+    //## @brief Gets the limit on the memory held by the undo history in bytes.
+    //## If the value is 0 that means that there is no limit.
+    std::size_t GetMemoryLimit() const override;
+
+    //##Documentation
+    //## @brief Sets a limit on the memory held by undo and redo stack in bytes.
+    //## If the limit is exceeded, the oldest undo items will
+    //## be dropped from the bottom of the undo stack. The newest item is always kept.
+    //## The 0 value means that there is no limit.
+    //## @param limit the maximum number of bytes
+    void SetMemoryLimit(std::size_t limit) override;
+
+    //##Documentation
+    //## @brief Returns the number of bytes currently held by undo and redo stack
+    std::size_t GetMemoryUsage() const override;
+
     //##Documentation
     //## @brief Returns the ObjectEventId of the
     //## top element in the OperationHistory
@@ -127,6 +145,10 @@ namespace mitk
     //## elements in the list and to clear the list
     void ClearList(UndoContainer *list);
 
+    //## @brief Appends an item to the undo stack and drops the oldest items
+    //## as long as the undo limit or the memory limit is exceeded
+    void PushUndoItem(UndoStackItem *item);
+
     UndoContainer m_UndoList;
 
     UndoContainer m_RedoList;
@@ -134,8 +156,18 @@ namespace mitk
   private:
     int FirstObjectEventIdOfCurrentGroup(UndoContainer &stack);
 
+    //## @brief Deletes an item that was removed from the stacks and releases the memory it was charged with
+    void DeleteItem(UndoStackItem *item);
+
     std::size_t m_UndoLimit;
 
+    std::size_t m_MemoryLimit;
+
+    std::size_t m_MemoryUsage;
+
+    //## @brief Memory usage of each item when it was pushed, subtracted again when the item is deleted
+    std::map<const UndoStackItem *, std::size_t> m_ItemMemoryUsage;
+
   };
 
 #pragma GCC visibility push(default)
@@ -147,8 +179,9 @@ namespace mitk
   itkEventMacro(RedoEmptyEvent, UndoStackEvent);
   itkEventMacro(UndoNotEmptyEvent, UndoStackEvent);
   itkEventMacro(RedoNotEmptyEvent, UndoStackEvent);
-  /// Additional unused events, if anybody wants to put an artificial limit to the possible number of items in the stack
+  /// Signals that items were dropped from the bottom of the undo stack because the undo limit or the memory limit was reached
   itkEventMacro(UndoFullEvent, UndoStackEvent);
+  /// Additional unused event, if anybody wants to put an artificial limit to the possible number of items in the stack
   itkEventMacro(RedoFullEvent, UndoStackEvent);
 
 #pragma GCC visibility pop
@@ -41,6 +41,10 @@ namespace mitk
       return parser.str();
     }
     \endcode
+
+    Switches to the same locale in concurrent threads, e.g. while reading
+    files concurrently, share the switched locale: the previous locale is
+    restored when the last of them is destroyed.
   */
 
   struct MITKCORE_EXPORT LocaleSwitch
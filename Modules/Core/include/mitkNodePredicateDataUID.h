@@ -34,6 +34,8 @@ namespace mitk
 
     bool CheckNode(const mitk::DataNode *node) const override;
 
+    const Identifiable::UIDType &GetUID() const { return m_UID; }
+
   protected:
     explicit NodePredicateDataUID(const Identifiable::UIDType &uid);
 
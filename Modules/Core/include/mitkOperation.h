@@ -39,6 +39,13 @@ namespace mitk
 
     OperationType GetOperationType();
 
+    //##Documentation
+    //## @brief Returns the approximate number of bytes of data held by the operation.
+    //##
+    //## Used by the undo models to limit their memory consumption. The default implementation
+    //## returns 0, operations storing considerable amounts of data (e.g. image slices) should override it.
+    virtual std::size_t GetMemoryUsage() const;
+
   protected:
     OperationType m_OperationType;
   };
@@ -17,6 +17,7 @@ found in the LICENSE file.
 #include "mitkDataStorage.h"
 #include "mitkMessage.h"
 #include <map>
+#include <set>
 
 namespace mitk
 {
@@ -87,6 +88,33 @@ namespace mitk
     //##
     SetOfObjects::ConstPointer GetAll() const override;
 
+    //##Documentation
+    //## @brief returns a set of data objects that meet the given condition(s)
+    //##
+    //## The StandaloneDataStorage keeps secondary indexes of the data type, the data UID and
+    //## the values of selected properties (see AddIndexedPropertyKey()) of all nodes.
+    //## Conditions of type NodePredicateDataType, NodePredicateDataUID and NodePredicateProperty
+    //## (without renderer and for an indexed property key) are answered from these indexes.
+    //## A NodePredicateAnd uses the first of its children that can be answered from an index,
+    //## a NodePredicateOr can use the indexes if all of its children can. The condition itself
+    //## is still checked for every candidate. All other conditions are checked for every node.
+    //##
+    //## The indexes are updated whenever a node or one of its indexed properties sends a
+    //## ModifiedEvent. Property values are indexed by BaseProperty::GetValueAsString(), so only
+    //## properties with a meaningful string representation should be indexed. The UID of a
+    //## data object is expected not to change while the data object is in the storage.
+    SetOfObjects::ConstPointer GetSubset(const NodePredicateBase *condition) const override;
+
+    //##Documentation
+    //## @brief Adds a property key to the keys whose values are indexed
+    //##
+    //## The "name" property is indexed by default.
+    void AddIndexedPropertyKey(const std::string &propertyKey);
+
+    //##Documentation
+    //## @brief Returns the property keys whose values are indexed
+    std::set<std::string> GetIndexedPropertyKeys() const;
+
     /*ITK Mutex */
     mutable itk::SimpleFastMutexLock m_Mutex;
 
@@ -121,12 +149,89 @@ namespace mitk
     //## @brief Prints the contents of the StandaloneDataStorage to os. Do not call directly, call ->Print() instead
     void PrintSelf(std::ostream &os, itk::Indent indent) const override;
 
+    //##Documentation
+    //## @brief Set of nodes, ordered the same way as the nodes in the adjacency lists
+    typedef std::set<const mitk::DataNode *> NodeSet;
+
+    //##Documentation
+    //## @brief Indexed values of a single node
+    struct IndexEntry
+    {
+      IndexEntry() : HasData(false) {}
+
+      bool HasData;
+      std::string DataType;
+      Identifiable::UIDType DataUID;
+      //## property key -> (property of the node's renderer independent property list, value as string)
+      std::map<std::string, std::pair<const BaseProperty *, std::string>> Properties;
+    };
+
+    //##Documentation
+    //## @brief An indexed property object and the nodes it is indexed for
+    struct ObservedProperty
+    {
+      BaseProperty::ConstPointer Property;
+      unsigned long ObserverTag;
+      std::multiset<const mitk::DataNode *> Nodes;
+    };
+
+    //##Documentation
+    //## @brief Collects the indexed values of node
+    IndexEntry CreateIndexEntry(const mitk::DataNode *node) const;
+
+    //##Documentation
+    //## @brief Adds node to the indexes and starts observing it and its indexed properties (m_Mutex must be locked)
+    void AddToIndex(const mitk::DataNode *node);
+
+    //##Documentation
+    //## @brief Removes node from the indexes and stops observing it (m_Mutex must be locked)
+    void RemoveFromIndex(const mitk::DataNode *node);
+
+    //##Documentation
+    //## @brief Re-indexes node after it or one of its indexed properties has been modified (m_Mutex must be locked)
+    void UpdateIndex(const mitk::DataNode *node);
+
+    void InsertIndexEntry(const mitk::DataNode *node, const IndexEntry &entry);
+    void EraseIndexEntry(const mitk::DataNode *node, const IndexEntry &entry);
+    void ObserveProperty(const mitk::DataNode *node, const BaseProperty *property);
+    void UnobserveProperty(const mitk::DataNode *node, const BaseProperty *property);
+
+    //##Documentation
+    //## @brief Collects the nodes that may fulfill condition from the indexes (m_Mutex must be locked)
+    //##
+    //## Returns false if the condition cannot be answered from the indexes.
+    bool GetIndexCandidates(const NodePredicateBase *condition, NodeSet &candidates) const;
+
+    void OnIndexedNodeModified(const itk::Object *caller, const itk::EventObject &event);
+    void OnIndexedPropertyModified(const itk::Object *caller, const itk::EventObject &event);
+
     //##Documentation
     //## @brief Nodes and their relation are stored in m_SourceNodes
     AdjacencyList m_SourceNodes;
     //##Documentation
     //## @brief Nodes are stored in reverse relation for easier traversal in the opposite direction of the relation
     AdjacencyList m_DerivedNodes;
+
+    std::set<std::string> m_IndexedPropertyKeys;
+    std::map<const mitk::DataNode *, IndexEntry> m_IndexEntries;
+    std::map<const mitk::DataNode *, unsigned long> m_IndexObserverTags;
+    std::map<const BaseProperty *, ObservedProperty> m_ObservedProperties;
+
+    //##Documentation
+    //## @brief data type (class name) -> nodes
+    std::map<std::string, NodeSet> m_DataTypeIndex;
+    //##Documentation
+    //## @brief data UID -> nodes
+    std::map<Identifiable::UIDType, NodeSet> m_DataUIDIndex;
+    //##Documentation
+    //## @brief property key -> property value -> nodes
+    std::map<std::string, std::map<std::string, NodeSet>> m_PropertyIndex;
+    //##Documentation
+    //## @brief property key -> nodes without that property in their own property list
+    //##
+    //## These nodes can still have the property in the property list of their data and are
+    //## therefore candidates for every condition on that key.
+    std::map<std::string, NodeSet> m_NodesWithoutIndexedProperty;
   };
 } // namespace mitk
 #endif /* MITKSTANDALONEDATASTORAGE_H_HEADER_INCLUDED_ */
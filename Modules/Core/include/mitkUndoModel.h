@@ -71,6 +71,24 @@ namespace mitk
     //## @param limit the maximum number of items on the stack
     virtual void SetUndoLimit(std::size_t limit) = 0;
 
+    //##Documentation
+    //## @brief Gets the limit on the memory held by the undo history in bytes.
+    //## If the value is 0 that means that there is no limit.
+    virtual std::size_t GetMemoryLimit() const = 0;
+
+    //##Documentation
+    //## @brief Sets a limit on the memory held by undo and redo stack in bytes.
+    //## If the limit is exceeded, the oldest undo items will
+    //## be dropped from the bottom of the undo stack. The newest item is always kept.
+    //## The 0 value means that there is no limit.
+    //## @param limit the maximum number of bytes
+    virtual void SetMemoryLimit(std::size_t limit) = 0;
+
+    //##Documentation
+    //## @brief Returns the number of bytes currently held by undo and redo stack,
+    //## as reported by UndoStackItem::GetMemoryUsage()
+    virtual std::size_t GetMemoryUsage() const = 0;
+
     //##Documentation
     //## @brief returns the ObjectEventId of the
     //## top Element in the OperationHistory of the selected
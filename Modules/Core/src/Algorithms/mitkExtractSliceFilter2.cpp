@@ -16,9 +16,11 @@ found in the LICENSE file.
 #include <mitkImageWriteAccessor.h>
 
 #include <itkBSplineInterpolateImageFunction.h>
-#include <itkLinearInterpolateImageFunction.h>
-#include <itkNearestNeighborInterpolateImageFunction.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
 #include <limits>
 
 struct mitk::ExtractSliceFilter2::Impl
@@ -29,10 +31,13 @@ struct mitk::ExtractSliceFilter2::Impl
   PlaneGeometry::Pointer OutputGeometry;
   mitk::ExtractSliceFilter2::Interpolator Interpolator;
   itk::Object::Pointer InterpolateImageFunction;
+  itk::ModifiedTimeType InterpolateImageFunctionTime;
+  std::function<void(const OutputImageRegionType&)> GenerateRegion;
 };
 
 mitk::ExtractSliceFilter2::Impl::Impl()
-  : Interpolator(NearestNeighbor)
+  : Interpolator(NearestNeighbor),
+    InterpolateImageFunctionTime(0)
 {
 }
 
@@ -43,45 +48,168 @@ mitk::ExtractSliceFilter2::Impl::~Impl()
 namespace
 {
   template <class TInputImage>
-  void CreateInterpolateImageFunction(const TInputImage* inputImage, mitk::ExtractSliceFilter2::Interpolator interpolator, itk::Object::Pointer& result)
+  void CreateInterpolateImageFunction(const TInputImage* inputImage, itk::Object::Pointer& result)
   {
-    typename itk::InterpolateImageFunction<TInputImage>::Pointer interpolateImageFunction;
+    auto bSplineInterpolateImageFunction = itk::BSplineInterpolateImageFunction<TInputImage>::New();
+    bSplineInterpolateImageFunction->SetSplineOrder(2);
+    bSplineInterpolateImageFunction->SetInputImage(inputImage);
 
-    switch (interpolator)
+    result = bSplineInterpolateImageFunction.GetPointer();
+  }
+
+  /** \brief Samples a 3-d pixel buffer at continuous indices relative to the first pixel of the buffer.
+   *
+   * All methods expect indices that passed IsInside(), so they do not check any bounds themselves.
+   */
+  template <typename TPixel>
+  class BufferSampler
+  {
+  public:
+    template <class TInputImage>
+    explicit BufferSampler(const TInputImage* inputImage)
+      : m_Buffer(inputImage->GetBufferPointer())
     {
-      case mitk::ExtractSliceFilter2::NearestNeighbor:
-        interpolateImageFunction = itk::NearestNeighborInterpolateImageFunction<TInputImage>::New().GetPointer();
-        break;
+      auto size = inputImage->GetBufferedRegion().GetSize();
+
+      for (int i = 0; i < 3; ++i)
+      {
+        m_MaxIndex[i] = static_cast<long>(size[i]) - 1;
+        m_UpperBound[i] = static_cast<double>(size[i]) - 0.5;
+      }
+
+      m_Stride[0] = 1;
+      m_Stride[1] = static_cast<std::ptrdiff_t>(size[0]);
+      m_Stride[2] = static_cast<std::ptrdiff_t>(size[0] * size[1]);
+    }
+
+    /** \brief Same bounds as itk::ImageRegion::IsInside() for continuous indices. */
+    bool IsInside(const double* index) const
+    {
+      return index[0] >= -0.5 && index[0] < m_UpperBound[0] &&
+             index[1] >= -0.5 && index[1] < m_UpperBound[1] &&
+             index[2] >= -0.5 && index[2] < m_UpperBound[2];
+    }
 
-      case mitk::ExtractSliceFilter2::Linear:
-        interpolateImageFunction = itk::LinearInterpolateImageFunction<TInputImage>::New().GetPointer();
-        break;
+    /** \brief Range [lower, upper) of the line index + n * step that is inside, clipped to [begin, end). */
+    void ClipLine(const double* index, const double* step, long begin, long end, long& lower, long& upper) const
+    {
+      double first = static_cast<double>(begin);
+      double last = static_cast<double>(end);
 
-      case mitk::ExtractSliceFilter2::Cubic:
+      for (int i = 0; i < 3 && first < last; ++i)
       {
-        auto bSplineInterpolateImageFunction = itk::BSplineInterpolateImageFunction<TInputImage>::New();
-        bSplineInterpolateImageFunction->SetSplineOrder(2);
-        interpolateImageFunction = bSplineInterpolateImageFunction.GetPointer();
-        break;
+        if (0.0 == step[i])
+        {
+          if (index[i] < -0.5 || index[i] >= m_UpperBound[i])
+            last = first;
+        }
+        else
+        {
+          double a = (-0.5 - index[i]) / step[i];
+          double b = (m_UpperBound[i] - index[i]) / step[i];
+
+          if (a > b)
+            std::swap(a, b);
+
+          first = std::max(first, std::ceil(a));
+          last = std::min(last, std::floor(b) + 1.0);
+        }
       }
 
-      default:
-        mitkThrow() << "Interplator is unknown.";
+      lower = static_cast<long>(first);
+      upper = std::max(lower, static_cast<long>(last));
+
+      // the range is convex, so only its ends can suffer from rounding errors
+      const auto isInside = [&](long n) {
+        const double point[3] = { index[0] + n * step[0], index[1] + n * step[1], index[2] + n * step[2] };
+        return this->IsInside(point);
+      };
+
+      while (lower < upper && !isInside(lower))
+        ++lower;
+
+      while (upper > lower && !isInside(upper - 1))
+        --upper;
+
+      if (lower == upper)
+        return;
+
+      while (lower > begin && isInside(lower - 1))
+        --lower;
+
+      while (upper < end && isInside(upper))
+        ++upper;
     }
 
-    interpolateImageFunction->SetInputImage(inputImage);
+    TPixel Nearest(const double* index) const
+    {
+      // indices are >= -0.5, so truncation rounds half up like itk::NearestNeighborInterpolateImageFunction
+      return m_Buffer[static_cast<long>(index[0] + 0.5) * m_Stride[0] +
+                      static_cast<long>(index[1] + 0.5) * m_Stride[1] +
+                      static_cast<long>(index[2] + 0.5) * m_Stride[2]];
+    }
 
-    result = interpolateImageFunction.GetPointer();
-  }
+    /** \brief Trilinear interpolation that repeats the border pixels like itk::LinearInterpolateImageFunction. */
+    TPixel Linear(const double* index) const
+    {
+      std::ptrdiff_t offset[3][2];
+      double weight[3];
+
+      for (int i = 0; i < 3; ++i)
+      {
+        auto base = static_cast<long>(std::floor(index[i]));
+        weight[i] = index[i] - base;
 
+        if (base < 0)
+        {
+          base = 0;
+          weight[i] = 0.0;
+        }
+
+        offset[i][0] = base * m_Stride[i];
+        offset[i][1] = std::min(base + 1, m_MaxIndex[i]) * m_Stride[i];
+      }
+
+      double value = 0.0;
+
+      for (int z = 0; z < 2; ++z)
+      {
+        const double wz = z ? weight[2] : 1.0 - weight[2];
+        double valueY = 0.0;
+
+        for (int y = 0; y < 2; ++y)
+        {
+          const double wy = y ? weight[1] : 1.0 - weight[1];
+          const TPixel* row = m_Buffer + offset[2][z] + offset[1][y];
+          valueY += wy * ((1.0 - weight[0]) * row[offset[0][0]] + weight[0] * row[offset[0][1]]);
+        }
+
+        value += wz * valueY;
+      }
+
+      return static_cast<TPixel>(value);
+    }
+
+  private:
+    const TPixel* m_Buffer;
+    long m_MaxIndex[3];
+    double m_UpperBound[3];
+    std::ptrdiff_t m_Stride[3];
+  };
+
+  /** \brief Creates the function that resamples a region of rows of the output image.
+   *
+   * The continuous input index of an output pixel is an affine function of its output index, so each row is
+   * walked with a constant index step and clipped to the input volume once. The pixels in between are
+   * sampled without any further bounds checks or coordinate transformations.
+   */
   template <typename TPixel, unsigned int VImageDimension>
-  void GenerateData(const itk::Image<TPixel, VImageDimension>* inputImage, mitk::Image* outputImage, const mitk::ExtractSliceFilter2::OutputImageRegionType& outputRegion, itk::Object* interpolateImageFunction)
+  void CreateRegionGenerator(const itk::Image<TPixel, VImageDimension>* inputImage, mitk::Image* outputImage, mitk::ExtractSliceFilter2::Interpolator interpolator, itk::Object* interpolateImageFunction, std::function<void(const mitk::ExtractSliceFilter2::OutputImageRegionType&)>& result)
   {
     typedef itk::Image<TPixel, VImageDimension> TInputImage;
     typedef itk::InterpolateImageFunction<TInputImage> TInterpolateImageFunction;
 
     auto outputGeometry = outputImage->GetSlicedGeometry()->GetPlaneGeometry(0);
-    auto interpolator = static_cast<TInterpolateImageFunction*>(interpolateImageFunction);
 
     auto origin = outputGeometry->GetOrigin();
     auto spacing = outputGeometry->GetSpacing();
@@ -91,45 +219,107 @@ namespace
     xDirection.Normalize();
     yDirection.Normalize();
 
-    auto spacingAlongXDirection = xDirection * spacing[0];
-    auto spacingAlongYDirection = yDirection * spacing[1];
+    const auto toIndex = inputImage->GetPhysicalPointToIndexMatrix();
+    const auto bufferStart = inputImage->GetBufferedRegion().GetIndex();
 
-    const std::size_t pixelSize = outputImage->GetPixelType().GetSize();
-    const std::size_t width = outputGeometry->GetExtent(0);
-    const std::size_t xBegin = outputRegion.GetIndex(0);
-    const std::size_t yBegin = outputRegion.GetIndex(1);
-    const std::size_t xEnd = xBegin + outputRegion.GetSize(0);
-    const std::size_t yEnd = yBegin + outputRegion.GetSize(1);
+    itk::Vector<double, 3> originOffset;
+    for (int i = 0; i < 3; ++i)
+      originOffset[i] = origin[i] - inputImage->GetOrigin()[i];
 
-    mitk::ImageWriteAccessor writeAccess(outputImage, nullptr, mitk::ImageAccessorBase::IgnoreLock);
-    auto data = static_cast<char*>(writeAccess.GetData());
+    // continuous index relative to the buffer of output pixel (x, y) is origin + x * xStep + y * yStep
+    std::array<double, 3> originIndex, xStep, yStep;
+    {
+      itk::Vector<double, 3> x, y;
+      for (int i = 0; i < 3; ++i)
+      {
+        x[i] = xDirection[i] * spacing[0];
+        y[i] = yDirection[i] * spacing[1];
+      }
+
+      const auto o = toIndex * originOffset;
+      const auto dx = toIndex * x;
+      const auto dy = toIndex * y;
 
-    const TPixel backgroundPixel = std::numeric_limits<TPixel>::lowest();
-    TPixel pixel;
+      for (int i = 0; i < 3; ++i)
+      {
+        originIndex[i] = o[i] - bufferStart[i];
+        xStep[i] = dx[i];
+        yStep[i] = dy[i];
+      }
+    }
 
-    itk::ContinuousIndex<mitk::ScalarType, 3> index;
-    mitk::Point3D yPoint;
-    mitk::Point3D point;
+    const long width = static_cast<long>(outputGeometry->GetExtent(0));
 
-    for (std::size_t y = yBegin; y < yEnd; ++y)
+    mitk::ImageWriteAccessor writeAccess(outputImage, nullptr, mitk::ImageAccessorBase::IgnoreLock);
+    auto data = static_cast<TPixel*>(writeAccess.GetData());
+
+    typename TInputImage::ConstPointer input = inputImage;
+    typename TInterpolateImageFunction::ConstPointer cubicInterpolator = static_cast<TInterpolateImageFunction*>(interpolateImageFunction);
+
+    result = [=](const mitk::ExtractSliceFilter2::OutputImageRegionType& outputRegion)
     {
-      yPoint = origin + spacingAlongYDirection * y;
+      const BufferSampler<TPixel> sampler(input.GetPointer());
+      const TPixel backgroundPixel = std::numeric_limits<TPixel>::lowest();
+
+      const long xBegin = outputRegion.GetIndex(0);
+      const long yBegin = outputRegion.GetIndex(1);
+      const long xEnd = xBegin + static_cast<long>(outputRegion.GetSize(0));
+      const long yEnd = yBegin + static_cast<long>(outputRegion.GetSize(1));
+
+      itk::ContinuousIndex<mitk::ScalarType, 3> continuousIndex;
 
-      for (std::size_t x = xBegin; x < xEnd; ++x)
+      for (long y = yBegin; y < yEnd; ++y)
       {
-        point = yPoint + spacingAlongXDirection * x;
+        const double rowIndex[3] = {
+          originIndex[0] + y * yStep[0],
+          originIndex[1] + y * yStep[1],
+          originIndex[2] + y * yStep[2]
+        };
 
-        if (inputImage->TransformPhysicalPointToContinuousIndex(point, index))
-        {
-          pixel = interpolator->EvaluateAtContinuousIndex(index);
-          memcpy(static_cast<void*>(data + pixelSize * (width * y + x)), static_cast<const void*>(&pixel), pixelSize);
-        }
-        else
+        TPixel* row = data + width * y;
+
+        long lower, upper;
+        sampler.ClipLine(rowIndex, xStep.data(), xBegin, xEnd, lower, upper);
+
+        std::fill(row + xBegin, row + lower, backgroundPixel);
+        std::fill(row + upper, row + xEnd, backgroundPixel);
+
+        double index[3];
+
+        switch (interpolator)
         {
-          memcpy(static_cast<void*>(data + pixelSize * (width * y + x)), static_cast<const void*>(&backgroundPixel), pixelSize);
+          case mitk::ExtractSliceFilter2::NearestNeighbor:
+            for (long x = lower; x < upper; ++x)
+            {
+              index[0] = rowIndex[0] + x * xStep[0];
+              index[1] = rowIndex[1] + x * xStep[1];
+              index[2] = rowIndex[2] + x * xStep[2];
+              row[x] = sampler.Nearest(index);
+            }
+            break;
+
+          case mitk::ExtractSliceFilter2::Linear:
+            for (long x = lower; x < upper; ++x)
+            {
+              index[0] = rowIndex[0] + x * xStep[0];
+              index[1] = rowIndex[1] + x * xStep[1];
+              index[2] = rowIndex[2] + x * xStep[2];
+              row[x] = sampler.Linear(index);
+            }
+            break;
+
+          case mitk::ExtractSliceFilter2::Cubic:
+            for (long x = lower; x < upper; ++x)
+            {
+              for (int i = 0; i < 3; ++i)
+                continuousIndex[i] = rowIndex[i] + x * xStep[i] + bufferStart[i];
+
+              row[x] = static_cast<TPixel>(cubicInterpolator->EvaluateAtContinuousIndex(continuousIndex));
+            }
+            break;
         }
       }
-    }
+    };
   }
 
   void VerifyInputImage(const mitk::Image* inputImage)
@@ -185,45 +375,58 @@ void mitk::ExtractSliceFilter2::AllocateOutputs()
 
   auto data = new char[static_cast<std::size_t>(pixelType.GetSize() * outputGeometry->GetExtent(0) * outputGeometry->GetExtent(1))];
 
-  try
-  {
-    if (!outputImage->SetImportVolume(data, 0, 0, mitk::Image::ReferenceMemory))
-      throw;
-  }
-  catch (...)
+  if (!outputImage->SetImportVolume(data, 0, 0, mitk::Image::ManageMemory))
   {
     delete[] data;
+    mitkThrow() << "Could not allocate output image.";
   }
 }
 
-/*void mitk::ExtractSliceFilter2::BeforeThreadedGenerateData()
+void mitk::ExtractSliceFilter2::BeforeThreadedGenerateData()
 {
-  if (nullptr != m_Impl->InterpolateImageFunction && this->GetInput()->GetMTime() < this->GetMTime())
-    return;
-
   const auto* inputImage = this->GetInput();
-  AccessFixedDimensionByItk_2(inputImage, CreateInterpolateImageFunction, 3, this->GetInterpolator(), m_Impl->InterpolateImageFunction);
+
+  if (Cubic == this->GetInterpolator() && (nullptr == m_Impl->InterpolateImageFunction || inputImage->GetMTime() != m_Impl->InterpolateImageFunctionTime))
+  {
+    // B-spline coefficients of the whole volume are expensive, so they are kept as long as the input is unchanged
+    AccessFixedDimensionByItk_1(inputImage, CreateInterpolateImageFunction, 3, m_Impl->InterpolateImageFunction);
+    m_Impl->InterpolateImageFunctionTime = inputImage->GetMTime();
+  }
+
+  AccessFixedDimensionByItk_n(inputImage, CreateRegionGenerator, 3, (this->GetOutput(), this->GetInterpolator(), m_Impl->InterpolateImageFunction.GetPointer(), m_Impl->GenerateRegion));
 }
 
 void mitk::ExtractSliceFilter2::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType)
 {
-  const auto* inputImage = this->GetInput();
-  AccessFixedDimensionByItk_3(inputImage, ::GenerateData, 3, this->GetOutput(), outputRegionForThread, m_Impl->InterpolateImageFunction);
-}*/
+  m_Impl->GenerateRegion(outputRegionForThread);
+}
 
-void mitk::ExtractSliceFilter2::GenerateData()
+void mitk::ExtractSliceFilter2::AfterThreadedGenerateData()
 {
-  if (nullptr != m_Impl->InterpolateImageFunction && this->GetInput()->GetMTime() < this->GetMTime())
-    return;
+  m_Impl->GenerateRegion = nullptr;
+}
 
-  const auto* inputImage = this->GetInput();
+unsigned int mitk::ExtractSliceFilter2::SplitRequestedRegion(unsigned int i, unsigned int num, OutputImageRegionType& splitRegion)
+{
+  // the whole slice is always generated, split it into blocks of rows
+  splitRegion = this->GetOutput()->GetLargestPossibleRegion();
+
+  const auto height = splitRegion.GetSize(1);
+
+  if (0 == height || 0 == num)
+    return 1;
 
-  AccessFixedDimensionByItk_2(inputImage, CreateInterpolateImageFunction, 3, this->GetInterpolator(), m_Impl->InterpolateImageFunction);
+  const auto rowsPerThread = (height + num - 1) / num;
+  const auto numberOfBlocks = static_cast<unsigned int>((height + rowsPerThread - 1) / rowsPerThread);
 
-  this->AllocateOutputs();
-  auto outputRegion = this->GetOutput()->GetLargestPossibleRegion();
+  if (i < numberOfBlocks)
+  {
+    const auto begin = i * rowsPerThread;
+    splitRegion.SetIndex(1, splitRegion.GetIndex(1) + begin);
+    splitRegion.SetSize(1, std::min(rowsPerThread, height - begin));
+  }
 
-  AccessFixedDimensionByItk_3(inputImage, ::GenerateData, 3, this->GetOutput(), outputRegion, m_Impl->InterpolateImageFunction);
+  return numberOfBlocks;
 }
 
 void mitk::ExtractSliceFilter2::SetInput(const InputImageType* image)
@@ -267,7 +470,6 @@ void mitk::ExtractSliceFilter2::SetInterpolator(Interpolator interpolator)
   if (m_Impl->Interpolator != interpolator)
   {
     m_Impl->Interpolator = interpolator;
-    m_Impl->InterpolateImageFunction = nullptr;
     this->Modified();
   }
 }
@@ -14,7 +14,7 @@ found in the LICENSE file.
 #include <mitkRenderingManager.h>
 
 mitk::LimitedLinearUndo::LimitedLinearUndo()
-: m_UndoLimit(0)
+: m_UndoLimit(0), m_MemoryLimit(0), m_MemoryUsage(0)
 {
   // nothing to do
 }
@@ -32,10 +32,21 @@ void mitk::LimitedLinearUndo::ClearList(UndoContainer *list)
   {
     UndoStackItem *item = list->back();
     list->pop_back();
-    delete item;
+    this->DeleteItem(item);
   }
 }
 
+void mitk::LimitedLinearUndo::DeleteItem(UndoStackItem *item)
+{
+  auto memoryUsage = m_ItemMemoryUsage.find(item);
+  if (memoryUsage != m_ItemMemoryUsage.end())
+  {
+    m_MemoryUsage -= memoryUsage->second;
+    m_ItemMemoryUsage.erase(memoryUsage);
+  }
+  delete item;
+}
+
 bool mitk::LimitedLinearUndo::SetOperationEvent(UndoStackItem *stackItem)
 {
   auto *operationEvent = dynamic_cast<OperationEvent *>(stackItem);
@@ -49,19 +60,35 @@ bool mitk::LimitedLinearUndo::SetOperationEvent(UndoStackItem *stackItem)
     InvokeEvent(RedoEmptyEvent());
   }
 
-  if (0 != m_UndoLimit && m_UndoList.size() == m_UndoLimit)
-  {
-    auto item = m_UndoList.front();
-    m_UndoList.pop_front();
-    delete item;
-  }
-  m_UndoList.push_back(operationEvent);
+  this->PushUndoItem(operationEvent);
 
   InvokeEvent(UndoNotEmptyEvent());
 
   return true;
 }
 
+void mitk::LimitedLinearUndo::PushUndoItem(UndoStackItem *item)
+{
+  m_UndoList.push_back(item);
+  // operations may change their size later (e.g. DiffSliceOperation::SetImage), so the charged size is kept
+  const std::size_t memoryUsage = item->GetMemoryUsage();
+  m_ItemMemoryUsage[item] = memoryUsage;
+  m_MemoryUsage += memoryUsage;
+
+  bool itemsDropped = false;
+  while (m_UndoList.size() > 1 && ((0 != m_UndoLimit && m_UndoList.size() > m_UndoLimit) ||
+                                   (0 != m_MemoryLimit && m_MemoryUsage > m_MemoryLimit)))
+  {
+    auto oldestItem = m_UndoList.front();
+    m_UndoList.pop_front();
+    this->DeleteItem(oldestItem);
+    itemsDropped = true;
+  }
+
+  if (itemsDropped)
+    InvokeEvent(UndoFullEvent());
+}
+
 bool mitk::LimitedLinearUndo::Undo(bool fine)
 {
   if (fine)
@@ -182,14 +209,50 @@ void mitk::LimitedLinearUndo::SetUndoLimit(std::size_t undoLimit)
 {
   if (undoLimit != m_UndoLimit)
   {
-    if (m_UndoList.size() > undoLimit)
+    if (0 != undoLimit && m_UndoList.size() > undoLimit)
     {
-      m_UndoList.erase(m_UndoList.begin(), m_UndoList.end() - undoLimit);
+      while (m_UndoList.size() > undoLimit)
+      {
+        auto item = m_UndoList.front();
+        m_UndoList.pop_front();
+        this->DeleteItem(item);
+      }
+      InvokeEvent(UndoFullEvent());
     }
     m_UndoLimit = undoLimit;
   }
 }
 
+std::size_t mitk::LimitedLinearUndo::GetMemoryLimit() const
+{
+  return m_MemoryLimit;
+}
+
+void mitk::LimitedLinearUndo::SetMemoryLimit(std::size_t memoryLimit)
+{
+  if (memoryLimit != m_MemoryLimit)
+  {
+    m_MemoryLimit = memoryLimit;
+
+    bool itemsDropped = false;
+    while (0 != m_MemoryLimit && m_MemoryUsage > m_MemoryLimit && m_UndoList.size() > 1)
+    {
+      auto item = m_UndoList.front();
+      m_UndoList.pop_front();
+      this->DeleteItem(item);
+      itemsDropped = true;
+    }
+
+    if (itemsDropped)
+      InvokeEvent(UndoFullEvent());
+  }
+}
+
+std::size_t mitk::LimitedLinearUndo::GetMemoryUsage() const
+{
+  return m_MemoryUsage;
+}
+
 int mitk::LimitedLinearUndo::GetLastObjectEventIdInList()
 {
   return m_UndoList.back()->GetObjectEventId();
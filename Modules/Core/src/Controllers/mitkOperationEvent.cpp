@@ -72,6 +72,11 @@ void mitk::UndoStackItem::ReverseAndExecute()
   ReverseOperations();
 }
 
+std::size_t mitk::UndoStackItem::GetMemoryUsage() const
+{
+  return 0;
+}
+
 // ******************** mitk::OperationEvent ********************
 
 mitk::Operation *mitk::OperationEvent::GetOperation()
@@ -134,6 +139,16 @@ void mitk::OperationEvent::ReverseAndExecute()
     m_Destination->ExecuteOperation(m_Operation);
 }
 
+std::size_t mitk::OperationEvent::GetMemoryUsage() const
+{
+  std::size_t memoryUsage = 0;
+  if (m_Operation)
+    memoryUsage += m_Operation->GetMemoryUsage();
+  if (m_UndoOperation)
+    memoryUsage += m_UndoOperation->GetMemoryUsage();
+  return memoryUsage;
+}
+
 mitk::OperationActor *mitk::OperationEvent::GetDestination()
 {
   return m_Destination;
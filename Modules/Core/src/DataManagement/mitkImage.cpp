@@ -96,6 +96,7 @@ mitk::Image::~Image()
 
   delete[] m_OffsetTable;
   delete m_ImageStatistics;
+  m_ImageStatistics = nullptr;
 }
 
 const mitk::PixelType mitk::Image::GetPixelType(int n) const
@@ -131,6 +132,9 @@ void *mitk::Image::GetData()
   // if data present, it won't be overwritten
   m_ImageDescriptor->GetChannelDescriptor(0).SetData(m_CompleteData->GetData());
 
+  // writes to the returned memory cannot be tracked
+  this->PixelsWritten(nullptr, nullptr);
+
   return m_CompleteData->GetData();
 }
 
@@ -293,6 +297,16 @@ mitk::Image::ImageDataItemPointer mitk::Image::GetSliceData_unlocked(
     return m_Slices[pos] = sl;
   }
 
+  // slice is unavailable. Can we load it?
+  if (m_VolumeLoader)
+  {
+    m_VolumeLoader(const_cast<Image *>(this), t, n);
+    if (IsSliceSet_unlocked(s, t, n))
+      return GetSliceData_unlocked(s, t, n, data, importMemoryManagement);
+    else
+      return nullptr;
+  }
+
   // slice is unavailable. Can we calculate it?
   if ((GetSource().IsNotNull()) && (GetSource()->Updating() == false))
   {
@@ -424,6 +438,16 @@ mitk::Image::ImageDataItemPointer mitk::Image::GetVolumeData_unlocked(
     return m_Volumes[pos] = vol;
   }
 
+  // volume is unavailable. Can we load it?
+  if (m_VolumeLoader)
+  {
+    m_VolumeLoader(const_cast<Image *>(this), t, n);
+    if (IsVolumeSet_unlocked(t, n))
+      return GetVolumeData_unlocked(t, n, data, importMemoryManagement);
+    else
+      return nullptr;
+  }
+
   // volume is unavailable. Can we calculate it?
   if ((GetSource().IsNotNull()) && (GetSource()->Updating() == false))
   {
@@ -538,6 +562,21 @@ mitk::Image::ImageDataItemPointer mitk::Image::GetChannelData_unlocked(
     return m_Channels[n] = ch;
   }
 
+  // channel is unavailable. Can we load its missing volumes?
+  if (m_VolumeLoader)
+  {
+    for (unsigned int t = 0; t < m_Dimensions[3]; ++t)
+    {
+      // the loader may have set the whole channel already
+      if (IsVolumeSet_unlocked(t, n) == false)
+        m_VolumeLoader(const_cast<Image *>(this), t, n);
+    }
+    if (IsChannelSet_unlocked(n))
+      return GetChannelData_unlocked(n, data, importMemoryManagement);
+    else
+      return nullptr;
+  }
+
   // channel is unavailable. Can we calculate it?
   if ((GetSource().IsNotNull()) && (GetSource()->Updating() == false))
   {
@@ -572,7 +611,7 @@ mitk::Image::ImageDataItemPointer mitk::Image::GetChannelData_unlocked(
 bool mitk::Image::IsSliceSet(int s, int t, int n) const
 {
   MutexHolder lock(m_ImageDataArraysLock);
-  return IsSliceSet_unlocked(s, t, n);
+  return IsSliceSet_unlocked(s, t, n) || (m_VolumeLoader && IsValidSlice(s, t, n));
 }
 
 bool mitk::Image::IsSliceSet_unlocked(int s, int t, int n) const
@@ -602,7 +641,7 @@ bool mitk::Image::IsSliceSet_unlocked(int s, int t, int n) const
 bool mitk::Image::IsVolumeSet(int t, int n) const
 {
   MutexHolder lock(m_ImageDataArraysLock);
-  return IsVolumeSet_unlocked(t, n);
+  return IsVolumeSet_unlocked(t, n) || (m_VolumeLoader && IsValidVolume(t, n));
 }
 
 bool mitk::Image::IsVolumeSet_unlocked(int t, int n) const
@@ -636,7 +675,7 @@ bool mitk::Image::IsVolumeSet_unlocked(int t, int n) const
 bool mitk::Image::IsChannelSet(int n) const
 {
   MutexHolder lock(m_ImageDataArraysLock);
-  return IsChannelSet_unlocked(n);
+  return IsChannelSet_unlocked(n) || (m_VolumeLoader && IsValidChannel(n));
 }
 
 bool mitk::Image::IsChannelSet_unlocked(int n) const
@@ -685,7 +724,13 @@ bool mitk::Image::SetImportSlice(void *data, int s, int t, int n, ImportMemoryMa
   ImageDataItemPointer sl;
   const size_t ptypeSize = this->m_ImageDescriptor->GetChannelTypeById(n).GetSize();
 
-  if (IsSliceSet(s, t, n))
+  bool isSliceSet;
+  {
+    // data that has not been loaded yet is replaced, not loaded
+    MutexHolder lock(m_ImageDataArraysLock);
+    isSliceSet = IsSliceSet_unlocked(s, t, n);
+  }
+  if (isSliceSet)
   {
     sl = GetSliceData(s, t, n, data, importMemoryManagement);
     if (sl->GetManageMemory() == false)
@@ -697,6 +742,8 @@ bool mitk::Image::SetImportSlice(void *data, int s, int t, int n, ImportMemoryMa
     if (sl->GetData() != data)
       std::memcpy(sl->GetData(), data, m_OffsetTable[2] * (ptypeSize));
     sl->Modified();
+    if (m_ImageStatistics != nullptr)
+      m_ImageStatistics->InvalidateTimeStep(t);
     // we have changed the data: call Modified()!
     Modified();
   }
@@ -707,6 +754,8 @@ bool mitk::Image::SetImportSlice(void *data, int s, int t, int n, ImportMemoryMa
       return false;
     if (sl->GetData() != data)
       std::memcpy(sl->GetData(), data, m_OffsetTable[2] * (ptypeSize));
+    if (m_ImageStatistics != nullptr)
+      m_ImageStatistics->InvalidateTimeStep(t);
     // we just added a missing slice, which is not regarded as modification.
     // Therefore, we do not call Modified()!
   }
@@ -720,7 +769,13 @@ bool mitk::Image::SetImportVolume(void *data, int t, int n, ImportMemoryManageme
 
   const size_t ptypeSize = this->m_ImageDescriptor->GetChannelTypeById(n).GetSize();
   ImageDataItemPointer vol;
-  if (IsVolumeSet(t, n))
+  bool isVolumeSet;
+  {
+    // data that has not been loaded yet is replaced, not loaded
+    MutexHolder lock(m_ImageDataArraysLock);
+    isVolumeSet = IsVolumeSet_unlocked(t, n);
+  }
+  if (isVolumeSet)
   {
     vol = GetVolumeData(t, n, data, importMemoryManagement);
     if (vol->GetManageMemory() == false)
@@ -733,6 +788,8 @@ bool mitk::Image::SetImportVolume(void *data, int t, int n, ImportMemoryManageme
       std::memcpy(vol->GetData(), data, m_OffsetTable[3] * (ptypeSize));
     vol->Modified();
     vol->SetComplete(true);
+    if (m_ImageStatistics != nullptr)
+      m_ImageStatistics->InvalidateTimeStep(t);
     // we have changed the data: call Modified()!
     Modified();
   }
@@ -747,6 +804,8 @@ bool mitk::Image::SetImportVolume(void *data, int t, int n, ImportMemoryManageme
     }
     vol->SetComplete(true);
     this->m_ImageDescriptor->GetChannelDescriptor(n).SetData(vol->GetData());
+    if (m_ImageStatistics != nullptr)
+      m_ImageStatistics->InvalidateTimeStep(t);
     // we just added a missing Volume, which is not regarded as modification.
     // Therefore, we do not call Modified()!
   }
@@ -768,7 +827,13 @@ bool mitk::Image::SetImportChannel(void *data, int n, ImportMemoryManagementType
   const size_t ptypeSize = this->m_ImageDescriptor->GetChannelTypeById(n).GetSize();
 
   ImageDataItemPointer ch;
-  if (IsChannelSet(n))
+  bool isChannelSet;
+  {
+    // data that has not been loaded yet is replaced, not loaded
+    MutexHolder lock(m_ImageDataArraysLock);
+    isChannelSet = IsChannelSet_unlocked(n);
+  }
+  if (isChannelSet)
   {
     ch = GetChannelData(n, data, importMemoryManagement);
     if (ch->GetManageMemory() == false)
@@ -781,6 +846,7 @@ bool mitk::Image::SetImportChannel(void *data, int n, ImportMemoryManagementType
       std::memcpy(ch->GetData(), data, m_OffsetTable[4] * (ptypeSize));
     ch->Modified();
     ch->SetComplete(true);
+    this->InvalidateStatisticsOfAllTimeSteps();
     // we have changed the data: call Modified()!
     Modified();
   }
@@ -794,6 +860,7 @@ bool mitk::Image::SetImportChannel(void *data, int n, ImportMemoryManagementType
     ch->SetComplete(true);
 
     this->m_ImageDescriptor->GetChannelDescriptor(n).SetData(ch->GetData());
+    this->InvalidateStatisticsOfAllTimeSteps();
     // we just added a missing Channel, which is not regarded as modification.
     // Therefore, we do not call Modified()!
   }
@@ -1311,9 +1378,22 @@ unsigned int *mitk::Image::GetDimensions() const
   return m_Dimensions;
 }
 
+void mitk::Image::SetVolumeLoader(const VolumeLoaderType &loader)
+{
+  MutexHolder lock(m_ImageDataArraysLock);
+  m_VolumeLoader = loader;
+}
+
+bool mitk::Image::HasVolumeLoader() const
+{
+  MutexHolder lock(m_ImageDataArraysLock);
+  return static_cast<bool>(m_VolumeLoader);
+}
+
 void mitk::Image::Clear()
 {
   Superclass::Clear();
+  m_VolumeLoader = nullptr;
   delete[] m_Dimensions;
   m_Dimensions = nullptr;
 }
@@ -1333,6 +1413,34 @@ void mitk::Image::SetGeometry(BaseGeometry *aGeometry3D)
     GetTimeGeometry()->GetGeometryForTimeStep(step)->ImageGeometryOn();
 }
 
+void mitk::Image::Modified() const
+{
+  Superclass::Modified();
+
+  if (m_ImageStatistics != nullptr)
+    m_ImageStatistics->ImageModified();
+}
+
+void mitk::Image::PixelsWritten(const void *begin, const void *end)
+{
+  if (m_ImageStatistics == nullptr)
+    return;
+
+  if (begin == nullptr)
+    m_ImageStatistics->InvalidateAll();
+  else
+    m_ImageStatistics->InvalidateMemory(begin, end);
+}
+
+void mitk::Image::InvalidateStatisticsOfAllTimeSteps()
+{
+  if (m_ImageStatistics == nullptr)
+    return;
+
+  for (unsigned int t = 0; t < GetDimension(3); ++t)
+    m_ImageStatistics->InvalidateTimeStep(t);
+}
+
 void mitk::Image::PrintSelf(std::ostream &os, itk::Indent indent) const
 {
   if (m_Initialized)
@@ -14,8 +14,63 @@ found in the LICENSE file.
 #include "mitkHistogramGenerator.h"
 #include <mitkProperties.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace
+{
+  /** Approximate number of pixels in a block of slices */
+  const std::size_t MinimumPixelsPerBlock = 1 << 18;
+}
+
+mitk::ImageStatisticsHolder::Extrema::Extrema()
+  : m_Min(itk::NumericTraits<ScalarType>::max()),
+    m_2ndMin(itk::NumericTraits<ScalarType>::max()),
+    m_Max(itk::NumericTraits<ScalarType>::NonpositiveMin()),
+    m_2ndMax(itk::NumericTraits<ScalarType>::NonpositiveMin()),
+    m_CountOfMin(0),
+    m_CountOfMax(0)
+{
+}
+
+void mitk::ImageStatisticsHolder::Extrema::Merge(const Extrema &other)
+{
+  if (other.m_Min < m_Min)
+  {
+    m_2ndMin = std::min(m_Min, other.m_2ndMin);
+    m_Min = other.m_Min;
+    m_CountOfMin = other.m_CountOfMin;
+  }
+  else if (other.m_Min == m_Min)
+  {
+    m_2ndMin = std::min(m_2ndMin, other.m_2ndMin);
+    m_CountOfMin += other.m_CountOfMin;
+  }
+  else
+  {
+    m_2ndMin = std::min(m_2ndMin, other.m_Min);
+  }
+
+  if (other.m_Max > m_Max)
+  {
+    m_2ndMax = std::max(m_Max, other.m_2ndMax);
+    m_Max = other.m_Max;
+    m_CountOfMax = other.m_CountOfMax;
+  }
+  else if (other.m_Max == m_Max)
+  {
+    m_2ndMax = std::max(m_2ndMax, other.m_2ndMax);
+    m_CountOfMax += other.m_CountOfMax;
+  }
+  else
+  {
+    m_2ndMax = std::max(m_2ndMax, other.m_Max);
+  }
+}
+
 mitk::ImageStatisticsHolder::ImageStatisticsHolder(mitk::Image *image)
-  : m_Image(image)
+  : m_Image(image), m_HasInvalidatedBlocks(false), m_HasPendingTrackedWrite(false), m_HasUntrackedModification(false)
 {
   m_CountOfMinValuedVoxels.resize(1, 0);
   m_CountOfMaxValuedVoxels.resize(1, 0);
@@ -36,6 +91,17 @@ mitk::ImageStatisticsHolder::~ImageStatisticsHolder()
 const mitk::ImageStatisticsHolder::HistogramType *mitk::ImageStatisticsHolder::GetScalarHistogram(
   int t, unsigned int /*component*/)
 {
+  if (!m_Image->IsValidTimeStep(t))
+    return nullptr;
+
+  this->CheckImageModified();
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (static_cast<std::size_t>(t) < m_Histograms.size() && m_Histograms[t].IsNotNull())
+      return m_Histograms[t];
+  }
+
   mitk::ImageTimeSelector *timeSelector = this->GetTimeSelector();
   if (timeSelector != nullptr)
   {
@@ -46,7 +112,13 @@ const mitk::ImageStatisticsHolder::HistogramType *mitk::ImageStatisticsHolder::G
       static_cast<mitk::HistogramGenerator *>(m_HistogramGeneratorObject.GetPointer());
     generator->SetImage(timeSelector->GetOutput());
     generator->ComputeHistogram();
-    return static_cast<const mitk::ImageStatisticsHolder::HistogramType *>(generator->GetHistogram());
+
+    HistogramType::ConstPointer histogram = generator->GetHistogram();
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (static_cast<std::size_t>(t) >= m_Histograms.size())
+      m_Histograms.resize(t + 1);
+    m_Histograms[t] = histogram;
+    return histogram;
   }
   return nullptr;
 }
@@ -92,87 +164,311 @@ void mitk::ImageStatisticsHolder::ResetImageStatistics()
   m_Scalar2ndMax.assign(1, itk::NumericTraits<ScalarType>::NonpositiveMin());
   m_CountOfMinValuedVoxels.assign(1, 0);
   m_CountOfMaxValuedVoxels.assign(1, 0);
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_TimeStepExtrema.clear();
+  m_Histograms.clear();
 }
 
-#include "mitkImageAccessByItk.h"
+void mitk::ImageStatisticsHolder::InvalidateMemory(const void *begin, const void *end)
+{
+  struct ModifiedRange
+  {
+    unsigned int t;
+    std::size_t begin;
+    std::size_t end;
+    std::size_t volumeSize;
+  };
+  std::vector<ModifiedRange> ranges;
+
+  const auto *first = static_cast<const unsigned char *>(begin);
+  const auto *last = static_cast<const unsigned char *>(end);
+  auto addRange = [&](unsigned int t, const unsigned char *volume, std::size_t volumeSize) {
+    if (first < volume + volumeSize && last > volume)
+    {
+      ranges.push_back({t,
+                        static_cast<std::size_t>(std::max(first, volume) - volume),
+                        static_cast<std::size_t>(std::min(last, volume + volumeSize) - volume),
+                        volumeSize});
+    }
+  };
 
-//#define BOUNDINGOBJECT_IGNORE
+  {
+    Image::MutexHolder lock(m_Image->m_ImageDataArraysLock);
 
-template <typename ItkImageType>
-void mitk::_ComputeExtremaInItkImage(const ItkImageType *itkImage, mitk::ImageStatisticsHolder *statisticsHolder, int t)
-{
-  typename ItkImageType::RegionType region;
-  region = itkImage->GetBufferedRegion();
-  if (region.Crop(itkImage->GetRequestedRegion()) == false)
-    return;
-  if (region != itkImage->GetRequestedRegion())
+    const unsigned int timeSteps = m_Image->GetDimension(3);
+    const ImageDataItem *channel = m_Image->m_Channels.empty() ? nullptr : m_Image->m_Channels[0].GetPointer();
+
+    for (unsigned int t = 0; t < timeSteps; ++t)
+    {
+      // volumes either point into the memory of their channel or have their own memory
+      const auto volumeIndex = static_cast<std::size_t>(m_Image->GetVolumeIndex(t, 0));
+      if (volumeIndex < m_Image->m_Volumes.size() && m_Image->m_Volumes[volumeIndex].IsNotNull() &&
+          m_Image->m_Volumes[volumeIndex]->m_Data != nullptr)
+      {
+        addRange(t, m_Image->m_Volumes[volumeIndex]->m_Data, m_Image->m_Volumes[volumeIndex]->m_Size);
+      }
+      if (channel != nullptr && channel->m_Data != nullptr)
+      {
+        const std::size_t volumeSize = channel->m_Size / timeSteps;
+        addRange(t, channel->m_Data + t * volumeSize, volumeSize);
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_HasInvalidatedBlocks = true;
+  m_HasPendingTrackedWrite = true;
+
+  if (ranges.empty())
+  {
+    // e.g. a slice with memory of its own, we cannot tell which time step it belongs to
+    for (auto &timeStep : m_TimeStepExtrema)
+    {
+      timeStep.m_ModifiedBlocks.assign(timeStep.m_ModifiedBlocks.size(), true);
+    }
+    m_Histograms.clear();
     return;
+  }
 
-  itk::ImageRegionConstIterator<ItkImageType> it(itkImage, region);
-  typedef typename ItkImageType::PixelType TPixel;
-  TPixel value = 0;
+  for (const auto &range : ranges)
+  {
+    if (range.t < m_Histograms.size())
+      m_Histograms[range.t] = nullptr;
 
-  if (statisticsHolder == nullptr || !statisticsHolder->IsValidTimeStep(t))
+    if (range.t >= m_TimeStepExtrema.size() || m_TimeStepExtrema[range.t].m_Blocks.empty())
+      continue;
+
+    auto &timeStep = m_TimeStepExtrema[range.t];
+    const std::size_t sliceSize = range.volumeSize / timeStep.m_NumberOfSlices;
+    if (sliceSize == 0)
+    {
+      timeStep.m_ModifiedBlocks.assign(timeStep.m_ModifiedBlocks.size(), true);
+      continue;
+    }
+
+    const std::size_t firstBlock = range.begin / sliceSize / timeStep.m_SlicesPerBlock;
+    const std::size_t lastBlock = std::min((range.end - 1) / sliceSize / timeStep.m_SlicesPerBlock,
+                                           timeStep.m_ModifiedBlocks.size() - 1);
+    for (std::size_t block = firstBlock; block <= lastBlock; ++block)
+    {
+      timeStep.m_ModifiedBlocks[block] = true;
+    }
+  }
+}
+
+void mitk::ImageStatisticsHolder::InvalidateTimeStep(int t)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_HasInvalidatedBlocks = true;
+  m_HasPendingTrackedWrite = true;
+
+  if (t < 0)
     return;
-  statisticsHolder->Expand(t + 1); // make sure we have initialized all arrays
-  statisticsHolder->m_CountOfMinValuedVoxels[t] = 0;
-  statisticsHolder->m_CountOfMaxValuedVoxels[t] = 0;
 
-  statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMin[t] = itk::NumericTraits<ScalarType>::max();
-  statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_ScalarMax[t] =
-    itk::NumericTraits<ScalarType>::NonpositiveMin();
+  if (static_cast<std::size_t>(t) < m_Histograms.size())
+    m_Histograms[t] = nullptr;
+
+  if (static_cast<std::size_t>(t) < m_TimeStepExtrema.size())
+  {
+    auto &timeStep = m_TimeStepExtrema[t];
+    timeStep.m_ModifiedBlocks.assign(timeStep.m_ModifiedBlocks.size(), true);
+  }
+}
+
+void mitk::ImageStatisticsHolder::InvalidateAll()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_HasUntrackedModification = true;
+}
+
+void mitk::ImageStatisticsHolder::ImageModified()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (!m_HasPendingTrackedWrite)
+    m_HasUntrackedModification = true;
+  m_HasPendingTrackedWrite = false;
+}
 
-  while (!it.IsAtEnd())
+void mitk::ImageStatisticsHolder::CheckImageModified()
+{
+  bool reset = false;
   {
-    value = it.Get();
-#ifdef BOUNDINGOBJECT_IGNORE
-    if (value > -32765)
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_HasUntrackedModification || m_Image->GetMTime() > m_LastRecomputeTimeStamp.GetMTime())
     {
-#endif
-      // update min
-      if (value < statisticsHolder->m_ScalarMin[t])
-      {
-        statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMin[t];
-        statisticsHolder->m_ScalarMin[t] = value;
-        statisticsHolder->m_CountOfMinValuedVoxels[t] = 1;
-      }
-      else if (value == statisticsHolder->m_ScalarMin[t])
-      {
-        ++statisticsHolder->m_CountOfMinValuedVoxels[t];
-      }
-      else if (value < statisticsHolder->m_Scalar2ndMin[t])
-      {
-        statisticsHolder->m_Scalar2ndMin[t] = value;
-      }
+      // modifications through write accessors and the setters of the image already invalidated the blocks they
+      // touched, any other modification invalidates everything
+      reset = m_HasUntrackedModification || !m_HasInvalidatedBlocks;
+      m_HasInvalidatedBlocks = false;
+      m_HasPendingTrackedWrite = false;
+      m_HasUntrackedModification = false;
+      m_LastRecomputeTimeStamp.Modified();
+    }
+  }
 
-      // update max
-      if (value > statisticsHolder->m_ScalarMax[t])
-      {
-        statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_ScalarMax[t];
-        statisticsHolder->m_ScalarMax[t] = value;
-        statisticsHolder->m_CountOfMaxValuedVoxels[t] = 1;
-      }
-      else if (value == statisticsHolder->m_ScalarMax[t])
+  if (reset)
+    this->ResetImageStatistics();
+}
+
+bool mitk::ImageStatisticsHolder::IsModified(int t, unsigned int component)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (static_cast<std::size_t>(t) < m_TimeStepExtrema.size() && !m_TimeStepExtrema[t].m_Blocks.empty())
+    {
+      const auto &timeStep = m_TimeStepExtrema[t];
+      return timeStep.m_Component != component ||
+             std::find(timeStep.m_ModifiedBlocks.begin(), timeStep.m_ModifiedBlocks.end(), true) !=
+               timeStep.m_ModifiedBlocks.end();
+    }
+  }
+
+  // pixel types without blocks
+  return m_ScalarMin[t] == itk::NumericTraits<ScalarType>::max() &&
+         m_Scalar2ndMin[t] == itk::NumericTraits<ScalarType>::max();
+}
+
+void mitk::ImageStatisticsHolder::ComputeExtremaInBlocks(int t,
+                                                         unsigned int component,
+                                                         unsigned int numberOfSlices,
+                                                         std::size_t pixelsPerSlice,
+                                                         const BlockFunctionType &blockFunction)
+{
+  std::vector<std::size_t> modifiedBlocks;
+  unsigned int slicesPerBlock = 1;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (static_cast<std::size_t>(t) >= m_TimeStepExtrema.size())
+      m_TimeStepExtrema.resize(t + 1);
+
+    auto &timeStep = m_TimeStepExtrema[t];
+    if (timeStep.m_Blocks.empty() || timeStep.m_Component != component || timeStep.m_NumberOfSlices != numberOfSlices)
+    {
+      timeStep.m_Component = component;
+      timeStep.m_NumberOfSlices = numberOfSlices;
+      timeStep.m_SlicesPerBlock = static_cast<unsigned int>(
+        std::max<std::size_t>(1, MinimumPixelsPerBlock / std::max<std::size_t>(1, pixelsPerSlice)));
+      const std::size_t numberOfBlocks = (numberOfSlices + timeStep.m_SlicesPerBlock - 1) / timeStep.m_SlicesPerBlock;
+      timeStep.m_Blocks.assign(numberOfBlocks, Extrema());
+      timeStep.m_ModifiedBlocks.assign(numberOfBlocks, true);
+    }
+
+    for (std::size_t block = 0; block < timeStep.m_ModifiedBlocks.size(); ++block)
+    {
+      if (timeStep.m_ModifiedBlocks[block])
       {
-        ++statisticsHolder->m_CountOfMaxValuedVoxels[t];
+        modifiedBlocks.push_back(block);
+        timeStep.m_ModifiedBlocks[block] = false;
       }
-      else if (value > statisticsHolder->m_Scalar2ndMax[t])
+    }
+    slicesPerBlock = timeStep.m_SlicesPerBlock;
+  }
+
+  // blocks are computed without holding the lock, a write accessor invalidating one of them in the meantime
+  // just marks it as modified again
+  std::vector<Extrema> blockExtrema(modifiedBlocks.size());
+  std::atomic<std::size_t> nextBlock(0);
+
+  auto compute = [&]() {
+    for (std::size_t i = nextBlock++; i < modifiedBlocks.size(); i = nextBlock++)
+    {
+      const unsigned int firstSlice = static_cast<unsigned int>(modifiedBlocks[i]) * slicesPerBlock;
+      blockFunction(firstSlice, std::min(slicesPerBlock, numberOfSlices - firstSlice), blockExtrema[i]);
+    }
+  };
+
+  const auto numberOfThreads = static_cast<unsigned int>(
+    std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), modifiedBlocks.size()));
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < numberOfThreads; ++i)
+  {
+    threads.emplace_back(compute);
+  }
+  compute();
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  Extrema extrema;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto &timeStep = m_TimeStepExtrema[t];
+    if (timeStep.m_Component == component && timeStep.m_NumberOfSlices == numberOfSlices)
+    {
+      for (std::size_t i = 0; i < modifiedBlocks.size(); ++i)
       {
-        statisticsHolder->m_Scalar2ndMax[t] = value;
+        timeStep.m_Blocks[modifiedBlocks[i]] = blockExtrema[i];
       }
-#ifdef BOUNDINGOBJECT_IGNORE
     }
-#endif
-
-    ++it;
+    for (const auto &block : timeStep.m_Blocks)
+    {
+      extrema.Merge(block);
+    }
   }
 
+  m_ScalarMin[t] = extrema.m_Min;
+  m_Scalar2ndMin[t] = extrema.m_2ndMin;
+  m_ScalarMax[t] = extrema.m_Max;
+  m_Scalar2ndMax[t] = extrema.m_2ndMax;
+  m_CountOfMinValuedVoxels[t] = extrema.m_CountOfMin;
+  m_CountOfMaxValuedVoxels[t] = extrema.m_CountOfMax;
+
   //// guard for wrong 2dMin/Max on single constant value images
-  if (statisticsHolder->m_ScalarMax[t] == statisticsHolder->m_ScalarMin[t])
+  if (m_ScalarMax[t] == m_ScalarMin[t])
+  {
+    m_Scalar2ndMax[t] = m_Scalar2ndMin[t] = m_ScalarMax[t];
+  }
+  m_LastRecomputeTimeStamp.Modified();
+}
+
+#include "mitkImageAccessByItk.h"
+
+namespace
+{
+  /** Region of slices [firstSlice, firstSlice + numberOfSlices) along the last dimension of region */
+  template <typename RegionType>
+  RegionType GetSliceRegion(RegionType region, unsigned int firstSlice, unsigned int numberOfSlices)
   {
-    statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMax[t];
+    const unsigned int lastDimension = RegionType::ImageDimension - 1;
+    region.SetIndex(lastDimension, region.GetIndex(lastDimension) + firstSlice);
+    region.SetSize(lastDimension, numberOfSlices);
+    return region;
   }
-  statisticsHolder->m_LastRecomputeTimeStamp.Modified();
+}
+
+template <typename ItkImageType>
+void mitk::_ComputeExtremaInItkImage(const ItkImageType *itkImage, mitk::ImageStatisticsHolder *statisticsHolder, int t)
+{
+  typename ItkImageType::RegionType region;
+  region = itkImage->GetBufferedRegion();
+  if (region.Crop(itkImage->GetRequestedRegion()) == false)
+    return;
+  if (region != itkImage->GetRequestedRegion())
+    return;
+
+  if (statisticsHolder == nullptr || !statisticsHolder->IsValidTimeStep(t))
+    return;
+  statisticsHolder->Expand(t + 1); // make sure we have initialized all arrays
+
+  const unsigned int lastDimension = ItkImageType::ImageDimension - 1;
+  const unsigned int numberOfSlices = region.GetSize(lastDimension);
+
+  statisticsHolder->ComputeExtremaInBlocks(
+    t,
+    0,
+    numberOfSlices,
+    region.GetNumberOfPixels() / std::max(numberOfSlices, 1u),
+    [itkImage, &region](
+      unsigned int firstSlice, unsigned int numberOfSlicesInBlock, ImageStatisticsHolder::Extrema &extrema) {
+      itk::ImageRegionConstIterator<ItkImageType> it(itkImage,
+                                                     GetSliceRegion(region, firstSlice, numberOfSlicesInBlock));
+      for (; !it.IsAtEnd(); ++it)
+      {
+        extrema.Add(it.Get());
+      }
+    });
 }
 
 template <typename ItkImageType>
@@ -188,69 +484,27 @@ void mitk::_ComputeExtremaInItkVectorImage(const ItkImageType *itkImage,
   if (region != itkImage->GetRequestedRegion())
     return;
 
-  itk::ImageRegionConstIterator<ItkImageType> it(itkImage, region);
-
   if (statisticsHolder == nullptr || !statisticsHolder->IsValidTimeStep(t))
     return;
   statisticsHolder->Expand(t + 1); // make sure we have initialized all arrays
-  statisticsHolder->m_CountOfMinValuedVoxels[t] = 0;
-  statisticsHolder->m_CountOfMaxValuedVoxels[t] = 0;
 
-  statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMin[t] = itk::NumericTraits<ScalarType>::max();
-  statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_ScalarMax[t] =
-    itk::NumericTraits<ScalarType>::NonpositiveMin();
-
-  while (!it.IsAtEnd())
-  {
-    double value = it.Get()[component];
-#ifdef BOUNDINGOBJECT_IGNORE
-    if (value > -32765)
-    {
-#endif
-      // update min
-      if (value < statisticsHolder->m_ScalarMin[t])
-      {
-        statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMin[t];
-        statisticsHolder->m_ScalarMin[t] = value;
-        statisticsHolder->m_CountOfMinValuedVoxels[t] = 1;
-      }
-      else if (value == statisticsHolder->m_ScalarMin[t])
-      {
-        ++statisticsHolder->m_CountOfMinValuedVoxels[t];
-      }
-      else if (value < statisticsHolder->m_Scalar2ndMin[t])
-      {
-        statisticsHolder->m_Scalar2ndMin[t] = value;
-      }
-
-      // update max
-      if (value > statisticsHolder->m_ScalarMax[t])
-      {
-        statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_ScalarMax[t];
-        statisticsHolder->m_ScalarMax[t] = value;
-        statisticsHolder->m_CountOfMaxValuedVoxels[t] = 1;
-      }
-      else if (value == statisticsHolder->m_ScalarMax[t])
-      {
-        ++statisticsHolder->m_CountOfMaxValuedVoxels[t];
-      }
-      else if (value > statisticsHolder->m_Scalar2ndMax[t])
+  const unsigned int lastDimension = ItkImageType::ImageDimension - 1;
+  const unsigned int numberOfSlices = region.GetSize(lastDimension);
+
+  statisticsHolder->ComputeExtremaInBlocks(
+    t,
+    component,
+    numberOfSlices,
+    region.GetNumberOfPixels() / std::max(numberOfSlices, 1u),
+    [itkImage, &region, component](
+      unsigned int firstSlice, unsigned int numberOfSlicesInBlock, ImageStatisticsHolder::Extrema &extrema) {
+      itk::ImageRegionConstIterator<ItkImageType> it(itkImage,
+                                                     GetSliceRegion(region, firstSlice, numberOfSlicesInBlock));
+      for (; !it.IsAtEnd(); ++it)
       {
-        statisticsHolder->m_Scalar2ndMax[t] = value;
+        extrema.Add(it.Get()[component]);
       }
-#ifdef BOUNDINGOBJECT_IGNORE
-    }
-#endif
-
-    ++it;
-  }
-
-  //// guard for wrong 2dMin/Max on single constant value images
-  if (statisticsHolder->m_ScalarMax[t] == statisticsHolder->m_ScalarMin[t])
-  {
-    statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMax[t];
-  }
-  statisticsHolder->m_LastRecomputeTimeStamp.Modified();
+    });
 }
 
 void mitk::ImageStatisticsHolder::ComputeImageStatistics(int t, unsigned int component)
@@ -260,14 +514,12 @@ void mitk::ImageStatisticsHolder::ComputeImageStatistics(int t, unsigned int com
     return;
 
   // image modified?
-  if (this->m_Image->GetMTime() > m_LastRecomputeTimeStamp.GetMTime())
-    this->ResetImageStatistics();
+  this->CheckImageModified();
 
   Expand(t + 1);
 
   // do we have valid information already?
-  if (m_ScalarMin[t] != itk::NumericTraits<ScalarType>::max() ||
-      m_Scalar2ndMin[t] != itk::NumericTraits<ScalarType>::max())
+  if (!this->IsModified(t, component))
     return; // Values already calculated before...
 
   // used to avoid statistics calculation on Odf images. property will be replaced as soons as bug 17928 is merged and
@@ -17,6 +17,9 @@ mitk::ImageWriteAccessor::ImageWriteAccessor(ImagePointer image, const mitk::Ima
 
 {
   OrganizeWriteAccess();
+
+  // statistics computed while the accessor is alive are outdated when it is released, see destructor
+  m_Image->PixelsWritten(m_AddressBegin, m_AddressEnd);
 }
 
 mitk::ImageWriteAccessor::~ImageWriteAccessor()
@@ -42,6 +45,8 @@ mitk::ImageWriteAccessor::~ImageWriteAccessor()
   }
 
   m_Image->m_ReadWriteLock.Unlock();
+
+  m_Image->PixelsWritten(m_AddressBegin, m_AddressEnd);
 }
 
 const mitk::Image *mitk::ImageWriteAccessor::GetImage() const
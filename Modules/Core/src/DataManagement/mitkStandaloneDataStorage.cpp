@@ -12,16 +12,39 @@ found in the LICENSE file.
 
 #include "mitkStandaloneDataStorage.h"
 
+#include "itkCommand.h"
 #include "itkMutexLockHolder.h"
 #include "itkSimpleFastMutexLock.h"
 #include "mitkDataNode.h"
 #include "mitkGroupTagProperty.h"
+#include "mitkNodePredicateAnd.h"
 #include "mitkNodePredicateBase.h"
+#include "mitkNodePredicateDataType.h"
+#include "mitkNodePredicateDataUID.h"
+#include "mitkNodePredicateOr.h"
 #include "mitkNodePredicateProperty.h"
 #include "mitkProperties.h"
 
+namespace
+{
+  template <typename TKey>
+  void EraseFromIndex(std::map<TKey, std::set<const mitk::DataNode *>> &index,
+                      const TKey &key,
+                      const mitk::DataNode *node)
+  {
+    auto finding = index.find(key);
+    if (finding == index.end())
+      return;
+
+    finding->second.erase(node);
+    if (finding->second.empty())
+      index.erase(finding);
+  }
+}
+
 mitk::StandaloneDataStorage::StandaloneDataStorage() : mitk::DataStorage()
 {
+  m_IndexedPropertyKeys.insert("name");
 }
 
 mitk::StandaloneDataStorage::~StandaloneDataStorage()
@@ -29,6 +52,7 @@ mitk::StandaloneDataStorage::~StandaloneDataStorage()
   for (auto it = m_SourceNodes.begin(); it != m_SourceNodes.end(); ++it)
   {
     this->RemoveListeners(it->first);
+    this->RemoveFromIndex(it->first);
   }
 }
 
@@ -81,6 +105,8 @@ void mitk::StandaloneDataStorage::Add(mitk::DataNode *node, const mitk::DataStor
 
     // register for ITK changed events
     this->AddListeners(node);
+
+    this->AddToIndex(node);
   }
 
   /* Notify observers */
@@ -112,6 +138,8 @@ void mitk::StandaloneDataStorage::Remove(const mitk::DataNode *node)
     /* remove node from both relation adjacency lists */
     this->RemoveFromRelation(node, m_SourceNodes);
     this->RemoveFromRelation(node, m_DerivedNodes);
+
+    this->RemoveFromIndex(node);
   }
 }
 
@@ -251,6 +279,296 @@ mitk::DataStorage::SetOfObjects::ConstPointer mitk::StandaloneDataStorage::GetDe
   return this->GetRelations(node, m_DerivedNodes, condition, onlyDirectDerivations);
 }
 
+mitk::DataStorage::SetOfObjects::ConstPointer mitk::StandaloneDataStorage::GetSubset(
+  const NodePredicateBase *condition) const
+{
+  if (condition == nullptr)
+    return this->GetAll();
+
+  mitk::DataStorage::SetOfObjects::Pointer candidates = mitk::DataStorage::SetOfObjects::New();
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_Mutex);
+    NodeSet indexedCandidates;
+    if (!this->GetIndexCandidates(condition, indexedCandidates))
+      candidates = nullptr;
+    else
+      for (auto it = indexedCandidates.cbegin(); it != indexedCandidates.cend(); ++it)
+        candidates->InsertElement(candidates->Size(), const_cast<mitk::DataNode *>(*it));
+  }
+
+  /* The condition is checked without holding the lock, because predicates may access the data storage */
+  if (candidates.IsNull())
+    return Superclass::GetSubset(condition);
+  return this->FilterSetOfObjects(candidates, condition);
+}
+
+bool mitk::StandaloneDataStorage::GetIndexCandidates(const NodePredicateBase *condition, NodeSet &candidates) const
+{
+  if (const auto *dataTypePredicate = dynamic_cast<const NodePredicateDataType *>(condition))
+  {
+    auto finding = m_DataTypeIndex.find(dataTypePredicate->GetValidDataType());
+    if (finding != m_DataTypeIndex.cend())
+      candidates.insert(finding->second.cbegin(), finding->second.cend());
+    return true;
+  }
+
+  if (const auto *uidPredicate = dynamic_cast<const NodePredicateDataUID *>(condition))
+  {
+    auto finding = m_DataUIDIndex.find(uidPredicate->GetUID());
+    if (finding != m_DataUIDIndex.cend())
+      candidates.insert(finding->second.cbegin(), finding->second.cend());
+    return true;
+  }
+
+  if (const auto *propertyPredicate = dynamic_cast<const NodePredicateProperty *>(condition))
+  {
+    const std::string &key = propertyPredicate->GetValidPropertyName();
+    if (propertyPredicate->GetRenderer() != nullptr || m_IndexedPropertyKeys.find(key) == m_IndexedPropertyKeys.cend())
+      return false;
+
+    auto valueIndex = m_PropertyIndex.find(key);
+    if (valueIndex != m_PropertyIndex.cend())
+    {
+      if (propertyPredicate->GetValidProperty() == nullptr)
+      {
+        for (auto valueIt = valueIndex->second.cbegin(); valueIt != valueIndex->second.cend(); ++valueIt)
+          candidates.insert(valueIt->second.cbegin(), valueIt->second.cend());
+      }
+      else
+      {
+        auto finding = valueIndex->second.find(propertyPredicate->GetValidProperty()->GetValueAsString());
+        if (finding != valueIndex->second.cend())
+          candidates.insert(finding->second.cbegin(), finding->second.cend());
+      }
+    }
+
+    /* nodes without own property may still have it in the property list of their data */
+    auto withoutProperty = m_NodesWithoutIndexedProperty.find(key);
+    if (withoutProperty != m_NodesWithoutIndexedProperty.cend())
+      candidates.insert(withoutProperty->second.cbegin(), withoutProperty->second.cend());
+    return true;
+  }
+
+  if (const auto *andPredicate = dynamic_cast<const NodePredicateAnd *>(condition))
+  {
+    /* every child has to be fulfilled, so the candidates of one child are sufficient */
+    const NodePredicateCompositeBase::ChildPredicates children = andPredicate->GetPredicates();
+    for (auto it = children.cbegin(); it != children.cend(); ++it)
+    {
+      NodeSet childCandidates;
+      if (this->GetIndexCandidates(*it, childCandidates))
+      {
+        candidates.insert(childCandidates.cbegin(), childCandidates.cend());
+        return true;
+      }
+    }
+    return false;
+  }
+
+  if (const auto *orPredicate = dynamic_cast<const NodePredicateOr *>(condition))
+  {
+    /* any child may be fulfilled, so all children need to be answered from the indexes */
+    const NodePredicateCompositeBase::ChildPredicates children = orPredicate->GetPredicates();
+    if (children.empty())
+      return false;
+
+    NodeSet childCandidates;
+    for (auto it = children.cbegin(); it != children.cend(); ++it)
+      if (!this->GetIndexCandidates(*it, childCandidates))
+        return false;
+    candidates.insert(childCandidates.cbegin(), childCandidates.cend());
+    return true;
+  }
+
+  return false;
+}
+
+void mitk::StandaloneDataStorage::AddIndexedPropertyKey(const std::string &propertyKey)
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_Mutex);
+  if (propertyKey.empty() || !m_IndexedPropertyKeys.insert(propertyKey).second)
+    return;
+
+  for (auto it = m_IndexEntries.cbegin(); it != m_IndexEntries.cend(); ++it)
+    this->UpdateIndex(it->first);
+}
+
+std::set<std::string> mitk::StandaloneDataStorage::GetIndexedPropertyKeys() const
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_Mutex);
+  return m_IndexedPropertyKeys;
+}
+
+mitk::StandaloneDataStorage::IndexEntry mitk::StandaloneDataStorage::CreateIndexEntry(const mitk::DataNode *node) const
+{
+  IndexEntry entry;
+
+  const BaseData *data = node->GetData();
+  if (data != nullptr)
+  {
+    entry.HasData = true;
+    entry.DataType = data->GetNameOfClass();
+    entry.DataUID = data->GetUID();
+  }
+
+  for (auto it = m_IndexedPropertyKeys.cbegin(); it != m_IndexedPropertyKeys.cend(); ++it)
+  {
+    const BaseProperty *property = node->GetProperty(it->c_str(), nullptr, false);
+    entry.Properties[*it] =
+      std::make_pair(property, property != nullptr ? property->GetValueAsString() : std::string());
+  }
+
+  return entry;
+}
+
+void mitk::StandaloneDataStorage::AddToIndex(const mitk::DataNode *node)
+{
+  if (node == nullptr || m_IndexEntries.find(node) != m_IndexEntries.end())
+    return;
+
+  IndexEntry entry = this->CreateIndexEntry(node);
+  for (auto it = entry.Properties.cbegin(); it != entry.Properties.cend(); ++it)
+    if (it->second.first != nullptr)
+      this->ObserveProperty(node, it->second.first);
+  this->InsertIndexEntry(node, entry);
+  m_IndexEntries[node] = entry;
+
+  auto *nonConstNode = const_cast<mitk::DataNode *>(node);
+  itk::MemberCommand<StandaloneDataStorage>::Pointer command = itk::MemberCommand<StandaloneDataStorage>::New();
+  command->SetCallbackFunction(this, &StandaloneDataStorage::OnIndexedNodeModified);
+  m_IndexObserverTags[node] = nonConstNode->AddObserver(itk::ModifiedEvent(), command);
+}
+
+void mitk::StandaloneDataStorage::RemoveFromIndex(const mitk::DataNode *node)
+{
+  auto entryIt = m_IndexEntries.find(node);
+  if (entryIt == m_IndexEntries.end())
+    return;
+
+  auto tagIt = m_IndexObserverTags.find(node);
+  if (tagIt != m_IndexObserverTags.end())
+  {
+    const_cast<mitk::DataNode *>(node)->RemoveObserver(tagIt->second);
+    m_IndexObserverTags.erase(tagIt);
+  }
+
+  this->EraseIndexEntry(node, entryIt->second);
+  for (auto it = entryIt->second.Properties.cbegin(); it != entryIt->second.Properties.cend(); ++it)
+    if (it->second.first != nullptr)
+      this->UnobserveProperty(node, it->second.first);
+  m_IndexEntries.erase(entryIt);
+}
+
+void mitk::StandaloneDataStorage::UpdateIndex(const mitk::DataNode *node)
+{
+  auto entryIt = m_IndexEntries.find(node);
+  if (entryIt == m_IndexEntries.end())
+    return;
+
+  /* observe the new properties before releasing the old ones, so unchanged properties keep their observer */
+  IndexEntry entry = this->CreateIndexEntry(node);
+  for (auto it = entry.Properties.cbegin(); it != entry.Properties.cend(); ++it)
+    if (it->second.first != nullptr)
+      this->ObserveProperty(node, it->second.first);
+  for (auto it = entryIt->second.Properties.cbegin(); it != entryIt->second.Properties.cend(); ++it)
+    if (it->second.first != nullptr)
+      this->UnobserveProperty(node, it->second.first);
+
+  this->EraseIndexEntry(node, entryIt->second);
+  this->InsertIndexEntry(node, entry);
+  entryIt->second = entry;
+}
+
+void mitk::StandaloneDataStorage::InsertIndexEntry(const mitk::DataNode *node, const IndexEntry &entry)
+{
+  if (entry.HasData)
+  {
+    m_DataTypeIndex[entry.DataType].insert(node);
+    m_DataUIDIndex[entry.DataUID].insert(node);
+  }
+
+  for (auto it = entry.Properties.cbegin(); it != entry.Properties.cend(); ++it)
+    if (it->second.first != nullptr)
+      m_PropertyIndex[it->first][it->second.second].insert(node);
+    else
+      m_NodesWithoutIndexedProperty[it->first].insert(node);
+}
+
+void mitk::StandaloneDataStorage::EraseIndexEntry(const mitk::DataNode *node, const IndexEntry &entry)
+{
+  if (entry.HasData)
+  {
+    EraseFromIndex(m_DataTypeIndex, entry.DataType, node);
+    EraseFromIndex(m_DataUIDIndex, entry.DataUID, node);
+  }
+
+  for (auto it = entry.Properties.cbegin(); it != entry.Properties.cend(); ++it)
+  {
+    if (it->second.first != nullptr)
+    {
+      auto valueIndex = m_PropertyIndex.find(it->first);
+      if (valueIndex != m_PropertyIndex.end())
+        EraseFromIndex(valueIndex->second, it->second.second, node);
+    }
+    else
+    {
+      EraseFromIndex(m_NodesWithoutIndexedProperty, it->first, node);
+    }
+  }
+}
+
+void mitk::StandaloneDataStorage::ObserveProperty(const mitk::DataNode *node, const BaseProperty *property)
+{
+  auto finding = m_ObservedProperties.find(property);
+  if (finding == m_ObservedProperties.end())
+  {
+    itk::MemberCommand<StandaloneDataStorage>::Pointer command = itk::MemberCommand<StandaloneDataStorage>::New();
+    command->SetCallbackFunction(this, &StandaloneDataStorage::OnIndexedPropertyModified);
+
+    ObservedProperty observed;
+    observed.Property = property;
+    observed.ObserverTag = const_cast<BaseProperty *>(property)->AddObserver(itk::ModifiedEvent(), command);
+    finding = m_ObservedProperties.insert(std::make_pair(property, observed)).first;
+  }
+  finding->second.Nodes.insert(node);
+}
+
+void mitk::StandaloneDataStorage::UnobserveProperty(const mitk::DataNode *node, const BaseProperty *property)
+{
+  auto finding = m_ObservedProperties.find(property);
+  if (finding == m_ObservedProperties.end())
+    return;
+
+  auto nodeIt = finding->second.Nodes.find(node);
+  if (nodeIt != finding->second.Nodes.end())
+    finding->second.Nodes.erase(nodeIt);
+
+  if (finding->second.Nodes.empty())
+  {
+    const_cast<BaseProperty *>(property)->RemoveObserver(finding->second.ObserverTag);
+    m_ObservedProperties.erase(finding);
+  }
+}
+
+void mitk::StandaloneDataStorage::OnIndexedNodeModified(const itk::Object *caller, const itk::EventObject &)
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_Mutex);
+  this->UpdateIndex(dynamic_cast<const mitk::DataNode *>(caller));
+}
+
+void mitk::StandaloneDataStorage::OnIndexedPropertyModified(const itk::Object *caller, const itk::EventObject &)
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_Mutex);
+  auto finding = m_ObservedProperties.find(dynamic_cast<const BaseProperty *>(caller));
+  if (finding == m_ObservedProperties.end())
+    return;
+
+  /* copy, UpdateIndex() modifies the observed properties */
+  const NodeSet nodes(finding->second.Nodes.cbegin(), finding->second.Nodes.cend());
+  for (auto it = nodes.cbegin(); it != nodes.cend(); ++it)
+    this->UpdateIndex(*it);
+}
+
 void mitk::StandaloneDataStorage::PrintSelf(std::ostream &os, itk::Indent indent) const
 {
   os << indent << "StandaloneDataStorage:\n";
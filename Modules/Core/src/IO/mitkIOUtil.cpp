@@ -35,8 +35,12 @@ found in the LICENSE file.
 #include <vtkSmartPointer.h>
 #include <vtkTriangleFilter.h>
 
+#include <atomic>
 #include <cerrno>
+#include <condition_variable>
 #include <cstdlib>
+#include <mutex>
+#include <thread>
 
 static std::string GetLastErrorStr()
 {
@@ -314,6 +318,16 @@ namespace mitk
     static BaseData::Pointer LoadBaseDataFromFile(const std::string &path, const ReaderOptionsFunctorBase* optionsCallback = nullptr);
 
     static void SetDefaultDataNodeProperties(mitk::DataNode *node, const std::string &filePath = std::string());
+
+    /**
+     * Selects the reader of loadInfo and sets its options, re-using the readers and options chosen
+     * for previous files of the same mime-type (see usedReaderItems) or calling optionsCallback.
+     * Returns false if no reader is available for the file.
+     */
+    static bool SelectReader(LoadInfo &loadInfo,
+                             std::map<std::string, FileReaderSelector::Item> &usedReaderItems,
+                             const ReaderOptionsFunctorBase *optionsCallback,
+                             std::string &errMsg);
   };
 
   BaseData::Pointer IOUtil::Impl::LoadBaseDataFromFile(const std::string &path,
@@ -326,6 +340,79 @@ namespace mitk
     return baseDataList.front();
   }
 
+  bool IOUtil::Impl::SelectReader(LoadInfo &loadInfo,
+                                  std::map<std::string, FileReaderSelector::Item> &usedReaderItems,
+                                  const ReaderOptionsFunctorBase *optionsCallback,
+                                  std::string &errMsg)
+  {
+    std::vector<FileReaderSelector::Item> readers = loadInfo.m_ReaderSelector.Get();
+
+    if (readers.empty())
+    {
+      if (!itksys::SystemTools::FileExists(loadInfo.m_Path.c_str()))
+      {
+        errMsg += "File '" + loadInfo.m_Path + "' does not exist\n";
+      }
+      else
+      {
+        errMsg += "No reader available for '" + loadInfo.m_Path + "'\n";
+      }
+      return false;
+    }
+
+    bool callOptionsCallback = readers.size() > 1 || !readers.front().GetReader()->GetOptions().empty();
+
+    // check if we already used a reader which should be re-used
+    std::vector<MimeType> currMimeTypes = loadInfo.m_ReaderSelector.GetMimeTypes();
+    std::string selectedMimeType;
+    for (std::vector<MimeType>::const_iterator mimeTypeIter = currMimeTypes.begin(),
+                                               mimeTypeIterEnd = currMimeTypes.end();
+         mimeTypeIter != mimeTypeIterEnd;
+         ++mimeTypeIter)
+    {
+      std::map<std::string, FileReaderSelector::Item>::const_iterator oldSelectedItemIter =
+        usedReaderItems.find(mimeTypeIter->GetName());
+      if (oldSelectedItemIter != usedReaderItems.end())
+      {
+        // we found an already used item for a mime-type which is contained
+        // in the current reader set, check all current readers if there service
+        // id equals the old reader
+        for (std::vector<FileReaderSelector::Item>::const_iterator currReaderItem = readers.begin(),
+                                                                   currReaderItemEnd = readers.end();
+             currReaderItem != currReaderItemEnd;
+             ++currReaderItem)
+        {
+          if (currReaderItem->GetMimeType().GetName() == mimeTypeIter->GetName() &&
+              currReaderItem->GetServiceId() == oldSelectedItemIter->second.GetServiceId() &&
+              currReaderItem->GetConfidenceLevel() >= oldSelectedItemIter->second.GetConfidenceLevel())
+          {
+            // okay, we used the same reader already, re-use its options
+            selectedMimeType = mimeTypeIter->GetName();
+            callOptionsCallback = false;
+            loadInfo.m_ReaderSelector.Select(oldSelectedItemIter->second.GetServiceId());
+            loadInfo.m_ReaderSelector.GetSelected().GetReader()->SetOptions(
+              oldSelectedItemIter->second.GetReader()->GetOptions());
+            break;
+          }
+        }
+        if (!selectedMimeType.empty())
+          break;
+      }
+    }
+
+    if (callOptionsCallback && optionsCallback)
+    {
+      callOptionsCallback = (*optionsCallback)(loadInfo);
+      if (!callOptionsCallback && !loadInfo.m_Cancel)
+      {
+        usedReaderItems.erase(selectedMimeType);
+        FileReaderSelector::Item selectedItem = loadInfo.m_ReaderSelector.GetSelected();
+        usedReaderItems.insert(std::make_pair(selectedItem.GetMimeType().GetName(), selectedItem));
+      }
+    }
+    return true;
+  }
+
 #ifdef US_PLATFORM_WINDOWS
   std::string IOUtil::GetProgramPath()
   {
@@ -590,72 +677,11 @@ namespace mitk
       if(std::find(read_files.begin(), read_files.end(), loadInfo.m_Path) != read_files.end())
         continue;
 
-      std::vector<FileReaderSelector::Item> readers = loadInfo.m_ReaderSelector.Get();
-
-      if (readers.empty())
+      if (!Impl::SelectReader(loadInfo, usedReaderItems, optionsCallback, errMsg))
       {
-        if (!itksys::SystemTools::FileExists(loadInfo.m_Path.c_str()))
-        {
-          errMsg += "File '" + loadInfo.m_Path + "' does not exist\n";
-        }
-        else
-        {
-          errMsg += "No reader available for '" + loadInfo.m_Path + "'\n";
-        }
         continue;
       }
 
-      bool callOptionsCallback = readers.size() > 1 || !readers.front().GetReader()->GetOptions().empty();
-
-      // check if we already used a reader which should be re-used
-      std::vector<MimeType> currMimeTypes = loadInfo.m_ReaderSelector.GetMimeTypes();
-      std::string selectedMimeType;
-      for (std::vector<MimeType>::const_iterator mimeTypeIter = currMimeTypes.begin(),
-                                                 mimeTypeIterEnd = currMimeTypes.end();
-           mimeTypeIter != mimeTypeIterEnd;
-           ++mimeTypeIter)
-      {
-        std::map<std::string, FileReaderSelector::Item>::const_iterator oldSelectedItemIter =
-          usedReaderItems.find(mimeTypeIter->GetName());
-        if (oldSelectedItemIter != usedReaderItems.end())
-        {
-          // we found an already used item for a mime-type which is contained
-          // in the current reader set, check all current readers if there service
-          // id equals the old reader
-          for (std::vector<FileReaderSelector::Item>::const_iterator currReaderItem = readers.begin(),
-                                                                     currReaderItemEnd = readers.end();
-               currReaderItem != currReaderItemEnd;
-               ++currReaderItem)
-          {
-            if (currReaderItem->GetMimeType().GetName() == mimeTypeIter->GetName() &&
-                currReaderItem->GetServiceId() == oldSelectedItemIter->second.GetServiceId() &&
-                currReaderItem->GetConfidenceLevel() >= oldSelectedItemIter->second.GetConfidenceLevel())
-            {
-              // okay, we used the same reader already, re-use its options
-              selectedMimeType = mimeTypeIter->GetName();
-              callOptionsCallback = false;
-              loadInfo.m_ReaderSelector.Select(oldSelectedItemIter->second.GetServiceId());
-              loadInfo.m_ReaderSelector.GetSelected().GetReader()->SetOptions(
-                oldSelectedItemIter->second.GetReader()->GetOptions());
-              break;
-            }
-          }
-          if (!selectedMimeType.empty())
-            break;
-        }
-      }
-
-      if (callOptionsCallback && optionsCallback)
-      {
-        callOptionsCallback = (*optionsCallback)(loadInfo);
-        if (!callOptionsCallback && !loadInfo.m_Cancel)
-        {
-          usedReaderItems.erase(selectedMimeType);
-          FileReaderSelector::Item selectedItem = loadInfo.m_ReaderSelector.GetSelected();
-          usedReaderItems.insert(std::make_pair(selectedItem.GetMimeType().GetName(), selectedItem));
-        }
-      }
-
       if (loadInfo.m_Cancel)
       {
         errMsg += "Reading operation(s) cancelled.";
@@ -742,6 +768,300 @@ namespace mitk
     return errMsg;
   }
 
+  struct IOUtil::ConcurrentLoad::Impl
+  {
+    struct Job
+    {
+      std::size_t m_LoadInfoIndex;
+      StandaloneDataStorage::Pointer m_Storage;
+      DataStorage::SetOfObjects::Pointer m_Nodes;
+      std::vector<std::string> m_ReadFiles;
+      std::string m_ErrMsg;
+      bool m_Done;
+    };
+
+    Impl()
+      : m_NextJob(0), m_Cancelled(false), m_NumberOfFinishedJobs(0), m_NumberOfReportedJobs(0), m_NumberOfActiveThreads(0)
+    {
+    }
+
+    void ReadFiles();
+
+    std::vector<LoadInfo> m_LoadInfos;
+    std::vector<Job> m_Jobs;
+    std::string m_ErrMsg;
+    FileReadCallback m_FileRead;
+
+    std::atomic<std::size_t> m_NextJob;
+    std::atomic<bool> m_Cancelled;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_JobFinished;
+    std::size_t m_NumberOfFinishedJobs;
+    std::size_t m_NumberOfReportedJobs;
+    unsigned int m_NumberOfActiveThreads;
+    std::vector<std::thread> m_Threads;
+  };
+
+  void IOUtil::ConcurrentLoad::Impl::ReadFiles()
+  {
+    for (std::size_t jobIndex = m_NextJob++; jobIndex < m_Jobs.size() && !m_Cancelled; jobIndex = m_NextJob++)
+    {
+      Job &job = m_Jobs[jobIndex];
+      const LoadInfo &loadInfo = m_LoadInfos[job.m_LoadInfoIndex];
+      IFileReader *reader = loadInfo.m_ReaderSelector.GetSelected().GetReader();
+
+      // each file is read into a storage of its own, so readers never touch shared state
+      try
+      {
+        job.m_Storage = StandaloneDataStorage::New();
+        job.m_Nodes = reader->Read(*job.m_Storage);
+        job.m_ReadFiles = reader->GetReadFiles();
+        if (job.m_Nodes->empty())
+        {
+          job.m_ErrMsg = "Unknown read error occurred reading " + loadInfo.m_Path;
+        }
+      }
+      catch (const std::exception &e)
+      {
+        job.m_ErrMsg = "Exception occured when reading file " + loadInfo.m_Path + ":\n" + e.what() + "\n\n";
+      }
+      catch (...)
+      {
+        job.m_ErrMsg = "Unknown read error occurred reading " + loadInfo.m_Path;
+      }
+      job.m_Done = true;
+
+      if (m_FileRead)
+      {
+        m_FileRead(loadInfo, job.m_ErrMsg);
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        ++m_NumberOfFinishedJobs;
+      }
+      m_JobFinished.notify_all();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      --m_NumberOfActiveThreads;
+    }
+    m_JobFinished.notify_all();
+  }
+
+  IOUtil::ConcurrentLoad::ConcurrentLoad() : d(new Impl)
+  {
+  }
+
+  IOUtil::ConcurrentLoad::~ConcurrentLoad()
+  {
+    this->Cancel();
+    for (auto &thread : d->m_Threads)
+    {
+      thread.join();
+    }
+  }
+
+  void IOUtil::ConcurrentLoad::Cancel()
+  {
+    d->m_Cancelled = true;
+  }
+
+  bool IOUtil::ConcurrentLoad::IsCancelled() const
+  {
+    return d->m_Cancelled;
+  }
+
+  bool IOUtil::ConcurrentLoad::UpdateProgress()
+  {
+    std::size_t numberOfNewJobs;
+    bool done;
+    {
+      std::lock_guard<std::mutex> lock(d->m_Mutex);
+      numberOfNewJobs = d->m_NumberOfFinishedJobs - d->m_NumberOfReportedJobs;
+      d->m_NumberOfReportedJobs = d->m_NumberOfFinishedJobs;
+      done = d->m_NumberOfActiveThreads == 0;
+    }
+
+    if (numberOfNewJobs > 0)
+    {
+      mitk::ProgressBar::GetInstance()->Progress(numberOfNewJobs);
+    }
+    return done;
+  }
+
+  void IOUtil::ConcurrentLoad::Wait()
+  {
+    while (!this->UpdateProgress())
+    {
+      std::unique_lock<std::mutex> lock(d->m_Mutex);
+      d->m_JobFinished.wait(lock, [this] {
+        return d->m_NumberOfFinishedJobs > d->m_NumberOfReportedJobs || d->m_NumberOfActiveThreads == 0;
+      });
+    }
+
+    for (auto &thread : d->m_Threads)
+    {
+      thread.join();
+    }
+    d->m_Threads.clear();
+  }
+
+  std::string IOUtil::ConcurrentLoad::Finish(DataStorage::SetOfObjects *nodeResult, DataStorage *ds)
+  {
+    this->Wait();
+
+    std::string errMsg = d->m_ErrMsg;
+    std::vector<std::string> readFiles;
+
+    for (auto &job : d->m_Jobs)
+    {
+      if (!job.m_Done)
+      {
+        continue;
+      }
+
+      LoadInfo &loadInfo = d->m_LoadInfos[job.m_LoadInfoIndex];
+      if (std::find(readFiles.begin(), readFiles.end(), loadInfo.m_Path) != readFiles.end())
+      {
+        continue;
+      }
+      readFiles.insert(readFiles.end(), job.m_ReadFiles.begin(), job.m_ReadFiles.end());
+
+      errMsg += job.m_ErrMsg;
+      if (job.m_Nodes.IsNull())
+      {
+        continue;
+      }
+
+      for (DataStorage::SetOfObjects::ConstIterator nodeIter = job.m_Nodes->Begin(), nodeIterEnd = job.m_Nodes->End();
+           nodeIter != nodeIterEnd;
+           ++nodeIter)
+      {
+        const mitk::DataNode::Pointer &node = nodeIter->Value();
+        mitk::BaseData::Pointer data = node->GetData();
+        if (data.IsNull())
+        {
+          continue;
+        }
+
+        mitk::StringProperty::Pointer pathProp = mitk::StringProperty::New(loadInfo.m_Path);
+        data->SetProperty("path", pathProp);
+
+        loadInfo.m_Output.push_back(data);
+        if (ds != nullptr)
+        {
+          ds->Add(node, job.m_Storage->GetSources(node, nullptr, true));
+        }
+        if (nodeResult)
+        {
+          nodeResult->push_back(node);
+        }
+      }
+
+      job.m_Storage = nullptr;
+      job.m_Nodes = nullptr;
+    }
+
+    if (d->m_Cancelled)
+    {
+      errMsg += "Reading operation(s) cancelled.";
+    }
+
+    if (!errMsg.empty())
+    {
+      MITK_ERROR << errMsg;
+    }
+
+    // files skipped due to cancellation
+    std::lock_guard<std::mutex> lock(d->m_Mutex);
+    if (d->m_Jobs.size() > d->m_NumberOfReportedJobs)
+    {
+      mitk::ProgressBar::GetInstance()->Progress(d->m_Jobs.size() - d->m_NumberOfReportedJobs);
+      d->m_NumberOfReportedJobs = d->m_Jobs.size();
+    }
+
+    return errMsg;
+  }
+
+  const std::vector<IOUtil::LoadInfo> &IOUtil::ConcurrentLoad::GetLoadInfos() const
+  {
+    return d->m_LoadInfos;
+  }
+
+  std::unique_ptr<IOUtil::ConcurrentLoad> IOUtil::LoadConcurrently(const std::vector<std::string> &paths,
+                                                                   const ReaderOptionsFunctorBase *optionsCallback,
+                                                                   const FileReadCallback &fileRead,
+                                                                   unsigned int numberOfThreads)
+  {
+    std::unique_ptr<ConcurrentLoad> load(new ConcurrentLoad);
+    ConcurrentLoad::Impl *d = load->d.get();
+    d->m_FileRead = fileRead;
+
+    for (const auto &path : paths)
+    {
+      d->m_LoadInfos.push_back(LoadInfo(path));
+    }
+
+    if (d->m_LoadInfos.empty())
+    {
+      d->m_ErrMsg = "No input files given";
+      return load;
+    }
+
+    // the options callback may show dialogs, so readers are selected on the calling thread
+    std::map<std::string, FileReaderSelector::Item> usedReaderItems;
+    for (std::size_t i = 0; i < d->m_LoadInfos.size(); ++i)
+    {
+      LoadInfo &loadInfo = d->m_LoadInfos[i];
+      if (!Impl::SelectReader(loadInfo, usedReaderItems, optionsCallback, d->m_ErrMsg))
+      {
+        continue;
+      }
+
+      if (loadInfo.m_Cancel)
+      {
+        d->m_Jobs.clear();
+        d->m_Cancelled = true;
+        return load;
+      }
+
+      if (loadInfo.m_ReaderSelector.GetSelected().GetReader() == nullptr)
+      {
+        d->m_ErrMsg += "Unexpected nullptr reader.";
+        continue;
+      }
+
+      ConcurrentLoad::Impl::Job job;
+      job.m_LoadInfoIndex = i;
+      job.m_Done = false;
+      d->m_Jobs.push_back(job);
+    }
+
+    if (d->m_Jobs.empty())
+    {
+      return load;
+    }
+
+    if (numberOfThreads == 0)
+    {
+      numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numberOfThreads = static_cast<unsigned int>(std::min<std::size_t>(numberOfThreads, d->m_Jobs.size()));
+
+    mitk::ProgressBar::GetInstance()->AddStepsToDo(d->m_Jobs.size());
+
+    d->m_NumberOfActiveThreads = numberOfThreads;
+    for (unsigned int i = 0; i < numberOfThreads; ++i)
+    {
+      d->m_Threads.emplace_back(&ConcurrentLoad::Impl::ReadFiles, d);
+    }
+
+    return load;
+  }
+
   std::vector<BaseData::Pointer> IOUtil::Load(const us::ModuleResource &usResource, std::ios_base::openmode mode)
   {
     us::ModuleResourceStream resStream(usResource, mode);
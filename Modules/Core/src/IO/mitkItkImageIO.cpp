@@ -11,6 +11,7 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkItkImageIO.h"
+#include "mitkItkImageVolumeLoader.h"
 
 #include <mitkArbitraryTimeGeometry.h>
 #include <mitkCoreServices.h>
@@ -28,6 +29,7 @@ found in the LICENSE file.
 #include <itkMetaDataObject.h>
 
 #include <algorithm>
+#include <memory>
 
 namespace mitk
 {
@@ -120,6 +122,7 @@ namespace mitk
 
     this->AbstractFileReader::SetMimeTypePrefix(IOMimeTypes::DEFAULT_BASE_NAME() + ".image.");
     this->InitializeDefaultMetaDataKeys();
+    this->InitializeDefaultReaderOptions();
 
     std::vector<std::string> readExtensions = m_ImageIO->GetSupportedReadExtensions();
 
@@ -205,6 +208,7 @@ namespace mitk
 
     this->AbstractFileReader::SetMimeTypePrefix(IOMimeTypes::DEFAULT_BASE_NAME() + ".image.");
     this->InitializeDefaultMetaDataKeys();
+    this->InitializeDefaultReaderOptions();
 
     if (rank)
     {
@@ -215,6 +219,51 @@ namespace mitk
     this->RegisterService();
   }
 
+  std::string ItkImageIO::OPTION_DATA_LOADING()
+  {
+    static std::string s = "Data loading";
+    return s;
+  }
+
+  std::string ItkImageIO::OPTION_DATA_LOADING_ENUM()
+  {
+    static std::string s = OPTION_DATA_LOADING() + ".enum";
+    return s;
+  }
+
+  std::string ItkImageIO::DATA_LOADING_IMMEDIATELY()
+  {
+    static std::string s = "Immediately";
+    return s;
+  }
+
+  std::string ItkImageIO::DATA_LOADING_ON_ACCESS()
+  {
+    static std::string s = "On access";
+    return s;
+  }
+
+  std::string ItkImageIO::DATA_LOADING_IN_BACKGROUND()
+  {
+    static std::string s = "In background";
+    return s;
+  }
+
+  void ItkImageIO::InitializeDefaultReaderOptions()
+  {
+    Options defaultOptions;
+
+    defaultOptions[OPTION_DATA_LOADING()] = DATA_LOADING_IMMEDIATELY();
+
+    std::vector<std::string> dataLoadingEnum;
+    dataLoadingEnum.push_back(DATA_LOADING_IMMEDIATELY());
+    dataLoadingEnum.push_back(DATA_LOADING_ON_ACCESS());
+    dataLoadingEnum.push_back(DATA_LOADING_IN_BACKGROUND());
+    defaultOptions[OPTION_DATA_LOADING_ENUM()] = dataLoadingEnum;
+
+    this->SetDefaultReaderOptions(defaultOptions);
+  }
+
   /**Helper function that converts the content of a meta data into a time point vector.
    * If MetaData is not valid or cannot be converted an empty vector is returned.*/
   std::vector<TimePointType> ConvertMetaDataObjectToTimePointList(const itk::MetaDataObjectBase *data)
@@ -310,13 +359,38 @@ namespace mitk
     ioRegion.SetSize(ioSize);
     ioRegion.SetIndex(ioStart);
 
-    MITK_INFO << "ioRegion: " << ioRegion << std::endl;
-    m_ImageIO->SetIORegion(ioRegion);
-    void *buffer = new unsigned char[m_ImageIO->GetImageSizeInBytes()];
-    m_ImageIO->Read(buffer);
-
     image->Initialize(MakePixelType(m_ImageIO), ndim, dimensions);
-    image->SetImportChannel(buffer, 0, Image::ManageMemory);
+
+    std::string dataLoading = DATA_LOADING_IMMEDIATELY();
+    try
+    {
+      dataLoading = us::any_cast<std::string>(this->GetReaderOption(OPTION_DATA_LOADING()));
+    }
+    catch (const us::BadAnyCastException &e)
+    {
+      MITK_WARN << "Unexpected error in reading reader options: " << e.what();
+    }
+
+    // a file read from a stream is a temporary copy, which is deleted after reading
+    if (dataLoading != DATA_LOADING_IMMEDIATELY() && this->AbstractFileReader::GetInputStream() == nullptr)
+    {
+      MITK_INFO << "image data is read " << (dataLoading == DATA_LOADING_IN_BACKGROUND() ? "in background" : "on access");
+      auto loader = std::make_shared<ItkImageVolumeLoader>(
+        dynamic_cast<itk::ImageIOBase *>(m_ImageIO->Clone().GetPointer()),
+        path,
+        ndim,
+        dataLoading == DATA_LOADING_IN_BACKGROUND());
+      image->SetVolumeLoader([loader](Image *image, int t, int n) { loader->Load(image, t, n); });
+    }
+    else
+    {
+      MITK_INFO << "ioRegion: " << ioRegion << std::endl;
+      m_ImageIO->SetIORegion(ioRegion);
+      void *buffer = new unsigned char[m_ImageIO->GetImageSizeInBytes()];
+      m_ImageIO->Read(buffer);
+
+      image->SetImportChannel(buffer, 0, Image::ManageMemory);
+    }
 
     const itk::MetaDataDictionary &dictionary = m_ImageIO->GetMetaDataDictionary();
 
@@ -406,7 +480,6 @@ namespace mitk
 
     image->SetTimeGeometry(timeGeometry);
 
-    buffer = nullptr;
     MITK_INFO << "number of image components: " << image->GetPixelType().GetNumberOfComponents() << std::endl;
 
     for (auto iter = dictionary.Begin(), iterEnd = dictionary.End(); iter != iterEnd;
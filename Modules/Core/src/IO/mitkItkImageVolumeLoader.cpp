@@ -0,0 +1,183 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkItkImageVolumeLoader.h"
+
+#include <mitkLocaleSwitch.h>
+
+#include <itkImageIORegion.h>
+
+#include <algorithm>
+
+mitk::ItkImageVolumeLoader::ItkImageVolumeLoader(itk::ImageIOBase *imageIO,
+                                                 const std::string &fileName,
+                                                 unsigned int numberOfDimensions,
+                                                 bool readInBackground)
+  : m_ImageIO(imageIO), m_NumberOfDimensions(numberOfDimensions), m_RequestedBlock(-1), m_Stop(false)
+{
+  m_ImageIO->SetFileName(fileName);
+  m_ImageIO->ReadImageInformation();
+
+  m_ReadVolumes = m_ImageIO->CanStreamRead() && m_NumberOfDimensions == 4 && m_ImageIO->GetNumberOfDimensions() == 4;
+
+  const unsigned int numberOfBlocks = m_ReadVolumes ? m_ImageIO->GetDimensions(3) : 1;
+  m_States.assign(numberOfBlocks, BlockState::Unread);
+  m_Buffers.resize(numberOfBlocks);
+
+  if (readInBackground)
+  {
+    m_Thread = std::thread(&ItkImageVolumeLoader::ReadInBackground, this);
+  }
+}
+
+mitk::ItkImageVolumeLoader::~ItkImageVolumeLoader()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stop = true;
+  }
+
+  if (m_Thread.joinable())
+  {
+    m_Thread.join();
+  }
+}
+
+void mitk::ItkImageVolumeLoader::Load(Image *image, int t, int n)
+{
+  if (n != 0)
+  {
+    return;
+  }
+
+  const unsigned int block = m_ReadVolumes ? t : 0;
+  std::unique_ptr<unsigned char[]> buffer;
+
+  if (m_Thread.joinable())
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (m_States[block] == BlockState::Unread && !m_Error)
+    {
+      m_RequestedBlock = block;
+      m_BlockRead.wait(lock);
+    }
+
+    if (m_States[block] == BlockState::Read)
+    {
+      buffer = std::move(m_Buffers[block]);
+      m_States[block] = BlockState::Taken;
+    }
+    else if (m_States[block] == BlockState::Unread)
+    {
+      std::rethrow_exception(m_Error);
+    }
+  }
+
+  // read on access, or read again if the image has released data it took before
+  if (!buffer)
+  {
+    LocaleSwitch localeSwitch("C");
+    std::lock_guard<std::mutex> readLock(m_ReadMutex);
+    buffer = this->ReadBlock(block);
+  }
+
+  unsigned char *data = buffer.release();
+  const bool dataSet = m_ReadVolumes ? image->SetImportVolume(data, t, n, Image::ManageMemory)
+                                     : image->SetImportChannel(data, n, Image::ManageMemory);
+  if (!dataSet)
+  {
+    delete[] data;
+  }
+}
+
+std::unique_ptr<unsigned char[]> mitk::ItkImageVolumeLoader::ReadBlock(unsigned int block)
+{
+  itk::ImageIORegion ioRegion(m_NumberOfDimensions);
+  itk::ImageIORegion::SizeType ioSize = ioRegion.GetSize();
+  itk::ImageIORegion::IndexType ioStart = ioRegion.GetIndex();
+
+  for (unsigned int i = 0; i < m_NumberOfDimensions; ++i)
+  {
+    ioStart[i] = 0;
+    ioSize[i] = m_ImageIO->GetDimensions(i);
+  }
+
+  if (m_ReadVolumes)
+  {
+    ioStart[3] = block;
+    ioSize[3] = 1;
+  }
+
+  ioRegion.SetSize(ioSize);
+  ioRegion.SetIndex(ioStart);
+  m_ImageIO->SetIORegion(ioRegion);
+
+  const std::size_t size = m_ReadVolumes ? ioRegion.GetNumberOfPixels() * m_ImageIO->GetPixelSize()
+                                         : m_ImageIO->GetImageSizeInBytes();
+  std::unique_ptr<unsigned char[]> buffer(new unsigned char[size]);
+  m_ImageIO->Read(buffer.get());
+  return buffer;
+}
+
+void mitk::ItkImageVolumeLoader::ReadInBackground()
+{
+  try
+  {
+    while (true)
+    {
+      unsigned int block;
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Stop)
+        {
+          return;
+        }
+
+        if (m_RequestedBlock >= 0 && m_States[m_RequestedBlock] == BlockState::Unread)
+        {
+          block = m_RequestedBlock;
+        }
+        else
+        {
+          auto next = std::find(m_States.begin(), m_States.end(), BlockState::Unread);
+          if (next == m_States.end())
+          {
+            return;
+          }
+          block = next - m_States.begin();
+        }
+        m_RequestedBlock = -1;
+      }
+
+      std::unique_ptr<unsigned char[]> buffer;
+      {
+        std::lock_guard<std::mutex> readLock(m_ReadMutex);
+        buffer = this->ReadBlock(block);
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Buffers[block] = std::move(buffer);
+        m_States[block] = BlockState::Read;
+      }
+      m_BlockRead.notify_all();
+    }
+  }
+  catch (...)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Error = std::current_exception();
+    }
+    m_BlockRead.notify_all();
+  }
+}
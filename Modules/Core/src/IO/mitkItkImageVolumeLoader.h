@@ -0,0 +1,88 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkItkImageVolumeLoader_h
+#define mitkItkImageVolumeLoader_h
+
+#include <mitkImage.h>
+
+#include <itkImageIOBase.h>
+
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * @brief Reads the data of an image file when it is accessed, see Image::SetVolumeLoader().
+   *
+   * If the ImageIO supports streamed reading, each volume of a 3D+t image is read separately by restricting the
+   * IO region to its time step. Otherwise, the whole file is read on the first access.
+   *
+   * In background mode, a thread reads all volumes in the order of their time steps right away. Accessing a
+   * volume waits until the thread has read it; a volume that is waited for is read next.
+   */
+  class ItkImageVolumeLoader
+  {
+  public:
+    /**
+     * @param imageIO ImageIO that is used by the loader only
+     * @param fileName file to read
+     * @param numberOfDimensions number of dimensions of the image as read by ItkImageIO
+     * @param readInBackground whether to start reading all volumes immediately
+     */
+    ItkImageVolumeLoader(itk::ImageIOBase *imageIO,
+                         const std::string &fileName,
+                         unsigned int numberOfDimensions,
+                         bool readInBackground);
+
+    /** @brief Stops reading in background, waiting for the volume that is read at the moment. */
+    ~ItkImageVolumeLoader();
+
+    /** @brief Sets the data of volume @a t of @a image (or its whole channel if volumes cannot be read separately). */
+    void Load(Image *image, int t, int n);
+
+  private:
+    enum class BlockState
+    {
+      Unread,
+      Read,
+      Taken
+    };
+
+    std::unique_ptr<unsigned char[]> ReadBlock(unsigned int block);
+    void ReadInBackground();
+
+    itk::ImageIOBase::Pointer m_ImageIO;
+    unsigned int m_NumberOfDimensions;
+    /** True if each volume is read separately; otherwise the only block is the whole image. */
+    bool m_ReadVolumes;
+
+    /** Serializes the use of m_ImageIO */
+    std::mutex m_ReadMutex;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_BlockRead;
+    std::vector<BlockState> m_States;
+    std::vector<std::unique_ptr<unsigned char[]>> m_Buffers;
+    int m_RequestedBlock;
+    bool m_Stop;
+    std::exception_ptr m_Error;
+    std::thread m_Thread;
+  };
+}
+
+#endif
@@ -15,8 +15,23 @@ found in the LICENSE file.
 #include "mitkLogMacros.h"
 
 #include <clocale>
+#include <mutex>
 #include <string>
 
+namespace
+{
+  /// guards setlocale() and the shared switch below
+  std::mutex switchMutex;
+
+  /// locale installed by LocaleSwitch objects that are alive at the same time
+  std::string sharedLocale;
+
+  /// locale to restore when the last of these objects is destroyed
+  std::string sharedOldLocale;
+
+  unsigned int numberOfSharedSwitches = 0;
+}
+
 namespace mitk
 {
   struct LocaleSwitch::Impl
@@ -31,12 +46,27 @@ namespace mitk
 
     /// locale during life-time of object
     const std::string m_NewLocale;
+
+    /// whether the switch is shared with other objects
+    bool m_Shared;
   };
 
-  LocaleSwitch::Impl::Impl(const std::string &newLocale) : m_NewLocale(newLocale)
+  LocaleSwitch::Impl::Impl(const std::string &newLocale) : m_NewLocale(newLocale), m_Shared(false)
   {
+    std::lock_guard<std::mutex> lock(switchMutex);
+
     // query and keep the current locale
     const char *currentLocale = std::setlocale(LC_ALL, nullptr);
+
+    // another object has installed this locale already
+    if (numberOfSharedSwitches > 0 && sharedLocale == m_NewLocale && currentLocale != nullptr &&
+        sharedLocale == currentLocale)
+    {
+      ++numberOfSharedSwitches;
+      m_Shared = true;
+      return;
+    }
+
     if (currentLocale != nullptr)
       m_OldLocale = currentLocale;
     else
@@ -50,11 +80,29 @@ namespace mitk
         MITK_INFO << "Could not switch to locale " << m_NewLocale;
         m_OldLocale = "";
       }
+      else if (numberOfSharedSwitches == 0)
+      {
+        sharedLocale = m_NewLocale;
+        sharedOldLocale = m_OldLocale;
+        numberOfSharedSwitches = 1;
+        m_Shared = true;
+      }
     }
   }
 
   LocaleSwitch::Impl::~Impl()
   {
+    std::lock_guard<std::mutex> lock(switchMutex);
+
+    if (m_Shared)
+    {
+      if (--numberOfSharedSwitches == 0 && !std::setlocale(LC_ALL, sharedOldLocale.c_str()))
+      {
+        MITK_INFO << "Could not reset original locale " << sharedOldLocale;
+      }
+      return;
+    }
+
     if (!m_OldLocale.empty() && m_OldLocale != m_NewLocale && !std::setlocale(LC_ALL, m_OldLocale.c_str()))
     {
       MITK_INFO << "Could not reset original locale " << m_OldLocale;
@@ -0,0 +1,219 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkImageSliceCache.h"
+
+#include <mitkImage.h>
+#include <mitkPlaneGeometry.h>
+
+#include <algorithm>
+
+namespace
+{
+  void AppendGeometry(const mitk::BaseGeometry *geometry, std::vector<mitk::ScalarType> &values)
+  {
+    if (nullptr == geometry)
+    {
+      values.push_back(0.0);
+      return;
+    }
+
+    values.push_back(geometry->GetImageGeometry() ? 2.0 : 1.0);
+
+    const auto *transform = geometry->GetIndexToWorldTransform();
+    const auto &matrix = transform->GetMatrix();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      for (unsigned int j = 0; j < 3; ++j)
+      {
+        values.push_back(matrix[i][j]);
+      }
+    }
+
+    const auto &offset = transform->GetOffset();
+    values.insert(values.end(), offset.Begin(), offset.End());
+
+    const auto &bounds = geometry->GetBounds();
+    values.insert(values.end(), bounds.Begin(), bounds.End());
+  }
+}
+
+mitk::ImageSliceCache::Key::Key(const Image *image,
+                                const PlaneGeometry *worldGeometry,
+                                unsigned int timeStep,
+                                ExtractSliceFilter::ResliceInterpolation interpolationMode,
+                                bool inPlaneResampleExtentByGeometry)
+  : m_Image(image),
+    m_ImageTime(image->GetMTime()),
+    m_TimeStep(timeStep),
+    m_InterpolationMode(interpolationMode),
+    m_InPlaneResampleExtentByGeometry(inPlaneResampleExtentByGeometry)
+{
+  m_Geometry.reserve(3 * 19);
+  AppendGeometry(worldGeometry, m_Geometry);
+  AppendGeometry(worldGeometry->GetReferenceGeometry(), m_Geometry);
+  AppendGeometry(image->GetTimeGeometry()->GetGeometryForTimeStep(timeStep), m_Geometry);
+}
+
+bool mitk::ImageSliceCache::Key::operator<(const Key &other) const
+{
+  if (m_Image != other.m_Image)
+    return m_Image < other.m_Image;
+  if (m_ImageTime != other.m_ImageTime)
+    return m_ImageTime < other.m_ImageTime;
+  if (m_TimeStep != other.m_TimeStep)
+    return m_TimeStep < other.m_TimeStep;
+  if (m_InterpolationMode != other.m_InterpolationMode)
+    return m_InterpolationMode < other.m_InterpolationMode;
+  if (m_InPlaneResampleExtentByGeometry != other.m_InPlaneResampleExtentByGeometry)
+    return m_InPlaneResampleExtentByGeometry < other.m_InPlaneResampleExtentByGeometry;
+  return m_Geometry < other.m_Geometry;
+}
+
+mitk::ImageSliceCache *mitk::ImageSliceCache::GetInstance()
+{
+  static ImageSliceCache instance;
+  return &instance;
+}
+
+mitk::ImageSliceCache::ImageSliceCache()
+  : m_Size(0), m_MaximumSize(256 * 1024 * 1024), m_NumberOfHits(0), m_NumberOfMisses(0)
+{
+}
+
+mitk::ImageSliceCache::SlicePointer mitk::ImageSliceCache::Find(const Key &key)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  auto iter = m_Index.find(key);
+  if (iter == m_Index.end())
+  {
+    ++m_NumberOfMisses;
+    return nullptr;
+  }
+
+  ++m_NumberOfHits;
+  m_Slices.splice(m_Slices.begin(), m_Slices, iter->second);
+  return iter->second->second;
+}
+
+mitk::ImageSliceCache::SlicePointer mitk::ImageSliceCache::Insert(const Key &key, ExtractSliceFilter *reslicer)
+{
+  // copy outside of the lock, the output of the reslicer is overwritten by its next update
+  auto image = vtkSmartPointer<vtkImageData>::New();
+  image->DeepCopy(reslicer->GetVtkOutput());
+  SlicePointer slice = CreateSlice(reslicer, image);
+  const std::size_t size = GetSizeOfSlice(*slice);
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  if (size > m_MaximumSize)
+  {
+    return slice;
+  }
+
+  auto iter = m_Index.find(key);
+  if (iter != m_Index.end())
+  {
+    // another renderer resliced the same slice in the meantime
+    m_Size -= GetSizeOfSlice(*iter->second->second);
+    m_Slices.erase(iter->second);
+    m_Index.erase(iter);
+  }
+
+  this->Shrink(m_MaximumSize - size);
+
+  m_Slices.emplace_front(key, slice);
+  m_Index.emplace(key, m_Slices.begin());
+  m_Size += size;
+
+  return slice;
+}
+
+mitk::ImageSliceCache::SlicePointer mitk::ImageSliceCache::CreateSlice(ExtractSliceFilter *reslicer,
+                                                                       vtkImageData *image)
+{
+  auto slice = std::make_shared<Slice>();
+  slice->m_Image = image;
+  slice->m_ResliceAxes = vtkSmartPointer<vtkMatrix4x4>::New();
+  slice->m_ResliceAxes->DeepCopy(reslicer->GetResliceAxes());
+  const ScalarType *spacing = reslicer->GetOutputSpacing();
+  slice->m_Spacing[0] = spacing[0];
+  slice->m_Spacing[1] = spacing[1];
+  return slice;
+}
+
+void mitk::ImageSliceCache::SetMaximumSize(std::size_t bytes)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_MaximumSize = bytes;
+  this->Shrink(m_MaximumSize);
+}
+
+std::size_t mitk::ImageSliceCache::GetMaximumSize() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MaximumSize;
+}
+
+std::size_t mitk::ImageSliceCache::GetSize() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Size;
+}
+
+std::size_t mitk::ImageSliceCache::GetNumberOfSlices() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Slices.size();
+}
+
+unsigned long mitk::ImageSliceCache::GetNumberOfHits() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfHits;
+}
+
+unsigned long mitk::ImageSliceCache::GetNumberOfMisses() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfMisses;
+}
+
+void mitk::ImageSliceCache::ResetStatistics()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_NumberOfHits = 0;
+  m_NumberOfMisses = 0;
+}
+
+void mitk::ImageSliceCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  this->Shrink(0);
+}
+
+std::size_t mitk::ImageSliceCache::GetSizeOfSlice(const Slice &slice)
+{
+  // vtkImageData reports kibibytes
+  return static_cast<std::size_t>(slice.m_Image->GetActualMemorySize()) * 1024;
+}
+
+void mitk::ImageSliceCache::Shrink(std::size_t maximumSize)
+{
+  while (m_Size > maximumSize && !m_Slices.empty())
+  {
+    m_Size -= GetSizeOfSlice(*m_Slices.back().second);
+    m_Index.erase(m_Slices.back().first);
+    m_Slices.pop_back();
+  }
+}
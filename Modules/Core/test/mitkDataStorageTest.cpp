@@ -12,6 +12,7 @@ found in the LICENSE file.
 
 #include <algorithm>
 #include <fstream>
+#include <sstream>
 
 #include "mitkColorProperty.h"
 #include "mitkDataNode.h"
@@ -27,6 +28,7 @@ found in the LICENSE file.
 #include "mitkNodePredicateAnd.h"
 #include "mitkNodePredicateData.h"
 #include "mitkNodePredicateDataType.h"
+#include "mitkNodePredicateDataUID.h"
 #include "mitkNodePredicateDimension.h"
 #include "mitkNodePredicateNot.h"
 #include "mitkNodePredicateOr.h"
@@ -37,6 +39,7 @@ found in the LICENSE file.
 #include "mitkTestingMacros.h"
 
 void TestDataStorage(mitk::DataStorage *ds, std::string filename);
+void TestStandaloneDataStorageIndex();
 
 namespace mitk
 {
@@ -146,9 +149,10 @@ int mitkDataStorageTest(int argc, char *argv[])
   MITK_TEST_OUTPUT(<< "Testing StandaloneDataStorage: ");
   MITK_TEST_CONDITION_REQUIRED(argc > 1, "Testing correct test invocation");
   TestDataStorage(sds, argv[1]);
-  // TODO: Add specific StandaloneDataStorage Tests here
   sds = nullptr;
 
+  TestStandaloneDataStorageIndex();
+
   MITK_TEST_END();
 }
 
@@ -872,3 +876,91 @@ void TestDataStorage(mitk::DataStorage *ds, std::string filename)
   ds->Remove(ds->GetAll());
   MITK_TEST_CONDITION(ds->GetAll()->Size() == 0, "Checking Clear DataStorage");
 }
+
+//##Documentation
+//## @brief Test that the indexed lookups of StandaloneDataStorage::GetSubset() return the same
+//## results as checking every node, also after names, properties and data have been changed.
+void TestStandaloneDataStorageIndex()
+{
+  mitk::StandaloneDataStorage::Pointer ds = mitk::StandaloneDataStorage::New();
+  ds->AddIndexedPropertyKey("organ");
+  MITK_TEST_CONDITION(ds->GetIndexedPropertyKeys().count("name") == 1 && ds->GetIndexedPropertyKeys().count("organ") == 1,
+                      "Checking indexed property keys");
+
+  std::vector<mitk::DataNode::Pointer> nodes;
+  for (unsigned int i = 0; i < 100; ++i)
+  {
+    mitk::DataNode::Pointer node = mitk::DataNode::New();
+    std::ostringstream name;
+    name << "node" << i % 10;
+    node->SetName(name.str());
+    if (i % 2 == 0)
+      node->SetData(mitk::Image::New());
+    else if (i % 3 == 0)
+      node->SetData(mitk::Surface::New());
+    if (i % 4 == 0)
+      node->SetStringProperty("organ", "liver");
+    ds->Add(node);
+    nodes.push_back(node);
+  }
+
+  auto checkPredicate = [&ds](const mitk::NodePredicateBase *predicate, const std::string &description) {
+    mitk::DataStorage::SetOfObjects::ConstPointer indexed = ds->GetSubset(predicate);
+    mitk::DataStorage::SetOfObjects::ConstPointer scanned = ds->mitk::DataStorage::GetSubset(predicate);
+    bool equal = indexed->Size() == scanned->Size() &&
+                 std::equal(indexed->begin(), indexed->end(), scanned->begin());
+    MITK_TEST_CONDITION(equal, "Checking indexed GetSubset() for " << description);
+  };
+
+  mitk::NodePredicateProperty::Pointer nameIs3 =
+    mitk::NodePredicateProperty::New("name", mitk::StringProperty::New("node3"));
+  mitk::NodePredicateProperty::Pointer isLiver =
+    mitk::NodePredicateProperty::New("organ", mitk::StringProperty::New("liver"));
+  mitk::NodePredicateProperty::Pointer hasOrgan = mitk::NodePredicateProperty::New("organ");
+  mitk::NodePredicateDataType::Pointer isImage = mitk::NodePredicateDataType::New("Image");
+  mitk::NodePredicateDataType::Pointer isSurface = mitk::NodePredicateDataType::New("Surface");
+  mitk::NodePredicateDataUID::Pointer hasUID = mitk::NodePredicateDataUID::New(nodes[10]->GetData()->GetUID());
+  mitk::NodePredicateAnd::Pointer liverImages = mitk::NodePredicateAnd::New(isLiver, isImage);
+  mitk::NodePredicateOr::Pointer imagesOrSurfaces = mitk::NodePredicateOr::New(isImage, isSurface);
+
+  MITK_TEST_CONDITION(ds->GetSubset(nameIs3)->Size() == 10, "Checking number of nodes with a given name");
+  MITK_TEST_CONDITION(ds->GetSubset(isImage)->Size() == 50, "Checking number of nodes with a given data type");
+  MITK_TEST_CONDITION(ds->GetSubset(hasUID)->Size() == 1 && ds->GetSubset(hasUID)->GetElement(0) == nodes[10],
+                      "Checking node with a given data UID");
+  MITK_TEST_CONDITION(ds->GetNamedNode("node3") != nullptr && ds->GetNamedNode("node10") == nullptr,
+                      "Checking GetNamedNode()");
+
+  checkPredicate(nameIs3, "name");
+  checkPredicate(isLiver, "property value");
+  checkPredicate(hasOrgan, "property existence");
+  checkPredicate(isImage, "data type");
+  checkPredicate(hasUID, "data UID");
+  checkPredicate(liverImages, "conjunction");
+  checkPredicate(imagesOrSurfaces, "disjunction");
+
+  /* change nodes in all ways that affect the indexes */
+  nodes[3]->SetName("renamed");
+  nodes[13]->SetData(mitk::Image::New());
+  nodes[23]->SetData(nullptr);
+  dynamic_cast<mitk::StringProperty *>(nodes[4]->GetProperty("organ"))->SetValue("kidney");
+  nodes[5]->SetStringProperty("organ", "liver");
+  nodes[8]->GetPropertyList()->DeleteProperty("organ");
+  nodes[33]->GetPropertyList()->DeleteProperty("name");
+  nodes[33]->GetData()->SetProperty("name", mitk::StringProperty::New("node3"));
+
+  MITK_TEST_CONDITION(ds->GetSubset(nameIs3)->Size() == 9, "Checking number of nodes with a given name after changes");
+  checkPredicate(nameIs3, "name after changes");
+  checkPredicate(isLiver, "property value after changes");
+  checkPredicate(hasOrgan, "property existence after changes");
+  checkPredicate(isImage, "data type after changes");
+  checkPredicate(liverImages, "conjunction after changes");
+  checkPredicate(imagesOrSurfaces, "disjunction after changes");
+
+  ds->Remove(nodes[13]);
+  nodes[13]->SetName("node3");
+  checkPredicate(nameIs3, "name after removal");
+  checkPredicate(isImage, "data type after removal");
+
+  ds->Remove(ds->GetAll());
+  MITK_TEST_CONDITION(ds->GetSubset(isImage)->Size() == 0, "Checking empty index after clearing the data storage");
+}
@@ -10,14 +10,19 @@ found in the LICENSE file.
 
 ============================================================================*/
 
+#include <itkBSplineInterpolateImageFunction.h>
 #include <itkImage.h>
 #include <itkImageRegionIterator.h>
+#include <itkLinearInterpolateImageFunction.h>
+#include <itkNearestNeighborInterpolateImageFunction.h>
 #include <mitkExtractSliceFilter.h>
+#include <mitkExtractSliceFilter2.h>
 #include <mitkIOUtil.h>
 #include <mitkITKImageImport.h>
 #include <mitkImageAccessByItk.h>
 #include <mitkImageCast.h>
 #include <mitkImagePixelReadAccessor.h>
+#include <mitkImageReadAccessor.h>
 #include <mitkInteractionConst.h>
 #include <mitkNumericTypes.h>
 #include <mitkRotationOperation.h>
@@ -25,8 +30,10 @@ found in the LICENSE file.
 #include <mitkTestingMacros.h>
 
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <cmath>
+#include <limits>
 
 #include <mitkGeometry3D.h>
 
@@ -138,6 +145,109 @@ public:
 #endif
   }
 
+  /*
+   * Counts the pixels of a slice of the test volume that differ by more than one gray value from the volume sampled
+   * by interpolateFunction at their world positions (or from the background of ExtractSliceFilter2 outside of it).
+   */
+  static std::size_t CountPixelsDifferingFromReference(mitk::Image *slice,
+                                                       const itk::InterpolateImageFunction<itk::Image<unsigned char, 3>> *interpolateFunction)
+  {
+    mitk::ImageReadAccessor sliceAccess(slice);
+    const auto *slicePixels = static_cast<const unsigned char *>(sliceAccess.GetData());
+    const long width = static_cast<long>(slice->GetDimension(0));
+    const auto *sliceGeometry = slice->GetSlicedGeometry()->GetPlaneGeometry(0);
+    const unsigned char background = std::numeric_limits<unsigned char>::lowest();
+
+    std::size_t numberOfDifferingPixels = 0;
+    for (long y = 0; y < static_cast<long>(slice->GetDimension(1)); ++y)
+    {
+      for (long x = 0; x < width; ++x)
+      {
+        mitk::Point3D index;
+        index[0] = x;
+        index[1] = y;
+        index[2] = 0;
+        mitk::Point3D worldPoint;
+        sliceGeometry->IndexToWorld(index, worldPoint);
+
+        itk::Point<double, 3> point;
+        for (int i = 0; i < 3; ++i)
+          point[i] = worldPoint[i];
+
+        const double reference = interpolateFunction->IsInsideBuffer(point) ?
+                                   static_cast<unsigned char>(interpolateFunction->Evaluate(point)) :
+                                   background;
+
+        if (std::abs(reference - slicePixels[y * width + x]) > 1.0)
+          ++numberOfDifferingPixels;
+      }
+    }
+    return numberOfDifferingPixels;
+  }
+
+  /*
+   * Compares ExtractSliceFilter2 pixel by pixel with the ITK interpolate image function of each interpolation mode,
+   * and its threaded with its single-threaded result.
+   */
+  static void TestExtractSliceFilter2(mitk::PlaneGeometry *planeGeometry, std::string testname)
+  {
+    typedef itk::Image<unsigned char, 3> TestVolumeType;
+
+    TestVolumeType::Pointer itkVolume;
+    mitk::CastToItkImage(TestVolume, itkVolume);
+
+    auto bSplineInterpolateFunction = itk::BSplineInterpolateImageFunction<TestVolumeType>::New();
+    bSplineInterpolateFunction->SetSplineOrder(2);
+
+    const mitk::ExtractSliceFilter2::Interpolator interpolators[] = {
+      mitk::ExtractSliceFilter2::NearestNeighbor, mitk::ExtractSliceFilter2::Linear, mitk::ExtractSliceFilter2::Cubic};
+    const itk::InterpolateImageFunction<TestVolumeType>::Pointer referenceFunctions[] = {
+      itk::NearestNeighborInterpolateImageFunction<TestVolumeType>::New().GetPointer(),
+      itk::LinearInterpolateImageFunction<TestVolumeType>::New().GetPointer(),
+      bSplineInterpolateFunction.GetPointer()};
+    const char *names[] = {"nearest", "linear", "cubic"};
+
+    for (int i = 0; i < 3; ++i)
+    {
+      mitk::ExtractSliceFilter2::Pointer singleThreaded = mitk::ExtractSliceFilter2::New();
+      singleThreaded->SetInput(TestVolume);
+      singleThreaded->SetOutputGeometry(planeGeometry);
+      singleThreaded->SetInterpolator(interpolators[i]);
+      singleThreaded->SetNumberOfThreads(1);
+      singleThreaded->Update();
+
+      mitk::ExtractSliceFilter2::Pointer multiThreaded = mitk::ExtractSliceFilter2::New();
+      multiThreaded->SetInput(TestVolume);
+      multiThreaded->SetOutputGeometry(planeGeometry);
+      multiThreaded->SetInterpolator(interpolators[i]);
+      multiThreaded->Update();
+
+      mitk::Image::Pointer singleThreadedSlice = singleThreaded->GetOutput();
+      mitk::Image::Pointer multiThreadedSlice = multiThreaded->GetOutput();
+
+      {
+        mitk::ImageReadAccessor singleThreadedAccess(singleThreadedSlice);
+        mitk::ImageReadAccessor multiThreadedAccess(multiThreadedSlice);
+        const std::size_t size = singleThreadedSlice->GetPixelType().GetSize() * singleThreadedSlice->GetDimension(0) *
+                                 singleThreadedSlice->GetDimension(1);
+
+        MITK_TEST_CONDITION(0 == std::memcmp(singleThreadedAccess.GetData(), multiThreadedAccess.GetData(), size),
+                            testname << " (" << names[i] << "): threaded ExtractSliceFilter2 equals single-threaded");
+      }
+
+      // positions exactly between two voxels or on the border of the volume may be rounded to either side
+      referenceFunctions[i]->SetInputImage(itkVolume);
+      const std::size_t numberOfPixels =
+        static_cast<std::size_t>(singleThreadedSlice->GetDimension(0)) * singleThreadedSlice->GetDimension(1);
+      const std::size_t numberOfDifferingPixels =
+        CountPixelsDifferingFromReference(singleThreadedSlice, referenceFunctions[i]);
+
+      MITK_TEST_CONDITION(numberOfDifferingPixels <= numberOfPixels / 1000,
+                          testname << " (" << names[i] << "): ExtractSliceFilter2 equals the ITK interpolation ("
+                                   << numberOfDifferingPixels << " of " << numberOfPixels << " pixels differ)");
+    }
+  }
+
   /*
    * get the radius of the slice of a sphere based on pixel distance from edge to edge of the circle.
    */
@@ -937,6 +1047,7 @@ int mitkExtractSliceFilterTest(int /*argc*/, char * /*argv*/ [])
   delete op;
 
   mitkExtractSliceFilterTestClass::TestSlice(obliquePlane, "Testing oblique plane");
+  mitkExtractSliceFilterTestClass::TestExtractSliceFilter2(obliquePlane, "Testing oblique plane");
 /* end oblique plane */
 
 #ifdef SHOW_SLICE_IN_RENDER_WINDOW
@@ -16,9 +16,13 @@ found in the LICENSE file.
 
 #include <mitkIOUtil.h>
 #include <mitkImageGenerator.h>
+#include <mitkStandaloneDataStorage.h>
 
 #include <itksys/SystemTools.hxx>
 
+#include <atomic>
+#include <future>
+
 class mitkIOUtilTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkIOUtilTestSuite);
@@ -31,6 +35,8 @@ class mitkIOUtilTestSuite : public mitk::TestFixture
   MITK_TEST(TestLoadAndSaveSurface);
   MITK_TEST(TestTempMethodsForUniqueFilenames);
   MITK_TEST(TestTempMethodsForUniqueFilenames);
+  MITK_TEST(TestLoadConcurrently);
+  MITK_TEST(TestCancelLoadConcurrently);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -226,6 +232,71 @@ public:
     // delete the files after the test is done
     std::remove(surfacePath.c_str());
   }
+
+  void TestLoadConcurrently()
+  {
+    std::vector<std::string> paths;
+    paths.push_back(m_ImagePath);
+    paths.push_back(m_SurfacePath);
+    paths.push_back(m_PointSetPath);
+    paths.push_back(GetTestDataFilePath("BallBinary30x30x30.nrrd"));
+
+    std::atomic<unsigned int> numberOfReadFiles(0);
+    auto load = mitk::IOUtil::LoadConcurrently(
+      paths, nullptr, [&numberOfReadFiles](const mitk::IOUtil::LoadInfo &, const std::string &errorMessage) {
+        if (errorMessage.empty())
+          ++numberOfReadFiles;
+      });
+
+    mitk::StandaloneDataStorage::Pointer storage = mitk::StandaloneDataStorage::New();
+    mitk::DataStorage::SetOfObjects::Pointer nodes = mitk::DataStorage::SetOfObjects::New();
+    CPPUNIT_ASSERT_EQUAL(std::string(), load->Finish(nodes, storage));
+    CPPUNIT_ASSERT_EQUAL(4u, numberOfReadFiles.load());
+    CPPUNIT_ASSERT_EQUAL(4u, static_cast<unsigned int>(storage->GetAll()->Size()));
+
+    // the data is in the order of the paths and equals the data loaded sequentially
+    std::vector<mitk::BaseData::Pointer> expected = mitk::IOUtil::Load(paths);
+    CPPUNIT_ASSERT_EQUAL(expected.size(), static_cast<std::size_t>(nodes->Size()));
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+      mitk::BaseData *data = nodes->ElementAt(i)->GetData();
+      CPPUNIT_ASSERT_EQUAL(std::string(expected[i]->GetNameOfClass()), std::string(data->GetNameOfClass()));
+      CPPUNIT_ASSERT_EQUAL(paths[i], data->GetProperty("path")->GetValueAsString());
+      CPPUNIT_ASSERT_EQUAL(data, load->GetLoadInfos()[i].m_Output.front().GetPointer());
+    }
+
+    for (std::size_t i : { 0, 3 })
+    {
+      mitk::Image::Pointer expectedImage = dynamic_cast<mitk::Image *>(expected[i].GetPointer());
+      mitk::Image::Pointer image = dynamic_cast<mitk::Image *>(nodes->ElementAt(i)->GetData());
+      MITK_ASSERT_EQUAL(expectedImage, image, "Concurrently loaded image differs");
+    }
+  }
+
+  void TestCancelLoadConcurrently()
+  {
+    std::vector<std::string> paths;
+    paths.push_back(m_ImagePath);
+    paths.push_back(m_SurfacePath);
+    paths.push_back(m_PointSetPath);
+
+    // cancel after the first file, reading one file at a time
+    std::promise<mitk::IOUtil::ConcurrentLoad *> loadPromise;
+    std::shared_future<mitk::IOUtil::ConcurrentLoad *> loadFuture = loadPromise.get_future().share();
+    auto load = mitk::IOUtil::LoadConcurrently(
+      paths, nullptr, [loadFuture](const mitk::IOUtil::LoadInfo &, const std::string &) { loadFuture.get()->Cancel(); }, 1);
+    loadPromise.set_value(load.get());
+
+    mitk::DataStorage::SetOfObjects::Pointer nodes = mitk::DataStorage::SetOfObjects::New();
+    std::string errMsg = load->Finish(nodes, nullptr);
+
+    CPPUNIT_ASSERT(load->IsCancelled());
+    CPPUNIT_ASSERT(errMsg.find("cancelled") != std::string::npos);
+    CPPUNIT_ASSERT_EQUAL(1u, static_cast<unsigned int>(nodes->Size()));
+    CPPUNIT_ASSERT(dynamic_cast<mitk::Image *>(nodes->ElementAt(0)->GetData()) != nullptr);
+    CPPUNIT_ASSERT(load->GetLoadInfos()[1].m_Output.empty());
+    CPPUNIT_ASSERT(load->GetLoadInfos()[2].m_Output.empty());
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkIOUtil)
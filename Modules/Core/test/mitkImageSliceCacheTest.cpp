@@ -0,0 +1,159 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkExtractSliceFilter.h"
+#include "mitkImage.h"
+#include "mitkImageGenerator.h"
+#include "mitkImageSliceCache.h"
+#include "mitkPlaneGeometry.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+class mitkImageSliceCacheTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageSliceCacheTestSuite);
+  MITK_TEST(Find_EmptyCache_Misses);
+  MITK_TEST(Find_InsertedSlice_Hits);
+  MITK_TEST(Find_ModifiedImage_Misses);
+  MITK_TEST(Find_OtherPlaneOrInterpolation_Misses);
+  MITK_TEST(Insert_ExceedsMaximumSize_DropsLeastRecentlyUsed);
+  MITK_TEST(Clear_DropsAllSlices);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_Image;
+  mitk::PlaneGeometry::Pointer m_Plane;
+  mitk::PlaneGeometry::Pointer m_OtherPlane;
+  mitk::ExtractSliceFilter::Pointer m_Reslicer;
+  std::unique_ptr<mitk::ImageSliceCache> m_Cache;
+
+  mitk::PlaneGeometry::Pointer CreatePlane(mitk::ScalarType z)
+  {
+    auto plane = mitk::PlaneGeometry::New();
+    plane->InitializeStandardPlane(m_Image->GetGeometry(), mitk::PlaneGeometry::Axial, z);
+    plane->SetReferenceGeometry(m_Image->GetGeometry());
+    return plane;
+  }
+
+  mitk::ImageSliceCache::Key CreateKey(const mitk::PlaneGeometry *plane)
+  {
+    return mitk::ImageSliceCache::Key(m_Image, plane, 0, mitk::ExtractSliceFilter::RESLICE_NEAREST, false);
+  }
+
+  void Reslice(const mitk::PlaneGeometry *plane)
+  {
+    m_Reslicer->SetWorldGeometry(plane);
+    m_Reslicer->Modified();
+    m_Reslicer->UpdateLargestPossibleRegion();
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = mitk::ImageGenerator::GenerateRandomImage<short>(32, 32, 8);
+    m_Plane = this->CreatePlane(2);
+    m_OtherPlane = this->CreatePlane(5);
+
+    m_Reslicer = mitk::ExtractSliceFilter::New();
+    m_Reslicer->SetInput(m_Image);
+    m_Reslicer->SetVtkOutputRequest(true);
+    m_Reslicer->SetResliceTransformByGeometry(m_Image->GetGeometry());
+
+    m_Cache.reset(new mitk::ImageSliceCache);
+  }
+
+  void tearDown() override
+  {
+    m_Cache.reset();
+    m_Reslicer = nullptr;
+    m_Plane = nullptr;
+    m_OtherPlane = nullptr;
+    m_Image = nullptr;
+  }
+
+  void Find_EmptyCache_Misses()
+  {
+    CPPUNIT_ASSERT(m_Cache->Find(this->CreateKey(m_Plane)) == nullptr);
+    CPPUNIT_ASSERT_EQUAL(0ul, m_Cache->GetNumberOfHits());
+    CPPUNIT_ASSERT_EQUAL(1ul, m_Cache->GetNumberOfMisses());
+  }
+
+  void Find_InsertedSlice_Hits()
+  {
+    this->Reslice(m_Plane);
+    auto inserted = m_Cache->Insert(this->CreateKey(m_Plane), m_Reslicer);
+    CPPUNIT_ASSERT(inserted != nullptr);
+    CPPUNIT_ASSERT(inserted->m_Image.GetPointer() != m_Reslicer->GetVtkOutput());
+    CPPUNIT_ASSERT_EQUAL(m_Reslicer->GetOutputSpacing()[0], inserted->m_Spacing[0]);
+
+    // a key built from an equal, but distinct plane finds the slice
+    auto found = m_Cache->Find(this->CreateKey(this->CreatePlane(2)));
+    CPPUNIT_ASSERT(found == inserted);
+    CPPUNIT_ASSERT_EQUAL(1ul, m_Cache->GetNumberOfHits());
+    CPPUNIT_ASSERT_EQUAL(0ul, m_Cache->GetNumberOfMisses());
+
+    m_Cache->ResetStatistics();
+    CPPUNIT_ASSERT_EQUAL(0ul, m_Cache->GetNumberOfHits());
+  }
+
+  void Find_ModifiedImage_Misses()
+  {
+    this->Reslice(m_Plane);
+    m_Cache->Insert(this->CreateKey(m_Plane), m_Reslicer);
+
+    m_Image->Modified();
+    CPPUNIT_ASSERT(m_Cache->Find(this->CreateKey(m_Plane)) == nullptr);
+  }
+
+  void Find_OtherPlaneOrInterpolation_Misses()
+  {
+    this->Reslice(m_Plane);
+    m_Cache->Insert(this->CreateKey(m_Plane), m_Reslicer);
+
+    CPPUNIT_ASSERT(m_Cache->Find(this->CreateKey(m_OtherPlane)) == nullptr);
+    CPPUNIT_ASSERT(m_Cache->Find(mitk::ImageSliceCache::Key(
+                     m_Image, m_Plane, 0, mitk::ExtractSliceFilter::RESLICE_LINEAR, false)) == nullptr);
+    CPPUNIT_ASSERT_EQUAL(2ul, m_Cache->GetNumberOfMisses());
+  }
+
+  void Insert_ExceedsMaximumSize_DropsLeastRecentlyUsed()
+  {
+    this->Reslice(m_Plane);
+    m_Cache->Insert(this->CreateKey(m_Plane), m_Reslicer);
+    m_Cache->SetMaximumSize(m_Cache->GetSize());
+
+    this->Reslice(m_OtherPlane);
+    m_Cache->Insert(this->CreateKey(m_OtherPlane), m_Reslicer);
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), m_Cache->GetNumberOfSlices());
+    CPPUNIT_ASSERT(m_Cache->GetSize() <= m_Cache->GetMaximumSize());
+    CPPUNIT_ASSERT(m_Cache->Find(this->CreateKey(m_Plane)) == nullptr);
+    CPPUNIT_ASSERT(m_Cache->Find(this->CreateKey(m_OtherPlane)) != nullptr);
+
+    m_Cache->SetMaximumSize(0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), m_Cache->GetNumberOfSlices());
+  }
+
+  void Clear_DropsAllSlices()
+  {
+    this->Reslice(m_Plane);
+    auto slice = m_Cache->Insert(this->CreateKey(m_Plane), m_Reslicer);
+    m_Cache->Clear();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), m_Cache->GetSize());
+    CPPUNIT_ASSERT(m_Cache->Find(this->CreateKey(m_Plane)) == nullptr);
+    // slices handed out before stay valid
+    CPPUNIT_ASSERT(slice->m_Image->GetNumberOfPoints() > 0);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageSliceCache)
@@ -0,0 +1,209 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkImage.h"
+#include "mitkImageGenerator.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkImageStatisticsHolder.h"
+#include "mitkImageWriteAccessor.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <vtkImageData.h>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+class mitkImageStatisticsHolderTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageStatisticsHolderTestSuite);
+  MITK_TEST(GetScalarValues_RandomImage_MatchAllPixels);
+  MITK_TEST(GetScalarValues_ConstantImage_2ndExtremaEqualExtrema);
+  MITK_TEST(GetScalarValues_AfterWriteAccess_Updated);
+  MITK_TEST(GetScalarValues_AfterWriteAccessToTimeStep_OtherTimeStepsUnchanged);
+  MITK_TEST(GetScalarValues_AfterModifiedWithoutAccessor_Updated);
+  MITK_TEST(GetScalarValues_AfterUntrackedAndTrackedWrite_Updated);
+  MITK_TEST(GetScalarValues_AfterSetVolume_Updated);
+  MITK_TEST(GetScalarHistogram_Unmodified_Cached);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  // 256 * 256 pixels per slice, so the time steps consist of several blocks
+  mitk::Image::Pointer m_Image;
+  mitk::Image::Pointer m_Image4D;
+
+  struct Expected
+  {
+    int min;
+    int secondMin;
+    int max;
+    int secondMax;
+    unsigned int countOfMin;
+    unsigned int countOfMax;
+  };
+
+  static Expected ComputeExpected(const int *data, std::size_t size)
+  {
+    std::set<int> values(data, data + size);
+    Expected expected;
+    expected.min = *values.begin();
+    expected.secondMin = values.size() > 1 ? *std::next(values.begin()) : expected.min;
+    expected.max = *values.rbegin();
+    expected.secondMax = values.size() > 1 ? *std::next(values.rbegin()) : expected.max;
+    expected.countOfMin = static_cast<unsigned int>(std::count(data, data + size, expected.min));
+    expected.countOfMax = static_cast<unsigned int>(std::count(data, data + size, expected.max));
+    return expected;
+  }
+
+  void CheckStatistics(mitk::Image *image, int t)
+  {
+    Expected expected;
+    {
+      mitk::ImageReadAccessor readAccess(image, image->GetVolumeData(t));
+      const std::size_t size = image->GetDimension(0) * image->GetDimension(1) * image->GetDimension(2);
+      expected = ComputeExpected(static_cast<const int *>(readAccess.GetData()), size);
+    }
+
+    auto *statistics = image->GetStatistics();
+    CPPUNIT_ASSERT_EQUAL(static_cast<mitk::ScalarType>(expected.min), statistics->GetScalarValueMin(t));
+    CPPUNIT_ASSERT_EQUAL(static_cast<mitk::ScalarType>(expected.secondMin), statistics->GetScalarValue2ndMin(t));
+    CPPUNIT_ASSERT_EQUAL(static_cast<mitk::ScalarType>(expected.max), statistics->GetScalarValueMax(t));
+    CPPUNIT_ASSERT_EQUAL(static_cast<mitk::ScalarType>(expected.secondMax), statistics->GetScalarValue2ndMax(t));
+    CPPUNIT_ASSERT_EQUAL(static_cast<mitk::ScalarType>(expected.countOfMin),
+                         statistics->GetCountOfMinValuedVoxels(t));
+    CPPUNIT_ASSERT_EQUAL(static_cast<mitk::ScalarType>(expected.countOfMax),
+                         statistics->GetCountOfMaxValuedVoxels(t));
+  }
+
+  static void SetPixel(mitk::Image *image, int t, std::size_t offset, int value)
+  {
+    mitk::ImageWriteAccessor writeAccess(image, image->GetVolumeData(t));
+    static_cast<int *>(writeAccess.GetData())[offset] = value;
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = mitk::ImageGenerator::GenerateRandomImage<int>(256, 256, 20, 1, 1, 1, 1, 1000);
+    m_Image4D = mitk::ImageGenerator::GenerateRandomImage<int>(256, 256, 6, 3, 1, 1, 1, 1000);
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+    m_Image4D = nullptr;
+  }
+
+  void GetScalarValues_RandomImage_MatchAllPixels()
+  {
+    this->CheckStatistics(m_Image, 0);
+    for (int t = 0; t < 3; ++t)
+    {
+      this->CheckStatistics(m_Image4D, t);
+    }
+  }
+
+  void GetScalarValues_ConstantImage_2ndExtremaEqualExtrema()
+  {
+    // the random values of integer images are in [0, randomMax]
+    auto image = mitk::ImageGenerator::GenerateRandomImage<int>(256, 256, 20, 1, 1, 1, 1, 0);
+    auto *statistics = image->GetStatistics();
+    CPPUNIT_ASSERT_EQUAL(0.0, statistics->GetScalarValueMin());
+    CPPUNIT_ASSERT_EQUAL(0.0, statistics->GetScalarValue2ndMin());
+    CPPUNIT_ASSERT_EQUAL(0.0, statistics->GetScalarValue2ndMax());
+    CPPUNIT_ASSERT_EQUAL(256.0 * 256.0 * 20.0, statistics->GetCountOfMaxValuedVoxels());
+  }
+
+  void GetScalarValues_AfterWriteAccess_Updated()
+  {
+    this->CheckStatistics(m_Image, 0);
+
+    // new extrema in the first and in the last block, no call of Modified()
+    SetPixel(m_Image, 0, 10, -2000);
+    SetPixel(m_Image, 0, 256 * 256 * 20 - 1, 2000);
+    this->CheckStatistics(m_Image, 0);
+
+    // remove the only minimum again, the former minimum of all other blocks is the minimum again
+    SetPixel(m_Image, 0, 10, 0);
+    m_Image->Modified();
+    this->CheckStatistics(m_Image, 0);
+  }
+
+  void GetScalarValues_AfterWriteAccessToTimeStep_OtherTimeStepsUnchanged()
+  {
+    const mitk::ScalarType min0 = m_Image4D->GetStatistics()->GetScalarValueMin(0);
+    const mitk::ScalarType min2 = m_Image4D->GetStatistics()->GetScalarValueMin(2);
+
+    SetPixel(m_Image4D, 1, 256 * 256 * 3, -3000);
+    m_Image4D->Modified();
+
+    CPPUNIT_ASSERT_EQUAL(-3000.0, m_Image4D->GetStatistics()->GetScalarValueMin(1));
+    CPPUNIT_ASSERT_EQUAL(min0, m_Image4D->GetStatistics()->GetScalarValueMin(0));
+    CPPUNIT_ASSERT_EQUAL(min2, m_Image4D->GetStatistics()->GetScalarValueMin(2));
+    this->CheckStatistics(m_Image4D, 1);
+  }
+
+  void GetScalarValues_AfterModifiedWithoutAccessor_Updated()
+  {
+    this->CheckStatistics(m_Image, 0);
+
+    // writing to the vtkImageData is not tracked, the image is recomputed as a whole
+    auto *vtkImage = m_Image->GetVtkImageData();
+    static_cast<int *>(vtkImage->GetScalarPointer())[256 * 256 * 5] = 3000;
+    m_Image->Modified();
+
+    CPPUNIT_ASSERT_EQUAL(3000.0, m_Image->GetStatistics()->GetScalarValueMax());
+    this->CheckStatistics(m_Image, 0);
+  }
+
+  void GetScalarValues_AfterUntrackedAndTrackedWrite_Updated()
+  {
+    this->CheckStatistics(m_Image, 0);
+
+    // the untracked write must not be hidden by the tracked write in another block
+    auto *vtkImage = m_Image->GetVtkImageData();
+    static_cast<int *>(vtkImage->GetScalarPointer())[256 * 256 * 5] = 3000;
+    m_Image->Modified();
+    SetPixel(m_Image, 0, 256 * 256 * 19, -3000);
+    m_Image->Modified();
+
+    this->CheckStatistics(m_Image, 0);
+  }
+
+  void GetScalarValues_AfterSetVolume_Updated()
+  {
+    this->CheckStatistics(m_Image4D, 1);
+    const mitk::ScalarType min0 = m_Image4D->GetStatistics()->GetScalarValueMin(0);
+
+    std::vector<int> volume(256 * 256 * 6, 7);
+    volume[100] = -5000;
+    m_Image4D->SetVolume(volume.data(), 1);
+
+    CPPUNIT_ASSERT_EQUAL(-5000.0, m_Image4D->GetStatistics()->GetScalarValueMin(1));
+    CPPUNIT_ASSERT_EQUAL(min0, m_Image4D->GetStatistics()->GetScalarValueMin(0));
+    this->CheckStatistics(m_Image4D, 1);
+  }
+
+  void GetScalarHistogram_Unmodified_Cached()
+  {
+    auto *statistics = m_Image->GetStatistics();
+    mitk::ImageStatisticsHolder::HistogramType::ConstPointer histogram = statistics->GetScalarHistogram();
+    CPPUNIT_ASSERT(histogram.IsNotNull());
+    CPPUNIT_ASSERT(histogram == statistics->GetScalarHistogram());
+
+    m_Image->Modified();
+    CPPUNIT_ASSERT(histogram != statistics->GetScalarHistogram());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageStatisticsHolder)
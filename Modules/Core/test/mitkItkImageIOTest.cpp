@@ -17,11 +17,14 @@ found in the LICENSE file.
 
 #include "mitkIOUtil.h"
 #include "mitkITKImageImport.h"
+#include <mitkImageReadAccessor.h>
+#include <mitkItkImageIO.h>
 #include <mitkExtractSliceFilter.h>
 
 #include "itksys/SystemTools.hxx"
 #include <itkImageRegionIterator.h>
 
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
@@ -43,6 +46,8 @@ class mitkItkImageIOTestSuite : public mitk::TestFixture
   MITK_TEST(TestWrite3DImageWithTwoPlanes);
   MITK_TEST(TestWrite3DplusT_ArbitraryTG);
   MITK_TEST(TestWrite3DplusT_ProportionalTG);
+  MITK_TEST(TestDataLoadingOnAccess);
+  MITK_TEST(TestDataLoadingInBackground);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -67,6 +72,50 @@ public:
     // TODO
   }
 
+  void TestDataLoadingOnAccess() { TestDataLoading(mitk::ItkImageIO::DATA_LOADING_ON_ACCESS()); }
+
+  void TestDataLoadingInBackground() { TestDataLoading(mitk::ItkImageIO::DATA_LOADING_IN_BACKGROUND()); }
+
+  /**
+  *  test that an image whose data is read on access or in background equals the image read immediately,
+  *  both for a NRRD file and for an uncompressed NIfTI file that can be read volume by volume
+  */
+  void TestDataLoading(const std::string &dataLoading)
+  {
+    std::string nrrdFilePath = GetTestDataFilePath("3D+t-ITKIO-TestData/LinearModel_4D_prop_time_geometry.nrrd");
+    mitk::Image::Pointer reference = mitk::IOUtil::Load<mitk::Image>(nrrdFilePath);
+    CPPUNIT_ASSERT_MESSAGE("Reference image is read immediately", !reference->HasVolumeLoader());
+
+    std::ofstream tmpStream;
+    std::string niftiFilePath = mitk::IOUtil::CreateTemporaryFile(tmpStream, "XXXXXX.nii");
+    tmpStream.close();
+    mitk::IOUtil::Save(reference, niftiFilePath);
+
+    mitk::IFileReader::Options options;
+    options[mitk::ItkImageIO::OPTION_DATA_LOADING()] = dataLoading;
+
+    for (const auto &filePath : { nrrdFilePath, niftiFilePath })
+    {
+      mitk::Image::Pointer image = mitk::IOUtil::Load<mitk::Image>(filePath, options);
+      CPPUNIT_ASSERT_MESSAGE("Image data is loaded on access", image->HasVolumeLoader());
+      CPPUNIT_ASSERT_EQUAL(reference->GetDimension(3), image->GetDimension(3));
+      CPPUNIT_ASSERT_MESSAGE("Volumes to be loaded count as set", image->IsVolumeSet(image->GetDimension(3) - 1));
+
+      // access a single time step first, then the whole image
+      const unsigned int t = image->GetDimension(3) - 1;
+      mitk::ImageReadAccessor referenceVolume(reference, reference->GetVolumeData(t));
+      mitk::ImageReadAccessor volume(image, image->GetVolumeData(t));
+      const std::size_t volumeSize = reference->GetPixelType().GetSize() * reference->GetDimension(0) *
+                                     reference->GetDimension(1) * reference->GetDimension(2);
+      CPPUNIT_ASSERT_MESSAGE("Last time step equals the reference",
+                             0 == std::memcmp(referenceVolume.GetData(), volume.GetData(), volumeSize));
+
+      MITK_ASSERT_EQUAL(reference, image, "Image loaded with option \"" + dataLoading + "\" equals the reference");
+    }
+
+    std::remove(niftiFilePath.c_str());
+  }
+
   std::string AppendExtension(const std::string &filename, const char *extension)
   {
     std::string new_filename = filename;
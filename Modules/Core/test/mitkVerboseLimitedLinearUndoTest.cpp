@@ -32,6 +32,20 @@ namespace mitk
     TestOperation(OperationType operationType) : Operation(operationType) { g_GlobalCounter++; };
     ~TestOperation() override { g_GlobalCounter--; };
   };
+
+  /**
+  * @brief Operation reporting a fixed memory usage, to check the memory limit of the undo model
+  **/
+  class SizedTestOperation : public TestOperation
+  {
+  public:
+    SizedTestOperation(OperationType operationType, std::size_t size) : TestOperation(operationType), m_Size(size) {};
+    std::size_t GetMemoryUsage() const override { return m_Size; };
+    void SetSize(std::size_t size) { m_Size = size; };
+
+  private:
+    std::size_t m_Size;
+  };
 } // namespace
 
 /**
@@ -126,6 +140,40 @@ int mitkVerboseLimitedLinearUndoTest(int /* argc */, char * /*argv*/ [])
   // static singleton
   MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 4, "checking singleton UndoModel");
 
+  // a memory limit drops the oldest items, but keeps the newest one
+  g_GlobalCounter = 0;
+  mitk::LimitedLinearUndo::Pointer memoryLimitedModel = mitk::LimitedLinearUndo::New();
+  memoryLimitedModel->SetMemoryLimit(1000);
+  for (int i = 0; i < 3; i++)
+  {
+    auto doOp = new mitk::SizedTestOperation(mitk::OpTEST, 200);
+    auto undoOp = new mitk::SizedTestOperation(mitk::OpTEST, 200);
+    memoryLimitedModel->SetOperationEvent(new mitk::OperationEvent(nullptr, doOp, undoOp, "Test"));
+    mitk::OperationEvent::IncCurrObjectEventId();
+  }
+  MITK_TEST_CONDITION_REQUIRED(memoryLimitedModel->GetMemoryUsage() == 800, "checking memory usage within limit");
+  MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 4, "checking that the oldest operations were dropped");
+
+  memoryLimitedModel->Undo();
+  MITK_TEST_CONDITION_REQUIRED(memoryLimitedModel->GetMemoryUsage() == 800, "checking memory usage including redo list");
+
+  memoryLimitedModel->SetOperationEvent(new mitk::OperationEvent(nullptr,
+    new mitk::SizedTestOperation(mitk::OpTEST, 1000), new mitk::SizedTestOperation(mitk::OpTEST, 1000), "Test"));
+  MITK_TEST_CONDITION_REQUIRED(memoryLimitedModel->GetMemoryUsage() == 2000, "checking that the newest item is kept");
+  MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 2, "checking that redo list and older items were dropped");
+
+  memoryLimitedModel->Clear();
+  MITK_TEST_CONDITION_REQUIRED(memoryLimitedModel->GetMemoryUsage() == 0, "checking memory usage of empty model");
+  MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 0, "checking deleting all operations");
+
+  // operations growing after they were pushed release only the memory they were charged with
+  auto growingOp = new mitk::SizedTestOperation(mitk::OpTEST, 200);
+  memoryLimitedModel->SetOperationEvent(
+    new mitk::OperationEvent(nullptr, growingOp, new mitk::SizedTestOperation(mitk::OpTEST, 200), "Test"));
+  growingOp->SetSize(5000);
+  memoryLimitedModel->Clear();
+  MITK_TEST_CONDITION_REQUIRED(memoryLimitedModel->GetMemoryUsage() == 0, "checking memory usage after an operation grew");
+
   // always end with this!
   MITK_TEST_END()
   // operations will be deleted after terminating the application
@@ -17,6 +17,7 @@ found in the LICENSE file.
 
 #include <set>
 #include <memory>
+#include <vector>
 
 #include <gdcmScanner.h>
 
@@ -43,6 +44,13 @@ namespace mitk
 
       void InitCache(const std::set<DICOMTag>& scannedTags, const std::shared_ptr<gdcm::Scanner>& scanner, const StringList& inputFiles);
 
+      /**
+        \brief Initialize the cache from several scanners that each scanned a part of inputFiles.
+        Used by DICOMGDCMTagScanner when scanning with multiple threads. The order of the
+        frame info list follows inputFiles, not the order of the scanners.
+      */
+      void InitCache(const std::set<DICOMTag>& scannedTags, const std::vector<std::shared_ptr<gdcm::Scanner>>& scanners, const StringList& inputFiles);
+
       const gdcm::Scanner& GetScanner() const;
 
   protected:
@@ -53,6 +61,7 @@ namespace mitk
       std::set<DICOMTag> m_ScannedTags;
 
       std::shared_ptr<gdcm::Scanner> m_Scanner;
+      std::vector<std::shared_ptr<gdcm::Scanner>> m_Scanners;
 
       DICOMDatasetAccessingImageFrameList m_ScanResult;
 
@@ -101,6 +101,25 @@ namespace mitk
       */
       virtual DICOMDatasetFinding GetTagValue(DICOMImageFrameInfo* frame, const DICOMTag& tag) const;
 
+      /**
+        \brief Number of threads used by Scan().
+        With more than one thread, the input files are split into contiguous
+        chunks that are scanned concurrently by separate gdcm::Scanner instances.
+        A value of 0 uses itk::MultiThreader::GetGlobalDefaultNumberOfThreads().
+        Default is 1 (sequential scan).
+      */
+      itkSetMacro(NumberOfThreads, unsigned int);
+      itkGetConstMacro(NumberOfThreads, unsigned int);
+
+      /**
+        \brief Persistent tag index used by Scan().
+        If set, Scan() creates a DICOMPersistentTagCache that only scans files
+        which are not up-to-date in the index file. The default is taken from the
+        environment variable MITK_DICOM_TAG_INDEX, an empty name disables the index.
+      */
+      itkSetStringMacro(IndexFileName);
+      itkGetStringMacro(IndexFileName);
+
     protected:
 
       DICOMGDCMTagScanner();
@@ -110,6 +129,8 @@ namespace mitk
       StringList m_InputFilenames;
       DICOMGDCMTagCache::Pointer m_Cache;
       std::shared_ptr<gdcm::Scanner> m_GDCMScanner;
+      unsigned int m_NumberOfThreads;
+      std::string m_IndexFileName;
 
     private:
       DICOMGDCMTagScanner(const DICOMGDCMTagScanner&);
@@ -259,6 +259,17 @@ class MITKDICOMREADER_EXPORT DICOMITKSeriesGDCMReader : public DICOMFileReader
       return m_SimpleVolumeReading;
     };
 
+    /**
+      \brief Number of threads used for tag scanning and slice decoding.
+      With more than one thread, DICOMGDCMTagScanner scans chunks of the input files
+      concurrently and ITKDICOMSeriesReaderHelper decodes slices concurrently into
+      the pre-allocated output image.
+      A value of 0 uses itk::MultiThreader::GetGlobalDefaultNumberOfThreads().
+      Default is 1, i.e. the sequential loading of earlier versions.
+    */
+    void SetNumberOfThreads(unsigned int numberOfThreads);
+    unsigned int GetNumberOfThreads() const;
+
     double GetToleratedOriginError() const;
     bool IsToleratedOriginOffsetAbsolute() const;
 
@@ -345,6 +356,8 @@ class MITKDICOMREADER_EXPORT DICOMITKSeriesGDCMReader : public DICOMFileReader
 
     bool m_SimpleVolumeReading;
 
+    unsigned int m_NumberOfThreads;
+
   private:
 
     SortingBlockList m_SortingResultInProgress;
@@ -0,0 +1,93 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkDICOMPersistentTagCache_h
+#define mitkDICOMPersistentTagCache_h
+
+#include "mitkDICOMGDCMTagCache.h"
+
+namespace boost
+{
+  namespace interprocess
+  {
+    class mapped_region;
+  }
+}
+
+namespace mitk
+{
+
+  /**
+    \ingroup DICOMReaderModule
+    \brief Tag cache that keeps scan results in a persistent, memory-mapped index file.
+
+    The index file holds one entry per scanned file, keyed by the file path, its size
+    and its modification time. InitCache() answers unchanged files from the index and
+    passes only new or modified files (or files that lack some of the requested tags
+    in the index) to a DICOMGDCMTagScanner. The updated index is written back to disk
+    and memory-mapped again, tag values of all frames point directly into the mapping.
+
+    Entries are never removed from the index; the tags stored for a file grow with
+    the tags requested over time. The index file is replaced atomically, concurrent
+    updates by multiple processes are not coordinated (the last writer wins).
+
+    If the index cannot be read, it is ignored and rebuilt. If it cannot be written,
+    the scan results are used without being persisted.
+
+    DICOMGDCMTagScanner uses this cache if an index file name is set (see
+    DICOMGDCMTagScanner::SetIndexFileName()).
+  */
+  class MITKDICOMREADER_EXPORT DICOMPersistentTagCache : public DICOMGDCMTagCache
+  {
+    public:
+
+      mitkClassMacro(DICOMPersistentTagCache, DICOMGDCMTagCache);
+      itkFactorylessNewMacro( DICOMPersistentTagCache );
+
+      /** \brief Location of the index file. Must be set before calling InitCache(). */
+      itkSetStringMacro(IndexFileName);
+      itkGetStringMacro(IndexFileName);
+
+      /**
+        \brief Fill the cache for the given files and tags, scanning only files that are not up-to-date in the index.
+        \param numberOfThreads passed on to DICOMGDCMTagScanner::SetNumberOfThreads() for the files that need scanning
+      */
+      void InitCache(const std::set<DICOMTag>& scannedTags, const StringList& inputFiles, unsigned int numberOfThreads = 1);
+
+      /** \brief Number of input files answered from the index by the last call to InitCache(). */
+      itkGetConstMacro(NumberOfReusedFiles, unsigned int);
+
+      /** \brief Number of input files scanned by the last call to InitCache(). */
+      itkGetConstMacro(NumberOfScannedFiles, unsigned int);
+
+    protected:
+
+      DICOMPersistentTagCache();
+      ~DICOMPersistentTagCache() override;
+
+      std::string m_IndexFileName;
+
+      /** Mapped index file that all frame infos point into. */
+      std::shared_ptr<boost::interprocess::mapped_region> m_IndexMapping;
+
+      /** Keeps the scan results alive if they could not be persisted. */
+      DICOMTagCache::Pointer m_ScanCache;
+
+      unsigned int m_NumberOfReusedFiles;
+      unsigned int m_NumberOfScannedFiles;
+
+    private:
+      DICOMPersistentTagCache(const DICOMPersistentTagCache&);
+  };
+}
+
+#endif
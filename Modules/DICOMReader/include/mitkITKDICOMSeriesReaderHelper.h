@@ -36,6 +36,19 @@ class ITKDICOMSeriesReaderHelper
     typedef std::vector<std::string> StringContainer;
     typedef std::list<StringContainer> StringContainerList;
 
+    ITKDICOMSeriesReaderHelper();
+
+    /**
+      \brief Number of threads used to decode the slices of a series.
+      With more than one thread, slices are decoded concurrently by separate
+      itk::GDCMImageIO instances and written directly into the pre-allocated
+      output image. Series that cannot be loaded this way (e.g. slices with
+      differing pixel types) are loaded by itk::ImageSeriesReader as before.
+      A value of 0 uses itk::MultiThreader::GetGlobalDefaultNumberOfThreads().
+    */
+    void SetNumberOfThreads(unsigned int numberOfThreads);
+    unsigned int GetNumberOfThreads() const;
+
     Image::Pointer Load( const StringContainer& filenames, bool correctTilt, const GantryTiltInformation& tiltInfo );
     Image::Pointer Load3DnT( const StringContainerList& filenamesLists, bool correctTilt, const GantryTiltInformation& tiltInfo );
 
@@ -43,6 +56,24 @@ class ITKDICOMSeriesReaderHelper
 
   private:
 
+    /** A slice that has to be decoded from file Filename into the memory at Destination. */
+    struct SliceReadJob
+    {
+      std::string Filename;
+      void* Destination;
+    };
+    typedef std::vector<SliceReadJob> SliceReadJobList;
+
+    /** Decodes all jobs concurrently. Every file has to provide a single frame of
+     sliceSizeInBytes bytes that has the component type and number of components of
+     referenceIO. Throws mitk::Exception otherwise. */
+    static void ReadSlicesConcurrently( const SliceReadJobList& jobs,
+                                        const itk::ImageIOBase* referenceIO,
+                                        std::size_t sliceSizeInBytes,
+                                        unsigned int numberOfThreads );
+
+    unsigned int GetEffectiveNumberOfThreads( std::size_t numberOfSlices ) const;
+
     typedef std::vector<TimeBounds> TimeBoundsList;
     typedef itk::FixedArray<OFDateTime,2>  DateTimeBounds;
 
@@ -97,7 +128,21 @@ class ITKDICOMSeriesReaderHelper
                         const GantryTiltInformation& tiltInfo,
                         itk::GDCMImageIO::Pointer& io);
 
+    template <typename PixelType>
+    Image::Pointer
+    LoadDICOMByITKConcurrently( const StringContainer& filenames,
+                                bool correctTilt,
+                                const GantryTiltInformation& tiltInfo,
+                                itk::GDCMImageIO::Pointer& io);
+
+    template <typename PixelType>
+    Image::Pointer
+    LoadDICOMByITK3DnTConcurrently( const StringContainerList& filenames,
+                                    bool correctTilt,
+                                    const GantryTiltInformation& tiltInfo,
+                                    itk::GDCMImageIO::Pointer& io);
 
+    unsigned int m_NumberOfThreads;
 };
 
 }
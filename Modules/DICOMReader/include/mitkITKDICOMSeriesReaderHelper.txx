@@ -18,6 +18,10 @@ found in the LICENSE file.
 //#include <itkLinearInterpolateImageFunction.h>
 //#include <itkTimeProbesCollectorBase.h>
 
+#include "mitkImageWriteAccessor.h"
+
+#include <memory>
+
 #include "dcmtk/ofstd/ofdatime.h"
 
 template <typename PixelType>
@@ -29,6 +33,18 @@ mitk::ITKDICOMSeriesReaderHelper
     const GantryTiltInformation& tiltInfo,
     itk::GDCMImageIO::Pointer& io)
 {
+  if (this->GetEffectiveNumberOfThreads(filenames.size()) > 1)
+  {
+    try
+    {
+      return LoadDICOMByITKConcurrently<PixelType>(filenames, correctTilt, tiltInfo, io);
+    }
+    catch (const mitk::Exception& e)
+    {
+      MITK_DEBUG << "Concurrent loading not possible, using itk::ImageSeriesReader: " << e.GetDescription();
+    }
+  }
+
   /******** Normal Case, 3D (also for GDCM < 2 usable) ***************/
   mitk::Image::Pointer image = mitk::Image::New();
 
@@ -89,6 +105,24 @@ mitk::ITKDICOMSeriesReaderHelper
     const GantryTiltInformation& tiltInfo,
     itk::GDCMImageIO::Pointer& io)
 {
+  std::size_t numberOfSlices = 0;
+  for (const auto& filenamesOfTimeStep : filenamesForTimeSteps)
+  {
+    numberOfSlices += filenamesOfTimeStep.size();
+  }
+
+  if (this->GetEffectiveNumberOfThreads(numberOfSlices) > 1)
+  {
+    try
+    {
+      return LoadDICOMByITK3DnTConcurrently<PixelType>(filenamesForTimeSteps, correctTilt, tiltInfo, io);
+    }
+    catch (const mitk::Exception& e)
+    {
+      MITK_DEBUG << "Concurrent loading not possible, using itk::ImageSeriesReader: " << e.GetDescription();
+    }
+  }
+
   unsigned int numberOfTimeSteps = filenamesForTimeSteps.size();
 
   MITK_DEBUG << "Start extracting time bounds of time steps";
@@ -173,6 +207,200 @@ mitk::ITKDICOMSeriesReaderHelper
 }
 
 
+template <typename PixelType>
+mitk::Image::Pointer
+mitk::ITKDICOMSeriesReaderHelper
+::LoadDICOMByITKConcurrently(
+    const StringContainer& filenames,
+    bool correctTilt,
+    const GantryTiltInformation& tiltInfo,
+    itk::GDCMImageIO::Pointer& io)
+{
+  typedef itk::Image<PixelType, 3> ImageType;
+  typedef itk::ImageSeriesReader<ImageType> ReaderType;
+
+  // geometry is determined by itk::ImageSeriesReader exactly as in LoadDICOMByITK,
+  // only the pixel data is decoded slice-wise by multiple threads
+  io = itk::GDCMImageIO::New();
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO(io);
+  reader->ReverseOrderOff(); // see LoadDICOMByITK
+  reader->SetFileNames(filenames);
+  reader->UpdateOutputInformation();
+
+  itk::GDCMImageIO::Pointer referenceIO = itk::GDCMImageIO::New();
+  referenceIO->SetFileName(filenames.front());
+  referenceIO->ReadImageInformation();
+
+  const ImageType* outputInformation = reader->GetOutput();
+  const typename ImageType::SizeType size = outputInformation->GetLargestPossibleRegion().GetSize();
+  const std::size_t sliceSizeInBytes = size[0] * size[1] * sizeof(PixelType);
+
+  if (size[2] != filenames.size()
+      || referenceIO->GetComponentSize() * referenceIO->GetNumberOfComponents() != sizeof(PixelType))
+  {
+    mitkThrow() << "Series does not consist of one single-frame file per slice.";
+  }
+
+  mitk::Image::Pointer image = mitk::Image::New();
+  SliceReadJobList jobs;
+  jobs.reserve(filenames.size());
+
+  if (correctTilt)
+  {
+    typename ImageType::Pointer readVolume = ImageType::New();
+    readVolume->CopyInformation(outputInformation);
+    readVolume->SetRegions(outputInformation->GetLargestPossibleRegion());
+    readVolume->Allocate();
+
+    auto* destination = reinterpret_cast<char*>(readVolume->GetBufferPointer());
+    for (const auto& filename : filenames)
+    {
+      jobs.push_back({ filename, destination });
+      destination += sliceSizeInBytes;
+    }
+    ReadSlicesConcurrently(jobs, referenceIO, sliceSizeInBytes, this->GetEffectiveNumberOfThreads(jobs.size()));
+
+    readVolume = FixUpTiltedGeometry(readVolume.GetPointer(), tiltInfo);
+    image->InitializeByItk(readVolume.GetPointer());
+    image->SetImportVolume(readVolume->GetBufferPointer());
+  }
+  else
+  {
+    // without tilt correction, slices are decoded straight into the mitk::Image
+    image->InitializeByItk(outputInformation);
+    mitk::ImageWriteAccessor accessor(image, image->GetVolumeData(0));
+
+    auto* destination = static_cast<char*>(accessor.GetData());
+    for (const auto& filename : filenames)
+    {
+      jobs.push_back({ filename, destination });
+      destination += sliceSizeInBytes;
+    }
+    ReadSlicesConcurrently(jobs, referenceIO, sliceSizeInBytes, this->GetEffectiveNumberOfThreads(jobs.size()));
+  }
+
+  return image;
+}
+
+template <typename PixelType>
+mitk::Image::Pointer
+mitk::ITKDICOMSeriesReaderHelper
+::LoadDICOMByITK3DnTConcurrently(
+    const StringContainerList& filenamesForTimeSteps,
+    bool correctTilt,
+    const GantryTiltInformation& tiltInfo,
+    itk::GDCMImageIO::Pointer& io)
+{
+  unsigned int numberOfTimeSteps = filenamesForTimeSteps.size();
+
+  const TimeBoundsList timeBoundsList = ExtractTimeBoundsOfTimeSteps(filenamesForTimeSteps);
+  if (numberOfTimeSteps!=timeBoundsList.size())
+  {
+    mitkThrow() << "Error while loading 3D+t. Inconsistent size of generated time bounds list. List size: "<< timeBoundsList.size() << "; number of steps: "<<numberOfTimeSteps;
+  }
+
+  typedef itk::Image<PixelType, 4> ImageType;
+  typedef itk::ImageSeriesReader<ImageType> ReaderType;
+
+  const StringContainer& firstTimeStep = filenamesForTimeSteps.front();
+
+  io = itk::GDCMImageIO::New();
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO(io);
+  reader->ReverseOrderOff(); // see LoadDICOMByITK3DnT
+  reader->SetFileNames(firstTimeStep);
+  reader->UpdateOutputInformation();
+
+  itk::GDCMImageIO::Pointer referenceIO = itk::GDCMImageIO::New();
+  referenceIO->SetFileName(firstTimeStep.front());
+  referenceIO->ReadImageInformation();
+
+  const ImageType* outputInformation = reader->GetOutput();
+  const typename ImageType::SizeType size = outputInformation->GetLargestPossibleRegion().GetSize();
+  const std::size_t sliceSizeInBytes = size[0] * size[1] * sizeof(PixelType);
+
+  if (size[2] != firstTimeStep.size() || size[3] != 1
+      || referenceIO->GetComponentSize() * referenceIO->GetNumberOfComponents() != sizeof(PixelType))
+  {
+    mitkThrow() << "Series does not consist of one single-frame file per slice.";
+  }
+
+  for (const auto& filenamesOfTimeStep : filenamesForTimeSteps)
+  {
+    if (filenamesOfTimeStep.size() != firstTimeStep.size())
+    {
+      mitkThrow() << "Time steps of 3D+t series differ in their number of slices.";
+    }
+  }
+
+  mitk::Image::Pointer image = mitk::Image::New();
+
+  if (correctTilt)
+  {
+    // tilt correction resamples each volume, so the time steps are decoded into
+    // intermediate ITK volumes (each using all threads) and corrected one by one
+    unsigned int currentTimeStep = 0;
+    for (auto timestepsIter = filenamesForTimeSteps.cbegin();
+         timestepsIter != filenamesForTimeSteps.cend();
+         ++currentTimeStep, ++timestepsIter)
+    {
+      typename ImageType::Pointer readVolume = ImageType::New();
+      readVolume->CopyInformation(outputInformation);
+      readVolume->SetRegions(outputInformation->GetLargestPossibleRegion());
+      readVolume->Allocate();
+
+      SliceReadJobList jobs;
+      jobs.reserve(timestepsIter->size());
+      auto* destination = reinterpret_cast<char*>(readVolume->GetBufferPointer());
+      for (const auto& filename : *timestepsIter)
+      {
+        jobs.push_back({ filename, destination });
+        destination += sliceSizeInBytes;
+      }
+      ReadSlicesConcurrently(jobs, referenceIO, sliceSizeInBytes, this->GetEffectiveNumberOfThreads(jobs.size()));
+
+      readVolume = FixUpTiltedGeometry(readVolume.GetPointer(), tiltInfo);
+
+      if (currentTimeStep == 0)
+      {
+        image->InitializeByItk(readVolume.GetPointer(), 1, numberOfTimeSteps);
+      }
+      image->SetImportVolume(readVolume->GetBufferPointer(), currentTimeStep);
+    }
+  }
+  else
+  {
+    // all slices of all time steps are decoded in one go, straight into the mitk::Image
+    image->InitializeByItk(outputInformation, 1, numberOfTimeSteps);
+
+    std::vector<std::unique_ptr<mitk::ImageWriteAccessor>> accessors;
+    SliceReadJobList jobs;
+    jobs.reserve(numberOfTimeSteps * firstTimeStep.size());
+
+    unsigned int currentTimeStep = 0;
+    for (auto timestepsIter = filenamesForTimeSteps.cbegin();
+         timestepsIter != filenamesForTimeSteps.cend();
+         ++currentTimeStep, ++timestepsIter)
+    {
+      accessors.emplace_back(new mitk::ImageWriteAccessor(image, image->GetVolumeData(currentTimeStep)));
+
+      auto* destination = static_cast<char*>(accessors.back()->GetData());
+      for (const auto& filename : *timestepsIter)
+      {
+        jobs.push_back({ filename, destination });
+        destination += sliceSizeInBytes;
+      }
+    }
+    ReadSlicesConcurrently(jobs, referenceIO, sliceSizeInBytes, this->GetEffectiveNumberOfThreads(jobs.size()));
+  }
+
+  //construct timegeometry
+  TimeGeometry::Pointer timeGeometry = GenerateTimeGeometry(image->GetGeometry(),timeBoundsList);
+  image->SetTimeGeometry(timeGeometry);
+  return image;
+}
+
 template <typename ImageType>
 typename ImageType::Pointer
 mitk::ITKDICOMSeriesReaderHelper
@@ -14,6 +14,8 @@ found in the LICENSE file.
 #include "mitkDICOMEnums.h"
 #include "mitkDICOMGDCMImageFrameInfo.h"
 
+#include <algorithm>
+
 mitk::DICOMGDCMTagCache::DICOMGDCMTagCache()
 {
 }
@@ -83,17 +85,42 @@ mitk::DICOMDatasetAccessingImageFrameList mitk::DICOMGDCMTagCache::GetFrameInfoL
 void
 mitk::DICOMGDCMTagCache::InitCache(const std::set<DICOMTag>& scannedTags, const std::shared_ptr<gdcm::Scanner>& scanner, const StringList& inputFiles)
 {
+  this->InitCache(scannedTags, std::vector<std::shared_ptr<gdcm::Scanner>>(1, scanner), inputFiles);
+}
+
+void
+mitk::DICOMGDCMTagCache::InitCache(const std::set<DICOMTag>& scannedTags, const std::vector<std::shared_ptr<gdcm::Scanner>>& scanners, const StringList& inputFiles)
+{
+  if (scanners.empty())
+  {
+    mitkThrow() << "Invalid call to DICOMGDCMTagCache::InitCache(). At least one scanner is required.";
+  }
+
   m_ScannedTags = scannedTags;
   m_InputFilenames = inputFiles;
-  m_Scanner = scanner;
+  m_Scanners = scanners;
+  m_Scanner = scanners.front();
 
   m_ScanResult.clear();
   m_ScanResult.reserve(m_InputFilenames.size());
 
+  // scanners hold contiguous chunks of the input files, so the scanner of
+  // the previous file is the best guess for the next one
+  auto scannerIter = m_Scanners.cbegin();
   for (auto inputIter = m_InputFilenames.cbegin(); inputIter != m_InputFilenames.cend(); ++inputIter)
   {
+    if (m_Scanners.size() > 1 && !(*scannerIter)->IsKey(inputIter->c_str()))
+    {
+      scannerIter = std::find_if(m_Scanners.cbegin(), m_Scanners.cend(),
+        [inputIter](const std::shared_ptr<gdcm::Scanner>& scanner) { return scanner->IsKey(inputIter->c_str()); });
+      if (scannerIter == m_Scanners.cend())
+      {
+        scannerIter = m_Scanners.cbegin(); // unreadable file, GetMapping() provides an empty mapping
+      }
+    }
+
     m_ScanResult.push_back(DICOMGDCMImageFrameInfo::New(DICOMImageFrameInfo::New(*inputIter, 0),
-      m_Scanner->GetMapping(inputIter->c_str())).GetPointer());
+      (*scannerIter)->GetMapping(inputIter->c_str())).GetPointer());
   }
 }
 
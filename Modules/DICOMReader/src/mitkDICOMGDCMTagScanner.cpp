@@ -13,12 +13,22 @@ found in the LICENSE file.
 #include "mitkDICOMGDCMTagScanner.h"
 #include "mitkDICOMGDCMTagCache.h"
 #include "mitkDICOMGDCMImageFrameInfo.h"
+#include "mitkDICOMPersistentTagCache.h"
 
 #include <gdcmScanner.h>
 
+#include <itkMultiThreader.h>
+#include <itksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
 mitk::DICOMGDCMTagScanner::DICOMGDCMTagScanner()
+  : m_NumberOfThreads(1)
 {
   m_GDCMScanner = std::make_shared<gdcm::Scanner>();
+  itksys::SystemTools::GetEnv("MITK_DICOM_TAG_INDEX", m_IndexFileName);
 }
 
 mitk::DICOMGDCMTagScanner::~DICOMGDCMTagScanner()
@@ -92,11 +102,90 @@ void mitk::DICOMGDCMTagScanner::SetInputFiles( const StringList& filenames )
 
 void mitk::DICOMGDCMTagScanner::Scan()
 {
-  // TODO integrate push/pop locale??
-  m_GDCMScanner->Scan( m_InputFilenames );
+  if (!m_IndexFileName.empty())
+  {
+    DICOMPersistentTagCache::Pointer persistentCache = DICOMPersistentTagCache::New();
+    persistentCache->SetIndexFileName(m_IndexFileName);
+    persistentCache->InitCache(m_ScannedTags, m_InputFilenames, m_NumberOfThreads);
+    m_Cache = persistentCache.GetPointer();
+    return;
+  }
+
+  unsigned int numberOfThreads = m_NumberOfThreads;
+  if (numberOfThreads == 0)
+  {
+    numberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  }
+
+  // a chunk should at least hold a few files, otherwise thread creation dominates
+  const std::size_t minimumFilesPerChunk = 16;
+  numberOfThreads = static_cast<unsigned int>(
+    std::min<std::size_t>(numberOfThreads, m_InputFilenames.size() / minimumFilesPerChunk));
 
   DICOMGDCMTagCache::Pointer newCache = DICOMGDCMTagCache::New();
-  newCache->InitCache(m_ScannedTags, m_GDCMScanner, m_InputFilenames);
+
+  if (numberOfThreads < 2)
+  {
+    // TODO integrate push/pop locale??
+    m_GDCMScanner->Scan( m_InputFilenames );
+    newCache->InitCache(m_ScannedTags, m_GDCMScanner, m_InputFilenames);
+  }
+  else
+  {
+    // gdcm::Scanner instances are not shared between threads, each one
+    // scans a contiguous chunk of the input files
+    std::vector<std::shared_ptr<gdcm::Scanner>> scanners;
+    std::vector<StringList> chunks;
+    const std::size_t filesPerChunk = (m_InputFilenames.size() + numberOfThreads - 1) / numberOfThreads;
+
+    for (auto chunkStart = m_InputFilenames.cbegin(); chunkStart != m_InputFilenames.cend();)
+    {
+      auto chunkEnd = chunkStart + std::min<std::size_t>(filesPerChunk, std::distance(chunkStart, m_InputFilenames.cend()));
+      chunks.emplace_back(chunkStart, chunkEnd);
+      chunkStart = chunkEnd;
+
+      auto scanner = std::make_shared<gdcm::Scanner>();
+      for (const auto& tag : m_ScannedTags)
+      {
+        scanner->AddTag(gdcm::Tag(tag.GetGroup(), tag.GetElement()));
+      }
+      scanners.push_back(scanner);
+    }
+
+    std::vector<std::exception_ptr> errors(scanners.size());
+    std::vector<std::thread> threads;
+    threads.reserve(scanners.size());
+
+    for (std::size_t i = 0; i < scanners.size(); ++i)
+    {
+      threads.emplace_back([&scanners, &chunks, &errors, i]()
+      {
+        try
+        {
+          scanners[i]->Scan(chunks[i]);
+        }
+        catch (...)
+        {
+          errors[i] = std::current_exception();
+        }
+      });
+    }
+
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    for (const auto& error : errors)
+    {
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
+
+    newCache->InitCache(m_ScannedTags, scanners, m_InputFilenames);
+  }
 
   m_Cache = newCache;
 }
@@ -28,6 +28,7 @@ mitk::DICOMITKSeriesGDCMReader::DICOMITKSeriesGDCMReader( unsigned int decimalPl
 : DICOMFileReader()
 , m_FixTiltByShearing(m_DefaultFixTiltByShearing)
 , m_SimpleVolumeReading( simpleVolumeImport )
+, m_NumberOfThreads( 1 )
 , m_DecimalPlacesForOrientation( decimalPlacesForOrientation )
 , m_ExternalCache(false)
 {
@@ -38,6 +39,8 @@ mitk::DICOMITKSeriesGDCMReader::DICOMITKSeriesGDCMReader( unsigned int decimalPl
 mitk::DICOMITKSeriesGDCMReader::DICOMITKSeriesGDCMReader( const DICOMITKSeriesGDCMReader& other )
 : DICOMFileReader( other )
 , m_FixTiltByShearing( other.m_FixTiltByShearing)
+, m_SimpleVolumeReading( other.m_SimpleVolumeReading )
+, m_NumberOfThreads( other.m_NumberOfThreads )
 , m_SortingResultInProgress( other.m_SortingResultInProgress )
 , m_Sorter( other.m_Sorter )
 , m_EquiDistantBlocksSorter( other.m_EquiDistantBlocksSorter->Clone() )
@@ -61,6 +64,8 @@ mitk::DICOMITKSeriesGDCMReader& mitk::DICOMITKSeriesGDCMReader::
   {
     DICOMFileReader::operator                =( other );
     this->m_FixTiltByShearing                = other.m_FixTiltByShearing;
+    this->m_SimpleVolumeReading              = other.m_SimpleVolumeReading;
+    this->m_NumberOfThreads                  = other.m_NumberOfThreads;
     this->m_SortingResultInProgress          = other.m_SortingResultInProgress;
     this->m_Sorter                           = other.m_Sorter; // TODO should clone the list items
     this->m_EquiDistantBlocksSorter          = other.m_EquiDistantBlocksSorter->Clone();
@@ -119,6 +124,17 @@ bool mitk::DICOMITKSeriesGDCMReader::GetFixTiltByShearing() const
   return m_FixTiltByShearing;
 }
 
+void mitk::DICOMITKSeriesGDCMReader::SetNumberOfThreads( unsigned int numberOfThreads )
+{
+  this->Modified();
+  m_NumberOfThreads = numberOfThreads;
+}
+
+unsigned int mitk::DICOMITKSeriesGDCMReader::GetNumberOfThreads() const
+{
+  return m_NumberOfThreads;
+}
+
 void mitk::DICOMITKSeriesGDCMReader::SetAcceptTwoSlicesGroups( bool accept ) const
 {
   this->Modified();
@@ -237,6 +253,7 @@ void mitk::DICOMITKSeriesGDCMReader::AnalyzeInputFiles()
 
     filescanner->SetInputFiles( inputFilenames );
     filescanner->AddTagPaths( this->GetTagsOfInterest() );
+    filescanner->SetNumberOfThreads( m_NumberOfThreads );
 
     PushLocale();
     filescanner->Scan();
@@ -447,6 +464,7 @@ bool mitk::DICOMITKSeriesGDCMReader::LoadMitkImageForImageBlockDescriptor(
   }
 
   mitk::ITKDICOMSeriesReaderHelper helper;
+  helper.SetNumberOfThreads( m_NumberOfThreads );
   bool success( true );
   try
   {
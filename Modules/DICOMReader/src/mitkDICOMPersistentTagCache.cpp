@@ -0,0 +1,465 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkDICOMPersistentTagCache.h"
+#include "mitkDICOMGDCMTagScanner.h"
+#include "mitkDICOMGDCMImageFrameInfo.h"
+
+#include <mitkUIDGenerator.h>
+
+#include <itksys/SystemTools.hxx>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace
+{
+  /*
+    Index file layout (native byte order, checked via ByteOrderMark):
+
+    header:  char[8] magic, uint32 version, uint32 byte order mark, uint32 number of entries
+    entry:   uint32 path length, char[] path, '\0',
+             uint64 file size, int64 modification time, uint32 number of tags,
+             per tag: uint16 group, uint16 element, uint32 value length (ValueAbsent if
+                      the tag was scanned but not found), char[] value, '\0'
+  */
+  const char IndexMagic[8] = { 'M', 'I', 'T', 'K', 'D', 'T', 'I', 'X' };
+  const uint32_t IndexVersion = 1;
+  const uint32_t ByteOrderMark = 0x01020304;
+  const uint32_t ValueAbsent = 0xFFFFFFFF;
+
+  /** Location of one file's entry within the mapped index. */
+  struct IndexEntry
+  {
+    const char* Begin;
+    std::size_t Length;
+    uint64_t FileSize;
+    int64_t ModificationTime;
+    uint32_t NumberOfTags;
+    const char* Tags;
+  };
+
+  typedef std::unordered_map<std::string, IndexEntry> IndexEntryMap;
+
+  template <typename T>
+  T ReadValue(const char*& position, const char* end)
+  {
+    if (position + sizeof(T) > end)
+    {
+      mitkThrow() << "Truncated DICOM tag index.";
+    }
+
+    T value;
+    std::memcpy(&value, position, sizeof(T));
+    position += sizeof(T);
+    return value;
+  }
+
+  template <typename T>
+  void WriteValue(std::ostream& stream, T value)
+  {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  /** Skips a length-prefixed, null-terminated string and returns its begin. */
+  const char* SkipString(const char*& position, const char* end, uint32_t length)
+  {
+    const char* begin = position;
+    if (position + length + 1 > end || position[length] != '\0')
+    {
+      mitkThrow() << "Corrupt string in DICOM tag index.";
+    }
+    position += length + 1;
+    return begin;
+  }
+
+  std::shared_ptr<boost::interprocess::mapped_region> MapIndexFile(const std::string& indexFileName)
+  {
+    std::shared_ptr<boost::interprocess::mapped_region> region;
+
+    if (!itksys::SystemTools::FileExists(indexFileName.c_str(), true)
+        || itksys::SystemTools::FileLength(indexFileName.c_str()) == 0)
+    {
+      return region;
+    }
+
+    try
+    {
+      // the region stays valid after the file_mapping object is destroyed
+      boost::interprocess::file_mapping file(indexFileName.c_str(), boost::interprocess::read_only);
+      region = std::make_shared<boost::interprocess::mapped_region>(file, boost::interprocess::read_only);
+    }
+    catch (const boost::interprocess::interprocess_exception& e)
+    {
+      MITK_WARN << "Could not map DICOM tag index " << indexFileName << ": " << e.what();
+      region.reset();
+    }
+
+    return region;
+  }
+
+  IndexEntryMap ParseIndex(const boost::interprocess::mapped_region* region)
+  {
+    IndexEntryMap entries;
+    if (region == nullptr)
+    {
+      return entries;
+    }
+
+    const char* position = static_cast<const char*>(region->get_address());
+    const char* end = position + region->get_size();
+
+    try
+    {
+      if (position + sizeof(IndexMagic) > end || std::memcmp(position, IndexMagic, sizeof(IndexMagic)) != 0)
+      {
+        mitkThrow() << "Not a DICOM tag index.";
+      }
+      position += sizeof(IndexMagic);
+
+      if (ReadValue<uint32_t>(position, end) != IndexVersion || ReadValue<uint32_t>(position, end) != ByteOrderMark)
+      {
+        mitkThrow() << "Unsupported version or byte order of DICOM tag index.";
+      }
+
+      const auto numberOfEntries = ReadValue<uint32_t>(position, end);
+      entries.reserve(numberOfEntries);
+
+      for (uint32_t i = 0; i < numberOfEntries; ++i)
+      {
+        IndexEntry entry;
+        entry.Begin = position;
+
+        const auto pathLength = ReadValue<uint32_t>(position, end);
+        const std::string path(SkipString(position, end, pathLength), pathLength);
+
+        entry.FileSize = ReadValue<uint64_t>(position, end);
+        entry.ModificationTime = ReadValue<int64_t>(position, end);
+        entry.NumberOfTags = ReadValue<uint32_t>(position, end);
+        entry.Tags = position;
+
+        for (uint32_t t = 0; t < entry.NumberOfTags; ++t)
+        {
+          ReadValue<uint16_t>(position, end);
+          ReadValue<uint16_t>(position, end);
+          const auto valueLength = ReadValue<uint32_t>(position, end);
+          if (valueLength != ValueAbsent)
+          {
+            SkipString(position, end, valueLength);
+          }
+        }
+
+        entry.Length = position - entry.Begin;
+        entries[path] = entry;
+      }
+    }
+    catch (const mitk::Exception& e)
+    {
+      MITK_WARN << "Ignoring DICOM tag index: " << e.GetDescription();
+      entries.clear();
+    }
+
+    return entries;
+  }
+
+  /** Calls functor(tag, value) for all tags of an entry, value is nullptr for tags that were not found. */
+  template <typename FunctorType>
+  void ForEachTag(const IndexEntry& entry, FunctorType functor)
+  {
+    const char* position = entry.Tags;
+    const char* end = entry.Begin + entry.Length;
+
+    for (uint32_t t = 0; t < entry.NumberOfTags; ++t)
+    {
+      const auto group = ReadValue<uint16_t>(position, end);
+      const auto element = ReadValue<uint16_t>(position, end);
+      const auto valueLength = ReadValue<uint32_t>(position, end);
+
+      const char* value = nullptr;
+      if (valueLength != ValueAbsent)
+      {
+        value = SkipString(position, end, valueLength);
+      }
+
+      functor(mitk::DICOMTag(group, element), value);
+    }
+  }
+
+  std::set<mitk::DICOMTag> GetTagsOfEntry(const IndexEntry& entry)
+  {
+    std::set<mitk::DICOMTag> tags;
+    ForEachTag(entry, [&tags](const mitk::DICOMTag& tag, const char*) { tags.insert(tag); });
+    return tags;
+  }
+
+  /** Size and modification time of a file, the key of an index entry besides the path. */
+  struct FileState
+  {
+    uint64_t FileSize;
+    int64_t ModificationTime;
+  };
+
+  FileState GetFileState(const std::string& filename)
+  {
+    FileState state;
+    state.FileSize = static_cast<uint64_t>(itksys::SystemTools::FileLength(filename));
+    state.ModificationTime = static_cast<int64_t>(itksys::SystemTools::ModifiedTime(filename));
+    return state;
+  }
+
+  bool IsEntryUpToDate(const IndexEntry& entry, const FileState& state, const std::set<mitk::DICOMTag>& tags)
+  {
+    if (entry.FileSize != state.FileSize || entry.ModificationTime != state.ModificationTime)
+    {
+      return false;
+    }
+
+    const std::set<mitk::DICOMTag> tagsOfEntry = GetTagsOfEntry(entry);
+    return std::includes(tagsOfEntry.cbegin(), tagsOfEntry.cend(), tags.cbegin(), tags.cend());
+  }
+
+  void WriteEntry(std::ostream& stream,
+                  const std::string& filename,
+                  const FileState& state,
+                  const std::set<mitk::DICOMTag>& tags,
+                  mitk::DICOMDatasetAccessingImageFrameInfo* frame)
+  {
+    WriteValue<uint32_t>(stream, static_cast<uint32_t>(filename.size()));
+    stream.write(filename.c_str(), filename.size() + 1);
+    WriteValue<uint64_t>(stream, state.FileSize);
+    WriteValue<int64_t>(stream, state.ModificationTime);
+    WriteValue<uint32_t>(stream, static_cast<uint32_t>(tags.size()));
+
+    for (const auto& tag : tags)
+    {
+      WriteValue<uint16_t>(stream, static_cast<uint16_t>(tag.GetGroup()));
+      WriteValue<uint16_t>(stream, static_cast<uint16_t>(tag.GetElement()));
+
+      const mitk::DICOMDatasetFinding finding = frame->GetTagValueAsString(tag);
+      if (finding.isValid)
+      {
+        WriteValue<uint32_t>(stream, static_cast<uint32_t>(finding.value.size()));
+        stream.write(finding.value.c_str(), finding.value.size() + 1);
+      }
+      else
+      {
+        WriteValue<uint32_t>(stream, ValueAbsent);
+      }
+    }
+  }
+
+  mitk::DICOMDatasetAccessingImageFrameInfo::Pointer CreateFrameInfo(const std::string& filename, const IndexEntry& entry)
+  {
+    gdcm::Scanner::TagToValue tagToValue;
+    ForEachTag(entry, [&tagToValue](const mitk::DICOMTag& tag, const char* value)
+    {
+      if (value != nullptr)
+      {
+        tagToValue[gdcm::Tag(tag.GetGroup(), tag.GetElement())] = value;
+      }
+    });
+
+    return mitk::DICOMGDCMImageFrameInfo::New(mitk::DICOMImageFrameInfo::New(filename, 0), tagToValue).GetPointer();
+  }
+}
+
+mitk::DICOMPersistentTagCache::DICOMPersistentTagCache()
+  : m_NumberOfReusedFiles(0),
+    m_NumberOfScannedFiles(0)
+{
+  m_Scanner = std::make_shared<gdcm::Scanner>(); // keeps GetScanner() valid, the index replaces scanning
+}
+
+mitk::DICOMPersistentTagCache::~DICOMPersistentTagCache()
+{
+}
+
+void mitk::DICOMPersistentTagCache::InitCache(const std::set<DICOMTag>& scannedTags,
+                                              const StringList& inputFiles,
+                                              unsigned int numberOfThreads)
+{
+  if (m_IndexFileName.empty())
+  {
+    mitkThrow() << "Invalid call to DICOMPersistentTagCache::InitCache(). No index file name set.";
+  }
+
+  m_ScannedTags = scannedTags;
+  m_InputFilenames = inputFiles;
+  m_ScanResult.clear();
+  m_ScanCache = nullptr;
+  m_NumberOfReusedFiles = 0;
+  m_NumberOfScannedFiles = 0;
+
+  std::shared_ptr<boost::interprocess::mapped_region> previousIndex = MapIndexFile(m_IndexFileName);
+  IndexEntryMap entries = ParseIndex(previousIndex.get());
+
+  // find files that have to be scanned; tags already known for these files are scanned
+  // again, so that the tag sets of index entries only grow
+  // (file states are taken before scanning, so that files changing during the scan are
+  // found outdated next time)
+  StringList filesToScan;
+  std::unordered_map<std::string, FileState> fileStates;
+  std::set<DICOMTag> tagsToScan = scannedTags;
+  for (const auto& filename : inputFiles)
+  {
+    const FileState state = GetFileState(filename);
+    const auto entryIter = entries.find(filename);
+    if (entryIter == entries.cend())
+    {
+      filesToScan.push_back(filename);
+      fileStates[filename] = state;
+    }
+    else if (!IsEntryUpToDate(entryIter->second, state, scannedTags))
+    {
+      filesToScan.push_back(filename);
+      fileStates[filename] = state;
+      const std::set<DICOMTag> tagsOfEntry = GetTagsOfEntry(entryIter->second);
+      tagsToScan.insert(tagsOfEntry.cbegin(), tagsOfEntry.cend());
+    }
+  }
+
+  m_NumberOfScannedFiles = static_cast<unsigned int>(filesToScan.size());
+  m_NumberOfReusedFiles = static_cast<unsigned int>(inputFiles.size() - filesToScan.size());
+
+  if (filesToScan.empty())
+  {
+    // nothing changed, the index is answering everything
+    for (const auto& filename : inputFiles)
+    {
+      m_ScanResult.push_back(CreateFrameInfo(filename, entries.at(filename)));
+    }
+    m_IndexMapping = previousIndex;
+    return;
+  }
+
+  DICOMGDCMTagScanner::Pointer scanner = DICOMGDCMTagScanner::New();
+  scanner->SetIndexFileName(""); // scan without index, we are the index
+  scanner->AddTags(DICOMTagList(tagsToScan.cbegin(), tagsToScan.cend()));
+  scanner->SetInputFiles(filesToScan);
+  scanner->SetNumberOfThreads(numberOfThreads);
+  scanner->Scan();
+
+  const DICOMDatasetAccessingImageFrameList scannedFrames = scanner->GetFrameInfoList();
+  std::unordered_map<std::string, DICOMDatasetAccessingImageFrameInfo::Pointer> scannedFramesByName;
+  for (const auto& frame : scannedFrames)
+  {
+    scannedFramesByName[frame->Filename] = frame;
+  }
+
+  // write the updated index next to the old one: kept entries are copied verbatim. The name is unique, so that
+  // processes updating the same index do not write to the same temporary file
+  const std::string temporarySuffix = "." + UIDGenerator("", 8).GetUID();
+  const std::string temporaryIndexFileName = m_IndexFileName + temporarySuffix + ".tmp";
+  bool indexWritten = false;
+  {
+    std::ofstream stream(temporaryIndexFileName.c_str(), std::ios::binary | std::ios::trunc);
+
+    uint32_t numberOfEntries = static_cast<uint32_t>(scannedFramesByName.size());
+    for (const auto& entry : entries)
+    {
+      if (scannedFramesByName.find(entry.first) == scannedFramesByName.cend())
+      {
+        ++numberOfEntries;
+      }
+    }
+
+    stream.write(IndexMagic, sizeof(IndexMagic));
+    WriteValue<uint32_t>(stream, IndexVersion);
+    WriteValue<uint32_t>(stream, ByteOrderMark);
+    WriteValue<uint32_t>(stream, numberOfEntries);
+
+    for (const auto& entry : entries)
+    {
+      if (scannedFramesByName.find(entry.first) == scannedFramesByName.cend())
+      {
+        stream.write(entry.second.Begin, entry.second.Length);
+      }
+    }
+
+    for (const auto& frame : scannedFramesByName)
+    {
+      WriteEntry(stream, frame.first, fileStates.at(frame.first), tagsToScan, frame.second);
+    }
+
+    indexWritten = stream.good();
+  }
+
+  if (indexWritten)
+  {
+    // replaces the index atomically, even while the previous one is mapped (not on Windows)
+    bool indexReplaced = std::rename(temporaryIndexFileName.c_str(), m_IndexFileName.c_str()) == 0;
+
+    if (!indexReplaced)
+    {
+      // Windows neither replaces existing files nor renames mapped ones: release the previous index and move it
+      // aside, so it can be restored if the new one cannot take its place
+      entries.clear();
+      previousIndex.reset();
+
+      const std::string previousIndexFileName = m_IndexFileName + temporarySuffix + ".bak";
+      const bool movedAside = std::rename(m_IndexFileName.c_str(), previousIndexFileName.c_str()) == 0;
+      indexReplaced = std::rename(temporaryIndexFileName.c_str(), m_IndexFileName.c_str()) == 0;
+
+      if (movedAside && indexReplaced)
+      {
+        std::remove(previousIndexFileName.c_str());
+      }
+      else if (movedAside)
+      {
+        std::rename(previousIndexFileName.c_str(), m_IndexFileName.c_str());
+      }
+
+      if (!indexReplaced)
+      {
+        previousIndex = MapIndexFile(m_IndexFileName);
+        entries = ParseIndex(previousIndex.get());
+      }
+    }
+
+    if (indexReplaced)
+    {
+      m_IndexMapping = MapIndexFile(m_IndexFileName);
+      entries = ParseIndex(m_IndexMapping.get());
+    }
+    indexWritten = indexReplaced;
+  }
+
+  if (!indexWritten)
+  {
+    MITK_WARN << "Could not update DICOM tag index " << m_IndexFileName << ", scan results are not persisted.";
+    std::remove(temporaryIndexFileName.c_str());
+    m_IndexMapping = previousIndex;
+  }
+
+  for (const auto& filename : inputFiles)
+  {
+    const auto entryIter = entries.find(filename);
+    const auto scannedIter = scannedFramesByName.find(filename);
+
+    if (scannedIter != scannedFramesByName.cend() && (!indexWritten || entryIter == entries.cend()))
+    {
+      m_ScanCache = scanner->GetScanCache(); // frame infos point into the scanner's results
+      m_ScanResult.push_back(scannedIter->second);
+    }
+    else if (entryIter != entries.cend())
+    {
+      m_ScanResult.push_back(CreateFrameInfo(filename, entryIter->second));
+    }
+  }
+}
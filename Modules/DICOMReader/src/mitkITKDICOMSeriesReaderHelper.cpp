@@ -31,11 +31,121 @@ found in the LICENSE file.
 
 #include "dcmtk/dcmdata/dcvrda.h"
 
+#include <itkMultiThreader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 
 const mitk::DICOMTag mitk::ITKDICOMSeriesReaderHelper::AcquisitionDateTag = mitk::DICOMTag( 0x0008, 0x0022 );
 const mitk::DICOMTag mitk::ITKDICOMSeriesReaderHelper::AcquisitionTimeTag = mitk::DICOMTag( 0x0008, 0x0032 );
 const mitk::DICOMTag mitk::ITKDICOMSeriesReaderHelper::TriggerTimeTag = mitk::DICOMTag( 0x0018, 0x1060 );
 
+mitk::ITKDICOMSeriesReaderHelper::ITKDICOMSeriesReaderHelper()
+  : m_NumberOfThreads(1)
+{
+}
+
+void mitk::ITKDICOMSeriesReaderHelper::SetNumberOfThreads( unsigned int numberOfThreads )
+{
+  m_NumberOfThreads = numberOfThreads;
+}
+
+unsigned int mitk::ITKDICOMSeriesReaderHelper::GetNumberOfThreads() const
+{
+  return m_NumberOfThreads;
+}
+
+unsigned int mitk::ITKDICOMSeriesReaderHelper::GetEffectiveNumberOfThreads( std::size_t numberOfSlices ) const
+{
+  unsigned int numberOfThreads = m_NumberOfThreads;
+  if ( numberOfThreads == 0 )
+  {
+    numberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  }
+
+  return static_cast<unsigned int>( std::min<std::size_t>( numberOfThreads, numberOfSlices ) );
+}
+
+void mitk::ITKDICOMSeriesReaderHelper::ReadSlicesConcurrently( const SliceReadJobList& jobs,
+                                                               const itk::ImageIOBase* referenceIO,
+                                                               std::size_t sliceSizeInBytes,
+                                                               unsigned int numberOfThreads )
+{
+  // jobs are handed out one by one, since decoding times of compressed slices may vary a lot
+  std::atomic<std::size_t> nextJob( 0 );
+  std::exception_ptr error;
+  std::mutex errorMutex;
+
+  auto worker = [&]()
+  {
+    itk::GDCMImageIO::Pointer io = itk::GDCMImageIO::New();
+
+    for ( std::size_t job = nextJob++; job < jobs.size(); job = nextJob++ )
+    {
+      try
+      {
+        io->SetFileName( jobs[job].Filename );
+        io->ReadImageInformation();
+
+        if ( io->GetComponentType() != referenceIO->GetComponentType()
+             || io->GetNumberOfComponents() != referenceIO->GetNumberOfComponents()
+             || io->GetImageSizeInBytes() != sliceSizeInBytes )
+        {
+          mitkThrow() << "Pixel layout of '" << jobs[job].Filename << "' differs from first slice of series.";
+        }
+
+        io->Read( jobs[job].Destination );
+      }
+      catch ( ... )
+      {
+        std::lock_guard<std::mutex> lock( errorMutex );
+        if ( !error )
+        {
+          error = std::current_exception();
+        }
+        nextJob = jobs.size(); // stop all workers
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for ( unsigned int t = 1; t < numberOfThreads; ++t )
+  {
+    threads.emplace_back( worker );
+  }
+  worker(); // calling thread does its share
+
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  if ( error )
+  {
+    try
+    {
+      std::rethrow_exception( error );
+    }
+    catch ( const mitk::Exception& )
+    {
+      throw;
+    }
+    catch ( const std::exception& e )
+    {
+      // callers fall back to itk::ImageSeriesReader on mitk::Exception
+      mitkThrow() << "Error decoding DICOM slice: " << e.what();
+    }
+    catch ( ... )
+    {
+      mitkThrow() << "Unknown error decoding DICOM slice.";
+    }
+  }
+}
+
 #define switch3DCase( IOType, T ) \
   case IOType:                    \
     return LoadDICOMByITK<T>( filenames, correctTilt, tiltInfo, io );
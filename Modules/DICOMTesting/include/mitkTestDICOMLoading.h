@@ -52,6 +52,20 @@ class MITKDICOMTESTING_EXPORT TestDICOMLoading
     CompareImageInformationDumps( const std::string& reference,
                                   const std::string& test );
 
+    /**
+      \brief Write a synthetic CT series of single-frame DICOM files.
+
+      Slices are written to an existing directory and contain a simple gradient pattern.
+      All files share study, series and frame of reference UIDs, so that they are
+      loaded as one volume of columns x rows x numberOfSlices voxels.
+      \return names of the written files, ordered by slice position
+    */
+    StringList
+    WriteSyntheticSeries( const std::string& directory,
+                          unsigned int columns,
+                          unsigned int rows,
+                          unsigned int numberOfSlices );
+
   private:
 
     typedef std::map<std::string,std::string> KeyValueMap;
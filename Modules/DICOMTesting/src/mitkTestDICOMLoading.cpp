@@ -13,8 +13,28 @@ found in the LICENSE file.
 
 #include "mitkTestDICOMLoading.h"
 
+#include <gdcmImageWriter.h>
+#include <gdcmUIDGenerator.h>
+
+#include <iomanip>
 #include <stack>
 
+namespace
+{
+  void InsertStringElement( gdcm::DataSet& dataset, const gdcm::Tag& tag, const gdcm::VR& vr, std::string value )
+  {
+    if ( value.size() % 2 )
+    {
+      value.push_back( vr == gdcm::VR::UI ? '\0' : ' ' ); // DICOM values have even length
+    }
+
+    gdcm::DataElement element( tag );
+    element.SetVR( vr );
+    element.SetByteValue( value.c_str(), static_cast<uint32_t>( value.size() ) );
+    dataset.Replace( element );
+  }
+}
+
 mitk::TestDICOMLoading::TestDICOMLoading()
 :m_PreviousCLocale(nullptr)
 {
@@ -486,3 +506,85 @@ mitk::TestDICOMLoading::ParseDump( const std::string& dump )
   return parsedResult;
 }
 
+
+mitk::StringList
+mitk::TestDICOMLoading
+::WriteSyntheticSeries( const std::string& directory,
+                        unsigned int columns,
+                        unsigned int rows,
+                        unsigned int numberOfSlices )
+{
+  StringList filenames;
+
+  gdcm::UIDGenerator uidGenerator;
+  const std::string studyUID = uidGenerator.Generate();
+  const std::string seriesUID = uidGenerator.Generate();
+  const std::string frameOfReferenceUID = uidGenerator.Generate();
+
+  const double pixelSpacing = 0.75;
+  const double sliceDistance = 1.5;
+  const double directionCosines[6] = { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0 };
+
+  std::vector<short> pixels( columns * rows );
+
+  for ( unsigned int slice = 0; slice < numberOfSlices; ++slice )
+  {
+    for ( unsigned int y = 0; y < rows; ++y )
+    {
+      for ( unsigned int x = 0; x < columns; ++x )
+      {
+        pixels[y * columns + x] = static_cast<short>( ( x + 2 * y + 4 * slice ) % 2048 - 1024 );
+      }
+    }
+
+    gdcm::ImageWriter writer;
+
+    gdcm::Image& image = writer.GetImage();
+    image.SetNumberOfDimensions( 2 );
+    image.SetDimension( 0, columns );
+    image.SetDimension( 1, rows );
+    image.SetPixelFormat( gdcm::PixelFormat::INT16 );
+    image.SetPhotometricInterpretation( gdcm::PhotometricInterpretation::MONOCHROME2 );
+    image.SetSpacing( 0, pixelSpacing );
+    image.SetSpacing( 1, pixelSpacing );
+    image.SetSpacing( 2, sliceDistance );
+    image.SetOrigin( 0, -0.5 * columns * pixelSpacing );
+    image.SetOrigin( 1, -0.5 * rows * pixelSpacing );
+    image.SetOrigin( 2, slice * sliceDistance );
+    image.SetDirectionCosines( directionCosines );
+    image.SetIntercept( 0.0 );
+    image.SetSlope( 1.0 );
+
+    gdcm::DataElement pixelData( gdcm::Tag( 0x7fe0, 0x0010 ) );
+    pixelData.SetByteValue( reinterpret_cast<const char*>( pixels.data() ),
+                            static_cast<uint32_t>( pixels.size() * sizeof( short ) ) );
+    image.SetDataElement( pixelData );
+
+    std::ostringstream instanceNumber;
+    instanceNumber << slice + 1;
+
+    gdcm::DataSet& dataset = writer.GetFile().GetDataSet();
+    InsertStringElement( dataset, gdcm::Tag( 0x0008, 0x0016 ), gdcm::VR::UI,
+                         gdcm::MediaStorage::GetMSString( gdcm::MediaStorage::CTImageStorage ) );
+    InsertStringElement( dataset, gdcm::Tag( 0x0008, 0x0060 ), gdcm::VR::CS, "CT" );
+    InsertStringElement( dataset, gdcm::Tag( 0x0010, 0x0010 ), gdcm::VR::PN, "Synthetic^Series" );
+    InsertStringElement( dataset, gdcm::Tag( 0x0018, 0x0050 ), gdcm::VR::DS, "1.5" );
+    InsertStringElement( dataset, gdcm::Tag( 0x0020, 0x000d ), gdcm::VR::UI, studyUID );
+    InsertStringElement( dataset, gdcm::Tag( 0x0020, 0x000e ), gdcm::VR::UI, seriesUID );
+    InsertStringElement( dataset, gdcm::Tag( 0x0020, 0x0013 ), gdcm::VR::IS, instanceNumber.str() );
+    InsertStringElement( dataset, gdcm::Tag( 0x0020, 0x0052 ), gdcm::VR::UI, frameOfReferenceUID );
+
+    std::ostringstream filename;
+    filename << directory << "/synthetic_" << std::setw( 5 ) << std::setfill( '0' ) << slice << ".dcm";
+
+    writer.SetFileName( filename.str().c_str() );
+    if ( !writer.Write() )
+    {
+      mitkThrow() << "Could not write synthetic DICOM slice " << filename.str();
+    }
+
+    filenames.push_back( filename.str() );
+  }
+
+  return filenames;
+}
@@ -1,4 +1,10 @@
 
+# tests without command line parameters
+set(MODULE_TESTS
+  mitkDICOMConcurrentLoadingTest.cpp
+  mitkDICOMPersistentTagCacheTest.cpp
+)
+
 # tests with no extra command line parameter
 set(MODULE_CUSTOM_TESTS
   mitkDICOMTestingSanityTest.cpp
@@ -0,0 +1,83 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTestDICOMLoading.h"
+#include "mitkDICOMITKSeriesGDCMReader.h"
+
+#include "mitkIOUtil.h"
+#include "mitkTestingMacros.h"
+
+#include <itksys/SystemTools.hxx>
+
+#include <chrono>
+
+namespace
+{
+  /** Loads files with the given number of threads, returns the single image and reports the elapsed time. */
+  mitk::Image::Pointer LoadSeries( const mitk::StringList& files, unsigned int numberOfThreads, double& seconds )
+  {
+    auto start = std::chrono::steady_clock::now();
+
+    mitk::DICOMITKSeriesGDCMReader::Pointer reader = mitk::DICOMITKSeriesGDCMReader::New();
+    reader->SetNumberOfThreads( numberOfThreads );
+    reader->SetInputFiles( files );
+    reader->AnalyzeInputFiles();
+    reader->LoadImages();
+
+    seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+    if ( reader->GetNumberOfOutputs() != 1 )
+    {
+      return nullptr;
+    }
+
+    return reader->GetOutput( 0 ).GetMitkImage();
+  }
+}
+
+/**
+  \brief Compares sequential and concurrent loading of a synthetic series by DICOMITKSeriesGDCMReader.
+
+  Both paths must produce identical images. Timings of both paths are reported as a simple benchmark.
+*/
+int mitkDICOMConcurrentLoadingTest(int /*argc*/, char* /*argv*/[])
+{
+  MITK_TEST_BEGIN("DICOMConcurrentLoading")
+
+  const std::string directory = mitk::IOUtil::CreateTemporaryDirectory( "DICOMConcurrentLoading-XXXXXX" );
+
+  mitk::TestDICOMLoading loader;
+  const mitk::StringList files = loader.WriteSyntheticSeries( directory, 256, 256, 200 );
+  MITK_TEST_CONDITION_REQUIRED( files.size() == 200, "Synthetic series of 200 slices written" )
+
+  double sequentialSeconds( 0.0 );
+  mitk::Image::Pointer sequentialImage = LoadSeries( files, 1, sequentialSeconds );
+  MITK_TEST_CONDITION_REQUIRED( sequentialImage.IsNotNull(), "Sequential loading results in one image" )
+
+  double concurrentSeconds( 0.0 );
+  mitk::Image::Pointer concurrentImage = LoadSeries( files, 0, concurrentSeconds );
+  MITK_TEST_CONDITION_REQUIRED( concurrentImage.IsNotNull(), "Concurrent loading results in one image" )
+
+  MITK_TEST_CONDITION( mitk::Equal( *sequentialImage, *concurrentImage, mitk::eps, true ),
+                       "Concurrent loading produces the same image as sequential loading" )
+
+  MITK_TEST_CONDITION( loader.CompareImageInformationDumps( loader.DumpImageInformation( sequentialImage ),
+                                                            loader.DumpImageInformation( concurrentImage ) ),
+                       "Concurrent loading produces the same image information as sequential loading" )
+
+  MITK_INFO << "Loading " << files.size() << " slices: sequential " << sequentialSeconds << " s, concurrent "
+            << concurrentSeconds << " s (speedup " << sequentialSeconds / concurrentSeconds << ")";
+
+  itksys::SystemTools::RemoveADirectory( directory );
+
+  MITK_TEST_END()
+}
@@ -0,0 +1,138 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTestDICOMLoading.h"
+#include "mitkDICOMGDCMTagScanner.h"
+#include "mitkDICOMPersistentTagCache.h"
+
+#include "mitkIOUtil.h"
+#include "mitkTestingMacros.h"
+
+#include <itksys/SystemTools.hxx>
+
+namespace
+{
+  mitk::DICOMPersistentTagCache::Pointer ScanWithIndex( const std::string& indexFileName,
+                                                        const mitk::StringList& files,
+                                                        const mitk::DICOMTagList& tags )
+  {
+    mitk::DICOMGDCMTagScanner::Pointer scanner = mitk::DICOMGDCMTagScanner::New();
+    scanner->SetIndexFileName( indexFileName );
+    scanner->AddTags( tags );
+    scanner->SetInputFiles( files );
+    scanner->Scan();
+
+    return dynamic_cast<mitk::DICOMPersistentTagCache*>( scanner->GetScanCache().GetPointer() );
+  }
+
+  bool HasSameValues( mitk::DICOMTagCache* reference, mitk::DICOMTagCache* test, const mitk::DICOMTagList& tags )
+  {
+    const mitk::DICOMDatasetAccessingImageFrameList referenceFrames = reference->GetFrameInfoList();
+    const mitk::DICOMDatasetAccessingImageFrameList testFrames = test->GetFrameInfoList();
+
+    if ( referenceFrames.size() != testFrames.size() )
+    {
+      return false;
+    }
+
+    for ( std::size_t i = 0; i < referenceFrames.size(); ++i )
+    {
+      if ( referenceFrames[i]->Filename != testFrames[i]->Filename )
+      {
+        return false;
+      }
+
+      for ( const auto& tag : tags )
+      {
+        const mitk::DICOMDatasetFinding referenceFinding = referenceFrames[i]->GetTagValueAsString( tag );
+        const mitk::DICOMDatasetFinding testFinding = testFrames[i]->GetTagValueAsString( tag );
+        if ( referenceFinding.isValid != testFinding.isValid || referenceFinding.value != testFinding.value )
+        {
+          MITK_ERROR << "Value mismatch in " << referenceFrames[i]->Filename << ": '" << referenceFinding.value
+                     << "' vs. '" << testFinding.value << "'";
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+}
+
+/**
+  \brief Verifies that DICOMPersistentTagCache answers unchanged files from its index and rescans only what is needed.
+*/
+int mitkDICOMPersistentTagCacheTest(int /*argc*/, char* /*argv*/[])
+{
+  MITK_TEST_BEGIN("DICOMPersistentTagCache")
+
+  const std::string directory = mitk::IOUtil::CreateTemporaryDirectory( "DICOMPersistentTagCache-XXXXXX" );
+  const std::string indexFileName = directory + "/tags.index";
+  itksys::SystemTools::MakeDirectory( directory + "/a" );
+  itksys::SystemTools::MakeDirectory( directory + "/b" );
+
+  mitk::TestDICOMLoading loader;
+  const mitk::StringList filesA = loader.WriteSyntheticSeries( directory + "/a", 32, 32, 20 );
+  const mitk::StringList filesB = loader.WriteSyntheticSeries( directory + "/b", 32, 32, 10 );
+
+  mitk::DICOMTagList tags;
+  tags.push_back( mitk::DICOMTag( 0x0020, 0x0032 ) ); // Image Position (Patient)
+  tags.push_back( mitk::DICOMTag( 0x0020, 0x0013 ) ); // Instance Number
+  tags.push_back( mitk::DICOMTag( 0x0020, 0x000e ) ); // Series Instance UID
+  tags.push_back( mitk::DICOMTag( 0x0018, 0x1060 ) ); // Trigger Time (not present)
+
+  mitk::DICOMGDCMTagScanner::Pointer referenceScanner = mitk::DICOMGDCMTagScanner::New();
+  referenceScanner->SetIndexFileName( "" );
+  referenceScanner->AddTags( tags );
+  referenceScanner->SetInputFiles( filesA );
+  referenceScanner->Scan();
+
+  // first scan builds the index
+  mitk::DICOMPersistentTagCache::Pointer cache = ScanWithIndex( indexFileName, filesA, tags );
+  MITK_TEST_CONDITION_REQUIRED( cache.IsNotNull(), "Scanner with index file creates a DICOMPersistentTagCache" )
+  MITK_TEST_CONDITION( cache->GetNumberOfScannedFiles() == 20 && cache->GetNumberOfReusedFiles() == 0,
+                       "All files are scanned into an empty index" )
+  MITK_TEST_CONDITION( itksys::SystemTools::FileExists( indexFileName.c_str(), true ), "Index file is written" )
+  MITK_TEST_CONDITION( HasSameValues( referenceScanner->GetScanCache(), cache, tags ),
+                       "Values of a fresh scan equal values of a scan without index" )
+
+  // second scan is answered from the index
+  cache = ScanWithIndex( indexFileName, filesA, tags );
+  MITK_TEST_CONDITION( cache->GetNumberOfScannedFiles() == 0 && cache->GetNumberOfReusedFiles() == 20,
+                       "Unchanged files are answered from the index" )
+  MITK_TEST_CONDITION( HasSameValues( referenceScanner->GetScanCache(), cache, tags ),
+                       "Values from the index equal values of a scan without index" )
+
+  // new files are scanned, known ones reused
+  mitk::StringList filesAB = filesA;
+  filesAB.insert( filesAB.end(), filesB.cbegin(), filesB.cend() );
+  cache = ScanWithIndex( indexFileName, filesAB, tags );
+  MITK_TEST_CONDITION( cache->GetNumberOfScannedFiles() == 10 && cache->GetNumberOfReusedFiles() == 20,
+                       "Only new files are scanned" )
+  MITK_TEST_CONDITION( cache->GetFrameInfoList().size() == 30, "Frame list covers all input files" )
+
+  // requesting a tag that is not in the index rescans
+  mitk::DICOMTagList moreTags = tags;
+  moreTags.push_back( mitk::DICOMTag( 0x0020, 0x0052 ) ); // Frame of Reference UID
+  cache = ScanWithIndex( indexFileName, filesB, moreTags );
+  MITK_TEST_CONDITION( cache->GetNumberOfScannedFiles() == 10 && cache->GetNumberOfReusedFiles() == 0,
+                       "Files lacking requested tags in the index are scanned" )
+
+  cache = ScanWithIndex( indexFileName, filesB, tags );
+  MITK_TEST_CONDITION( cache->GetNumberOfScannedFiles() == 0 && cache->GetNumberOfReusedFiles() == 10,
+                       "Index keeps previously scanned tags when more tags were added" )
+
+  cache = nullptr;
+  itksys::SystemTools::RemoveADirectory( directory );
+
+  MITK_TEST_END()
+}
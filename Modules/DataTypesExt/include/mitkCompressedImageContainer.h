@@ -55,6 +55,11 @@ namespace mitk
      */
     Image::Pointer GetImage();
 
+    /**
+     * \brief Returns the number of bytes occupied by the compressed data of all timesteps.
+     */
+    unsigned long GetCompressedSize() const;
+
   protected:
     CompressedImageContainer(); // purposely hidden
     ~CompressedImageContainer() override;
@@ -121,6 +121,16 @@ void mitk::CompressedImageContainer::SetImage(Image *image)
   }
 }
 
+unsigned long mitk::CompressedImageContainer::GetCompressedSize() const
+{
+  unsigned long compressedSize = 0;
+  for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter)
+  {
+    compressedSize += iter->second;
+  }
+  return compressedSize;
+}
+
 mitk::Image::Pointer mitk::CompressedImageContainer::GetImage()
 {
   if (m_ByteBuffers.empty())
@@ -145,6 +145,35 @@ void mitk::NavigationDataPlayer::Resume()
   }
 }
 
+void mitk::NavigationDataPlayer::Seek(TimeStampType timeStampSinceStart)
+{
+  if ( this->GetNumberOfSnapshots() == 0 )
+  {
+    mitkThrowException(mitk::IGTException) << "Cannot seek without navigation datas.";
+  }
+
+  if (m_CurPlayerState == PlayerStopped)
+  {
+    MITK_ERROR << "Player is not started, cannot seek!" << std::endl;
+    return;
+  }
+
+  TimeStampType firstTimeStamp = m_NavigationDataSet->Begin()->at(0)->GetIGTTimeStamp();
+  m_NavigationDataSetIterator = m_NavigationDataSet->Begin()
+      + this->GetSnapshotNumberAtTimeStamp(firstTimeStamp + timeStampSinceStart);
+  m_TimeStampSinceStart = timeStampSinceStart;
+
+  // shift the start time, so GenerateData() and Resume() continue at the new position
+  if (m_CurPlayerState == PlayerRunning)
+  {
+    m_StartPlayingTimeStamp = mitk::IGTTimeStamp::GetInstance()->GetElapsed() - timeStampSinceStart;
+  }
+  else
+  {
+    m_StartPlayingTimeStamp = m_PauseTimeStamp - timeStampSinceStart;
+  }
+}
+
 mitk::NavigationDataPlayer::PlayerState mitk::NavigationDataPlayer::GetCurrentPlayerState()
 {
   return m_CurPlayerState;
@@ -67,6 +67,14 @@ namespace mitk {
     */
     void Resume();
 
+    /**
+    * \brief Continues playing at the given time since start, i.e. relative to the time stamp of the
+    * first snapshot. Works while the player is running or paused.
+    *
+    * @throw mitk::IGTException If m_NavigationDataSet is null or empty.
+    */
+    void Seek(TimeStampType timeStampSinceStart);
+
     PlayerState GetCurrentPlayerState();
 
     TimeStampType GetTimeStampSinceStart();
@@ -15,6 +15,8 @@ found in the LICENSE file.
 // include for exceptions
 #include "mitkIGTException.h"
 
+#include <algorithm>
+
 mitk::NavigationDataPlayerBase::NavigationDataPlayerBase()
   : m_Repeat(false)
 {
@@ -54,6 +56,22 @@ unsigned int mitk::NavigationDataPlayerBase::GetCurrentSnapshotNumber()
   return m_NavigationDataSet.IsNull() ? 0 : m_NavigationDataSetIterator - m_NavigationDataSet->Begin();
 }
 
+unsigned int mitk::NavigationDataPlayerBase::GetSnapshotNumberAtTimeStamp(NavigationData::TimeStampType timeStamp)
+{
+  if ( m_NavigationDataSet.IsNull() )
+  {
+    mitkThrowException(mitk::IGTException)
+      << "NavigationDataSet has to be set before seeking.";
+  }
+
+  NavigationDataSet::NavigationDataSetConstIterator snapshot = std::upper_bound(
+    m_NavigationDataSet->Begin(), m_NavigationDataSet->End(), timeStamp,
+    [](NavigationData::TimeStampType value, const std::vector<NavigationData::Pointer>& navigationDatas)
+    { return value < navigationDatas.at(0)->GetIGTTimeStamp(); });
+
+  return snapshot == m_NavigationDataSet->Begin() ? 0 : (snapshot - m_NavigationDataSet->Begin()) - 1;
+}
+
 void mitk::NavigationDataPlayerBase::InitPlayer()
 {
   if ( m_NavigationDataSet.IsNull() )
@@ -68,6 +68,15 @@ namespace mitk{
 
     unsigned int GetCurrentSnapshotNumber();
 
+    /**
+    * \brief Returns the number of the last snapshot whose time stamp (of the first tool) is not
+    * greater than the given one, or 0 if all snapshots are later. Uses a binary search, so
+    * seeking is fast even in long recordings.
+    *
+    * @throw mitk::IGTException If no mitk::NavigationDataSet is set.
+    */
+    unsigned int GetSnapshotNumberAtTimeStamp(NavigationData::TimeStampType timeStamp);
+
     /**
     * \brief This method checks if player arrived at end of file.
     *
@@ -20,7 +20,9 @@ mitk::NavigationDataRecorder::NavigationDataRecorder()
    m_StandardizeTime(false),
    m_StandardizedTimeInitialized(false),
    m_RecordCountLimit(-1),
-   m_RecordOnlyValidData(false)
+   m_RecordOnlyValidData(false),
+   m_StreamRecordingWriter(nullptr),
+   m_NumberOfStreamedSteps(0)
 {
 
 }
@@ -67,15 +69,26 @@ void mitk::NavigationDataRecorder::GenerateData()
   }
 
   // if limitation is set and has been reached, stop recording
-  if ((m_RecordCountLimit > 0) && (m_NavigationDataSet->Size() >= static_cast<unsigned int>(m_RecordCountLimit)))
+  if ((m_RecordCountLimit > 0) && (this->GetNumberOfRecordedSteps() >= m_RecordCountLimit))
     m_Recording = false;
   // We can skip the rest of the method, if recording is deactivated
   if (!m_Recording) return;
   // We can skip the rest of the method, if we read only valid data
   if (m_RecordOnlyValidData && atLeastOneInputIsInvalid) return;
 
-  // Add data to set
-  m_NavigationDataSet->AddNavigationDatas(clonedDatas);
+  // Add data to the stream or to the set
+  if (this->IsStreaming())
+  {
+    if (!clonedDatas.empty())
+    {
+      m_StreamRecordingWriter->AddNavigationDatas(clonedDatas, clonedDatas[0]->GetIGTTimeStamp());
+      ++m_NumberOfStreamedSteps;
+    }
+  }
+  else
+  {
+    m_NavigationDataSet->AddNavigationDatas(clonedDatas);
+  }
 }
 
 void mitk::NavigationDataRecorder::StartRecording()
@@ -109,6 +122,7 @@ void mitk::NavigationDataRecorder::StopRecording()
 void mitk::NavigationDataRecorder::ResetRecording()
 {
   m_NavigationDataSet = mitk::NavigationDataSet::New(GetNumberOfIndexedInputs());
+  m_NumberOfStreamedSteps = 0;
 
   if (m_Recording)
   {
@@ -119,5 +133,12 @@ void mitk::NavigationDataRecorder::ResetRecording()
 
 int mitk::NavigationDataRecorder::GetNumberOfRecordedSteps()
 {
+  if (this->IsStreaming())
+    return m_NumberOfStreamedSteps;
   return m_NavigationDataSet->Size();
 }
+
+bool mitk::NavigationDataRecorder::IsStreaming() const
+{
+  return m_StreamRecordingWriter.IsNotNull() && m_StreamRecordingWriter->IsOpen();
+}
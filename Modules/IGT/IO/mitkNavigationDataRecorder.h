@@ -16,6 +16,7 @@ found in the LICENSE file.
 #include "mitkNavigationDataToNavigationDataFilter.h"
 #include "mitkNavigationData.h"
 #include "mitkNavigationDataSet.h"
+#include "mitkStreamRecordingWriter.h"
 
 namespace mitk
 {
@@ -27,6 +28,10 @@ namespace mitk
   * With StopRecording() the stream is stopped, but can be resumed anytime.
   * To start recording to a new NavigationDataSet, call ResetRecording();
   *
+  * If a mitk::StreamRecordingWriter is set and open, the recorded data is appended to the writer's file
+  * instead of the NavigationDataSet. This keeps the memory usage constant during long recordings, the
+  * NavigationDataSet stays empty then.
+  *
   * \warning Do not add inputs while the recorder ist recording. The recorder can't handle that and will cause a nullpointer exception.
   * \ingroup IGT
   */
@@ -77,6 +82,13 @@ namespace mitk
     */
     itkGetMacro(RecordOnlyValidData, bool);
 
+    /**
+    * \brief Sets a writer which streams the recorded data to a file. The writer has to be opened and
+    * closed by the caller. Set to nullptr to record into the NavigationDataSet again.
+    */
+    itkSetObjectMacro(StreamRecordingWriter, mitk::StreamRecordingWriter);
+    itkGetObjectMacro(StreamRecordingWriter, mitk::StreamRecordingWriter);
+
     /**
     * \brief Starts recording NavigationData into the NavigationDataSet
     */
@@ -98,7 +110,8 @@ namespace mitk
     virtual void ResetRecording();
 
     /**
-    * \brief Returns the number of time steps that were recorded in the current set.
+    * \brief Returns the number of time steps that were recorded in the current set, or
+    * streamed to the StreamRecordingWriter since the last reset if a writer is set and open.
     * Warning: This Method does NOT Stop Recording!
     */
     virtual int GetNumberOfRecordedSteps();
@@ -111,6 +124,9 @@ namespace mitk
 
     ~NavigationDataRecorder() override;
 
+    /** \brief Returns true if recorded data is passed to the StreamRecordingWriter instead of the set. */
+    bool IsStreaming() const;
+
     unsigned int m_NumberOfInputs; ///< counts the numbers of added input NavigationDatas
 
     mitk::NavigationDataSet::Pointer m_NavigationDataSet;
@@ -124,6 +140,10 @@ namespace mitk
     int m_RecordCountLimit; ///< limits the number of frames, recording will be stopped if the limit is reached. -1 disables the limit
 
     bool m_RecordOnlyValidData; ///< indicates whether only valid data is recorded
+
+    mitk::StreamRecordingWriter::Pointer m_StreamRecordingWriter; ///< if set and open, data is streamed to its file
+
+    int m_NumberOfStreamedSteps; ///< number of time steps passed to m_StreamRecordingWriter since the last reset
   };
 }
 #endif // #define _MITK_POINT_SET_SOURCE_H
@@ -67,6 +67,17 @@ bool mitk::NavigationDataSequentialPlayer::GoToNextSnapshot()
   return true;
 }
 
+void mitk::NavigationDataSequentialPlayer::GoToTimeStamp(NavigationData::TimeStampType timeStamp)
+{
+  if ( this->GetNumberOfSnapshots() == 0 )
+  {
+    mitkThrowException(mitk::IGTException) << "Cannot go to a time stamp without navigation datas.";
+  }
+
+  m_NavigationDataSetIterator = m_NavigationDataSet->Begin() + this->GetSnapshotNumberAtTimeStamp(timeStamp);
+  this->GenerateData();
+}
+
 void mitk::NavigationDataSequentialPlayer::GenerateData()
 {
   if ( m_NavigationDataSetIterator == m_NavigationDataSet->End() )
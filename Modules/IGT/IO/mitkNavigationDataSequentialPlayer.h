@@ -53,6 +53,15 @@ namespace mitk
     */
     bool GoToNextSnapshot();
 
+    /**
+    * \brief Advance the output to the last snapshot whose time stamp is not greater than
+    * the given time stamp (see GetSnapshotNumberAtTimeStamp()).
+    * Filter output is updated inside the function.
+    *
+    * @throw mitk::IGTException Throws an exception if no NavigationDataSet is set or it is empty.
+    */
+    void GoToTimeStamp(NavigationData::TimeStampType timeStamp);
+
     /**
     * \brief Used for pipeline update just to tell the pipeline
     * that we always have to update
@@ -0,0 +1,256 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkIGTIOException.h>
+#include <mitkImageGenerator.h>
+#include <mitkIOUtil.h>
+#include <mitkNavigationDataRecorder.h>
+#include <mitkNavigationDataSequentialPlayer.h>
+#include <mitkStreamRecordingReader.h>
+#include <mitkStreamRecordingWriter.h>
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+class mitkStreamRecordingTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkStreamRecordingTestSuite);
+  MITK_TEST(TestWriteAndRead);
+  MITK_TEST(TestReadWithoutIndex);
+  MITK_TEST(TestReadTruncatedRecords);
+  MITK_TEST(TestRecorderStreamsToFile);
+  MITK_TEST(TestSequentialPlayerGoToTimeStamp);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::string m_FileName;
+  mitk::StreamRecordingWriter::Pointer m_Writer;
+  mitk::StreamRecordingReader::Pointer m_Reader;
+
+  static std::vector<mitk::NavigationData::Pointer> CreateNavigationDatas(unsigned int snapshot)
+  {
+    std::vector<mitk::NavigationData::Pointer> navigationDatas;
+    for (unsigned int tool = 0; tool < 2; ++tool)
+    {
+      mitk::NavigationData::Pointer navigationData = mitk::NavigationData::New();
+      mitk::NavigationData::PositionType position;
+      mitk::FillVector3D(position, snapshot, tool, 0.5 * snapshot);
+      navigationData->SetPosition(position);
+      const double component = 1.0 / std::sqrt(2.0);
+      navigationData->SetOrientation(mitk::NavigationData::OrientationType(0.0, 0.0, component, component));
+      navigationData->SetPositionAccuracy(0.1 * (tool + 1));
+      navigationData->SetIGTTimeStamp(10.0 * snapshot);
+      navigationData->SetDataValid(snapshot % 3 != 0);
+      navigationData->SetName(tool == 0 ? "Pointer" : "Reference");
+      navigationDatas.push_back(navigationData);
+    }
+    return navigationDatas;
+  }
+
+  template <typename T>
+  static void Write(std::ofstream &file, const T &value)
+  {
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  /** Writes a file without index and with a record of the given type whose payload is only the given value */
+  template <typename T>
+  void WriteFileWithRecord(std::uint32_t type, const T &payload)
+  {
+    std::ofstream file(m_FileName, std::ios::binary | std::ios::trunc);
+    file.write("MITKREC", 8);
+    Write(file, std::uint32_t(1));
+    Write(file, std::uint32_t(0));
+    Write(file, type);
+    Write(file, std::uint32_t(0));
+    Write(file, static_cast<std::uint64_t>(sizeof(T)));
+    Write(file, 0.0);
+    Write(file, payload);
+  }
+
+  void WriteNavigationDatas(unsigned int numberOfSnapshots)
+  {
+    for (unsigned int snapshot = 0; snapshot < numberOfSnapshots; ++snapshot)
+    {
+      m_Writer->AddNavigationDatas(CreateNavigationDatas(snapshot), 10.0 * snapshot);
+    }
+  }
+
+  void CheckNavigationDatas(unsigned int numberOfSnapshots)
+  {
+    CPPUNIT_ASSERT_EQUAL(numberOfSnapshots, m_Reader->GetNumberOfNavigationDataSnapshots());
+    for (unsigned int snapshot = 0; snapshot < numberOfSnapshots; ++snapshot)
+    {
+      auto expected = CreateNavigationDatas(snapshot);
+      auto actual = m_Reader->GetNavigationDatas(snapshot);
+      CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+      for (std::size_t tool = 0; tool < expected.size(); ++tool)
+      {
+        CPPUNIT_ASSERT_MESSAGE("Read navigation data equals written one",
+                               mitk::Equal(*expected[tool], *actual[tool], mitk::eps, true));
+        CPPUNIT_ASSERT_EQUAL(std::string(expected[tool]->GetName()), std::string(actual[tool]->GetName()));
+      }
+      CPPUNIT_ASSERT_EQUAL(10.0 * snapshot, m_Reader->GetNavigationDataTimeStamp(snapshot));
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    m_FileName = mitk::IOUtil::CreateTemporaryFile("StreamRecording_XXXXXX.mitkrec");
+    m_Writer = mitk::StreamRecordingWriter::New();
+    m_Reader = mitk::StreamRecordingReader::New();
+  }
+
+  void tearDown() override
+  {
+    m_Reader->Close();
+    m_Writer->Close();
+    std::remove(m_FileName.c_str());
+  }
+
+  void TestWriteAndRead()
+  {
+    mitk::Image::Pointer image0 = mitk::ImageGenerator::GenerateRandomImage<unsigned char>(64, 48, 1, 1, 0.3, 0.4);
+    mitk::Image::Pointer image1 = mitk::ImageGenerator::GenerateRandomImage<float>(16, 16, 4);
+
+    m_Writer->Open(m_FileName);
+    this->WriteNavigationDatas(5);
+    CPPUNIT_ASSERT_EQUAL(0ul, m_Writer->AddImage(image0, 12.0));
+    m_Writer->AddMessage(0, "first message", 13.0);
+    m_Writer->AddMessage(0, "second message", 14.0);
+    CPPUNIT_ASSERT_EQUAL(1ul, m_Writer->AddImage(image1, 25.0));
+    CPPUNIT_ASSERT_EQUAL(5ul, m_Writer->GetNumberOfNavigationDataSnapshots());
+    m_Writer->Close();
+
+    m_Reader->Open(m_FileName);
+    this->CheckNavigationDatas(5);
+
+    CPPUNIT_ASSERT_EQUAL(2u, m_Reader->GetNumberOfImages());
+    MITK_ASSERT_EQUAL(image0, m_Reader->GetImage(0), "Read 2D image equals written one");
+    MITK_ASSERT_EQUAL(image1, m_Reader->GetImage(1), "Read 3D image equals written one");
+    CPPUNIT_ASSERT_EQUAL(25.0, m_Reader->GetImageTimeStamp(1));
+
+    auto messages = m_Reader->GetImageMessages(0);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), messages.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("first message"), messages[0]);
+    CPPUNIT_ASSERT_EQUAL(std::string("second message"), messages[1]);
+    CPPUNIT_ASSERT(m_Reader->GetImageMessages(1).empty());
+
+    CPPUNIT_ASSERT_EQUAL(0u, m_Reader->FindNavigationDataSnapshot(-5.0));
+    CPPUNIT_ASSERT_EQUAL(2u, m_Reader->FindNavigationDataSnapshot(25.0));
+    CPPUNIT_ASSERT_EQUAL(4u, m_Reader->FindNavigationDataSnapshot(1000.0));
+    CPPUNIT_ASSERT_EQUAL(0u, m_Reader->FindImage(20.0));
+    CPPUNIT_ASSERT_EQUAL(1u, m_Reader->FindImage(25.0));
+
+    CPPUNIT_ASSERT_THROW(m_Reader->GetNavigationDatas(5), mitk::IGTException);
+  }
+
+  void TestReadWithoutIndex()
+  {
+    m_Writer->Open(m_FileName);
+    this->WriteNavigationDatas(20);
+    m_Writer->Flush();
+
+    // the writer is still open, so the file has no index yet
+    m_Reader->Open(m_FileName);
+    this->CheckNavigationDatas(20);
+    m_Reader->Close();
+
+    m_Writer->Close();
+    m_Reader->Open(m_FileName);
+    this->CheckNavigationDatas(20);
+  }
+
+  void TestReadTruncatedRecords()
+  {
+    // navigation datas record announcing 1000 tools without their data
+    this->WriteFileWithRecord(1, std::uint32_t(1000));
+    m_Reader->Open(m_FileName);
+    CPPUNIT_ASSERT_EQUAL(1u, m_Reader->GetNumberOfNavigationDataSnapshots());
+    CPPUNIT_ASSERT_THROW(m_Reader->GetNavigationDatas(0), mitk::IGTIOException);
+    m_Reader->Close();
+
+    // image record that is shorter than the image header
+    this->WriteFileWithRecord(2, std::uint64_t(0));
+    m_Reader->Open(m_FileName);
+    CPPUNIT_ASSERT_EQUAL(1u, m_Reader->GetNumberOfImages());
+    CPPUNIT_ASSERT_THROW(m_Reader->GetImage(0), mitk::IGTIOException);
+  }
+
+  void TestRecorderStreamsToFile()
+  {
+    mitk::NavigationDataSet::Pointer navigationDataSet = mitk::NavigationDataSet::New(2);
+    for (unsigned int snapshot = 0; snapshot < 10; ++snapshot)
+    {
+      navigationDataSet->AddNavigationDatas(CreateNavigationDatas(snapshot));
+    }
+
+    mitk::NavigationDataSequentialPlayer::Pointer player = mitk::NavigationDataSequentialPlayer::New();
+    player->SetNavigationDataSet(navigationDataSet);
+
+    mitk::NavigationDataRecorder::Pointer recorder = mitk::NavigationDataRecorder::New();
+    recorder->SetStandardizeTime(false);
+    recorder->ConnectTo(player);
+    recorder->SetStreamRecordingWriter(m_Writer);
+
+    m_Writer->Open(m_FileName);
+    recorder->StartRecording();
+    while (!player->IsAtEnd())
+    {
+      recorder->Update();
+      player->GoToNextSnapshot();
+    }
+    recorder->StopRecording();
+
+    CPPUNIT_ASSERT_EQUAL(10, recorder->GetNumberOfRecordedSteps());
+    CPPUNIT_ASSERT_EQUAL(0u, recorder->GetNavigationDataSet()->Size());
+
+    // after closing the writer the recorder records to its set again
+    m_Writer->Close();
+    CPPUNIT_ASSERT_EQUAL(0, recorder->GetNumberOfRecordedSteps());
+
+    m_Reader->Open(m_FileName);
+    this->CheckNavigationDatas(10);
+  }
+
+  void TestSequentialPlayerGoToTimeStamp()
+  {
+    m_Writer->Open(m_FileName);
+    this->WriteNavigationDatas(10);
+    m_Writer->Close();
+    m_Reader->Open(m_FileName);
+
+    mitk::NavigationDataSequentialPlayer::Pointer player = mitk::NavigationDataSequentialPlayer::New();
+    player->SetNavigationDataSet(m_Reader->ReadNavigationDataSet());
+
+    player->GoToTimeStamp(55.0);
+    CPPUNIT_ASSERT_EQUAL(5u, player->GetCurrentSnapshotNumber());
+    CPPUNIT_ASSERT_EQUAL(50.0, player->GetOutput(0)->GetIGTTimeStamp());
+
+    player->GoToTimeStamp(20.0);
+    CPPUNIT_ASSERT_EQUAL(2u, player->GetCurrentSnapshotNumber());
+
+    player->GoToTimeStamp(-1.0);
+    CPPUNIT_ASSERT_EQUAL(0u, player->GetCurrentSnapshotNumber());
+
+    mitk::NavigationDataSet::Pointer part = m_Reader->ReadNavigationDataSet(3, 4);
+    CPPUNIT_ASSERT_EQUAL(4u, part->Size());
+    CPPUNIT_ASSERT_EQUAL(30.0, part->GetNavigationDataForIndex(0, 0)->GetIGTTimeStamp());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkStreamRecording)
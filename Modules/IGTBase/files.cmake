@@ -10,6 +10,8 @@ set(CPP_FILES
   mitkIGTException.cpp
   mitkIGTIOException.cpp
   mitkIGTHardwareException.cpp
+  mitkStreamRecordingWriter.cpp
+  mitkStreamRecordingReader.cpp
 )
 
 if(WIN32)
@@ -0,0 +1,131 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKSTREAMRECORDINGREADER_H_HEADER_INCLUDED_
+#define MITKSTREAMRECORDINGREADER_H_HEADER_INCLUDED_
+
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include "MitkIGTBaseExports.h"
+#include "mitkCommon.h"
+#include "mitkImage.h"
+#include "mitkNavigationDataSet.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+
+namespace mitk {
+
+  /**Documentation
+  * \brief Gives random access to the data of a file written by mitk::StreamRecordingWriter.
+  *
+  * The file is mapped into memory, only the positions and time stamps of the records are
+  * read on Open(). Navigation datas and images are created from the mapped data when they
+  * are requested, so even recordings which are larger than the main memory can be played.
+  *
+  * Files which were not closed by the writer do not contain an index; the reader then
+  * scans the records and ignores a truncated last record.
+  *
+  * \ingroup IGT
+  */
+  class MITKIGTBASE_EXPORT StreamRecordingReader : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(StreamRecordingReader, itk::Object);
+    itkFactorylessNewMacro(Self)
+
+    /**
+    * \brief Maps the file into memory and reads the positions of all records.
+    * @throw mitk::IGTIOException if the file cannot be opened or is no stream recording.
+    */
+    void Open(const std::string &fileName);
+
+    void Close();
+
+    bool IsOpen() const;
+
+    unsigned int GetNumberOfNavigationDataSnapshots() const;
+
+    /**
+    * \brief Returns the navigation datas (one per tool) of the given snapshot.
+    * @throw mitk::IGTException if the index is out of range.
+    */
+    std::vector<NavigationData::Pointer> GetNavigationDatas(unsigned int index) const;
+
+    NavigationData::TimeStampType GetNavigationDataTimeStamp(unsigned int index) const;
+
+    /**
+    * \brief Returns the index of the last snapshot with a time stamp not greater than the given one,
+    * or 0 if all snapshots are later.
+    */
+    unsigned int FindNavigationDataSnapshot(NavigationData::TimeStampType timeStamp) const;
+
+    /**
+    * \brief Creates a mitk::NavigationDataSet of the snapshots [first, first + count), e.g. for
+    * mitk::NavigationDataPlayer. A count of 0 reads all snapshots from first to the end.
+    * @throw mitk::IGTException if the recording does not contain navigation datas.
+    */
+    NavigationDataSet::Pointer ReadNavigationDataSet(unsigned int first = 0, unsigned int count = 0) const;
+
+    unsigned int GetNumberOfImages() const;
+
+    /**
+    * \brief Creates the image with the given index.
+    * @throw mitk::IGTException if the index is out of range.
+    */
+    mitk::Image::Pointer GetImage(unsigned int index) const;
+
+    double GetImageTimeStamp(unsigned int index) const;
+
+    /**
+    * \brief Returns the messages which were added to the image with the given index.
+    */
+    std::vector<std::string> GetImageMessages(unsigned int index) const;
+
+    /**
+    * \brief Returns the index of the last image with a time stamp not greater than the given one,
+    * or 0 if all images are later.
+    */
+    unsigned int FindImage(double timeStamp) const;
+
+  protected:
+    StreamRecordingReader();
+    ~StreamRecordingReader() override;
+
+    struct MappedFile;
+
+    struct Entry
+    {
+      std::uint64_t m_PayloadOffset;
+      std::uint64_t m_PayloadSize;
+      double m_TimeStamp;
+    };
+
+    /** Reads the positions of the records from the index at the end of the file, false if there is no valid index */
+    bool ReadIndex();
+
+    /** Reads the positions of the records by visiting every record header */
+    void ScanRecords();
+
+    void AddRecord(std::uint32_t type, std::uint64_t offset, std::uint64_t payloadSize, double timeStamp);
+
+    static unsigned int FindEntry(const std::vector<Entry> &entries, double timeStamp);
+
+    std::unique_ptr<MappedFile> m_File;
+    std::vector<Entry> m_NavigationDataEntries;
+    std::vector<Entry> m_ImageEntries;
+    std::multimap<unsigned int, std::string> m_Messages; ///< messages by image index
+  };
+} // namespace mitk
+
+#endif /* MITKSTREAMRECORDINGREADER_H_HEADER_INCLUDED_ */
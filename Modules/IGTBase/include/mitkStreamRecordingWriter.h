@@ -0,0 +1,164 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKSTREAMRECORDINGWRITER_H_HEADER_INCLUDED_
+#define MITKSTREAMRECORDINGWRITER_H_HEADER_INCLUDED_
+
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include "MitkIGTBaseExports.h"
+#include "mitkCommon.h"
+#include "mitkImage.h"
+#include "mitkNavigationData.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace mitk {
+
+  /**Documentation
+  * \brief Appends navigation datas, image frames and messages to a single binary file.
+  *
+  * The calling thread only serializes the data into a buffer, a background thread appends
+  * the buffers to the file. So recording does not keep the data in memory and there is
+  * nothing left to do when the recording ends. All Add methods are thread safe, hence a
+  * mitk::NavigationDataRecorder and a mitk::USImageLoggingFilter can share one writer to
+  * record a tracked ultrasound session into one file.
+  *
+  * If the disc is slower than the data arrives, the Add methods block as soon as the
+  * buffers waiting for the background thread exceed the maximum queue size.
+  *
+  * After Flush() all data added before is in the file and can be read by
+  * mitk::StreamRecordingReader. Close() additionally writes an index, which allows the
+  * reader to open large files without scanning them.
+  *
+  * \ingroup IGT
+  */
+  class MITKIGTBASE_EXPORT StreamRecordingWriter : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(StreamRecordingWriter, itk::Object);
+    itkFactorylessNewMacro(Self)
+
+    /**
+    * \brief Creates the file (an existing file is overwritten) and starts the background thread.
+    * @throw mitk::IGTIOException if the writer is already open or the file cannot be created.
+    */
+    void Open(const std::string &fileName);
+
+    /**
+    * \brief Writes the remaining data and the index and closes the file.
+    * Does nothing if the writer is not open.
+    * @throw mitk::IGTIOException if writing to the file failed at some point.
+    */
+    void Close();
+
+    bool IsOpen() const;
+
+    /**
+    * \brief Waits until all data added before is written to the file.
+    */
+    void Flush();
+
+    /**
+    * \brief Appends one snapshot of navigation datas, i.e. one navigation data per tool.
+    * @param timeStamp time stamp which is used to seek in the recording, usually the IGT time stamp of the first tool
+    * @throw mitk::IGTException if the writer is not open.
+    */
+    void AddNavigationDatas(const std::vector<NavigationData::Pointer> &navigationDatas,
+                            NavigationData::TimeStampType timeStamp);
+
+    /**
+    * \brief Appends the first time step of an image.
+    * @return index of the image in the recording, used by AddMessage()
+    * @throw mitk::IGTException if the writer is not open or the image is not initialized.
+    */
+    unsigned long AddImage(const mitk::Image *image, double timeStamp);
+
+    /**
+    * \brief Appends a message which belongs to the image with the given index.
+    * @throw mitk::IGTException if the writer is not open.
+    */
+    void AddMessage(unsigned long imageIndex, const std::string &message, double timeStamp);
+
+    /**
+    * \brief Number of navigation data snapshots added since Open().
+    */
+    unsigned long GetNumberOfNavigationDataSnapshots() const;
+
+    /**
+    * \brief Number of images added since Open().
+    */
+    unsigned long GetNumberOfImages() const;
+
+    /**
+    * \brief Sets the maximum number of bytes which wait for the background thread. Default is 256 MB.
+    */
+    void SetMaximumQueueSize(std::size_t size);
+    std::size_t GetMaximumQueueSize() const;
+
+  protected:
+    StreamRecordingWriter();
+    ~StreamRecordingWriter() override;
+
+    struct Record
+    {
+      std::uint32_t m_Type;
+      double m_TimeStamp;
+      std::vector<char> m_Payload;
+    };
+
+    struct IndexEntry
+    {
+      std::uint64_t m_Offset;
+      std::uint32_t m_Type;
+      double m_TimeStamp;
+    };
+
+    /**
+    * \brief Hands a record to the background thread, waits while the queue is full
+    * @return index of the record among the records of its type
+    */
+    unsigned long Enqueue(std::uint32_t type, double timeStamp, std::vector<char> &&payload);
+
+    /** Main function of the background thread */
+    void Run();
+
+    void WriteRecord(const Record &record);
+    void WriteIndex();
+
+    std::ofstream m_Stream;
+    std::thread m_Thread;
+
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    std::deque<Record> m_Queue;
+    std::size_t m_QueueSize; ///< bytes waiting in m_Queue
+    std::size_t m_MaximumQueueSize;
+    bool m_Open;
+    bool m_Stop;
+    bool m_FlushRequested;
+    bool m_Failed;
+    unsigned long m_NumberOfNavigationDataSnapshots;
+    unsigned long m_NumberOfImages;
+
+    // only accessed by the background thread while the writer is open
+    std::vector<IndexEntry> m_Index;
+    std::uint64_t m_Offset;
+  };
+} // namespace mitk
+
+#endif /* MITKSTREAMRECORDINGWRITER_H_HEADER_INCLUDED_ */
@@ -0,0 +1,89 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKSTREAMRECORDINGFORMAT_H_HEADER_INCLUDED_
+#define MITKSTREAMRECORDINGFORMAT_H_HEADER_INCLUDED_
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace mitk
+{
+  /**
+  * \brief Layout of the files written by mitk::StreamRecordingWriter and read by mitk::StreamRecordingReader.
+  *
+  * A file starts with a header (magic and version), followed by records. Every record consists of a
+  * record header (type, payload size, time stamp) and its payload. When the file is closed properly, an
+  * index with one entry per record and a trailer follow the last record. Files without a valid trailer,
+  * e.g. after a crash, are read by scanning the record headers.
+  *
+  * All values are stored in the byte order of the writing machine and without padding.
+  *
+  * Payloads:
+  * - NavigationDatas: uint32 number of tools, per tool position (3 doubles), orientation (x, y, z, r),
+  *   covariance matrix (36 doubles), IGT time stamp (double), flags (uint8: valid, has position,
+  *   has orientation) and name (uint32 length, characters)
+  * - Image: itk component type (int32), number of components (uint32), dimension (uint32), size (3 uint32),
+  *   index to world matrix (9 doubles), offset (3 doubles), pixel data of the first time step
+  * - Message: index of the image (uint64) and the characters of the message
+  */
+  namespace StreamRecordingFormat
+  {
+    const char FileMagic[8] = {'M', 'I', 'T', 'K', 'R', 'E', 'C', '\0'};
+    const char IndexMagic[8] = {'M', 'I', 'T', 'K', 'I', 'D', 'X', '\0'};
+    const std::uint32_t Version = 1;
+
+    const std::size_t FileHeaderSize = sizeof(FileMagic) + 2 * sizeof(std::uint32_t);
+    const std::size_t RecordHeaderSize = 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t) + sizeof(double);
+    const std::size_t IndexEntrySize = sizeof(std::uint64_t) + 2 * sizeof(std::uint32_t) + sizeof(double);
+    const std::size_t TrailerSize = 2 * sizeof(std::uint64_t) + sizeof(IndexMagic);
+
+    /** Size of the fixed part of a tool in a NavigationDatas payload (everything but the characters of the name) */
+    const std::size_t NavigationDataSize =
+      (3 + 4 + 36 + 1) * sizeof(double) + sizeof(std::uint8_t) + sizeof(std::uint32_t);
+    /** Size of an Image payload without the pixel data */
+    const std::size_t ImageHeaderSize = sizeof(std::int32_t) + 5 * sizeof(std::uint32_t) + 12 * sizeof(double);
+
+    enum RecordType : std::uint32_t
+    {
+      NavigationDatasRecord = 1,
+      ImageRecord = 2,
+      MessageRecord = 3
+    };
+
+    template <typename T>
+    void Append(std::vector<char> &buffer, const T &value)
+    {
+      const char *bytes = reinterpret_cast<const char *>(&value);
+      buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    inline void Append(std::vector<char> &buffer, const void *data, std::size_t size)
+    {
+      const char *bytes = static_cast<const char *>(data);
+      buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    /** Reads a value from a possibly unaligned position and advances the position */
+    template <typename T>
+    T Read(const char *&position)
+    {
+      T value;
+      std::memcpy(&value, position, sizeof(T));
+      position += sizeof(T);
+      return value;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,493 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkStreamRecordingReader.h"
+#include "mitkStreamRecordingFormat.h"
+
+#include "mitkIGTIOException.h"
+
+#include <itkImageIOBase.h>
+#include <vtkImageData.h>
+#include <vtkSmartPointer.h>
+#include <vtkType.h>
+
+#include <algorithm>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Format = mitk::StreamRecordingFormat;
+
+/** Read only memory mapping of a whole file */
+struct mitk::StreamRecordingReader::MappedFile
+{
+  const char *m_Data = nullptr;
+  std::uint64_t m_Size = 0;
+#ifdef _WIN32
+  HANDLE m_File = INVALID_HANDLE_VALUE;
+  HANDLE m_Mapping = nullptr;
+#else
+  int m_File = -1;
+#endif
+
+  MappedFile(const std::string &fileName)
+  {
+#ifdef _WIN32
+    m_File = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size;
+    if (m_File == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_File, &size))
+    {
+      this->Release();
+      mitkThrowException(mitk::IGTIOException) << "Cannot open stream recording " << fileName;
+    }
+    m_Size = static_cast<std::uint64_t>(size.QuadPart);
+    if (m_Size > 0)
+    {
+      m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      void *data = m_Mapping != nullptr ? MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+      if (data == nullptr)
+      {
+        this->Release();
+        mitkThrowException(mitk::IGTIOException) << "Cannot map stream recording " << fileName << " into memory";
+      }
+      m_Data = static_cast<const char *>(data);
+    }
+#else
+    m_File = open(fileName.c_str(), O_RDONLY);
+    struct stat status;
+    if (m_File < 0 || fstat(m_File, &status) != 0)
+    {
+      this->Release();
+      mitkThrowException(mitk::IGTIOException) << "Cannot open stream recording " << fileName;
+    }
+    m_Size = static_cast<std::uint64_t>(status.st_size);
+    if (m_Size > 0)
+    {
+      void *data = mmap(nullptr, m_Size, PROT_READ, MAP_SHARED, m_File, 0);
+      if (data == MAP_FAILED)
+      {
+        this->Release();
+        mitkThrowException(mitk::IGTIOException) << "Cannot map stream recording " << fileName << " into memory";
+      }
+      m_Data = static_cast<const char *>(data);
+    }
+#endif
+  }
+
+  ~MappedFile() { this->Release(); }
+
+  void Release()
+  {
+#ifdef _WIN32
+    if (m_Data != nullptr)
+      UnmapViewOfFile(m_Data);
+    if (m_Mapping != nullptr)
+      CloseHandle(m_Mapping);
+    if (m_File != INVALID_HANDLE_VALUE)
+      CloseHandle(m_File);
+    m_Mapping = nullptr;
+    m_File = INVALID_HANDLE_VALUE;
+#else
+    if (m_Data != nullptr)
+      munmap(const_cast<char *>(m_Data), m_Size);
+    if (m_File >= 0)
+      close(m_File);
+    m_File = -1;
+#endif
+    m_Data = nullptr;
+  }
+};
+
+namespace
+{
+  int ToVtkScalarType(int componentType)
+  {
+    switch (componentType)
+    {
+      case itk::ImageIOBase::UCHAR: return VTK_UNSIGNED_CHAR;
+      case itk::ImageIOBase::CHAR: return VTK_SIGNED_CHAR;
+      case itk::ImageIOBase::USHORT: return VTK_UNSIGNED_SHORT;
+      case itk::ImageIOBase::SHORT: return VTK_SHORT;
+      case itk::ImageIOBase::UINT: return VTK_UNSIGNED_INT;
+      case itk::ImageIOBase::INT: return VTK_INT;
+      case itk::ImageIOBase::ULONG: return VTK_UNSIGNED_LONG;
+      case itk::ImageIOBase::LONG: return VTK_LONG;
+      case itk::ImageIOBase::FLOAT: return VTK_FLOAT;
+      case itk::ImageIOBase::DOUBLE: return VTK_DOUBLE;
+      default: return VTK_VOID;
+    }
+  }
+
+  /** Checks whether numberOfBytes can be read at position without passing end */
+  bool CanRead(const char *position, const char *end, std::uint64_t numberOfBytes)
+  {
+    return numberOfBytes <= static_cast<std::uint64_t>(end - position);
+  }
+}
+
+mitk::StreamRecordingReader::StreamRecordingReader()
+{
+}
+
+mitk::StreamRecordingReader::~StreamRecordingReader()
+{
+}
+
+void mitk::StreamRecordingReader::Open(const std::string &fileName)
+{
+  this->Close();
+
+  std::unique_ptr<MappedFile> file(new MappedFile(fileName));
+  if (file->m_Size < Format::FileHeaderSize ||
+      std::memcmp(file->m_Data, Format::FileMagic, sizeof(Format::FileMagic)) != 0)
+  {
+    mitkThrowException(mitk::IGTIOException) << fileName << " is no stream recording";
+  }
+
+  const char *position = file->m_Data + sizeof(Format::FileMagic);
+  const auto version = Format::Read<std::uint32_t>(position);
+  if (version > Format::Version)
+  {
+    mitkThrowException(mitk::IGTIOException) << "Stream recording " << fileName << " has the unsupported version "
+                                             << version;
+  }
+
+  m_File = std::move(file);
+  if (!this->ReadIndex())
+  {
+    MITK_WARN << "Stream recording " << fileName << " has no index, it was probably not closed. Scanning the records.";
+    this->ScanRecords();
+  }
+}
+
+void mitk::StreamRecordingReader::Close()
+{
+  m_File.reset();
+  m_NavigationDataEntries.clear();
+  m_ImageEntries.clear();
+  m_Messages.clear();
+}
+
+bool mitk::StreamRecordingReader::IsOpen() const
+{
+  return m_File != nullptr;
+}
+
+bool mitk::StreamRecordingReader::ReadIndex()
+{
+  const std::uint64_t size = m_File->m_Size;
+  if (size < Format::FileHeaderSize + Format::TrailerSize)
+    return false;
+
+  const char *position = m_File->m_Data + size - Format::TrailerSize;
+  const auto indexOffset = Format::Read<std::uint64_t>(position);
+  const auto numberOfRecords = Format::Read<std::uint64_t>(position);
+  if (std::memcmp(position, Format::IndexMagic, sizeof(Format::IndexMagic)) != 0 ||
+      indexOffset < Format::FileHeaderSize ||
+      numberOfRecords > (size - Format::TrailerSize - indexOffset) / Format::IndexEntrySize ||
+      indexOffset + numberOfRecords * Format::IndexEntrySize + Format::TrailerSize != size)
+    return false;
+
+  position = m_File->m_Data + indexOffset;
+  for (std::uint64_t i = 0; i < numberOfRecords; ++i)
+  {
+    const auto offset = Format::Read<std::uint64_t>(position);
+    const auto type = Format::Read<std::uint32_t>(position);
+    Format::Read<std::uint32_t>(position);
+    const auto timeStamp = Format::Read<double>(position);
+
+    std::uint64_t payloadSize = 0;
+    if (offset + Format::RecordHeaderSize <= indexOffset)
+    {
+      const char *header = m_File->m_Data + offset + 2 * sizeof(std::uint32_t);
+      payloadSize = Format::Read<std::uint64_t>(header);
+    }
+    if (offset + Format::RecordHeaderSize > indexOffset ||
+        payloadSize > indexOffset - offset - Format::RecordHeaderSize)
+    {
+      m_NavigationDataEntries.clear();
+      m_ImageEntries.clear();
+      m_Messages.clear();
+      return false;
+    }
+    this->AddRecord(type, offset + Format::RecordHeaderSize, payloadSize, timeStamp);
+  }
+  return true;
+}
+
+void mitk::StreamRecordingReader::ScanRecords()
+{
+  const std::uint64_t size = m_File->m_Size;
+  std::uint64_t offset = Format::FileHeaderSize;
+  while (offset + Format::RecordHeaderSize <= size)
+  {
+    const char *position = m_File->m_Data + offset;
+    const auto type = Format::Read<std::uint32_t>(position);
+    Format::Read<std::uint32_t>(position);
+    const auto payloadSize = Format::Read<std::uint64_t>(position);
+    const auto timeStamp = Format::Read<double>(position);
+
+    const std::uint64_t payloadOffset = offset + Format::RecordHeaderSize;
+    if (payloadSize > size - payloadOffset)
+      break; // truncated record
+
+    this->AddRecord(type, payloadOffset, payloadSize, timeStamp);
+    offset = payloadOffset + payloadSize;
+  }
+}
+
+void mitk::StreamRecordingReader::AddRecord(std::uint32_t type,
+                                            std::uint64_t offset,
+                                            std::uint64_t payloadSize,
+                                            double timeStamp)
+{
+  switch (type)
+  {
+    case Format::NavigationDatasRecord:
+      m_NavigationDataEntries.push_back(Entry{offset, payloadSize, timeStamp});
+      break;
+    case Format::ImageRecord:
+      m_ImageEntries.push_back(Entry{offset, payloadSize, timeStamp});
+      break;
+    case Format::MessageRecord:
+      if (payloadSize >= sizeof(std::uint64_t))
+      {
+        const char *position = m_File->m_Data + offset;
+        const auto imageIndex = Format::Read<std::uint64_t>(position);
+        m_Messages.emplace(static_cast<unsigned int>(imageIndex),
+                           std::string(position, payloadSize - sizeof(std::uint64_t)));
+      }
+      break;
+    default:
+      // records of later versions are skipped
+      break;
+  }
+}
+
+unsigned int mitk::StreamRecordingReader::GetNumberOfNavigationDataSnapshots() const
+{
+  return static_cast<unsigned int>(m_NavigationDataEntries.size());
+}
+
+std::vector<mitk::NavigationData::Pointer> mitk::StreamRecordingReader::GetNavigationDatas(unsigned int index) const
+{
+  if (index >= m_NavigationDataEntries.size())
+  {
+    mitkThrowException(mitk::IGTException) << "Navigation data snapshot " << index << " does not exist.";
+  }
+
+  const Entry &entry = m_NavigationDataEntries[index];
+  const char *position = m_File->m_Data + entry.m_PayloadOffset;
+  const char *end = position + entry.m_PayloadSize;
+
+  if (!CanRead(position, end, sizeof(std::uint32_t)))
+  {
+    mitkThrowException(mitk::IGTIOException) << "Navigation data snapshot " << index << " is corrupt.";
+  }
+  const auto numberOfTools = Format::Read<std::uint32_t>(position);
+  if (numberOfTools > static_cast<std::uint64_t>(end - position) / Format::NavigationDataSize)
+  {
+    mitkThrowException(mitk::IGTIOException) << "Navigation data snapshot " << index << " is corrupt.";
+  }
+
+  std::vector<NavigationData::Pointer> navigationDatas;
+  navigationDatas.reserve(numberOfTools);
+  for (std::uint32_t tool = 0; tool < numberOfTools; ++tool)
+  {
+    if (!CanRead(position, end, Format::NavigationDataSize))
+    {
+      mitkThrowException(mitk::IGTIOException) << "Navigation data snapshot " << index << " is corrupt.";
+    }
+
+    NavigationData::PositionType point;
+    for (unsigned int i = 0; i < 3; ++i)
+      point[i] = Format::Read<double>(position);
+    NavigationData::OrientationType orientation;
+    for (unsigned int i = 0; i < 4; ++i)
+      orientation[i] = Format::Read<double>(position);
+    NavigationData::CovarianceMatrixType covariance;
+    for (unsigned int row = 0; row < 6; ++row)
+      for (unsigned int column = 0; column < 6; ++column)
+        covariance[row][column] = Format::Read<double>(position);
+    const auto igtTimeStamp = Format::Read<double>(position);
+    const auto flags = Format::Read<std::uint8_t>(position);
+    const auto nameLength = Format::Read<std::uint32_t>(position);
+    if (!CanRead(position, end, nameLength))
+    {
+      mitkThrowException(mitk::IGTIOException) << "Navigation data snapshot " << index << " is corrupt.";
+    }
+
+    NavigationData::Pointer navigationData = NavigationData::New();
+    navigationData->SetPosition(point);
+    navigationData->SetOrientation(orientation);
+    navigationData->SetCovErrorMatrix(covariance);
+    navigationData->SetIGTTimeStamp(igtTimeStamp);
+    navigationData->SetDataValid((flags & 1) != 0);
+    navigationData->SetHasPosition((flags & 2) != 0);
+    navigationData->SetHasOrientation((flags & 4) != 0);
+    navigationData->SetName(std::string(position, nameLength));
+    position += nameLength;
+
+    navigationDatas.push_back(navigationData);
+  }
+  return navigationDatas;
+}
+
+mitk::NavigationData::TimeStampType mitk::StreamRecordingReader::GetNavigationDataTimeStamp(unsigned int index) const
+{
+  if (index >= m_NavigationDataEntries.size())
+  {
+    mitkThrowException(mitk::IGTException) << "Navigation data snapshot " << index << " does not exist.";
+  }
+  return m_NavigationDataEntries[index].m_TimeStamp;
+}
+
+unsigned int mitk::StreamRecordingReader::FindNavigationDataSnapshot(NavigationData::TimeStampType timeStamp) const
+{
+  return FindEntry(m_NavigationDataEntries, timeStamp);
+}
+
+mitk::NavigationDataSet::Pointer mitk::StreamRecordingReader::ReadNavigationDataSet(unsigned int first,
+                                                                                   unsigned int count) const
+{
+  if (m_NavigationDataEntries.empty())
+  {
+    mitkThrowException(mitk::IGTException) << "The stream recording contains no navigation datas.";
+  }
+
+  const unsigned int end = count == 0 ? this->GetNumberOfNavigationDataSnapshots()
+                                      : std::min(first + count, this->GetNumberOfNavigationDataSnapshots());
+  const auto numberOfTools = static_cast<unsigned int>(this->GetNavigationDatas(0).size());
+
+  NavigationDataSet::Pointer navigationDataSet = NavigationDataSet::New(numberOfTools);
+  for (unsigned int index = first; index < end; ++index)
+  {
+    navigationDataSet->AddNavigationDatas(this->GetNavigationDatas(index));
+  }
+  return navigationDataSet;
+}
+
+unsigned int mitk::StreamRecordingReader::GetNumberOfImages() const
+{
+  return static_cast<unsigned int>(m_ImageEntries.size());
+}
+
+mitk::Image::Pointer mitk::StreamRecordingReader::GetImage(unsigned int index) const
+{
+  if (index >= m_ImageEntries.size())
+  {
+    mitkThrowException(mitk::IGTException) << "Image " << index << " does not exist.";
+  }
+
+  const Entry &entry = m_ImageEntries[index];
+  const char *position = m_File->m_Data + entry.m_PayloadOffset;
+  const char *end = position + entry.m_PayloadSize;
+  if (!CanRead(position, end, Format::ImageHeaderSize))
+  {
+    mitkThrowException(mitk::IGTIOException) << "Image " << index << " is corrupt.";
+  }
+
+  const auto componentType = Format::Read<std::int32_t>(position);
+  const auto numberOfComponents = Format::Read<std::uint32_t>(position);
+  const auto dimension = Format::Read<std::uint32_t>(position);
+  unsigned int size[3];
+  for (unsigned int i = 0; i < 3; ++i)
+    size[i] = Format::Read<std::uint32_t>(position);
+
+  mitk::AffineTransform3D::MatrixType matrix;
+  for (unsigned int row = 0; row < 3; ++row)
+    for (unsigned int column = 0; column < 3; ++column)
+      matrix[row][column] = Format::Read<double>(position);
+  mitk::AffineTransform3D::OutputVectorType offset;
+  for (unsigned int i = 0; i < 3; ++i)
+    offset[i] = Format::Read<double>(position);
+
+  const int scalarType = ToVtkScalarType(componentType);
+  if (scalarType == VTK_VOID || dimension < 1 || dimension > 3)
+  {
+    mitkThrowException(mitk::IGTIOException) << "Image " << index << " has an unsupported pixel type or dimension.";
+  }
+
+  // a single voxel is enough to derive the pixel type
+  vtkSmartPointer<vtkImageData> pixelTypeImage = vtkSmartPointer<vtkImageData>::New();
+  pixelTypeImage->SetDimensions(1, 1, 1);
+  pixelTypeImage->AllocateScalars(scalarType, static_cast<int>(numberOfComponents));
+  const mitk::PixelType pixelType = mitk::MakePixelType(pixelTypeImage);
+
+  // checked factor by factor, the product of the stored sizes may exceed 64 bit
+  const std::uint64_t remainingBytes = static_cast<std::uint64_t>(end - position);
+  std::uint64_t numberOfBytes = pixelType.GetSize();
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (size[i] != 0 && numberOfBytes > remainingBytes / size[i])
+    {
+      mitkThrowException(mitk::IGTIOException) << "Image " << index << " is corrupt.";
+    }
+    numberOfBytes *= size[i];
+  }
+  if (numberOfBytes > remainingBytes)
+  {
+    mitkThrowException(mitk::IGTIOException) << "Image " << index << " is corrupt.";
+  }
+
+  mitk::Image::Pointer image = mitk::Image::New();
+  image->Initialize(pixelType, dimension, size);
+  image->SetImportVolume(position, 0, 0);
+
+  mitk::AffineTransform3D::Pointer transform = mitk::AffineTransform3D::New();
+  transform->SetMatrix(matrix);
+  transform->SetOffset(offset);
+  image->GetGeometry()->SetIndexToWorldTransform(transform);
+
+  return image;
+}
+
+double mitk::StreamRecordingReader::GetImageTimeStamp(unsigned int index) const
+{
+  if (index >= m_ImageEntries.size())
+  {
+    mitkThrowException(mitk::IGTException) << "Image " << index << " does not exist.";
+  }
+  return m_ImageEntries[index].m_TimeStamp;
+}
+
+std::vector<std::string> mitk::StreamRecordingReader::GetImageMessages(unsigned int index) const
+{
+  std::vector<std::string> messages;
+  const auto range = m_Messages.equal_range(index);
+  for (auto it = range.first; it != range.second; ++it)
+    messages.push_back(it->second);
+  return messages;
+}
+
+unsigned int mitk::StreamRecordingReader::FindImage(double timeStamp) const
+{
+  return FindEntry(m_ImageEntries, timeStamp);
+}
+
+unsigned int mitk::StreamRecordingReader::FindEntry(const std::vector<Entry> &entries, double timeStamp)
+{
+  const auto it = std::upper_bound(entries.begin(), entries.end(), timeStamp, [](double value, const Entry &entry) {
+    return value < entry.m_TimeStamp;
+  });
+  return it == entries.begin() ? 0 : static_cast<unsigned int>(it - entries.begin() - 1);
+}
@@ -0,0 +1,343 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkStreamRecordingWriter.h"
+#include "mitkStreamRecordingFormat.h"
+
+#include "mitkIGTIOException.h"
+#include "mitkImageReadAccessor.h"
+
+#include <algorithm>
+
+namespace Format = mitk::StreamRecordingFormat;
+
+mitk::StreamRecordingWriter::StreamRecordingWriter()
+  : m_QueueSize(0),
+    m_MaximumQueueSize(256 * 1024 * 1024),
+    m_Open(false),
+    m_Stop(false),
+    m_FlushRequested(false),
+    m_Failed(false),
+    m_NumberOfNavigationDataSnapshots(0),
+    m_NumberOfImages(0),
+    m_Offset(0)
+{
+}
+
+mitk::StreamRecordingWriter::~StreamRecordingWriter()
+{
+  try
+  {
+    this->Close();
+  }
+  catch (const mitk::Exception &e)
+  {
+    MITK_ERROR << e.GetDescription();
+  }
+}
+
+void mitk::StreamRecordingWriter::Open(const std::string &fileName)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (m_Open)
+  {
+    mitkThrowException(mitk::IGTIOException) << "Stream recording writer is already open, close it before opening "
+                                             << fileName;
+  }
+
+  m_Stream.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_Stream.is_open())
+  {
+    mitkThrowException(mitk::IGTIOException) << "Cannot create stream recording " << fileName;
+  }
+
+  m_Stream.write(Format::FileMagic, sizeof(Format::FileMagic));
+  const std::uint32_t header[2] = {Format::Version, 0};
+  m_Stream.write(reinterpret_cast<const char *>(header), sizeof(header));
+
+  m_Index.clear();
+  m_Offset = Format::FileHeaderSize;
+  m_QueueSize = 0;
+  m_Stop = false;
+  m_FlushRequested = false;
+  m_Failed = !m_Stream.good();
+  m_NumberOfNavigationDataSnapshots = 0;
+  m_NumberOfImages = 0;
+  m_Open = true;
+
+  m_Thread = std::thread(&StreamRecordingWriter::Run, this);
+}
+
+void mitk::StreamRecordingWriter::Close()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (!m_Open)
+      return;
+    m_Stop = true;
+  }
+  m_Condition.notify_all();
+  m_Thread.join();
+
+  // the background thread has finished, so the stream and the index are ours
+  this->WriteIndex();
+  m_Stream.close();
+
+  bool failed;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Open = false;
+    failed = m_Failed || m_Stream.fail();
+  }
+  m_Condition.notify_all();
+
+  if (failed)
+  {
+    mitkThrowException(mitk::IGTIOException) << "Writing the stream recording failed, the file is incomplete.";
+  }
+}
+
+bool mitk::StreamRecordingWriter::IsOpen() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Open;
+}
+
+void mitk::StreamRecordingWriter::Flush()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  if (!m_Open)
+    return;
+  m_FlushRequested = true;
+  m_Condition.notify_all();
+  m_Condition.wait(lock, [this] { return !m_FlushRequested || !m_Open; });
+}
+
+void mitk::StreamRecordingWriter::AddNavigationDatas(const std::vector<NavigationData::Pointer> &navigationDatas,
+                                                     NavigationData::TimeStampType timeStamp)
+{
+  std::vector<char> payload;
+  payload.reserve(sizeof(std::uint32_t) + navigationDatas.size() * 400);
+  Format::Append(payload, static_cast<std::uint32_t>(navigationDatas.size()));
+
+  for (const auto &navigationData : navigationDatas)
+  {
+    const NavigationData::PositionType position = navigationData->GetPosition();
+    const NavigationData::OrientationType orientation = navigationData->GetOrientation();
+    const NavigationData::CovarianceMatrixType covariance = navigationData->GetCovErrorMatrix();
+
+    for (unsigned int i = 0; i < 3; ++i)
+      Format::Append(payload, static_cast<double>(position[i]));
+    for (unsigned int i = 0; i < 4; ++i)
+      Format::Append(payload, static_cast<double>(orientation[i]));
+    for (unsigned int row = 0; row < 6; ++row)
+      for (unsigned int column = 0; column < 6; ++column)
+        Format::Append(payload, static_cast<double>(covariance[row][column]));
+    Format::Append(payload, static_cast<double>(navigationData->GetIGTTimeStamp()));
+
+    const std::uint8_t flags = (navigationData->IsDataValid() ? 1 : 0) | (navigationData->GetHasPosition() ? 2 : 0) |
+                               (navigationData->GetHasOrientation() ? 4 : 0);
+    Format::Append(payload, flags);
+
+    const std::string name = navigationData->GetName() != nullptr ? navigationData->GetName() : "";
+    Format::Append(payload, static_cast<std::uint32_t>(name.size()));
+    Format::Append(payload, name.data(), name.size());
+  }
+
+  this->Enqueue(Format::NavigationDatasRecord, timeStamp, std::move(payload));
+}
+
+unsigned long mitk::StreamRecordingWriter::AddImage(const mitk::Image *image, double timeStamp)
+{
+  if (image == nullptr || !image->IsInitialized())
+  {
+    mitkThrowException(mitk::IGTException) << "Cannot add an image which is not initialized to the stream recording.";
+  }
+
+  const mitk::PixelType pixelType = image->GetPixelType();
+  const unsigned int dimension = std::min(image->GetDimension(), 3u);
+  std::uint32_t size[3] = {1, 1, 1};
+  for (unsigned int i = 0; i < dimension; ++i)
+    size[i] = image->GetDimension(i);
+  const std::uint64_t numberOfBytes =
+    static_cast<std::uint64_t>(size[0]) * size[1] * size[2] * pixelType.GetSize();
+
+  const mitk::AffineTransform3D *transform = image->GetGeometry()->GetIndexToWorldTransform();
+
+  std::vector<char> payload;
+  payload.reserve(128 + numberOfBytes);
+  Format::Append(payload, static_cast<std::int32_t>(pixelType.GetComponentType()));
+  Format::Append(payload, static_cast<std::uint32_t>(pixelType.GetNumberOfComponents()));
+  Format::Append(payload, static_cast<std::uint32_t>(dimension));
+  Format::Append(payload, size, sizeof(size));
+  for (unsigned int row = 0; row < 3; ++row)
+    for (unsigned int column = 0; column < 3; ++column)
+      Format::Append(payload, static_cast<double>(transform->GetMatrix()[row][column]));
+  for (unsigned int i = 0; i < 3; ++i)
+    Format::Append(payload, static_cast<double>(transform->GetOffset()[i]));
+
+  {
+    mitk::ImageReadAccessor readAccess(image, image->GetVolumeData(0));
+    Format::Append(payload, readAccess.GetData(), numberOfBytes);
+  }
+
+  return this->Enqueue(Format::ImageRecord, timeStamp, std::move(payload));
+}
+
+void mitk::StreamRecordingWriter::AddMessage(unsigned long imageIndex, const std::string &message, double timeStamp)
+{
+  std::vector<char> payload;
+  payload.reserve(sizeof(std::uint64_t) + message.size());
+  Format::Append(payload, static_cast<std::uint64_t>(imageIndex));
+  Format::Append(payload, message.data(), message.size());
+
+  this->Enqueue(Format::MessageRecord, timeStamp, std::move(payload));
+}
+
+unsigned long mitk::StreamRecordingWriter::GetNumberOfNavigationDataSnapshots() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfNavigationDataSnapshots;
+}
+
+unsigned long mitk::StreamRecordingWriter::GetNumberOfImages() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfImages;
+}
+
+void mitk::StreamRecordingWriter::SetMaximumQueueSize(std::size_t size)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_MaximumQueueSize = size;
+  }
+  m_Condition.notify_all();
+}
+
+std::size_t mitk::StreamRecordingWriter::GetMaximumQueueSize() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MaximumQueueSize;
+}
+
+unsigned long mitk::StreamRecordingWriter::Enqueue(std::uint32_t type, double timeStamp, std::vector<char> &&payload)
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  if (!m_Open || m_Stop)
+  {
+    mitkThrowException(mitk::IGTException) << "Stream recording writer is not open.";
+  }
+
+  // a single record larger than the maximum queue size is accepted as soon as the queue is empty
+  m_Condition.wait(lock, [this, &payload] {
+    return m_Queue.empty() || m_QueueSize + payload.size() <= m_MaximumQueueSize || m_Stop;
+  });
+  if (m_Stop)
+  {
+    mitkThrowException(mitk::IGTException) << "Stream recording writer was closed while waiting for the queue.";
+  }
+
+  m_QueueSize += payload.size();
+  m_Queue.push_back(Record{type, timeStamp, std::move(payload)});
+  unsigned long index = 0;
+  if (type == Format::NavigationDatasRecord)
+    index = m_NumberOfNavigationDataSnapshots++;
+  else if (type == Format::ImageRecord)
+    index = m_NumberOfImages++;
+
+  lock.unlock();
+  m_Condition.notify_all();
+  return index;
+}
+
+void mitk::StreamRecordingWriter::Run()
+{
+  std::deque<Record> records;
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  for (;;)
+  {
+    m_Condition.wait(lock, [this] { return !m_Queue.empty() || m_FlushRequested || m_Stop; });
+
+    if (!m_Queue.empty())
+    {
+      records.swap(m_Queue);
+      lock.unlock();
+
+      for (const auto &record : records)
+        this->WriteRecord(record);
+
+      std::size_t writtenSize = 0;
+      for (const auto &record : records)
+        writtenSize += record.m_Payload.size();
+      records.clear();
+
+      lock.lock();
+      m_QueueSize -= writtenSize;
+      m_Condition.notify_all();
+    }
+    else if (m_FlushRequested)
+    {
+      m_Stream.flush();
+      m_FlushRequested = false;
+      m_Condition.notify_all();
+    }
+    else
+    {
+      // m_Stop is set and the queue is empty
+      break;
+    }
+  }
+}
+
+void mitk::StreamRecordingWriter::WriteRecord(const Record &record)
+{
+  std::vector<char> header;
+  header.reserve(Format::RecordHeaderSize);
+  Format::Append(header, record.m_Type);
+  Format::Append(header, std::uint32_t(0));
+  Format::Append(header, static_cast<std::uint64_t>(record.m_Payload.size()));
+  Format::Append(header, record.m_TimeStamp);
+
+  m_Stream.write(header.data(), header.size());
+  m_Stream.write(record.m_Payload.data(), record.m_Payload.size());
+
+  if (!m_Stream.good())
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (!m_Failed)
+      MITK_ERROR << "Writing the stream recording failed, the following data is lost.";
+    m_Failed = true;
+    return;
+  }
+
+  m_Index.push_back(IndexEntry{m_Offset, record.m_Type, record.m_TimeStamp});
+  m_Offset += header.size() + record.m_Payload.size();
+}
+
+void mitk::StreamRecordingWriter::WriteIndex()
+{
+  std::vector<char> buffer;
+  buffer.reserve(m_Index.size() * Format::IndexEntrySize + Format::TrailerSize);
+  for (const auto &entry : m_Index)
+  {
+    Format::Append(buffer, entry.m_Offset);
+    Format::Append(buffer, entry.m_Type);
+    Format::Append(buffer, std::uint32_t(0));
+    Format::Append(buffer, entry.m_TimeStamp);
+  }
+  Format::Append(buffer, m_Offset);
+  Format::Append(buffer, static_cast<std::uint64_t>(m_Index.size()));
+  Format::Append(buffer, Format::IndexMagic, sizeof(Format::IndexMagic));
+
+  m_Stream.write(buffer.data(), buffer.size());
+}
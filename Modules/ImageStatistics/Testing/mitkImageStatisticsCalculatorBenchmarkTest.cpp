@@ -0,0 +1,255 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkImageStatisticsCalculator.h"
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkExtendedLabelStatisticsImageFilter.h>
+#include <mitkITKImageImport.h>
+#include <mitkImageMaskGenerator.h>
+#include <mitkImageStatisticsConstants.h>
+#include <mitkMinMaxLabelmageFilterWithIndex.h>
+
+#include <itkImageDuplicator.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <chrono>
+#include <cmath>
+
+/**
+  Compares the single-pass multi-label statistics of mitk::ImageStatisticsCalculator with the filters
+  it used before (itk::MinMaxLabelImageFilterWithIndex and itk::ExtendedLabelStatisticsImageFilter).
+  Both must produce the same statistics. Timings of both are reported as a simple benchmark.
+*/
+class mitkImageStatisticsCalculatorBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageStatisticsCalculatorBenchmarkTestSuite);
+  MITK_TEST(TestMultiLabelStatisticsEqualLabelStatisticsFilter);
+  MITK_TEST(TestUnchangedLabelsAreSkipped);
+  MITK_TEST(TestMovedPixelsInvalidateLabel);
+  CPPUNIT_TEST_SUITE_END();
+
+  typedef itk::Image<short, 3> ImageType;
+  typedef itk::Image<unsigned short, 3> MaskType;
+
+  ImageType::Pointer m_ItkImage;
+  MaskType::Pointer m_ItkMask;
+  mitk::Image::Pointer m_Image;
+  mitk::Image::Pointer m_Mask;
+
+  static const unsigned int ImageSize = 128;
+  static const unsigned int BlockSize = 24; // results in 125 labels plus background
+
+public:
+  void setUp() override
+  {
+    ImageType::SizeType size;
+    size.Fill(ImageSize);
+    ImageType::RegionType region(size);
+
+    m_ItkImage = ImageType::New();
+    m_ItkImage->SetRegions(region);
+    m_ItkImage->Allocate();
+
+    m_ItkMask = MaskType::New();
+    m_ItkMask->SetRegions(region);
+    m_ItkMask->Allocate();
+
+    itk::ImageRegionIteratorWithIndex<ImageType> imageIt(m_ItkImage, region);
+    itk::ImageRegionIteratorWithIndex<MaskType> maskIt(m_ItkMask, region);
+    for (; !imageIt.IsAtEnd(); ++imageIt, ++maskIt)
+    {
+      auto index = imageIt.GetIndex();
+      imageIt.Set(static_cast<short>(1000 * std::sin(0.05 * index[0]) * std::cos(0.07 * index[1]) + 3 * index[2] - 200));
+
+      // blocks of labels with a background margin at the upper end of each dimension
+      if (index[0] % BlockSize == BlockSize - 1 || index[1] % BlockSize == BlockSize - 1 ||
+          index[2] % BlockSize == BlockSize - 1 || index[0] >= 5 * BlockSize || index[1] >= 5 * BlockSize ||
+          index[2] >= 5 * BlockSize)
+      {
+        maskIt.Set(0);
+      }
+      else
+      {
+        maskIt.Set(1 + index[0] / BlockSize + 5 * (index[1] / BlockSize) + 25 * (index[2] / BlockSize));
+      }
+    }
+
+    m_Image = mitk::GrabItkImageMemory(m_ItkImage.GetPointer());
+    m_Mask = mitk::GrabItkImageMemory(m_ItkMask.GetPointer());
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+    m_Mask = nullptr;
+    m_ItkImage = nullptr;
+    m_ItkMask = nullptr;
+  }
+
+  void TestMultiLabelStatisticsEqualLabelStatisticsFilter()
+  {
+    typedef itk::MinMaxLabelImageFilterWithIndex<ImageType, MaskType> MinMaxLabelFilterType;
+    typedef itk::ExtendedLabelStatisticsImageFilter<ImageType, MaskType> LabelStatisticsFilterType;
+    const unsigned int nBins = 100;
+
+    auto start = std::chrono::steady_clock::now();
+
+    MinMaxLabelFilterType::Pointer minMaxFilter = MinMaxLabelFilterType::New();
+    minMaxFilter->SetInput(m_ItkImage);
+    minMaxFilter->SetLabelInput(m_ItkMask);
+    minMaxFilter->UpdateLargestPossibleRegion();
+
+    std::map<unsigned short, unsigned int> nBinsForLabels;
+    std::map<unsigned short, short> minVals;
+    std::map<unsigned short, short> maxVals;
+    for (unsigned short label : minMaxFilter->GetRelevantLabels())
+    {
+      nBinsForLabels[label] = nBins;
+      minVals[label] = minMaxFilter->GetMin(label);
+      maxVals[label] = minMaxFilter->GetMax(label);
+    }
+
+    LabelStatisticsFilterType::Pointer labelStatisticsFilter = LabelStatisticsFilterType::New();
+    labelStatisticsFilter->SetInput(m_ItkImage);
+    labelStatisticsFilter->SetLabelInput(m_ItkMask);
+    labelStatisticsFilter->SetHistogramParametersForLabels(nBinsForLabels, minVals, maxVals);
+    labelStatisticsFilter->Update();
+
+    double filterSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+
+    mitk::ImageMaskGenerator::Pointer maskGenerator = mitk::ImageMaskGenerator::New();
+    maskGenerator->SetImageMask(m_Mask);
+    mitk::ImageStatisticsCalculator::Pointer calculator = mitk::ImageStatisticsCalculator::New();
+    calculator->SetInputImage(m_Image);
+    calculator->SetMask(maskGenerator.GetPointer());
+    calculator->SetNBinsForHistogramStatistics(nBins);
+    calculator->GetStatistics(1);
+
+    double calculatorSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    MITK_INFO << "Statistics of " << minMaxFilter->GetRelevantLabels().size() << " labels in a " << ImageSize
+              << "^3 image: label statistics filters " << filterSeconds << " s, ImageStatisticsCalculator "
+              << calculatorSeconds << " s";
+
+    for (unsigned short label : minMaxFilter->GetRelevantLabels())
+    {
+      auto statistics = calculator->GetStatistics(label)->GetStatisticsForTimeStep(0);
+      auto count =
+        statistics.GetValueConverted<mitk::ImageStatisticsContainer::VoxelCountType>(mitk::ImageStatisticsConstants::NUMBEROFVOXELS());
+      CPPUNIT_ASSERT_EQUAL(static_cast<mitk::ImageStatisticsContainer::VoxelCountType>(labelStatisticsFilter->GetCount(label)), count);
+
+      auto real = [&statistics](const std::string &name) {
+        return statistics.GetValueConverted<mitk::ImageStatisticsContainer::RealType>(name);
+      };
+      CPPUNIT_ASSERT(mitk::Equal(labelStatisticsFilter->GetMean(label), real(mitk::ImageStatisticsConstants::MEAN()), 1e-6, true));
+      CPPUNIT_ASSERT(mitk::Equal(labelStatisticsFilter->GetSigma(label), real(mitk::ImageStatisticsConstants::STANDARDDEVIATION()), 1e-6, true));
+      CPPUNIT_ASSERT(mitk::Equal(labelStatisticsFilter->GetMinimum(label), real(mitk::ImageStatisticsConstants::MINIMUM()), mitk::eps, true));
+      CPPUNIT_ASSERT(mitk::Equal(labelStatisticsFilter->GetMaximum(label), real(mitk::ImageStatisticsConstants::MAXIMUM()), mitk::eps, true));
+      CPPUNIT_ASSERT(mitk::Equal(labelStatisticsFilter->GetSkewness(label), real(mitk::ImageStatisticsConstants::SKEWNESS()), 1e-4, true));
+      CPPUNIT_ASSERT(mitk::Equal(labelStatisticsFilter->GetKurtosis(label), real(mitk::ImageStatisticsConstants::KURTOSIS()), 1e-4, true));
+      CPPUNIT_ASSERT(mitk::Equal(labelStatisticsFilter->GetMedian(label), real(mitk::ImageStatisticsConstants::MEDIAN()), mitk::eps, true));
+      CPPUNIT_ASSERT(mitk::Equal(labelStatisticsFilter->GetEntropy(label), real(mitk::ImageStatisticsConstants::ENTROPY()), 1e-6, true));
+
+      auto histogram = labelStatisticsFilter->GetHistogram(label);
+      CPPUNIT_ASSERT_EQUAL(histogram->Size(), statistics.m_Histogram->Size());
+      for (unsigned int bin = 0; bin < histogram->Size(); ++bin)
+      {
+        CPPUNIT_ASSERT_EQUAL(histogram->GetFrequency(bin), statistics.m_Histogram->GetFrequency(bin));
+      }
+    }
+  }
+
+  void TestUnchangedLabelsAreSkipped()
+  {
+    mitk::ImageMaskGenerator::Pointer maskGenerator = mitk::ImageMaskGenerator::New();
+    maskGenerator->SetImageMask(m_Mask);
+    mitk::ImageStatisticsCalculator::Pointer calculator = mitk::ImageStatisticsCalculator::New();
+    calculator->SetInputImage(m_Image);
+    calculator->SetMask(maskGenerator.GetPointer());
+
+    mitk::ImageStatisticsContainer::Pointer unchangedContainer = calculator->GetStatistics(1);
+    mitk::ImageStatisticsContainer::Pointer changedContainer = calculator->GetStatistics(2);
+    auto unchangedTime = unchangedContainer->GetMTime();
+    auto countBefore = changedContainer->GetStatisticsForTimeStep(0).GetValueConverted<mitk::ImageStatisticsContainer::VoxelCountType>(
+      mitk::ImageStatisticsConstants::NUMBEROFVOXELS());
+
+    // move one pixel from label 2 to the background
+    MaskType::IndexType index;
+    index[0] = BlockSize;
+    index[1] = 0;
+    index[2] = 0;
+    typedef itk::ImageDuplicator<MaskType> DuplicatorType;
+    DuplicatorType::Pointer duplicator = DuplicatorType::New();
+    duplicator->SetInputImage(m_ItkMask);
+    duplicator->Update();
+    MaskType::Pointer itkChangedMask = duplicator->GetOutput();
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(2), itkChangedMask->GetPixel(index));
+    itkChangedMask->SetPixel(index, 0);
+    mitk::Image::Pointer changedMask = mitk::GrabItkImageMemory(itkChangedMask.GetPointer());
+    maskGenerator->SetImageMask(changedMask);
+
+    auto countAfter = calculator->GetStatistics(2)->GetStatisticsForTimeStep(0).GetValueConverted<mitk::ImageStatisticsContainer::VoxelCountType>(
+      mitk::ImageStatisticsConstants::NUMBEROFVOXELS());
+    CPPUNIT_ASSERT_EQUAL(countBefore - 1, countAfter);
+
+    // label 1 still covers the same pixels, its statistics are kept and no further calculation is triggered
+    CPPUNIT_ASSERT(calculator->GetStatistics(1) == unchangedContainer.GetPointer());
+    CPPUNIT_ASSERT_EQUAL(unchangedTime, unchangedContainer->GetMTime());
+
+    // a changed image invalidates all labels
+    m_Image->Modified();
+    calculator->GetStatistics(1);
+    CPPUNIT_ASSERT(unchangedContainer->GetMTime() > unchangedTime);
+  }
+
+  void TestMovedPixelsInvalidateLabel()
+  {
+    mitk::ImageMaskGenerator::Pointer maskGenerator = mitk::ImageMaskGenerator::New();
+    maskGenerator->SetImageMask(m_Mask);
+    mitk::ImageStatisticsCalculator::Pointer calculator = mitk::ImageStatisticsCalculator::New();
+    calculator->SetInputImage(m_Image);
+    calculator->SetMask(maskGenerator.GetPointer());
+
+    mitk::ImageStatisticsContainer::Pointer unchangedContainer = calculator->GetStatistics(1);
+    mitk::ImageStatisticsContainer::Pointer movedContainer = calculator->GetStatistics(2);
+    auto unchangedTime = unchangedContainer->GetMTime();
+    auto movedTime = movedContainer->GetMTime();
+
+    // label 2 loses one pixel to the background and gains another one, so its voxel count does not change
+    typedef itk::ImageDuplicator<MaskType> DuplicatorType;
+    DuplicatorType::Pointer duplicator = DuplicatorType::New();
+    duplicator->SetInputImage(m_ItkMask);
+    duplicator->Update();
+    MaskType::Pointer itkChangedMask = duplicator->GetOutput();
+    MaskType::IndexType removedIndex;
+    removedIndex[0] = BlockSize;
+    removedIndex[1] = 0;
+    removedIndex[2] = 0;
+    MaskType::IndexType addedIndex = removedIndex;
+    addedIndex[0] = 2 * BlockSize - 1;
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(0), itkChangedMask->GetPixel(addedIndex));
+    itkChangedMask->SetPixel(removedIndex, 0);
+    itkChangedMask->SetPixel(addedIndex, 2);
+    mitk::Image::Pointer changedMask = mitk::GrabItkImageMemory(itkChangedMask.GetPointer());
+    maskGenerator->SetImageMask(changedMask);
+
+    calculator->GetStatistics(2);
+    CPPUNIT_ASSERT(movedContainer->GetMTime() > movedTime);
+    CPPUNIT_ASSERT_EQUAL(unchangedTime, unchangedContainer->GetMTime());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageStatisticsCalculatorBenchmark)
@@ -23,6 +23,14 @@ found in the LICENSE file.
 #include <mitkImageStatisticsContainerNodeHelper.h>
 #include <mitkStatisticsToImageRelationRule.h>
 #include <mitkStatisticsToMaskRelationRule.h>
+#include <mitkImageStatisticsCalculator.h>
+#include <mitkImageStatisticsConstants.h>
+#include <mitkImageMaskGenerator.h>
+#include <mitkITKImageImport.h>
+#include <mitkImageRegionModifiedEvent.h>
+#include <mitkPlaneGeometry.h>
+
+#include <itkImageRegionIteratorWithIndex.h>
 
 class mitkImageStatisticsContainerManagerTestSuite : public mitk::TestFixture
 {
@@ -33,6 +41,7 @@ class mitkImageStatisticsContainerManagerTestSuite : public mitk::TestFixture
   MITK_TEST(GetImageStatisticsWithImageAndMaskConnected);
   MITK_TEST(GetImageStatisticsWithImageAndMaskNotConnected);
   MITK_TEST(GetImageStatisticsInvalid);
+  MITK_TEST(UpdateImageStatisticsForDirtyRegion);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -248,5 +257,136 @@ public:
     CPPUNIT_ASSERT_THROW(mitk::ImageStatisticsContainerManager::GetImageStatistics(standaloneDataStorage.GetPointer(), nullptr, m_planarFigure.GetPointer()), mitk::Exception);
   }
 
+  void UpdateImageStatisticsForDirtyRegion()
+  {
+    typedef itk::Image<short, 3> ImageType;
+    typedef itk::Image<unsigned char, 3> MaskType;
+
+    ImageType::SizeType size;
+    size.Fill(70);
+    ImageType::RegionType region(size);
+    auto itkImage = ImageType::New();
+    itkImage->SetRegions(region);
+    itkImage->Allocate();
+    auto itkMask = MaskType::New();
+    itkMask->SetRegions(region);
+    itkMask->Allocate();
+
+    itk::ImageRegionIteratorWithIndex<ImageType> imageIt(itkImage, region);
+    itk::ImageRegionIteratorWithIndex<MaskType> maskIt(itkMask, region);
+    for (; !imageIt.IsAtEnd(); ++imageIt, ++maskIt)
+    {
+      auto index = imageIt.GetIndex();
+      imageIt.Set(static_cast<short>(7 * index[0] - 3 * index[1] + (index[2] * index[2]) % 50));
+      maskIt.Set(index[0] > 10 && index[0] < 50 && index[1] > 5 && index[1] < 60 && index[2] > 20 ? 1 : 0);
+    }
+
+    auto image = mitk::GrabItkImageMemory(itkImage.GetPointer());
+    auto mask = mitk::GrabItkImageMemory(itkMask.GetPointer());
+
+    auto maskGenerator = mitk::ImageMaskGenerator::New();
+    maskGenerator->SetImageMask(mask);
+    auto calculator = mitk::ImageStatisticsCalculator::New();
+    calculator->SetInputImage(image);
+    calculator->SetMask(maskGenerator.GetPointer());
+    mitk::ImageStatisticsContainer::Pointer container = calculator->GetStatistics(1);
+
+    CreateNodeRelationImage(container.GetPointer(), image.GetPointer());
+    CreateNodeRelationMask(container.GetPointer(), mask.GetPointer());
+    auto standaloneDataStorage = mitk::StandaloneDataStorage::New();
+    standaloneDataStorage->Add(mitk::CreateImageStatisticsNode(container, "testStatistics"));
+
+    mitk::ImageStatisticsContainerManager manager;
+
+    //no container for the mask alone --> nothing to update
+    CPPUNIT_ASSERT(!manager.UpdateImageStatistics(standaloneDataStorage.GetPointer(), mask.GetPointer(), mask.GetPointer(), region));
+
+    //first update builds the block statistics
+    CPPUNIT_ASSERT(manager.UpdateImageStatistics(standaloneDataStorage.GetPointer(), image.GetPointer(), mask.GetPointer(), region));
+    AssertEqualStatistics(calculator->GetStatistics(1)->GetStatisticsForTimeStep(0), container->GetStatisticsForTimeStep(0));
+
+    //draw into slice 30 and erase in slice 40, which extends the intensity range of the label
+    ImageType::IndexType sliceIndex = {{0, 0, 30}};
+    ImageType::SizeType sliceSize = {{70, 70, 1}};
+    ImageType::RegionType slice(sliceIndex, sliceSize);
+    for (itk::ImageRegionIteratorWithIndex<MaskType> it(itkMask, slice); !it.IsAtEnd(); ++it)
+    {
+      if (it.GetIndex()[0] < 10)
+        it.Set(1);
+    }
+    sliceIndex[2] = 40;
+    ImageType::RegionType slice2(sliceIndex, sliceSize);
+    for (itk::ImageRegionIteratorWithIndex<MaskType> it(itkMask, slice2); !it.IsAtEnd(); ++it)
+    {
+      if (it.GetIndex()[1] < 30)
+        it.Set(0);
+    }
+    mask->Modified();
+
+    CPPUNIT_ASSERT(manager.UpdateImageStatistics(standaloneDataStorage.GetPointer(), image.GetPointer(), mask.GetPointer(), slice));
+    CPPUNIT_ASSERT(manager.UpdateImageStatistics(standaloneDataStorage.GetPointer(), image.GetPointer(), mask.GetPointer(), slice2));
+
+    auto referenceMaskGenerator = mitk::ImageMaskGenerator::New();
+    referenceMaskGenerator->SetImageMask(mask);
+    auto referenceCalculator = mitk::ImageStatisticsCalculator::New();
+    referenceCalculator->SetInputImage(image);
+    referenceCalculator->SetMask(referenceMaskGenerator.GetPointer());
+    AssertEqualStatistics(referenceCalculator->GetStatistics(1)->GetStatisticsForTimeStep(0), container->GetStatisticsForTimeStep(0));
+
+    //edits reported by the mask (as segmentation tools and undo do) update the container
+    manager.ObserveMask(standaloneDataStorage.GetPointer(), image.GetPointer(), mask.GetPointer());
+    sliceIndex[2] = 50;
+    ImageType::RegionType slice3(sliceIndex, sliceSize);
+    for (itk::ImageRegionIteratorWithIndex<MaskType> it(itkMask, slice3); !it.IsAtEnd(); ++it)
+    {
+      it.Set(it.GetIndex()[0] > 60 ? 1 : 0);
+    }
+    mask->Modified();
+    auto planeGeometry = mitk::PlaneGeometry::New();
+    planeGeometry->InitializeStandardPlane(image->GetGeometry(), mitk::PlaneGeometry::Axial, 50);
+    mask->InvokeEvent(mitk::ImageRegionModifiedEvent(planeGeometry, 0));
+
+    auto observedMaskGenerator = mitk::ImageMaskGenerator::New();
+    observedMaskGenerator->SetImageMask(mask);
+    auto observedCalculator = mitk::ImageStatisticsCalculator::New();
+    observedCalculator->SetInputImage(image);
+    observedCalculator->SetMask(observedMaskGenerator.GetPointer());
+    AssertEqualStatistics(observedCalculator->GetStatistics(1)->GetStatisticsForTimeStep(0), container->GetStatisticsForTimeStep(0));
+
+    //no update after the observation ended
+    manager.StopObservingMask(mask.GetPointer());
+    auto statisticsMTime = container->GetMTime();
+    mask->InvokeEvent(mitk::ImageRegionModifiedEvent(planeGeometry, 0));
+    CPPUNIT_ASSERT_EQUAL(statisticsMTime, container->GetMTime());
+  }
+
+  void AssertEqualStatistics(const mitk::ImageStatisticsContainer::ImageStatisticsObject& expected, const mitk::ImageStatisticsContainer::ImageStatisticsObject& actual)
+  {
+    using VoxelCountType = mitk::ImageStatisticsContainer::VoxelCountType;
+    using RealType = mitk::ImageStatisticsContainer::RealType;
+    using IndexType = mitk::ImageStatisticsContainer::IndexType;
+
+    CPPUNIT_ASSERT_EQUAL(expected.GetValueConverted<VoxelCountType>(mitk::ImageStatisticsConstants::NUMBEROFVOXELS()),
+      actual.GetValueConverted<VoxelCountType>(mitk::ImageStatisticsConstants::NUMBEROFVOXELS()));
+    CPPUNIT_ASSERT(expected.GetValueConverted<IndexType>(mitk::ImageStatisticsConstants::MINIMUMPOSITION()) ==
+      actual.GetValueConverted<IndexType>(mitk::ImageStatisticsConstants::MINIMUMPOSITION()));
+    CPPUNIT_ASSERT(expected.GetValueConverted<IndexType>(mitk::ImageStatisticsConstants::MAXIMUMPOSITION()) ==
+      actual.GetValueConverted<IndexType>(mitk::ImageStatisticsConstants::MAXIMUMPOSITION()));
+
+    for (const auto& name : { mitk::ImageStatisticsConstants::MEAN(), mitk::ImageStatisticsConstants::MINIMUM(),
+      mitk::ImageStatisticsConstants::MAXIMUM(), mitk::ImageStatisticsConstants::STANDARDDEVIATION(),
+      mitk::ImageStatisticsConstants::VOLUME(), mitk::ImageStatisticsConstants::MEDIAN(),
+      mitk::ImageStatisticsConstants::ENTROPY(), mitk::ImageStatisticsConstants::UNIFORMITY() })
+    {
+      CPPUNIT_ASSERT_MESSAGE(name, mitk::Equal(expected.GetValueConverted<RealType>(name), actual.GetValueConverted<RealType>(name), 1e-6, true));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(expected.m_Histogram->Size(), actual.m_Histogram->Size());
+    for (unsigned int bin = 0; bin < expected.m_Histogram->Size(); ++bin)
+    {
+      CPPUNIT_ASSERT_EQUAL(expected.m_Histogram->GetFrequency(bin), actual.m_Histogram->GetFrequency(bin));
+    }
+  }
+
 };
 MITK_TEST_SUITE_REGISTRATION(mitkImageStatisticsContainerManager)
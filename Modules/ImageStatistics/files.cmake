@@ -15,6 +15,7 @@ set(CPP_FILES
   mitkImageStatisticsPredicateHelper.cpp
   mitkImageStatisticsContainerNodeHelper.cpp
   mitkImageStatisticsContainerManager.cpp
+  mitkIncrementalLabelStatistics.cpp
   mitkStatisticsToImageRelationRule.cpp
   mitkStatisticsToMaskRelationRule.cpp
   mitkImageStatisticsConstants.cpp
@@ -38,9 +39,11 @@ set(H_FILES
   mitkIgnorePixelMaskGenerator.h
   mitkMinMaxImageFilterWithIndex.h
   mitkMinMaxLabelmageFilterWithIndex.h
+  mitkMultiLabelStatisticsAccumulator.h
   mitkImageStatisticsPredicateHelper.h
   mitkImageStatisticsContainerNodeHelper.h
   mitkImageStatisticsContainerManager.h
+  mitkIncrementalLabelStatistics.h
   mitkStatisticsToImageRelationRule.h
   mitkStatisticsToMaskRelationRule.h
   mitkImageStatisticsConstants.h
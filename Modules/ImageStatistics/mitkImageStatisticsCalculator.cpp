@@ -11,7 +11,6 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkImageStatisticsCalculator.h"
-#include <mitkExtendedLabelStatisticsImageFilter.h>
 #include <mitkExtendedStatisticsImageFilter.h>
 #include <mitkImage.h>
 #include <mitkImageAccessByItk.h>
@@ -21,9 +20,11 @@ found in the LICENSE file.
 #include <mitkImageToItk.h>
 #include <mitkMaskUtilities.h>
 #include <mitkMinMaxImageFilterWithIndex.h>
-#include <mitkMinMaxLabelmageFilterWithIndex.h>
+#include <mitkMultiLabelStatisticsAccumulator.h>
 #include <mitkitkMaskImageFilter.h>
 
+#include <set>
+
 namespace mitk
 {
   void ImageStatisticsCalculator::SetInputImage(const mitk::Image *image)
@@ -104,6 +105,16 @@ namespace mitk
 
     if (IsUpdateRequired(label))
     {
+      // labels may only keep their statistics if nothing but the masks has changed since the last calculation
+      m_ReuseUnchangedLabels = m_LastStatisticsImage.IsNotNull() &&
+                               m_LastStatisticsImage->GetMTime() < m_LastCalculationTime.GetMTime() &&
+                               m_Image->GetMTime() < m_LastCalculationTime.GetMTime() &&
+                               this->GetMTime() < m_LastCalculationTime.GetMTime();
+      if (!m_ReuseUnchangedLabels)
+      {
+        m_CalculatedMasks.clear();
+      }
+
       auto timeGeometry = m_Image->GetTimeGeometry();
       // always compute statistics on all timesteps
       for (unsigned int timeStep = 0; timeStep < m_Image->GetTimeSteps(); timeStep++)
@@ -150,9 +161,17 @@ namespace mitk
         else
         {
           // 2) calculate statistics masked
+          if (m_LastStatisticsImage != m_InternalImageForStatistics)
+          {
+            m_ReuseUnchangedLabels = false;
+            m_CalculatedMasks.clear();
+          }
           AccessByItk_2(m_ImageTimeSlice, InternalCalculateStatisticsMasked, timeGeometry, timeStep)
         }
       }
+
+      m_LastStatisticsImage = m_InternalImageForStatistics;
+      m_LastCalculationTime.Modified();
     }
 
     auto it = m_StatisticContainers.find(label);
@@ -300,10 +319,8 @@ namespace mitk
     typedef itk::Image<TPixel, VImageDimension> ImageType;
     typedef itk::Image<MaskPixelType, VImageDimension> MaskType;
     typedef typename MaskType::PixelType LabelPixelType;
-    typedef itk::ExtendedLabelStatisticsImageFilter<ImageType, MaskType> ImageStatisticsFilterType;
     typedef MaskUtilities<TPixel, VImageDimension> MaskUtilType;
-    typedef typename itk::MinMaxLabelImageFilterWithIndex<ImageType, MaskType> MinMaxLabelFilterType;
-    typedef typename ImageType::PixelType InputImgPixelType;
+    typedef MultiLabelStatisticsAccumulator<TPixel, VImageDimension> AccumulatorType;
 
     // workaround: if m_SecondaryMaskGenerator ist not null but m_MaskGenerator is! (this is the case if we request a
     // 'ignore zuero valued pixels' mask in the gui but do not define a primary mask)
@@ -373,31 +390,73 @@ namespace mitk
 
     adaptedImage = maskUtil->ExtractMaskImageRegion(); // this also checks mask sanity
 
-    // find min, max, minindex and maxindex
-    typename MinMaxLabelFilterType::Pointer minMaxFilter = MinMaxLabelFilterType::New();
-    minMaxFilter->SetInput(adaptedImage);
-    minMaxFilter->SetLabelInput(maskImage);
-    minMaxFilter->UpdateLargestPossibleRegion();
+    // statistics of all labels in one pass over image and mask
+    typename AccumulatorType::Pointer accumulator = AccumulatorType::New();
+    accumulator->SetInput(adaptedImage);
+    accumulator->SetLabelInput(maskImage);
+    try
+    {
+      accumulator->ComputeStatistics();
+    }
+    catch (const itk::ExceptionObject &e)
+    {
+      mitkThrow() << "Image statistics calculation failed due to following ITK Exception: \n " << e.what();
+    }
 
-    // set histogram parameters for each label individually (min/max may be different for each label)
-    typedef typename std::map<LabelPixelType, InputImgPixelType> MapType;
-    typedef typename std::pair<LabelPixelType, InputImgPixelType> PairType;
+    // a label covering exactly the same pixels as in the previous calculation keeps its statistics,
+    // if nothing but the mask has changed since then
+    CalculatedMask calculatedMask;
+    const auto &maskRegion = maskImage->GetBufferedRegion();
+    for (unsigned int i = 0; i < VImageDimension; ++i)
+    {
+      calculatedMask.m_Region.push_back(maskRegion.GetIndex(i));
+      calculatedMask.m_Region.push_back(static_cast<long>(maskRegion.GetSize(i)));
+    }
+    const MaskPixelType *maskBuffer = maskImage->GetBufferPointer();
+    calculatedMask.m_Pixels.assign(maskBuffer, maskBuffer + maskRegion.GetNumberOfPixels());
+
+    auto previousMaskIt = m_CalculatedMasks.find(static_cast<TimeStepType>(timeStep));
+    const bool comparePixels = m_ReuseUnchangedLabels && previousMaskIt != m_CalculatedMasks.end() &&
+                               previousMaskIt->second.m_Region == calculatedMask.m_Region;
+    std::set<LabelPixelType> modifiedLabels;
+    if (comparePixels)
+    {
+      const auto &previousPixels = previousMaskIt->second.m_Pixels;
+      const auto &currentPixels = calculatedMask.m_Pixels;
+      for (std::size_t i = 0; i < currentPixels.size(); ++i)
+      {
+        if (previousPixels[i] != currentPixels[i])
+        {
+          modifiedLabels.insert(previousPixels[i]);
+          modifiedLabels.insert(currentPixels[i]);
+        }
+      }
+    }
+    m_CalculatedMasks[static_cast<TimeStepType>(timeStep)] = std::move(calculatedMask);
 
-    std::vector<LabelPixelType> relevantLabels = minMaxFilter->GetRelevantLabels();
-    MapType minVals;
-    MapType maxVals;
+    std::vector<LabelPixelType> relevantLabels = accumulator->GetRelevantLabels();
+    std::vector<LabelPixelType> changedLabels;
     std::map<LabelPixelType, unsigned int> nBins;
 
     for (LabelPixelType label : relevantLabels)
     {
-      minVals.insert(PairType(label, minMaxFilter->GetMin(label)));
-      maxVals.insert(PairType(label, minMaxFilter->GetMax(label)));
+      const auto &labelStats = accumulator->GetStatistics(label);
 
+      auto containerIt = m_StatisticContainers.find(label);
+      if (comparePixels && modifiedLabels.find(label) == modifiedLabels.end() &&
+          containerIt != m_StatisticContainers.end() && containerIt->second->TimeStepExists(timeStep))
+      {
+        continue;
+      }
+
+      changedLabels.push_back(label);
+
+      // set histogram parameters for each label individually (min/max may be different for each label)
       unsigned int nBinsForHistogram;
       if (m_UseBinSizeOverNBins)
       {
         nBinsForHistogram =
-          std::max(static_cast<double>(std::ceil(minMaxFilter->GetMax(label) - minMaxFilter->GetMin(label))) /
+          std::max(static_cast<double>(std::ceil(labelStats.m_Maximum - labelStats.m_Minimum)) /
                      m_binSizeForHistogramStatistics,
                    10.); // do not allow less than 10 bins
       }
@@ -406,24 +465,15 @@ namespace mitk
         nBinsForHistogram = m_nBinsForHistogramStatistics;
       }
 
-      nBins.insert(typename std::pair<LabelPixelType, unsigned int>(label, nBinsForHistogram));
+      nBins.insert(std::make_pair(label, nBinsForHistogram));
     }
 
-    typename ImageStatisticsFilterType::Pointer imageStatisticsFilter = ImageStatisticsFilterType::New();
-    imageStatisticsFilter->SetDirectionTolerance(0.001);
-    imageStatisticsFilter->SetCoordinateTolerance(0.001);
-    imageStatisticsFilter->SetInput(adaptedImage);
-    imageStatisticsFilter->SetLabelInput(maskImage);
-    imageStatisticsFilter->SetHistogramParametersForLabels(nBins, minVals, maxVals);
-    imageStatisticsFilter->Update();
-
-    std::list<int> labels = imageStatisticsFilter->GetRelevantLabels();
-    auto it = labels.begin();
+    accumulator->ComputeHistograms(nBins);
 
-    while (it != labels.end())
+    for (LabelPixelType label : changedLabels)
     {
       ImageStatisticsContainer::Pointer statisticContainerForLabelImage;
-      auto labelIt = m_StatisticContainers.find(*it);
+      auto labelIt = m_StatisticContainers.find(label);
       // reset if statisticContainer already exist
       if (labelIt != m_StatisticContainers.end())
       {
@@ -434,29 +484,26 @@ namespace mitk
       {
         statisticContainerForLabelImage = ImageStatisticsContainer::New();
         statisticContainerForLabelImage->SetTimeGeometry(const_cast<mitk::TimeGeometry*>(timeGeometry));
-        // link label (*it) to statisticContainer
-        m_StatisticContainers.emplace(*it, statisticContainerForLabelImage);
+        // link label to statisticContainer
+        m_StatisticContainers.emplace(label, statisticContainerForLabelImage);
       }
 
+      const auto &labelStats = accumulator->GetStatistics(label);
       ImageStatisticsContainer::ImageStatisticsObject statObj;
 
-      // find min, max, minindex and maxindex
-      // make sure to only look in the masked region, use a masker for this
-
       vnl_vector<int> minIndex, maxIndex;
       mitk::Point3D worldCoordinateMin;
       mitk::Point3D worldCoordinateMax;
       mitk::Point3D indexCoordinateMin;
       mitk::Point3D indexCoordinateMax;
-      m_InternalImageForStatistics->GetGeometry()->IndexToWorld(minMaxFilter->GetMinIndex(*it), worldCoordinateMin);
-      m_InternalImageForStatistics->GetGeometry()->IndexToWorld(minMaxFilter->GetMaxIndex(*it), worldCoordinateMax);
+      m_InternalImageForStatistics->GetGeometry()->IndexToWorld(accumulator->GetMinimumIndex(label), worldCoordinateMin);
+      m_InternalImageForStatistics->GetGeometry()->IndexToWorld(accumulator->GetMaximumIndex(label), worldCoordinateMax);
       m_Image->GetGeometry()->WorldToIndex(worldCoordinateMin, indexCoordinateMin);
       m_Image->GetGeometry()->WorldToIndex(worldCoordinateMax, indexCoordinateMax);
 
       minIndex.set_size(3);
       maxIndex.set_size(3);
 
-      // for (unsigned int i=0; i < tmpMaxIndex.GetIndexDimension(); i++)
       for (unsigned int i = 0; i < 3; i++)
       {
         minIndex[i] = indexCoordinateMin[i];
@@ -466,36 +513,35 @@ namespace mitk
       statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUMPOSITION(), minIndex);
       statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUMPOSITION(), maxIndex);
 
-      assert(std::abs(minMaxFilter->GetMax(*it) - imageStatisticsFilter->GetMaximum(*it)) < mitk::eps);
-      assert(std::abs(minMaxFilter->GetMin(*it) - imageStatisticsFilter->GetMinimum(*it)) < mitk::eps);
-
       auto voxelVolume = GetVoxelVolume<TPixel, VImageDimension>(image);
-      auto numberOfVoxels =
-        static_cast<unsigned long>(imageStatisticsFilter->GetSum(*it) / (double)imageStatisticsFilter->GetMean(*it));
+      auto numberOfVoxels = static_cast<ImageStatisticsContainer::VoxelCountType>(labelStats.m_Count);
       auto volume = static_cast<double>(numberOfVoxels) * voxelVolume;
-      auto rms = std::sqrt(std::pow(imageStatisticsFilter->GetMean(*it), 2.) +
-                           imageStatisticsFilter->GetVariance(*it)); // variance = sigma^2
-      auto variance = imageStatisticsFilter->GetSigma(*it) * imageStatisticsFilter->GetSigma(*it);
+      auto rms = std::sqrt(std::pow(labelStats.m_Mean, 2.) + labelStats.m_Variance); // variance = sigma^2
+      auto sigma = std::sqrt(labelStats.m_Variance);
 
       statObj.AddStatistic(mitk::ImageStatisticsConstants::NUMBEROFVOXELS(), numberOfVoxels);
       statObj.AddStatistic(mitk::ImageStatisticsConstants::VOLUME(), volume);
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MEAN(), imageStatisticsFilter->GetMean(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUM(), imageStatisticsFilter->GetMinimum(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUM(), imageStatisticsFilter->GetMaximum(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::STANDARDDEVIATION(), imageStatisticsFilter->GetSigma(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::VARIANCE(), variance);
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::SKEWNESS(), imageStatisticsFilter->GetSkewness(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::KURTOSIS(), imageStatisticsFilter->GetKurtosis(*it));
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::MEAN(), labelStats.m_Mean);
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUM(), labelStats.m_Minimum);
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUM(), labelStats.m_Maximum);
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::STANDARDDEVIATION(), sigma);
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::VARIANCE(), sigma * sigma);
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::SKEWNESS(), labelStats.m_Skewness);
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::KURTOSIS(), labelStats.m_Kurtosis);
       statObj.AddStatistic(mitk::ImageStatisticsConstants::RMS(), rms);
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MPP(), imageStatisticsFilter->GetMPP(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::ENTROPY(), imageStatisticsFilter->GetEntropy(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MEDIAN(), imageStatisticsFilter->GetMedian(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::UNIFORMITY(), imageStatisticsFilter->GetUniformity(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::UPP(), imageStatisticsFilter->GetUPP(*it));
-      statObj.m_Histogram = imageStatisticsFilter->GetHistogram(*it).GetPointer();
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::MPP(), labelStats.m_MPP);
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::ENTROPY(), labelStats.m_Entropy);
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::MEDIAN(), labelStats.m_Median);
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::UNIFORMITY(), labelStats.m_Uniformity);
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::UPP(), labelStats.m_UPP);
+      statObj.m_Histogram = labelStats.m_Histogram.GetPointer();
 
       statisticContainerForLabelImage->SetStatisticsForTimeStep(timeStep, statObj);
-      ++it;
+    }
+
+    for (LabelPixelType label : relevantLabels)
+    {
+      m_LabelValidationTimes[label].Modified();
     }
 
     // swap maskGenerators back
@@ -519,6 +565,13 @@ namespace mitk
 
     unsigned long statisticsTimeStamp = it->second->GetMTime();
 
+    // statistics of labels that did not change in the last calculation are valid although their container is older
+    auto validationIt = m_LabelValidationTimes.find(label);
+    if (validationIt != m_LabelValidationTimes.end())
+    {
+      statisticsTimeStamp = std::max(statisticsTimeStamp, validationIt->second.GetMTime());
+    }
+
     if (thisClassTimeStamp > statisticsTimeStamp) // inputs have changed
     {
       return true;
@@ -18,6 +18,8 @@ found in the LICENSE file.
 #include <mitkMaskGenerator.h>
 #include <mitkImageStatisticsContainer.h>
 
+#include <itkTimeStamp.h>
+
 namespace mitk
 {
     class MITKIMAGESTATISTICS_EXPORT ImageStatisticsCalculator: public itk::Object
@@ -74,7 +76,10 @@ namespace mitk
 
         /**Documentation
         @brief Returns the statistics for label @a label. If these requested statistics are not computed yet the computation is done as well.
-        For performance reasons, statistics for all labels in the image are computed at once.
+        For performance reasons, statistics for all labels in the image are computed at once, in a single multi-threaded pass over image
+        and mask (plus one pass for the histograms).
+        If only the mask has changed since the last computation, labels that still cover the same pixels keep their statistics
+        (and their containers are not modified); only the histograms of changed labels are recomputed.
          */
         ImageStatisticsContainer* GetStatistics(LabelIndex label=1);
 
@@ -83,6 +88,7 @@ namespace mitk
             m_nBinsForHistogramStatistics = 100;
             m_binSizeForHistogramStatistics = 10;
             m_UseBinSizeOverNBins = false;
+            m_ReuseUnchangedLabels = false;
         };
 
 
@@ -100,6 +106,13 @@ namespace mitk
 
         bool IsUpdateRequired(LabelIndex label) const;
 
+        /** Copy of the (cropped and combined) mask of a time step used by the last calculation. */
+        struct CalculatedMask
+        {
+          std::vector<long> m_Region;
+          std::vector<MaskPixelType> m_Pixels;
+        };
+
         mitk::Image::ConstPointer m_Image;
         mitk::Image::Pointer m_ImageTimeSlice;
         mitk::Image::ConstPointer m_InternalImageForStatistics;
@@ -115,6 +128,15 @@ namespace mitk
         bool m_UseBinSizeOverNBins;
 
         std::map<LabelIndex,ImageStatisticsContainer::Pointer> m_StatisticContainers;
+
+        /** Masks of the last calculation per time step. A label keeps its statistics only if none of the
+        pixels that differ from this copy belong to it, so it costs one mask copy per time step. */
+        std::map<TimeStepType, CalculatedMask> m_CalculatedMasks;
+        /** Time of the last calculation that found the statistics of a label valid, including unchanged labels. */
+        std::map<LabelIndex, itk::TimeStamp> m_LabelValidationTimes;
+        mitk::Image::ConstPointer m_LastStatisticsImage;
+        itk::TimeStamp m_LastCalculationTime;
+        bool m_ReuseUnchangedLabels;
     };
 
 }
@@ -18,8 +18,154 @@ found in the LICENSE file.
 #include "mitkNodePredicateNot.h"
 #include "mitkStatisticsToImageRelationRule.h"
 #include "mitkStatisticsToMaskRelationRule.h"
+#include "mitkIncrementalLabelStatistics.h"
+
+#include "mitkImageRegionModifiedEvent.h"
+
+#include <itkCommand.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+struct mitk::ImageStatisticsContainerManager::Impl
+{
+  using ObserverType = std::pair<const itk::Object*, unsigned long>;
+
+  /** Block statistics of the labels and time steps of a container, valid as long as the container has the recorded MTime. */
+  struct IncrementalStatisticsEntry
+  {
+    std::map<std::pair<mitk::TimeStepType, mitk::ImageStatisticsContainer::LabelIndex>, mitk::IncrementalLabelStatistics::Pointer> statistics;
+    itk::ModifiedTimeType containerMTime = 0;
+    const mitk::Image* image = nullptr;
+    const mitk::Image* mask = nullptr;
+    std::vector<ObserverType> deleteObservers;
+  };
+
+  /** Mask whose ImageRegionModifiedEvents update the statistics of image and mask. */
+  struct MaskObservation
+  {
+    mitk::DataStorage::ConstPointer dataStorage;
+    const mitk::Image* image = nullptr;
+    mitk::ImageStatisticsContainer::LabelIndex label = 1;
+    std::vector<ObserverType> observers;
+  };
+
+  explicit Impl(ImageStatisticsContainerManager* manager) : m_Manager(manager) {}
+
+  ~Impl()
+  {
+    for (const auto& entry : m_Entries) {
+      RemoveObservers(entry.second.deleteObservers, nullptr);
+    }
+    for (const auto& observation : m_Observations) {
+      RemoveObservers(observation.second.observers, nullptr);
+    }
+  }
+
+  ObserverType AddDeleteObserver(const itk::Object* object)
+  {
+    auto command = itk::MemberCommand<Impl>::New();
+    command->SetCallbackFunction(this, &Impl::OnObjectDeleted);
+    return std::make_pair(object, object->AddObserver(itk::DeleteEvent(), command));
+  }
+
+  /** Removes the observers from their objects except from the object that is currently deleted. */
+  static void RemoveObservers(const std::vector<ObserverType>& observers, const itk::Object* deletedObject)
+  {
+    for (const auto& observer : observers) {
+      if (observer.first != deletedObject) {
+        observer.first->RemoveObserver(observer.second);
+      }
+    }
+  }
+
+  IncrementalStatisticsEntry& GetEntry(const mitk::ImageStatisticsContainer* container, const mitk::Image* image, const mitk::Image* mask)
+  {
+    auto entryIter = m_Entries.find(container);
+    if (entryIter != m_Entries.end() && (entryIter->second.image != image || entryIter->second.mask != mask)) {
+      RemoveObservers(entryIter->second.deleteObservers, nullptr);
+      m_Entries.erase(entryIter);
+      entryIter = m_Entries.end();
+    }
+    if (entryIter == m_Entries.end()) {
+      IncrementalStatisticsEntry entry;
+      entry.image = image;
+      entry.mask = mask;
+      entry.deleteObservers.push_back(AddDeleteObserver(container));
+      entry.deleteObservers.push_back(AddDeleteObserver(image));
+      entry.deleteObservers.push_back(AddDeleteObserver(mask));
+      entryIter = m_Entries.emplace(container, std::move(entry)).first;
+    }
+    return entryIter->second;
+  }
+
+  void StopObservingMask(const mitk::Image* mask, const itk::Object* deletedObject)
+  {
+    auto observationIter = m_Observations.find(mask);
+    if (observationIter != m_Observations.end()) {
+      RemoveObservers(observationIter->second.observers, deletedObject);
+      m_Observations.erase(observationIter);
+    }
+  }
+
+  void OnObjectDeleted(const itk::Object* object, const itk::EventObject&)
+  {
+    for (auto entryIter = m_Entries.begin(); entryIter != m_Entries.end();) {
+      if (entryIter->first == object || entryIter->second.image == object || entryIter->second.mask == object) {
+        RemoveObservers(entryIter->second.deleteObservers, object);
+        entryIter = m_Entries.erase(entryIter);
+      }
+      else {
+        ++entryIter;
+      }
+    }
+
+    for (auto observationIter = m_Observations.begin(); observationIter != m_Observations.end();) {
+      if (observationIter->first == object || observationIter->second.image == object) {
+        RemoveObservers(observationIter->second.observers, object);
+        observationIter = m_Observations.erase(observationIter);
+      }
+      else {
+        ++observationIter;
+      }
+    }
+  }
+
+  void OnMaskRegionModified(const itk::Object* object, const itk::EventObject& event)
+  {
+    auto regionEvent = dynamic_cast<const mitk::ImageRegionModifiedEvent*>(&event);
+    auto observationIter = m_Observations.find(object);
+    if (!regionEvent || !regionEvent->GetGeometry() || observationIter == m_Observations.end()) {
+      return;
+    }
+
+    // copy, the update may end the observation if it releases the last reference of image or mask
+    auto observation = observationIter->second;
+    auto mask = static_cast<const mitk::Image*>(object);
+    m_Manager->UpdateImageStatistics(observation.dataStorage, observation.image, mask, regionEvent->GetGeometry(), regionEvent->GetTimeStep(), observation.label);
+  }
+
+  ImageStatisticsContainerManager* m_Manager;
+  std::map<const itk::Object*, IncrementalStatisticsEntry> m_Entries;
+  std::map<const itk::Object*, MaskObservation> m_Observations;
+};
+
+mitk::ImageStatisticsContainerManager::ImageStatisticsContainerManager() : m_Impl(new Impl(this))
+{
+}
+
+mitk::ImageStatisticsContainerManager::~ImageStatisticsContainerManager()
+{
+}
 
 mitk::ImageStatisticsContainer::ConstPointer mitk::ImageStatisticsContainerManager::GetImageStatistics(const mitk::DataStorage* dataStorage, const mitk::BaseData* image, const mitk::BaseData* mask)
+{
+  return GetStoredImageStatistics(dataStorage, image, mask);
+}
+
+mitk::ImageStatisticsContainer* mitk::ImageStatisticsContainerManager::GetStoredImageStatistics(const mitk::DataStorage* dataStorage, const mitk::BaseData* image, const mitk::BaseData* mask)
 {
   if (!dataStorage) {
     mitkThrow() << "data storage is nullptr!";
@@ -88,3 +234,130 @@ mitk::NodePredicateBase::ConstPointer mitk::ImageStatisticsContainerManager::Get
 
   return predicate;
 }
+
+bool mitk::ImageStatisticsContainerManager::UpdateImageStatistics(const mitk::DataStorage* dataStorage, const mitk::Image* image, const mitk::Image* mask,
+  const itk::ImageRegion<3>& dirtyRegion, TimeStepType timeStep, ImageStatisticsContainer::LabelIndex label)
+{
+  if (!mask) {
+    mitkThrow() << "Mask is nullptr";
+  }
+
+  auto container = GetStoredImageStatistics(dataStorage, image, mask);
+  if (!container) {
+    return false;
+  }
+
+  auto& entry = m_Impl->GetEntry(container, image, mask);
+  if (entry.containerMTime != container->GetMTime()) {
+    // statistics were recomputed or changed elsewhere, block statistics must be rebuilt
+    entry.statistics.clear();
+  }
+
+  auto& labelStatistics = entry.statistics[std::make_pair(timeStep, label)];
+  try {
+    if (labelStatistics.IsNull() || !labelStatistics->IsInitializedFor(image, mask, timeStep, label)) {
+      unsigned int nBins = 100;
+      if (container->TimeStepExists(timeStep)) {
+        auto histogram = container->GetStatisticsForTimeStep(timeStep).m_Histogram;
+        if (histogram.IsNotNull() && histogram->Size() > 0) {
+          nBins = histogram->Size();
+        }
+      }
+      labelStatistics = mitk::IncrementalLabelStatistics::New();
+      labelStatistics->Initialize(image, mask, timeStep, label, nBins);
+    }
+    else {
+      labelStatistics->Update(dirtyRegion);
+    }
+  }
+  catch (const mitk::Exception& e) {
+    MITK_WARN << "Incremental statistics update not possible: " << e.GetDescription();
+    entry.statistics.erase(std::make_pair(timeStep, label));
+    return false;
+  }
+
+  if (labelStatistics->GetCount() == 0) {
+    return false;
+  }
+
+  container->SetStatisticsForTimeStep(timeStep, labelStatistics->GetStatistics());
+  entry.containerMTime = container->GetMTime();
+  return true;
+}
+
+bool mitk::ImageStatisticsContainerManager::UpdateImageStatistics(const mitk::DataStorage* dataStorage, const mitk::Image* image, const mitk::Image* mask,
+  const mitk::BaseGeometry* dirtyGeometry, TimeStepType timeStep, ImageStatisticsContainer::LabelIndex label)
+{
+  if (!image) {
+    mitkThrow() << "Image is nullptr";
+  }
+  if (!dirtyGeometry) {
+    mitkThrow() << "Geometry of the changed region is nullptr";
+  }
+
+  // bounding box of the corners of the changed region in index coordinates of the image
+  auto imageGeometry = image->GetGeometry(timeStep);
+  mitk::Point3D lower, upper;
+  for (int corner = 0; corner < 8; ++corner) {
+    mitk::Point3D index;
+    imageGeometry->WorldToIndex(dirtyGeometry->GetCornerPoint(corner), index);
+    for (unsigned int i = 0; i < 3; ++i) {
+      lower[i] = corner == 0 ? index[i] : std::min(lower[i], index[i]);
+      upper[i] = corner == 0 ? index[i] : std::max(upper[i], index[i]);
+    }
+  }
+
+  // one voxel of padding covers voxels that are only partially inside the changed region
+  itk::ImageRegion<3>::IndexType regionIndex;
+  itk::ImageRegion<3>::SizeType regionSize;
+  for (unsigned int i = 0; i < 3; ++i) {
+    auto first = static_cast<itk::IndexValueType>(std::floor(lower[i])) - 1;
+    auto last = static_cast<itk::IndexValueType>(std::ceil(upper[i])) + 1;
+    first = std::max<itk::IndexValueType>(first, 0);
+    last = std::min<itk::IndexValueType>(last, static_cast<itk::IndexValueType>(image->GetDimension(i)) - 1);
+    if (last < first) {
+      // changed region is outside of the image, the statistics stay valid
+      return GetImageStatistics(dataStorage, image, mask).IsNotNull();
+    }
+    regionIndex[i] = first;
+    regionSize[i] = last - first + 1;
+  }
+
+  return UpdateImageStatistics(dataStorage, image, mask, itk::ImageRegion<3>(regionIndex, regionSize), timeStep, label);
+}
+
+void mitk::ImageStatisticsContainerManager::ObserveMask(const mitk::DataStorage* dataStorage, const mitk::Image* image, const mitk::Image* mask,
+  ImageStatisticsContainer::LabelIndex label)
+{
+  if (!dataStorage) {
+    mitkThrow() << "data storage is nullptr!";
+  }
+  if (!image) {
+    mitkThrow() << "Image is nullptr";
+  }
+  if (!mask) {
+    mitkThrow() << "Mask is nullptr";
+  }
+
+  StopObservingMask(mask);
+
+  Impl::MaskObservation observation;
+  observation.dataStorage = dataStorage;
+  observation.image = image;
+  observation.label = label;
+
+  auto command = itk::MemberCommand<Impl>::New();
+  command->SetCallbackFunction(m_Impl.get(), &Impl::OnMaskRegionModified);
+  observation.observers.push_back(std::make_pair(mask, mask->AddObserver(mitk::ImageRegionModifiedEvent(), command)));
+  observation.observers.push_back(m_Impl->AddDeleteObserver(mask));
+  if (image != mask) {
+    observation.observers.push_back(m_Impl->AddDeleteObserver(image));
+  }
+
+  m_Impl->m_Observations.emplace(mask, std::move(observation));
+}
+
+void mitk::ImageStatisticsContainerManager::StopObservingMask(const mitk::Image* mask)
+{
+  m_Impl->StopObservingMask(mask, nullptr);
+}
@@ -20,11 +20,20 @@ found in the LICENSE file.
 #include <mitkNodePredicateBase.h>
 #include <mitkGenericIDRelationRule.h>
 #include <mitkPropertyRelations.h>
+#include <mitkImage.h>
+
+#include <itkImageRegion.h>
+
+#include <memory>
 
 namespace mitk
 {
   /**
   \brief Returns the StatisticsContainer that was computed on given input (image/mask/planar figure) and is added as DataNode in a DataStorage
+
+  An instance additionally keeps the statistics of containers up to date after changes of a region of image or mask
+  (see UpdateImageStatistics() and ObserveMask()). Instances are not thread-safe and must be used by the thread that
+  modifies the images, like the data storage.
   */
   class MITKIMAGESTATISTICS_EXPORT ImageStatisticsContainerManager
   {
@@ -38,8 +47,52 @@ namespace mitk
     */
     static mitk::ImageStatisticsContainer::ConstPointer GetImageStatistics(const mitk::DataStorage* dataStorage, const mitk::BaseData* image, const mitk::BaseData* mask=nullptr);
 
+    ImageStatisticsContainerManager();
+    ~ImageStatisticsContainerManager();
+
+    ImageStatisticsContainerManager(const ImageStatisticsContainerManager&) = delete;
+    ImageStatisticsContainerManager& operator=(const ImageStatisticsContainerManager&) = delete;
+
+    /**Documentation
+    @brief Updates the statistics of the given label in the StatisticContainer of image and mask after a change of image or mask
+    inside dirtyRegion (index coordinates, e.g. the slice written by a DiffSliceOperation).
+    @return true if the container was updated, false if no container is found, the label vanished or image and mask are
+    not supported (the statistics have to be recomputed by ImageStatisticsCalculator then)
+    @details Block-wise statistics of the label are kept by this manager per container. Only blocks intersecting dirtyRegion
+    are rescanned. The block statistics are recomputed completely on the first call and whenever the container was modified
+    elsewhere. They do not keep image, mask or container alive and are dropped when one of them is deleted.
+    @pre Datastorage must point to a valid instance.
+    @pre image and mask must point to valid instances.
+    */
+    bool UpdateImageStatistics(const mitk::DataStorage* dataStorage, const mitk::Image* image, const mitk::Image* mask,
+      const itk::ImageRegion<3>& dirtyRegion, TimeStepType timeStep = 0, ImageStatisticsContainer::LabelIndex label = 1);
+
+    /**Documentation
+    @brief Same as above with the changed region given by a geometry in world coordinates (e.g. the bounding box of a tool's modification).
+    */
+    bool UpdateImageStatistics(const mitk::DataStorage* dataStorage, const mitk::Image* image, const mitk::Image* mask,
+      const mitk::BaseGeometry* dirtyGeometry, TimeStepType timeStep = 0, ImageStatisticsContainer::LabelIndex label = 1);
+
+    /**Documentation
+    @brief Updates the statistics of image and mask whenever the mask reports a changed region by an ImageRegionModifiedEvent,
+    as the segmentation tools and their undo/redo operations do.
+    @details The observation ends with StopObservingMask(), the deletion of image or mask or the destruction of this manager.
+    The data storage is kept alive as long as the mask is observed.
+    */
+    void ObserveMask(const mitk::DataStorage* dataStorage, const mitk::Image* image, const mitk::Image* mask,
+      ImageStatisticsContainer::LabelIndex label = 1);
+
+    void StopObservingMask(const mitk::Image* mask);
+
   protected:
     static mitk::NodePredicateBase::ConstPointer GetPredicateForSources(const mitk::BaseData* image, const mitk::BaseData* mask = nullptr);
+
+    /** Returns the newest StatisticContainer of image and mask as it is stored in the data storage, or nullptr. */
+    static mitk::ImageStatisticsContainer* GetStoredImageStatistics(const mitk::DataStorage* dataStorage, const mitk::BaseData* image, const mitk::BaseData* mask);
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_Impl;
   };
 }
 #endif
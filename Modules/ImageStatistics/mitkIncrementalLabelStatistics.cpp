@@ -0,0 +1,530 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkIncrementalLabelStatistics.h"
+
+#include <mitkHistogramStatisticsCalculator.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageStatisticsConstants.h>
+
+#include <itkImageIOBase.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  /** Calls function with a value of the pixel type given by the ITK component type. */
+  template <typename TFunction>
+  void CallForComponentType(int componentType, TFunction function)
+  {
+    switch (componentType)
+    {
+      case itk::ImageIOBase::UCHAR:
+        function(static_cast<unsigned char>(0));
+        break;
+      case itk::ImageIOBase::CHAR:
+        function(static_cast<char>(0));
+        break;
+      case itk::ImageIOBase::USHORT:
+        function(static_cast<unsigned short>(0));
+        break;
+      case itk::ImageIOBase::SHORT:
+        function(static_cast<short>(0));
+        break;
+      case itk::ImageIOBase::UINT:
+        function(static_cast<unsigned int>(0));
+        break;
+      case itk::ImageIOBase::INT:
+        function(static_cast<int>(0));
+        break;
+      case itk::ImageIOBase::ULONG:
+        function(static_cast<unsigned long>(0));
+        break;
+      case itk::ImageIOBase::LONG:
+        function(static_cast<long>(0));
+        break;
+      case itk::ImageIOBase::FLOAT:
+        function(static_cast<float>(0));
+        break;
+      case itk::ImageIOBase::DOUBLE:
+        function(static_cast<double>(0));
+        break;
+      default:
+        mitkThrow() << "Pixel type not supported by IncrementalLabelStatistics.";
+    }
+  }
+
+  template <typename TMaskPixel>
+  void ReadMembership(const TMaskPixel *mask,
+                      const std::array<std::size_t, 3> &dimensions,
+                      const mitk::IncrementalLabelStatistics::RegionType &region,
+                      mitk::IncrementalLabelStatistics::LabelIndex label,
+                      std::vector<char> &membership)
+  {
+    membership.resize(region.GetNumberOfPixels());
+    const double labelValue = static_cast<double>(label);
+    std::size_t i = 0;
+    for (std::size_t z = region.GetIndex(2); z < region.GetIndex(2) + region.GetSize(2); ++z)
+    {
+      for (std::size_t y = region.GetIndex(1); y < region.GetIndex(1) + region.GetSize(1); ++y)
+      {
+        const TMaskPixel *line = mask + (z * dimensions[1] + y) * dimensions[0] + region.GetIndex(0);
+        for (std::size_t x = 0; x < region.GetSize(0); ++x)
+        {
+          membership[i++] = static_cast<double>(line[x]) == labelValue;
+        }
+      }
+    }
+  }
+}
+
+mitk::IncrementalLabelStatistics::IncrementalLabelStatistics()
+  : m_TimeStep(0),
+    m_MaskTimeStep(0),
+    m_Label(1),
+    m_NumberOfBins(100),
+    m_HistogramLowerBound(0.0),
+    m_HistogramUpperBound(0.0),
+    m_NumberOfScannedBlocks(0)
+{
+  m_Dimensions.fill(0);
+  m_NumberOfBlocks.fill(0);
+}
+
+mitk::IncrementalLabelStatistics::~IncrementalLabelStatistics()
+{
+}
+
+void mitk::IncrementalLabelStatistics::Initialize(
+  const Image *image, const Image *mask, TimeStepType timeStep, LabelIndex label, unsigned int numberOfBins)
+{
+  if (nullptr == image || nullptr == mask)
+  {
+    mitkThrow() << "Image and mask must not be nullptr.";
+  }
+
+  if (image->GetDimension() > 4 || image->GetPixelType().GetNumberOfComponents() != 1)
+  {
+    mitkThrow() << "Only scalar images with up to three spatial dimensions are supported.";
+  }
+
+  if (timeStep >= image->GetTimeSteps())
+  {
+    mitkThrow() << "Time step " << timeStep << " is out of range.";
+  }
+
+  for (int i = 0; i < 3; ++i)
+  {
+    if (image->GetDimension(i) != mask->GetDimension(i))
+    {
+      mitkThrow() << "Image and mask differ in size.";
+    }
+    m_Dimensions[i] = image->GetDimension(i);
+    m_NumberOfBlocks[i] = (m_Dimensions[i] + BlockSize - 1) / BlockSize;
+  }
+
+  m_Image = image;
+  m_Mask = mask;
+  m_TimeStep = timeStep;
+  m_MaskTimeStep = std::min<TimeStepType>(timeStep, mask->GetTimeSteps() - 1);
+  m_Label = label;
+  m_NumberOfBins = std::max(numberOfBins, 1u);
+
+  m_Blocks.clear();
+  m_Blocks.resize(m_NumberOfBlocks[0] * m_NumberOfBlocks[1] * m_NumberOfBlocks[2]);
+
+  std::vector<std::size_t> allBlocks(m_Blocks.size());
+  for (std::size_t block = 0; block < allBlocks.size(); ++block)
+  {
+    allBlocks[block] = block;
+  }
+
+  // the histogram range is the intensity range of the label, so histograms need a second scan
+  m_BinMinimums.clear();
+  m_BinMaximums.clear();
+  this->ScanBlocks(allBlocks, false);
+  unsigned int numberOfScannedBlocks = m_NumberOfScannedBlocks;
+
+  BlockStatistics total;
+  this->SumUpBlocks(total);
+  this->InitializeHistogramBins(total.m_Minimum, total.m_Maximum);
+
+  std::vector<std::size_t> labelBlocks;
+  for (std::size_t block = 0; block < m_Blocks.size(); ++block)
+  {
+    if (m_Blocks[block].m_Count > 0)
+    {
+      labelBlocks.push_back(block);
+    }
+  }
+  this->ScanBlocks(labelBlocks, true);
+  m_NumberOfScannedBlocks += numberOfScannedBlocks;
+}
+
+bool mitk::IncrementalLabelStatistics::IsInitializedFor(const Image *image,
+                                                        const Image *mask,
+                                                        TimeStepType timeStep,
+                                                        LabelIndex label) const
+{
+  return !m_Blocks.empty() && m_Image == image && m_Mask == mask && timeStep == m_TimeStep && label == m_Label;
+}
+
+void mitk::IncrementalLabelStatistics::Update(const RegionType &dirtyRegion)
+{
+  if (m_Blocks.empty())
+  {
+    mitkThrow() << "IncrementalLabelStatistics must be initialized before updating.";
+  }
+
+  RegionType::SizeType size;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    size[i] = m_Dimensions[i];
+  }
+  RegionType region = dirtyRegion;
+  if (!region.Crop(RegionType(size)))
+  {
+    m_NumberOfScannedBlocks = 0;
+    return;
+  }
+
+  std::array<std::size_t, 3> firstBlock;
+  std::array<std::size_t, 3> lastBlock;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    firstBlock[i] = region.GetIndex(i) / BlockSize;
+    lastBlock[i] = (region.GetIndex(i) + region.GetSize(i) - 1) / BlockSize;
+  }
+
+  std::vector<std::size_t> dirtyBlocks;
+  for (std::size_t z = firstBlock[2]; z <= lastBlock[2]; ++z)
+  {
+    for (std::size_t y = firstBlock[1]; y <= lastBlock[1]; ++y)
+    {
+      for (std::size_t x = firstBlock[0]; x <= lastBlock[0]; ++x)
+      {
+        dirtyBlocks.push_back((z * m_NumberOfBlocks[1] + y) * m_NumberOfBlocks[0] + x);
+      }
+    }
+  }
+
+  this->ScanBlocks(dirtyBlocks, false);
+
+  BlockStatistics total;
+  this->SumUpBlocks(total);
+  if (total.m_Count > 0 && (total.m_Minimum != m_HistogramLowerBound || total.m_Maximum != m_HistogramUpperBound))
+  {
+    // the bins depend on the intensity range, rebuild the histograms of all blocks of the label
+    unsigned int numberOfScannedBlocks = m_NumberOfScannedBlocks;
+    this->InitializeHistogramBins(total.m_Minimum, total.m_Maximum);
+
+    std::vector<std::size_t> labelBlocks;
+    for (std::size_t block = 0; block < m_Blocks.size(); ++block)
+    {
+      if (m_Blocks[block].m_Count > 0)
+      {
+        labelBlocks.push_back(block);
+      }
+    }
+    this->ScanBlocks(labelBlocks, true);
+    m_NumberOfScannedBlocks += numberOfScannedBlocks;
+  }
+}
+
+mitk::IncrementalLabelStatistics::RegionType mitk::IncrementalLabelStatistics::GetBlockRegion(std::size_t block) const
+{
+  RegionType::IndexType index;
+  RegionType::SizeType size;
+
+  std::array<std::size_t, 3> blockIndex;
+  blockIndex[0] = block % m_NumberOfBlocks[0];
+  blockIndex[1] = (block / m_NumberOfBlocks[0]) % m_NumberOfBlocks[1];
+  blockIndex[2] = block / (m_NumberOfBlocks[0] * m_NumberOfBlocks[1]);
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    index[i] = blockIndex[i] * BlockSize;
+    size[i] = std::min<std::size_t>(BlockSize, m_Dimensions[i] - index[i]);
+  }
+
+  return RegionType(index, size);
+}
+
+void mitk::IncrementalLabelStatistics::ScanBlocks(const std::vector<std::size_t> &blocks, bool histogramOnly)
+{
+  ImageReadAccessor imageAccessor(m_Image.GetPointer(), m_Image->GetVolumeData(m_TimeStep));
+  ImageReadAccessor maskAccessor(m_Mask.GetPointer(), m_Mask->GetVolumeData(m_MaskTimeStep));
+
+  std::vector<char> membership;
+  for (std::size_t block : blocks)
+  {
+    const RegionType region = this->GetBlockRegion(block);
+
+    CallForComponentType(m_Mask->GetPixelType().GetComponentType(), [&](auto maskPixel) {
+      using MaskPixelType = decltype(maskPixel);
+      ReadMembership(static_cast<const MaskPixelType *>(maskAccessor.GetData()), m_Dimensions, region, m_Label, membership);
+    });
+
+    BlockStatistics &statistics = m_Blocks[block];
+    CallForComponentType(m_Image->GetPixelType().GetComponentType(), [&](auto pixel) {
+      using PixelType = decltype(pixel);
+      this->AccumulateBlock(static_cast<const PixelType *>(imageAccessor.GetData()), region, membership, histogramOnly, statistics);
+    });
+  }
+
+  m_NumberOfScannedBlocks = blocks.size();
+}
+
+template <typename TPixel>
+void mitk::IncrementalLabelStatistics::AccumulateBlock(const TPixel *image,
+                                                       const RegionType &region,
+                                                       const std::vector<char> &membership,
+                                                       bool histogramOnly,
+                                                       BlockStatistics &statistics) const
+{
+  if (!histogramOnly)
+  {
+    statistics = BlockStatistics();
+  }
+
+  if (!m_BinMinimums.empty())
+  {
+    statistics.m_Histogram.assign(m_NumberOfBins, 0);
+  }
+  else
+  {
+    statistics.m_Histogram.clear();
+  }
+
+  const double interval = (m_HistogramUpperBound - m_HistogramLowerBound) / m_NumberOfBins;
+  const long lastBin = static_cast<long>(m_NumberOfBins) - 1;
+
+  std::size_t i = 0;
+  for (std::size_t z = region.GetIndex(2); z < region.GetIndex(2) + region.GetSize(2); ++z)
+  {
+    for (std::size_t y = region.GetIndex(1); y < region.GetIndex(1) + region.GetSize(1); ++y)
+    {
+      const std::size_t lineOffset = (z * m_Dimensions[1] + y) * m_Dimensions[0] + region.GetIndex(0);
+      for (std::size_t x = 0; x < region.GetSize(0); ++x, ++i)
+      {
+        if (!membership[i])
+        {
+          continue;
+        }
+
+        const double value = static_cast<double>(image[lineOffset + x]);
+
+        if (!histogramOnly)
+        {
+          if (statistics.m_Count == 0 || value < statistics.m_Minimum)
+          {
+            statistics.m_Minimum = value;
+            statistics.m_MinimumOffset = lineOffset + x;
+          }
+          if (statistics.m_Count == 0 || value > statistics.m_Maximum)
+          {
+            statistics.m_Maximum = value;
+            statistics.m_MaximumOffset = lineOffset + x;
+          }
+
+          const double square = value * value;
+          ++statistics.m_Count;
+          statistics.m_Sum += value;
+          statistics.m_SumOfSquares += square;
+          statistics.m_SumOfCubes += square * value;
+          statistics.m_SumOfQuadruples += square * square;
+          if (value > 0)
+          {
+            ++statistics.m_PositivePixelCount;
+            statistics.m_SumOfPositivePixels += value;
+          }
+        }
+
+        if (!statistics.m_Histogram.empty())
+        {
+          // same bin as Histogram::GetIndex() would assign, see MultiLabelStatisticsAccumulator
+          long bin = interval > 0 ? static_cast<long>((value - m_HistogramLowerBound) / interval) : lastBin;
+          bin = std::max(0L, std::min(bin, lastBin));
+          while (bin > 0 && value < m_BinMinimums[bin])
+          {
+            --bin;
+          }
+          while (bin < lastBin && value >= m_BinMaximums[bin])
+          {
+            ++bin;
+          }
+          ++statistics.m_Histogram[bin];
+        }
+      }
+    }
+  }
+}
+
+void mitk::IncrementalLabelStatistics::InitializeHistogramBins(double lowerBound, double upperBound)
+{
+  // the bins are taken from a histogram initialized like the ones of ImageStatisticsCalculator
+  ImageStatisticsContainer::HistogramType::Pointer histogram = ImageStatisticsContainer::HistogramType::New();
+  ImageStatisticsContainer::HistogramType::SizeType size(1);
+  ImageStatisticsContainer::HistogramType::MeasurementVectorType lower(1);
+  ImageStatisticsContainer::HistogramType::MeasurementVectorType upper(1);
+  histogram->SetMeasurementVectorSize(1);
+  size[0] = m_NumberOfBins;
+  lower[0] = lowerBound;
+  upper[0] = upperBound;
+  histogram->Initialize(size, lower, upper);
+
+  m_HistogramLowerBound = lowerBound;
+  m_HistogramUpperBound = upperBound;
+  m_BinMinimums.resize(m_NumberOfBins);
+  m_BinMaximums.resize(m_NumberOfBins);
+  for (unsigned int bin = 0; bin < m_NumberOfBins; ++bin)
+  {
+    m_BinMinimums[bin] = histogram->GetBinMin(0, bin);
+    m_BinMaximums[bin] = histogram->GetBinMax(0, bin);
+  }
+}
+
+void mitk::IncrementalLabelStatistics::SumUpBlocks(BlockStatistics &total) const
+{
+  total = BlockStatistics();
+  for (const auto &block : m_Blocks)
+  {
+    if (block.m_Count == 0)
+    {
+      continue;
+    }
+
+    // blocks are not in scan order, equal extrema are resolved by the smaller offset
+    if (total.m_Count == 0 || block.m_Minimum < total.m_Minimum ||
+        (block.m_Minimum == total.m_Minimum && block.m_MinimumOffset < total.m_MinimumOffset))
+    {
+      total.m_Minimum = block.m_Minimum;
+      total.m_MinimumOffset = block.m_MinimumOffset;
+    }
+    if (total.m_Count == 0 || block.m_Maximum > total.m_Maximum ||
+        (block.m_Maximum == total.m_Maximum && block.m_MaximumOffset < total.m_MaximumOffset))
+    {
+      total.m_Maximum = block.m_Maximum;
+      total.m_MaximumOffset = block.m_MaximumOffset;
+    }
+
+    total.m_Count += block.m_Count;
+    total.m_PositivePixelCount += block.m_PositivePixelCount;
+    total.m_Sum += block.m_Sum;
+    total.m_SumOfSquares += block.m_SumOfSquares;
+    total.m_SumOfCubes += block.m_SumOfCubes;
+    total.m_SumOfQuadruples += block.m_SumOfQuadruples;
+    total.m_SumOfPositivePixels += block.m_SumOfPositivePixels;
+
+    if (!block.m_Histogram.empty())
+    {
+      total.m_Histogram.resize(block.m_Histogram.size(), 0);
+      for (std::size_t bin = 0; bin < block.m_Histogram.size(); ++bin)
+      {
+        total.m_Histogram[bin] += block.m_Histogram[bin];
+      }
+    }
+  }
+}
+
+itk::SizeValueType mitk::IncrementalLabelStatistics::GetCount() const
+{
+  itk::SizeValueType count = 0;
+  for (const auto &block : m_Blocks)
+  {
+    count += block.m_Count;
+  }
+  return count;
+}
+
+mitk::ImageStatisticsContainer::ImageStatisticsObject mitk::IncrementalLabelStatistics::GetStatistics() const
+{
+  BlockStatistics total;
+  this->SumUpBlocks(total);
+  if (total.m_Count == 0)
+  {
+    mitkThrow() << "Label " << m_Label << " is not present in the mask.";
+  }
+
+  // same definitions as in ImageStatisticsCalculator
+  const double count = static_cast<double>(total.m_Count);
+  const double mean = total.m_Sum / count;
+  const double mpp = total.m_SumOfPositivePixels / static_cast<double>(total.m_PositivePixelCount);
+  const double variance = (total.m_SumOfSquares - total.m_Sum * total.m_Sum / count) / count;
+  const double secondMoment = total.m_SumOfSquares / count;
+  const double thirdMoment = total.m_SumOfCubes / count;
+  const double fourthMoment = total.m_SumOfQuadruples / count;
+  const double skewness = (thirdMoment - 3. * secondMoment * mean + 2. * std::pow(mean, 3.)) /
+                          std::pow(secondMoment - std::pow(mean, 2.), 1.5);
+  const double kurtosis =
+    (fourthMoment - 4. * thirdMoment * mean + 6. * secondMoment * std::pow(mean, 2.) - 3. * std::pow(mean, 4.)) /
+    std::pow(secondMoment - std::pow(mean, 2.), 2.);
+  const double sigma = std::sqrt(variance);
+
+  double voxelVolume = 1.;
+  const auto spacing = m_Image->GetGeometry()->GetSpacing();
+  for (unsigned int i = 0; i < std::min(m_Image->GetDimension(), 3u); ++i)
+  {
+    voxelVolume *= spacing[i];
+  }
+
+  ImageStatisticsContainer::HistogramType::Pointer histogram = ImageStatisticsContainer::HistogramType::New();
+  ImageStatisticsContainer::HistogramType::SizeType size(1);
+  ImageStatisticsContainer::HistogramType::MeasurementVectorType lower(1);
+  ImageStatisticsContainer::HistogramType::MeasurementVectorType upper(1);
+  histogram->SetMeasurementVectorSize(1);
+  size[0] = m_NumberOfBins;
+  lower[0] = m_HistogramLowerBound;
+  upper[0] = m_HistogramUpperBound;
+  histogram->Initialize(size, lower, upper);
+  for (unsigned int bin = 0; bin < total.m_Histogram.size(); ++bin)
+  {
+    histogram->SetFrequency(bin, total.m_Histogram[bin]);
+  }
+
+  HistogramStatisticsCalculator histStatCalc;
+  histStatCalc.SetHistogram(histogram);
+  histStatCalc.CalculateStatistics();
+
+  auto offsetToIndex = [this](std::size_t offset) {
+    ImageStatisticsContainer::IndexType index;
+    index.set_size(3);
+    index[0] = offset % m_Dimensions[0];
+    index[1] = (offset / m_Dimensions[0]) % m_Dimensions[1];
+    index[2] = offset / (m_Dimensions[0] * m_Dimensions[1]);
+    return index;
+  };
+
+  ImageStatisticsContainer::ImageStatisticsObject statObj;
+  statObj.AddStatistic(ImageStatisticsConstants::MINIMUMPOSITION(), offsetToIndex(total.m_MinimumOffset));
+  statObj.AddStatistic(ImageStatisticsConstants::MAXIMUMPOSITION(), offsetToIndex(total.m_MaximumOffset));
+  statObj.AddStatistic(ImageStatisticsConstants::NUMBEROFVOXELS(),
+                       static_cast<ImageStatisticsContainer::VoxelCountType>(total.m_Count));
+  statObj.AddStatistic(ImageStatisticsConstants::VOLUME(), count * voxelVolume);
+  statObj.AddStatistic(ImageStatisticsConstants::MEAN(), mean);
+  statObj.AddStatistic(ImageStatisticsConstants::MINIMUM(), total.m_Minimum);
+  statObj.AddStatistic(ImageStatisticsConstants::MAXIMUM(), total.m_Maximum);
+  statObj.AddStatistic(ImageStatisticsConstants::STANDARDDEVIATION(), sigma);
+  statObj.AddStatistic(ImageStatisticsConstants::VARIANCE(), sigma * sigma);
+  statObj.AddStatistic(ImageStatisticsConstants::SKEWNESS(), skewness);
+  statObj.AddStatistic(ImageStatisticsConstants::KURTOSIS(), kurtosis);
+  statObj.AddStatistic(ImageStatisticsConstants::RMS(), std::sqrt(std::pow(mean, 2.) + variance));
+  statObj.AddStatistic(ImageStatisticsConstants::MPP(), mpp);
+  statObj.AddStatistic(ImageStatisticsConstants::ENTROPY(), histStatCalc.GetEntropy());
+  statObj.AddStatistic(ImageStatisticsConstants::MEDIAN(), histStatCalc.GetMedian());
+  statObj.AddStatistic(ImageStatisticsConstants::UNIFORMITY(), histStatCalc.GetUniformity());
+  statObj.AddStatistic(ImageStatisticsConstants::UPP(), histStatCalc.GetUPP());
+  statObj.m_Histogram = histogram.GetPointer();
+
+  return statObj;
+}
@@ -0,0 +1,127 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKINCREMENTALLABELSTATISTICS
+#define MITKINCREMENTALLABELSTATISTICS
+
+#include <MitkImageStatisticsExports.h>
+#include <mitkImage.h>
+#include <mitkImageStatisticsContainer.h>
+
+#include <itkImageRegion.h>
+#include <itkWeakPointer.h>
+
+#include <array>
+
+namespace mitk
+{
+  /**
+   * @brief Statistics of one label of a mask that can be updated for a changed region of image or mask.
+   *
+   * Initialize() divides the time step of the image into blocks of BlockSize^3 voxels and keeps count, sums of
+   * powers, extrema and histogram of the label for each block. Update() rescans only the blocks that intersect the
+   * changed region and sums up the blocks again. If the intensity range of the label changes, the histograms of
+   * all blocks containing the label are rebuilt for the new range.
+   *
+   * The resulting statistics equal those of ImageStatisticsCalculator with an ImageMaskGenerator for the same mask.
+   * Image and mask must have the same size and the image must have scalar pixels.
+   *
+   * Image and mask are not kept alive. The owner has to drop the object when one of them is deleted
+   * (see ImageStatisticsContainerManager).
+   */
+  class MITKIMAGESTATISTICS_EXPORT IncrementalLabelStatistics : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(IncrementalLabelStatistics, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    using RegionType = itk::ImageRegion<3>;
+    using LabelIndex = ImageStatisticsContainer::LabelIndex;
+
+    static const unsigned int BlockSize = 32;
+
+    /**
+     * @brief Computes the block statistics of the label for the given time step.
+     * @throws mitk::Exception if image and mask are not compatible
+     */
+    void Initialize(
+      const Image *image, const Image *mask, TimeStepType timeStep, LabelIndex label, unsigned int numberOfBins);
+
+    /** @brief Checks whether Initialize() has been called with the given parameters. */
+    bool IsInitializedFor(const Image *image, const Image *mask, TimeStepType timeStep, LabelIndex label) const;
+
+    /** @brief Recomputes the statistics of all blocks that intersect @a dirtyRegion (in index coordinates). */
+    void Update(const RegionType &dirtyRegion);
+
+    /** @brief Number of voxels of the label. */
+    itk::SizeValueType GetCount() const;
+
+    /** @brief Statistics in the form ImageStatisticsCalculator provides them. Requires GetCount() > 0. */
+    ImageStatisticsContainer::ImageStatisticsObject GetStatistics() const;
+
+    /** @brief Number of blocks rescanned by the last call of Initialize() or Update(). */
+    itkGetConstMacro(NumberOfScannedBlocks, unsigned int);
+
+  protected:
+    IncrementalLabelStatistics();
+    ~IncrementalLabelStatistics() override;
+
+  private:
+    struct BlockStatistics
+    {
+      itk::SizeValueType m_Count = 0;
+      itk::SizeValueType m_PositivePixelCount = 0;
+      double m_Sum = 0.0;
+      double m_SumOfSquares = 0.0;
+      double m_SumOfCubes = 0.0;
+      double m_SumOfQuadruples = 0.0;
+      double m_SumOfPositivePixels = 0.0;
+      double m_Minimum = 0.0;
+      double m_Maximum = 0.0;
+      std::size_t m_MinimumOffset = 0;
+      std::size_t m_MaximumOffset = 0;
+      std::vector<itk::SizeValueType> m_Histogram;
+    };
+
+    void ScanBlocks(const std::vector<std::size_t> &blocks, bool histogramOnly);
+
+    template <typename TPixel>
+    void AccumulateBlock(const TPixel *image,
+                         const RegionType &region,
+                         const std::vector<char> &membership,
+                         bool histogramOnly,
+                         BlockStatistics &statistics) const;
+    void InitializeHistogramBins(double lowerBound, double upperBound);
+    void SumUpBlocks(BlockStatistics &total) const;
+    RegionType GetBlockRegion(std::size_t block) const;
+
+    itk::WeakPointer<const Image> m_Image;
+    itk::WeakPointer<const Image> m_Mask;
+    TimeStepType m_TimeStep;
+    TimeStepType m_MaskTimeStep;
+    LabelIndex m_Label;
+    unsigned int m_NumberOfBins;
+
+    std::array<std::size_t, 3> m_Dimensions;
+    std::array<std::size_t, 3> m_NumberOfBlocks;
+    std::vector<BlockStatistics> m_Blocks;
+
+    double m_HistogramLowerBound;
+    double m_HistogramUpperBound;
+    std::vector<double> m_BinMinimums;
+    std::vector<double> m_BinMaximums;
+
+    unsigned int m_NumberOfScannedBlocks;
+  };
+}
+
+#endif // MITKINCREMENTALLABELSTATISTICS
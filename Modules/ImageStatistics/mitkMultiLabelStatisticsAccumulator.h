@@ -0,0 +1,135 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKMULTILABELSTATISTICSACCUMULATOR
+#define MITKMULTILABELSTATISTICSACCUMULATOR
+
+#include <itkImage.h>
+#include <itkHistogram.h>
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+
+#include <map>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * @brief Accumulates intensity statistics of all labels of a label image at once.
+   *
+   * Image and label image must have the same buffered region. ComputeStatistics() runs over both buffers
+   * in one multi-threaded pass and accumulates count, moments, minimum and maximum (with their first position
+   * in scan order) for every label present. Consecutive pixels with the same label are accumulated in a
+   * tight loop over the intensity buffer, which the compiler can vectorize.
+   *
+   * Histograms depend on the intensity range of each label and are filled by a second pass,
+   * ComputeHistograms(), only for the labels passed to it.
+   */
+  template <class TPixel, unsigned int VImageDimension>
+  class MultiLabelStatisticsAccumulator : public itk::Object
+  {
+  public:
+    /** Standard Self typedef */
+    typedef MultiLabelStatisticsAccumulator     Self;
+    typedef itk::Object                         Superclass;
+    typedef itk::SmartPointer< Self >           Pointer;
+    typedef itk::SmartPointer< const Self >     ConstPointer;
+
+    /** Method for creation through the object factory. */
+    itkNewMacro(Self)
+
+    /** Runtime information support. */
+    itkTypeMacro(MultiLabelStatisticsAccumulator, itk::Object)
+
+    typedef itk::Image<TPixel, VImageDimension> ImageType;
+    typedef unsigned short LabelPixelType;
+    typedef itk::Image<LabelPixelType, VImageDimension> LabelImageType;
+    typedef itk::Statistics::Histogram<double> HistogramType;
+
+    struct LabelStatistics
+    {
+      itk::SizeValueType m_Count = 0;
+      itk::SizeValueType m_PositivePixelCount = 0;
+      double m_Sum = 0.0;
+      double m_SumOfSquares = 0.0;
+      double m_SumOfCubes = 0.0;
+      double m_SumOfQuadruples = 0.0;
+      double m_SumOfPositivePixels = 0.0;
+      double m_Minimum = 0.0;
+      double m_Maximum = 0.0;
+      itk::OffsetValueType m_MinimumOffset = -1;
+      itk::OffsetValueType m_MaximumOffset = -1;
+
+      double m_Mean = 0.0;
+      double m_Variance = 0.0;
+      double m_Skewness = 0.0;
+      double m_Kurtosis = 0.0;
+      double m_MPP = 0.0;
+
+      HistogramType::Pointer m_Histogram;
+      double m_Median = 0.0;
+      double m_Entropy = 0.0;
+      double m_Uniformity = 0.0;
+      double m_UPP = 0.0;
+    };
+
+    typedef std::map<LabelPixelType, LabelStatistics> StatisticsMapType;
+
+    void SetInput(const ImageType *image);
+    void SetLabelInput(const LabelImageType *labelImage);
+
+    /** Number of threads used by both passes, 0 means the ITK default. */
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
+    /**
+     * @brief Computes count, moments, minimum and maximum of all labels in one pass. Throws if the buffered
+     * regions of image and label image differ.
+     */
+    void ComputeStatistics();
+
+    /**
+     * @brief Fills a histogram for each of the given labels, spanning the label's intensity range with the
+     * given number of bins. ComputeStatistics() must have been called before.
+     */
+    void ComputeHistograms(const std::map<LabelPixelType, unsigned int> &numberOfBins);
+
+    /** @brief Labels present in the label image, sorted ascending. */
+    std::vector<LabelPixelType> GetRelevantLabels() const;
+
+    bool HasLabel(LabelPixelType label) const;
+
+    const LabelStatistics &GetStatistics(LabelPixelType label) const;
+
+    typename ImageType::IndexType GetMinimumIndex(LabelPixelType label) const;
+    typename ImageType::IndexType GetMaximumIndex(LabelPixelType label) const;
+
+  protected:
+    MultiLabelStatisticsAccumulator() : m_Image(nullptr), m_LabelImage(nullptr), m_NumberOfThreads(0) {}
+    ~MultiLabelStatisticsAccumulator() override {}
+
+  private:
+    unsigned int GetNumberOfChunks(std::size_t numberOfPixels) const;
+
+    typename ImageType::ConstPointer m_Image;
+    typename LabelImageType::ConstPointer m_LabelImage;
+    unsigned int m_NumberOfThreads;
+
+    StatisticsMapType m_Statistics;
+  };
+}
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "mitkMultiLabelStatisticsAccumulator.hxx"
+#endif
+
+#endif // MITKMULTILABELSTATISTICSACCUMULATOR
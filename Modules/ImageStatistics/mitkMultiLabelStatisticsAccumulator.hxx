@@ -0,0 +1,430 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKMULTILABELSTATISTICSACCUMULATOR_HXX
+#define MITKMULTILABELSTATISTICSACCUMULATOR_HXX
+
+#include "mitkMultiLabelStatisticsAccumulator.h"
+
+#include <itkMultiThreader.h>
+#include <mitkHistogramStatisticsCalculator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace mitk
+{
+  namespace MultiLabelStatisticsAccumulatorDetail
+  {
+    /** Calls function(chunk) for chunk in [0, numberOfChunks), each chunk in its own thread. */
+    template <class TFunction>
+    void RunChunks(unsigned int numberOfChunks, const TFunction &function)
+    {
+      std::vector<std::thread> threads;
+      for (unsigned int chunk = 1; chunk < numberOfChunks; ++chunk)
+      {
+        threads.emplace_back(function, chunk);
+      }
+      function(0);
+      for (auto &thread : threads)
+      {
+        thread.join();
+      }
+    }
+  }
+
+  template <class TPixel, unsigned int VImageDimension>
+  void MultiLabelStatisticsAccumulator<TPixel, VImageDimension>::SetInput(const ImageType *image)
+  {
+    if (image != m_Image)
+    {
+      m_Image = image;
+      this->Modified();
+    }
+  }
+
+  template <class TPixel, unsigned int VImageDimension>
+  void MultiLabelStatisticsAccumulator<TPixel, VImageDimension>::SetLabelInput(const LabelImageType *labelImage)
+  {
+    if (labelImage != m_LabelImage)
+    {
+      m_LabelImage = labelImage;
+      this->Modified();
+    }
+  }
+
+  template <class TPixel, unsigned int VImageDimension>
+  unsigned int MultiLabelStatisticsAccumulator<TPixel, VImageDimension>::GetNumberOfChunks(
+    std::size_t numberOfPixels) const
+  {
+    unsigned int numberOfThreads =
+      m_NumberOfThreads > 0 ? m_NumberOfThreads : itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+
+    // do not start threads for less than 2^16 pixels each
+    const std::size_t maximumNumberOfChunks = numberOfPixels / 65536 + 1;
+    return static_cast<unsigned int>(std::max<std::size_t>(1, std::min<std::size_t>(numberOfThreads, maximumNumberOfChunks)));
+  }
+
+  template <class TPixel, unsigned int VImageDimension>
+  void MultiLabelStatisticsAccumulator<TPixel, VImageDimension>::ComputeStatistics()
+  {
+    if (m_Image.IsNull() || m_LabelImage.IsNull())
+    {
+      itkExceptionMacro(<< "Image and label image must be set.");
+    }
+
+    if (m_Image->GetBufferedRegion() != m_LabelImage->GetBufferedRegion())
+    {
+      itkExceptionMacro(<< "Buffered regions of image and label image differ.");
+    }
+
+    const TPixel *values = m_Image->GetBufferPointer();
+    const LabelPixelType *labels = m_LabelImage->GetBufferPointer();
+    const std::size_t numberOfPixels = m_Image->GetBufferedRegion().GetNumberOfPixels();
+    const unsigned int numberOfChunks = this->GetNumberOfChunks(numberOfPixels);
+
+    // dense tables indexed by label value, grown to the largest label met in the chunk
+    std::vector<std::vector<LabelStatistics>> chunkStatistics(numberOfChunks);
+
+    auto accumulateChunk = [&](unsigned int chunk) {
+      const std::size_t begin = numberOfPixels * chunk / numberOfChunks;
+      const std::size_t end = numberOfPixels * (chunk + 1) / numberOfChunks;
+      std::vector<LabelStatistics> &statistics = chunkStatistics[chunk];
+
+      std::size_t runBegin = begin;
+      while (runBegin < end)
+      {
+        const LabelPixelType label = labels[runBegin];
+        std::size_t runEnd = runBegin + 1;
+        while (runEnd < end && labels[runEnd] == label)
+        {
+          ++runEnd;
+        }
+
+        if (label >= statistics.size())
+        {
+          statistics.resize(label + 1);
+        }
+        LabelStatistics &labelStats = statistics[label];
+
+        // the run has a single label, so its intensities are accumulated without any branching on the label
+        double sum = 0.0;
+        double sumOfSquares = 0.0;
+        double sumOfCubes = 0.0;
+        double sumOfQuadruples = 0.0;
+        double sumOfPositivePixels = 0.0;
+        itk::SizeValueType positivePixelCount = 0;
+        double runMinimum = static_cast<double>(values[runBegin]);
+        double runMaximum = runMinimum;
+        for (std::size_t i = runBegin; i < runEnd; ++i)
+        {
+          const double value = static_cast<double>(values[i]);
+          const double square = value * value;
+          sum += value;
+          sumOfSquares += square;
+          sumOfCubes += square * value;
+          sumOfQuadruples += square * square;
+          const bool positive = value > 0;
+          positivePixelCount += positive;
+          sumOfPositivePixels += positive ? value : 0.0;
+          runMinimum = value < runMinimum ? value : runMinimum;
+          runMaximum = value > runMaximum ? value : runMaximum;
+        }
+
+        // positions are only searched if the run holds a new extremum
+        if (labelStats.m_Count == 0 || runMinimum < labelStats.m_Minimum)
+        {
+          labelStats.m_Minimum = runMinimum;
+          std::size_t i = runBegin;
+          while (i + 1 < runEnd && static_cast<double>(values[i]) != runMinimum)
+          {
+            ++i;
+          }
+          labelStats.m_MinimumOffset = i;
+        }
+        if (labelStats.m_Count == 0 || runMaximum > labelStats.m_Maximum)
+        {
+          labelStats.m_Maximum = runMaximum;
+          std::size_t i = runBegin;
+          while (i + 1 < runEnd && static_cast<double>(values[i]) != runMaximum)
+          {
+            ++i;
+          }
+          labelStats.m_MaximumOffset = i;
+        }
+
+        labelStats.m_Count += runEnd - runBegin;
+        labelStats.m_Sum += sum;
+        labelStats.m_SumOfSquares += sumOfSquares;
+        labelStats.m_SumOfCubes += sumOfCubes;
+        labelStats.m_SumOfQuadruples += sumOfQuadruples;
+        labelStats.m_SumOfPositivePixels += sumOfPositivePixels;
+        labelStats.m_PositivePixelCount += positivePixelCount;
+
+        runBegin = runEnd;
+      }
+    };
+
+    MultiLabelStatisticsAccumulatorDetail::RunChunks(numberOfChunks, accumulateChunk);
+
+    // merge the chunks in scan order, so that the first extremum in scan order wins
+    m_Statistics.clear();
+    for (const auto &statistics : chunkStatistics)
+    {
+      for (std::size_t label = 0; label < statistics.size(); ++label)
+      {
+        const LabelStatistics &chunkStats = statistics[label];
+        if (chunkStats.m_Count == 0)
+        {
+          continue;
+        }
+
+        auto insertion = m_Statistics.insert(std::make_pair(static_cast<LabelPixelType>(label), chunkStats));
+        if (insertion.second)
+        {
+          continue;
+        }
+
+        LabelStatistics &labelStats = insertion.first->second;
+        if (chunkStats.m_Minimum < labelStats.m_Minimum)
+        {
+          labelStats.m_Minimum = chunkStats.m_Minimum;
+          labelStats.m_MinimumOffset = chunkStats.m_MinimumOffset;
+        }
+        if (chunkStats.m_Maximum > labelStats.m_Maximum)
+        {
+          labelStats.m_Maximum = chunkStats.m_Maximum;
+          labelStats.m_MaximumOffset = chunkStats.m_MaximumOffset;
+        }
+        labelStats.m_Count += chunkStats.m_Count;
+        labelStats.m_Sum += chunkStats.m_Sum;
+        labelStats.m_SumOfSquares += chunkStats.m_SumOfSquares;
+        labelStats.m_SumOfCubes += chunkStats.m_SumOfCubes;
+        labelStats.m_SumOfQuadruples += chunkStats.m_SumOfQuadruples;
+        labelStats.m_SumOfPositivePixels += chunkStats.m_SumOfPositivePixels;
+        labelStats.m_PositivePixelCount += chunkStats.m_PositivePixelCount;
+      }
+    }
+
+    // same definitions as in itk::ExtendedLabelStatisticsImageFilter
+    for (auto &entry : m_Statistics)
+    {
+      LabelStatistics &ls = entry.second;
+      const double count = static_cast<double>(ls.m_Count);
+
+      ls.m_Mean = ls.m_Sum / count;
+      ls.m_MPP = ls.m_SumOfPositivePixels / static_cast<double>(ls.m_PositivePixelCount);
+      ls.m_Variance = (ls.m_SumOfSquares - ls.m_Sum * ls.m_Sum / count) / count;
+
+      const double secondMoment = ls.m_SumOfSquares / count;
+      const double thirdMoment = ls.m_SumOfCubes / count;
+      const double fourthMoment = ls.m_SumOfQuadruples / count;
+      const double mean = ls.m_Mean;
+
+      ls.m_Skewness = (thirdMoment - 3. * secondMoment * mean + 2. * std::pow(mean, 3.)) /
+                      std::pow(secondMoment - std::pow(mean, 2.), 1.5);
+      ls.m_Kurtosis =
+        (fourthMoment - 4. * thirdMoment * mean + 6. * secondMoment * std::pow(mean, 2.) - 3. * std::pow(mean, 4.)) /
+        std::pow(secondMoment - std::pow(mean, 2.), 2.);
+
+      ls.m_Histogram = nullptr;
+      ls.m_Median = 0.0;
+      ls.m_Entropy = 0.0;
+      ls.m_Uniformity = 0.0;
+      ls.m_UPP = 0.0;
+    }
+  }
+
+  template <class TPixel, unsigned int VImageDimension>
+  void MultiLabelStatisticsAccumulator<TPixel, VImageDimension>::ComputeHistograms(
+    const std::map<LabelPixelType, unsigned int> &numberOfBins)
+  {
+    struct HistogramSetup
+    {
+      LabelStatistics *statistics;
+      unsigned int numberOfBins;
+      double lowerBound;
+      double interval;
+      std::vector<double> binMinimums;
+      std::vector<double> binMaximums;
+    };
+
+    std::vector<HistogramSetup> setups;
+    std::vector<int> setupOfLabel;
+
+    for (const auto &labelBins : numberOfBins)
+    {
+      auto statisticsIt = m_Statistics.find(labelBins.first);
+      if (statisticsIt == m_Statistics.end() || labelBins.second == 0)
+      {
+        continue;
+      }
+
+      LabelStatistics &ls = statisticsIt->second;
+
+      // initialized like the histograms of itk::ExtendedLabelStatisticsImageFilter
+      ls.m_Histogram = HistogramType::New();
+      typename HistogramType::SizeType size;
+      typename HistogramType::MeasurementVectorType lowerBound;
+      typename HistogramType::MeasurementVectorType upperBound;
+      size.SetSize(1);
+      lowerBound.SetSize(1);
+      upperBound.SetSize(1);
+      ls.m_Histogram->SetMeasurementVectorSize(1);
+      size[0] = labelBins.second;
+      lowerBound[0] = ls.m_Minimum;
+      upperBound[0] = ls.m_Maximum;
+      ls.m_Histogram->Initialize(size, lowerBound, upperBound);
+
+      HistogramSetup setup;
+      setup.statistics = &ls;
+      setup.numberOfBins = labelBins.second;
+      setup.lowerBound = ls.m_Minimum;
+      setup.interval = (ls.m_Maximum - ls.m_Minimum) / labelBins.second;
+      for (unsigned int bin = 0; bin < labelBins.second; ++bin)
+      {
+        setup.binMinimums.push_back(ls.m_Histogram->GetBinMin(0, bin));
+        setup.binMaximums.push_back(ls.m_Histogram->GetBinMax(0, bin));
+      }
+
+      if (labelBins.first >= setupOfLabel.size())
+      {
+        setupOfLabel.resize(labelBins.first + 1, -1);
+      }
+      setupOfLabel[labelBins.first] = static_cast<int>(setups.size());
+      setups.push_back(std::move(setup));
+    }
+
+    if (setups.empty())
+    {
+      return;
+    }
+
+    const TPixel *values = m_Image->GetBufferPointer();
+    const LabelPixelType *labels = m_LabelImage->GetBufferPointer();
+    const std::size_t numberOfPixels = m_Image->GetBufferedRegion().GetNumberOfPixels();
+    const unsigned int numberOfChunks = this->GetNumberOfChunks(numberOfPixels);
+
+    std::vector<std::vector<std::vector<itk::SizeValueType>>> chunkFrequencies(numberOfChunks);
+
+    auto fillChunk = [&](unsigned int chunk) {
+      const std::size_t begin = numberOfPixels * chunk / numberOfChunks;
+      const std::size_t end = numberOfPixels * (chunk + 1) / numberOfChunks;
+      auto &frequencies = chunkFrequencies[chunk];
+      frequencies.resize(setups.size());
+      for (std::size_t i = 0; i < setups.size(); ++i)
+      {
+        frequencies[i].assign(setups[i].numberOfBins, 0);
+      }
+
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        const LabelPixelType label = labels[i];
+        if (label >= setupOfLabel.size() || setupOfLabel[label] < 0)
+        {
+          continue;
+        }
+
+        const HistogramSetup &setup = setups[setupOfLabel[label]];
+        const double value = static_cast<double>(values[i]);
+        const long lastBin = static_cast<long>(setup.numberOfBins) - 1;
+
+        long bin = setup.interval > 0 ? static_cast<long>((value - setup.lowerBound) / setup.interval) : lastBin;
+        bin = std::max(0L, std::min(bin, lastBin));
+
+        // correct rounding errors, so that every value ends up in the same bin as with Histogram::GetIndex()
+        while (bin > 0 && value < setup.binMinimums[bin])
+        {
+          --bin;
+        }
+        while (bin < lastBin && value >= setup.binMaximums[bin])
+        {
+          ++bin;
+        }
+
+        ++frequencies[setupOfLabel[label]][bin];
+      }
+    };
+
+    MultiLabelStatisticsAccumulatorDetail::RunChunks(numberOfChunks, fillChunk);
+
+    for (std::size_t i = 0; i < setups.size(); ++i)
+    {
+      LabelStatistics &ls = *setups[i].statistics;
+      for (unsigned int bin = 0; bin < setups[i].numberOfBins; ++bin)
+      {
+        itk::SizeValueType frequency = 0;
+        for (const auto &frequencies : chunkFrequencies)
+        {
+          frequency += frequencies[i][bin];
+        }
+        ls.m_Histogram->SetFrequency(bin, frequency);
+      }
+
+      mitk::HistogramStatisticsCalculator histStatCalc;
+      histStatCalc.SetHistogram(ls.m_Histogram);
+      histStatCalc.CalculateStatistics();
+      ls.m_Median = histStatCalc.GetMedian();
+      ls.m_Entropy = histStatCalc.GetEntropy();
+      ls.m_Uniformity = histStatCalc.GetUniformity();
+      ls.m_UPP = histStatCalc.GetUPP();
+    }
+  }
+
+  template <class TPixel, unsigned int VImageDimension>
+  std::vector<typename MultiLabelStatisticsAccumulator<TPixel, VImageDimension>::LabelPixelType>
+    MultiLabelStatisticsAccumulator<TPixel, VImageDimension>::GetRelevantLabels() const
+  {
+    std::vector<LabelPixelType> relevantLabels;
+    relevantLabels.reserve(m_Statistics.size());
+    for (const auto &entry : m_Statistics)
+    {
+      relevantLabels.push_back(entry.first);
+    }
+    return relevantLabels;
+  }
+
+  template <class TPixel, unsigned int VImageDimension>
+  bool MultiLabelStatisticsAccumulator<TPixel, VImageDimension>::HasLabel(LabelPixelType label) const
+  {
+    return m_Statistics.find(label) != m_Statistics.end();
+  }
+
+  template <class TPixel, unsigned int VImageDimension>
+  const typename MultiLabelStatisticsAccumulator<TPixel, VImageDimension>::LabelStatistics &
+    MultiLabelStatisticsAccumulator<TPixel, VImageDimension>::GetStatistics(LabelPixelType label) const
+  {
+    auto it = m_Statistics.find(label);
+    if (it == m_Statistics.end())
+    {
+      itkExceptionMacro(<< "Label " << label << " is not present in the label image.");
+    }
+    return it->second;
+  }
+
+  template <class TPixel, unsigned int VImageDimension>
+  typename MultiLabelStatisticsAccumulator<TPixel, VImageDimension>::ImageType::IndexType
+    MultiLabelStatisticsAccumulator<TPixel, VImageDimension>::GetMinimumIndex(LabelPixelType label) const
+  {
+    return m_Image->ComputeIndex(this->GetStatistics(label).m_MinimumOffset);
+  }
+
+  template <class TPixel, unsigned int VImageDimension>
+  typename MultiLabelStatisticsAccumulator<TPixel, VImageDimension>::ImageType::IndexType
+    MultiLabelStatisticsAccumulator<TPixel, VImageDimension>::GetMaximumIndex(LabelPixelType label) const
+  {
+    return m_Image->ComputeIndex(this->GetStatistics(label).m_MaximumOffset);
+  }
+}
+
+#endif
@@ -58,6 +58,11 @@ namespace mitk
     itkSetMacro(ActivateFailureThreshold, bool);
     itkGetConstMacro(ActivateFailureThreshold, bool);
 
+    /**If set to true (default), the analytic derivatives of models that support them
+     (see ModelBase::HasAnalyticDerivative()) are used. Otherwise the derivatives are computed numerically.*/
+    itkSetMacro(UseAnalyticDerivative, bool);
+    itkGetConstMacro(UseAnalyticDerivative, bool);
+
     ParameterNamesType GetCriterionNames() const override;
 
   protected:
@@ -96,6 +101,8 @@ namespace mitk
     /**If set to true and an constraint checker is set. The cost function will allways fail if the penalty of the
      checker reaches the threshold. In this case no function evaluation will be done-*/
     bool m_ActivateFailureThreshold;
+
+    bool m_UseAnalyticDerivative;
   };
 
 }
@@ -32,7 +32,10 @@ namespace mitk
  * The decorator has a failure threshold. An evaluation
  * can always be accounted as a failure if the sum of penalties given by the checker
  * is greater or equal to the threshold. If the evaluation is a failure the wrapped cost function
- * will not be evaluated. Otherwise the penalty will be added to every measure of the cost function.
+ * will not be evaluated. Otherwise the penalty will be added to every measure of the cost function.\n
+ * The model is only evaluated by the wrapped cost function. The derivative is the derivative of the wrapped
+ * cost function (analytic if supported) plus the numerical derivative of the penalty sum. Close to the failure
+ * threshold the whole measure is derived numerically.
  */
 class MITKMODELFIT_EXPORT MVConstrainedCostFunctionDecorator : public mitk::MVModelFitCostFunction
 {
@@ -74,10 +77,19 @@ public:
 
     /**Returns the index of the first (in terms of index position) failed parameter in the last failed evaluation.*/
     ParametersType::size_type GetFailedParameter() const;
+
+    /**Reimplementation that skips the evaluation of the model, because CalcMeasure() only uses
+     the wrapped cost function.*/
+    MeasureType GetValue(const ParametersType& parameter) const override;
+    void GetDerivative(const ParametersType &parameters, DerivativeType &derivative) const override;
+
 protected:
 
     MeasureType CalcMeasure(const ParametersType &parameters, const SignalType& signal) const override;
 
+    /**Returns true if the penalty sum reaches the failure threshold (and the threshold is activated).*/
+    bool IsFailure(PenaltyValueType penalty) const;
+
     MVConstrainedCostFunctionDecorator() : m_FailureThreshold(1e15), m_ActivateFailureThreshold(true),
       m_EvaluationCount(0), m_PenaltyCount(0), m_FailureCount(0), m_LastFailedParameter(-1)
     {
@@ -26,6 +26,9 @@ namespace mitk
 /** Base class for all model fit cost function that return a multiple cost value
  * It offers also a default implementation for the numerical computation of the
  * derivatives. Normaly you just have to (re)implement CalcMeasure().
+ * If the model computes its derivative analytically (ModelBase::HasAnalyticDerivative()) and the
+ * cost function reimplements CalcMeasureDerivative(), GetDerivative() uses the analytic derivatives
+ * instead of evaluating the model twice per parameter.
 */
 class MITKMODELFIT_EXPORT MVModelFitCostFunction : public itk::MultipleValuedCostFunction, public ModelFitCostFunctionInterface
 {
@@ -54,11 +57,27 @@ public:
     itkSetMacro(DerivativeStepLength, double);
     itkGetConstMacro(DerivativeStepLength, double);
 
+    /** If set to false, the derivatives are always computed numerically. Default is true.*/
+    itkSetMacro(UseAnalyticDerivative, bool);
+    itkGetConstMacro(UseAnalyticDerivative, bool);
+    itkBooleanMacro(UseAnalyticDerivative);
+
 protected:
 
     virtual MeasureType CalcMeasure(const ParametersType &parameters, const SignalType& signal) const = 0;
 
-    MVModelFitCostFunction() : m_DerivativeStepLength(1e-5)
+    /** Indicates if the cost function implements CalcMeasureDerivative(). Default implementation returns false.*/
+    virtual bool HasAnalyticMeasureDerivative() const;
+
+    /** Computes the derivative of the measure given the signal of the model and the derivative of the signal
+     * (see ModelBase::GetSignalAndDerivative()). Default implementation throws an exception.*/
+    virtual void CalcMeasureDerivative(const ParametersType &parameters, const SignalType& signal,
+      const ModelBase::ModelDerivativeType& signalDerivative, DerivativeType& derivative) const;
+
+    /** Computes the derivative by central differences of GetValue() using the derivative step length.*/
+    void CalcNumericDerivative(const ParametersType &parameters, DerivativeType &derivative) const;
+
+    MVModelFitCostFunction() : m_DerivativeStepLength(1e-5), m_UseAnalyticDerivative(true)
     {
     }
 
@@ -71,6 +90,8 @@ private:
 
     /**value (delta of parameters) used to compute the derivatives numerically*/
     double m_DerivativeStepLength;
+
+    bool m_UseAnalyticDerivative;
 };
 
 }
@@ -57,6 +57,9 @@ namespace mitk
     typedef ModelTraitsInterface::ModelResultType ModelResultType;
     typedef ModelTraitsInterface::ParameterValueType ParameterValueType;
     typedef ModelTraitsInterface::ParametersType ParametersType;
+    /** Type of the derivative of the signal with respect to the parameters.
+     * Element [i][j] is the derivative of signal value j with respect to parameter i.*/
+    typedef itk::Array2D<double> ModelDerivativeType;
     /** Type defining the time grid used be models.
      * @remark the model time grid has a resolution in sec and not like the time geometry which uses ms.*/
     typedef itk::Array<double> TimeGridType;
@@ -168,10 +171,31 @@ namespace mitk
 
     ModelResultType GetSignal(const ParametersType& parameters) const;
 
+    /** Indicates if the model computes the derivative of its signal with respect to the parameters
+     * analytically (see GetSignalAndDerivative()). Cost functions fall back to a numerical derivative
+     * otherwise.
+     * @remark Default implementation returns false.*/
+    virtual bool HasAnalyticDerivative() const;
+
+    /** Computes the signal and its derivative with respect to the parameters in one pass.
+     * The model is validated like in GetSignal().
+     * @pre HasAnalyticDerivative() must return true.
+     * @param parameters The parameters of the model.
+     * @param [out] signal The signal of the model.
+     * @param [out] derivative Derivative of the signal; size is number of parameters x signal size.*/
+    void GetSignalAndDerivative(const ParametersType& parameters, ModelResultType& signal,
+                                ModelDerivativeType& derivative) const;
+
   protected:
 
     virtual ModelResultType ComputeModelfunction(const ParametersType& parameters) const = 0;
 
+    /** Helper function called by GetSignalAndDerivative(). Reimplement it together with
+     * HasAnalyticDerivative() in derived classes that can compute their derivatives analytically.
+     * @remark Default implementation throws an exception.*/
+    virtual void ComputeModelDerivative(const ParametersType& parameters, ModelResultType& signal,
+                                        ModelDerivativeType& derivative) const;
+
     /** Member is called by GetSignal() before ComputeModelfunction(). It indicates if model is in a valid state and
      * ready to compute the signal. The default implementation checks nothing and always returns true.
      * Reimplement to realize special behavior for derived classes.
@@ -36,6 +36,10 @@ namespace mitk
    * - criterion images: Images that encode the criterion value of the fitting strategy for the fitted parameters
    * - evaluation parameter images: Images that encode measures of additional evaluation cost functions defined by the user. (These were not part of the fitting strategy)
    * .
+   * The voxels to fit (all voxels or the voxels inside the mask) are split into blocks of BlockSize voxels.
+   * Worker threads take the next unprocessed block until all blocks are fitted, so the load is balanced
+   * even if the fits of some image regions take much longer. Each worker copies the signals of its block
+   * from the dynamic image into a time-contiguous buffer once and reuses its buffers for all voxels.
    */
 class MITKMODELFIT_EXPORT PixelBasedParameterFitImageGenerator: public ParameterFitImageGeneratorBase
 {
@@ -71,6 +75,14 @@ public:
     itkGetMacro(TimeGridByParameterizer, bool);
     itkBooleanMacro(TimeGridByParameterizer);
 
+    /** Number of threads used for the fit. 0 (default) uses itk::MultiThreader::GetGlobalDefaultNumberOfThreads().*/
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
+    /** Number of voxels that are fitted by one thread in a row. Default is 64.*/
+    itkSetClampMacro(BlockSize, unsigned int, 1, itk::NumericTraits<unsigned int>::max());
+    itkGetConstMacro(BlockSize, unsigned int);
+
     double GetProgress() const override;
 
     ParameterNamesType GetParameterNames() const override;
@@ -82,7 +94,8 @@ public:
     ParameterNamesType GetEvaluationParameterNames() const override;
 
 protected:
-  PixelBasedParameterFitImageGenerator() : m_Progress(0), m_TimeGridByParameterizer(false)
+  PixelBasedParameterFitImageGenerator() : m_Progress(0), m_TimeGridByParameterizer(false), m_NumberOfThreads(0),
+    m_BlockSize(64)
   {
     m_InternalMask = nullptr;
     m_Mask = nullptr;
@@ -97,8 +110,6 @@ protected:
     template <typename TPixel, unsigned int VDim>
     void DoPrepareMask(itk::Image<TPixel, VDim>* image);
 
-    void onFitProgressEvent(::itk::Object* caller, const ::itk::EventObject& eventObject);
-
     bool HasOutdatedResult() const override;
     void CheckValidInputs() const override;
     void DoFitAndGetResults(ParameterImageMapType& parameterImages, ParameterImageMapType& derivedParameterImages, ParameterImageMapType& criterionImages, ParameterImageMapType& evaluationParameterImages) override;
@@ -123,6 +134,9 @@ private:
     /**Indicates if the time grid defined in the parameterizer should be used (True)
     or if the filter should extract the time grid from the input image (False).*/
     bool m_TimeGridByParameterizer;
+
+    unsigned int m_NumberOfThreads;
+    unsigned int m_BlockSize;
 };
 
 }
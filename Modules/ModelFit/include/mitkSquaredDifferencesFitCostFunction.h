@@ -40,6 +40,12 @@ protected:
 
     MeasureType CalcMeasure(const ParametersType &parameters, const SignalType& signal) const override;
 
+    bool HasAnalyticMeasureDerivative() const override;
+
+    /** d measure[j] / d parameter[i] = -2 * (sample[j] - signal[j]) * d signal[j] / d parameter[i]*/
+    void CalcMeasureDerivative(const ParametersType &parameters, const SignalType& signal,
+      const ModelBase::ModelDerivativeType& signalDerivative, DerivativeType& derivative) const override;
+
     SquaredDifferencesFitCostFunction()
     {
     }
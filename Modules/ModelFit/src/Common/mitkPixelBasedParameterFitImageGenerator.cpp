@@ -10,29 +10,21 @@ found in the LICENSE file.
 
 ============================================================================*/
 
-#include "itkCommand.h"
-#include "itkMultiOutputNaryFunctorImageFilter.h"
+#include "itkCastImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMultiThreader.h"
 
 #include "mitkPixelBasedParameterFitImageGenerator.h"
-#include "mitkImageTimeSelector.h"
 #include "mitkImageAccessByItk.h"
 #include "mitkImageCast.h"
-#include "mitkModelFitFunctorPolicy.h"
 
 #include "mitkExtractTimeGrid.h"
 
-void
-  mitk::PixelBasedParameterFitImageGenerator::
-  onFitProgressEvent(::itk::Object* caller, const ::itk::EventObject& /*eventObject*/)
-{
-  this->InvokeEvent(::itk::ProgressEvent());
-
-  auto* process = dynamic_cast<itk::ProcessObject*>(caller);
-  if (process)
-  {
-    this->m_Progress = process->GetProgress();
-  }
-};
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 template <typename TPixel, unsigned int VDim>
 void
@@ -55,18 +47,18 @@ void
 }
 
 template<typename TImage>
-mitk::PixelBasedParameterFitImageGenerator::ParameterImageMapType StoreResultImages( mitk::ModelFitFunctorBase::ParameterNamesType &paramNames, itk::ImageSource<TImage>* source, mitk::ModelFitFunctorBase::ParameterNamesType::size_type startPos, mitk::ModelFitFunctorBase::ParameterNamesType::size_type& endPos )
+mitk::PixelBasedParameterFitImageGenerator::ParameterImageMapType StoreResultImages( mitk::ModelFitFunctorBase::ParameterNamesType &paramNames, const std::vector<typename TImage::Pointer>& outputs, mitk::ModelFitFunctorBase::ParameterNamesType::size_type startPos, mitk::ModelFitFunctorBase::ParameterNamesType::size_type& endPos )
 {
   mitk::PixelBasedParameterFitImageGenerator::ParameterImageMapType result;
   for (mitk::ModelFitFunctorBase::ParameterNamesType::size_type j = 0; j < paramNames.size(); ++j)
   {
-    if (source->GetNumberOfOutputs() < startPos+j)
+    if (outputs.size() <= startPos+j)
     {
-      mitkThrow() << "Error while generating fitted parameter images. Number of sources is too low and does not match expected parameter number. Output size: "<< source->GetNumberOfOutputs()<<"; number of param names: "<<paramNames.size()<<";source start pos: " << startPos;
+      mitkThrow() << "Error while generating fitted parameter images. Number of sources is too low and does not match expected parameter number. Output size: "<< outputs.size()<<"; number of param names: "<<paramNames.size()<<";source start pos: " << startPos;
     }
 
     mitk::Image::Pointer paramImage = mitk::Image::New();
-    typename TImage::ConstPointer outputImg = source->GetOutput(startPos+j);
+    typename TImage::ConstPointer outputImg = outputs[startPos+j].GetPointer();
     mitk::CastToMitkImage(outputImg, paramImage);
 
     result.insert(std::make_pair(paramNames[j],paramImage));
@@ -79,35 +71,11 @@ mitk::PixelBasedParameterFitImageGenerator::ParameterImageMapType StoreResultIma
 
 template <typename TPixel, unsigned int VDim>
 void
-  mitk::PixelBasedParameterFitImageGenerator::DoParameterFit(itk::Image<TPixel, VDim>* /*image*/)
+  mitk::PixelBasedParameterFitImageGenerator::DoParameterFit(itk::Image<TPixel, VDim>* image)
 {
-  using InputFrameImageType = itk::Image<TPixel, VDim-1>;
+  using InputImageType = itk::Image<TPixel, VDim>;
   using ParameterImageType = itk::Image<ScalarType, VDim-1>;
 
-  using FitFilterType = itk::MultiOutputNaryFunctorImageFilter<InputFrameImageType, ParameterImageType, ModelFitFunctorPolicy, InternalMaskType>;
-
-  typename FitFilterType::Pointer fitFilter = FitFilterType::New();
-
-  typename ::itk::MemberCommand<Self>::Pointer spProgressCommand = ::itk::MemberCommand<Self>::New();
-  spProgressCommand->SetCallbackFunction(this, &Self::onFitProgressEvent);
-  fitFilter->AddObserver(::itk::ProgressEvent(), spProgressCommand);
-
-  //add the time frames to the fit filter
-  mitk::ImageTimeSelector::Pointer imageTimeSelector = mitk::ImageTimeSelector::New();
-  imageTimeSelector->SetInput(this->m_DynamicImage);
-  std::vector<Image::Pointer> frameCache;
-  for (unsigned int i = 0; i < this->m_DynamicImage->GetTimeSteps(); ++i)
-  {
-    typename InputFrameImageType::Pointer frameImage;
-    imageTimeSelector->SetTimeNr(i);
-    imageTimeSelector->UpdateLargestPossibleRegion();
-
-    Image::Pointer frameMITKImage = imageTimeSelector->GetOutput();
-    frameCache.push_back(frameMITKImage);
-    mitk::CastToItkImage(frameMITKImage, frameImage);
-    fitFilter->SetInput(i,frameImage);
-  }
-
   ModelBaseType::TimeGridType timeGrid = ExtractTimeGrid(m_DynamicImage);
   if (m_TimeGridByParameterizer)
   {
@@ -122,39 +90,195 @@ void
     this->m_ModelParameterizer->SetDefaultTimeGrid(timeGrid);
   }
 
-  ModelFitFunctorPolicy functor;
+  //frame geometry of the parameter images
+  const typename InputImageType::RegionType inputRegion = image->GetBufferedRegion();
+  typename ParameterImageType::RegionType frameRegion;
+  typename ParameterImageType::SpacingType frameSpacing;
+  typename ParameterImageType::PointType frameOrigin;
+  typename ParameterImageType::DirectionType frameDirection;
+  for (unsigned int i = 0; i < VDim - 1; ++i)
+  {
+    frameRegion.SetIndex(i, inputRegion.GetIndex(i));
+    frameRegion.SetSize(i, inputRegion.GetSize(i));
+    frameSpacing[i] = image->GetSpacing()[i];
+    frameOrigin[i] = image->GetOrigin()[i];
+    for (unsigned int j = 0; j < VDim - 1; ++j)
+    {
+      frameDirection[i][j] = image->GetDirection()[i][j];
+    }
+  }
+
+  const std::size_t numberOfFrameVoxels = frameRegion.GetNumberOfPixels();
+  const std::size_t numberOfFrames = inputRegion.GetSize(VDim - 1);
 
-  functor.SetModelFitFunctor(this->m_FitFunctor);
-  functor.SetModelParameterizer(this->m_ModelParameterizer);
-  fitFilter->SetFunctor(functor);
+  //linear offsets (within a frame) of all voxels that should be fitted
+  std::vector<std::size_t> voxelOffsets;
   if (this->m_InternalMask.IsNotNull())
   {
-    fitFilter->SetMask(this->m_InternalMask);
+    if (!m_InternalMask->GetLargestPossibleRegion().IsInside(frameRegion))
+    {
+      mitkThrow() << "Cannot do fitting. Mask does not cover the dynamic image. Mask region: " << m_InternalMask->GetLargestPossibleRegion() << "; image region: " << frameRegion;
+    }
+
+    itk::ImageRegionConstIterator<InternalMaskType> maskIterator(m_InternalMask, frameRegion);
+    for (std::size_t offset = 0; !maskIterator.IsAtEnd(); ++maskIterator, ++offset)
+    {
+      if (maskIterator.Get() > 0)
+      {
+        voxelOffsets.push_back(offset);
+      }
+    }
   }
+  else
+  {
+    voxelOffsets.resize(numberOfFrameVoxels);
+    for (std::size_t offset = 0; offset < numberOfFrameVoxels; ++offset)
+    {
+      voxelOffsets[offset] = offset;
+    }
+  }
+
+  //allocate the outputs; voxels outside the mask stay 0
+  ModelBaseType::Pointer refModel = this->m_ModelParameterizer->GenerateParameterizedModel();
+  const unsigned int numberOfOutputs = this->m_FitFunctor->GetNumberOfOutputs(refModel);
+
+  std::vector<typename ParameterImageType::Pointer> outputs;
+  std::vector<ScalarType*> outputBuffers;
+  for (unsigned int i = 0; i < numberOfOutputs; ++i)
+  {
+    typename ParameterImageType::Pointer output = ParameterImageType::New();
+    output->SetRegions(frameRegion);
+    output->SetSpacing(frameSpacing);
+    output->SetOrigin(frameOrigin);
+    output->SetDirection(frameDirection);
+    output->Allocate();
+    output->FillBuffer(0.0);
+    outputs.push_back(output);
+    outputBuffers.push_back(output->GetBufferPointer());
+  }
+
+  const TPixel* inputBuffer = image->GetBufferPointer();
+  const FitFunctorType* fitFunctor = this->m_FitFunctor;
+  const ParameterizerType* parameterizer = this->m_ModelParameterizer;
+  const std::size_t blockSize = m_BlockSize;
+  const std::size_t numberOfBlocks = (voxelOffsets.size() + blockSize - 1) / blockSize;
+
+  unsigned int numberOfThreads = m_NumberOfThreads;
+  if (numberOfThreads == 0)
+    numberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  numberOfThreads = std::max<unsigned int>(1, std::min<std::size_t>(numberOfThreads, numberOfBlocks));
+
+  std::atomic<std::size_t> nextBlock(0);
+  std::atomic<std::size_t> fittedVoxels(0);
+  std::atomic<bool> abort(false);
+  std::exception_ptr error;
+  std::mutex errorMutex;
+
+  //only the calling thread reports the progress, so observers are not called concurrently
+  auto fitBlocks = [&](bool reportProgress)
+  {
+    try
+    {
+      std::vector<ScalarType> blockSignals;
+      FitFunctorType::InputPixelArrayType signal(numberOfFrames);
+      ParameterizerType::IndexType index;
+
+      for (std::size_t block = nextBlock++; block < numberOfBlocks && !abort; block = nextBlock++)
+      {
+        const std::size_t first = block * blockSize;
+        const std::size_t last = std::min(first + blockSize, voxelOffsets.size());
+        const std::size_t count = last - first;
+
+        //gather frame by frame, so every frame is read in order; the block buffer stays in cache
+        blockSignals.resize(count * numberOfFrames);
+        for (std::size_t frame = 0; frame < numberOfFrames; ++frame)
+        {
+          const TPixel* frameBuffer = inputBuffer + frame * numberOfFrameVoxels;
+          for (std::size_t voxel = 0; voxel < count; ++voxel)
+          {
+            blockSignals[voxel * numberOfFrames + frame] = static_cast<ScalarType>(frameBuffer[voxelOffsets[first + voxel]]);
+          }
+        }
+
+        for (std::size_t voxel = 0; voxel < count; ++voxel)
+        {
+          const std::size_t offset = voxelOffsets[first + voxel];
+          std::size_t remainder = offset;
+          for (unsigned int i = 0; i < VDim - 1; ++i)
+          {
+            index[i] = frameRegion.GetIndex(i) + static_cast<itk::IndexValueType>(remainder % frameRegion.GetSize(i));
+            remainder /= frameRegion.GetSize(i);
+          }
+
+          std::copy(blockSignals.begin() + voxel * numberOfFrames,
+                    blockSignals.begin() + (voxel + 1) * numberOfFrames, signal.begin());
+
+          ModelBaseType::Pointer parameterizedModel = parameterizer->GenerateParameterizedModel(index);
+          ParameterizerType::ParametersType initialParams = parameterizer->GetInitialParameterization(index);
+          FitFunctorType::OutputPixelArrayType result = fitFunctor->Compute(signal, parameterizedModel, initialParams);
+
+          if (result.size() != numberOfOutputs)
+          {
+            mitkThrow() << "Error. Number of output images do not equal number of outputs required by functor. Number of outputs: " << numberOfOutputs << "; functor output size:" << result.size();
+          }
+
+          for (unsigned int i = 0; i < numberOfOutputs; ++i)
+          {
+            outputBuffers[i][offset] = result[i];
+          }
+        }
+
+        const std::size_t fitted = (fittedVoxels += count);
+        if (reportProgress)
+        {
+          this->m_Progress = static_cast<double>(fitted) / voxelOffsets.size();
+          this->InvokeEvent(::itk::ProgressEvent());
+        }
+      }
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (!error)
+        error = std::current_exception();
+      abort = true;
+    }
+  };
 
-  //generate the fits
-  fitFilter->Update();
+  std::vector<std::thread> threads;
+  for (unsigned int thread = 1; thread < numberOfThreads; ++thread)
+    threads.emplace_back(fitBlocks, false);
+  fitBlocks(true);
+  for (auto &thread : threads)
+    thread.join();
+
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+
+  this->m_Progress = 1.0;
+  this->InvokeEvent(::itk::ProgressEvent());
 
   //convert the outputs into mitk images and fill the parameter image map
-  ModelBaseType::Pointer refModel = this->m_ModelParameterizer->GenerateParameterizedModel();
   ModelFitFunctorBase::ParameterNamesType paramNames = refModel->GetParameterNames();
   ModelFitFunctorBase::ParameterNamesType derivedParamNames = refModel->GetDerivedParameterNames();
   ModelFitFunctorBase::ParameterNamesType criterionNames = this->m_FitFunctor->GetCriterionNames();
   ModelFitFunctorBase::ParameterNamesType evaluationParamNames = this->m_FitFunctor->GetEvaluationParameterNames();
   ModelFitFunctorBase::ParameterNamesType debugParamNames = this->m_FitFunctor->GetDebugParameterNames();
 
-  if (fitFilter->GetNumberOfOutputs() != (paramNames.size() + derivedParamNames.size() + criterionNames.size() + evaluationParamNames.size() + debugParamNames.size()))
+  if (outputs.size() != (paramNames.size() + derivedParamNames.size() + criterionNames.size() + evaluationParamNames.size() + debugParamNames.size()))
   {
-    mitkThrow() << "Error while generating fitted parameter images. Fit filter output size does not match expected parameter number. Output size: "<< fitFilter->GetNumberOfOutputs();
+    mitkThrow() << "Error while generating fitted parameter images. Fit filter output size does not match expected parameter number. Output size: "<< outputs.size();
   }
 
   ModelFitFunctorBase::ParameterNamesType::size_type resultPos = 0;
-  this->m_TempResultMap = StoreResultImages<ParameterImageType>(paramNames,fitFilter,resultPos, resultPos);
-  this->m_TempDerivedResultMap = StoreResultImages<ParameterImageType>(derivedParamNames,fitFilter,resultPos, resultPos);
-  this->m_TempCriterionResultMap = StoreResultImages<ParameterImageType>(criterionNames,fitFilter,resultPos, resultPos);
-  this->m_TempEvaluationResultMap = StoreResultImages<ParameterImageType>(evaluationParamNames,fitFilter,resultPos, resultPos);
+  this->m_TempResultMap = StoreResultImages<ParameterImageType>(paramNames,outputs,resultPos, resultPos);
+  this->m_TempDerivedResultMap = StoreResultImages<ParameterImageType>(derivedParamNames,outputs,resultPos, resultPos);
+  this->m_TempCriterionResultMap = StoreResultImages<ParameterImageType>(criterionNames,outputs,resultPos, resultPos);
+  this->m_TempEvaluationResultMap = StoreResultImages<ParameterImageType>(evaluationParamNames,outputs,resultPos, resultPos);
   //also add debug params (if generated) to the evaluation result map
-  mitk::PixelBasedParameterFitImageGenerator::ParameterImageMapType debugMap = StoreResultImages<ParameterImageType>(debugParamNames, fitFilter, resultPos, resultPos);
+  mitk::PixelBasedParameterFitImageGenerator::ParameterImageMapType debugMap = StoreResultImages<ParameterImageType>(debugParamNames, outputs, resultPos, resultPos);
   this->m_TempEvaluationResultMap.insert(debugMap.begin(), debugMap.end());
 }
 
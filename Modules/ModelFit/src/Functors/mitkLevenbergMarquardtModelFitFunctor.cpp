@@ -20,7 +20,7 @@ found in the LICENSE file.
 mitk::LevenbergMarquardtModelFitFunctor::
 LevenbergMarquardtModelFitFunctor(): m_Epsilon(1e-5), m_GradientTolerance(1e-3),
   m_ValueTolerance(1e-5), m_Iterations(1000), m_DerivativeStepLength(1e-5),
-  m_ActivateFailureThreshold(true)
+  m_ActivateFailureThreshold(true), m_UseAnalyticDerivative(true)
 {};
 
 mitk::LevenbergMarquardtModelFitFunctor::
@@ -60,6 +60,7 @@ mitk::MVModelFitCostFunction::Pointer mitk::LevenbergMarquardtModelFitFunctor::G
   metric->SetModel(model);
   metric->SetSample(value);
   metric->SetDerivativeStepLength(m_DerivativeStepLength);
+  metric->SetUseAnalyticDerivative(m_UseAnalyticDerivative);
 
   mitk::MVModelFitCostFunction::Pointer result = metric.GetPointer();
 
@@ -74,6 +75,7 @@ mitk::MVModelFitCostFunction::Pointer mitk::LevenbergMarquardtModelFitFunctor::G
     decorator->SetModel(model);
     decorator->SetSample(value);
     decorator->SetActivateFailureThreshold(m_ActivateFailureThreshold);
+    decorator->SetDerivativeStepLength(m_DerivativeStepLength);
     result = decorator;
   }
 
@@ -16,6 +16,60 @@ found in the LICENSE file.
 
 #include <mitkExceptionMacro.h>
 
+mitk::MVConstrainedCostFunctionDecorator::MeasureType
+  mitk::MVConstrainedCostFunctionDecorator::GetValue(const ParametersType &parameter) const
+{
+  return CalcMeasure(parameter, SignalType());
+}
+
+void
+  mitk::MVConstrainedCostFunctionDecorator::GetDerivative(const ParametersType &parameters, DerivativeType &derivative) const
+{
+  if (m_ConstraintChecker.IsNull()) mitkThrow()<<"Error. Cannot calc derivative. Constraint checker is not set";
+  if (m_WrappedCostFunction.IsNull()) mitkThrow()<<"Error. Cannot calc derivative. Wrapped metric is not set";
+
+  const double stepLength = this->GetDerivativeStepLength();
+  const ParametersType::SizeValueType paramCount = parameters.Size();
+
+  // penalty derivative per parameter; if any evaluation fails, the measure is no
+  // smooth sum of both parts and the whole measure is derived numerically.
+  std::vector<PenaltyValueType> penaltyDerivative(paramCount, 0.0);
+  bool failure = IsFailure(m_ConstraintChecker->GetPenaltySum(parameters));
+  for (ParametersType::SizeValueType i = 0; i < paramCount && !failure; ++i)
+  {
+    ParametersType newParameters = parameters;
+    newParameters[i] -= stepLength;
+    PenaltyValueType p0 = m_ConstraintChecker->GetPenaltySum(newParameters);
+
+    newParameters[i] = parameters[i] + stepLength;
+    PenaltyValueType p1 = m_ConstraintChecker->GetPenaltySum(newParameters);
+
+    failure = IsFailure(p0) || IsFailure(p1);
+    penaltyDerivative[i] = (p1 - p0) / (2 * stepLength);
+  }
+
+  if (failure)
+  {
+    CalcNumericDerivative(parameters, derivative);
+    return;
+  }
+
+  m_WrappedCostFunction->GetDerivative(parameters, derivative);
+  for (unsigned int i = 0; i < derivative.rows(); ++i)
+  {
+    for (unsigned int j = 0; j < derivative.cols(); ++j)
+    {
+      derivative[i][j] += penaltyDerivative[i];
+    }
+  }
+}
+
+bool
+  mitk::MVConstrainedCostFunctionDecorator::IsFailure(PenaltyValueType penalty) const
+{
+  return m_ActivateFailureThreshold && penalty >= m_FailureThreshold;
+}
+
 mitk::MVConstrainedCostFunctionDecorator::MeasureType
   mitk::MVConstrainedCostFunctionDecorator::CalcMeasure(const ParametersType &parameters, const SignalType & /*signal*/) const
 {
@@ -30,7 +84,7 @@ mitk::MVConstrainedCostFunctionDecorator::MeasureType
   measure.SetSize(m_WrappedCostFunction->GetNumberOfValues());
   measure.Fill(penalty);
 
-  if (penalty<m_FailureThreshold || !m_ActivateFailureThreshold)
+  if (!IsFailure(penalty))
   {
     MeasureType wrappedMeasure = m_WrappedCostFunction->GetValue(parameters);
     if (wrappedMeasure.Size() != measure.Size()) mitkThrow()<<"Error. Cannot calc measure. Penalty measure and wrapped measure have different size. Penalty size:"<<measure.Size()<<"; wrapped measure size: "<<wrappedMeasure.Size();
@@ -30,6 +30,37 @@ mitk::MVModelFitCostFunction::MeasureType mitk::MVModelFitCostFunction::GetValue
 }
 
 void mitk::MVModelFitCostFunction::GetDerivative (const ParametersType &parameters, DerivativeType &derivative) const
+{
+  if (m_UseAnalyticDerivative && this->HasAnalyticMeasureDerivative() && m_Model->HasAnalyticDerivative())
+  {
+    SignalType signal;
+    ModelBase::ModelDerivativeType signalDerivative;
+    m_Model->GetSignalAndDerivative(parameters, signal, signalDerivative);
+
+    if(signal.GetSize() != m_Sample.GetSize()) itkExceptionMacro("Signal size does not matche sample size!");
+    if(signal.GetSize() == 0)  itkExceptionMacro("Signal is empty!");
+
+    CalcMeasureDerivative(parameters, signal, signalDerivative, derivative);
+  }
+  else
+  {
+    CalcNumericDerivative(parameters, derivative);
+  }
+};
+
+bool mitk::MVModelFitCostFunction::HasAnalyticMeasureDerivative() const
+{
+  return false;
+};
+
+void mitk::MVModelFitCostFunction::CalcMeasureDerivative(const ParametersType & /*parameters*/,
+  const SignalType & /*signal*/, const ModelBase::ModelDerivativeType & /*signalDerivative*/,
+  DerivativeType & /*derivative*/) const
+{
+  itkExceptionMacro("Cost function does not support analytic derivatives.");
+};
+
+void mitk::MVModelFitCostFunction::CalcNumericDerivative(const ParametersType &parameters, DerivativeType &derivative) const
 {
   ParametersType::SizeValueType paramCount = parameters.Size();
   MeasureType::SizeValueType measureCount = GetNumberOfValues();
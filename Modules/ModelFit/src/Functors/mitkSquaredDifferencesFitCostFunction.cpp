@@ -24,3 +24,22 @@ mitk::SquaredDifferencesFitCostFunction::MeasureType mitk::SquaredDifferencesFit
 
   return measure;
 }
+
+bool mitk::SquaredDifferencesFitCostFunction::HasAnalyticMeasureDerivative() const
+{
+  return true;
+}
+
+void mitk::SquaredDifferencesFitCostFunction::CalcMeasureDerivative(const ParametersType &/*parameters*/,
+  const SignalType &signal, const ModelBase::ModelDerivativeType &signalDerivative, DerivativeType &derivative) const
+{
+  derivative.SetSize(signalDerivative.rows(), signal.GetSize());
+
+  for (unsigned int i = 0; i < signalDerivative.rows(); ++i)
+  {
+    for (SignalType::size_type j = 0; j < signal.GetSize(); ++j)
+    {
+      derivative[i][j] = -2.0 * (m_Sample[j] - signal[j]) * signalDerivative[i][j];
+    }
+  }
+}
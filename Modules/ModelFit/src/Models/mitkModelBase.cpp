@@ -146,6 +146,37 @@ mitk::ModelBase::ModelResultType mitk::ModelBase::GetSignal(const ParametersType
   return signal;
 }
 
+bool mitk::ModelBase::HasAnalyticDerivative() const
+{
+  return false;
+};
+
+void mitk::ModelBase::GetSignalAndDerivative(const ParametersType& parameters, ModelResultType& signal,
+                                             ModelDerivativeType& derivative) const
+{
+  if (parameters.size() != this->GetNumberOfParameters())
+  {
+    itkExceptionMacro("Passed parameter set has wrong size for model. Cannot evaluate model derivative. Required size: "
+                      << this->GetNumberOfParameters() << "; passed parameters: " << parameters);
+  }
+
+  std::string error;
+
+  if (!ValidateModel(error))
+  {
+    itkExceptionMacro("Cannot evaluate model derivative. Model is in an invalid state. Validation error: "
+                      << error);
+  }
+
+  ComputeModelDerivative(parameters, signal, derivative);
+}
+
+void mitk::ModelBase::ComputeModelDerivative(const ParametersType& /*parameters*/, ModelResultType& /*signal*/,
+                                             ModelDerivativeType& /*derivative*/) const
+{
+  itkExceptionMacro("Model " << this->GetClassID() << " does not support analytic derivatives.");
+}
+
 bool mitk::ModelBase::ValidateModel(std::string& /*error*/) const
 {
   return true;
@@ -151,5 +151,17 @@ int mitkPixelBasedParameterFitImageGeneratorTest(int  /*argc*/, char*[] /*argv[]
     testValue = offsetAccessor2.GetPixelByIndex(testIndex6);
     MITK_TEST_CONDITION_REQUIRED(mitk::Equal(0,testValue, 1e-5, true)==true, "Check param #2 (offset) at index #6");
 
+    //Test that block size and thread count do not change the result
+    generator->SetBlockSize(1);
+    generator->SetNumberOfThreads(4);
+    MITK_TEST_CONDITION(generator->GetBlockSize() == 1, "Check block size.");
+    MITK_TEST_CONDITION(generator->GetNumberOfThreads() == 4, "Check number of threads.");
+
+    generator->Generate();
+
+    mitk::PixelBasedParameterFitImageGenerator::ParameterImageMapType blockResultImages = generator->GetParameterImages();
+    MITK_ASSERT_EQUAL(resultImages["slope"], blockResultImages["slope"], "Check slope image fitted in blocks of single voxels.");
+    MITK_ASSERT_EQUAL(resultImages["offset"], blockResultImages["offset"], "Check offset image fitted in blocks of single voxels.");
+
   MITK_TEST_END()
 }
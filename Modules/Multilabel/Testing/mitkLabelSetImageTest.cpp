@@ -11,11 +11,17 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include <mitkIOUtil.h>
+#include <mitkImagePixelReadAccessor.h>
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkImageRegionModifiedEvent.h>
 #include <mitkImageStatisticsHolder.h>
 #include <mitkLabelSetImage.h>
+#include <mitkPlaneGeometry.h>
 #include <mitkTestFixture.h>
 #include <mitkTestingMacros.h>
 
+#include <vtkImageData.h>
+
 class mitkLabelSetImageTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkLabelSetImageTestSuite);
@@ -34,6 +40,7 @@ class mitkLabelSetImageTestSuite : public mitk::TestFixture
   MITK_TEST(TestRemoveLayer);
   MITK_TEST(TestRemoveLabels);
   MITK_TEST(TestMergeLabel);
+  MITK_TEST(TestSparseLayerStorage);
   // TODO check it these functionalities can be moved into a process object
   //  MITK_TEST(TestMergeLabels);
   //  MITK_TEST(TestConcatenate);
@@ -439,6 +446,100 @@ public:
     // Check if merge label has 507 + 823 = 1330 pixels
     CPPUNIT_ASSERT_MESSAGE("Label with value 7 was not remove from the image", m_LabelSetImage->GetStatistics()->GetCountOfMaxValuedVoxels() == 1330);
   }
+
+  void TestSparseLayerStorage()
+  {
+    typedef mitk::LabelSetImage::PixelType PixelType;
+    itk::Index<3> index1 = {{10, 20, 30}};
+    itk::Index<3> index2 = {{100, 200, 300}};
+
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> accessor(m_LabelSetImage.GetPointer());
+      accessor.SetPixelByIndex(index1, 1);
+    }
+    m_LabelSetImage->SetSparseLayerStorage(true);
+    CPPUNIT_ASSERT_MESSAGE("Sparse layer storage not enabled", m_LabelSetImage->GetSparseLayerStorage());
+
+    unsigned int layerID = m_LabelSetImage->AddLayer();
+    {
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(m_LabelSetImage.GetPointer());
+      CPPUNIT_ASSERT_MESSAGE("New layer is not empty", accessor.GetPixelByIndex(index1) == 0);
+    }
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> accessor(m_LabelSetImage.GetPointer());
+      accessor.SetPixelByIndex(index2, 2);
+    }
+
+    m_LabelSetImage->SetActiveLayer(0);
+    {
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(m_LabelSetImage.GetPointer());
+      CPPUNIT_ASSERT_MESSAGE("Layer 0 not restored", accessor.GetPixelByIndex(index1) == 1);
+      CPPUNIT_ASSERT_MESSAGE("Layer 0 contains pixels of layer 1", accessor.GetPixelByIndex(index2) == 0);
+    }
+
+    // dense layer images are still available
+    {
+      const mitk::LabelSetImage *constLabelSetImage = m_LabelSetImage;
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(constLabelSetImage->GetLayerImage(layerID));
+      CPPUNIT_ASSERT_MESSAGE("Wrong layer image returned", accessor.GetPixelByIndex(index2) == 2);
+      CPPUNIT_ASSERT_MESSAGE("Wrong layer image returned", accessor.GetPixelByIndex(index1) == 0);
+    }
+
+    // changes to a decoded layer are encoded into the layer again
+    itk::Index<3> index3 = {{40, 50, 60}};
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> accessor(m_LabelSetImage->GetLayerImage(layerID));
+      accessor.SetPixelByIndex(index3, 3);
+    }
+    m_LabelSetImage->SetActiveLayer(layerID);
+    {
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(m_LabelSetImage.GetPointer());
+      CPPUNIT_ASSERT_MESSAGE("Change of the decoded layer lost", accessor.GetPixelByIndex(index3) == 3);
+    }
+
+    // slices written and reported like by the segmentation tools are encoded when switching the layer
+    *static_cast<PixelType *>(m_LabelSetImage->GetVtkImageData()->GetScalarPointer(index3[0], index3[1], index3[2])) = 4;
+    m_LabelSetImage->Modified();
+    auto planeGeometry = mitk::PlaneGeometry::New();
+    planeGeometry->InitializeStandardPlane(m_LabelSetImage->GetGeometry(), mitk::PlaneGeometry::Axial, index3[2]);
+    m_LabelSetImage->InvokeEvent(mitk::ImageRegionModifiedEvent(planeGeometry, 0));
+    m_LabelSetImage->SetActiveLayer(0);
+    m_LabelSetImage->SetActiveLayer(layerID);
+    {
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(m_LabelSetImage.GetPointer());
+      CPPUNIT_ASSERT_MESSAGE("Reported slice not encoded", accessor.GetPixelByIndex(index3) == 4);
+      CPPUNIT_ASSERT_MESSAGE("Layer 1 not restored", accessor.GetPixelByIndex(index2) == 2);
+    }
+    m_LabelSetImage->SetActiveLayer(0);
+
+    // slices of a layer are decoded without the rest of the layer
+    {
+      mitk::Image::Pointer slices = m_LabelSetImage->GetLayerSlices(layerID, 0, index2[2] - 1, index2[2] + 1);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong number of slices", 3u, slices->GetDimension(2));
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(slices);
+      itk::Index<3> sliceIndex = {{index2[0], index2[1], 1}};
+      CPPUNIT_ASSERT_MESSAGE("Wrong slices returned", accessor.GetPixelByIndex(sliceIndex) == 2);
+      sliceIndex[2] = 0;
+      CPPUNIT_ASSERT_MESSAGE("Wrong slices returned", accessor.GetPixelByIndex(sliceIndex) == 0);
+
+      mitk::Point3D slicesOrigin = slices->GetGeometry()->GetOrigin();
+      mitk::Point3D expectedOrigin;
+      mitk::Point3D firstSliceIndex;
+      firstSliceIndex.Fill(0);
+      firstSliceIndex[2] = index2[2] - 1;
+      m_LabelSetImage->GetGeometry()->IndexToWorld(firstSliceIndex, expectedOrigin);
+      CPPUNIT_ASSERT_MESSAGE("Slices are not at the position of the layer", mitk::Equal(expectedOrigin, slicesOrigin));
+    }
+
+    // switching back to dense storage keeps all layers
+    m_LabelSetImage->SetSparseLayerStorage(false);
+    m_LabelSetImage->SetActiveLayer(layerID);
+    {
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(m_LabelSetImage.GetPointer());
+      CPPUNIT_ASSERT_MESSAGE("Layer 1 not restored", accessor.GetPixelByIndex(index2) == 2);
+      CPPUNIT_ASSERT_MESSAGE("Layer 1 contains pixels of layer 0", accessor.GetPixelByIndex(index1) == 0);
+    }
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImage)
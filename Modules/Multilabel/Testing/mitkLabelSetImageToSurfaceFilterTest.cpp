@@ -0,0 +1,94 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkLabelSetImage.h>
+#include <mitkLabelSetImageToSurfaceFilter.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+class mitkLabelSetImageToSurfaceFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLabelSetImageToSurfaceFilterTestSuite);
+  MITK_TEST(TestGenerateAllLabels);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::LabelSetImage::Pointer m_LabelSetImage;
+
+public:
+  void setUp() override
+  {
+    m_LabelSetImage = mitk::LabelSetImage::New();
+    mitk::Image::Pointer regularImage = mitk::Image::New();
+    unsigned int dimensions[3] = {64, 64, 64};
+    regularImage->Initialize(mitk::MakeScalarPixelType<int>(), 3, dimensions);
+    m_LabelSetImage->Initialize(regularImage);
+
+    // three cubes of different size with labels 1, 2 and 3
+    mitk::ImagePixelWriteAccessor<mitk::LabelSetImage::PixelType, 3> accessor(m_LabelSetImage.GetPointer());
+    itk::Index<3> index;
+    for (index[2] = 0; index[2] < 64; ++index[2])
+      for (index[1] = 0; index[1] < 64; ++index[1])
+        for (index[0] = 0; index[0] < 64; ++index[0])
+        {
+          mitk::LabelSetImage::PixelType value = 0;
+          if (index[0] >= 5 && index[0] < 20 && index[1] >= 5 && index[1] < 20 && index[2] >= 5 && index[2] < 20)
+            value = 1;
+          else if (index[0] >= 30 && index[0] < 60 && index[1] >= 10 && index[1] < 40 && index[2] >= 20 && index[2] < 50)
+            value = 2;
+          else if (index[0] >= 5 && index[0] < 15 && index[1] >= 45 && index[1] < 62 && index[2] >= 40 && index[2] < 63)
+            value = 3;
+          accessor.SetPixelByIndex(index, value);
+        }
+  }
+
+  void tearDown() override { m_LabelSetImage = nullptr; }
+
+  void TestGenerateAllLabels()
+  {
+    auto batchFilter = mitk::LabelSetImageToSurfaceFilter::New();
+    batchFilter->SetInput(m_LabelSetImage);
+    batchFilter->GenerateAllLabelsOn();
+    batchFilter->SetRequestedLabel(2);
+    batchFilter->Update();
+
+    const auto &surfaces = batchFilter->GetLabelSurfaces();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(3), surfaces.size());
+
+    for (mitk::LabelSetImage::PixelType label = 1; label <= 3; ++label)
+    {
+      auto singleFilter = mitk::LabelSetImageToSurfaceFilter::New();
+      singleFilter->SetInput(m_LabelSetImage);
+      singleFilter->SetRequestedLabel(label);
+      singleFilter->Update();
+
+      // processing the bounding box of a label must give the same surface as processing the whole image
+      auto expected = singleFilter->GetOutput()->GetVtkPolyData();
+      auto actual = surfaces.at(label)->GetVtkPolyData();
+      CPPUNIT_ASSERT_EQUAL(expected->GetNumberOfPoints(), actual->GetNumberOfPoints());
+      CPPUNIT_ASSERT_EQUAL(expected->GetNumberOfPolys(), actual->GetNumberOfPolys());
+
+      double expectedBounds[6];
+      double actualBounds[6];
+      expected->GetBounds(expectedBounds);
+      actual->GetBounds(actualBounds);
+      for (int i = 0; i < 6; ++i)
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedBounds[i], actualBounds[i], 1e-6);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(surfaces.at(2)->GetVtkPolyData()->GetNumberOfPoints(),
+                         batchFilter->GetOutput()->GetVtkPolyData()->GetNumberOfPoints());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImageToSurfaceFilter)
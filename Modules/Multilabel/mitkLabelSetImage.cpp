@@ -14,8 +14,11 @@ found in the LICENSE file.
 
 #include "mitkImageAccessByItk.h"
 #include "mitkImageCast.h"
+#include "mitkImageRegionModifiedEvent.h"
 #include "mitkImagePixelReadAccessor.h"
 #include "mitkImagePixelWriteAccessor.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
 #include "mitkInteractionConst.h"
 #include "mitkLookupTableProperty.h"
 #include "mitkPadImageFilter.h"
@@ -34,6 +37,12 @@ found in the LICENSE file.
 
 #include <itkCommand.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
 template <typename TPixel, unsigned int VDimensions>
 void SetToZero(itk::Image<TPixel, VDimensions> *source)
 {
@@ -61,8 +70,24 @@ void CreateLabelMaskProcessing(mitk::Image *layerImage, mitk::Image *mask, mitk:
 }
 
 mitk::LabelSetImage::LabelSetImage()
-  : mitk::Image(), m_ActiveLayer(0), m_activeLayerInvalid(false), m_ExteriorLabel(nullptr)
+  : mitk::Image(),
+    m_DecodedLayerIndex(0),
+    m_DecodedLayerWritable(false),
+    m_WrittenMemoryBegin(nullptr),
+    m_WrittenMemoryEnd(nullptr),
+    m_AllChunksModified(false),
+    m_UnreportedModification(false),
+    m_WritesReported(false),
+    m_SparseLayerStorage(false),
+    m_ActiveLayer(0),
+    m_activeLayerInvalid(false),
+    m_ExteriorLabel(nullptr)
 {
+  // listen to slices written by segmentation tools to update the active sparse layer for them only
+  itk::MemberCommand<Self>::Pointer regionCommand = itk::MemberCommand<Self>::New();
+  regionCommand->SetCallbackFunction(this, &mitk::LabelSetImage::OnRegionModified);
+  this->AddObserver(ImageRegionModifiedEvent(), regionCommand);
+
   // Iniitlaize Background Label
   mitk::Color color;
   color.Set(0, 0, 0);
@@ -79,10 +104,27 @@ mitk::LabelSetImage::LabelSetImage()
 
 mitk::LabelSetImage::LabelSetImage(const mitk::LabelSetImage &other)
   : Image(other),
+    m_DecodedLayerIndex(0),
+    m_DecodedLayerWritable(false),
+    m_WrittenMemoryBegin(nullptr),
+    m_WrittenMemoryEnd(nullptr),
+    m_AllChunksModified(true), // the active sparse layer of other may be outdated
+    m_UnreportedModification(false),
+    m_WritesReported(false),
+    m_SparseLayerStorage(other.GetSparseLayerStorage()),
     m_ActiveLayer(other.GetActiveLayer()),
     m_activeLayerInvalid(false),
     m_ExteriorLabel(other.GetExteriorLabel()->Clone())
 {
+  itk::MemberCommand<Self>::Pointer regionCommand = itk::MemberCommand<Self>::New();
+  regionCommand->SetCallbackFunction(this, &mitk::LabelSetImage::OnRegionModified);
+  this->AddObserver(ImageRegionModifiedEvent(), regionCommand);
+
+  if (m_SparseLayerStorage)
+  {
+    other.FlushDecodedLayer();
+  }
+
   for (unsigned int i = 0; i < other.GetNumberOfLayers(); i++)
   {
     // Clone LabelSet data
@@ -94,8 +136,16 @@ mitk::LabelSetImage::LabelSetImage(const mitk::LabelSetImage &other)
     m_LabelSetContainer.push_back(lsClone);
 
     // clone layer Image data
-    mitk::Image::Pointer liClone = other.GetLayerImage(i)->Clone();
-    m_LayerContainer.push_back(liClone);
+    if (m_SparseLayerStorage)
+    {
+      m_SparseLayerContainer.push_back(other.m_SparseLayerContainer[i]->Clone());
+      m_LayerContainer.push_back(nullptr);
+    }
+    else
+    {
+      mitk::Image::Pointer liClone = other.GetLayerImage(i)->Clone();
+      m_LayerContainer.push_back(liClone);
+    }
   }
 
   // Add some DICOM Tags as properties to segmentation image
@@ -162,12 +212,375 @@ mitk::LabelSetImage::~LabelSetImage()
 
 mitk::Image *mitk::LabelSetImage::GetLayerImage(unsigned int layer)
 {
-  return m_LayerContainer[layer];
+  if (!m_SparseLayerStorage)
+  {
+    return m_LayerContainer[layer];
+  }
+
+  // the active layer is only up to date in the image buffer
+  if (layer == this->GetActiveLayer())
+  {
+    return this;
+  }
+
+  auto decodedLayer = this->DecodeLayer(layer);
+  m_DecodedLayerWritable = true;
+  return decodedLayer;
 }
 
 const mitk::Image *mitk::LabelSetImage::GetLayerImage(unsigned int layer) const
 {
-  return m_LayerContainer[layer];
+  if (!m_SparseLayerStorage)
+  {
+    return m_LayerContainer[layer];
+  }
+
+  if (layer == this->GetActiveLayer())
+  {
+    return this;
+  }
+
+  return this->DecodeLayer(layer);
+}
+
+mitk::Image *mitk::LabelSetImage::DecodeLayer(unsigned int layer) const
+{
+  // non-active layers only change through the decoded layer itself, so it never needs to be decoded again
+  if (m_DecodedLayer.IsNotNull() && m_DecodedLayerIndex == layer)
+  {
+    return m_DecodedLayer;
+  }
+
+  this->FlushDecodedLayer();
+
+  m_DecodedLayer = this->CreateLayerImage();
+  m_DecodedLayerIndex = layer;
+  m_DecodedLayerWritable = false;
+  {
+    ImageWriteAccessor accessor(m_DecodedLayer);
+    m_SparseLayerContainer[layer]->WriteTo(static_cast<PixelType *>(accessor.GetData()));
+  }
+  m_DecodedLayer->Modified();
+  return m_DecodedLayer;
+}
+
+void mitk::LabelSetImage::FlushDecodedLayer() const
+{
+  if (m_DecodedLayer.IsNull() || !m_DecodedLayerWritable)
+  {
+    return;
+  }
+
+  // only the chunks that differ are encoded again
+  ImageReadAccessor accessor(m_DecodedLayer);
+  m_SparseLayerContainer[m_DecodedLayerIndex]->Update(static_cast<const PixelType *>(accessor.GetData()));
+}
+
+mitk::Image::Pointer mitk::LabelSetImage::GetLayerSlices(unsigned int layer,
+                                                        unsigned int timeStep,
+                                                        unsigned int firstSlice,
+                                                        unsigned int lastSlice) const
+{
+  if (layer >= this->GetNumberOfLayers() || !this->IsValidTimeStep(timeStep) || firstSlice > lastSlice ||
+      lastSlice >= this->GetDimension(2))
+  {
+    mitkThrow() << "Invalid request of slices " << firstSlice << " to " << lastSlice << " of time step " << timeStep
+                << " of layer " << layer << ".";
+  }
+
+  const unsigned int numberOfSlices = lastSlice - firstSlice + 1;
+
+  // geometry of the time step, starting at the first slice
+  auto geometry = this->GetTimeGeometry()->GetGeometryForTimeStep(timeStep)->Clone();
+  mitk::Point3D firstSliceIndex;
+  firstSliceIndex.Fill(0);
+  firstSliceIndex[2] = firstSlice;
+  mitk::Point3D origin;
+  geometry->IndexToWorld(firstSliceIndex, origin);
+  geometry->SetOrigin(origin);
+  auto bounds = geometry->GetBounds();
+  bounds[5] = bounds[4] + numberOfSlices;
+  geometry->SetBounds(bounds);
+
+  mitk::Image::Pointer slices = mitk::Image::New();
+  slices->Initialize(this->GetPixelType(), *geometry);
+
+  ImageWriteAccessor writeAccessor(slices);
+  if (m_SparseLayerStorage && layer != this->GetActiveLayer())
+  {
+    if (layer == m_DecodedLayerIndex)
+    {
+      this->FlushDecodedLayer();
+    }
+    m_SparseLayerContainer[layer]->WriteChunksTo(static_cast<PixelType *>(writeAccessor.GetData()),
+                                                 static_cast<std::size_t>(timeStep) * this->GetDimension(2) + firstSlice,
+                                                 numberOfSlices);
+  }
+  else
+  {
+    // the active layer is only up to date in the image buffer
+    const mitk::Image *layerImage = layer == this->GetActiveLayer() ? this : m_LayerContainer[layer].GetPointer();
+    ImageReadAccessor readAccessor(layerImage, layerImage->GetVolumeData(timeStep));
+    const std::size_t sliceSize =
+      static_cast<std::size_t>(this->GetDimension(0)) * this->GetDimension(1) * this->GetPixelType().GetSize();
+    std::memcpy(writeAccessor.GetData(),
+                static_cast<const char *>(readAccessor.GetData()) + firstSlice * sliceSize,
+                numberOfSlices * sliceSize);
+  }
+
+  return slices;
+}
+
+void mitk::LabelSetImage::SetSparseLayerStorage(bool sparseLayerStorage)
+{
+  if (sparseLayerStorage == m_SparseLayerStorage)
+  {
+    return;
+  }
+
+  if (this->IsInitialized() && this->GetPixelType() != mitk::MakeScalarPixelType<PixelType>())
+  {
+    mitkThrow() << "Sparse layer storage requires the pixel type of mitk::Label.";
+  }
+
+  if (m_SparseLayerStorage)
+  {
+    this->FlushDecodedLayer();
+  }
+  m_DecodedLayer = nullptr;
+
+  if (sparseLayerStorage)
+  {
+    m_SparseLayerContainer.clear();
+    for (unsigned int layer = 0; layer < m_LayerContainer.size(); ++layer)
+    {
+      // the active layer is only up to date in the image buffer
+      if (layer == this->GetActiveLayer())
+      {
+        m_SparseLayerContainer.push_back(this->CreateSparseLayer(this));
+      }
+      else
+      {
+        m_SparseLayerContainer.push_back(this->CreateSparseLayer(m_LayerContainer[layer]));
+      }
+      m_LayerContainer[layer] = nullptr;
+    }
+    m_SparseLayerStorage = true;
+    this->ResetActiveSparseLayerModifications();
+  }
+  else
+  {
+    for (unsigned int layer = 0; layer < m_SparseLayerContainer.size(); ++layer)
+    {
+      m_LayerContainer[layer] = this->CreateLayerImage();
+      ImageWriteAccessor accessor(m_LayerContainer[layer]);
+      m_SparseLayerContainer[layer]->WriteTo(static_cast<PixelType *>(accessor.GetData()));
+    }
+    m_SparseLayerContainer.clear();
+    m_SparseLayerStorage = false;
+  }
+}
+
+bool mitk::LabelSetImage::GetSparseLayerStorage() const
+{
+  return m_SparseLayerStorage;
+}
+
+mitk::Image::Pointer mitk::LabelSetImage::CreateLayerImage() const
+{
+  mitk::Image::Pointer newImage = mitk::Image::New();
+  newImage->Initialize(this->GetPixelType(),
+                       this->GetDimension(),
+                       this->GetDimensions(),
+                       this->GetImageDescriptor()->GetNumberOfChannels());
+  newImage->SetTimeGeometry(this->GetTimeGeometry()->Clone());
+  return newImage;
+}
+
+mitk::SparseLabelLayer::Pointer mitk::LabelSetImage::CreateSparseLayer(const mitk::Image *layerImage) const
+{
+  // one chunk per slice and time step
+  std::size_t chunkSize = static_cast<std::size_t>(this->GetDimension(0)) * this->GetDimension(1);
+  std::size_t numberOfChunks = 1;
+  for (unsigned int dim = 2; dim < this->GetDimension(); ++dim)
+  {
+    numberOfChunks *= this->GetDimension(dim);
+  }
+
+  auto sparseLayer = mitk::SparseLabelLayer::New();
+  sparseLayer->Initialize(chunkSize, numberOfChunks);
+
+  if (nullptr != layerImage)
+  {
+    for (unsigned int dim = 0; dim < this->GetDimension(); ++dim)
+    {
+      if (layerImage->GetDimension(dim) != this->GetDimension(dim))
+      {
+        mitkThrow() << "Layer image does not match the size of the segmentation.";
+      }
+    }
+    if (layerImage->GetPixelType() != this->GetPixelType())
+    {
+      mitkThrow() << "Layer image does not match the pixel type of the segmentation.";
+    }
+
+    ImageReadAccessor accessor(layerImage);
+    sparseLayer->Update(static_cast<const PixelType *>(accessor.GetData()));
+  }
+  return sparseLayer;
+}
+
+void mitk::LabelSetImage::UpdateActiveSparseLayer() const
+{
+  std::set<std::size_t> modifiedChunks;
+  bool allChunksModified = false;
+  const unsigned char *writtenBegin = nullptr;
+  const unsigned char *writtenEnd = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_ModificationMutex);
+    modifiedChunks.swap(m_ModifiedChunks);
+    allChunksModified = m_AllChunksModified || m_UnreportedModification;
+    writtenBegin = static_cast<const unsigned char *>(m_WrittenMemoryBegin);
+    writtenEnd = static_cast<const unsigned char *>(m_WrittenMemoryEnd);
+  }
+  if (!allChunksModified && modifiedChunks.empty() && nullptr == writtenBegin)
+  {
+    return;
+  }
+
+  auto sparseLayer = m_SparseLayerContainer[this->GetActiveLayer()];
+  ImageReadAccessor accessor(this);
+  const auto *buffer = static_cast<const PixelType *>(accessor.GetData());
+
+  if (nullptr != writtenBegin && !allChunksModified)
+  {
+    // the memory written through accessors, converted to chunks of the buffer
+    const auto *bufferBegin = reinterpret_cast<const unsigned char *>(buffer);
+    const auto *bufferEnd = reinterpret_cast<const unsigned char *>(buffer + sparseLayer->GetNumberOfPixels());
+    if (writtenBegin < bufferBegin || writtenEnd > bufferEnd)
+    {
+      allChunksModified = true;
+    }
+    else if (writtenBegin < writtenEnd)
+    {
+      const std::size_t chunkBytes = sparseLayer->GetChunkSize() * sizeof(PixelType);
+      const std::size_t lastChunk = static_cast<std::size_t>(writtenEnd - bufferBegin - 1) / chunkBytes;
+      for (auto chunk = static_cast<std::size_t>(writtenBegin - bufferBegin) / chunkBytes; chunk <= lastChunk; ++chunk)
+      {
+        modifiedChunks.insert(chunk);
+      }
+    }
+  }
+
+  if (allChunksModified)
+  {
+    sparseLayer->Update(buffer);
+  }
+  else
+  {
+    sparseLayer->Update(buffer, modifiedChunks);
+  }
+  this->ResetActiveSparseLayerModifications();
+}
+
+void mitk::LabelSetImage::ResetActiveSparseLayerModifications() const
+{
+  std::lock_guard<std::mutex> lock(m_ModificationMutex);
+  m_ModifiedChunks.clear();
+  m_WrittenMemoryBegin = nullptr;
+  m_WrittenMemoryEnd = nullptr;
+  m_AllChunksModified = false;
+  m_UnreportedModification = false;
+  m_WritesReported = false;
+}
+
+void mitk::LabelSetImage::Modified() const
+{
+  Superclass::Modified();
+
+  if (!m_SparseLayerStorage)
+  {
+    return;
+  }
+
+  // like for the statistics, a modification neither written through an accessor nor followed by an
+  // ImageRegionModifiedEvent may have changed any pixel
+  std::lock_guard<std::mutex> lock(m_ModificationMutex);
+  m_AllChunksModified = m_AllChunksModified || m_UnreportedModification;
+  m_UnreportedModification = !m_WritesReported;
+  m_WritesReported = false;
+}
+
+void mitk::LabelSetImage::PixelsWritten(const void *begin, const void *end)
+{
+  Superclass::PixelsWritten(begin, end);
+
+  if (!m_SparseLayerStorage)
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_ModificationMutex);
+  m_WritesReported = true;
+  if (nullptr == begin)
+  {
+    m_AllChunksModified = true;
+  }
+  else if (nullptr == m_WrittenMemoryBegin)
+  {
+    m_WrittenMemoryBegin = begin;
+    m_WrittenMemoryEnd = end;
+  }
+  else
+  {
+    m_WrittenMemoryBegin = std::min(m_WrittenMemoryBegin, begin, std::less<const void *>());
+    m_WrittenMemoryEnd = std::max(m_WrittenMemoryEnd, end, std::less<const void *>());
+  }
+}
+
+void mitk::LabelSetImage::OnRegionModified(const itk::Object *, const itk::EventObject &event)
+{
+  auto regionEvent = dynamic_cast<const ImageRegionModifiedEvent *>(&event);
+  if (!m_SparseLayerStorage || nullptr == regionEvent || nullptr == regionEvent->GetGeometry() ||
+      !this->IsValidTimeStep(regionEvent->GetTimeStep()))
+  {
+    return;
+  }
+
+  const auto timeStep = regionEvent->GetTimeStep();
+  std::set<std::size_t> chunks;
+  if (this->GetDimension() < 3)
+  {
+    chunks.insert(0);
+  }
+  else
+  {
+    // slices touched by the region, padded by one slice for voxels partially inside
+    const BaseGeometry *regionGeometry = regionEvent->GetGeometry();
+    const BaseGeometry *imageGeometry = this->GetGeometry(timeStep);
+    double minSlice = std::numeric_limits<double>::max();
+    double maxSlice = std::numeric_limits<double>::lowest();
+    for (int corner = 0; corner < 8; ++corner)
+    {
+      mitk::Point3D index;
+      imageGeometry->WorldToIndex(regionGeometry->GetCornerPoint(corner), index);
+      minSlice = std::min(minSlice, index[2]);
+      maxSlice = std::max(maxSlice, index[2]);
+    }
+
+    const long numberOfSlices = this->GetDimension(2);
+    const long firstSlice = std::max(0L, static_cast<long>(std::floor(minSlice)) - 1);
+    const long lastSlice = std::min(numberOfSlices - 1, static_cast<long>(std::ceil(maxSlice)) + 1);
+    for (long slice = firstSlice; slice <= lastSlice; ++slice)
+    {
+      chunks.insert(static_cast<std::size_t>(timeStep) * numberOfSlices + slice);
+    }
+  }
+
+  // the event follows the Modified() of the write
+  std::lock_guard<std::mutex> lock(m_ModificationMutex);
+  m_UnreportedModification = false;
+  m_ModifiedChunks.insert(chunks.begin(), chunks.end());
 }
 
 unsigned int mitk::LabelSetImage::GetActiveLayer() const
@@ -186,6 +599,12 @@ void mitk::LabelSetImage::RemoveLayer()
   // remove all observers from active label set
   GetLabelSet(layerToDelete)->RemoveAllObservers();
 
+  if (m_SparseLayerStorage)
+  {
+    this->FlushDecodedLayer();
+    m_DecodedLayer = nullptr;
+  }
+
   // set the active layer to one below, if exists.
   if (layerToDelete != 0)
   {
@@ -200,6 +619,10 @@ void mitk::LabelSetImage::RemoveLayer()
   // remove labelset and image data
   m_LabelSetContainer.erase(m_LabelSetContainer.begin() + layerToDelete);
   m_LayerContainer.erase(m_LayerContainer.begin() + layerToDelete);
+  if (m_SparseLayerStorage)
+  {
+    m_SparseLayerContainer.erase(m_SparseLayerContainer.begin() + layerToDelete);
+  }
 
   if (layerToDelete == 0)
   {
@@ -211,12 +634,13 @@ void mitk::LabelSetImage::RemoveLayer()
 
 unsigned int mitk::LabelSetImage::AddLayer(mitk::LabelSet::Pointer lset)
 {
-  mitk::Image::Pointer newImage = mitk::Image::New();
-  newImage->Initialize(this->GetPixelType(),
-                       this->GetDimension(),
-                       this->GetDimensions(),
-                       this->GetImageDescriptor()->GetNumberOfChannels());
-  newImage->SetTimeGeometry(this->GetTimeGeometry()->Clone());
+  if (m_SparseLayerStorage)
+  {
+    // an empty sparse layer needs no image data at all
+    return this->AppendLayer(nullptr, this->CreateSparseLayer(nullptr), lset);
+  }
+
+  mitk::Image::Pointer newImage = this->CreateLayerImage();
 
   if (newImage->GetDimension() < 4)
   {
@@ -233,6 +657,17 @@ unsigned int mitk::LabelSetImage::AddLayer(mitk::LabelSet::Pointer lset)
 }
 
 unsigned int mitk::LabelSetImage::AddLayer(mitk::Image::Pointer layerImage, mitk::LabelSet::Pointer lset)
+{
+  if (m_SparseLayerStorage)
+  {
+    return this->AppendLayer(nullptr, this->CreateSparseLayer(layerImage), lset);
+  }
+  return this->AppendLayer(layerImage, nullptr, lset);
+}
+
+unsigned int mitk::LabelSetImage::AppendLayer(mitk::Image::Pointer layerImage,
+                                              mitk::SparseLabelLayer::Pointer sparseLayer,
+                                              mitk::LabelSet::Pointer lset)
 {
   unsigned int newLabelSetId = m_LayerContainer.size();
 
@@ -255,6 +690,10 @@ unsigned int mitk::LabelSetImage::AddLayer(mitk::Image::Pointer layerImage, mitk
 
   // push a new working image for the new layer
   m_LayerContainer.push_back(layerImage);
+  if (m_SparseLayerStorage)
+  {
+    m_SparseLayerContainer.push_back(sparseLayer);
+  }
 
   // push a new labelset for the new layer
   m_LabelSetContainer.push_back(ls);
@@ -264,9 +703,9 @@ unsigned int mitk::LabelSetImage::AddLayer(mitk::Image::Pointer layerImage, mitk
   command->SetCallbackFunction(this, &mitk::LabelSetImage::OnLabelSetModified);
   ls->AddObserver(itk::ModifiedEvent(), command);
 
+  // also marks this image as modified
   SetActiveLayer(newLabelSetId);
   // MITK_INFO << GetActiveLayer();
-  this->Modified();
   return newLabelSetId;
 }
 
@@ -297,9 +736,45 @@ void mitk::LabelSetImage::AddLabelSetToLayer(const unsigned int layerIdx, const
 
 void mitk::LabelSetImage::SetActiveLayer(unsigned int layer)
 {
+  bool sparseLayerWritten = false;
   try
   {
-    if (4 == this->GetDimension())
+    if (m_SparseLayerStorage)
+    {
+      if ((layer != GetActiveLayer() || m_activeLayerInvalid) && (layer < this->GetNumberOfLayers()))
+      {
+        BeforeChangeLayerEvent.Send();
+
+        // the new active layer is held in the image buffer only
+        this->FlushDecodedLayer();
+        if (layer == m_DecodedLayerIndex)
+        {
+          m_DecodedLayer = nullptr;
+        }
+
+        // the buffer holds the previously active layer, chunks equal in both layers need not be written
+        const SparseLabelLayer *bufferContent = nullptr;
+        if (m_activeLayerInvalid)
+        {
+          // We should not write the invalid layer back to the vector
+          m_activeLayerInvalid = false;
+        }
+        else
+        {
+          this->UpdateActiveSparseLayer();
+          bufferContent = m_SparseLayerContainer[GetActiveLayer()];
+        }
+        m_ActiveLayer = layer; // only at this place m_ActiveLayer should be manipulated!!! Use Getter and Setter
+        {
+          ImageWriteAccessor accessor(this);
+          m_SparseLayerContainer[layer]->WriteTo(static_cast<PixelType *>(accessor.GetData()), bufferContent);
+        }
+        sparseLayerWritten = true;
+
+        AfterChangeLayerEvent.Send();
+      }
+    }
+    else if (4 == this->GetDimension())
     {
       if ((layer != GetActiveLayer() || m_activeLayerInvalid) && (layer < this->GetNumberOfLayers()))
       {
@@ -346,7 +821,20 @@ void mitk::LabelSetImage::SetActiveLayer(unsigned int layer)
   {
     mitkThrow() << e.GetDescription();
   }
-  this->Modified();
+
+  if (m_SparseLayerStorage)
+  {
+    // no pixel was modified apart from decoding the active layer into the buffer
+    Superclass::Modified();
+    if (sparseLayerWritten)
+    {
+      this->ResetActiveSparseLayerModifications();
+    }
+  }
+  else
+  {
+    this->Modified();
+  }
 }
 
 void mitk::LabelSetImage::Concatenate(mitk::LabelSetImage *other)
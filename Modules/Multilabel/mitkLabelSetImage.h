@@ -15,9 +15,13 @@ found in the LICENSE file.
 
 #include <mitkImage.h>
 #include <mitkLabelSet.h>
+#include <mitkSparseLabelLayer.h>
 
 #include <MitkMultilabelExports.h>
 
+#include <mutex>
+#include <set>
+
 namespace mitk
 {
   //##Documentation
@@ -241,13 +245,56 @@ namespace mitk
     void RemoveLayer();
 
     /**
-      * \brief  */
+      * \brief Returns the image data of a layer.
+      *
+      * If sparse layer storage is enabled, the active layer is this image and every other layer is decoded like by
+      * the const overload. Changes to the decoded image are encoded into the layer again before another layer is
+      * requested or the layer becomes active; changes made afterwards are lost.
+      */
     mitk::Image *GetLayerImage(unsigned int layer);
 
+    /**
+      * \brief Returns the image data of a layer.
+      *
+      * If sparse layer storage is enabled, the active layer is this image and every other layer is decoded into a
+      * dense copy on demand. Only the most recently decoded layer is kept, so the returned pointer is only valid
+      * until a different layer is requested. Hold a smart pointer to keep it longer.
+      */
     const mitk::Image *GetLayerImage(unsigned int layer) const;
 
+    /**
+      * \brief Returns the slices [firstSlice, lastSlice] of a time step of a layer as a dense image.
+      *
+      * Only these slices are decoded if sparse layer storage is enabled, so it is meant for displaying layers. The
+      * geometry of the returned image is the geometry of the time step restricted to the slices. The image is a
+      * copy and not cached.
+      */
+    mitk::Image::Pointer GetLayerSlices(unsigned int layer,
+                                        unsigned int timeStep,
+                                        unsigned int firstSlice,
+                                        unsigned int lastSlice) const;
+
+    /**
+     * @brief Stores the layers run-length encoded (see mitk::SparseLabelLayer) instead of as dense images.
+     *
+     * This saves memory for segmentations with many mostly empty layers. SetActiveLayer() then only copies the
+     * slices that differ between the previously and the newly active layer. The active layer is still held
+     * densely in the image buffer. Disabled by default.
+     *
+     * Only the slices written through an ImageWriteAccessor or reported by an ImageRegionModifiedEvent are encoded
+     * again when the active layer is needed. Other writes (e.g. through GetData() or the vtkImageData) have to be
+     * followed by Modified() and cause the whole buffer to be compared with the layer, unless an
+     * ImageRegionModifiedEvent reports the modified region after Modified().
+     */
+    void SetSparseLayerStorage(bool sparseLayerStorage);
+
+    bool GetSparseLayerStorage() const;
+
     void OnLabelSetModified();
 
+    /** \brief Also marks the active sparse layer as outdated, see SetSparseLayerStorage(). */
+    void Modified() const override;
+
     /**
      * @brief Sets the label which is used as default exterior label when creating a new layer
      * @param label the label which will be used as new exterior label
@@ -272,6 +319,35 @@ namespace mitk
     template <typename ImageType1, typename ImageType2>
     void ChangeLayerProcessing(ImageType1 *source, ImageType2 *target);
 
+    /** \brief Adds layer image (dense storage) or sparse layer (sparse storage) and label set as new layer.*/
+    unsigned int AppendLayer(mitk::Image::Pointer layerImage,
+                             mitk::SparseLabelLayer::Pointer sparseLayer,
+                             mitk::LabelSet::Pointer lset);
+
+    /** \brief Creates an uninitialized dense image of the size of this image.*/
+    mitk::Image::Pointer CreateLayerImage() const;
+
+    /** \brief Run-length encodes an image of the size and pixel type of this image.*/
+    mitk::SparseLabelLayer::Pointer CreateSparseLayer(const mitk::Image *layerImage) const;
+
+    /** \brief Encodes the modified chunks of the image buffer into the sparse storage of the active layer.*/
+    void UpdateActiveSparseLayer() const;
+
+    /** \brief Marks the image buffer as equal to the sparse storage of the active layer.*/
+    void ResetActiveSparseLayerModifications() const;
+
+    /** \brief Decodes a layer other than the active one into m_DecodedLayer, see GetLayerImage().*/
+    mitk::Image *DecodeLayer(unsigned int layer) const;
+
+    /** \brief Encodes changes of the decoded layer handed out by the non-const GetLayerImage() into its layer.*/
+    void FlushDecodedLayer() const;
+
+    /** \brief Remembers the memory written through an ImageWriteAccessor for UpdateActiveSparseLayer().*/
+    void PixelsWritten(const void *begin, const void *end) override;
+
+    /** \brief Marks the slices inside the geometry of an ImageRegionModifiedEvent as modified.*/
+    void OnRegionModified(const itk::Object *caller, const itk::EventObject &event);
+
     template <typename TPixel, unsigned int VImageDimension>
     void LayerContainerToImageProcessing(itk::Image<TPixel, VImageDimension> *source, unsigned int layer);
 
@@ -304,6 +380,28 @@ namespace mitk
 
     std::vector<LabelSet::Pointer> m_LabelSetContainer;
     std::vector<Image::Pointer> m_LayerContainer;
+    std::vector<SparseLabelLayer::Pointer> m_SparseLayerContainer;
+
+    /** \brief Dense copy of the sparse layer last handed out by GetLayerImage().*/
+    mutable Image::Pointer m_DecodedLayer;
+    mutable unsigned int m_DecodedLayerIndex;
+    /** \brief The decoded layer was handed out writable and may differ from its sparse layer.*/
+    mutable bool m_DecodedLayerWritable;
+
+    /** \brief Chunks of the image buffer modified since the active sparse layer was updated.*/
+    mutable std::set<std::size_t> m_ModifiedChunks;
+    /** \brief Bounds of the memory written through ImageWriteAccessors since the active sparse layer was updated.*/
+    mutable const void *m_WrittenMemoryBegin;
+    mutable const void *m_WrittenMemoryEnd;
+    /** \brief Whether the buffer may have been modified anywhere, e.g. by a write through GetData().*/
+    mutable bool m_AllChunksModified;
+    /** \brief Whether the writes before the last Modified() were neither written through an ImageWriteAccessor nor
+      * reported by an ImageRegionModifiedEvent (yet).*/
+    mutable bool m_UnreportedModification;
+    mutable bool m_WritesReported;
+    mutable std::mutex m_ModificationMutex;
+
+    bool m_SparseLayerStorage;
 
     int m_ActiveLayer;
 
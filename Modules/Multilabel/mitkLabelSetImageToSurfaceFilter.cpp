@@ -19,6 +19,7 @@ found in the LICENSE file.
 #include <itkAntiAliasBinaryImageFilter.h>
 #include <itkAutoCropLabelMapFilter.h>
 #include <itkBinaryThresholdImageFilter.h>
+#include <itkExtractImageFilter.h>
 #include <itkLabelImageToLabelMapFilter.h>
 #include <itkLabelMap.h>
 #include <itkLabelMapToLabelImageFilter.h>
@@ -34,6 +35,13 @@ found in the LICENSE file.
 #include <vtkMarchingCubes.h>
 #include <vtkSmartPointer.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 mitk::LabelSetImageToSurfaceFilter::LabelSetImageToSurfaceFilter()
   : m_GenerateAllLabels(false), m_RequestedLabel(1), m_BackgroundLabel(0), m_UseSmoothing(0), m_Sigma(0.1)
 {
@@ -64,6 +72,11 @@ const mitk::Image *mitk::LabelSetImageToSurfaceFilter::GetInput(void)
   return static_cast<const mitk::Image *>(this->ProcessObject::GetInput(0));
 }
 
+const mitk::LabelSetImageToSurfaceFilter::LabelSurfaceMapType &mitk::LabelSetImageToSurfaceFilter::GetLabelSurfaces() const
+{
+  return m_LabelSurfaces;
+}
+
 void mitk::LabelSetImageToSurfaceFilter::GenerateOutputInformation()
 {
   itkDebugMacro(<< "GenerateOutputInformation()");
@@ -85,6 +98,23 @@ void mitk::LabelSetImageToSurfaceFilter::GenerateData()
 template <typename TPixel, unsigned int VDimension>
 void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPixel, VDimension> *input,
                                                             mitk::Surface * /*surface*/)
+{
+  if (m_GenerateAllLabels)
+  {
+    this->GenerateAllLabelSurfaces(input);
+    return;
+  }
+
+  vtkSmartPointer<vtkPolyData> polydata =
+    this->CreateLabelSurface(input, static_cast<TPixel>(m_RequestedLabel), 0, m_ResultImage);
+
+  mitk::Surface::Pointer output = this->GetOutput(0);
+  output->SetVtkPolyData(polydata, 0);
+}
+
+template <typename TPixel, unsigned int VDimension>
+vtkSmartPointer<vtkPolyData> mitk::LabelSetImageToSurfaceFilter::CreateLabelSurface(
+  const itk::Image<TPixel, VDimension> *input, TPixel label, itk::ThreadIdType numberOfThreads, mitk::Image::Pointer &resultImage)
 {
   typedef itk::Image<TPixel, VDimension> ImageType;
 
@@ -102,15 +132,19 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
 
   typename BinaryThresholdFilterType::Pointer thresholdFilter = BinaryThresholdFilterType::New();
   thresholdFilter->SetInput(input);
-  thresholdFilter->SetLowerThreshold(m_RequestedLabel);
-  thresholdFilter->SetUpperThreshold(m_RequestedLabel);
+  thresholdFilter->SetLowerThreshold(label);
+  thresholdFilter->SetUpperThreshold(label);
   thresholdFilter->SetOutsideValue(0);
   thresholdFilter->SetInsideValue(1);
   //  thresholdFilter->ReleaseDataFlagOn();
+  if (numberOfThreads > 0)
+    thresholdFilter->SetNumberOfThreads(numberOfThreads);
   thresholdFilter->Update();
 
   typename Image2LabelMapType::Pointer image2label = Image2LabelMapType::New();
   image2label->SetInput(thresholdFilter->GetOutput());
+  if (numberOfThreads > 0)
+    image2label->SetNumberOfThreads(numberOfThreads);
 
   typename AutoCropType::SizeType border;
   border[0] = 3;
@@ -133,6 +167,8 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
   antiAliasFilter->SetNumberOfLayers(3);
   antiAliasFilter->SetUseImageSpacing(false);
   antiAliasFilter->SetNumberOfIterations(40);
+  if (numberOfThreads > 0)
+    antiAliasFilter->SetNumberOfThreads(numberOfThreads);
 
   antiAliasFilter->Update();
 
@@ -143,6 +179,8 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
     typename GaussianFilterType::Pointer gaussianFilter = GaussianFilterType::New();
     gaussianFilter->SetSigma(m_Sigma);
     gaussianFilter->SetInput(antiAliasFilter->GetOutput());
+    if (numberOfThreads > 0)
+      gaussianFilter->SetNumberOfThreads(numberOfThreads);
     gaussianFilter->Update();
     result = gaussianFilter->GetOutput();
   }
@@ -158,16 +196,16 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
 
   const typename ImageType::IndexType &cropIndex = cropRegion.GetIndex();
 
-  m_ResultImage = mitk::Image::New();
-  mitk::CastToMitkImage(result, m_ResultImage);
+  resultImage = mitk::Image::New();
+  mitk::CastToMitkImage(result, resultImage);
 
-  mitk::BaseGeometry *newGeometry = m_ResultImage->GetSlicedGeometry();
+  mitk::BaseGeometry *newGeometry = resultImage->GetSlicedGeometry();
   mitk::Point3D origin;
   vtk2itk(cropIndex, origin);
   this->GetInput()->GetGeometry()->IndexToWorld(origin, origin);
   newGeometry->SetOrigin(origin);
 
-  auto *vtkimage = m_ResultImage->GetVtkImageData(0);
+  auto *vtkimage = resultImage->GetVtkImageData(0);
 
   vtkSmartPointer<vtkImageChangeInformation> indexCoordinatesImageFilter =
     vtkSmartPointer<vtkImageChangeInformation>::New();
@@ -219,6 +257,179 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
   cleanPolyDataFilter->PointMergingOn();
   cleanPolyDataFilter->Update();
 
-  mitk::Surface::Pointer output = this->GetOutput(0);
-  output->SetVtkPolyData(cleanPolyDataFilter->GetOutput(), 0);
+  vtkSmartPointer<vtkPolyData> surface = cleanPolyDataFilter->GetOutput();
+  return surface;
+}
+
+template <typename TPixel, unsigned int VDimension>
+void mitk::LabelSetImageToSurfaceFilter::GenerateAllLabelSurfaces(const itk::Image<TPixel, VDimension> *input)
+{
+  typedef itk::Image<TPixel, VDimension> ImageType;
+  typedef itk::ExtractImageFilter<ImageType, ImageType> ExtractFilterType;
+
+  struct LabelExtent
+  {
+    typename ImageType::IndexType min;
+    typename ImageType::IndexType max;
+    itk::SizeValueType count;
+  };
+
+  // bounding boxes of all labels in one pass, runs of equal labels along x are handled at once
+  const typename ImageType::RegionType bufferedRegion = input->GetBufferedRegion();
+  const typename ImageType::SizeType bufferedSize = bufferedRegion.GetSize();
+  const TPixel *buffer = input->GetBufferPointer();
+  const TPixel background = static_cast<TPixel>(m_BackgroundLabel);
+
+  std::map<TPixel, LabelExtent> extents;
+  typename ImageType::IndexType index;
+  for (itk::SizeValueType z = 0; z < bufferedSize[2]; ++z)
+  {
+    for (itk::SizeValueType y = 0; y < bufferedSize[1]; ++y)
+    {
+      const TPixel *line = buffer + (z * bufferedSize[1] + y) * bufferedSize[0];
+      itk::SizeValueType x = 0;
+      while (x < bufferedSize[0])
+      {
+        const TPixel value = line[x];
+        itk::SizeValueType runEnd = x + 1;
+        while (runEnd < bufferedSize[0] && line[runEnd] == value)
+          ++runEnd;
+
+        if (value != background)
+        {
+          index[0] = bufferedRegion.GetIndex(0) + x;
+          index[1] = bufferedRegion.GetIndex(1) + y;
+          index[2] = bufferedRegion.GetIndex(2) + z;
+
+          auto extentIter = extents.find(value);
+          if (extentIter == extents.end())
+          {
+            LabelExtent extent;
+            extent.min = index;
+            extent.max = index;
+            extent.max[0] += runEnd - x - 1;
+            extent.count = runEnd - x;
+            extents.emplace(value, extent);
+          }
+          else
+          {
+            LabelExtent &extent = extentIter->second;
+            for (unsigned int i = 0; i < 3; ++i)
+            {
+              extent.min[i] = std::min(extent.min[i], index[i]);
+              extent.max[i] = std::max(extent.max[i], index[i]);
+            }
+            extent.max[0] = std::max<itk::IndexValueType>(extent.max[0], index[0] + runEnd - x - 1);
+            extent.count += runEnd - x;
+          }
+        }
+        x = runEnd;
+      }
+    }
+  }
+
+  // large labels first, so that the threads finish at about the same time
+  std::vector<TPixel> labels;
+  for (const auto &extent : extents)
+    labels.push_back(extent.first);
+  std::sort(labels.begin(), labels.end(), [&extents](TPixel a, TPixel b) {
+    return extents.at(a).count > extents.at(b).count;
+  });
+
+  m_LabelSurfaces.clear();
+  std::mutex mutex;
+  std::condition_variable labelFinished;
+  std::size_t numberOfFinishedLabels = 0;
+  std::atomic<std::size_t> nextLabel(0);
+  std::exception_ptr error;
+
+  auto worker = [&]() {
+    for (std::size_t i = nextLabel++; i < labels.size(); i = nextLabel++)
+    {
+      const TPixel label = labels[i];
+      const LabelExtent &extent = extents.at(label);
+
+      // same border as used by the auto crop filter, so that the result equals the one of a single label
+      typename ImageType::IndexType cropIndex;
+      typename ImageType::SizeType cropSize;
+      for (unsigned int d = 0; d < 3; ++d)
+      {
+        const itk::IndexValueType first = std::max<itk::IndexValueType>(extent.min[d] - 3, bufferedRegion.GetIndex(d));
+        const itk::IndexValueType last = std::min<itk::IndexValueType>(
+          extent.max[d] + 3, bufferedRegion.GetIndex(d) + static_cast<itk::IndexValueType>(bufferedSize[d]) - 1);
+        cropIndex[d] = first;
+        cropSize[d] = last - first + 1;
+      }
+
+      Surface::Pointer surface;
+      try
+      {
+        typename ExtractFilterType::Pointer extractFilter = ExtractFilterType::New();
+        extractFilter->SetInput(input);
+        extractFilter->SetExtractionRegion(typename ImageType::RegionType(cropIndex, cropSize));
+        extractFilter->SetDirectionCollapseToSubmatrix();
+        extractFilter->SetNumberOfThreads(1);
+        extractFilter->Update();
+
+        mitk::Image::Pointer resultImage;
+        vtkSmartPointer<vtkPolyData> polydata = this->CreateLabelSurface(extractFilter->GetOutput(), label, 1, resultImage);
+        surface = Surface::New();
+        surface->SetVtkPolyData(polydata);
+      }
+      catch (const itk::ExceptionObject &e)
+      {
+        MITK_WARN << "No surface created for label " << static_cast<int>(label) << ": " << e.GetDescription();
+      }
+      catch (...)
+      {
+        // other errors (e.g. bad_alloc) abort the filter, they are rethrown after the workers finished
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error)
+          error = std::current_exception();
+        nextLabel = labels.size();
+      }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      if (surface.IsNotNull())
+        m_LabelSurfaces[static_cast<LabelType>(label)] = surface;
+      ++numberOfFinishedLabels;
+      labelFinished.notify_one();
+    }
+  };
+
+  const std::size_t numberOfThreads =
+    std::max<std::size_t>(1, std::min<std::size_t>(this->GetNumberOfThreads(), labels.size()));
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < numberOfThreads; ++i)
+    threads.emplace_back(worker);
+
+  // progress is reported from this thread only, as observers are not prepared for calls from the workers
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    std::size_t reportedLabels = 0;
+    while (reportedLabels < labels.size() && !error)
+    {
+      labelFinished.wait(lock, [&]() { return numberOfFinishedLabels > reportedLabels || error; });
+      reportedLabels = numberOfFinishedLabels;
+      lock.unlock();
+      this->UpdateProgress(static_cast<float>(reportedLabels) / labels.size());
+      lock.lock();
+    }
+  }
+
+  for (auto &thread : threads)
+    thread.join();
+
+  if (error)
+  {
+    m_LabelSurfaces.clear();
+    std::rethrow_exception(error);
+  }
+
+  auto requestedSurface = m_LabelSurfaces.find(static_cast<LabelType>(m_RequestedLabel));
+  if (requestedSurface != m_LabelSurfaces.end())
+  {
+    mitk::Surface::Pointer output = this->GetOutput(0);
+    output->SetVtkPolyData(requestedSurface->second->GetVtkPolyData(), 0);
+  }
 }
@@ -19,6 +19,8 @@ found in the LICENSE file.
 #include <mitkSurfaceSource.h>
 
 #include <vtkMatrix4x4.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
 
 #include <itkImage.h>
 
@@ -30,6 +32,11 @@ namespace mitk
    * Generates surface meshes from a labelset image.
    * If you want to calculate a surface representation for all available labels,
    * you may call GenerateAllLabelsOn().
+   *
+   * In that case the bounding boxes of all labels are determined in a single pass over the image. Each label is
+   * then processed on its bounding box only and the labels are distributed over GetNumberOfThreads() threads.
+   * The surfaces are provided by GetLabelSurfaces(), the output holds the surface of the requested label (if present).
+   * Progress is reported per finished label.
    */
   class MITKMULTILABEL_EXPORT LabelSetImageToSurfaceFilter : public SurfaceSource
   {
@@ -44,6 +51,8 @@ namespace mitk
 
     typedef std::map<unsigned int, LabelType> IndexToLabelMapType;
 
+    typedef std::map<LabelType, Surface::Pointer> LabelSurfaceMapType;
+
     /**
     * Returns a const pointer to the labelset image set as input
     */
@@ -105,6 +114,12 @@ namespace mitk
      */
     itkSetMacro(Sigma, float);
 
+    /**
+     * Returns the surfaces of all labels (except the background label) generated by the last update
+     * with GenerateAllLabels() set to true. Labels for which no surface could be created are missing.
+     */
+    const LabelSurfaceMapType &GetLabelSurfaces() const;
+
   protected:
     LabelSetImageToSurfaceFilter();
 
@@ -129,6 +144,20 @@ namespace mitk
     template <typename TPixel, unsigned int VImageDimension>
     void InternalProcessing(const itk::Image<TPixel, VImageDimension> *input, mitk::Surface *surface);
 
+    /**
+    * Creates the surface of one label. The label is searched in the buffered region of input only.
+    * @param numberOfThreads number of threads used by the ITK filters, 0 for the default
+    * @param resultImage the smoothed label image the surface was extracted from
+    */
+    template <typename TPixel, unsigned int VImageDimension>
+    vtkSmartPointer<vtkPolyData> CreateLabelSurface(const itk::Image<TPixel, VImageDimension> *input,
+                                                    TPixel label,
+                                                    itk::ThreadIdType numberOfThreads,
+                                                    mitk::Image::Pointer &resultImage);
+
+    template <typename TPixel, unsigned int VImageDimension>
+    void GenerateAllLabelSurfaces(const itk::Image<TPixel, VImageDimension> *input);
+
     bool m_GenerateAllLabels;
 
     int m_RequestedLabel;
@@ -143,6 +172,8 @@ namespace mitk
 
     IndexToLabelMapType m_IndexToLabels;
 
+    LabelSurfaceMapType m_LabelSurfaces;
+
     mitk::Vector3D m_InputImageSpacing;
 
     void GenerateData() override;
@@ -17,7 +17,8 @@ found in the LICENSE file.
 
 namespace mitk
 {
-  LabelSetImageToSurfaceThreadedFilter::LabelSetImageToSurfaceThreadedFilter() : m_RequestedLabel(1), m_Result(nullptr)
+  LabelSetImageToSurfaceThreadedFilter::LabelSetImageToSurfaceThreadedFilter()
+    : m_RequestedLabel(1), m_GenerateAllLabels(false), m_Result(nullptr)
   {
   }
 
@@ -70,10 +71,19 @@ namespace mitk
       MITK_WARN << "\"RequestedLabel\" parameter was not set: will use the default value (" << m_RequestedLabel << ").";
     }
 
+    try
+    {
+      this->GetParameter("GenerateAllLabels", m_GenerateAllLabels);
+    }
+    catch (std::invalid_argument &)
+    {
+      // optional parameter, surfaces are generated for the requested label only by default
+    }
+
     mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
     filter->SetInput(image);
     //  filter->SetObserver(obsv);
-    filter->SetGenerateAllLabels(false);
+    filter->SetGenerateAllLabels(m_GenerateAllLabels);
     filter->SetRequestedLabel(m_RequestedLabel);
     filter->SetUseSmoothing(useSmoothing);
 
@@ -97,6 +107,12 @@ namespace mitk
       return false;
     }
 
+    if (m_GenerateAllLabels)
+    {
+      m_LabelSurfaces = filter->GetLabelSurfaces();
+      return !m_LabelSurfaces.empty();
+    }
+
     m_Result = filter->GetOutput();
 
     if (m_Result.IsNull() || !m_Result->GetVtkPolyData())
@@ -115,6 +131,25 @@ namespace mitk
     std::string name = this->GetGroupNode()->GetName();
     name.append("-surf");
 
+    if (m_GenerateAllLabels)
+    {
+      for (const auto &labelSurface : m_LabelSurfaces)
+      {
+        mitk::Label *label = image->GetLabel(labelSurface.first, image->GetActiveLayer());
+
+        mitk::DataNode::Pointer node = mitk::DataNode::New();
+        node->SetData(labelSurface.second);
+        node->SetName(label ? name + "-" + label->GetName() : name + "-" + std::to_string(labelSurface.first));
+        if (label)
+          node->SetColor(label->GetColor());
+
+        this->InsertBelowGroupNode(node);
+      }
+
+      Superclass::ThreadedUpdateSuccessful();
+      return;
+    }
+
     mitk::DataNode::Pointer node = mitk::DataNode::New();
     node->SetData(m_Result);
     node->SetName(name);
@@ -14,6 +14,7 @@ found in the LICENSE file.
 #define __mitkLabelSetImageToSurfaceThreadedFilter_H_
 
 #include "mitkSegmentationSink.h"
+#include "mitkLabelSetImageToSurfaceFilter.h"
 #include "mitkSurface.h"
 #include <MitkMultilabelExports.h>
 
@@ -38,7 +39,9 @@ namespace mitk
 
   private:
     int m_RequestedLabel;
+    bool m_GenerateAllLabels;
     Surface::Pointer m_Result;
+    LabelSetImageToSurfaceFilter::LabelSurfaceMapType m_LabelSurfaces;
   };
 
 } // namespace
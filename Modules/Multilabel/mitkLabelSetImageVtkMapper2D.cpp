@@ -52,6 +52,42 @@ found in the LICENSE file.
 #include <itkRGBAPixel.h>
 #include <mitkRenderingModeProperty.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  /** \brief Slices of the image that the plane of the world geometry may cut, with a margin of one slice. */
+  void GetDisplayedSlices(const mitk::BaseGeometry *imageGeometry,
+                          const mitk::BaseGeometry *worldGeometry,
+                          unsigned int numberOfSlices,
+                          unsigned int &firstSlice,
+                          unsigned int &lastSlice)
+  {
+    firstSlice = 0;
+    lastSlice = numberOfSlices - 1;
+    if (nullptr != dynamic_cast<const mitk::AbstractTransformGeometry *>(worldGeometry))
+    {
+      return;
+    }
+
+    double minimum = std::numeric_limits<double>::max();
+    double maximum = std::numeric_limits<double>::lowest();
+    for (int corner = 0; corner < 8; ++corner)
+    {
+      mitk::Point3D index;
+      imageGeometry->WorldToIndex(worldGeometry->GetCornerPoint(corner), index);
+      minimum = std::min(minimum, index[2]);
+      maximum = std::max(maximum, index[2]);
+    }
+
+    const double last = static_cast<double>(numberOfSlices - 1);
+    firstSlice = static_cast<unsigned int>(std::min(std::max(std::floor(minimum) - 1.0, 0.0), last));
+    lastSlice = static_cast<unsigned int>(std::min(std::max(std::ceil(maximum) + 1.0, 0.0), last));
+  }
+}
+
 mitk::LabelSetImageVtkMapper2D::LabelSetImageVtkMapper2D()
 {
 }
@@ -97,6 +133,7 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     localStorage->m_NumberOfLayers = numberOfLayers;
     localStorage->m_ReslicedImageVector.clear();
     localStorage->m_ReslicerVector.clear();
+    localStorage->m_SliceVector.clear();
     localStorage->m_LayerTextureVector.clear();
     localStorage->m_LevelWindowFilterVector.clear();
     localStorage->m_LayerMapperVector.clear();
@@ -108,6 +145,7 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     {
       localStorage->m_ReslicedImageVector.push_back(vtkSmartPointer<vtkImageData>::New());
       localStorage->m_ReslicerVector.push_back(mitk::ExtractSliceFilter::New());
+      localStorage->m_SliceVector.push_back(nullptr);
       localStorage->m_LayerTextureVector.push_back(vtkSmartPointer<vtkNeverTranslucentTexture>::New());
       localStorage->m_LevelWindowFilterVector.push_back(vtkSmartPointer<vtkMitkLevelWindowFilter>::New());
       localStorage->m_LayerMapperVector.push_back(vtkSmartPointer<vtkPolyDataMapper>::New());
@@ -145,21 +183,41 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
 
   for (int lidx = 0; lidx < numberOfLayers; ++lidx)
   {
-    mitk::Image *layerImage = nullptr;
+    const mitk::Image *layerImage = nullptr;
+    mitk::Image::Pointer layerSlices;
+    int layerTimeStep = this->GetTimestep();
 
     // set main input for ExtractSliceFilter
     if (lidx == activeLayer)
+    {
       layerImage = image;
+    }
+    else if (image->GetSparseLayerStorage())
+    {
+      // decode only the slices the plane cuts instead of the whole layer
+      unsigned int firstSlice = 0;
+      unsigned int lastSlice = 0;
+      GetDisplayedSlices(image->GetTimeGeometry()->GetGeometryForTimeStep(layerTimeStep),
+                         worldGeometry,
+                         image->GetDimension(2),
+                         firstSlice,
+                         lastSlice);
+      layerSlices = image->GetLayerSlices(lidx, layerTimeStep, firstSlice, lastSlice);
+      layerImage = layerSlices;
+      layerTimeStep = 0;
+    }
     else
-      layerImage = image->GetLayerImage(lidx);
+    {
+      layerImage = static_cast<const LabelSetImage *>(image)->GetLayerImage(lidx);
+    }
 
     localStorage->m_ReslicerVector[lidx]->SetInput(layerImage);
     localStorage->m_ReslicerVector[lidx]->SetWorldGeometry(worldGeometry);
-    localStorage->m_ReslicerVector[lidx]->SetTimeStep(this->GetTimestep());
+    localStorage->m_ReslicerVector[lidx]->SetTimeStep(layerTimeStep);
 
     // set the transformation of the image to adapt reslice axis
     localStorage->m_ReslicerVector[lidx]->SetResliceTransformByGeometry(
-      layerImage->GetTimeGeometry()->GetGeometryForTimeStep(this->GetTimestep()));
+      layerImage->GetTimeGeometry()->GetGeometryForTimeStep(layerTimeStep));
 
     // is the geometry of the slice based on the image image or the worldgeometry?
     bool inPlaneResampleExtentByGeometry = false;
@@ -188,12 +246,33 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     // setup the textured plane
     this->GeneratePlane(renderer, sliceBounds);
 
+    // other renderers may have resliced the same plane already; curved planes are not shared
+    ImageSliceCache *sliceCache = ImageSliceCache::GetInstance();
+    std::unique_ptr<ImageSliceCache::Key> sliceKey;
+    localStorage->m_SliceVector[lidx] = nullptr;
+    if (layerSlices.IsNull() && nullptr == dynamic_cast<const AbstractTransformGeometry *>(worldGeometry))
+    {
+      sliceKey.reset(new ImageSliceCache::Key(layerImage,
+                                              worldGeometry,
+                                              this->GetTimestep(),
+                                              ExtractSliceFilter::RESLICE_NEAREST,
+                                              inPlaneResampleExtentByGeometry));
+      localStorage->m_SliceVector[lidx] = sliceCache->Find(*sliceKey);
+    }
+
+    if (!localStorage->m_SliceVector[lidx])
+    {
+      auto reslicer = localStorage->m_ReslicerVector[lidx];
+      reslicer->Modified();
+      // start the pipeline with updating the largest possible, needed if the geometry of the image has changed
+      reslicer->UpdateLargestPossibleRegion();
+      localStorage->m_SliceVector[lidx] = sliceKey ? sliceCache->Insert(*sliceKey, reslicer)
+                                                   : ImageSliceCache::CreateSlice(reslicer, reslicer->GetVtkOutput());
+    }
+    localStorage->m_ReslicedImageVector[lidx] = localStorage->m_SliceVector[lidx]->m_Image;
+
     // get the spacing of the slice
-    localStorage->m_mmPerPixel = localStorage->m_ReslicerVector[lidx]->GetOutputSpacing();
-    localStorage->m_ReslicerVector[lidx]->Modified();
-    // start the pipeline with updating the largest possible, needed if the geometry of the image has changed
-    localStorage->m_ReslicerVector[lidx]->UpdateLargestPossibleRegion();
-    localStorage->m_ReslicedImageVector[lidx] = localStorage->m_ReslicerVector[lidx]->GetVtkOutput();
+    localStorage->m_mmPerPixel = localStorage->m_SliceVector[lidx]->m_Spacing;
 
     const auto *planeGeometry = dynamic_cast<const PlaneGeometry *>(worldGeometry);
 
@@ -206,7 +285,7 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     // Calculate the actual bounds of the transformed plane clipped by the
     // dataset bounding box; this is required for drawing the texture at the
     // correct position during 3D mapping.
-    mitk::PlaneClipping::CalculateClippedPlaneBounds(layerImage->GetGeometry(), planeGeometry, textureClippingBounds);
+    mitk::PlaneClipping::CalculateClippedPlaneBounds(image->GetGeometry(), planeGeometry, textureClippingBounds);
 
     textureClippingBounds[0] = static_cast<int>(textureClippingBounds[0] / localStorage->m_mmPerPixel[0] + 0.5);
     textureClippingBounds[1] = static_cast<int>(textureClippingBounds[1] / localStorage->m_mmPerPixel[0] + 0.5);
@@ -579,7 +658,7 @@ void mitk::LabelSetImageVtkMapper2D::TransformActor(mitk::BaseRenderer *renderer
   LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
   // get the transformation matrix of the reslicer in order to render the slice as axial, coronal or saggital
   vtkSmartPointer<vtkTransform> trans = vtkSmartPointer<vtkTransform>::New();
-  vtkSmartPointer<vtkMatrix4x4> matrix = localStorage->m_ReslicerVector[0]->GetResliceAxes(); // same for all layers
+  vtkSmartPointer<vtkMatrix4x4> matrix = localStorage->m_SliceVector[0]->m_ResliceAxes; // same for all layers
   trans->SetMatrix(matrix);
 
   for (int lidx = 0; lidx < localStorage->m_NumberOfLayers; ++lidx)
@@ -20,6 +20,7 @@ found in the LICENSE file.
 // MITK Rendering
 #include "mitkBaseRenderer.h"
 #include "mitkExtractSliceFilter.h"
+#include "mitkImageSliceCache.h"
 #include "mitkLabelSetImage.h"
 #include "mitkVtkMapper.h"
 
@@ -96,6 +97,8 @@ namespace mitk
       vtkSmartPointer<vtkPlaneSource> m_Plane;
 
       std::vector<mitk::ExtractSliceFilter::Pointer> m_ReslicerVector;
+      /** \brief Current slices of the layers, possibly shared with other renderers via the ImageSliceCache. */
+      std::vector<ImageSliceCache::SlicePointer> m_SliceVector;
 
       vtkSmartPointer<vtkPolyData> m_OutlinePolyData;
       /** \brief An actor for the outline */
@@ -112,7 +115,7 @@ namespace mitk
       itk::TimeStamp m_LastPropertyUpdateTime;
 
       /** \brief mmPerPixel relation between pixel and mm. (World spacing).*/
-      mitk::ScalarType *m_mmPerPixel;
+      const mitk::ScalarType *m_mmPerPixel;
 
       int m_NumberOfLayers;
 
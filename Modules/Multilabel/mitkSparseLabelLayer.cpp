@@ -0,0 +1,190 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkSparseLabelLayer.h"
+
+#include <mitkExceptionMacro.h>
+
+#include <algorithm>
+#include <limits>
+
+mitk::SparseLabelLayer::SparseLabelLayer() : m_ChunkSize(0)
+{
+}
+
+mitk::SparseLabelLayer::SparseLabelLayer(const SparseLabelLayer &other)
+  : itk::Object(), m_ChunkSize(other.m_ChunkSize), m_Chunks(other.m_Chunks)
+{
+}
+
+mitk::SparseLabelLayer::~SparseLabelLayer()
+{
+}
+
+void mitk::SparseLabelLayer::Initialize(std::size_t chunkSize, std::size_t numberOfChunks)
+{
+  if (chunkSize > std::numeric_limits<unsigned int>::max())
+  {
+    mitkThrow() << "Chunk size " << chunkSize << " exceeds the maximum run length.";
+  }
+
+  m_ChunkSize = chunkSize;
+  m_Chunks.clear();
+  m_Chunks.resize(numberOfChunks);
+  this->Modified();
+}
+
+std::size_t mitk::SparseLabelLayer::Update(const PixelType *buffer)
+{
+  std::size_t numberOfChangedChunks = 0;
+  for (std::size_t chunk = 0; chunk < m_Chunks.size(); ++chunk)
+  {
+    const PixelType *pixels = buffer + chunk * m_ChunkSize;
+    if (!this->ChunkEquals(m_Chunks[chunk], pixels))
+    {
+      this->EncodeChunk(pixels, m_Chunks[chunk]);
+      ++numberOfChangedChunks;
+    }
+  }
+
+  if (numberOfChangedChunks > 0)
+  {
+    this->Modified();
+  }
+  return numberOfChangedChunks;
+}
+
+std::size_t mitk::SparseLabelLayer::Update(const PixelType *buffer, const std::set<std::size_t> &chunks)
+{
+  std::size_t numberOfChangedChunks = 0;
+  for (auto chunk : chunks)
+  {
+    if (chunk >= m_Chunks.size())
+    {
+      break;
+    }
+
+    const PixelType *pixels = buffer + chunk * m_ChunkSize;
+    if (!this->ChunkEquals(m_Chunks[chunk], pixels))
+    {
+      this->EncodeChunk(pixels, m_Chunks[chunk]);
+      ++numberOfChangedChunks;
+    }
+  }
+
+  if (numberOfChangedChunks > 0)
+  {
+    this->Modified();
+  }
+  return numberOfChangedChunks;
+}
+
+std::size_t mitk::SparseLabelLayer::WriteTo(PixelType *buffer, const SparseLabelLayer *bufferContent) const
+{
+  if (bufferContent && (bufferContent->m_ChunkSize != m_ChunkSize || bufferContent->m_Chunks.size() != m_Chunks.size()))
+  {
+    mitkThrow() << "Layers differ in size.";
+  }
+
+  std::size_t numberOfWrittenChunks = 0;
+  for (std::size_t chunk = 0; chunk < m_Chunks.size(); ++chunk)
+  {
+    if (bufferContent && bufferContent->m_Chunks[chunk] == m_Chunks[chunk])
+    {
+      continue;
+    }
+
+    this->DecodeChunk(m_Chunks[chunk], buffer + chunk * m_ChunkSize);
+    ++numberOfWrittenChunks;
+  }
+  return numberOfWrittenChunks;
+}
+
+void mitk::SparseLabelLayer::WriteChunksTo(PixelType *buffer, std::size_t firstChunk, std::size_t numberOfChunks) const
+{
+  if (firstChunk + numberOfChunks > m_Chunks.size())
+  {
+    mitkThrow() << "Chunks " << firstChunk << " to " << firstChunk + numberOfChunks << " exceed the "
+                << m_Chunks.size() << " chunks of the layer.";
+  }
+
+  for (std::size_t chunk = 0; chunk < numberOfChunks; ++chunk)
+  {
+    this->DecodeChunk(m_Chunks[firstChunk + chunk], buffer + chunk * m_ChunkSize);
+  }
+}
+
+std::size_t mitk::SparseLabelLayer::GetMemoryUsage() const
+{
+  std::size_t memoryUsage = m_Chunks.capacity() * sizeof(ChunkType);
+  for (const auto &chunk : m_Chunks)
+  {
+    memoryUsage += chunk.capacity() * sizeof(Run);
+  }
+  return memoryUsage;
+}
+
+bool mitk::SparseLabelLayer::ChunkEquals(const ChunkType &chunk, const PixelType *pixels) const
+{
+  // an empty chunk contains the exterior label only
+  if (chunk.empty())
+  {
+    return std::all_of(pixels, pixels + m_ChunkSize, [](PixelType value) { return value == 0; });
+  }
+
+  for (const auto &run : chunk)
+  {
+    const PixelType *runEnd = pixels + run.m_Length;
+    for (; pixels != runEnd; ++pixels)
+    {
+      if (*pixels != run.m_Value)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void mitk::SparseLabelLayer::EncodeChunk(const PixelType *pixels, ChunkType &chunk) const
+{
+  chunk.clear();
+
+  const PixelType *end = pixels + m_ChunkSize;
+  while (pixels != end)
+  {
+    const PixelType value = *pixels;
+    const PixelType *runEnd = std::find_if(pixels, end, [value](PixelType other) { return other != value; });
+    chunk.push_back(Run{value, static_cast<unsigned int>(runEnd - pixels)});
+    pixels = runEnd;
+  }
+
+  if (chunk.size() == 1 && chunk.front().m_Value == 0)
+  {
+    chunk.clear();
+  }
+  chunk.shrink_to_fit();
+}
+
+void mitk::SparseLabelLayer::DecodeChunk(const ChunkType &chunk, PixelType *pixels) const
+{
+  if (chunk.empty())
+  {
+    std::fill(pixels, pixels + m_ChunkSize, 0);
+    return;
+  }
+
+  for (const auto &run : chunk)
+  {
+    pixels = std::fill_n(pixels, run.m_Length, run.m_Value);
+  }
+}
@@ -0,0 +1,123 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef __mitkSparseLabelLayer_H_
+#define __mitkSparseLabelLayer_H_
+
+#include <MitkMultilabelExports.h>
+#include <mitkCommon.h>
+#include <mitkLabel.h>
+
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+
+#include <set>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * @brief Run-length encoded storage of one layer of a LabelSetImage.
+   *
+   * The pixel buffer of the layer is divided into chunks of equal size (e.g. one slice each). Every chunk is stored
+   * as a sequence of runs of equal pixel values; chunks containing only the exterior label (0) need no memory at all.
+   *
+   * Update() re-encodes only the chunks that differ from a given dense buffer, optionally restricted to the chunks
+   * known to be modified. WriteTo() decodes the layer into a
+   * dense buffer and, if the layer currently held by that buffer is passed as well, skips all chunks that are equal
+   * in both layers. Switching between mostly empty layers thus costs time proportional to the chunks that differ.
+   */
+  class MITKMULTILABEL_EXPORT SparseLabelLayer : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(SparseLabelLayer, itk::Object);
+    itkFactorylessNewMacro(Self);
+    itkCloneMacro(Self);
+
+    typedef mitk::Label::PixelType PixelType;
+
+    /**
+     * @brief Resets the layer to numberOfChunks chunks of chunkSize pixels, all set to the exterior label.
+     */
+    void Initialize(std::size_t chunkSize, std::size_t numberOfChunks);
+
+    /**
+     * @brief Encodes the chunks of buffer that differ from the stored ones.
+     * @param buffer dense pixel buffer of GetNumberOfPixels() pixels
+     * @return the number of chunks that changed
+     */
+    std::size_t Update(const PixelType *buffer);
+
+    /**
+     * @brief Encodes the given chunks of buffer if they differ from the stored ones, all other chunks are kept.
+     *
+     * Allows to update a layer in time proportional to the modified part of the buffer if it is known.
+     * @param buffer dense pixel buffer of GetNumberOfPixels() pixels
+     * @param chunks indices of the chunks to compare, indices beyond GetNumberOfChunks() are ignored
+     * @return the number of chunks that changed
+     */
+    std::size_t Update(const PixelType *buffer, const std::set<std::size_t> &chunks);
+
+    /**
+     * @brief Decodes the layer into buffer.
+     * @param buffer dense pixel buffer of GetNumberOfPixels() pixels
+     * @param bufferContent layer whose content the buffer currently holds, or nullptr. If given,
+     *        chunks that are equal in both layers are not written.
+     * @return the number of chunks written
+     */
+    std::size_t WriteTo(PixelType *buffer, const SparseLabelLayer *bufferContent = nullptr) const;
+
+    /**
+     * @brief Decodes the chunks [firstChunk, firstChunk + numberOfChunks) into buffer.
+     * @param buffer dense pixel buffer of numberOfChunks * GetChunkSize() pixels
+     */
+    void WriteChunksTo(PixelType *buffer, std::size_t firstChunk, std::size_t numberOfChunks) const;
+
+    itkGetConstMacro(ChunkSize, std::size_t);
+
+    std::size_t GetNumberOfChunks() const { return m_Chunks.size(); }
+
+    std::size_t GetNumberOfPixels() const { return m_ChunkSize * m_Chunks.size(); }
+
+    /** @brief Number of bytes occupied by the runs of all chunks. */
+    std::size_t GetMemoryUsage() const;
+
+  protected:
+    SparseLabelLayer();
+    SparseLabelLayer(const SparseLabelLayer &other);
+    ~SparseLabelLayer() override;
+
+    mitkCloneMacro(Self);
+
+  private:
+    struct Run
+    {
+      PixelType m_Value;
+      unsigned int m_Length;
+
+      bool operator==(const Run &other) const { return m_Value == other.m_Value && m_Length == other.m_Length; }
+    };
+
+    typedef std::vector<Run> ChunkType;
+
+    /** @brief Checks whether the stored chunk equals the given pixels without decoding it. */
+    bool ChunkEquals(const ChunkType &chunk, const PixelType *pixels) const;
+
+    void EncodeChunk(const PixelType *pixels, ChunkType &chunk) const;
+    void DecodeChunk(const ChunkType &chunk, PixelType *pixels) const;
+
+    std::size_t m_ChunkSize;
+    std::vector<ChunkType> m_Chunks;
+  };
+}
+
+#endif
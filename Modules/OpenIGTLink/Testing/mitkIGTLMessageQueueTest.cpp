@@ -0,0 +1,254 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+//TEST
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+//STD
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+//MITK
+#include "mitkIGTLClient.h"
+#include "mitkIGTLMessageQueue.h"
+#include "mitkIGTLServer.h"
+
+//IGTL
+#include "igtlTimeStamp.h"
+
+static const int PORT = 35360;
+static const std::string HOSTNAME = "localhost";
+
+class mitkIGTLMessageQueueTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkIGTLMessageQueueTestSuite);
+  MITK_TEST(Test_RingBuffer_FullQueue_DropsOldestMessages);
+  MITK_TEST(Test_NoBuffering_KeepsLatestMessage);
+  MITK_TEST(Test_SwitchToRingBuffer_BufferedMessagesPulledFirst);
+  MITK_TEST(Test_RingBuffer_ConcurrentConsumers_EveryMessagePulledOnce);
+  MITK_TEST(Test_Loopback_Latency);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::IGTLMessageQueue::Pointer m_Queue;
+
+  static igtl::TransformMessage::Pointer CreateMessage(const std::string &name)
+  {
+    igtl::TransformMessage::Pointer message = igtl::TransformMessage::New();
+    message->SetDeviceName(name.c_str());
+    return message;
+  }
+
+  void PushMessages(int first, int last)
+  {
+    for (int i = first; i < last; ++i)
+    {
+      m_Queue->PushMessage(CreateMessage(std::to_string(i)).GetPointer());
+    }
+  }
+
+  std::string PullName()
+  {
+    igtl::TransformMessage::Pointer message = m_Queue->PullTransformMessage();
+    return message.IsNotNull() ? std::string(message->GetDeviceName()) : std::string();
+  }
+
+  /** Sends transform messages from a server to a client on the local host and reports the times from sending
+  to pulling them */
+  void MeasureLoopbackLatency(mitk::IGTLMessageQueue::BufferingType bufferingType, const std::string &name)
+  {
+    mitk::IGTLServer::Pointer server = mitk::IGTLServer::New(true);
+    server->SetHostname(HOSTNAME);
+    server->SetPortNumber(PORT);
+    mitk::IGTLClient::Pointer client = mitk::IGTLClient::New(true);
+    client->SetHostname(HOSTNAME);
+    client->SetPortNumber(PORT);
+    client->GetMessageQueue()->SetBufferingType(bufferingType);
+
+    CPPUNIT_ASSERT_MESSAGE("Could not open connection with server", server->OpenConnection());
+    server->StartCommunication();
+    CPPUNIT_ASSERT_MESSAGE("Could not connect to server", client->OpenConnection());
+    CPPUNIT_ASSERT_MESSAGE("Could not start communication with client", client->StartCommunication());
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    const int numberOfMessages = 200;
+    std::atomic<bool> sending(true);
+    std::thread sender([&]() {
+      for (int i = 0; i < numberOfMessages; ++i)
+      {
+        igtl::TransformMessage::Pointer message = CreateMessage("Latency");
+        igtl::TimeStamp::Pointer timeStamp = igtl::TimeStamp::New();
+        timeStamp->GetTime();
+        message->SetTimeStamp(timeStamp);
+        server->SendMessage(mitk::IGTLMessage::New(message.GetPointer()));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      sending = false;
+    });
+
+    std::vector<double> latencies;
+    igtl::TimeStamp::Pointer now = igtl::TimeStamp::New();
+    igtl::TimeStamp::Pointer sent = igtl::TimeStamp::New();
+    while (sending)
+    {
+      igtl::TransformMessage::Pointer message = client->GetMessageQueue()->PullTransformMessage();
+      if (message.IsNull())
+      {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        continue;
+      }
+      now->GetTime();
+      message->GetTimeStamp(sent);
+      latencies.push_back((now->GetTimeStamp() - sent->GetTimeStamp()) * 1000.0);
+    }
+    sender.join();
+
+    const auto statistics = client->GetMessageQueue()->GetStatistics(mitk::IGTLMessageQueue::TransformQueue);
+
+    CPPUNIT_ASSERT(client->StopCommunication());
+    CPPUNIT_ASSERT(server->StopCommunication());
+    CPPUNIT_ASSERT(client->CloseConnection());
+    CPPUNIT_ASSERT(server->CloseConnection());
+
+    CPPUNIT_ASSERT_MESSAGE("No message was received", !latencies.empty());
+
+    std::sort(latencies.begin(), latencies.end());
+    MITK_INFO << name << ": received " << latencies.size() << " of " << numberOfMessages << " messages"
+              << ", end-to-end latency median " << latencies[latencies.size() / 2] << " ms"
+              << ", 99th percentile " << latencies[latencies.size() * 99 / 100] << " ms"
+              << ", maximum " << latencies.back() << " ms"
+              << "; in queue mean " << statistics.m_MeanLatency << " ms"
+              << ", maximum " << statistics.m_MaximumLatency << " ms"
+              << ", dropped " << statistics.m_NumberOfDroppedMessages;
+  }
+
+public:
+  void setUp() override
+  {
+    m_Queue = mitk::IGTLMessageQueue::New();
+  }
+
+  void tearDown() override
+  {
+    m_Queue = nullptr;
+  }
+
+  void Test_RingBuffer_FullQueue_DropsOldestMessages()
+  {
+    m_Queue->SetBufferingType(mitk::IGTLMessageQueue::RingBuffer);
+    m_Queue->SetRingBufferCapacity(4);
+    this->PushMessages(0, 6);
+
+    CPPUNIT_ASSERT_EQUAL(4, m_Queue->GetSize());
+    for (int i = 2; i < 6; ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(std::to_string(i), this->PullName());
+    }
+    CPPUNIT_ASSERT(m_Queue->PullTransformMessage().IsNull());
+
+    const auto statistics = m_Queue->GetStatistics(mitk::IGTLMessageQueue::TransformQueue);
+    CPPUNIT_ASSERT_EQUAL(6ul, statistics.m_NumberOfPushedMessages);
+    CPPUNIT_ASSERT_EQUAL(4ul, statistics.m_NumberOfPulledMessages);
+    CPPUNIT_ASSERT_EQUAL(2ul, statistics.m_NumberOfDroppedMessages);
+    CPPUNIT_ASSERT(statistics.m_MaximumLatency >= statistics.m_MeanLatency);
+
+    m_Queue->ResetStatistics();
+    const auto resetStatistics = m_Queue->GetStatistics(mitk::IGTLMessageQueue::TransformQueue);
+    CPPUNIT_ASSERT_EQUAL(0ul, resetStatistics.m_NumberOfPushedMessages);
+  }
+
+  void Test_NoBuffering_KeepsLatestMessage()
+  {
+    m_Queue->EnableNoBufferingMode(true);
+    this->PushMessages(0, 3);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("2"), this->PullName());
+    CPPUNIT_ASSERT(m_Queue->PullTransformMessage().IsNull());
+    const auto statistics = m_Queue->GetStatistics(mitk::IGTLMessageQueue::TransformQueue);
+    CPPUNIT_ASSERT_EQUAL(2ul, statistics.m_NumberOfDroppedMessages);
+  }
+
+  void Test_SwitchToRingBuffer_BufferedMessagesPulledFirst()
+  {
+    m_Queue->EnableNoBufferingMode(false);
+    this->PushMessages(0, 2);
+    m_Queue->SetBufferingType(mitk::IGTLMessageQueue::RingBuffer);
+    this->PushMessages(2, 4);
+
+    for (int i = 0; i < 4; ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(std::to_string(i), this->PullName());
+    }
+  }
+
+  void Test_RingBuffer_ConcurrentConsumers_EveryMessagePulledOnce()
+  {
+    m_Queue->SetBufferingType(mitk::IGTLMessageQueue::RingBuffer);
+    m_Queue->SetRingBufferCapacity(64);
+
+    const int numberOfMessages = 20000;
+    std::vector<igtl::TransformMessage::Pointer> messages;
+    for (int i = 0; i < numberOfMessages; ++i)
+    {
+      messages.push_back(CreateMessage(std::to_string(i)));
+    }
+
+    std::atomic<bool> producing(true);
+    std::atomic<unsigned long> numberOfPulledMessages(0);
+    auto consume = [&]() {
+      for (;;)
+      {
+        const bool lastRound = !producing;
+        if (m_Queue->PullTransformMessage().IsNotNull())
+          ++numberOfPulledMessages;
+        else if (lastRound)
+          break;
+      }
+    };
+
+    std::vector<std::thread> consumers;
+    for (int i = 0; i < 3; ++i)
+    {
+      consumers.emplace_back(consume);
+    }
+    for (const auto &message : messages)
+    {
+      m_Queue->PushMessage(message.GetPointer());
+    }
+    producing = false;
+    for (auto &consumer : consumers)
+    {
+      consumer.join();
+    }
+
+    const auto statistics = m_Queue->GetStatistics(mitk::IGTLMessageQueue::TransformQueue);
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned long>(numberOfMessages), statistics.m_NumberOfPushedMessages);
+    CPPUNIT_ASSERT_EQUAL(numberOfPulledMessages.load(), statistics.m_NumberOfPulledMessages);
+    CPPUNIT_ASSERT_EQUAL(statistics.m_NumberOfPushedMessages,
+                         statistics.m_NumberOfPulledMessages + statistics.m_NumberOfDroppedMessages);
+    CPPUNIT_ASSERT_EQUAL(0, m_Queue->GetSize());
+  }
+
+  void Test_Loopback_Latency()
+  {
+    this->MeasureLoopbackLatency(mitk::IGTLMessageQueue::Infinit, "Infinit");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    this->MeasureLoopbackLatency(mitk::IGTLMessageQueue::RingBuffer, "RingBuffer");
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkIGTLMessageQueue)
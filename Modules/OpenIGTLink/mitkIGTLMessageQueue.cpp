@@ -11,207 +11,224 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkIGTLMessageQueue.h"
+#include "mitkIGTLRingBuffer.h"
 #include <string>
 #include "igtlMessageBase.h"
 
-void mitk::IGTLMessageQueue::PushSendMessage(mitk::IGTLMessage::Pointer message)
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+template <typename T>
+class mitk::IGTLMessageQueue::Queue
 {
-  this->m_Mutex->Lock();
-  if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-    m_SendQueue.clear();
+public:
+  explicit Queue(unsigned int ringBufferCapacity)
+    : m_DequeSize(0),
+      m_RingBuffer(new IGTLRingBuffer<Entry>(ringBufferCapacity))
+  {
+    this->ResetStatistics();
+  }
 
-  m_SendQueue.push_back(message);
-  this->m_Mutex->Unlock();
+  void Push(const T &message, BufferingType bufferingType)
+  {
+    Entry entry;
+    entry.m_Message = message;
+    entry.m_PushTime = std::chrono::steady_clock::now();
+    ++m_NumberOfPushedMessages;
+
+    if (bufferingType == IGTLMessageQueue::RingBuffer)
+    {
+      // drop the oldest messages until there is a free slot
+      while (!m_RingBuffer->Push(entry))
+      {
+        Entry dropped;
+        if (m_RingBuffer->Pop(dropped))
+          ++m_NumberOfDroppedMessages;
+      }
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (bufferingType == IGTLMessageQueue::NoBuffering)
+    {
+      m_NumberOfDroppedMessages += m_Deque.size();
+      m_Deque.clear();
+    }
+    m_Deque.push_back(entry);
+    m_DequeSize = m_Deque.size();
+  }
+
+  T Pull()
+  {
+    Entry entry;
+
+    // messages pushed before the buffering type was switched to RingBuffer come first
+    if (m_DequeSize > 0)
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      if (!m_Deque.empty())
+      {
+        entry = m_Deque.front();
+        m_Deque.pop_front();
+        m_DequeSize = m_Deque.size();
+      }
+    }
+
+    if (entry.m_Message.IsNull() && !m_RingBuffer->Pop(entry))
+      return nullptr;
+
+    const auto latency = static_cast<unsigned long long>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - entry.m_PushTime)
+        .count());
+    ++m_NumberOfPulledMessages;
+    m_SumOfLatencies += latency;
+    auto maximum = m_MaximumLatency.load();
+    while (latency > maximum && !m_MaximumLatency.compare_exchange_weak(maximum, latency))
+    {
+    }
+
+    return entry.m_Message;
+  }
+
+  std::size_t GetSize() const { return m_DequeSize + m_RingBuffer->GetSize(); }
+
+  void SetRingBufferCapacity(unsigned int capacity)
+  {
+    m_RingBuffer.reset(new IGTLRingBuffer<Entry>(capacity));
+  }
+
+  QueueStatistics GetStatistics() const
+  {
+    QueueStatistics statistics;
+    statistics.m_NumberOfPushedMessages = m_NumberOfPushedMessages;
+    statistics.m_NumberOfPulledMessages = m_NumberOfPulledMessages;
+    statistics.m_NumberOfDroppedMessages = m_NumberOfDroppedMessages;
+    statistics.m_MeanLatency = statistics.m_NumberOfPulledMessages > 0
+                                 ? m_SumOfLatencies * 1e-6 / statistics.m_NumberOfPulledMessages
+                                 : 0.0;
+    statistics.m_MaximumLatency = m_MaximumLatency * 1e-6;
+    return statistics;
+  }
+
+  void ResetStatistics()
+  {
+    m_NumberOfPushedMessages = 0;
+    m_NumberOfPulledMessages = 0;
+    m_NumberOfDroppedMessages = 0;
+    m_SumOfLatencies = 0;
+    m_MaximumLatency = 0;
+  }
+
+private:
+  struct Entry
+  {
+    T m_Message;
+    std::chrono::steady_clock::time_point m_PushTime;
+  };
+
+  std::mutex m_Mutex;
+  std::deque<Entry> m_Deque;
+  std::atomic<std::size_t> m_DequeSize;
+
+  std::unique_ptr<IGTLRingBuffer<Entry>> m_RingBuffer;
+
+  std::atomic<unsigned long> m_NumberOfPushedMessages;
+  std::atomic<unsigned long> m_NumberOfPulledMessages;
+  std::atomic<unsigned long> m_NumberOfDroppedMessages;
+  /** in ns */
+  std::atomic<unsigned long long> m_SumOfLatencies;
+  std::atomic<unsigned long long> m_MaximumLatency;
+};
+
+void mitk::IGTLMessageQueue::PushSendMessage(mitk::IGTLMessage::Pointer message)
+{
+  m_SendQueue->Push(message, m_BufferingType);
 }
 
 void mitk::IGTLMessageQueue::PushCommandMessage(igtl::MessageBase::Pointer message)
 {
-  this->m_Mutex->Lock();
-  if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-    m_CommandQueue.clear();
-
-  m_CommandQueue.push_back(message);
-  this->m_Mutex->Unlock();
+  m_CommandQueue->Push(message, m_BufferingType);
 }
 
 void mitk::IGTLMessageQueue::PushMessage(igtl::MessageBase::Pointer msg)
 {
-  this->m_Mutex->Lock();
-
-  std::stringstream infolog;
-
-  infolog << "Received message of type ";
+  const BufferingType bufferingType = m_BufferingType;
 
   if (dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer()) != nullptr)
   {
-    if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-      m_TrackingDataQueue.clear();
-
-    this->m_TrackingDataQueue.push_back(dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer()));
-
-    infolog << "TDATA";
+    this->m_TrackingDataQueue->Push(dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer()), bufferingType);
   }
   else if (dynamic_cast<igtl::TransformMessage*>(msg.GetPointer()) != nullptr)
   {
-    if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-      m_TransformQueue.clear();
-
-    this->m_TransformQueue.push_back(dynamic_cast<igtl::TransformMessage*>(msg.GetPointer()));
-
-    infolog << "TRANSFORM";
+    this->m_TransformQueue->Push(dynamic_cast<igtl::TransformMessage*>(msg.GetPointer()), bufferingType);
   }
   else if (dynamic_cast<igtl::StringMessage*>(msg.GetPointer()) != nullptr)
   {
-    if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-      m_StringQueue.clear();
-
-    this->m_StringQueue.push_back(dynamic_cast<igtl::StringMessage*>(msg.GetPointer()));
-
-    infolog << "STRING";
+    this->m_StringQueue->Push(dynamic_cast<igtl::StringMessage*>(msg.GetPointer()), bufferingType);
   }
   else if (dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()) != nullptr)
   {
     igtl::ImageMessage::Pointer imageMsg = dynamic_cast<igtl::ImageMessage*>(msg.GetPointer());
-    int* dim = new int[3];
+    int dim[3];
     imageMsg->GetDimensions(dim);
     if (dim[2] > 1)
     {
-      if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-        m_Image3dQueue.clear();
-
-      this->m_Image3dQueue.push_back(dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()));
-
-      infolog << "IMAGE3D";
+      this->m_Image3dQueue->Push(imageMsg, bufferingType);
     }
     else
     {
-      if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-        m_Image2dQueue.clear();
-
-      this->m_Image2dQueue.push_back(dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()));
-
-      infolog << "IMAGE2D";
+      this->m_Image2dQueue->Push(imageMsg, bufferingType);
     }
   }
   else
   {
-    if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-      m_MiscQueue.clear();
-
-    this->m_MiscQueue.push_back(msg);
-
-    infolog << "OTHER";
+    this->m_MiscQueue->Push(msg, bufferingType);
   }
 
+  this->m_Mutex->Lock();
   m_Latest_Message = msg;
-
-  //MITK_INFO << infolog.str();
-
   this->m_Mutex->Unlock();
 }
 
 mitk::IGTLMessage::Pointer mitk::IGTLMessageQueue::PullSendMessage()
 {
-  mitk::IGTLMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_SendQueue.size() > 0)
-  {
-    ret = this->m_SendQueue.front();
-    this->m_SendQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_SendQueue->Pull();
 }
 
 igtl::MessageBase::Pointer mitk::IGTLMessageQueue::PullMiscMessage()
 {
-  igtl::MessageBase::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_MiscQueue.size() > 0)
-  {
-    ret = this->m_MiscQueue.front();
-    this->m_MiscQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_MiscQueue->Pull();
 }
 
 igtl::ImageMessage::Pointer mitk::IGTLMessageQueue::PullImage2dMessage()
 {
-  igtl::ImageMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_Image2dQueue.size() > 0)
-  {
-    ret = this->m_Image2dQueue.front();
-    this->m_Image2dQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_Image2dQueue->Pull();
 }
 
 igtl::ImageMessage::Pointer mitk::IGTLMessageQueue::PullImage3dMessage()
 {
-  igtl::ImageMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_Image3dQueue.size() > 0)
-  {
-    ret = this->m_Image3dQueue.front();
-    this->m_Image3dQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_Image3dQueue->Pull();
 }
 
 igtl::TrackingDataMessage::Pointer mitk::IGTLMessageQueue::PullTrackingMessage()
 {
-  igtl::TrackingDataMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_TrackingDataQueue.size() > 0)
-  {
-    ret = this->m_TrackingDataQueue.front();
-    this->m_TrackingDataQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_TrackingDataQueue->Pull();
 }
 
 igtl::MessageBase::Pointer mitk::IGTLMessageQueue::PullCommandMessage()
 {
-  igtl::MessageBase::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_CommandQueue.size() > 0)
-  {
-    ret = this->m_CommandQueue.front();
-    this->m_CommandQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_CommandQueue->Pull();
 }
 
 igtl::StringMessage::Pointer mitk::IGTLMessageQueue::PullStringMessage()
 {
-  igtl::StringMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_StringQueue.size() > 0)
-  {
-    ret = this->m_StringQueue.front();
-    this->m_StringQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_StringQueue->Pull();
 }
 
 igtl::TransformMessage::Pointer mitk::IGTLMessageQueue::PullTransformMessage()
 {
-  igtl::TransformMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_TransformQueue.size() > 0)
-  {
-    ret = this->m_TransformQueue.front();
-    this->m_TransformQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_TransformQueue->Pull();
 }
 
 std::string mitk::IGTLMessageQueue::GetNextMsgInformationString()
@@ -282,24 +299,96 @@ std::string mitk::IGTLMessageQueue::GetLatestMsgDeviceType()
 
 int mitk::IGTLMessageQueue::GetSize()
 {
-  return (this->m_CommandQueue.size() + this->m_Image2dQueue.size() + this->m_Image3dQueue.size() + this->m_MiscQueue.size()
-    + this->m_StringQueue.size() + this->m_TrackingDataQueue.size() + this->m_TransformQueue.size());
+  return static_cast<int>(this->m_CommandQueue->GetSize() + this->m_Image2dQueue->GetSize() +
+    this->m_Image3dQueue->GetSize() + this->m_MiscQueue->GetSize() + this->m_StringQueue->GetSize() +
+    this->m_TrackingDataQueue->GetSize() + this->m_TransformQueue->GetSize());
 }
 
 void mitk::IGTLMessageQueue::EnableNoBufferingMode(bool enable)
 {
-  this->m_Mutex->Lock();
   if (enable)
     this->m_BufferingType = IGTLMessageQueue::BufferingType::NoBuffering;
   else
     this->m_BufferingType = IGTLMessageQueue::BufferingType::Infinit;
-  this->m_Mutex->Unlock();
+}
+
+void mitk::IGTLMessageQueue::SetBufferingType(BufferingType type)
+{
+  this->m_BufferingType = type;
+}
+
+mitk::IGTLMessageQueue::BufferingType mitk::IGTLMessageQueue::GetBufferingType() const
+{
+  return this->m_BufferingType;
+}
+
+void mitk::IGTLMessageQueue::SetRingBufferCapacity(unsigned int capacity)
+{
+  m_RingBufferCapacity = capacity;
+  m_CommandQueue->SetRingBufferCapacity(capacity);
+  m_Image2dQueue->SetRingBufferCapacity(capacity);
+  m_Image3dQueue->SetRingBufferCapacity(capacity);
+  m_TransformQueue->SetRingBufferCapacity(capacity);
+  m_TrackingDataQueue->SetRingBufferCapacity(capacity);
+  m_StringQueue->SetRingBufferCapacity(capacity);
+  m_MiscQueue->SetRingBufferCapacity(capacity);
+  m_SendQueue->SetRingBufferCapacity(capacity);
+}
+
+unsigned int mitk::IGTLMessageQueue::GetRingBufferCapacity() const
+{
+  return m_RingBufferCapacity;
+}
+
+mitk::IGTLMessageQueue::QueueStatistics mitk::IGTLMessageQueue::GetStatistics(QueueType queue) const
+{
+  switch (queue)
+  {
+    case CommandQueue:
+      return m_CommandQueue->GetStatistics();
+    case Image2dQueue:
+      return m_Image2dQueue->GetStatistics();
+    case Image3dQueue:
+      return m_Image3dQueue->GetStatistics();
+    case TransformQueue:
+      return m_TransformQueue->GetStatistics();
+    case TrackingDataQueue:
+      return m_TrackingDataQueue->GetStatistics();
+    case StringQueue:
+      return m_StringQueue->GetStatistics();
+    case MiscQueue:
+      return m_MiscQueue->GetStatistics();
+    case SendQueue:
+    default:
+      return m_SendQueue->GetStatistics();
+  }
+}
+
+void mitk::IGTLMessageQueue::ResetStatistics()
+{
+  m_CommandQueue->ResetStatistics();
+  m_Image2dQueue->ResetStatistics();
+  m_Image3dQueue->ResetStatistics();
+  m_TransformQueue->ResetStatistics();
+  m_TrackingDataQueue->ResetStatistics();
+  m_StringQueue->ResetStatistics();
+  m_MiscQueue->ResetStatistics();
+  m_SendQueue->ResetStatistics();
 }
 
 mitk::IGTLMessageQueue::IGTLMessageQueue()
+  : m_BufferingType(IGTLMessageQueue::NoBuffering),
+    m_RingBufferCapacity(128)
 {
   this->m_Mutex = itk::FastMutexLock::New();
-  this->m_BufferingType = IGTLMessageQueue::NoBuffering;
+  m_CommandQueue.reset(new Queue<igtl::MessageBase::Pointer>(m_RingBufferCapacity));
+  m_Image2dQueue.reset(new Queue<igtl::ImageMessage::Pointer>(m_RingBufferCapacity));
+  m_Image3dQueue.reset(new Queue<igtl::ImageMessage::Pointer>(m_RingBufferCapacity));
+  m_TransformQueue.reset(new Queue<igtl::TransformMessage::Pointer>(m_RingBufferCapacity));
+  m_TrackingDataQueue.reset(new Queue<igtl::TrackingDataMessage::Pointer>(m_RingBufferCapacity));
+  m_StringQueue.reset(new Queue<igtl::StringMessage::Pointer>(m_RingBufferCapacity));
+  m_MiscQueue.reset(new Queue<igtl::MessageBase::Pointer>(m_RingBufferCapacity));
+  m_SendQueue.reset(new Queue<mitk::IGTLMessage::Pointer>(m_RingBufferCapacity));
 }
 
 mitk::IGTLMessageQueue::~IGTLMessageQueue()
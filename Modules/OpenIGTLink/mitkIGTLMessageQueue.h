@@ -19,7 +19,8 @@ found in the LICENSE file.
 #include "itkFastMutexLock.h"
 #include "mitkCommon.h"
 
-#include <deque>
+#include <atomic>
+#include <memory>
 #include <mitkIGTLMessage.h>
 
 //OpenIGTLink
@@ -34,6 +35,19 @@ namespace mitk {
   * \class IGTLMessageQueue
   * \brief Thread safe message queue to store OpenIGTLink messages.
   *
+  * There is one queue per message type. Each queue has a mutex of its own,
+  * so pulling tracking data does not wait for a thread that pulls images.
+  *
+  * In the RingBuffer mode, messages are stored in bounded lock-free ring
+  * buffers (see IGTLRingBuffer) whose slots are allocated once, so neither
+  * the receiving thread nor the consumers lock or allocate. When a ring
+  * buffer is full, the oldest message is dropped. Only the latest message,
+  * which is kept for the information strings, is still guarded by a mutex.
+  *
+  * Messages are passed on as pointers and never copied. For each queue, the
+  * number of pushed, pulled and dropped messages and the time the messages
+  * waited in the queue are counted in all modes, see GetStatistics().
+  *
   * \ingroup OpenIGTLink
   */
   class MITKOPENIGTLINK_EXPORT IGTLMessageQueue : public itk::Object
@@ -47,8 +61,37 @@ namespace mitk {
        * \brief Different buffering types
        * Infinit buffering means that you can push as many messages as you want
        * NoBuffering means that the queue just stores a single message
+       * RingBuffer means that the queue stores up to GetRingBufferCapacity()
+       * messages without locking and drops the oldest one when it is full
        */
-    enum BufferingType { Infinit, NoBuffering };
+    enum BufferingType { Infinit, NoBuffering, RingBuffer };
+
+    /**
+    * \brief The queues for the different kinds of messages
+    */
+    enum QueueType
+    {
+      CommandQueue,
+      Image2dQueue,
+      Image3dQueue,
+      TransformQueue,
+      TrackingDataQueue,
+      StringQueue,
+      MiscQueue,
+      SendQueue
+    };
+
+    /**
+    * \brief Counters of a single queue. Latencies are the times in ms between pushing and pulling a message.
+    */
+    struct QueueStatistics
+    {
+      unsigned long m_NumberOfPushedMessages;
+      unsigned long m_NumberOfPulledMessages;
+      unsigned long m_NumberOfDroppedMessages;
+      double m_MeanLatency;
+      double m_MaximumLatency;
+    };
 
     void PushSendMessage(mitk::IGTLMessage::Pointer message);
 
@@ -101,38 +144,59 @@ namespace mitk {
     std::string GetLatestMsgDeviceType();
 
     /**
+     * \brief Switches between the NoBuffering (enable) and the Infinit mode
      */
     void EnableNoBufferingMode(bool enable);
 
+    void SetBufferingType(BufferingType type);
+    BufferingType GetBufferingType() const;
+
+    /**
+    * \brief Sets the number of messages each ring buffer can store, rounded up to a power of two
+    *
+    * Discards the messages in the ring buffers. Not thread safe, call it before
+    * the communication is started.
+    */
+    void SetRingBufferCapacity(unsigned int capacity);
+    unsigned int GetRingBufferCapacity() const;
+
+    QueueStatistics GetStatistics(QueueType queue) const;
+    void ResetStatistics();
+
   protected:
     IGTLMessageQueue();
     ~IGTLMessageQueue() override;
 
+    template <typename T>
+    class Queue;
+
   protected:
     /**
-    * \brief Mutex to take car of the queue
+    * \brief Mutex to take care of the latest message
     */
     itk::FastMutexLock::Pointer m_Mutex;
 
     /**
-    * \brief the queue that stores pointer to the inserted messages
+    * \brief the queues that store pointers to the inserted messages
     */
-    std::deque< igtl::MessageBase::Pointer > m_CommandQueue;
-    std::deque< igtl::ImageMessage::Pointer > m_Image2dQueue;
-    std::deque< igtl::ImageMessage::Pointer > m_Image3dQueue;
-    std::deque< igtl::TransformMessage::Pointer > m_TransformQueue;
-    std::deque< igtl::TrackingDataMessage::Pointer > m_TrackingDataQueue;
-    std::deque< igtl::StringMessage::Pointer > m_StringQueue;
-    std::deque< igtl::MessageBase::Pointer > m_MiscQueue;
+    std::unique_ptr< Queue<igtl::MessageBase::Pointer> > m_CommandQueue;
+    std::unique_ptr< Queue<igtl::ImageMessage::Pointer> > m_Image2dQueue;
+    std::unique_ptr< Queue<igtl::ImageMessage::Pointer> > m_Image3dQueue;
+    std::unique_ptr< Queue<igtl::TransformMessage::Pointer> > m_TransformQueue;
+    std::unique_ptr< Queue<igtl::TrackingDataMessage::Pointer> > m_TrackingDataQueue;
+    std::unique_ptr< Queue<igtl::StringMessage::Pointer> > m_StringQueue;
+    std::unique_ptr< Queue<igtl::MessageBase::Pointer> > m_MiscQueue;
 
-    std::deque< mitk::IGTLMessage::Pointer > m_SendQueue;
+    std::unique_ptr< Queue<mitk::IGTLMessage::Pointer> > m_SendQueue;
 
     igtl::MessageBase::Pointer m_Latest_Message;
 
     /**
     * \brief defines the kind of buffering
     */
-    BufferingType m_BufferingType;
+    std::atomic<BufferingType> m_BufferingType;
+
+    unsigned int m_RingBufferCapacity;
   };
 }
 
@@ -0,0 +1,161 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkIGTLRingBuffer_h
+#define mitkIGTLRingBuffer_h
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace mitk {
+  /**
+  * \class IGTLRingBuffer
+  * \brief Bounded, lock-free queue with slots that are allocated once.
+  *
+  * Any number of threads may push and pop concurrently; no call blocks or
+  * allocates memory. Each slot carries a sequence number that tells
+  * producers and consumers whether the slot is free or holds a value of the
+  * current round, so a value is written and read by exactly one thread.
+  *
+  * Values are moved in and out of the slots. A popped slot is reset to a
+  * default constructed value, so smart pointers do not keep messages alive
+  * longer than necessary.
+  *
+  * \ingroup OpenIGTLink
+  */
+  template <typename T>
+  class IGTLRingBuffer
+  {
+  public:
+    /**
+    * \param capacity maximum number of values, rounded up to a power of two
+    */
+    explicit IGTLRingBuffer(std::size_t capacity)
+      : m_Capacity(RoundUpToPowerOfTwo(capacity)),
+        m_Slots(new Slot[m_Capacity]),
+        m_PushPosition(0),
+        m_PopPosition(0)
+    {
+      for (std::size_t i = 0; i < m_Capacity; ++i)
+        m_Slots[i].m_Sequence.store(i, std::memory_order_relaxed);
+    }
+
+    IGTLRingBuffer(const IGTLRingBuffer &) = delete;
+    IGTLRingBuffer &operator=(const IGTLRingBuffer &) = delete;
+
+    /**
+    * \brief Appends value, unless the buffer is full
+    * \return false if the buffer is full
+    */
+    bool Push(T value)
+    {
+      std::size_t position = m_PushPosition.load(std::memory_order_relaxed);
+      Slot *slot;
+      for (;;)
+      {
+        slot = &m_Slots[position & (m_Capacity - 1)];
+        const std::size_t sequence = slot->m_Sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+        if (difference == 0)
+        {
+          if (m_PushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            break;
+        }
+        else if (difference < 0)
+        {
+          return false;
+        }
+        else
+        {
+          position = m_PushPosition.load(std::memory_order_relaxed);
+        }
+      }
+
+      slot->m_Value = std::move(value);
+      slot->m_Sequence.store(position + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+    * \brief Removes the oldest value
+    * \return false if the buffer is empty
+    */
+    bool Pop(T &value)
+    {
+      std::size_t position = m_PopPosition.load(std::memory_order_relaxed);
+      Slot *slot;
+      for (;;)
+      {
+        slot = &m_Slots[position & (m_Capacity - 1)];
+        const std::size_t sequence = slot->m_Sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+        if (difference == 0)
+        {
+          if (m_PopPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            break;
+        }
+        else if (difference < 0)
+        {
+          return false;
+        }
+        else
+        {
+          position = m_PopPosition.load(std::memory_order_relaxed);
+        }
+      }
+
+      value = std::move(slot->m_Value);
+      slot->m_Value = T();
+      slot->m_Sequence.store(position + m_Capacity, std::memory_order_release);
+      return true;
+    }
+
+    /**
+    * \brief Number of values in the buffer; only a snapshot while other threads push or pop
+    */
+    std::size_t GetSize() const
+    {
+      const std::size_t popPosition = m_PopPosition.load(std::memory_order_relaxed);
+      const std::size_t pushPosition = m_PushPosition.load(std::memory_order_relaxed);
+      return pushPosition > popPosition ? pushPosition - popPosition : 0;
+    }
+
+    std::size_t GetCapacity() const { return m_Capacity; }
+
+  private:
+    struct Slot
+    {
+      std::atomic<std::size_t> m_Sequence;
+      T m_Value;
+    };
+
+    static std::size_t RoundUpToPowerOfTwo(std::size_t value)
+    {
+      std::size_t result = 1;
+      while (result < value)
+        result <<= 1;
+      return result;
+    }
+
+    const std::size_t m_Capacity;
+    std::unique_ptr<Slot[]> m_Slots;
+
+    // keeps the positions on separate cache lines, so producers and consumers do not invalidate each other's
+    std::atomic<std::size_t> m_PushPosition;
+    char m_Padding[64];
+    std::atomic<std::size_t> m_PopPosition;
+  };
+}
+
+#endif
@@ -27,7 +27,9 @@ namespace mitk
    * It also provides a method for interpolation of the AIF source array to a specified Timegrid that differs from
    * AIFTimeGrid. The AIF must be set with an itk::Array. If no AIFTimeGrid is specified with the Setter, it is assumed
    * that the AIFTimeGrid is the same as the ModelTimegrid (e.g. AIF is derived from data set to be fitted). In this
-   * case, AIFvalues must have the same length as ModelTimeGrid, otherwise an exception is generated*/
+   * case, AIFvalues must have the same length as ModelTimeGrid, otherwise an exception is generated.
+   * The AIF interpolated to the model time grid is computed once whenever the AIF, the AIF time grid or the
+   * model time grid is set, so evaluating the model during a fit does not interpolate the AIF again.*/
   class MITKPHARMACOKINETICS_EXPORT AIFBasedModelBase : public mitk::ModelBase
   {
   public:
@@ -54,8 +56,11 @@ namespace mitk
     itkGetConstReferenceMacro(AterialInputFunctionValues, AterialInputFunctionType);
     itkGetConstReferenceMacro(AterialInputFunctionTimeGrid, TimeGridType);
 
-    itkSetMacro(AterialInputFunctionValues, AterialInputFunctionType);
-    itkSetMacro(AterialInputFunctionTimeGrid, TimeGridType);
+    void SetAterialInputFunctionValues(const AterialInputFunctionType& values);
+    void SetAterialInputFunctionTimeGrid(const TimeGridType& grid);
+
+    /** Reimplementation that also updates the AIF interpolated to the new time grid.*/
+    void SetTimeGrid(const TimeGridType& grid) override;
 
     std::string GetXAxisName() const override;
 
@@ -71,8 +76,9 @@ namespace mitk
 
     /** Returns the Aterial Input function matching currentTimeGrid
      *  The original values are interpolated to the passed TimeGrid
-     * if currentTimeGrid.Size() = 0 , the Original AIF will be returned*/
-    const AterialInputFunctionType GetAterialInputFunction(TimeGridType currentTimeGrid) const;
+     * if currentTimeGrid.Size() = 0 , the Original AIF will be returned.
+     * If currentTimeGrid is the time grid of the model, the precomputed interpolation is returned.*/
+    const AterialInputFunctionType GetAterialInputFunction(const TimeGridType& currentTimeGrid) const;
 
     ParameterNamesType GetStaticParameterNames() const override;
     ParametersSizeType GetNumberOfStaticParameters() const override;
@@ -97,9 +103,18 @@ namespace mitk
     StaticParameterValuesType GetStaticParameterValue(const ParameterNameType& name) const
     override;
 
+    /** Interpolates the AIF to the model time grid and stores it in m_InterpolatedAterialInputFunction.
+     * Called by the setters of the AIF and the time grids; the cache stays invalid as long as the
+     * settings are incomplete or inconsistent. Derived models can override it to precompute further
+     * AIF dependent data; they have to call the implementation of the superclass.*/
+    virtual void UpdateInterpolatedAterialInputFunction();
+
     TimeGridType m_AterialInputFunctionTimeGrid;
     AterialInputFunctionType m_AterialInputFunctionValues;
 
+    AterialInputFunctionType m_InterpolatedAterialInputFunction;
+    bool m_InterpolatedAterialInputFunctionIsValid;
+
 
   private:
 
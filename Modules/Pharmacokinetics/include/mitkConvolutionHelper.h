@@ -128,6 +128,39 @@ inline    itk::Array<double> wrap1d(itk::Array<double> kernel)
   }
 
 
+  inline void convoluteAIFWithExponentialAndDerivative(const mitk::ModelBase::TimeGridType& timeGrid,
+                                                      const mitk::AIFBasedModelBase::AterialInputFunctionType& aif,
+                                                      double lambda, itk::Array<double>& convolution,
+                                                      itk::Array<double>& derivative)
+  {
+      /** @brief Iterative formula of convoluteAIFWithExponential that additionally computes the derivative of the
+       * convolution with respect to lambda by deriving every step of the recursion.
+       **/
+      convolution.SetSize(timeGrid.GetSize());
+      convolution.fill(0.0);
+      derivative.SetSize(timeGrid.GetSize());
+      derivative.fill(0.0);
+
+      for(unsigned int i = 0; i< (timeGrid.GetSize()-1); ++i)
+      {
+          double dt = timeGrid(i+1) - timeGrid(i);
+          double m = (aif(i+1) - aif(i))/dt;
+          double edt = exp(-lambda *dt);
+          double a = aif(i) - m*timeGrid(i);
+          double b = (lambda * timeGrid(i+1) - 1) - edt*(lambda*timeGrid(i) -1);
+
+          convolution(i+1) = edt * convolution(i)
+                           + a/lambda * (1 - edt )
+                           + m/(lambda * lambda) * b;
+
+          derivative(i+1) = edt * (derivative(i) - dt * convolution(i))
+                          + a * (dt * edt / lambda - (1 - edt) / (lambda * lambda))
+                          + m * ((timeGrid(i+1) + edt * (dt * (lambda * timeGrid(i) - 1) - timeGrid(i))) / (lambda * lambda)
+                                 - 2 * b / (lambda * lambda * lambda));
+      }
+  }
+
+
   inline itk::Array<double> convoluteAIFWithConstant(mitk::ModelBase::TimeGridType timeGrid, mitk::AIFBasedModelBase::AterialInputFunctionType aif, double constant)
   {
       /** @brief Iterative Formula to Convolve aif(t) with a constant value by linear interpolation of the Aif between sampling points
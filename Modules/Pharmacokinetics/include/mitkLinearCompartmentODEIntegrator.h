@@ -0,0 +1,104 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKLINEARCOMPARTMENTODEINTEGRATOR_H
+#define MITKLINEARCOMPARTMENTODEINTEGRATOR_H
+
+#include <array>
+#include <vector>
+
+#include "itkArray.h"
+#include "itkArray2D.h"
+
+#include "mitkModelBase.h"
+#include "MitkPharmacokineticsExports.h"
+
+namespace mitk
+{
+  /** @class LinearCompartmentODEIntegrator
+   * @brief Integrates the mass balance equations of linear two compartment models
+   *
+   * dx/dt = A * x + b * Ca(t),  x(0) = 0
+   *
+   * where x are the concentrations of the two compartments, A and b are defined by the model parameters
+   * and Ca(t) is the aterial input function. The integration uses fixed steps of the 5th order Cash-Karp
+   * Runge-Kutta scheme, like the former stepwise integration with boost odeint runge_kutta_cash_karp54.
+   *
+   * Everything that does not depend on the model parameters (the AIF at every stage time of every step and
+   * the interpolation of the steps to the time grid of the model) is computed once by Initialize(). So a
+   * model evaluation is a tight loop without searching or allocating per step.
+   *
+   * IntegrateWithSensitivities() additionally integrates the sensitivity equations
+   *
+   * dS_j/dt = A * S_j + dA/dp_j * x + db/dp_j * Ca(t),  S_j(0) = 0
+   *
+   * of every parameter p_j in lockstep with x, so S_j = dx/dp_j can be used as analytic Jacobian of the model.
+   * The states of all systems are stored contiguously and share the stage values of the AIF.
+   */
+  class MITKPHARMACOKINETICS_EXPORT LinearCompartmentODEIntegrator
+  {
+  public:
+    typedef ModelBase::TimeGridType TimeGridType;
+    typedef itk::Array<double> ConcentrationCurveType;
+    typedef itk::Array2D<double> ConcentrationDerivativeType;
+
+    /** Row major 2x2 matrix A*/
+    typedef std::array<double, 4> SystemMatrixType;
+    /** Input vector b*/
+    typedef std::array<double, 2> InputVectorType;
+
+    LinearCompartmentODEIntegrator();
+
+    /** Precomputes the AIF for all integration steps.
+     * @param timeGrid Time grid of the model. The integration starts at time 0 and covers the whole grid.
+     * @param aif AIF on timeGrid. For times after the grid the last value is used.
+     * @param stepSize Step size of the integration.
+     * @param endTime Time until which the integration runs at least.*/
+    void Initialize(const TimeGridType& timeGrid, const ConcentrationCurveType& aif, double stepSize, double endTime);
+
+    void Reset();
+
+    bool IsInitialized() const;
+
+    /** Integrates the system and returns the concentrations of both compartments on the time grid.*/
+    void Integrate(const SystemMatrixType& a, const InputVectorType& b, ConcentrationCurveType& c1,
+                   ConcentrationCurveType& c2) const;
+
+    /** Integrates the system and its sensitivities. dA and db contain the derivatives of A and b for every
+     * parameter. dc1[j][i] and dc2[j][i] are the derivatives of the concentrations at time point i with respect
+     * to parameter j.*/
+    void IntegrateWithSensitivities(const SystemMatrixType& a, const InputVectorType& b,
+                                    const std::vector<SystemMatrixType>& dA, const std::vector<InputVectorType>& db,
+                                    ConcentrationCurveType& c1, ConcentrationCurveType& c2,
+                                    ConcentrationDerivativeType& dc1, ConcentrationDerivativeType& dc2) const;
+
+  private:
+    /** Integrates 1 + dA.size() systems in lockstep. result[(system * 2 + compartment) * gridSize + i]*/
+    void IntegrateSystems(const SystemMatrixType& a, const InputVectorType& b,
+                          const std::vector<SystemMatrixType>& dA, const std::vector<InputVectorType>& db,
+                          std::vector<double>& result) const;
+
+    double m_StepSize;
+    std::size_t m_NumberOfSteps;
+
+    /** AIF at the stage times of every step*/
+    std::vector<double> m_StageAIF;
+
+    /** Linear interpolation of the integration steps to the time grid: index of the step after the time point
+     * and the weights of the steps before and after.*/
+    std::vector<std::size_t> m_NextStep;
+    std::vector<double> m_WeightLast;
+    std::vector<double> m_WeightNext;
+  };
+}
+
+#endif // MITKLINEARCOMPARTMENTODEINTEGRATOR_H
@@ -14,6 +14,7 @@ found in the LICENSE file.
 #define MITKNUMERICTWOCOMPARTMENTEXCHANGEMODEL_H
 
 #include "mitkAIFBasedModelBase.h"
+#include "mitkLinearCompartmentODEIntegrator.h"
 #include "MitkPharmacokineticsExports.h"
 
 
@@ -27,8 +28,8 @@ namespace mitk
    * ve * dCi(t)/dt = PS * (Cp(t) - Ci(t))
    *
    * with concentration curve Cp(t) of the Blood Plasma p and Ce(t) of the Extracellular Extravascular Space(EES)(interstitial volume). CA(t) is the aterial concentration, i.e. the AIF
-   * Cp(t) and Ce(t) are found numerical via Runge-Kutta methode, implemented in Boosts numeric library ODEINT. Here we use a runge_kutta_cash_karp54 stepper with
-   * adaptive step size and error controll.
+   * Cp(t) and Ce(t) are found numerical via Runge-Kutta methode (Cash-Karp scheme with the fixed step size ODEINTStepSize), implemented by
+   * LinearCompartmentODEIntegrator. The integrator also provides the sensitivities of Cp(t) and Ce(t), so the model has an analytic derivative.
    * From the resulting curves Cp(t) and Ce(t) the measured concentration Ctotal(t) is found vial
    *
    * Ctotal(t) = vp * Cp(t) + ve * Ce(t)
@@ -81,7 +82,7 @@ namespace mitk
     std::string GetModelType() const override;
 
     itkGetConstReferenceMacro(ODEINTStepSize, double);
-    itkSetMacro(ODEINTStepSize, double);
+    void SetODEINTStepSize(double stepSize);
 
 
     ParameterNamesType GetParameterNames() const override;
@@ -92,6 +93,8 @@ namespace mitk
     ParameterNamesType GetStaticParameterNames() const override;
     ParametersSizeType GetNumberOfStaticParameters() const override;
 
+    bool HasAnalyticDerivative() const override;
+
 
   protected:
     NumericTwoCompartmentExchangeModel();
@@ -105,14 +108,23 @@ namespace mitk
 
     ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
 
+    void ComputeModelDerivative(const ParametersType& parameters, ModelResultType& signal,
+                                ModelDerivativeType& derivative) const override;
+
+    /** Also precomputes the AIF for the integration steps.*/
+    void UpdateInterpolatedAterialInputFunction() override;
+
     void SetStaticParameter(const ParameterNameType& name, const StaticParameterValuesType& values) override;
     StaticParameterValuesType GetStaticParameterValue(const ParameterNameType& name) const override;
 
     void PrintSelf(std::ostream& os, ::itk::Indent indent) const override;
 
   private:
+    /** Returns the system matrix and input vector of the mass balance equations for the given parameters.*/
+    void GetSystem(const ParametersType& parameters, LinearCompartmentODEIntegrator::SystemMatrixType& a,
+                   LinearCompartmentODEIntegrator::InputVectorType& b) const;
 
-
+    void CheckIntegrator() const;
 
     //No copy constructor allowed
     NumericTwoCompartmentExchangeModel(const Self& source);
@@ -120,6 +132,8 @@ namespace mitk
 
     double m_ODEINTStepSize;
 
+    LinearCompartmentODEIntegrator m_Integrator;
+
 
 
   };
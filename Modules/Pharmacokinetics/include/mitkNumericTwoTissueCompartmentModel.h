@@ -14,6 +14,7 @@ found in the LICENSE file.
 #define MITKNUMERICTWOTISSUECOMPARTMENTMODEL_H
 
 #include "mitkAIFBasedModelBase.h"
+#include "mitkLinearCompartmentODEIntegrator.h"
 #include "MitkPharmacokineticsExports.h"
 
 
@@ -70,6 +71,8 @@ namespace mitk
 
     ParamterUnitMapType GetParameterUnits() const override;
 
+    bool HasAnalyticDerivative() const override;
+
   protected:
     NumericTwoTissueCompartmentModel();
     ~NumericTwoTissueCompartmentModel() override;
@@ -82,15 +85,30 @@ namespace mitk
 
     ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
 
+    void ComputeModelDerivative(const ParametersType& parameters, ModelResultType& signal,
+                                ModelDerivativeType& derivative) const override;
+
+    /** Also precomputes the AIF for the integration steps.*/
+    void UpdateInterpolatedAterialInputFunction() override;
+
     void PrintSelf(std::ostream& os, ::itk::Indent indent) const override;
 
   private:
+    /** Returns the system matrix and input vector of the mass balance equations for the given parameters.*/
+    void GetSystem(const ParametersType& parameters, LinearCompartmentODEIntegrator::SystemMatrixType& a,
+                   LinearCompartmentODEIntegrator::InputVectorType& b) const;
 
+    void CheckIntegrator() const;
 
     //No copy constructor allowed
     NumericTwoTissueCompartmentModel(const Self& source);
     void operator=(const Self&);  //purposely not implemented
 
+    /** Step size of the numeric integration*/
+    static const double ODE_STEP_SIZE;
+
+    LinearCompartmentODEIntegrator m_Integrator;
+
   };
 }
 
@@ -72,6 +72,8 @@ namespace mitk
 
     ParamterUnitMapType GetDerivedParameterUnits() const override;
 
+    bool HasAnalyticDerivative() const override;
+
   protected:
     StandardToftsModel();
     ~StandardToftsModel() override;
@@ -84,6 +86,9 @@ namespace mitk
 
     ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
 
+    void ComputeModelDerivative(const ParametersType& parameters, ModelResultType& signal,
+                                ModelDerivativeType& derivative) const override;
+
     DerivedParameterMapType ComputeDerivedParameters(const mitk::ModelBase::ParametersType&
         parameters) const override;
 
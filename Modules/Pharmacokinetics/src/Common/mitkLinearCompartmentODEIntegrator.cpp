@@ -0,0 +1,299 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkLinearCompartmentODEIntegrator.h"
+
+#include "itkMacro.h"
+#include "itkNumericTraits.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+  /** Butcher tableau of the Cash-Karp Runge-Kutta scheme (5th order solution), identical to
+   * boost::numeric::odeint::runge_kutta_cash_karp54.*/
+  const unsigned int NUMBER_OF_STAGES = 6;
+
+  const double STAGE_TIMES[NUMBER_OF_STAGES] = { 0.0, 1.0 / 5.0, 3.0 / 10.0, 3.0 / 5.0, 1.0, 7.0 / 8.0 };
+
+  const double STAGE_COEFFICIENTS[NUMBER_OF_STAGES][NUMBER_OF_STAGES - 1] = {
+    { 0.0, 0.0, 0.0, 0.0, 0.0 },
+    { 1.0 / 5.0, 0.0, 0.0, 0.0, 0.0 },
+    { 3.0 / 40.0, 9.0 / 40.0, 0.0, 0.0, 0.0 },
+    { 3.0 / 10.0, -9.0 / 10.0, 6.0 / 5.0, 0.0, 0.0 },
+    { -11.0 / 54.0, 5.0 / 2.0, -70.0 / 27.0, 35.0 / 27.0, 0.0 },
+    { 1631.0 / 55296.0, 175.0 / 512.0, 575.0 / 13824.0, 44275.0 / 110592.0, 253.0 / 4096.0 } };
+
+  const double SOLUTION_WEIGHTS[NUMBER_OF_STAGES] = {
+    37.0 / 378.0, 0.0, 250.0 / 621.0, 125.0 / 594.0, 0.0, 512.0 / 1771.0 };
+
+  /** Linear interpolation of the AIF like TwoCompartmentExchangeModelDifferentialEquations::InterpolateAIFToCurrentTimeStep,
+   * but with a binary search. After the last grid point the last value is used.*/
+  double InterpolateAIF(const std::vector<double>& grid, const std::vector<double>& aif, double t)
+  {
+    const std::size_t next = std::lower_bound(grid.begin(), grid.end(), t) - grid.begin();
+
+    if (next == grid.size())
+    {
+      return aif.back();
+    }
+
+    double lastValue = aif[0];
+    double lastTime = std::numeric_limits<double>::min();
+    if (next > 0)
+    {
+      lastValue = aif[next - 1];
+      lastTime = grid[next - 1];
+    }
+
+    const double weightLast = 1 - (t - lastTime) / (grid[next] - lastTime);
+    const double weightNext = 1 - (grid[next] - t) / (grid[next] - lastTime);
+
+    return weightLast * lastValue + weightNext * aif[next];
+  }
+}
+
+mitk::LinearCompartmentODEIntegrator::LinearCompartmentODEIntegrator() : m_StepSize(0.0), m_NumberOfSteps(0)
+{
+}
+
+void mitk::LinearCompartmentODEIntegrator::Initialize(const TimeGridType& timeGrid,
+                                                      const ConcentrationCurveType& aif,
+                                                      double stepSize,
+                                                      double endTime)
+{
+  const unsigned int gridSize = timeGrid.GetSize();
+
+  if (gridSize < 2)
+  {
+    itkGenericExceptionMacro("Cannot initialize ODE integration. Time grid needs at least 2 time points.");
+  }
+  if (aif.GetSize() != gridSize)
+  {
+    itkGenericExceptionMacro("Cannot initialize ODE integration. Size of AIF (" << aif.GetSize()
+                             << ") does not match size of the time grid (" << gridSize << ").");
+  }
+  if (!(stepSize > 0.0))
+  {
+    itkGenericExceptionMacro("Cannot initialize ODE integration. Invalid step size: " << stepSize);
+  }
+
+  this->Reset();
+
+  // AIF and time grid are extended by one time point holding the last value (like the former odeint based models)
+  std::vector<double> grid(timeGrid.begin(), timeGrid.end());
+  grid.push_back(timeGrid[gridSize - 1] + (timeGrid[gridSize - 1] - timeGrid[gridSize - 2]));
+  std::vector<double> aifValues(aif.begin(), aif.end());
+  aifValues.push_back(aif[gridSize - 1]);
+
+  // the times are accumulated like in the former stepping loops to get the identical steps
+  std::vector<double> stepTimes;
+  for (double t = 0.0; t < endTime; t += stepSize)
+  {
+    stepTimes.push_back(t);
+  }
+
+  m_StageAIF.resize(stepTimes.size() * NUMBER_OF_STAGES);
+  for (std::size_t step = 0; step < stepTimes.size(); ++step)
+  {
+    for (unsigned int stage = 0; stage < NUMBER_OF_STAGES; ++stage)
+    {
+      m_StageAIF[step * NUMBER_OF_STAGES + stage] =
+        InterpolateAIF(grid, aifValues, stepTimes[step] + STAGE_TIMES[stage] * stepSize);
+    }
+  }
+
+  // The state after the step from t to t+dt is associated with t (like the former recording of the steps)
+  // and interpolated to the time grid as done by mitk::InterpolateSignalToNewTimeGrid.
+  m_NextStep.resize(gridSize);
+  m_WeightLast.resize(gridSize);
+  m_WeightNext.resize(gridSize);
+
+  std::size_t next = 0;
+  double lastTime = itk::NumericTraits<double>::NonpositiveMin();
+  for (unsigned int i = 0; i < gridSize; ++i)
+  {
+    while (next < stepTimes.size() && timeGrid[i] > stepTimes[next])
+    {
+      lastTime = stepTimes[next];
+      ++next;
+    }
+
+    if (next == stepTimes.size())
+    {
+      itkGenericExceptionMacro("Cannot initialize ODE integration. Integration until " << endTime
+                               << " does not cover the time grid.");
+    }
+
+    m_NextStep[i] = next;
+    m_WeightLast[i] = 1 - (timeGrid[i] - lastTime) / (stepTimes[next] - lastTime);
+    m_WeightNext[i] = 1 - (stepTimes[next] - timeGrid[i]) / (stepTimes[next] - lastTime);
+  }
+
+  m_StepSize = stepSize;
+  m_NumberOfSteps = stepTimes.size();
+}
+
+void mitk::LinearCompartmentODEIntegrator::Reset()
+{
+  m_StepSize = 0.0;
+  m_NumberOfSteps = 0;
+  m_StageAIF.clear();
+  m_NextStep.clear();
+  m_WeightLast.clear();
+  m_WeightNext.clear();
+}
+
+bool mitk::LinearCompartmentODEIntegrator::IsInitialized() const
+{
+  return m_NumberOfSteps > 0;
+}
+
+void mitk::LinearCompartmentODEIntegrator::Integrate(const SystemMatrixType& a,
+                                                     const InputVectorType& b,
+                                                     ConcentrationCurveType& c1,
+                                                     ConcentrationCurveType& c2) const
+{
+  const std::size_t gridSize = m_NextStep.size();
+
+  std::vector<double> result;
+  this->IntegrateSystems(a, b, std::vector<SystemMatrixType>(), std::vector<InputVectorType>(), result);
+
+  c1.SetSize(gridSize);
+  c2.SetSize(gridSize);
+  std::copy(result.begin(), result.begin() + gridSize, c1.begin());
+  std::copy(result.begin() + gridSize, result.begin() + 2 * gridSize, c2.begin());
+}
+
+void mitk::LinearCompartmentODEIntegrator::IntegrateWithSensitivities(const SystemMatrixType& a,
+                                                                      const InputVectorType& b,
+                                                                      const std::vector<SystemMatrixType>& dA,
+                                                                      const std::vector<InputVectorType>& db,
+                                                                      ConcentrationCurveType& c1,
+                                                                      ConcentrationCurveType& c2,
+                                                                      ConcentrationDerivativeType& dc1,
+                                                                      ConcentrationDerivativeType& dc2) const
+{
+  if (dA.size() != db.size())
+  {
+    itkGenericExceptionMacro("Cannot integrate sensitivities. Number of derivatives of A (" << dA.size()
+                             << ") and b (" << db.size() << ") differ.");
+  }
+
+  const std::size_t gridSize = m_NextStep.size();
+  const std::size_t numberOfParameters = dA.size();
+
+  std::vector<double> result;
+  this->IntegrateSystems(a, b, dA, db, result);
+
+  c1.SetSize(gridSize);
+  c2.SetSize(gridSize);
+  dc1.SetSize(numberOfParameters, gridSize);
+  dc2.SetSize(numberOfParameters, gridSize);
+
+  std::copy(result.begin(), result.begin() + gridSize, c1.begin());
+  std::copy(result.begin() + gridSize, result.begin() + 2 * gridSize, c2.begin());
+  for (std::size_t j = 0; j < numberOfParameters; ++j)
+  {
+    const auto sensitivity = result.begin() + 2 * (j + 1) * gridSize;
+    std::copy(sensitivity, sensitivity + gridSize, dc1[j]);
+    std::copy(sensitivity + gridSize, sensitivity + 2 * gridSize, dc2[j]);
+  }
+}
+
+void mitk::LinearCompartmentODEIntegrator::IntegrateSystems(const SystemMatrixType& a,
+                                                            const InputVectorType& b,
+                                                            const std::vector<SystemMatrixType>& dA,
+                                                            const std::vector<InputVectorType>& db,
+                                                            std::vector<double>& result) const
+{
+  if (!this->IsInitialized())
+  {
+    itkGenericExceptionMacro("Cannot integrate ODE. Integrator is not initialized.");
+  }
+
+  const std::size_t gridSize = m_NextStep.size();
+  const std::size_t numberOfSystems = 1 + dA.size();
+  const std::size_t numberOfValues = 2 * numberOfSystems;
+  const double dt = m_StepSize;
+
+  result.assign(numberOfValues * gridSize, 0.0);
+
+  // state of all systems: x (values 0 and 1) followed by the sensitivities of every parameter
+  std::vector<double> state(numberOfValues, 0.0);
+  std::vector<double> lastState(numberOfValues, 0.0);
+  std::vector<double> stageState(numberOfValues);
+  std::vector<double> slopes(NUMBER_OF_STAGES * numberOfValues);
+
+  std::size_t gridPos = 0;
+  for (std::size_t step = 0; step < m_NumberOfSteps && gridPos < gridSize; ++step)
+  {
+    const double* stageAIF = &m_StageAIF[step * NUMBER_OF_STAGES];
+
+    for (unsigned int stage = 0; stage < NUMBER_OF_STAGES; ++stage)
+    {
+      std::copy(state.begin(), state.end(), stageState.begin());
+      for (unsigned int prevStage = 0; prevStage < stage; ++prevStage)
+      {
+        const double factor = dt * STAGE_COEFFICIENTS[stage][prevStage];
+        const double* prevSlopes = &slopes[prevStage * numberOfValues];
+        for (std::size_t v = 0; v < numberOfValues; ++v)
+        {
+          stageState[v] += factor * prevSlopes[v];
+        }
+      }
+
+      const double ca = stageAIF[stage];
+      double* stageSlopes = &slopes[stage * numberOfValues];
+
+      stageSlopes[0] = a[0] * stageState[0] + a[1] * stageState[1] + b[0] * ca;
+      stageSlopes[1] = a[2] * stageState[0] + a[3] * stageState[1] + b[1] * ca;
+
+      for (std::size_t j = 0; j < dA.size(); ++j)
+      {
+        const std::size_t pos = 2 * (j + 1);
+        const SystemMatrixType& derivA = dA[j];
+        const InputVectorType& derivB = db[j];
+
+        stageSlopes[pos] = a[0] * stageState[pos] + a[1] * stageState[pos + 1] + derivA[0] * stageState[0] +
+                           derivA[1] * stageState[1] + derivB[0] * ca;
+        stageSlopes[pos + 1] = a[2] * stageState[pos] + a[3] * stageState[pos + 1] + derivA[2] * stageState[0] +
+                               derivA[3] * stageState[1] + derivB[1] * ca;
+      }
+    }
+
+    std::copy(state.begin(), state.end(), lastState.begin());
+    for (unsigned int stage = 0; stage < NUMBER_OF_STAGES; ++stage)
+    {
+      if (SOLUTION_WEIGHTS[stage] != 0.0)
+      {
+        const double factor = dt * SOLUTION_WEIGHTS[stage];
+        const double* stageSlopes = &slopes[stage * numberOfValues];
+        for (std::size_t v = 0; v < numberOfValues; ++v)
+        {
+          state[v] += factor * stageSlopes[v];
+        }
+      }
+    }
+
+    // interpolate the time points of the grid that lie between the last and the current step
+    for (; gridPos < gridSize && m_NextStep[gridPos] == step; ++gridPos)
+    {
+      const std::vector<double>& last = step == 0 ? state : lastState;
+      for (std::size_t v = 0; v < numberOfValues; ++v)
+      {
+        result[v * gridSize + gridPos] = m_WeightLast[gridPos] * last[v] + m_WeightNext[gridPos] * state[v];
+      }
+    }
+  }
+}
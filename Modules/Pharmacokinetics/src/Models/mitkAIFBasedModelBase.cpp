@@ -46,7 +46,7 @@ std::string mitk::AIFBasedModelBase::GetYAxisUnit() const
   return "";
 }
 
-mitk::AIFBasedModelBase::AIFBasedModelBase()
+mitk::AIFBasedModelBase::AIFBasedModelBase() : m_InterpolatedAterialInputFunctionIsValid(false)
 {
 }
 
@@ -67,13 +67,74 @@ mitk::AIFBasedModelBase::GetCurrentAterialInputFunctionTimeGrid() const
   }
 };
 
+void mitk::AIFBasedModelBase::SetAterialInputFunctionValues(const AterialInputFunctionType& values)
+{
+  itkDebugMacro("setting AterialInputFunctionValues to " << values);
+
+  if (this->m_AterialInputFunctionValues != values)
+  {
+    this->m_AterialInputFunctionValues = values;
+    this->UpdateInterpolatedAterialInputFunction();
+    this->Modified();
+  }
+}
+
+void mitk::AIFBasedModelBase::SetAterialInputFunctionTimeGrid(const TimeGridType& grid)
+{
+  itkDebugMacro("setting AterialInputFunctionTimeGrid to " << grid);
+
+  if (this->m_AterialInputFunctionTimeGrid != grid)
+  {
+    this->m_AterialInputFunctionTimeGrid = grid;
+    this->UpdateInterpolatedAterialInputFunction();
+    this->Modified();
+  }
+}
+
+void mitk::AIFBasedModelBase::SetTimeGrid(const TimeGridType& grid)
+{
+  Superclass::SetTimeGrid(grid);
+  this->UpdateInterpolatedAterialInputFunction();
+}
+
+void mitk::AIFBasedModelBase::UpdateInterpolatedAterialInputFunction()
+{
+  m_InterpolatedAterialInputFunctionIsValid = false;
+  m_InterpolatedAterialInputFunction.SetSize(0);
+
+  if (m_TimeGrid.empty() || m_AterialInputFunctionValues.empty())
+  {
+    return;
+  }
+
+  if (m_AterialInputFunctionTimeGrid.empty())
+  {
+    if (m_AterialInputFunctionValues.GetSize() == m_TimeGrid.GetSize())
+    {
+      m_InterpolatedAterialInputFunction = m_AterialInputFunctionValues;
+      m_InterpolatedAterialInputFunctionIsValid = true;
+    }
+  }
+  else if (m_AterialInputFunctionValues.GetSize() == m_AterialInputFunctionTimeGrid.GetSize())
+  {
+    m_InterpolatedAterialInputFunction = mitk::InterpolateSignalToNewTimeGrid(m_AterialInputFunctionValues,
+      m_AterialInputFunctionTimeGrid, m_TimeGrid);
+    m_InterpolatedAterialInputFunctionIsValid = true;
+  }
+}
+
 const mitk::AIFBasedModelBase::AterialInputFunctionType
-mitk::AIFBasedModelBase::GetAterialInputFunction(TimeGridType CurrentTimeGrid) const
+mitk::AIFBasedModelBase::GetAterialInputFunction(const TimeGridType& CurrentTimeGrid) const
 {
   if (CurrentTimeGrid.GetSize() == 0)
   {
     return this->m_AterialInputFunctionValues;
   }
+  else if (m_InterpolatedAterialInputFunctionIsValid &&
+           (&CurrentTimeGrid == &m_TimeGrid || CurrentTimeGrid == m_TimeGrid))
+  {
+    return this->m_InterpolatedAterialInputFunction;
+  }
   else
   {
     return mitk::InterpolateSignalToNewTimeGrid(m_AterialInputFunctionValues,
@@ -12,7 +12,6 @@ found in the LICENSE file.
 
 #include "mitkExtendedToftsModel.h"
 #include "mitkConvolutionHelper.h"
-#include <vnl/algo/vnl_fft_1d.h>
 #include <fstream>
 
 const std::string mitk::ExtendedToftsModel::MODEL_DISPLAY_NAME = "Extended Tofts Model";
@@ -150,6 +149,49 @@ mitk::ExtendedToftsModel::ModelResultType mitk::ExtendedToftsModel::ComputeModel
 }
 
 
+bool mitk::ExtendedToftsModel::HasAnalyticDerivative() const
+{
+  return true;
+};
+
+void mitk::ExtendedToftsModel::ComputeModelDerivative(const ParametersType& parameters,
+    ModelResultType& signal, ModelDerivativeType& derivative) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  const AterialInputFunctionType aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+  unsigned int timeSteps = this->m_TimeGrid.GetSize();
+
+  //Model Parameters
+  double ktrans = parameters[POSITION_PARAMETER_Ktrans] / 6000.0;
+  double     ve = parameters[POSITION_PARAMETER_ve];
+  double     vp = parameters[POSITION_PARAMETER_vp];
+
+  double lambda =  ktrans / ve;
+
+  mitk::ModelBase::ModelResultType convolution;
+  mitk::ModelBase::ModelResultType convolutionDerivative;
+  mitk::convoluteAIFWithExponentialAndDerivative(this->m_TimeGrid, aterialInputFunction, lambda,
+      convolution, convolutionDerivative);
+
+  signal.SetSize(timeSteps);
+  derivative.SetSize(NUMBER_OF_PARAMETERS, timeSteps);
+
+  //lambda depends on ktrans and ve: d lambda/d ktrans = 1/ve, d lambda/d ve = -lambda/ve
+  for (unsigned int i = 0; i < timeSteps; ++i)
+  {
+    signal[i] = aterialInputFunction[i] * vp + ktrans * convolution[i];
+    derivative[POSITION_PARAMETER_Ktrans][i] = (convolution[i] + lambda * convolutionDerivative[i]) / 6000.0;
+    derivative[POSITION_PARAMETER_ve][i] = -ktrans * lambda / ve * convolutionDerivative[i];
+    derivative[POSITION_PARAMETER_vp][i] = aterialInputFunction[i];
+  }
+};
+
+
 mitk::ModelBase::DerivedParameterMapType mitk::ExtendedToftsModel::ComputeDerivedParameters(
   const mitk::ModelBase::ParametersType& parameters) const
 {
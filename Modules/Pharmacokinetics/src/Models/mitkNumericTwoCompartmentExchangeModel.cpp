@@ -13,10 +13,6 @@ found in the LICENSE file.
 #include "mitkNumericTwoCompartmentExchangeModel.h"
 #include "mitkAIFParametrizerHelper.h"
 #include "mitkTimeGridHelper.h"
-#include "mitkTwoCompartmentExchangeModelDifferentialEquations.h"
-#include <vnl/algo/vnl_fft_1d.h>
-#include <boost/numeric/odeint.hpp>
-#include <fstream>
 
 const std::string mitk::NumericTwoCompartmentExchangeModel::MODEL_DISPLAY_NAME =
   "Numeric Two Compartment Exchange Model";
@@ -52,7 +48,7 @@ std::string mitk::NumericTwoCompartmentExchangeModel::GetModelType() const
 };
 
 
-mitk::NumericTwoCompartmentExchangeModel::NumericTwoCompartmentExchangeModel()
+mitk::NumericTwoCompartmentExchangeModel::NumericTwoCompartmentExchangeModel() : m_ODEINTStepSize(0.05)
 {
 
 }
@@ -159,109 +155,141 @@ mitk::NumericTwoCompartmentExchangeModel::GetParameterUnits() const
   return result;
 };
 
-mitk::NumericTwoCompartmentExchangeModel::ModelResultType
-mitk::NumericTwoCompartmentExchangeModel::ComputeModelfunction(const ParametersType& parameters)
-const
+void mitk::NumericTwoCompartmentExchangeModel::SetODEINTStepSize(double stepSize)
 {
-  typedef itk::Array<double> ConcentrationCurveType;
-  typedef std::vector<double> ConcentrationVectorType;
-
-  if (this->m_TimeGrid.GetSize() == 0)
+  if (this->m_ODEINTStepSize != stepSize)
   {
-    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+    this->m_ODEINTStepSize = stepSize;
+    this->UpdateInterpolatedAterialInputFunction();
+    this->Modified();
   }
+}
 
-  AterialInputFunctionType aterialInputFunction;
-  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
-
-  unsigned int timeSteps = this->m_TimeGrid.GetSize();
+void mitk::NumericTwoCompartmentExchangeModel::UpdateInterpolatedAterialInputFunction()
+{
+  Superclass::UpdateInterpolatedAterialInputFunction();
 
-  /** @brief Boost::numeric::odeint works with type std::vector<double> thus, aif and grid are converted to ModelParameters( of type std::vector)
-   */
-  mitk::TwoCompartmentExchangeModelDifferentialEquations::AIFType aif = mitk::convertArrayToParameter(
-        aterialInputFunction);
-  mitk::TwoCompartmentExchangeModelDifferentialEquations::AIFType grid =
-    mitk::convertArrayToParameter(m_TimeGrid);
+  m_Integrator.Reset();
 
-  mitk::TwoCompartmentExchangeModelDifferentialEquations::AIFType aifODE = aif;
-  aifODE.push_back(aif[timeSteps - 1]);
-  mitk::TwoCompartmentExchangeModelDifferentialEquations::AIFType gridODE = grid;
-  gridODE.push_back(grid[timeSteps - 1] + (grid[timeSteps - 1] - grid[timeSteps - 2]));
+  if (m_InterpolatedAterialInputFunctionIsValid && this->m_TimeGrid.GetSize() > 1 && m_ODEINTStepSize > 0.0)
+  {
+    // The former implementation stepped until the last time point - 2*dt and extrapolated the remaining
+    // time points. The integration now covers the whole time grid; up to that point the steps are identical.
+    const double endTime = this->m_TimeGrid[this->m_TimeGrid.GetSize() - 1] + 2 * m_ODEINTStepSize;
+    m_Integrator.Initialize(this->m_TimeGrid, m_InterpolatedAterialInputFunction, m_ODEINTStepSize, endTime);
+  }
+}
 
+void mitk::NumericTwoCompartmentExchangeModel::CheckIntegrator() const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
 
+  if (!m_Integrator.IsInitialized())
+  {
+    itkExceptionMacro("Cannot Calculate Signal. AIF, AIF time grid or ODEINT step size (" << m_ODEINTStepSize
+                      << ") are not set or invalid.");
+  }
+}
 
-  //Model Parameters
+void mitk::NumericTwoCompartmentExchangeModel::GetSystem(const ParametersType& parameters,
+    LinearCompartmentODEIntegrator::SystemMatrixType& a, LinearCompartmentODEIntegrator::InputVectorType& b) const
+{
   double F = (double) parameters[POSITION_PARAMETER_F] / 6000.0;
   double PS  = (double) parameters[POSITION_PARAMETER_PS] / 6000.0;
   double ve = (double) parameters[POSITION_PARAMETER_ve];
   double vp = (double) parameters[POSITION_PARAMETER_vp];
 
+  /** @brief vp * dCp/dt = F * (Ca - Cp) - PS * (Cp - Ce); ve * dCe/dt = PS * (Cp - Ce)*/
+  a = { { -(F + PS) / vp, PS / vp, PS / ve, -PS / ve } };
+  b = { { F / vp, 0.0 } };
+}
 
-  /** @brief Initialize class TwoCompartmentExchangeModelDifferentialEquations defining the differential equations. AIF and Grid must be set so that at step t the aterial Concentration Ca(t) can be interpolated from AIF*/
-  mitk::TwoCompartmentExchangeModelDifferentialEquations ode;
-  ode.initialize(F, PS, ve, vp);
-  ode.setAIF(aifODE);
-  ode.setAIFTimeGrid(gridODE);
-
-  state_type x(2);
-  x[0] = 0.0;
-  x[1] = 0.0;
-  typedef boost::numeric::odeint::runge_kutta_cash_karp54<state_type> error_stepper_type;
-  //typedef boost::numeric::odeint::runge_kutta4< state_type > stepper_type;
-
-  /** @brief Results of odeeint x[0] and x[1]*/
-  ConcentrationVectorType Cp;
-  ConcentrationVectorType Ce;
-  ConcentrationVectorType odeTimeGrid;
+mitk::NumericTwoCompartmentExchangeModel::ModelResultType
+mitk::NumericTwoCompartmentExchangeModel::ComputeModelfunction(const ParametersType& parameters)
+const
+{
+  this->CheckIntegrator();
 
-  error_stepper_type stepper;
+  LinearCompartmentODEIntegrator::SystemMatrixType a;
+  LinearCompartmentODEIntegrator::InputVectorType b;
+  this->GetSystem(parameters, a, b);
 
+  LinearCompartmentODEIntegrator::ConcentrationCurveType C_Plasma;
+  LinearCompartmentODEIntegrator::ConcentrationCurveType C_EES;
+  m_Integrator.Integrate(a, b, C_Plasma, C_EES);
 
-  /** @brief Stepsize. Should be adapted by stepper (runge_kutta_cash_karp54) */
-//  const double dt = 0.05;
-   const double dt = this->m_ODEINTStepSize;
+  double ve = (double) parameters[POSITION_PARAMETER_ve];
+  double vp = (double) parameters[POSITION_PARAMETER_vp];
 
+  //Signal that will be returned by ComputeModelFunction
+  mitk::ModelBase::ModelResultType signal(this->m_TimeGrid.GetSize());
 
-  /** @brief perform Step t -> t+dt to calculate approximate value x(t+dt)*/
-  for (double t = 0.0; t < this->m_TimeGrid(this->m_TimeGrid.GetSize() - 1) - 2*dt; t += dt)
+  for (unsigned int i = 0; i < signal.GetSize(); ++i)
   {
-    stepper.do_step(ode, x, t, dt);
-    Cp.push_back(x[0]);
-    Ce.push_back(x[1]);
-    odeTimeGrid.push_back(t);
+    signal[i] = vp * C_Plasma[i] + ve * C_EES[i];
   }
 
-  /** @brief transfom result of Differential equations back to itk::Array and interpolate to m_TimeGrid (they are calculated on a different grid defined by stepsize of odeint)*/
-  ConcentrationCurveType plasmaConcentration = mitk::convertParameterToArray(Cp);
-  ConcentrationCurveType EESConcentration = mitk::convertParameterToArray(Ce);
-  ConcentrationCurveType rungeKuttaTimeGrid = mitk::convertParameterToArray(odeTimeGrid);
-
-  mitk::ModelBase::ModelResultType C_Plasma = mitk::InterpolateSignalToNewTimeGrid(plasmaConcentration, rungeKuttaTimeGrid, m_TimeGrid);
-  mitk::ModelBase::ModelResultType C_EES = mitk::InterpolateSignalToNewTimeGrid(EESConcentration, rungeKuttaTimeGrid, m_TimeGrid);
-
-
-  //Signal that will be returned by ComputeModelFunction
-  mitk::ModelBase::ModelResultType signal(timeSteps);
-  signal.fill(0.0);
+  return signal;
+}
 
-  mitk::ModelBase::ModelResultType::iterator signalPos = signal.begin();
-  mitk::ModelBase::ModelResultType::const_iterator CePos = C_EES.begin();
+bool mitk::NumericTwoCompartmentExchangeModel::HasAnalyticDerivative() const
+{
+  return true;
+};
 
-  mitk::ModelBase::ModelResultType::const_iterator t = this->m_TimeGrid.begin();
-  mitk::ModelBase::ModelResultType::const_iterator Cin = aterialInputFunction.begin();
+void mitk::NumericTwoCompartmentExchangeModel::ComputeModelDerivative(const ParametersType& parameters,
+    ModelResultType& signal, ModelDerivativeType& derivative) const
+{
+  this->CheckIntegrator();
 
+  LinearCompartmentODEIntegrator::SystemMatrixType a;
+  LinearCompartmentODEIntegrator::InputVectorType b;
+  this->GetSystem(parameters, a, b);
 
+  double F = (double) parameters[POSITION_PARAMETER_F] / 6000.0;
+  double PS  = (double) parameters[POSITION_PARAMETER_PS] / 6000.0;
+  double ve = (double) parameters[POSITION_PARAMETER_ve];
+  double vp = (double) parameters[POSITION_PARAMETER_vp];
 
-  for (mitk::ModelBase::ModelResultType::const_iterator CpPos = C_Plasma.begin();
-       CpPos != C_Plasma.end(); ++CpPos, ++CePos, ++signalPos, ++t, ++Cin)
+  //derivatives of the system with respect to the (unscaled) model parameters
+  std::vector<LinearCompartmentODEIntegrator::SystemMatrixType> dA(NUMBER_OF_PARAMETERS);
+  std::vector<LinearCompartmentODEIntegrator::InputVectorType> db(NUMBER_OF_PARAMETERS);
+
+  dA[POSITION_PARAMETER_F] = { { -1.0 / (6000.0 * vp), 0.0, 0.0, 0.0 } };
+  db[POSITION_PARAMETER_F] = { { 1.0 / (6000.0 * vp), 0.0 } };
+  dA[POSITION_PARAMETER_PS] = { { -1.0 / (6000.0 * vp), 1.0 / (6000.0 * vp), 1.0 / (6000.0 * ve), -1.0 / (6000.0 * ve) } };
+  db[POSITION_PARAMETER_PS] = { { 0.0, 0.0 } };
+  dA[POSITION_PARAMETER_ve] = { { 0.0, 0.0, -PS / (ve * ve), PS / (ve * ve) } };
+  db[POSITION_PARAMETER_ve] = { { 0.0, 0.0 } };
+  dA[POSITION_PARAMETER_vp] = { { (F + PS) / (vp * vp), -PS / (vp * vp), 0.0, 0.0 } };
+  db[POSITION_PARAMETER_vp] = { { -F / (vp * vp), 0.0 } };
+
+  LinearCompartmentODEIntegrator::ConcentrationCurveType C_Plasma;
+  LinearCompartmentODEIntegrator::ConcentrationCurveType C_EES;
+  LinearCompartmentODEIntegrator::ConcentrationDerivativeType dC_Plasma;
+  LinearCompartmentODEIntegrator::ConcentrationDerivativeType dC_EES;
+  m_Integrator.IntegrateWithSensitivities(a, b, dA, db, C_Plasma, C_EES, dC_Plasma, dC_EES);
+
+  const unsigned int timeSteps = this->m_TimeGrid.GetSize();
+  signal.SetSize(timeSteps);
+  derivative.SetSize(NUMBER_OF_PARAMETERS, timeSteps);
+
+  for (unsigned int i = 0; i < timeSteps; ++i)
   {
-    *signalPos = vp * (*CpPos) + ve * (*CePos);
+    signal[i] = vp * C_Plasma[i] + ve * C_EES[i];
 
-  }
-
-  return signal;
+    for (unsigned int j = 0; j < NUMBER_OF_PARAMETERS; ++j)
+    {
+      derivative[j][i] = vp * dC_Plasma[j][i] + ve * dC_EES[j][i];
+    }
 
-}
+    derivative[POSITION_PARAMETER_ve][i] += C_EES[i];
+    derivative[POSITION_PARAMETER_vp][i] += C_Plasma[i];
+  }
+};
 
 
 
@@ -271,6 +299,7 @@ itk::LightObject::Pointer mitk::NumericTwoCompartmentExchangeModel::InternalClon
   NumericTwoCompartmentExchangeModel::Pointer newClone = NumericTwoCompartmentExchangeModel::New();
 
   newClone->SetTimeGrid(this->m_TimeGrid);
+  newClone->SetODEINTStepSize(this->m_ODEINTStepSize);
 
   return newClone.GetPointer();
 }
@@ -13,10 +13,8 @@ found in the LICENSE file.
 #include "mitkNumericTwoTissueCompartmentModel.h"
 #include "mitkAIFParametrizerHelper.h"
 #include "mitkTimeGridHelper.h"
-#include "mitkTwoTissueCompartmentModelDifferentialEquations.h"
-#include <vnl/algo/vnl_fft_1d.h>
-#include <boost/numeric/odeint.hpp>
-#include <fstream>
+
+#include <algorithm>
 
 const std::string mitk::NumericTwoTissueCompartmentModel::MODEL_DISPLAY_NAME =
   "Numeric Two Tissue Compartment Model";
@@ -41,6 +39,8 @@ const unsigned int mitk::NumericTwoTissueCompartmentModel::POSITION_PARAMETER_VB
 
 const unsigned int mitk::NumericTwoTissueCompartmentModel::NUMBER_OF_PARAMETERS = 5;
 
+const double mitk::NumericTwoTissueCompartmentModel::ODE_STEP_SIZE = 0.1;
+
 
 std::string mitk::NumericTwoTissueCompartmentModel::GetModelDisplayName() const
 {
@@ -97,103 +97,132 @@ mitk::NumericTwoTissueCompartmentModel::GetParameterUnits() const
 };
 
 
-mitk::NumericTwoTissueCompartmentModel::ModelResultType
-mitk::NumericTwoTissueCompartmentModel::ComputeModelfunction(const ParametersType& parameters) const
+void mitk::NumericTwoTissueCompartmentModel::UpdateInterpolatedAterialInputFunction()
 {
-  typedef itk::Array<double> ConcentrationCurveType;
-  typedef std::vector<double> ConcentrationVectorType;
+  Superclass::UpdateInterpolatedAterialInputFunction();
+
+  m_Integrator.Reset();
 
+  const unsigned int timeSteps = this->m_TimeGrid.GetSize();
+  if (m_InterpolatedAterialInputFunctionIsValid && timeSteps > 1)
+  {
+    // The former implementation stepped until the last time point + the last frame duration.
+    // Make sure the integration also covers the time grid if the frames are shorter than a step.
+    const double endTime = std::max(this->m_TimeGrid[timeSteps - 1] +
+                                      (this->m_TimeGrid[timeSteps - 1] - this->m_TimeGrid[timeSteps - 2]),
+                                    this->m_TimeGrid[timeSteps - 1] + 2 * ODE_STEP_SIZE);
+    m_Integrator.Initialize(this->m_TimeGrid, m_InterpolatedAterialInputFunction, ODE_STEP_SIZE, endTime);
+  }
+}
+
+void mitk::NumericTwoTissueCompartmentModel::CheckIntegrator() const
+{
   if (this->m_TimeGrid.GetSize() == 0)
   {
     itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
   }
 
-  AterialInputFunctionType aterialInputFunction;
-  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
-
-  unsigned int timeSteps = this->m_TimeGrid.GetSize();
-
-  /** @brief Boost::numeric::odeint works with type std::vector<double> thus, aif and grid are converted to ModelParameters( of type std::vector)
-   */
-  mitk::TwoTissueCompartmentModelDifferentialEquations::AIFType aif = mitk::convertArrayToParameter(
-        aterialInputFunction);
-  mitk::TwoTissueCompartmentModelDifferentialEquations::AIFType grid = mitk::convertArrayToParameter(
-        m_TimeGrid);
-
-  mitk::TwoTissueCompartmentModelDifferentialEquations::AIFType aifODE = aif;
-  aifODE.push_back(aif[timeSteps - 1]);
-  mitk::TwoTissueCompartmentModelDifferentialEquations::AIFType gridODE = grid;
-  gridODE.push_back(grid[timeSteps - 1] + (grid[timeSteps - 1] - grid[timeSteps - 2]));
+  if (!m_Integrator.IsInitialized())
+  {
+    itkExceptionMacro("Cannot Calculate Signal. AIF or AIF time grid are not set or invalid.");
+  }
+}
 
-  //Model Parameters
+void mitk::NumericTwoTissueCompartmentModel::GetSystem(const ParametersType& parameters,
+    LinearCompartmentODEIntegrator::SystemMatrixType& a, LinearCompartmentODEIntegrator::InputVectorType& b) const
+{
   double K1 = (double)parameters[POSITION_PARAMETER_K1] / 60.0;
   double k2 = (double)parameters[POSITION_PARAMETER_k2] / 60.0;
   double k3 = (double)parameters[POSITION_PARAMETER_k3] / 60.0;
   double k4 = (double)parameters[POSITION_PARAMETER_k4] / 60.0;
-  double VB = parameters[POSITION_PARAMETER_VB];
 
+  /** @brief dC1/dt = K1 * Ca - (k2 + k3) * C1 + k4 * C2; dC2/dt = k3 * C1 - k4 * C2*/
+  a = { { -(k2 + k3), k4, k3, -k4 } };
+  b = { { K1, 0.0 } };
+}
+
+mitk::NumericTwoTissueCompartmentModel::ModelResultType
+mitk::NumericTwoTissueCompartmentModel::ComputeModelfunction(const ParametersType& parameters) const
+{
+  this->CheckIntegrator();
 
-  /** @brief Initialize class TwpTissueCompartmentModelDifferentialEquations defining the differential equations. AIF and Grid must be set so that at step t the aterial Concentration Ca(t) can be interpolated from AIF*/
-  mitk::TwoTissueCompartmentModelDifferentialEquations ode;
-  ode.initialize(K1, k2, k3, k4);
-  ode.setAIF(aifODE);
-  ode.setAIFTimeGrid(gridODE);
+  const AterialInputFunctionType& aterialInputFunction = m_InterpolatedAterialInputFunction;
 
-  state_type x(2);
-  x[0] = 0.0;
-  x[1] = 0.0;
-  typedef boost::numeric::odeint::runge_kutta_cash_karp54<state_type> error_stepper_type;
-  //typedef boost::numeric::odeint::runge_kutta4< state_type > stepper_type;
+  LinearCompartmentODEIntegrator::SystemMatrixType a;
+  LinearCompartmentODEIntegrator::InputVectorType b;
+  this->GetSystem(parameters, a, b);
 
-  /** @brief Results of odeeint x[0] and x[1]*/
-  ConcentrationVectorType C1;
-  ConcentrationVectorType C2;
-  ConcentrationVectorType odeTimeGrid;
+  LinearCompartmentODEIntegrator::ConcentrationCurveType C_1;
+  LinearCompartmentODEIntegrator::ConcentrationCurveType C_2;
+  m_Integrator.Integrate(a, b, C_1, C_2);
 
-  error_stepper_type stepper;
-  /** @brief Stepsize. Should be adapted by stepper (runge_kutta_cash_karp54) */
-  const double dt = 0.1;
-  /** @brief perform Step t -> t+dt to calculate approximate value x(t+dt)*/
+  double VB = parameters[POSITION_PARAMETER_VB];
 
-  double T = this->m_TimeGrid(timeSteps - 1) + (grid[timeSteps - 1] - grid[timeSteps - 2]);
+  //Signal that will be returned by ComputeModelFunction
+  mitk::ModelBase::ModelResultType signal(this->m_TimeGrid.GetSize());
 
-  for (double t = 0.0; t < T; t += dt)
+  for (unsigned int i = 0; i < signal.GetSize(); ++i)
   {
-    stepper.do_step(ode, x, t, dt);
-    C1.push_back(x[0]);
-    C2.push_back(x[1]);
-    odeTimeGrid.push_back(t);
-
+    signal[i] = VB * aterialInputFunction[i] + (1 - VB) * (C_1[i] + C_2[i]);
   }
 
-  /** @brief transfom result of Differential equations back to itk::Array and interpolate to m_TimeGrid (they are calculated on a different grid defined by stepsize of odeint)*/
-  ConcentrationCurveType ConcentrationCompartment1 = mitk::convertParameterToArray(C1);
-  ConcentrationCurveType ConcentrationCompartment2 = mitk::convertParameterToArray(C2);
-  ConcentrationCurveType rungeKuttaTimeGrid = mitk::convertParameterToArray(odeTimeGrid);
+  return signal;
+}
 
-  mitk::ModelBase::ModelResultType C_1 = mitk::InterpolateSignalToNewTimeGrid(
-      ConcentrationCompartment1, rungeKuttaTimeGrid, m_TimeGrid);
-  mitk::ModelBase::ModelResultType C_2 = mitk::InterpolateSignalToNewTimeGrid(
-      ConcentrationCompartment2, rungeKuttaTimeGrid, m_TimeGrid);
+bool mitk::NumericTwoTissueCompartmentModel::HasAnalyticDerivative() const
+{
+  return true;
+};
 
+void mitk::NumericTwoTissueCompartmentModel::ComputeModelDerivative(const ParametersType& parameters,
+    ModelResultType& signal, ModelDerivativeType& derivative) const
+{
+  this->CheckIntegrator();
+
+  const AterialInputFunctionType& aterialInputFunction = m_InterpolatedAterialInputFunction;
+
+  LinearCompartmentODEIntegrator::SystemMatrixType a;
+  LinearCompartmentODEIntegrator::InputVectorType b;
+  this->GetSystem(parameters, a, b);
+
+  //derivatives of the system with respect to the (unscaled) rate constants; V_B does not enter the ODE
+  const unsigned int numberOfRates = 4;
+  std::vector<LinearCompartmentODEIntegrator::SystemMatrixType> dA(numberOfRates);
+  std::vector<LinearCompartmentODEIntegrator::InputVectorType> db(numberOfRates);
+
+  dA[POSITION_PARAMETER_K1] = { { 0.0, 0.0, 0.0, 0.0 } };
+  db[POSITION_PARAMETER_K1] = { { 1.0 / 60.0, 0.0 } };
+  dA[POSITION_PARAMETER_k2] = { { -1.0 / 60.0, 0.0, 0.0, 0.0 } };
+  db[POSITION_PARAMETER_k2] = { { 0.0, 0.0 } };
+  dA[POSITION_PARAMETER_k3] = { { -1.0 / 60.0, 0.0, 1.0 / 60.0, 0.0 } };
+  db[POSITION_PARAMETER_k3] = { { 0.0, 0.0 } };
+  dA[POSITION_PARAMETER_k4] = { { 0.0, 1.0 / 60.0, 0.0, -1.0 / 60.0 } };
+  db[POSITION_PARAMETER_k4] = { { 0.0, 0.0 } };
+
+  LinearCompartmentODEIntegrator::ConcentrationCurveType C_1;
+  LinearCompartmentODEIntegrator::ConcentrationCurveType C_2;
+  LinearCompartmentODEIntegrator::ConcentrationDerivativeType dC_1;
+  LinearCompartmentODEIntegrator::ConcentrationDerivativeType dC_2;
+  m_Integrator.IntegrateWithSensitivities(a, b, dA, db, C_1, C_2, dC_1, dC_2);
 
-  //Signal that will be returned by ComputeModelFunction
-  mitk::ModelBase::ModelResultType signal(timeSteps);
-  signal.fill(0.0);
-  mitk::ModelBase::ModelResultType::iterator signalPos = signal.begin();
-  mitk::ModelBase::ModelResultType::const_iterator C1Pos = C_1.begin();
-  mitk::ModelBase::ModelResultType::const_iterator C2Pos = C_2.begin();
+  double VB = parameters[POSITION_PARAMETER_VB];
 
+  const unsigned int timeSteps = this->m_TimeGrid.GetSize();
+  signal.SetSize(timeSteps);
+  derivative.SetSize(NUMBER_OF_PARAMETERS, timeSteps);
 
-  for (AterialInputFunctionType::const_iterator aifpos = aterialInputFunction.begin();
-       aifpos != aterialInputFunction.end(); ++aifpos, ++C1Pos, ++C2Pos, ++signalPos)
+  for (unsigned int i = 0; i < timeSteps; ++i)
   {
-    *signalPos = VB * (*aifpos) + (1 - VB) * (*C1Pos + *C2Pos);
-  }
+    signal[i] = VB * aterialInputFunction[i] + (1 - VB) * (C_1[i] + C_2[i]);
 
-  return signal;
+    for (unsigned int j = 0; j < numberOfRates; ++j)
+    {
+      derivative[j][i] = (1 - VB) * (dC_1[j][i] + dC_2[j][i]);
+    }
 
-}
+    derivative[POSITION_PARAMETER_VB][i] = aterialInputFunction[i] - (C_1[i] + C_2[i]);
+  }
+};
 
 itk::LightObject::Pointer mitk::NumericTwoTissueCompartmentModel::InternalClone() const
 {
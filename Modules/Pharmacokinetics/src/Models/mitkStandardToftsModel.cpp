@@ -12,7 +12,6 @@ found in the LICENSE file.
 
 #include "mitkStandardToftsModel.h"
 #include "mitkConvolutionHelper.h"
-#include <vnl/algo/vnl_fft_1d.h>
 #include <fstream>
 
 const std::string mitk::StandardToftsModel::MODEL_DISPLAY_NAME = "Standard Tofts Model";
@@ -141,6 +140,47 @@ mitk::StandardToftsModel::ModelResultType mitk::StandardToftsModel::ComputeModel
 }
 
 
+bool mitk::StandardToftsModel::HasAnalyticDerivative() const
+{
+  return true;
+};
+
+void mitk::StandardToftsModel::ComputeModelDerivative(const ParametersType& parameters,
+    ModelResultType& signal, ModelDerivativeType& derivative) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  const AterialInputFunctionType aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+  unsigned int timeSteps = this->m_TimeGrid.GetSize();
+
+  //Model Parameters
+  double ktrans = parameters[POSITION_PARAMETER_Ktrans] / 6000.0;
+  double     ve = parameters[POSITION_PARAMETER_ve];
+
+  double lambda =  ktrans / ve;
+
+  mitk::ModelBase::ModelResultType convolution;
+  mitk::ModelBase::ModelResultType convolutionDerivative;
+  mitk::convoluteAIFWithExponentialAndDerivative(this->m_TimeGrid, aterialInputFunction, lambda,
+      convolution, convolutionDerivative);
+
+  signal.SetSize(timeSteps);
+  derivative.SetSize(NUMBER_OF_PARAMETERS, timeSteps);
+
+  //lambda depends on ktrans and ve: d lambda/d ktrans = 1/ve, d lambda/d ve = -lambda/ve
+  for (unsigned int i = 0; i < timeSteps; ++i)
+  {
+    signal[i] = ktrans * convolution[i];
+    derivative[POSITION_PARAMETER_Ktrans][i] = (convolution[i] + lambda * convolutionDerivative[i]) / 6000.0;
+    derivative[POSITION_PARAMETER_ve][i] = -ktrans * lambda / ve * convolutionDerivative[i];
+  }
+};
+
+
 mitk::ModelBase::DerivedParameterMapType mitk::StandardToftsModel::ComputeDerivedParameters(
   const mitk::ModelBase::ParametersType& parameters) const
 {
@@ -1,4 +1,6 @@
 SET(MODULE_TESTS
   mitkDescriptivePharmacokineticBrixModelTest.cpp
+  mitkToftsModelDerivativeTest.cpp
+  mitkNumericCompartmentModelTest.cpp
   #ConvertToConcentrationTest.cpp
 )
@@ -0,0 +1,71 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkModelDerivativeTestHelper_h
+#define mitkModelDerivativeTestHelper_h
+
+#include "mitkModelBase.h"
+#include "mitkSquaredDifferencesFitCostFunction.h"
+
+#include "mitkTestingMacros.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mitk
+{
+
+class ModelDerivativeTestHelper
+{
+  public:
+
+  /** Compares the derivative of the squared differences of the analytic and the numerical path of the model.
+   * Each derivative may deviate by relativeTolerance times the largest numerical derivative of its parameter.*/
+  static void CheckDerivative(const ModelBase* model, const ModelBase::ParametersType& parameters, double relativeTolerance)
+  {
+    ModelBase::ParametersType sampleParameters = parameters;
+    sampleParameters[0] *= 1.3;
+
+    SquaredDifferencesFitCostFunction::Pointer costFunction = SquaredDifferencesFitCostFunction::New();
+    costFunction->SetModel(model);
+    costFunction->SetSample(model->GetSignal(sampleParameters));
+
+    MVModelFitCostFunction::DerivativeType analytic;
+    costFunction->GetDerivative(parameters, analytic);
+
+    costFunction->UseAnalyticDerivativeOff();
+    MVModelFitCostFunction::DerivativeType numeric;
+    costFunction->GetDerivative(parameters, numeric);
+
+    CPPUNIT_ASSERT_EQUAL(numeric.rows(), analytic.rows());
+    CPPUNIT_ASSERT_EQUAL(numeric.cols(), analytic.cols());
+
+    for (unsigned int i = 0; i < numeric.rows(); ++i)
+    {
+      double maximum = 0.0;
+      for (unsigned int j = 0; j < numeric.cols(); ++j)
+      {
+        maximum = std::max(maximum, std::abs(numeric[i][j]));
+      }
+      CPPUNIT_ASSERT_MESSAGE("Derivative of parameter is not trivially zero", maximum > 0.0);
+
+      for (unsigned int j = 0; j < numeric.cols(); ++j)
+      {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(numeric[i][j], analytic[i][j], relativeTolerance * maximum);
+      }
+    }
+  }
+};
+
+}
+
+#endif
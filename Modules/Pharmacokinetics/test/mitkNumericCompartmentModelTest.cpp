@@ -0,0 +1,265 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTestingMacros.h"
+#include "mitkTestFixture.h"
+
+#include "mitkAIFParametrizerHelper.h"
+#include "mitkModelDerivativeTestHelper.h"
+#include "mitkNumericTwoCompartmentExchangeModel.h"
+#include "mitkNumericTwoTissueCompartmentModel.h"
+#include "mitkTimeGridHelper.h"
+#include "mitkTwoCompartmentExchangeModelDifferentialEquations.h"
+#include "mitkTwoTissueCompartmentModelDifferentialEquations.h"
+
+#include <boost/numeric/odeint.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+class mitkNumericCompartmentModelTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkNumericCompartmentModelTestSuite);
+  MITK_TEST(TestTwoCompartmentExchangeSignal);
+  MITK_TEST(TestTwoCompartmentExchangeDerivative);
+  MITK_TEST(TestTwoTissueCompartmentSignal);
+  MITK_TEST(TestTwoTissueCompartmentDerivative);
+  MITK_TEST(TestMissingAIF);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef std::vector<double> StateType;
+  typedef boost::numeric::odeint::runge_kutta_cash_karp54<StateType> StepperType;
+
+  mitk::ModelBase::TimeGridType m_Grid;
+  mitk::AIFBasedModelBase::AterialInputFunctionType m_AIF;
+
+  /** Steps the ODE like the former odeint based implementation of the models and interpolates the
+   * weighted sum of the compartments to the time grid. Only time points up to maxTime are valid.*/
+  template <typename TODE>
+  mitk::ModelBase::ModelResultType ComputeReferenceConcentration(TODE& ode, double dt, double endTime,
+    double weight1, double weight2, double& maxTime) const
+  {
+    StateType x(2, 0.0);
+    StepperType stepper;
+
+    std::vector<double> concentration;
+    std::vector<double> odeTimeGrid;
+
+    for (double t = 0.0; t < endTime; t += dt)
+    {
+      stepper.do_step(ode, x, t, dt);
+      concentration.push_back(weight1 * x[0] + weight2 * x[1]);
+      odeTimeGrid.push_back(t);
+    }
+
+    maxTime = odeTimeGrid.back();
+    return mitk::InterpolateSignalToNewTimeGrid(mitk::convertParameterToArray(concentration),
+      mitk::convertParameterToArray(odeTimeGrid), m_Grid);
+  }
+
+  /** AIF and time grid for the ODE functors: extended by one time point like in the former implementation and by
+   * a far time point, so that the AIF is also defined for the last integration steps.*/
+  void GetODEAIF(std::vector<double>& aif, std::vector<double>& grid) const
+  {
+    const unsigned int timeSteps = m_Grid.GetSize();
+    aif = mitk::convertArrayToParameter(m_AIF);
+    grid = mitk::convertArrayToParameter(m_Grid);
+    aif.push_back(m_AIF[timeSteps - 1]);
+    grid.push_back(m_Grid[timeSteps - 1] + (m_Grid[timeSteps - 1] - m_Grid[timeSteps - 2]));
+    aif.push_back(m_AIF[timeSteps - 1]);
+    grid.push_back(1e10);
+  }
+
+  void CheckSignal(const mitk::ModelBase::ModelResultType& expected, const mitk::ModelBase::ModelResultType& signal,
+    double maxTime) const
+  {
+    CPPUNIT_ASSERT_EQUAL(expected.GetSize(), signal.GetSize());
+
+    const double maximum = expected.inf_norm();
+    CPPUNIT_ASSERT(maximum > 0.0);
+
+    unsigned int checkedTimePoints = 0;
+    for (unsigned int i = 0; i < m_Grid.GetSize(); ++i)
+    {
+      if (m_Grid[i] <= maxTime)
+      {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[i], signal[i], 1e-10 * maximum);
+        ++checkedTimePoints;
+      }
+    }
+    CPPUNIT_ASSERT(checkedTimePoints + 1 >= m_Grid.GetSize());
+  }
+
+  mitk::NumericTwoCompartmentExchangeModel::Pointer CreateTwoCompartmentExchangeModel() const
+  {
+    mitk::NumericTwoCompartmentExchangeModel::Pointer model = mitk::NumericTwoCompartmentExchangeModel::New();
+    model->SetTimeGrid(m_Grid);
+    model->SetAterialInputFunctionValues(m_AIF);
+    model->SetODEINTStepSize(0.05);
+    return model;
+  }
+
+  mitk::NumericTwoTissueCompartmentModel::Pointer CreateTwoTissueCompartmentModel() const
+  {
+    mitk::NumericTwoTissueCompartmentModel::Pointer model = mitk::NumericTwoTissueCompartmentModel::New();
+    model->SetTimeGrid(m_Grid);
+    model->SetAterialInputFunctionValues(m_AIF);
+    return model;
+  }
+
+  mitk::ModelBase::ParametersType GetTwoCompartmentExchangeParameters() const
+  {
+    mitk::ModelBase::ParametersType parameters(4);
+    parameters[mitk::NumericTwoCompartmentExchangeModel::POSITION_PARAMETER_F] = 60.0;
+    parameters[mitk::NumericTwoCompartmentExchangeModel::POSITION_PARAMETER_PS] = 20.0;
+    parameters[mitk::NumericTwoCompartmentExchangeModel::POSITION_PARAMETER_ve] = 0.3;
+    parameters[mitk::NumericTwoCompartmentExchangeModel::POSITION_PARAMETER_vp] = 0.05;
+    return parameters;
+  }
+
+  mitk::ModelBase::ParametersType GetTwoTissueCompartmentParameters() const
+  {
+    mitk::ModelBase::ParametersType parameters(5);
+    parameters[mitk::NumericTwoTissueCompartmentModel::POSITION_PARAMETER_K1] = 0.5;
+    parameters[mitk::NumericTwoTissueCompartmentModel::POSITION_PARAMETER_k2] = 0.3;
+    parameters[mitk::NumericTwoTissueCompartmentModel::POSITION_PARAMETER_k3] = 0.1;
+    parameters[mitk::NumericTwoTissueCompartmentModel::POSITION_PARAMETER_k4] = 0.05;
+    parameters[mitk::NumericTwoTissueCompartmentModel::POSITION_PARAMETER_VB] = 0.05;
+    return parameters;
+  }
+
+public:
+  void setUp() override
+  {
+    m_Grid.SetSize(40);
+    m_AIF.SetSize(40);
+    for (unsigned int i = 0; i < m_Grid.GetSize(); ++i)
+    {
+      m_Grid[i] = 4.0 * i;
+      const double t = std::max(0.0, m_Grid[i] - 10.0) / 10.0;
+      m_AIF[i] = 5.0 * t * t * std::exp(-t) + 0.5 * (1.0 - std::exp(-t / 5.0));
+    }
+  }
+
+  void tearDown() override
+  {
+  }
+
+  void TestTwoCompartmentExchangeSignal()
+  {
+    mitk::NumericTwoCompartmentExchangeModel::Pointer model = this->CreateTwoCompartmentExchangeModel();
+    const mitk::ModelBase::ParametersType parameters = this->GetTwoCompartmentExchangeParameters();
+
+    const double F = parameters[0] / 6000.0;
+    const double PS = parameters[1] / 6000.0;
+    const double ve = parameters[2];
+    const double vp = parameters[3];
+    const double dt = 0.05;
+
+    std::vector<double> aif;
+    std::vector<double> grid;
+    this->GetODEAIF(aif, grid);
+
+    mitk::TwoCompartmentExchangeModelDifferentialEquations ode;
+    ode.initialize(F, PS, ve, vp);
+    ode.setAIF(aif);
+    ode.setAIFTimeGrid(grid);
+
+    double maxTime = 0.0;
+    const mitk::ModelBase::ModelResultType expected = this->ComputeReferenceConcentration(ode, dt,
+      m_Grid[m_Grid.GetSize() - 1] - 2 * dt, vp, ve, maxTime);
+
+    this->CheckSignal(expected, model->GetSignal(parameters), maxTime);
+
+    // the step size is a static parameter of the model and has to be respected
+    model->SetODEINTStepSize(0.5);
+    const mitk::ModelBase::ModelResultType coarseSignal = model->GetSignal(parameters);
+    mitk::ModelBase::StaticParameterMapType staticParameters;
+    staticParameters[mitk::NumericTwoCompartmentExchangeModel::NAME_STATIC_PARAMETER_ODEINTStepSize] =
+      mitk::ModelBase::StaticParameterValuesType(1, 0.05);
+    model->SetStaticParameters(staticParameters, false);
+    CPPUNIT_ASSERT((coarseSignal - model->GetSignal(parameters)).inf_norm() > 0.0);
+    this->CheckSignal(expected, model->GetSignal(parameters), maxTime);
+  }
+
+  void TestTwoCompartmentExchangeDerivative()
+  {
+    mitk::NumericTwoCompartmentExchangeModel::Pointer model = this->CreateTwoCompartmentExchangeModel();
+    CPPUNIT_ASSERT(model->HasAnalyticDerivative());
+
+    const mitk::ModelBase::ParametersType parameters = this->GetTwoCompartmentExchangeParameters();
+
+    mitk::ModelBase::ModelResultType signal;
+    mitk::ModelBase::ModelDerivativeType derivative;
+    model->GetSignalAndDerivative(parameters, signal, derivative);
+    CPPUNIT_ASSERT((signal - model->GetSignal(parameters)).inf_norm() < 1e-12);
+
+    mitk::ModelDerivativeTestHelper::CheckDerivative(model, parameters, 1e-4);
+  }
+
+  void TestTwoTissueCompartmentSignal()
+  {
+    mitk::NumericTwoTissueCompartmentModel::Pointer model = this->CreateTwoTissueCompartmentModel();
+    const mitk::ModelBase::ParametersType parameters = this->GetTwoTissueCompartmentParameters();
+
+    std::vector<double> aif;
+    std::vector<double> grid;
+    this->GetODEAIF(aif, grid);
+
+    mitk::TwoTissueCompartmentModelDifferentialEquations ode;
+    ode.initialize(parameters[0] / 60.0, parameters[1] / 60.0, parameters[2] / 60.0, parameters[3] / 60.0);
+    ode.setAIF(aif);
+    ode.setAIFTimeGrid(grid);
+
+    const unsigned int timeSteps = m_Grid.GetSize();
+    const double VB = parameters[4];
+
+    double maxTime = 0.0;
+    mitk::ModelBase::ModelResultType expected = this->ComputeReferenceConcentration(ode, 0.1,
+      m_Grid[timeSteps - 1] + (m_Grid[timeSteps - 1] - m_Grid[timeSteps - 2]), 1 - VB, 1 - VB, maxTime);
+    for (unsigned int i = 0; i < timeSteps; ++i)
+    {
+      expected[i] += VB * m_AIF[i];
+    }
+
+    this->CheckSignal(expected, model->GetSignal(parameters), maxTime);
+  }
+
+  void TestTwoTissueCompartmentDerivative()
+  {
+    mitk::NumericTwoTissueCompartmentModel::Pointer model = this->CreateTwoTissueCompartmentModel();
+    CPPUNIT_ASSERT(model->HasAnalyticDerivative());
+
+    const mitk::ModelBase::ParametersType parameters = this->GetTwoTissueCompartmentParameters();
+
+    mitk::ModelBase::ModelResultType signal;
+    mitk::ModelBase::ModelDerivativeType derivative;
+    model->GetSignalAndDerivative(parameters, signal, derivative);
+    CPPUNIT_ASSERT((signal - model->GetSignal(parameters)).inf_norm() < 1e-12);
+
+    mitk::ModelDerivativeTestHelper::CheckDerivative(model, parameters, 1e-4);
+  }
+
+  void TestMissingAIF()
+  {
+    mitk::NumericTwoTissueCompartmentModel::Pointer model = mitk::NumericTwoTissueCompartmentModel::New();
+    model->SetTimeGrid(m_Grid);
+    CPPUNIT_ASSERT_THROW(model->GetSignal(this->GetTwoTissueCompartmentParameters()), itk::ExceptionObject);
+
+    mitk::NumericTwoCompartmentExchangeModel::Pointer exchangeModel = this->CreateTwoCompartmentExchangeModel();
+    exchangeModel->SetODEINTStepSize(0.0);
+    CPPUNIT_ASSERT_THROW(exchangeModel->GetSignal(this->GetTwoCompartmentExchangeParameters()), itk::ExceptionObject);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkNumericCompartmentModel)
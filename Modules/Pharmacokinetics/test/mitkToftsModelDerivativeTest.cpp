@@ -0,0 +1,196 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTestingMacros.h"
+#include "mitkTestFixture.h"
+
+#include "mitkExtendedToftsModel.h"
+#include "mitkLevenbergMarquardtModelFitFunctor.h"
+#include "mitkModelDerivativeTestHelper.h"
+#include "mitkStandardToftsModel.h"
+#include "mitkTimeGridHelper.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+class mitkToftsModelDerivativeTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkToftsModelDerivativeTestSuite);
+  MITK_TEST(TestInterpolatedAIF);
+  MITK_TEST(TestStandardToftsDerivative);
+  MITK_TEST(TestExtendedToftsDerivative);
+  MITK_TEST(TestFitWithAnalyticDerivative);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::ModelBase::TimeGridType m_Grid;
+  mitk::ModelBase::TimeGridType m_AIFGrid;
+  mitk::AIFBasedModelBase::AterialInputFunctionType m_AIF;
+
+public:
+  void setUp() override
+  {
+    // model time grid: 60 frames, 3 s apart; AIF sampled on a finer grid
+    m_Grid.SetSize(60);
+    for (unsigned int i = 0; i < m_Grid.GetSize(); ++i)
+    {
+      m_Grid[i] = 3.0 * i;
+    }
+
+    m_AIFGrid.SetSize(120);
+    m_AIF.SetSize(120);
+    for (unsigned int i = 0; i < m_AIFGrid.GetSize(); ++i)
+    {
+      m_AIFGrid[i] = 1.5 * i;
+      const double t = std::max(0.0, m_AIFGrid[i] - 10.0) / 10.0;
+      m_AIF[i] = 5.0 * t * t * std::exp(-t) + 0.5 * (1.0 - std::exp(-t / 5.0));
+    }
+  }
+
+  void tearDown() override
+  {
+  }
+
+  void TestInterpolatedAIF()
+  {
+    mitk::StandardToftsModel::Pointer model = mitk::StandardToftsModel::New();
+    model->SetTimeGrid(m_Grid);
+    model->SetAterialInputFunctionValues(m_AIF);
+    model->SetAterialInputFunctionTimeGrid(m_AIFGrid);
+
+    mitk::ModelBase::ModelResultType expected = mitk::InterpolateSignalToNewTimeGrid(m_AIF, m_AIFGrid, m_Grid);
+    CPPUNIT_ASSERT(expected == model->GetAterialInputFunction(m_Grid));
+
+    // changing the model time grid has to update the interpolation
+    mitk::ModelBase::TimeGridType shortGrid(30);
+    for (unsigned int i = 0; i < shortGrid.GetSize(); ++i)
+    {
+      shortGrid[i] = 5.0 * i;
+    }
+    model->SetTimeGrid(shortGrid);
+    expected = mitk::InterpolateSignalToNewTimeGrid(m_AIF, m_AIFGrid, shortGrid);
+    CPPUNIT_ASSERT(expected == model->GetAterialInputFunction(shortGrid));
+
+    // other grids are still interpolated on request
+    expected = mitk::InterpolateSignalToNewTimeGrid(m_AIF, m_AIFGrid, m_Grid);
+    CPPUNIT_ASSERT(expected == model->GetAterialInputFunction(m_Grid));
+    CPPUNIT_ASSERT(m_AIF == model->GetAterialInputFunction(mitk::ModelBase::TimeGridType()));
+  }
+
+  void TestStandardToftsDerivative()
+  {
+    mitk::StandardToftsModel::Pointer model = mitk::StandardToftsModel::New();
+    model->SetTimeGrid(m_Grid);
+    model->SetAterialInputFunctionValues(m_AIF);
+    model->SetAterialInputFunctionTimeGrid(m_AIFGrid);
+    CPPUNIT_ASSERT(model->HasAnalyticDerivative());
+
+    mitk::ModelBase::ParametersType parameters(2);
+    parameters[mitk::StandardToftsModel::POSITION_PARAMETER_Ktrans] = 15.0;
+    parameters[mitk::StandardToftsModel::POSITION_PARAMETER_ve] = 0.3;
+
+    mitk::ModelBase::ModelResultType signal;
+    mitk::ModelBase::ModelDerivativeType derivative;
+    model->GetSignalAndDerivative(parameters, signal, derivative);
+    CPPUNIT_ASSERT((signal - model->GetSignal(parameters)).inf_norm() < 1e-12);
+
+    mitk::ModelDerivativeTestHelper::CheckDerivative(model, parameters, 1e-5);
+
+    mitk::ModelBase::ParametersType wrongSize(3);
+    CPPUNIT_ASSERT_THROW(model->GetSignalAndDerivative(wrongSize, signal, derivative), itk::ExceptionObject);
+  }
+
+  void TestExtendedToftsDerivative()
+  {
+    mitk::ExtendedToftsModel::Pointer model = mitk::ExtendedToftsModel::New();
+    model->SetTimeGrid(m_Grid);
+    model->SetAterialInputFunctionValues(m_AIF);
+    model->SetAterialInputFunctionTimeGrid(m_AIFGrid);
+    CPPUNIT_ASSERT(model->HasAnalyticDerivative());
+
+    mitk::ModelBase::ParametersType parameters(3);
+    parameters[mitk::ExtendedToftsModel::POSITION_PARAMETER_Ktrans] = 15.0;
+    parameters[mitk::ExtendedToftsModel::POSITION_PARAMETER_ve] = 0.3;
+    parameters[mitk::ExtendedToftsModel::POSITION_PARAMETER_vp] = 0.05;
+
+    mitk::ModelBase::ModelResultType signal;
+    mitk::ModelBase::ModelDerivativeType derivative;
+    model->GetSignalAndDerivative(parameters, signal, derivative);
+    CPPUNIT_ASSERT((signal - model->GetSignal(parameters)).inf_norm() < 1e-12);
+
+    mitk::ModelDerivativeTestHelper::CheckDerivative(model, parameters, 1e-5);
+  }
+
+  void TestFitWithAnalyticDerivative()
+  {
+    mitk::ExtendedToftsModel::Pointer model = mitk::ExtendedToftsModel::New();
+    model->SetTimeGrid(m_Grid);
+    model->SetAterialInputFunctionValues(m_AIF);
+    model->SetAterialInputFunctionTimeGrid(m_AIFGrid);
+
+    mitk::ModelBase::ParametersType initialParameters(3);
+    initialParameters[0] = 10.0;
+    initialParameters[1] = 0.5;
+    initialParameters[2] = 0.1;
+
+    std::vector<std::vector<double>> samples;
+    std::vector<mitk::ModelBase::ParametersType> truth;
+    for (unsigned int i = 0; i < 200; ++i)
+    {
+      mitk::ModelBase::ParametersType parameters(3);
+      parameters[0] = 5.0 + 0.1 * i;
+      parameters[1] = 0.2 + 0.002 * i;
+      parameters[2] = 0.02 + 0.0002 * i;
+      truth.push_back(parameters);
+
+      mitk::ModelBase::ModelResultType signal = model->GetSignal(parameters);
+      samples.emplace_back(signal.begin(), signal.end());
+    }
+
+    mitk::LevenbergMarquardtModelFitFunctor::Pointer analyticFunctor = mitk::LevenbergMarquardtModelFitFunctor::New();
+    mitk::LevenbergMarquardtModelFitFunctor::Pointer numericFunctor = mitk::LevenbergMarquardtModelFitFunctor::New();
+    numericFunctor->SetUseAnalyticDerivative(false);
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::vector<double>> analyticResults;
+    for (const auto& sample : samples)
+    {
+      analyticResults.push_back(analyticFunctor->Compute(sample, model, initialParameters));
+    }
+    auto analyticTime = std::chrono::steady_clock::now() - startTime;
+
+    startTime = std::chrono::steady_clock::now();
+    std::vector<std::vector<double>> numericResults;
+    for (const auto& sample : samples)
+    {
+      numericResults.push_back(numericFunctor->Compute(sample, model, initialParameters));
+    }
+    auto numericTime = std::chrono::steady_clock::now() - startTime;
+
+    MITK_INFO << "Extended Tofts fit of " << samples.size() << " curves: analytic derivative "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(analyticTime).count()
+              << " ms; numerical derivative "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(numericTime).count() << " ms";
+
+    for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+      for (unsigned int p = 0; p < 3; ++p)
+      {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(truth[i][p], analyticResults[i][p], 1e-2 * truth[i][p]);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(numericResults[i][p], analyticResults[i][p], 1e-2 * truth[i][p]);
+      }
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkToftsModelDerivative)
@@ -14,7 +14,12 @@ found in the LICENSE file.
 #define MITK_PHOTOACOUSTICS_BEAMFORMING_FILTER
 
 #include "mitkImageToImageFilter.h"
+#include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "./OpenCLFilter/mitkPhotoacousticOCLBeamformingFilter.h"
 #include "mitkBeamformingSettings.h"
 #include "mitkBeamformingUtils.h"
@@ -27,6 +32,10 @@ namespace mitk {
   *  The class must be given a configuration class instance of mitk::BeamformingSettings for beamforming parameters through mitk::BeamformingFilter::Configure(BeamformingSettings settings)
   *  Whether the GPU is used can be set in the configuration.
   *  For significant problems or important messages a string is written, which can be accessed via GetMessageString().
+  *
+  *  On the CPU, the lines of several slices are distributed to worker threads together. The worker threads are started
+  *  on the first update and kept until the filter is destroyed, so repeated updates for single frames do not pay for
+  *  thread creation.
   */
 
   class MITKPHOTOACOUSTICSALGORITHMS_EXPORT BeamformingFilter : public ImageToImageFilter
@@ -44,6 +53,10 @@ namespace mitk {
     */
     void SetProgressHandle(std::function<void(int, std::string)> progressHandle);
 
+    /** \brief Returns the configuration the filter has been created with
+    */
+    BeamformingSettings::Pointer GetConfiguration() const { return m_Conf; }
+
   protected:
     BeamformingFilter(mitk::BeamformingSettings::Pointer settings);
 
@@ -55,6 +68,16 @@ namespace mitk {
 
     void GenerateData() override;
 
+    /** \brief Calls job for every item in [0, numberOfItems) on the worker threads and the calling thread
+    *
+    *  Returns when all items are done. The worker threads are started on the first call.
+    */
+    void ParallelFor(unsigned int numberOfItems, const std::function<void(unsigned int)>& job);
+
+    void WorkerLoop();
+
+    void StopWorkers();
+
     //##Description
     //## @brief Time when Header was last initialized
     itk::TimeStamp m_TimeOfHeaderInitialization;
@@ -80,6 +103,17 @@ namespace mitk {
     /** \brief Pointer to the GPU beamforming filter class; for performance reasons the filter is initialized within the constructor and kept for all later computations.
     */
     mitk::PhotoacousticOCLBeamformingFilter::Pointer m_BeamformingOclFilter;
+
+    std::vector<std::thread> m_Workers;
+    std::mutex m_WorkerMutex;
+    std::condition_variable m_WorkAvailable;
+    std::condition_variable m_WorkFinished;
+    const std::function<void(unsigned int)>* m_Job;
+    std::atomic<unsigned int> m_NextItem;
+    unsigned int m_NumberOfItems;
+    unsigned int m_ActiveWorkers;
+    unsigned long m_JobGeneration;
+    bool m_StopWorkers;
   };
 } // namespace mitk
 
@@ -18,6 +18,8 @@ found in the LICENSE file.
 #include <mitkCommon.h>
 #include <MitkPhotoacousticsAlgorithmsExports.h>
 
+#include <mutex>
+
 namespace mitk {
   /*!
   * \brief Class holding the configuration data for the beamforming filters mitk::BeamformingFilter and mitk::PhotoacousticOCLBeamformingFilter
@@ -130,6 +132,22 @@ namespace mitk {
 
     unsigned short* GetMinMaxLines();
 
+    /** \brief Squared horizontal distances between reconstruction lines and transducer elements in samples
+    *
+    * The table holds GetTransducerElements() values per reconstruction line and is computed on the first call.
+    */
+    const float* GetHorizontalDelays();
+
+    /** \brief Heights of the transducer elements in samples, computed on the first call
+    */
+    const float* GetVerticalDelays();
+
+    /** \brief Apodization weights resampled for every possible number of used transducer elements
+    *
+    * The weights for n used elements start at index n * (n - 1) / 2. The table is computed on the first call.
+    */
+    const float* GetApodizationTable();
+
   protected:
 
     /**
@@ -239,6 +257,14 @@ namespace mitk {
     /**
     */
     unsigned short* m_MinMaxLines;
+
+    float* m_HorizontalDelays;
+    float* m_VerticalDelays;
+    float* m_ApodizationTable;
+
+    /** \brief Guards the lazily computed tables, which the CPU beamforming threads share
+    */
+    std::mutex m_TableMutex;
   };
 }
 #endif //MITK_BEAMFORMING_SETTINGS
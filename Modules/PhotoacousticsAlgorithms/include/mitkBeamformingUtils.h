@@ -22,6 +22,8 @@ namespace mitk {
   /*!
   * \brief Class implementing util functionality for beamforming on CPU
   *
+  * The line functions read the delay and apodization tables cached in mitk::BeamformingSettings. The tables are
+  * created on first access, which is thread-safe, so the functions can be called for several lines concurrently.
   */
   class BeamformingUtils final
   {
@@ -58,6 +60,19 @@ namespace mitk {
     */
     static unsigned short* MinMaxLines(const mitk::BeamformingSettings::Pointer config);
 
+    /** \brief Function to create the table of squared horizontal distances between reconstruction lines and transducer elements in samples
+    */
+    static float* HorizontalDelays(const mitk::BeamformingSettings::Pointer config);
+
+    /** \brief Function to create the table of transducer element heights in samples
+    */
+    static float* VerticalDelays(const mitk::BeamformingSettings::Pointer config);
+
+    /** \brief Function to create the apodization weights for every possible number of used transducer elements
+    * The weights for n used elements start at index n * (n - 1) / 2.
+    */
+    static float* ApodizationTable(const mitk::BeamformingSettings::Pointer config);
+
   protected:
     BeamformingUtils();
 
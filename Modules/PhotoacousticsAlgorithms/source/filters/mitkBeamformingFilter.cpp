@@ -24,7 +24,13 @@ found in the LICENSE file.
 mitk::BeamformingFilter::BeamformingFilter(mitk::BeamformingSettings::Pointer settings) :
   m_OutputData(nullptr),
   m_InputData(nullptr),
-  m_Conf(settings)
+  m_Conf(settings),
+  m_Job(nullptr),
+  m_NextItem(0),
+  m_NumberOfItems(0),
+  m_ActiveWorkers(0),
+  m_JobGeneration(0),
+  m_StopWorkers(false)
 {
   MITK_INFO << "Instantiating BeamformingFilter...";
   this->SetNumberOfIndexedInputs(1);
@@ -47,9 +53,88 @@ void mitk::BeamformingFilter::SetProgressHandle(std::function<void(int, std::str
 
 mitk::BeamformingFilter::~BeamformingFilter()
 {
+  this->StopWorkers();
   MITK_INFO << "Destructed BeamformingFilter";
 }
 
+void mitk::BeamformingFilter::ParallelFor(unsigned int numberOfItems, const std::function<void(unsigned int)>& job)
+{
+  std::unique_lock<std::mutex> lock(m_WorkerMutex);
+
+  if (m_Workers.empty())
+  {
+    // the calling thread takes part in the work as well
+    unsigned int numberOfWorkers = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+    for (unsigned int i = 0; i < numberOfWorkers; ++i)
+    {
+      m_Workers.emplace_back(&BeamformingFilter::WorkerLoop, this);
+    }
+  }
+
+  m_Job = &job;
+  m_NumberOfItems = numberOfItems;
+  m_NextItem = 0;
+  ++m_JobGeneration;
+  lock.unlock();
+  m_WorkAvailable.notify_all();
+
+  for (unsigned int item = m_NextItem++; item < numberOfItems; item = m_NextItem++)
+  {
+    job(item);
+  }
+
+  // all items are taken; wait for the workers still processing one
+  lock.lock();
+  m_WorkFinished.wait(lock, [this] { return m_ActiveWorkers == 0; });
+  m_Job = nullptr;
+}
+
+void mitk::BeamformingFilter::WorkerLoop()
+{
+  unsigned long lastGeneration = 0;
+  std::unique_lock<std::mutex> lock(m_WorkerMutex);
+
+  while (true)
+  {
+    m_WorkAvailable.wait(lock, [this, &lastGeneration] { return m_StopWorkers || m_JobGeneration != lastGeneration; });
+    if (m_StopWorkers)
+      return;
+
+    lastGeneration = m_JobGeneration;
+    if (m_Job == nullptr)
+      continue; // woke up after the job was already done
+
+    const std::function<void(unsigned int)>* job = m_Job;
+    unsigned int numberOfItems = m_NumberOfItems;
+    ++m_ActiveWorkers;
+    lock.unlock();
+
+    for (unsigned int item = m_NextItem++; item < numberOfItems; item = m_NextItem++)
+    {
+      (*job)(item);
+    }
+
+    lock.lock();
+    if (--m_ActiveWorkers == 0)
+      m_WorkFinished.notify_all();
+  }
+}
+
+void mitk::BeamformingFilter::StopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_WorkerMutex);
+    m_StopWorkers = true;
+  }
+  m_WorkAvailable.notify_all();
+
+  for (auto& worker : m_Workers)
+  {
+    worker.join();
+  }
+  m_Workers.clear();
+}
+
 void mitk::BeamformingFilter::GenerateInputRequestedRegion()
 {
   Superclass::GenerateInputRequestedRegion();
@@ -107,69 +192,55 @@ void mitk::BeamformingFilter::GenerateData()
 
   if (!m_Conf->GetUseGPU())
   {
-    int progInterval = output->GetDimension(2) / 20 > 1 ? output->GetDimension(2) / 20 : 1;
+    unsigned int numberOfSlices = output->GetDimension(2);
+    unsigned int progInterval = numberOfSlices / 20 > 1 ? numberOfSlices / 20 : 1;
     // the interval at which we update the gui progress bar
 
     float inputDim[2] = { (float)input->GetDimension(0), (float)input->GetDimension(1) };
     float outputDim[2] = { (float)output->GetDimension(0), (float)output->GetDimension(1) };
 
-    for (unsigned int i = 0; i < output->GetDimension(2); ++i) // seperate Slices should get Beamforming seperately applied
-    {
-      mitk::ImageReadAccessor inputReadAccessor(input, input->GetSliceData(i));
-      m_InputData = (float*)inputReadAccessor.GetData();
+    unsigned int lines = output->GetDimension(0);
+    size_t inputSliceSize = (size_t)input->GetDimension(0) * input->GetDimension(1);
+    size_t outputSliceSize = (size_t)lines * output->GetDimension(1);
 
-      m_OutputData = new float[m_Conf->GetReconstructionLines()*m_Conf->GetSamplesPerLine()];
+    void(*beamformLine)(float*, float*, float*, float*, const short&, const mitk::BeamformingSettings::Pointer) = &BeamformingUtils::DASSphericalLine;
+    if (m_Conf->GetAlgorithm() == BeamformingSettings::BeamformingAlgorithm::DMAS)
+      beamformLine = &BeamformingUtils::DMASSphericalLine;
+    else if (m_Conf->GetAlgorithm() == BeamformingSettings::BeamformingAlgorithm::sDMAS)
+      beamformLine = &BeamformingUtils::sDMASSphericalLine;
 
-      // fill the image with zeros
-      for (int l = 0; l < outputDim[0]; ++l)
-      {
-        for (int s = 0; s < outputDim[1]; ++s)
-        {
-          m_OutputData[l*(short)outputDim[1] + s] = 0;
-        }
-      }
+    // the tables are cached in the settings and shared by all lines and slices
+    m_Conf->GetMinMaxLines();
+    m_Conf->GetHorizontalDelays();
+    m_Conf->GetVerticalDelays();
+    m_Conf->GetApodizationTable();
 
-      std::thread *threads = new std::thread[(short)outputDim[0]];
+    mitk::ImageReadAccessor inputReadAccessor(input);
+    float* inputData = (float*)inputReadAccessor.GetData();
 
-      // every line will be beamformed in a seperate thread
-      if (m_Conf->GetAlgorithm() == BeamformingSettings::BeamformingAlgorithm::DAS)
-      {
-        for (short line = 0; line < outputDim[0]; ++line)
-        {
-          threads[line] = std::thread(&BeamformingUtils::DASSphericalLine, m_InputData,
-            m_OutputData, inputDim, outputDim, line, m_Conf);
-        }
-      }
-      else if (m_Conf->GetAlgorithm() == BeamformingSettings::BeamformingAlgorithm::DMAS)
-      {
-        for (short line = 0; line < outputDim[0]; ++line)
-        {
-          threads[line] = std::thread(&BeamformingUtils::DMASSphericalLine, m_InputData,
-            m_OutputData, inputDim, outputDim, line, m_Conf);
-        }
-      }
-      else if (m_Conf->GetAlgorithm() == BeamformingSettings::BeamformingAlgorithm::sDMAS)
-      {
-        for (short line = 0; line < outputDim[0]; ++line)
-        {
-          threads[line] = std::thread(&BeamformingUtils::sDMASSphericalLine, m_InputData,
-            m_OutputData, inputDim, outputDim, line, m_Conf);
-        }
-      }
-      // wait for all lines to finish
-      for (short line = 0; line < outputDim[0]; ++line)
-      {
-        threads[line].join();
-      }
+    // the lines of several slices are beamformed together, so the workers do not wait for the last lines of each slice
+    unsigned int slicesPerBatch = std::min(progInterval, std::max(std::thread::hardware_concurrency(), 1u));
+    std::vector<float> outputData(outputSliceSize * slicesPerBatch);
 
-      output->SetSlice(m_OutputData, i);
+    for (unsigned int firstSlice = 0; firstSlice < numberOfSlices; firstSlice += slicesPerBatch)
+    {
+      unsigned int slicesInBatch = std::min(slicesPerBatch, numberOfSlices - firstSlice);
 
-      if (i % progInterval == 0)
-        m_ProgressHandle((int)((i + 1) / (float)output->GetDimension(2) * 100), "performing reconstruction");
+      this->ParallelFor(slicesInBatch * lines, [&](unsigned int item) {
+        unsigned int slice = item / lines;
+        short line = (short)(item % lines);
+        beamformLine(inputData + (firstSlice + slice) * inputSliceSize, outputData.data() + slice * outputSliceSize,
+          inputDim, outputDim, line, m_Conf);
+      });
+
+      for (unsigned int slice = 0; slice < slicesInBatch; ++slice)
+      {
+        output->SetSlice(outputData.data() + slice * outputSliceSize, firstSlice + slice);
+      }
 
-      delete[] m_OutputData;
-      m_OutputData = nullptr;
-      m_InputData = nullptr;
+      unsigned int finishedSlices = firstSlice + slicesInBatch;
+      if (finishedSlices / progInterval != firstSlice / progInterval)
+        m_ProgressHandle((int)(finishedSlices / (float)numberOfSlices * 100), "performing reconstruction");
     }
   }
 #if defined(PHOTOACOUSTICS_USE_GPU) || DOXYGEN
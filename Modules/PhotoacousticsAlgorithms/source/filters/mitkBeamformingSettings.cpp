@@ -46,7 +46,10 @@ mitk::BeamformingSettings::BeamformingSettings(float pitchInMeters,
   m_Algorithm(algorithm),
   m_Geometry(geometry),
   m_ProbeRadius(probeRadius),
-  m_MinMaxLines(nullptr)
+  m_MinMaxLines(nullptr),
+  m_HorizontalDelays(nullptr),
+  m_VerticalDelays(nullptr),
+  m_ApodizationTable(nullptr)
 {
   if (inputDim == nullptr)
   {
@@ -127,11 +130,39 @@ mitk::BeamformingSettings::~BeamformingSettings()
   }
   if (m_MinMaxLines)
     delete[] m_MinMaxLines;
+  delete[] m_HorizontalDelays;
+  delete[] m_VerticalDelays;
+  delete[] m_ApodizationTable;
 }
 
 unsigned short* mitk::BeamformingSettings::GetMinMaxLines()
 {
+  std::lock_guard<std::mutex> lock(m_TableMutex);
   if (!m_MinMaxLines)
     m_MinMaxLines = mitk::BeamformingUtils::MinMaxLines(this);
   return m_MinMaxLines;
 }
+
+const float* mitk::BeamformingSettings::GetHorizontalDelays()
+{
+  std::lock_guard<std::mutex> lock(m_TableMutex);
+  if (!m_HorizontalDelays)
+    m_HorizontalDelays = mitk::BeamformingUtils::HorizontalDelays(this);
+  return m_HorizontalDelays;
+}
+
+const float* mitk::BeamformingSettings::GetVerticalDelays()
+{
+  std::lock_guard<std::mutex> lock(m_TableMutex);
+  if (!m_VerticalDelays)
+    m_VerticalDelays = mitk::BeamformingUtils::VerticalDelays(this);
+  return m_VerticalDelays;
+}
+
+const float* mitk::BeamformingSettings::GetApodizationTable()
+{
+  std::lock_guard<std::mutex> lock(m_TableMutex);
+  if (!m_ApodizationTable)
+    m_ApodizationTable = mitk::BeamformingUtils::ApodizationTable(this);
+  return m_ApodizationTable;
+}
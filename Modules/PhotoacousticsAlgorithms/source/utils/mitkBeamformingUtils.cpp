@@ -16,6 +16,7 @@ found in the LICENSE file.
 #include <itkImageIOBase.h>
 #include <chrono>
 #include <thread>
+#include <vector>
 #include <itkImageIOBase.h>
 #include "mitkImageCast.h"
 #include "mitkBeamformingUtils.h"
@@ -180,144 +181,232 @@ unsigned short* mitk::BeamformingUtils::MinMaxLines(const mitk::BeamformingSetti
   return dDest;
 }
 
-void mitk::BeamformingUtils::DASSphericalLine(
-  float* input, float* output, float inputDim[2], float outputDim[2],
-  const short& line, const mitk::BeamformingSettings::Pointer config)
+float* mitk::BeamformingUtils::HorizontalDelays(const mitk::BeamformingSettings::Pointer config)
 {
-  const float* apodisation = config->GetApodizationFunction();
-  const short apodArraySize = config->GetApodizationArraySize();
-
-  const float* elementHeights = config->GetElementHeights();
+  const unsigned int outputL = config->GetReconstructionLines();
+  const unsigned int elements = config->GetTransducerElements();
   const float* elementPositions = config->GetElementPositions();
+  const float samplesPerMeter = 1 / (config->GetTimeSpacing() * config->GetSpeedOfSound());
 
-  float& inputS = inputDim[1];
-  float& inputL = inputDim[0];
+  float* delays = new float[outputL * elements];
 
-  float& outputS = outputDim[1];
-  float& outputL = outputDim[0];
+  for (unsigned int line = 0; line < outputL; ++line)
+  {
+    float l_p = (float)line / outputL * config->GetHorizontalExtent();
+    for (unsigned int element = 0; element < elements; ++element)
+    {
+      float distance = samplesPerMeter * (l_p - elementPositions[element]);
+      delays[line * elements + element] = distance * distance;
+    }
+  }
 
-  short AddSample = 0;
-  short maxLine = 0;
-  short minLine = 0;
-  float l_p = 0;
-  float s_i = 0;
+  return delays;
+}
 
-  float apod_mult = 1;
+float* mitk::BeamformingUtils::VerticalDelays(const mitk::BeamformingSettings::Pointer config)
+{
+  const unsigned int elements = config->GetTransducerElements();
+  const float* elementHeights = config->GetElementHeights();
 
-  short usedLines = (maxLine - minLine);
+  float* delays = new float[elements];
 
-  float totalSamples_i = (float)(config->GetReconstructionDepth()) / (float)(config->GetSpeedOfSound() * config->GetTimeSpacing());
-  totalSamples_i = totalSamples_i <= inputS ? totalSamples_i : inputS;
+  for (unsigned int element = 0; element < elements; ++element)
+  {
+    delays[element] = elementHeights[element] / (config->GetSpeedOfSound() * config->GetTimeSpacing());
+  }
 
-  l_p = (float)line / outputL * config->GetHorizontalExtent();
+  return delays;
+}
 
-  for (short sample = 0; sample < outputS; ++sample)
-  {
-    s_i = (float)sample / outputS * totalSamples_i;
+float* mitk::BeamformingUtils::ApodizationTable(const mitk::BeamformingSettings::Pointer config)
+{
+  const unsigned int elements = config->GetTransducerElements();
+  const int apodArraySize = config->GetApodizationArraySize();
+  const float* apodisation = config->GetApodizationFunction();
 
-    minLine = config->GetMinMaxLines()[2*sample*(short)outputL + 2*line];
-    maxLine = config->GetMinMaxLines()[2*sample*(short)outputL + 2*line + 1];
-    usedLines = (maxLine - minLine);
+  float* table = new float[elements * (elements + 1) / 2];
 
-    apod_mult = (float)apodArraySize / (float)usedLines;
+  for (unsigned int usedLines = 1; usedLines <= elements; ++usedLines)
+  {
+    float apod_mult = (float)apodArraySize / (float)usedLines;
+    float* weights = table + usedLines * (usedLines - 1) / 2;
 
-    for (short l_s = minLine; l_s < maxLine; ++l_s)
+    for (unsigned int l = 0; l < usedLines; ++l)
     {
-      AddSample = (int)sqrt(
-        pow(s_i-elementHeights[l_s]/(config->GetSpeedOfSound()*config->GetTimeSpacing()), 2)
-        +
-        pow((1 / (config->GetTimeSpacing()*config->GetSpeedOfSound())) * (l_p - elementPositions[l_s]), 2)
-      ) + (1 - config->GetIsPhotoacousticImage())*s_i;
-      if (AddSample < inputS && AddSample >= 0)
-        output[sample*(short)outputL + line] += input[l_s + AddSample*(short)inputL] *
-        apodisation[(short)((l_s - minLine)*apod_mult)];
-      else
-        --usedLines;
+      weights[l] = apodisation[std::min((int)(l * apod_mult), apodArraySize - 1)];
     }
-    output[sample*(short)outputL + line] = output[sample*(short)outputL + line] / usedLines;
   }
+
+  return table;
 }
 
-void mitk::BeamformingUtils::DMASSphericalLine(
-  float* input, float* output, float inputDim[2], float outputDim[2],
-  const short& line, const mitk::BeamformingSettings::Pointer config)
+namespace
 {
-  const float* apodisation = config->GetApodizationFunction();
-  const short apodArraySize = config->GetApodizationArraySize();
+  /** \brief Gathers the delayed input samples of one reconstruction line from the tables cached in the settings
+  */
+  class DelayedSamples
+  {
+  public:
+    DelayedSamples(const float* input, const float inputDim[2], short line, const mitk::BeamformingSettings::Pointer& config)
+      : m_Input(input),
+        m_InputL((int)inputDim[0]),
+        m_InputS((int)inputDim[1]),
+        m_HorizontalDelays(config->GetHorizontalDelays() + line * config->GetTransducerElements()),
+        m_VerticalDelays(config->GetVerticalDelays()),
+        m_ApodizationTable(config->GetApodizationTable()),
+        m_EchoFactor(1 - config->GetIsPhotoacousticImage()),
+        m_Delays(config->GetTransducerElements()),
+        m_Samples(config->GetTransducerElements())
+    {
+    }
 
-  const float* elementHeights = config->GetElementHeights();
-  const float* elementPositions = config->GetElementPositions();
+    /** \brief Returns the input samples of the elements [minLine, maxLine) for the sample position s_i
+    * Samples whose delay lies outside of the input are set to zero.
+    */
+    const float* Gather(float s_i, unsigned short minLine, unsigned short maxLine)
+    {
+      const int usedLines = maxLine - minLine;
+      const float* horizontal = m_HorizontalDelays + minLine;
+      const float* vertical = m_VerticalDelays + minLine;
+      const float echo = m_EchoFactor * s_i;
+      int* delays = m_Delays.data();
+
+      // the delays of all elements are independent of each other, which allows the compiler to vectorize this loop
+      for (int l = 0; l < usedLines; ++l)
+      {
+        const float v = s_i - vertical[l];
+        delays[l] = (int)((int)std::sqrt(v * v + horizontal[l]) + echo);
+      }
 
-  float& inputS = inputDim[1];
-  float& inputL = inputDim[0];
+      const float* input = m_Input + minLine;
+      float* samples = m_Samples.data();
+      for (int l = 0; l < usedLines; ++l)
+      {
+        samples[l] = (delays[l] < m_InputS && delays[l] >= 0) ? input[l + delays[l] * m_InputL] : 0;
+      }
 
-  float& outputS = outputDim[1];
-  float& outputL = outputDim[0];
+      return samples;
+    }
 
-  short maxLine = 0;
-  short minLine = 0;
-  float l_p = 0;
-  float s_i = 0;
+    /** \brief Number of elements among the first n of the last Gather() call whose delay lies outside of the input
+    */
+    short GetNumberOfInvalidSamples(int n) const
+    {
+      short invalidSamples = 0;
+      for (int l = 0; l < n; ++l)
+      {
+        invalidSamples += (m_Delays[l] >= m_InputS || m_Delays[l] < 0);
+      }
+      return invalidSamples;
+    }
 
-  float apod_mult = 1;
+    /** \brief Apodization weights for the given number of used elements
+    */
+    const float* GetWeights(int usedLines) const
+    {
+      return m_ApodizationTable + usedLines * (usedLines - 1) / 2;
+    }
 
-  float mult = 0;
+  private:
+    const float* m_Input;
+    const int m_InputL;
+    const int m_InputS;
+    const float* m_HorizontalDelays;
+    const float* m_VerticalDelays;
+    const float* m_ApodizationTable;
+    const float m_EchoFactor;
+    std::vector<int> m_Delays;
+    std::vector<float> m_Samples;
+  };
+
+  /** \brief Sum over all products of two different elements as DMAS forms them
+  *
+  * sign(s_1 * s_2) * sqrt(|s_1 * s_2|) equals r_1 * r_2 with r = sign(s) * sqrt(|s|), so the sum over all pairs is
+  * ((sum r)^2 - sum r^2) / 2, which needs a single pass over the elements instead of one per pair.
+  */
+  float SumOfPairs(const float* samples, const float* weights, int usedLines)
+  {
+    double sum = 0;
+    double sumOfSquares = 0;
+    for (int l = 0; l < usedLines; ++l)
+    {
+      const float weighted = samples[l] * weights[l];
+      const float root = std::sqrt(std::fabs(weighted));
+      sum += weighted < 0 ? -root : root;
+      sumOfSquares += std::fabs(weighted);
+    }
+    return (float)((sum * sum - sumOfSquares) / 2);
+  }
+}
 
-  short usedLines = (maxLine - minLine);
+void mitk::BeamformingUtils::DASSphericalLine(
+  float* input, float* output, float inputDim[2], float outputDim[2],
+  const short& line, const mitk::BeamformingSettings::Pointer config)
+{
+  const unsigned short* minMaxLines = config->GetMinMaxLines();
+  DelayedSamples delayedSamples(input, inputDim, line, config);
 
-  float totalSamples_i = (float)(config->GetReconstructionDepth()) /
-    (float)(config->GetSpeedOfSound() * config->GetTimeSpacing());
-  totalSamples_i = totalSamples_i <= inputS ? totalSamples_i : inputS;
+  float& inputS = inputDim[1];
+
+  short outputS = (short)outputDim[1];
+  short outputL = (short)outputDim[0];
 
-  l_p = (float)line / outputL * config->GetHorizontalExtent();
+  float totalSamples_i = (float)(config->GetReconstructionDepth()) / (float)(config->GetSpeedOfSound() * config->GetTimeSpacing());
+  totalSamples_i = totalSamples_i <= inputS ? totalSamples_i : inputS;
 
   for (short sample = 0; sample < outputS; ++sample)
   {
-    s_i = (float)sample / outputS * totalSamples_i;
+    float s_i = (float)sample / outputS * totalSamples_i;
 
-    minLine = config->GetMinMaxLines()[2 * sample*(short)outputL + 2 * line];
-    maxLine = config->GetMinMaxLines()[2 * sample*(short)outputL + 2 * line + 1];
-    usedLines = (maxLine - minLine);
+    unsigned short minLine = minMaxLines[2 * sample * outputL + 2 * line];
+    unsigned short maxLine = minMaxLines[2 * sample * outputL + 2 * line + 1];
+    short usedLines = (maxLine - minLine);
 
-    apod_mult = (float)apodArraySize / (float)usedLines;
+    const float* samples = delayedSamples.Gather(s_i, minLine, maxLine);
+    const float* weights = delayedSamples.GetWeights(usedLines);
 
-    //calculate the AddSamples beforehand to save some time
-    short* AddSample = new short[maxLine - minLine];
-    for (short l_s = 0; l_s < maxLine - minLine; ++l_s)
+    float sum = 0;
+    for (short l = 0; l < maxLine - minLine; ++l)
     {
-      AddSample[l_s] = (int)sqrt(
-        pow(s_i - elementHeights[l_s + minLine] / (config->GetSpeedOfSound()*config->GetTimeSpacing()), 2)
-        +
-        pow((1 / (config->GetTimeSpacing()*config->GetSpeedOfSound())) * (l_p - elementPositions[l_s + minLine]), 2)
-      ) + (1 - config->GetIsPhotoacousticImage())*s_i;
+      sum += samples[l] * weights[l];
     }
+    usedLines -= delayedSamples.GetNumberOfInvalidSamples(maxLine - minLine);
 
-    float s_1 = 0;
-    float s_2 = 0;
+    output[sample * outputL + line] = sum / usedLines;
+  }
+}
 
-    for (short l_s1 = minLine; l_s1 < maxLine - 1; ++l_s1)
-    {
-      if (AddSample[l_s1 - minLine] < inputS && AddSample[l_s1 - minLine] >= 0)
-      {
-        for (short l_s2 = l_s1 + 1; l_s2 < maxLine; ++l_s2)
-        {
-          if (AddSample[l_s2 - minLine] < inputS && AddSample[l_s2 - minLine] >= 0)
-          {
-            s_2 = input[l_s2 + AddSample[l_s2 - minLine] * (short)inputL];
-            s_1 = input[l_s1 + AddSample[l_s1 - minLine] * (short)inputL];
+void mitk::BeamformingUtils::DMASSphericalLine(
+  float* input, float* output, float inputDim[2], float outputDim[2],
+  const short& line, const mitk::BeamformingSettings::Pointer config)
+{
+  const unsigned short* minMaxLines = config->GetMinMaxLines();
+  DelayedSamples delayedSamples(input, inputDim, line, config);
 
-            mult = s_2 * apodisation[(int)((l_s2 - minLine)*apod_mult)] * s_1 * apodisation[(int)((l_s1 - minLine)*apod_mult)];
-            output[sample*(short)outputL + line] += sqrt(fabs(mult)) * ((mult > 0) - (mult < 0));
-          }
-        }
-      }
-      else
-        --usedLines;
-    }
+  float& inputS = inputDim[1];
+
+  short outputS = (short)outputDim[1];
+  short outputL = (short)outputDim[0];
+
+  float totalSamples_i = (float)(config->GetReconstructionDepth()) /
+    (float)(config->GetSpeedOfSound() * config->GetTimeSpacing());
+  totalSamples_i = totalSamples_i <= inputS ? totalSamples_i : inputS;
+
+  for (short sample = 0; sample < outputS; ++sample)
+  {
+    float s_i = (float)sample / outputS * totalSamples_i;
 
-    output[sample*(short)outputL + line] = output[sample*(short)outputL + line] / (float)(pow(usedLines, 2) - (usedLines - 1));
+    unsigned short minLine = minMaxLines[2 * sample * outputL + 2 * line];
+    unsigned short maxLine = minMaxLines[2 * sample * outputL + 2 * line + 1];
+    short usedLines = (maxLine - minLine);
 
-    delete[] AddSample;
+    const float* samples = delayedSamples.Gather(s_i, minLine, maxLine);
+    float sum = SumOfPairs(samples, delayedSamples.GetWeights(usedLines), usedLines);
+
+    // the last element is never the first factor of a pair and therefore never counted as unused
+    usedLines -= delayedSamples.GetNumberOfInvalidSamples(maxLine - minLine - 1);
+
+    output[sample * outputL + line] = sum / (float)(pow(usedLines, 2) - (usedLines - 1));
   }
 }
 
@@ -325,84 +414,37 @@ void mitk::BeamformingUtils::sDMASSphericalLine(
   float* input, float* output, float inputDim[2], float outputDim[2],
   const short& line, const mitk::BeamformingSettings::Pointer config)
 {
-  const float* apodisation = config->GetApodizationFunction();
-  const short apodArraySize = config->GetApodizationArraySize();
-
-  const float* elementHeights = config->GetElementHeights();
-  const float* elementPositions = config->GetElementPositions();
+  const unsigned short* minMaxLines = config->GetMinMaxLines();
+  DelayedSamples delayedSamples(input, inputDim, line, config);
 
   float& inputS = inputDim[1];
-  float& inputL = inputDim[0];
-
-  float& outputS = outputDim[1];
-  float& outputL = outputDim[0];
-
-  short maxLine = 0;
-  short minLine = 0;
-  float l_p = 0;
-  float s_i = 0;
-
-  float apod_mult = 1;
-
-  float mult = 0;
 
-  short usedLines = (maxLine - minLine);
+  short outputS = (short)outputDim[1];
+  short outputL = (short)outputDim[0];
 
   float totalSamples_i = (float)(config->GetReconstructionDepth()) /
     (float)(config->GetSpeedOfSound() * config->GetTimeSpacing());
   totalSamples_i = totalSamples_i <= inputS ? totalSamples_i : inputS;
 
-  l_p = (float)line / outputL * config->GetHorizontalExtent();
-
   for (short sample = 0; sample < outputS; ++sample)
   {
-    s_i = (float)sample / outputS * totalSamples_i;
-
-    minLine = config->GetMinMaxLines()[2 * sample*(short)outputL + 2 * line];
-    maxLine = config->GetMinMaxLines()[2 * sample*(short)outputL + 2 * line + 1];
-    usedLines = (maxLine - minLine);
+    float s_i = (float)sample / outputS * totalSamples_i;
 
-    apod_mult = (float)apodArraySize / (float)usedLines;
+    unsigned short minLine = minMaxLines[2 * sample * outputL + 2 * line];
+    unsigned short maxLine = minMaxLines[2 * sample * outputL + 2 * line + 1];
+    short usedLines = (maxLine - minLine);
 
-    //calculate the AddSamples beforehand to save some time
-    short* AddSample = new short[maxLine - minLine];
-    for (short l_s = 0; l_s < maxLine - minLine; ++l_s)
-    {
-      AddSample[l_s] = (int)sqrt(
-        pow(s_i - elementHeights[l_s + minLine] / (config->GetSpeedOfSound()*config->GetTimeSpacing()), 2)
-        +
-        pow((1 / (config->GetTimeSpacing()*config->GetSpeedOfSound())) * (l_p - elementPositions[l_s + minLine]), 2)
-      ) + (1 - config->GetIsPhotoacousticImage())*s_i;
-    }
+    const float* samples = delayedSamples.Gather(s_i, minLine, maxLine);
+    float sum = SumOfPairs(samples, delayedSamples.GetWeights(usedLines), usedLines);
 
-    float s_1 = 0;
-    float s_2 = 0;
     float sign = 0;
-
-    for (short l_s1 = minLine; l_s1 < maxLine - 1; ++l_s1)
+    for (short l = 0; l < maxLine - minLine - 1; ++l)
     {
-      if (AddSample[l_s1 - minLine] < inputS && AddSample[l_s1 - minLine] >= 0)
-      {
-        s_1 = input[l_s1 + AddSample[l_s1 - minLine] * (short)inputL];
-        sign += s_1;
-
-        for (short l_s2 = l_s1 + 1; l_s2 < maxLine; ++l_s2)
-        {
-          if (AddSample[l_s2 - minLine] < inputS && AddSample[l_s2 - minLine] >= 0)
-          {
-            s_2 = input[l_s2 + AddSample[l_s2 - minLine] * (short)inputL];
-
-            mult = s_2 * apodisation[(int)((l_s2 - minLine)*apod_mult)] * s_1 * apodisation[(int)((l_s1 - minLine)*apod_mult)];
-            output[sample*(short)outputL + line] += sqrt(fabs(mult)) * ((mult > 0) - (mult < 0));
-          }
-        }
-      }
-      else
-        --usedLines;
+      sign += samples[l];
     }
 
-    output[sample*(short)outputL + line] = output[sample*(short)outputL + line] / (float)(pow(usedLines, 2) - (usedLines - 1)) * ((sign > 0) - (sign < 0));
+    usedLines -= delayedSamples.GetNumberOfInvalidSamples(maxLine - minLine - 1);
 
-    delete[] AddSample;
+    output[sample * outputL + line] = sum / (float)(pow(usedLines, 2) - (usedLines - 1)) * ((sign > 0) - (sign < 0));
   }
 }
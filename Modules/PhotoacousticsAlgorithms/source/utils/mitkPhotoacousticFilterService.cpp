@@ -246,12 +246,15 @@ mitk::Image::Pointer mitk::PhotoacousticFilterService::ApplyBeamforming(
     processedImage = inputImage;
   }
 
-  m_BeamformingFilter = mitk::BeamformingFilter::New(config);
+  // the filter is kept for calls with the same settings, so its worker threads and cached tables are reused
+  if (m_BeamformingFilter.IsNull() || m_BeamformingFilter->GetConfiguration() != config)
+    m_BeamformingFilter = mitk::BeamformingFilter::New(config);
   m_BeamformingFilter->SetInput(ConvertToFloat(processedImage));
   m_BeamformingFilter->SetProgressHandle(progressHandle);
   m_BeamformingFilter->UpdateLargestPossibleRegion();
 
   processedImage = m_BeamformingFilter->GetOutput();
+  processedImage->DisconnectPipeline();
 
   return processedImage;
 }
@@ -17,5 +17,6 @@ set(MODULE_TESTS
   mitkPAFilterServiceTest.cpp
   mitkCastToFloatImageFilterTest.cpp
   mitkCropImageFilterTest.cpp
+  mitkBeamformingFilterBenchmarkTest.cpp
   )
 set(RESOURCE_FILES)
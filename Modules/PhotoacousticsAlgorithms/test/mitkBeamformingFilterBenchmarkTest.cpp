@@ -0,0 +1,261 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+#include <mitkImage.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkBeamformingFilter.h>
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+/**
+  Compares the CPU beamforming of mitk::BeamformingFilter with a straightforward reference implementation and
+  reports the throughput in frames per second for all algorithms, both for volumes of several frames and for
+  repeated updates of single frames as in real-time reconstruction.
+*/
+class mitkBeamformingFilterBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkBeamformingFilterBenchmarkTestSuite);
+  MITK_TEST(testDASMatchesReference);
+  MITK_TEST(testDMASMatchesReference);
+  MITK_TEST(testSlicesAreBeamformedIndependently);
+  MITK_TEST(testThroughput);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  const unsigned int SAMPLES = 1024;
+  const unsigned int ELEMENTS = 64;
+  const unsigned int RECONSTRUCTED_SAMPLES = 256;
+  const unsigned int RECONSTRUCTED_LINES = 64;
+  const unsigned int FRAMES = 16;
+  const float SPEED_OF_SOUND = 1540; // m/s
+  const float SPACING_X = 0.3f / 1000; // m
+  const float SPACING_Y = 0.0125f / 1000000; // s
+
+  std::vector<float> m_Frame;
+
+public:
+  void setUp() override
+  {
+    // three point sources with a bipolar signal
+    m_Frame.assign(ELEMENTS * SAMPLES, 0.f);
+    const float sources[3][2] = { { 0.004f, 15 }, { 0.007f, 32 }, { 0.011f, 50 } };
+    for (const auto& source : sources)
+    {
+      for (unsigned int x = 0; x < ELEMENTS; ++x)
+      {
+        float distance = std::abs((float)x - source[1]) * SPACING_X;
+        int delay = (int)std::round(std::sqrt(source[0] * source[0] + distance * distance) / SPEED_OF_SOUND / SPACING_Y);
+        for (int index = -3; index < 3; ++index)
+        {
+          if (delay + index >= 0 && delay + index < (int)SAMPLES)
+            m_Frame[x + (delay + index) * ELEMENTS] += (index < 0 ? 1000.f : -1000.f) / std::sqrt(std::abs((float)x - source[1]) + 1);
+        }
+      }
+    }
+  }
+
+  void tearDown() override
+  {
+    m_Frame.clear();
+  }
+
+  mitk::BeamformingSettings::Pointer CreateSettings(unsigned int frames, mitk::BeamformingSettings::BeamformingAlgorithm algorithm)
+  {
+    unsigned int inputDim[3] = { ELEMENTS, SAMPLES, frames };
+    return mitk::BeamformingSettings::New(SPACING_X,
+      SPEED_OF_SOUND,
+      SPACING_Y,
+      27.f,
+      true,
+      RECONSTRUCTED_SAMPLES,
+      RECONSTRUCTED_LINES,
+      inputDim,
+      SPEED_OF_SOUND * SPACING_Y * SAMPLES,
+      false,
+      16,
+      mitk::BeamformingSettings::Apodization::Hann,
+      ELEMENTS * 2,
+      algorithm,
+      mitk::BeamformingSettings::ProbeGeometry::Linear,
+      0);
+  }
+
+  mitk::Image::Pointer CreateInput(unsigned int frames)
+  {
+    std::vector<float> data;
+    for (unsigned int frame = 0; frame < frames; ++frame)
+      data.insert(data.end(), m_Frame.begin(), m_Frame.end());
+
+    mitk::Image::Pointer image = mitk::Image::New();
+    unsigned int dimension[3] = { ELEMENTS, SAMPLES, frames };
+    image->Initialize(mitk::MakeScalarPixelType<float>(), 3, dimension);
+    image->SetImportVolume(data.data(), 0, 0, mitk::Image::CopyMemory);
+    return image;
+  }
+
+  /** Beamforming of the first frame as the filter did it before, computing all delays and pairs explicitly. */
+  std::vector<float> BeamformReference(mitk::BeamformingSettings::Pointer config)
+  {
+    const float* apodisation = config->GetApodizationFunction();
+    const float* elementPositions = config->GetElementPositions();
+    const unsigned short* minMaxLines = config->GetMinMaxLines();
+    const double samplesPerMeter = 1 / (config->GetTimeSpacing() * config->GetSpeedOfSound());
+    const bool isDAS = config->GetAlgorithm() == mitk::BeamformingSettings::BeamformingAlgorithm::DAS;
+
+    double totalSamples = std::min(config->GetReconstructionDepth() * samplesPerMeter, (double)SAMPLES);
+
+    std::vector<float> output(RECONSTRUCTED_LINES * RECONSTRUCTED_SAMPLES, 0.f);
+    for (unsigned int line = 0; line < RECONSTRUCTED_LINES; ++line)
+    {
+      double l_p = (double)line / RECONSTRUCTED_LINES * config->GetHorizontalExtent();
+      for (unsigned int sample = 0; sample < RECONSTRUCTED_SAMPLES; ++sample)
+      {
+        double s_i = (double)sample / RECONSTRUCTED_SAMPLES * totalSamples;
+        int minLine = minMaxLines[2 * sample * RECONSTRUCTED_LINES + 2 * line];
+        int maxLine = minMaxLines[2 * sample * RECONSTRUCTED_LINES + 2 * line + 1];
+        int usedLines = maxLine - minLine;
+        double apod_mult = (double)config->GetApodizationArraySize() / usedLines;
+
+        std::vector<double> weighted;
+        std::vector<bool> valid;
+        for (int l_s = minLine; l_s < maxLine; ++l_s)
+        {
+          int delay = (int)std::sqrt(s_i * s_i + std::pow(samplesPerMeter * (l_p - elementPositions[l_s]), 2));
+          valid.push_back(delay >= 0 && delay < (int)SAMPLES);
+          weighted.push_back(valid.back() ? m_Frame[l_s + delay * ELEMENTS] * apodisation[(int)((l_s - minLine) * apod_mult)] : 0.);
+        }
+
+        double result = 0;
+        if (isDAS)
+        {
+          int unused = 0;
+          for (int l = 0; l < usedLines; ++l)
+          {
+            result += weighted[l];
+            unused += !valid[l];
+          }
+          result /= usedLines - unused;
+        }
+        else
+        {
+          int unused = 0;
+          for (int l1 = 0; l1 < usedLines - 1; ++l1)
+          {
+            unused += !valid[l1];
+            for (int l2 = l1 + 1; l2 < usedLines; ++l2)
+            {
+              double mult = weighted[l1] * weighted[l2];
+              result += std::sqrt(std::fabs(mult)) * ((mult > 0) - (mult < 0));
+            }
+          }
+          usedLines -= unused;
+          result /= usedLines * usedLines - (usedLines - 1);
+        }
+        output[sample * RECONSTRUCTED_LINES + line] = (float)result;
+      }
+    }
+    return output;
+  }
+
+  void CompareWithReference(mitk::BeamformingSettings::BeamformingAlgorithm algorithm)
+  {
+    auto config = CreateSettings(1, algorithm);
+    auto filter = mitk::BeamformingFilter::New(config);
+    filter->SetInput(CreateInput(1));
+    filter->Update();
+
+    std::vector<float> reference = BeamformReference(config);
+    mitk::ImageReadAccessor readAccess(filter->GetOutput());
+    const float* output = (const float*)readAccess.GetData();
+
+    float maximum = 0;
+    for (float value : reference)
+      maximum = std::max(maximum, std::fabs(value));
+    CPPUNIT_ASSERT(maximum > 0);
+
+    // delays are truncated to whole samples; single-precision delays may round to the neighboring sample at a few positions
+    unsigned int differences = 0;
+    for (size_t i = 0; i < reference.size(); ++i)
+    {
+      if (std::fabs(output[i] - reference[i]) > 1e-3f * maximum)
+        ++differences;
+    }
+    CPPUNIT_ASSERT_MESSAGE(std::to_string(differences) + " of " + std::to_string(reference.size()) + " pixels differ from the reference",
+      differences < reference.size() / 200);
+  }
+
+  void testDASMatchesReference()
+  {
+    CompareWithReference(mitk::BeamformingSettings::BeamformingAlgorithm::DAS);
+  }
+
+  void testDMASMatchesReference()
+  {
+    CompareWithReference(mitk::BeamformingSettings::BeamformingAlgorithm::DMAS);
+  }
+
+  void testSlicesAreBeamformedIndependently()
+  {
+    auto filter = mitk::BeamformingFilter::New(CreateSettings(FRAMES, mitk::BeamformingSettings::BeamformingAlgorithm::sDMAS));
+    filter->SetInput(CreateInput(FRAMES));
+    filter->Update();
+
+    mitk::ImageReadAccessor readAccess(filter->GetOutput());
+    const float* output = (const float*)readAccess.GetData();
+    const size_t sliceSize = RECONSTRUCTED_LINES * RECONSTRUCTED_SAMPLES;
+
+    for (unsigned int frame = 1; frame < FRAMES; ++frame)
+    {
+      for (size_t i = 0; i < sliceSize; ++i)
+      {
+        CPPUNIT_ASSERT_EQUAL(output[i], output[frame * sliceSize + i]);
+      }
+    }
+  }
+
+  void testThroughput()
+  {
+    const mitk::BeamformingSettings::BeamformingAlgorithm algorithms[] = { mitk::BeamformingSettings::BeamformingAlgorithm::DAS,
+      mitk::BeamformingSettings::BeamformingAlgorithm::DMAS, mitk::BeamformingSettings::BeamformingAlgorithm::sDMAS };
+    const char* names[] = { "DAS", "DMAS", "sDMAS" };
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      auto volumeFilter = mitk::BeamformingFilter::New(CreateSettings(FRAMES, algorithms[i]));
+      volumeFilter->SetInput(CreateInput(FRAMES));
+      auto start = std::chrono::steady_clock::now();
+      volumeFilter->Update();
+      double volumeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      // one update per frame with the same filter, as a live reconstruction does it
+      auto frameFilter = mitk::BeamformingFilter::New(CreateSettings(1, algorithms[i]));
+      start = std::chrono::steady_clock::now();
+      for (unsigned int frame = 0; frame < FRAMES; ++frame)
+      {
+        frameFilter->SetInput(CreateInput(1));
+        frameFilter->Update();
+      }
+      double frameSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      CPPUNIT_ASSERT_EQUAL(FRAMES, volumeFilter->GetOutput()->GetDimension(2));
+      MITK_INFO << names[i] << " beamforming of " << ELEMENTS << "x" << SAMPLES << " frames to " << RECONSTRUCTED_LINES << "x"
+                << RECONSTRUCTED_SAMPLES << ": " << FRAMES / volumeSeconds << " fps as volume, " << FRAMES / frameSeconds
+                << " fps frame by frame";
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkBeamformingFilterBenchmark)
@@ -91,7 +91,18 @@ namespace mitk {
       Eigen::VectorXf SpectralUnmixingAlgorithm(Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic> endmemberMatrix,
         Eigen::VectorXf inputVector) override;
 
+      /**
+      * \brief overrides the baseclass method to decompose the endmember matrix only once with the algorithm set by "SetAlgorithm".
+      * The decomposition then solves for blocks of pixels as right-hand side matrices on several threads.
+      * @throws if the algorithmName is not a member of the enum AlgortihmType
+      * @throws if one chooses the ldlt/llt solver and the endmember matrix is not positive definite
+      */
+      void UnmixPixels(const Eigen::MatrixXf& endmemberMatrix, const Eigen::MatrixXf& inputMatrix, Eigen::MatrixXf& resultMatrix) override;
+
     private:
+      template <typename TDecomposition>
+      void Solve(const TDecomposition& decomposition, const Eigen::MatrixXf& inputMatrix, Eigen::MatrixXf& resultMatrix) const;
+
       AlgortihmType algorithmName;
     };
   }
@@ -24,6 +24,8 @@ found in the LICENSE file.
 #include "mitkPAPropertyCalculator.h"
 #include <eigen3/Eigen/Dense>
 
+#include <functional>
+
 namespace mitk {
   namespace pa {
     /**
@@ -126,6 +128,23 @@ namespace mitk {
       virtual Eigen::VectorXf SpectralUnmixingAlgorithm(Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic> endmemberMatrix,
         Eigen::VectorXf inputVector) = 0;
 
+      /**
+      * \brief Calculates the spectral unmixing results of many pixels at once.
+      * The default implementation calls "SpectralUnmixingAlgorithm" for every pixel, distributing the pixels to several threads.
+      * Subclasses can override it to share work between the pixels, e.g. to decompose the endmember matrix only once.
+      * @param endmemberMatrix Matrix with number of chromophores colums and number of wavelengths rows (see SpectralUnmixingAlgorithm)
+      * @param inputMatrix Matrix with number of wavelengths rows and one column per pixel containing its multispectral values
+      * @param resultMatrix is resized to number of chromophores rows and one column per pixel containing its unmixing result
+      * @throws if the algorithm fails for any pixel
+      */
+      virtual void UnmixPixels(const Eigen::MatrixXf& endmemberMatrix, const Eigen::MatrixXf& inputMatrix, Eigen::MatrixXf& resultMatrix);
+
+      /**
+      * \brief Calls job for consecutive ranges [begin, end) of pixels covering [0, numberOfPixels) on several threads and waits for them.
+      * @throws the first exception thrown by job; the remaining ranges are skipped then
+      */
+      void ParallelFor(unsigned int numberOfPixels, const std::function<void(unsigned int begin, unsigned int end)>& job) const;
+
       bool m_Verbose = false;
       bool m_RelativeError = false;
 
@@ -154,8 +173,8 @@ namespace mitk {
 
       /*
       * \brief Inherit from the "ImageToImageFilter" Superclass. Herain it calls InitializeOutputs, CalculateEndmemberMatrix and
-      * CheckPreConditions methods and enables pixelwise access to do spectral unmixing with the "SpectralUnmixingAlgorithm"
-      * method. In the end the method writes the results into the new MITK output images.
+      * CheckPreConditions methods and collects the pixels of all sequences to do spectral unmixing with the "UnmixPixels"
+      * method in one go. In the end the method writes the results into the new MITK output images.
       */
       void GenerateData() override;
 
@@ -179,13 +198,13 @@ namespace mitk {
       virtual float PropertyElement(mitk::pa::PropertyCalculator::ChromophoreType, int wavelength);
 
       /*
-      * \brief calculates the relative error between the input image and the unmixing result in the L2 norm
+      * \brief calculates the relative error between the input image and the unmixing result in the L2 norm for every pixel
       * @param endmemberMatrix is a Eigen matrix containing the endmember information
-      * @param inputVector is a Eigen vector containing the multispectral information of one pixel
-      * @param resultVector is a Eigen vector containing the spectral unmmixing result
+      * @param inputMatrix is a Eigen matrix containing the multispectral information of one pixel per column
+      * @param resultMatrix is a Eigen matrix containing the spectral unmmixing result of one pixel per column
       */
-      float CalculateRelativeError(Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic> endmemberMatrix,
-        Eigen::VectorXf inputVector, Eigen::VectorXf resultVector);
+      Eigen::RowVectorXf CalculateRelativeError(const Eigen::MatrixXf& endmemberMatrix,
+        const Eigen::MatrixXf& inputMatrix, const Eigen::MatrixXf& resultMatrix);
 
       PropertyCalculator::Pointer m_PropertyCalculatorEigen;
     };
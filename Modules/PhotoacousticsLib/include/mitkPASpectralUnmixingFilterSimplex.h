@@ -16,6 +16,8 @@ found in the LICENSE file.
 #include <mitkPASpectralUnmixingFilterBase.h>
 #include <MitkPhotoacousticsLibExports.h>
 
+#include <mutex>
+
 namespace mitk {
   namespace pa {
     class MITKPHOTOACOUSTICSLIB_EXPORT SpectralUnmixingFilterSimplex : public SpectralUnmixingFilterBase
@@ -43,6 +45,9 @@ namespace mitk {
       virtual Eigen::VectorXf Normalization(Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic> EndmemberMatrix,
         Eigen::VectorXf inputVector);
 
+      // pixels are unmixed on several threads, which all write to myfile
+      std::mutex m_FileMutex;
+
     };
   }
 }
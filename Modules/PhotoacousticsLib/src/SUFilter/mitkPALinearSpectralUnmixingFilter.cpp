@@ -78,3 +78,59 @@ Eigen::VectorXf mitk::pa::LinearSpectralUnmixingFilter::SpectralUnmixingAlgorith
 
   return resultVector;
 }
+
+void mitk::pa::LinearSpectralUnmixingFilter::UnmixPixels(const Eigen::MatrixXf& endmemberMatrix,
+  const Eigen::MatrixXf& inputMatrix, Eigen::MatrixXf& resultMatrix)
+{
+  resultMatrix.resize(endmemberMatrix.cols(), inputMatrix.cols());
+
+  if (mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::HOUSEHOLDERQR == algorithmName)
+    Solve(endmemberMatrix.householderQr(), inputMatrix, resultMatrix);
+
+  else if (mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::LDLT == algorithmName)
+  {
+    Eigen::LLT<Eigen::MatrixXf> lltOfA(endmemberMatrix);
+    if (lltOfA.info() == Eigen::NumericalIssue)
+    {
+      mitkThrow() << "Possibly non semi-positive definitie endmembermatrix!";
+    }
+    else
+      Solve(endmemberMatrix.ldlt(), inputMatrix, resultMatrix);
+  }
+
+  else if (mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::LLT == algorithmName)
+  {
+    Eigen::LLT<Eigen::MatrixXf> lltOfA(endmemberMatrix);
+    if (lltOfA.info() == Eigen::NumericalIssue)
+    {
+      mitkThrow() << "Possibly non semi-positive definitie endmembermatrix!";
+    }
+    else
+      Solve(lltOfA, inputMatrix, resultMatrix);
+  }
+
+  else if (mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::COLPIVHOUSEHOLDERQR == algorithmName)
+    Solve(endmemberMatrix.colPivHouseholderQr(), inputMatrix, resultMatrix);
+
+  else if (mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::JACOBISVD == algorithmName)
+    Solve(endmemberMatrix.jacobiSvd(Eigen::ComputeFullU | Eigen::ComputeFullV), inputMatrix, resultMatrix);
+
+  else if (mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::FULLPIVLU == algorithmName)
+    Solve(endmemberMatrix.fullPivLu(), inputMatrix, resultMatrix);
+
+  else if (mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::FULLPIVHOUSEHOLDERQR == algorithmName)
+    Solve(endmemberMatrix.fullPivHouseholderQr(), inputMatrix, resultMatrix);
+  else
+    mitkThrow() << "404 VIGRA ALGORITHM NOT FOUND";
+}
+
+template <typename TDecomposition>
+void mitk::pa::LinearSpectralUnmixingFilter::Solve(const TDecomposition& decomposition,
+  const Eigen::MatrixXf& inputMatrix, Eigen::MatrixXf& resultMatrix) const
+{
+  // solving for a block of pixels at once is a matrix-matrix operation; the decomposition is only read by the threads
+  ParallelFor(inputMatrix.cols(), [&](unsigned int begin, unsigned int end)
+  {
+    resultMatrix.middleCols(begin, end - begin) = decomposition.solve(inputMatrix.middleCols(begin, end - begin));
+  });
+}
@@ -20,6 +20,12 @@ found in the LICENSE file.
 #include <mitkImageReadAccessor.h>
 #include <mitkImageWriteAccessor.h>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 mitk::pa::SpectralUnmixingFilterBase::SpectralUnmixingFilterBase()
 {
   m_PropertyCalculatorEigen = mitk::pa::PropertyCalculator::New();
@@ -110,46 +116,91 @@ void mitk::pa::SpectralUnmixingFilterBase::GenerateData()
     outputCounter -= 1;
   }
 
+  /**
+  * Every column of the input matrix contains the multispectral values of one pixel. The pixels of all sequences are
+  * unmixed together, and their column index equals their position in the output images.
+  */
+  unsigned int pixelsPerImage = xDim * yDim;
+  unsigned int numberOfPixels = pixelsPerImage * totalNumberOfSequences;
+  Eigen::MatrixXf inputMatrix(sequenceSize, numberOfPixels);
   for (unsigned int sequenceCounter = 0; sequenceCounter < totalNumberOfSequences; ++sequenceCounter)
   {
-    MITK_INFO(m_Verbose) << "SequenceCounter: " << sequenceCounter;
-    //loop over every pixel in XY-plane
-    for (unsigned int x = 0; x < xDim; x++)
+    for (unsigned int z = 0; z < sequenceSize; z++)
     {
-      for (unsigned int y = 0; y < yDim; y++)
-      {
-        Eigen::VectorXf inputVector(sequenceSize);
-        for (unsigned int z = 0; z < sequenceSize; z++)
-        {
-          /**
-          * 'sequenceCounter*sequenceSize' has to be added to 'z' to ensure that one accesses the
-          * correct pixel, because the inputDataArray contains the information of all sequences and
-          * not just the one of the current sequence.
-          */
-          unsigned int pixelNumber = (xDim*yDim*(z+sequenceCounter*sequenceSize)) + x * yDim + y;
-          auto pixel = inputDataArray[pixelNumber];
-
-          inputVector[z] = pixel;
-        }
-        Eigen::VectorXf resultVector = SpectralUnmixingAlgorithm(endmemberMatrix, inputVector);
-
-        if (m_RelativeError == true)
-        {
-          float relativeError = CalculateRelativeError(endmemberMatrix, inputVector, resultVector);
-          writteBufferVector[outputCounter][(xDim*yDim * sequenceCounter) + x * yDim + y] = relativeError;
-        }
-
-        for (unsigned int outputIdx = 0; outputIdx < outputCounter; ++outputIdx)
-        {
-          writteBufferVector[outputIdx][(xDim*yDim * sequenceCounter) + x * yDim + y] = resultVector[outputIdx];
-        }
-      }
+      inputMatrix.row(z).segment(pixelsPerImage * sequenceCounter, pixelsPerImage) =
+        Eigen::Map<const Eigen::RowVectorXf>(inputDataArray + pixelsPerImage * (z + sequenceCounter * sequenceSize), pixelsPerImage);
     }
   }
+
+  Eigen::MatrixXf resultMatrix;
+  UnmixPixels(endmemberMatrix, inputMatrix, resultMatrix);
+
+  if (m_RelativeError == true)
+  {
+    Eigen::Map<Eigen::RowVectorXf>(writteBufferVector[outputCounter], numberOfPixels) =
+      CalculateRelativeError(endmemberMatrix, inputMatrix, resultMatrix);
+  }
+
+  for (unsigned int outputIdx = 0; outputIdx < outputCounter; ++outputIdx)
+  {
+    Eigen::Map<Eigen::RowVectorXf>(writteBufferVector[outputIdx], numberOfPixels) = resultMatrix.row(outputIdx);
+  }
+
   MITK_INFO(m_Verbose) << "GENERATING DATA...[DONE]";
   myfile.close();
 }
 
+void mitk::pa::SpectralUnmixingFilterBase::UnmixPixels(const Eigen::MatrixXf& endmemberMatrix,
+  const Eigen::MatrixXf& inputMatrix, Eigen::MatrixXf& resultMatrix)
+{
+  resultMatrix.resize(endmemberMatrix.cols(), inputMatrix.cols());
+
+  ParallelFor(inputMatrix.cols(), [&](unsigned int begin, unsigned int end)
+  {
+    for (unsigned int pixel = begin; pixel < end; ++pixel)
+      resultMatrix.col(pixel) = SpectralUnmixingAlgorithm(endmemberMatrix, inputMatrix.col(pixel));
+  });
+}
+
+void mitk::pa::SpectralUnmixingFilterBase::ParallelFor(unsigned int numberOfPixels,
+  const std::function<void(unsigned int begin, unsigned int end)>& job) const
+{
+  const unsigned int blockSize = 1024;
+  unsigned int numberOfBlocks = (numberOfPixels + blockSize - 1) / blockSize;
+  unsigned int numberOfThreads = std::min(std::max(std::thread::hardware_concurrency(), 1u), numberOfBlocks);
+
+  std::atomic<unsigned int> nextBlock(0);
+  std::exception_ptr exception;
+  std::mutex exceptionMutex;
+
+  auto worker = [&]()
+  {
+    try
+    {
+      for (unsigned int block = nextBlock++; block < numberOfBlocks; block = nextBlock++)
+        job(block * blockSize, std::min(numberOfPixels, (block + 1) * blockSize));
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(exceptionMutex);
+      if (!exception)
+        exception = std::current_exception();
+      nextBlock = numberOfBlocks;
+    }
+  };
+
+  // the calling thread processes blocks as well
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < numberOfThreads; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (auto& thread : threads)
+    thread.join();
+
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
 void mitk::pa::SpectralUnmixingFilterBase::CheckPreConditions(mitk::Image::Pointer input)
 {
   MITK_INFO(m_Verbose) << "CHECK PRECONDITIONS ...";
@@ -222,14 +273,21 @@ float mitk::pa::SpectralUnmixingFilterBase::PropertyElement(mitk::pa::PropertyCa
   }
 }
 
-float mitk::pa::SpectralUnmixingFilterBase::CalculateRelativeError(Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic> endmemberMatrix,
-  Eigen::VectorXf inputVector, Eigen::VectorXf resultVector)
+Eigen::RowVectorXf mitk::pa::SpectralUnmixingFilterBase::CalculateRelativeError(const Eigen::MatrixXf& endmemberMatrix,
+  const Eigen::MatrixXf& inputMatrix, const Eigen::MatrixXf& resultMatrix)
 {
-  float relativeError = (endmemberMatrix*resultVector - inputVector).norm() / inputVector.norm();
-  for (int i = 0; i < 2; ++i)
+  Eigen::RowVectorXf relativeError =
+    (endmemberMatrix * resultMatrix - inputMatrix).colwise().norm().cwiseQuotient(inputMatrix.colwise().norm());
+  for (Eigen::Index pixel = 0; pixel < relativeError.size(); ++pixel)
   {
-    if (resultVector[i] < m_RelativeErrorSettings[i])
-      return 0;
+    for (int i = 0; i < 2; ++i)
+    {
+      if (resultMatrix(i, pixel) < m_RelativeErrorSettings[i])
+      {
+        relativeError[pixel] = 0;
+        break;
+      }
+    }
   }
   return relativeError;
 }
@@ -47,6 +47,7 @@ Eigen::VectorXf mitk::pa::SpectralUnmixingFilterSimplex::SpectralUnmixingAlgorit
 
     resultVector[i] = Volume / VolumeMax;
 
+    std::lock_guard<std::mutex> lock(m_FileMutex);
     myfile << "resultVector["<<i<<"]: " << resultVector[i] << "\n";
     myfile << "Volume: " << Volume << "\n";
     myfile << "VolumeMax: " << VolumeMax << "\n";
@@ -159,7 +160,10 @@ Eigen::VectorXf mitk::pa::SpectralUnmixingFilterSimplex::Normalization(
 //ofstream myfile;
 //myfile.open("SimplexNormalisation.txt");
   //NormalizationFactor = inputVector[0] * 2 / norm;
-  myfile << "Normalizationfactor " << NormalizationFactor << "\n";
+  {
+    std::lock_guard<std::mutex> lock(m_FileMutex);
+    myfile << "Normalizationfactor " << NormalizationFactor << "\n";
+  }
 
   for (int i = 0; i < numberOfWavelengths; ++i)
   {
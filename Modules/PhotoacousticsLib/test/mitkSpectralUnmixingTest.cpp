@@ -33,6 +33,7 @@ class mitkSpectralUnmixingTestSuite : public mitk::TestFixture
   MITK_TEST(testAddOutput);
   MITK_TEST(testWeightsError);
   MITK_TEST(testOutputs);
+  MITK_TEST(testLargeImage);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -634,6 +635,67 @@ public:
     }
   }
 
+  // Tests that the batched linear and the threaded per-pixel unmixing give the correct result for every pixel of a larger image
+  void testLargeImage()
+  {
+    const unsigned int xDim = 40;
+    const unsigned int yDim = 30;
+    const unsigned int numberOfSequences = 3;
+    const unsigned int pixelsPerImage = xDim * yDim;
+
+    mitk::Image::Pointer largeImage = mitk::Image::New();
+    unsigned int dimensions[3] = { xDim, yDim, 2 * numberOfSequences };
+    largeImage->Initialize(mitk::MakeScalarPixelType<float>(), 3, dimensions);
+
+    std::vector<float> fractions(2 * pixelsPerImage * numberOfSequences);
+    std::vector<float> data(2 * pixelsPerImage * numberOfSequences);
+    for (unsigned int sequence = 0; sequence < numberOfSequences; ++sequence)
+    {
+      for (unsigned int pixel = 0; pixel < pixelsPerImage; ++pixel)
+      {
+        float fracHbO2 = 100 + (pixel + 7 * sequence) % 311;
+        float fracHb = 50 + (3 * pixel + sequence) % 173;
+        fractions[sequence * pixelsPerImage + pixel] = fracHbO2;
+        fractions[(numberOfSequences + sequence) * pixelsPerImage + pixel] = fracHb;
+        data[2 * sequence * pixelsPerImage + pixel] = fracHb * 7.52 + fracHbO2 * 2.77;
+        data[(2 * sequence + 1) * pixelsPerImage + pixel] = fracHb * 4.08 + fracHbO2 * 4.37;
+      }
+    }
+    largeImage->SetImportVolume(data.data(), mitk::Image::ImportMemoryManagementType::CopyMemory);
+
+    auto linearFilter = mitk::pa::LinearSpectralUnmixingFilter::New();
+    linearFilter->SetAlgorithm(mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::JACOBISVD);
+    auto vigraFilter = mitk::pa::SpectralUnmixingFilterVigra::New();
+    vigraFilter->SetAlgorithm(mitk::pa::SpectralUnmixingFilterVigra::VigraAlgortihmType::LS);
+    std::vector<mitk::pa::SpectralUnmixingFilterBase::Pointer> filters = { linearFilter.GetPointer(), vigraFilter.GetPointer() };
+
+    for (auto filter : filters)
+    {
+      filter->Verbose(false);
+      filter->RelativeError(false);
+      filter->SetInput(largeImage);
+      filter->AddOutputs(2);
+      for (int wavelength : m_inputWavelengths)
+        filter->AddWavelength(wavelength);
+      filter->AddChromophore(mitk::pa::PropertyCalculator::ChromophoreType::OXYGENATED);
+      filter->AddChromophore(mitk::pa::PropertyCalculator::ChromophoreType::DEOXYGENATED);
+      filter->Update();
+
+      for (unsigned int i = 0; i < 2; ++i)
+      {
+        mitk::Image::Pointer output = filter->GetOutput(i);
+        CPPUNIT_ASSERT_EQUAL(numberOfSequences, output->GetDimension(2));
+        mitk::ImageReadAccessor readAccess(output);
+        const float* outputData = (const float*)readAccess.GetData();
+        for (unsigned int pixel = 0; pixel < pixelsPerImage * numberOfSequences; ++pixel)
+        {
+          float expected = fractions[i * pixelsPerImage * numberOfSequences + pixel];
+          CPPUNIT_ASSERT(std::abs(outputData[pixel] - expected) < threshold * expected);
+        }
+      }
+    }
+  }
+
   // TEST TEMPLATE:
   /*
   // Test exceptions for
@@ -6,6 +6,8 @@ set(CPP_FILES
   mitkPointSetSerializer.cpp
   mitkPropertyListDeserializer.cpp
   mitkPropertyListDeserializerV1.cpp
+  mitkSceneArchiveReader.cpp
+  mitkSceneArchiveWriter.cpp
   mitkSceneIO.cpp
   mitkSceneReader.cpp
   mitkSceneReaderV1.cpp
@@ -61,6 +61,8 @@ namespace mitk
      *
      * Attempts to write a scene file, which contains the nodes of the
      * provided DataStorage, their parent/child relations, and properties.
+     * The files written for each node are compressed into the archive by several threads right after
+     * the node has been serialized, so temporary disk space is needed for one node at a time only.
      *
      * \param storage a DataStorage containing all nodes that should be saved
      * \param filename full filename of the scene file
@@ -0,0 +1,116 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkSceneArchiveReader.h"
+
+#include <mitkExceptionMacro.h>
+#include <mitkLogMacros.h>
+
+#include <Poco/File.h>
+#include <Poco/FileStream.h>
+#include <Poco/Path.h>
+#include <Poco/StreamCopier.h>
+#include <Poco/Zip/ZipArchive.h>
+#include <Poco/Zip/ZipStream.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+mitk::SceneArchiveReader::SceneArchiveReader(std::istream &stream, const std::string &filename) : m_FileName(filename)
+{
+  Poco::Zip::ZipArchive archive(stream);
+  for (auto iter = archive.headerBegin(); iter != archive.headerEnd(); ++iter)
+  {
+    if (!iter->second.isDirectory())
+    {
+      m_Headers.push_back(iter->second);
+    }
+  }
+
+  // start with the largest files, so the threads finish at about the same time
+  std::sort(m_Headers.begin(),
+            m_Headers.end(),
+            [](const Poco::Zip::ZipLocalFileHeader &a, const Poco::Zip::ZipLocalFileHeader &b) {
+              return a.getCompressedSize() > b.getCompressedSize();
+            });
+}
+
+unsigned int mitk::SceneArchiveReader::ExtractAll(const std::string &directory, unsigned int numberOfThreads)
+{
+  if (numberOfThreads == 0)
+  {
+    numberOfThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  numberOfThreads = static_cast<unsigned int>(std::min<std::size_t>(numberOfThreads, m_Headers.size()));
+
+  std::atomic<std::size_t> nextHeader(0);
+  std::atomic<unsigned int> numberOfErrors(0);
+
+  auto extract = [&]() {
+    for (std::size_t i = nextHeader++; i < m_Headers.size(); i = nextHeader++)
+    {
+      try
+      {
+        this->ExtractFile(m_Headers[i], directory);
+      }
+      catch (const std::exception &e)
+      {
+        ++numberOfErrors;
+        MITK_ERROR << "Error while unzipping: " << m_Headers[i].getFileName() << ": " << e.what();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < numberOfThreads; ++i)
+  {
+    threads.emplace_back(extract);
+  }
+  extract();
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  return numberOfErrors;
+}
+
+void mitk::SceneArchiveReader::ExtractFile(const Poco::Zip::ZipLocalFileHeader &header, const std::string &directory)
+{
+  Poco::Path file(header.getFileName(), Poco::Path::PATH_UNIX);
+  file.makeFile();
+  bool illegal = file.isAbsolute();
+  for (int i = 0; i < file.depth(); ++i)
+  {
+    illegal = illegal || file[i] == "..";
+  }
+  if (illegal)
+  {
+    mitkThrow() << "Illegal path in archive";
+  }
+
+  Poco::Path destination(Poco::Path(directory).makeDirectory(), file);
+  Poco::File(destination.parent()).createDirectories();
+
+  Poco::FileInputStream input(m_FileName, std::ios::in | std::ios::binary);
+  Poco::Zip::ZipInputStream zipInput(input, header);
+  Poco::FileOutputStream output(destination.toString(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+  const Poco::UInt64 size = Poco::StreamCopier::copyStream64(zipInput, output);
+  output.close();
+
+  if (size != header.getUncompressedSize())
+  {
+    mitkThrow() << "Extracted " << size << " of " << header.getUncompressedSize() << " bytes";
+  }
+}
@@ -0,0 +1,56 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkSceneArchiveReader_h
+#define mitkSceneArchiveReader_h
+
+#include <Poco/Zip/ZipLocalFileHeader.h>
+
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace mitk
+{
+  /**
+    \brief Extracts the files of a scene archive, several files at a time.
+
+    The file list is read from the archive once; then each thread reads its own files through a stream of
+    its own, so the files of a scene are decompressed in parallel. A single file is still decompressed by
+    one thread.
+  */
+  class SceneArchiveReader
+  {
+  public:
+    /**
+      \param stream stream of the archive the file list is read from
+      \param filename file name of the archive, opened again by every thread
+      \throw Poco::Exception if the archive cannot be parsed
+    */
+    SceneArchiveReader(std::istream &stream, const std::string &filename);
+
+    /**
+      \brief Extracts all files into directory.
+      \param numberOfThreads 0 for the number of cores
+      \return the number of files that could not be extracted
+    */
+    unsigned int ExtractAll(const std::string &directory, unsigned int numberOfThreads = 0);
+
+  private:
+    void ExtractFile(const Poco::Zip::ZipLocalFileHeader &header, const std::string &directory);
+
+    std::string m_FileName;
+    std::vector<Poco::Zip::ZipLocalFileHeader> m_Headers;
+  };
+}
+
+#endif
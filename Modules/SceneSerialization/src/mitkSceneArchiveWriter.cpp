@@ -0,0 +1,368 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkSceneArchiveWriter.h"
+
+#include <mitkExceptionMacro.h>
+
+#include <Poco/File.h>
+#include <Poco/FileStream.h>
+
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+  const std::size_t ChunkSize = 1 << 20;
+  const std::size_t DictionarySize = 1 << 15; // deflate window
+  const std::uint64_t Max16 = 0xFFFF;
+  const std::uint64_t Max32 = 0xFFFFFFFF;
+
+  // files that may exceed 4 GB when compressed get ZIP64 sizes, leaving room for incompressible data
+  const std::uint64_t Zip64Threshold = Max32 - (Max32 >> 6);
+
+  void Write16(std::ostream &stream, std::uint64_t value)
+  {
+    const char bytes[2] = {static_cast<char>(value & 0xFF), static_cast<char>((value >> 8) & 0xFF)};
+    stream.write(bytes, 2);
+  }
+
+  void Write32(std::ostream &stream, std::uint64_t value)
+  {
+    Write16(stream, value & 0xFFFF);
+    Write16(stream, (value >> 16) & 0xFFFF);
+  }
+
+  void Write64(std::ostream &stream, std::uint64_t value)
+  {
+    Write32(stream, value & Max32);
+    Write32(stream, value >> 32);
+  }
+}
+
+mitk::SceneArchiveWriter::SceneArchiveWriter(std::ostream &stream, unsigned int numberOfThreads)
+  : m_Stream(stream), m_StartPosition(stream.tellp()), m_NumberOfThreads(numberOfThreads), m_Closed(false)
+{
+  if (m_NumberOfThreads == 0)
+  {
+    m_NumberOfThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  m_Chunks.resize(2 * m_NumberOfThreads);
+
+  // MS-DOS date and time of all entries
+  std::time_t now = std::time(nullptr);
+  std::tm *local = std::localtime(&now);
+  m_Time = static_cast<std::uint16_t>((local->tm_hour << 11) | (local->tm_min << 5) | (local->tm_sec / 2));
+  m_Date = static_cast<std::uint16_t>(((std::max(local->tm_year, 80) - 80) << 9) | ((local->tm_mon + 1) << 5) | local->tm_mday);
+}
+
+void mitk::SceneArchiveWriter::AddFile(const std::string &path, const std::string &entryName)
+{
+  if (m_Closed)
+  {
+    mitkThrow() << "Cannot add '" << entryName << "' to a closed archive.";
+  }
+
+  Poco::FileInputStream input(path, std::ios::in | std::ios::binary);
+  if (!input.good())
+  {
+    mitkThrow() << "Cannot open '" << path << "' for reading.";
+  }
+
+  Entry entry;
+  entry.m_Name = entryName;
+  entry.m_CRC = crc32(0L, Z_NULL, 0);
+  entry.m_CompressedSize = 0;
+  entry.m_UncompressedSize = Poco::File(path).getSize();
+  entry.m_Offset = this->GetPosition();
+  entry.m_Zip64 = entry.m_UncompressedSize >= Zip64Threshold;
+
+  // local file header, CRC and sizes are written after compression
+  Write32(m_Stream, 0x04034b50);
+  Write16(m_Stream, entry.m_Zip64 ? 45 : 20); // version needed to extract
+  Write16(m_Stream, 0);                      // flags
+  Write16(m_Stream, 8);                      // deflate
+  Write16(m_Stream, m_Time);
+  Write16(m_Stream, m_Date);
+  Write32(m_Stream, 0);
+  Write32(m_Stream, 0);
+  Write32(m_Stream, 0);
+  Write16(m_Stream, entry.m_Name.size());
+  Write16(m_Stream, entry.m_Zip64 ? 20 : 0);
+  m_Stream.write(entry.m_Name.data(), entry.m_Name.size());
+  if (entry.m_Zip64)
+  {
+    Write16(m_Stream, 0x0001);
+    Write16(m_Stream, 16);
+    Write64(m_Stream, 0);
+    Write64(m_Stream, 0);
+  }
+
+  const std::uint64_t numberOfChunks = std::max<std::uint64_t>((entry.m_UncompressedSize + ChunkSize - 1) / ChunkSize, 1);
+  std::uint64_t remaining = entry.m_UncompressedSize;
+  m_Dictionary.clear();
+
+  for (std::uint64_t first = 0; first < numberOfChunks; first += m_Chunks.size())
+  {
+    const std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(m_Chunks.size(), numberOfChunks - first));
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      Chunk &chunk = m_Chunks[i];
+      chunk.m_Input.resize(static_cast<std::size_t>(std::min<std::uint64_t>(ChunkSize, remaining)));
+      input.read(chunk.m_Input.data(), chunk.m_Input.size());
+      if (static_cast<std::size_t>(input.gcount()) != chunk.m_Input.size())
+      {
+        mitkThrow() << "Could not read '" << path << "' completely.";
+      }
+      remaining -= chunk.m_Input.size();
+      chunk.m_Last = first + i + 1 == numberOfChunks;
+    }
+
+    this->CompressChunks(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      const Chunk &chunk = m_Chunks[i];
+      m_Stream.write(chunk.m_Output.data(), chunk.m_Output.size());
+      entry.m_CRC = crc32_combine(entry.m_CRC, chunk.m_CRC, chunk.m_Input.size());
+      entry.m_CompressedSize += chunk.m_Output.size();
+    }
+
+    const std::vector<char> &lastInput = m_Chunks[count - 1].m_Input;
+    m_Dictionary.assign(lastInput.end() - std::min(lastInput.size(), DictionarySize), lastInput.end());
+  }
+
+  if (!entry.m_Zip64 && entry.m_CompressedSize >= Max32)
+  {
+    mitkThrow() << "Compressed size of '" << entryName << "' exceeds the size reserved for it.";
+  }
+
+  // complete the local file header
+  const std::streamoff end = m_Stream.tellp();
+  m_Stream.seekp(m_StartPosition + static_cast<std::streamoff>(entry.m_Offset) + 14);
+  Write32(m_Stream, entry.m_CRC);
+  if (entry.m_Zip64)
+  {
+    Write32(m_Stream, Max32);
+    Write32(m_Stream, Max32);
+    m_Stream.seekp(4 + entry.m_Name.size() + 4, std::ios::cur);
+    Write64(m_Stream, entry.m_UncompressedSize);
+    Write64(m_Stream, entry.m_CompressedSize);
+  }
+  else
+  {
+    Write32(m_Stream, entry.m_CompressedSize);
+    Write32(m_Stream, entry.m_UncompressedSize);
+  }
+  m_Stream.seekp(end);
+
+  if (!m_Stream.good())
+  {
+    mitkThrow() << "Could not write '" << entryName << "' to the archive.";
+  }
+
+  m_Entries.push_back(entry);
+}
+
+void mitk::SceneArchiveWriter::Close()
+{
+  if (m_Closed)
+  {
+    return;
+  }
+  m_Closed = true;
+
+  const std::uint64_t centralDirectoryOffset = this->GetPosition();
+
+  for (const auto &entry : m_Entries)
+  {
+    const bool largeOffset = entry.m_Offset >= Max32;
+    const std::size_t extraSize = (entry.m_Zip64 ? 16 : 0) + (largeOffset ? 8 : 0);
+
+    Write32(m_Stream, 0x02014b50);
+    Write16(m_Stream, extraSize > 0 ? 45 : 20); // version made by
+    Write16(m_Stream, extraSize > 0 ? 45 : 20); // version needed to extract
+    Write16(m_Stream, 0);
+    Write16(m_Stream, 8);
+    Write16(m_Stream, m_Time);
+    Write16(m_Stream, m_Date);
+    Write32(m_Stream, entry.m_CRC);
+    Write32(m_Stream, entry.m_Zip64 ? Max32 : entry.m_CompressedSize);
+    Write32(m_Stream, entry.m_Zip64 ? Max32 : entry.m_UncompressedSize);
+    Write16(m_Stream, entry.m_Name.size());
+    Write16(m_Stream, extraSize > 0 ? extraSize + 4 : 0);
+    Write16(m_Stream, 0); // comment length
+    Write16(m_Stream, 0); // disk number
+    Write16(m_Stream, 0); // internal attributes
+    Write32(m_Stream, 0); // external attributes
+    Write32(m_Stream, largeOffset ? Max32 : entry.m_Offset);
+    m_Stream.write(entry.m_Name.data(), entry.m_Name.size());
+
+    if (extraSize > 0)
+    {
+      Write16(m_Stream, 0x0001);
+      Write16(m_Stream, extraSize);
+      if (entry.m_Zip64)
+      {
+        Write64(m_Stream, entry.m_UncompressedSize);
+        Write64(m_Stream, entry.m_CompressedSize);
+      }
+      if (largeOffset)
+      {
+        Write64(m_Stream, entry.m_Offset);
+      }
+    }
+  }
+
+  const std::uint64_t centralDirectoryEnd = this->GetPosition();
+  const std::uint64_t centralDirectorySize = centralDirectoryEnd - centralDirectoryOffset;
+  const std::uint64_t numberOfEntries = m_Entries.size();
+
+  if (numberOfEntries >= Max16 || centralDirectoryOffset >= Max32 || centralDirectorySize >= Max32)
+  {
+    // ZIP64 end of central directory record and locator
+    Write32(m_Stream, 0x06064b50);
+    Write64(m_Stream, 44);
+    Write16(m_Stream, 45);
+    Write16(m_Stream, 45);
+    Write32(m_Stream, 0);
+    Write32(m_Stream, 0);
+    Write64(m_Stream, numberOfEntries);
+    Write64(m_Stream, numberOfEntries);
+    Write64(m_Stream, centralDirectorySize);
+    Write64(m_Stream, centralDirectoryOffset);
+
+    Write32(m_Stream, 0x07064b50);
+    Write32(m_Stream, 0);
+    Write64(m_Stream, centralDirectoryEnd);
+    Write32(m_Stream, 1);
+  }
+
+  Write32(m_Stream, 0x06054b50);
+  Write16(m_Stream, 0);
+  Write16(m_Stream, 0);
+  Write16(m_Stream, std::min(numberOfEntries, Max16));
+  Write16(m_Stream, std::min(numberOfEntries, Max16));
+  Write32(m_Stream, std::min(centralDirectorySize, Max32));
+  Write32(m_Stream, std::min(centralDirectoryOffset, Max32));
+  Write16(m_Stream, 0); // comment length
+
+  m_Stream.flush();
+  if (!m_Stream.good())
+  {
+    mitkThrow() << "Could not write the central directory of the archive.";
+  }
+}
+
+void mitk::SceneArchiveWriter::CompressChunks(std::size_t count)
+{
+  const unsigned int numberOfThreads = static_cast<unsigned int>(std::min<std::size_t>(m_NumberOfThreads, count));
+  if (numberOfThreads <= 1)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      this->CompressChunk(i);
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> nextChunk(0);
+  std::exception_ptr error;
+  std::mutex errorMutex;
+
+  auto compress = [&]() {
+    for (std::size_t i = nextChunk++; i < count; i = nextChunk++)
+    {
+      try
+      {
+        this->CompressChunk(i);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        error = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < numberOfThreads; ++i)
+  {
+    threads.emplace_back(compress);
+  }
+  compress();
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
+
+void mitk::SceneArchiveWriter::CompressChunk(std::size_t index)
+{
+  Chunk &chunk = m_Chunks[index];
+
+  // the first chunk of a batch continues the last one of the previous batch
+  const std::vector<char> &previous = index > 0 ? m_Chunks[index - 1].m_Input : m_Dictionary;
+  const std::size_t dictionarySize = std::min(previous.size(), DictionarySize);
+
+  z_stream stream = z_stream();
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+  {
+    mitkThrow() << "Could not initialize zlib.";
+  }
+
+  if (dictionarySize > 0)
+  {
+    deflateSetDictionary(&stream,
+                         reinterpret_cast<const Bytef *>(previous.data() + previous.size() - dictionarySize),
+                         static_cast<uInt>(dictionarySize));
+  }
+
+  // all but the last chunk end with a sync flush, so the chunks form one deflate stream
+  chunk.m_Output.resize(deflateBound(&stream, chunk.m_Input.size()) + 16);
+  stream.next_in = reinterpret_cast<Bytef *>(chunk.m_Input.data());
+  stream.avail_in = static_cast<uInt>(chunk.m_Input.size());
+  stream.next_out = reinterpret_cast<Bytef *>(chunk.m_Output.data());
+  stream.avail_out = static_cast<uInt>(chunk.m_Output.size());
+
+  const int result = deflate(&stream, chunk.m_Last ? Z_FINISH : Z_SYNC_FLUSH);
+  const bool complete = chunk.m_Last ? result == Z_STREAM_END
+                                     : result == Z_OK && stream.avail_in == 0 && stream.avail_out > 0;
+  chunk.m_Output.resize(stream.total_out);
+  deflateEnd(&stream);
+
+  if (!complete)
+  {
+    mitkThrow() << "Could not compress data (zlib error " << result << ").";
+  }
+
+  chunk.m_CRC = crc32(crc32(0L, Z_NULL, 0),
+                      reinterpret_cast<const Bytef *>(chunk.m_Input.data()),
+                      static_cast<uInt>(chunk.m_Input.size()));
+}
+
+std::uint64_t mitk::SceneArchiveWriter::GetPosition()
+{
+  return static_cast<std::uint64_t>(m_Stream.tellp() - m_StartPosition);
+}
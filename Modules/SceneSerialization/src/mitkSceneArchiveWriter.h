@@ -0,0 +1,93 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkSceneArchiveWriter_h
+#define mitkSceneArchiveWriter_h
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace mitk
+{
+  /**
+    \brief Writes the files of a scene into a ZIP archive, compressing large files with several threads.
+
+    Each file is split into chunks that are deflated concurrently, every chunk primed with the end of the
+    previous one as dictionary. The chunks are concatenated into one ordinary deflate stream, so the archive
+    can be read by any ZIP implementation, including Poco::Zip::Decompress. ZIP64 records are written for
+    files and archives larger than 4 GB.
+
+    Files are added one by one, so a caller can delete each file right after adding it.
+  */
+  class SceneArchiveWriter
+  {
+  public:
+    /**
+      \param stream seekable stream the archive is written to
+      \param numberOfThreads number of threads compressing chunks, 0 for the number of cores
+    */
+    SceneArchiveWriter(std::ostream &stream, unsigned int numberOfThreads = 0);
+
+    /**
+      \brief Compresses the file at path into the archive as entryName.
+      \throw mitk::Exception if the file cannot be read or compressed
+    */
+    void AddFile(const std::string &path, const std::string &entryName);
+
+    /**
+      \brief Writes the central directory. No files can be added afterwards.
+    */
+    void Close();
+
+  private:
+    struct Entry
+    {
+      std::string m_Name;
+      std::uint32_t m_CRC;
+      std::uint64_t m_CompressedSize;
+      std::uint64_t m_UncompressedSize;
+      std::uint64_t m_Offset;
+      bool m_Zip64;
+    };
+
+    struct Chunk
+    {
+      std::vector<char> m_Input;
+      std::vector<char> m_Output;
+      std::uint32_t m_CRC;
+      bool m_Last;
+    };
+
+    /** \brief Compresses the first count chunks concurrently. */
+    void CompressChunks(std::size_t count);
+
+    void CompressChunk(std::size_t index);
+
+    std::uint64_t GetPosition();
+
+    std::ostream &m_Stream;
+    std::streamoff m_StartPosition;
+    unsigned int m_NumberOfThreads;
+    std::uint16_t m_Time;
+    std::uint16_t m_Date;
+
+    std::vector<Entry> m_Entries;
+    std::vector<Chunk> m_Chunks;
+    /** End of the last chunk of the previous batch, the dictionary of the first chunk of the next batch */
+    std::vector<char> m_Dictionary;
+    bool m_Closed;
+  };
+}
+
+#endif
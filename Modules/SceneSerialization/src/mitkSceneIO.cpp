@@ -11,13 +11,15 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include <Poco/Delegate.h>
+#include <Poco/DirectoryIterator.h>
 #include <Poco/Path.h>
 #include <Poco/TemporaryFile.h>
-#include <Poco/Zip/Compress.h>
 #include <Poco/Zip/Decompress.h>
 
 #include "mitkBaseDataSerializer.h"
 #include "mitkPropertyListSerializer.h"
+#include "mitkSceneArchiveReader.h"
+#include "mitkSceneArchiveWriter.h"
 #include "mitkSceneIO.h"
 #include "mitkSceneReader.h"
 
@@ -38,6 +40,60 @@ found in the LICENSE file.
 
 #include "itksys/SystemTools.hxx"
 
+namespace
+{
+  /// Compresses all files below directory into the archive and deletes them.
+  void MoveFilesToArchive(const std::string &directory, mitk::SceneArchiveWriter &archive, const std::string &prefix = "")
+  {
+    for (Poco::DirectoryIterator iter(directory), end; iter != end; ++iter)
+    {
+      if (iter->isDirectory())
+      {
+        MoveFilesToArchive(iter.path().toString(), archive, prefix + iter.name() + "/");
+      }
+      else
+      {
+        archive.AddFile(iter.path().toString(), prefix + iter.name());
+        iter->remove();
+      }
+    }
+  }
+
+  /// Removes the temporary directory and archive file of SaveScene on every exit path.
+  class TemporarySceneFiles
+  {
+  public:
+    ~TemporarySceneFiles()
+    {
+      Remove(m_ArchiveFile, false);
+      Remove(m_Directory, true);
+    }
+
+    std::string m_Directory;
+    std::string m_ArchiveFile;
+
+  private:
+    static void Remove(const std::string &path, bool recursive)
+    {
+      if (path.empty())
+        return;
+
+      try
+      {
+        Poco::File file(path);
+        if (file.exists())
+        {
+          file.remove(recursive);
+        }
+      }
+      catch (...)
+      {
+        MITK_ERROR << "Could not delete temporary file " << path;
+      }
+    }
+  };
+}
+
 mitk::SceneIO::SceneIO() : m_WorkingDirectory(""), m_UnzipErrors(0)
 {
 }
@@ -129,18 +185,30 @@ mitk::DataStorage::Pointer mitk::SceneIO::LoadScene(const std::string &filename,
     return storage;
   }
 
-  // unzip all filenames contents to temp dir
+  // unzip all filenames contents to temp dir, several files at a time
   m_UnzipErrors = 0;
-  Poco::Zip::Decompress unzipper(file, Poco::Path(m_WorkingDirectory));
-  unzipper.EError += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
-    this, &SceneIO::OnUnzipError);
-  unzipper.EOk += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
-    this, &SceneIO::OnUnzipOk);
-  unzipper.decompressAllFiles();
-  unzipper.EError -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
-    this, &SceneIO::OnUnzipError);
-  unzipper.EOk -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
-    this, &SceneIO::OnUnzipOk);
+  try
+  {
+    SceneArchiveReader archive(file, filename);
+    m_UnzipErrors = archive.ExtractAll(m_WorkingDirectory);
+  }
+  catch (const std::exception &e)
+  {
+    MITK_WARN << "Could not read the file list of '" << filename << "' (" << e.what() << "), unzipping sequentially.";
+
+    file.clear();
+    file.seekg(0);
+    Poco::Zip::Decompress unzipper(file, Poco::Path(m_WorkingDirectory));
+    unzipper.EError += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
+      this, &SceneIO::OnUnzipError);
+    unzipper.EOk += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
+      this, &SceneIO::OnUnzipOk);
+    unzipper.decompressAllFiles();
+    unzipper.EError -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
+      this, &SceneIO::OnUnzipError);
+    unzipper.EOk -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
+      this, &SceneIO::OnUnzipOk);
+  }
 
   if (m_UnzipErrors)
   {
@@ -227,6 +295,28 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
 
     // DataStorage::SetOfObjects::ConstPointer sceneNodes = storage->GetSubset( predicate );
 
+    TemporarySceneFiles temporaryFiles;
+    m_WorkingDirectory = CreateEmptyTempDirectory();
+    if (m_WorkingDirectory.empty())
+    {
+      MITK_ERROR << "Could not create temporary directory. Cannot create scene files.";
+      return false;
+    }
+    temporaryFiles.m_Directory = m_WorkingDirectory;
+
+    // create the zip next to filename, the files of each node are moved into it right after writing them.
+    // An existing scene is only replaced after the new one has been written completely.
+    UIDGenerator tempFileUIDGen("SceneIOTemp_", 6);
+    const std::string tempFilename = filename + "." + tempFileUIDGen.GetUID() + ".tmp";
+    temporaryFiles.m_ArchiveFile = tempFilename;
+    std::ofstream file(tempFilename.c_str(), std::ios::binary | std::ios::out);
+    if (!file.good())
+    {
+      MITK_ERROR << "Could not open a zip file for writing: '" << tempFilename << "'";
+      return false;
+    }
+    SceneArchiveWriter archive(file);
+
     if (sceneNodes.IsNull())
     {
       MITK_WARN << "Saving empty scene to " << filename;
@@ -240,13 +330,6 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
 
       MITK_INFO << "Storing scene with " << sceneNodes->size() << " objects to " << filename;
 
-      m_WorkingDirectory = CreateEmptyTempDirectory();
-      if (m_WorkingDirectory.empty())
-      {
-        MITK_ERROR << "Could not create temporary directory. Cannot create scene files.";
-        return false;
-      }
-
       ProgressBar::GetInstance()->AddStepsToDo(sceneNodes->size());
 
       // find out about dependencies
@@ -369,6 +452,8 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
             nodeElement->LinkEndChild(propertiesElement);
           }
           document.LinkEndChild(nodeElement);
+
+          MoveFilesToArchive(m_WorkingDirectory, archive);
         }
         else
         {
@@ -391,36 +476,17 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
     {
       try
       {
-        Poco::File deleteFile(filename.c_str());
-        if (deleteFile.exists())
+        MoveFilesToArchive(m_WorkingDirectory, archive);
+        archive.Close();
+        file.close();
+        if (!file)
         {
-          deleteFile.remove();
-        }
-
-        // create zip at filename
-        std::ofstream file(filename.c_str(), std::ios::binary | std::ios::out);
-        if (!file.good())
-        {
-          MITK_ERROR << "Could not open a zip file for writing: '" << filename << "'";
+          MITK_ERROR << "Could not write zip file '" << tempFilename << "'";
           return false;
         }
-        else
-        {
-          Poco::Zip::Compress zipper(file, true);
-          Poco::Path tmpdir(m_WorkingDirectory);
-          zipper.addRecursive(tmpdir);
-          zipper.close();
-        }
-        try
-        {
-          Poco::File deleteDir(m_WorkingDirectory);
-          deleteDir.remove(true); // recursive
-        }
-        catch (...)
-        {
-          MITK_ERROR << "Could not delete temporary directory " << m_WorkingDirectory;
-          return false; // ok?
-        }
+
+        Poco::File(tempFilename).renameTo(filename);
+        temporaryFiles.m_ArchiveFile.clear();
       }
       catch (std::exception &e)
       {
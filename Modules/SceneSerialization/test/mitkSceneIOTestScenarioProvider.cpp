@@ -266,6 +266,30 @@ mitk::DataStorage::Pointer mitk::SceneIOTestScenarioProvider::Image() const
   return storage;
 }
 
+mitk::DataStorage::Pointer mitk::SceneIOTestScenarioProvider::LargeImages() const
+{
+  mitk::DataStorage::Pointer storage = StandaloneDataStorage::New().GetPointer();
+
+  for (int i = 0; i < 3; ++i)
+  {
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<int>(128,
+                                                                              128,
+                                                                              64, // dim
+                                                                              1,
+                                                                              0.5,
+                                                                              0.5, // spacing
+                                                                              2,   // time steps
+                                                                              3000,
+                                                                              -1000); // random max / min
+    mitk::DataNode::Pointer node = DataNode::New();
+    node->SetName("LargeImage-" + std::to_string(i));
+    node->SetData(image);
+    storage->Add(node);
+  }
+
+  return storage;
+}
+
 mitk::DataStorage::Pointer mitk::SceneIOTestScenarioProvider::Surface() const
 {
   mitk::DataStorage::Pointer storage = StandaloneDataStorage::New().GetPointer();
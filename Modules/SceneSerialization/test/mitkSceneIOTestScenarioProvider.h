@@ -154,6 +154,11 @@ namespace mitk
     */
     DataStorage::Pointer Image() const;
 
+    /**
+      Several images that span many compression chunks each.
+    */
+    DataStorage::Pointer LargeImages() const;
+
     /**
       Basic core type Surface.
     */
@@ -191,6 +196,7 @@ namespace mitk
       AddSaveAndRestoreScenario(ComplicatedFamilySituation);
 
       AddSaveAndRestoreScenario(Image);
+      AddSaveAndRestoreScenario(LargeImages);
       AddSaveAndRestoreScenario(Surface);
       AddSaveAndRestoreScenario(PointSet);
 
@@ -16,6 +16,8 @@ found in the LICENSE file.
 
 #include <itkCommand.h>
 
+#include <vtkImageData.h>
+
 mitk::DiffSliceOperation::DiffSliceOperation() : Operation(1)
 {
   m_TimeStep = 0;
@@ -88,6 +90,16 @@ mitk::Image::Pointer mitk::DiffSliceOperation::GetSlice()
   return image;
 }
 
+std::size_t mitk::DiffSliceOperation::GetMemoryUsage() const
+{
+  std::size_t memoryUsage = 0;
+  if (m_zlibSliceContainer.IsNotNull())
+    memoryUsage += m_zlibSliceContainer->GetCompressedSize();
+  if (m_Slice != nullptr)
+    memoryUsage += m_Slice->GetActualMemorySize() * 1024;
+  return memoryUsage;
+}
+
 bool mitk::DiffSliceOperation::IsValid()
 {
   return m_ImageIsValid && m_zlibSliceContainer.IsNotNull() && (m_WorldGeometry.IsNotNull()); // TODO improve
@@ -81,6 +81,8 @@ namespace mitk
     void SetCurrentWorldGeometry(BaseGeometry *worldGeometry) { this->m_WorldGeometry = worldGeometry; }
     /** \brief Get the axis where the slice has to be applied in the volume.*/
     BaseGeometry *GetWorldGeometry() { return this->m_WorldGeometry; }
+    /** \brief Returns the size of the compressed slice, used by the undo models to limit their memory consumption.*/
+    std::size_t GetMemoryUsage() const override;
   protected:
     ~DiffSliceOperation() override;
 
@@ -16,6 +16,8 @@ found in the LICENSE file.
 #include "mitkRenderingManager.h"
 #include "mitkSegTool2D.h"
 #include <mitkExtractSliceFilter.h>
+#include <mitkImageRegionModifiedEvent.h>
+#include <mitkImageStatisticsHolder.h>
 #include <mitkVtkImageOverwrite.h>
 
 // VTK
@@ -64,7 +66,10 @@ void mitk::DiffSliceOperationApplier::ExecuteOperation(Operation *operation)
 
     // make sure the modification is rendered
     RenderingManager::GetInstance()->RequestUpdateAll();
+    imageOperation->GetImage()->GetStatistics()->InvalidateTimeStep(imageOperation->GetTimeStep());
     imageOperation->GetImage()->Modified();
+    imageOperation->GetImage()->InvokeEvent(
+      ImageRegionModifiedEvent(imageOperation->GetWorldGeometry(), imageOperation->GetTimeStep()));
 
     mitk::ExtractSliceFilter::Pointer extractor2 = mitk::ExtractSliceFilter::New();
     extractor2->SetInput(imageOperation->GetImage());
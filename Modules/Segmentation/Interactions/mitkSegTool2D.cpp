@@ -37,6 +37,8 @@ found in the LICENSE file.
 
 // includes for resling and overwriting
 #include <mitkExtractSliceFilter.h>
+#include <mitkImageRegionModifiedEvent.h>
+#include <mitkImageStatisticsHolder.h>
 #include <mitkVtkImageOverwrite.h>
 #include <vtkImageData.h>
 #include <vtkSmartPointer.h>
@@ -401,8 +403,10 @@ void mitk::SegTool2D::WriteSliceToVolume(const mitk::SegTool2D::SliceInformation
   extractor->Update();
 
   // the image was modified within the pipeline, but not marked so
+  image->GetStatistics()->InvalidateTimeStep(sliceInfo.timestep);
   image->Modified();
   image->GetVtkImageData()->Modified();
+  image->InvokeEvent(ImageRegionModifiedEvent(sliceInfo.plane, sliceInfo.timestep));
 
   /*============= BEGIN undo/redo feature block ========================*/
   // specify the undo operation with the edited slice
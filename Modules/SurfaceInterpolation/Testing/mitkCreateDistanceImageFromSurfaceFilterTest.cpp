@@ -14,9 +14,12 @@ found in the LICENSE file.
 #include <mitkCreateDistanceImageFromSurfaceFilter.h>
 #include <mitkIOUtil.h>
 #include <mitkImageAccessByItk.h>
+#include <mitkImageCast.h>
 #include <mitkTestFixture.h>
 #include <mitkTestingMacros.h>
 
+#include <itkImageRegionConstIterator.h>
+
 #include <vtkDebugLeaks.h>
 
 class mitkCreateDistanceImageFromSurfaceFilterTestSuite : public mitk::TestFixture
@@ -25,6 +28,7 @@ class mitkCreateDistanceImageFromSurfaceFilterTestSuite : public mitk::TestFixtu
   vtkDebugLeaks::SetExitError(0);
   MITK_TEST(TestCreateDistanceImageForLiver);
   MITK_TEST(TestCreateDistanceImageForTube);
+  MITK_TEST(TestCreateDistanceImageForLiverWithCompactSupport);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -127,6 +131,81 @@ public:
     CPPUNIT_ASSERT_MESSAGE("HolesDistanceImages are not equal!",
                            mitk::Equal(*(holesDistanceImageReference), *(holeDistanceImage), 0.0001, true));
   }
+
+  // The compactly supported interpolation does not reproduce the reference exactly, but must agree with its sign
+  void TestCreateDistanceImageForLiverWithCompactSupport()
+  {
+    unsigned int NUMBER_OF_LIVER_CONTOURS = 18;
+
+    for (unsigned int i = 0; i <= NUMBER_OF_LIVER_CONTOURS; ++i)
+    {
+      std::stringstream s;
+      s << "SurfaceInterpolation/InterpolateLiver/LiverContourWithNormals_";
+      s << i;
+      s << ".vtk";
+      mitk::Surface::Pointer contour = mitk::IOUtil::Load<mitk::Surface>(GetTestDataFilePath(s.str()));
+      contourList.push_back(contour);
+    }
+
+    mitk::Image::Pointer segmentationImage =
+      mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("SurfaceInterpolation/Reference/LiverSegmentation.nrrd"));
+
+    mitk::ComputeContourSetNormalsFilter::Pointer m_NormalsFilter = mitk::ComputeContourSetNormalsFilter::New();
+    mitk::CreateDistanceImageFromSurfaceFilter::Pointer m_InterpolateSurfaceFilter =
+      mitk::CreateDistanceImageFromSurfaceFilter::New();
+    m_InterpolateSurfaceFilter->UseCompactSupportOn();
+    m_InterpolateSurfaceFilter->SetNumberOfThreads(4);
+
+    itk::ImageBase<3>::Pointer itkImage = itk::ImageBase<3>::New();
+    AccessFixedDimensionByItk_1(segmentationImage, GetImageBase, 3, itkImage);
+    m_InterpolateSurfaceFilter->SetReferenceImage(itkImage.GetPointer());
+
+    for (unsigned int j = 0; j < contourList.size(); j++)
+    {
+      m_NormalsFilter->SetInput(j, contourList.at(j));
+      m_InterpolateSurfaceFilter->SetInput(j, m_NormalsFilter->GetOutput(j));
+    }
+
+    m_InterpolateSurfaceFilter->Update();
+
+    mitk::Image::Pointer liverDistanceImage = m_InterpolateSurfaceFilter->GetOutput();
+    CPPUNIT_ASSERT(liverDistanceImage.IsNotNull());
+
+    mitk::Image::Pointer liverDistanceImageReference =
+      mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("SurfaceInterpolation/Reference/LiverDistanceImage.nrrd"));
+    CPPUNIT_ASSERT_MESSAGE("Geometry of the LiverDistanceImage differs from the reference!",
+                           mitk::Equal(*(liverDistanceImageReference->GetGeometry()),
+                                       *(liverDistanceImage->GetGeometry()),
+                                       mitk::eps,
+                                       true));
+
+    // The reference is the result of the dense interpolation. Both must enclose nearly the same volume.
+    typedef mitk::CreateDistanceImageFromSurfaceFilter::DistanceImageType DistanceImageType;
+    DistanceImageType::Pointer itkDistanceImage;
+    DistanceImageType::Pointer itkReferenceImage;
+    mitk::CastToItkImage(liverDistanceImage, itkDistanceImage);
+    mitk::CastToItkImage(liverDistanceImageReference, itkReferenceImage);
+
+    itk::ImageRegionConstIterator<DistanceImageType> iter(itkDistanceImage, itkDistanceImage->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<DistanceImageType> referenceIter(itkReferenceImage,
+                                                                   itkReferenceImage->GetLargestPossibleRegion());
+    unsigned int numberOfInside = 0;
+    unsigned int numberOfReferenceInside = 0;
+    unsigned int numberOfBothInside = 0;
+    for (; !iter.IsAtEnd(); ++iter, ++referenceIter)
+    {
+      const bool inside = iter.Get() < 0;
+      const bool referenceInside = referenceIter.Get() < 0;
+      numberOfInside += inside;
+      numberOfReferenceInside += referenceInside;
+      numberOfBothInside += inside && referenceInside;
+    }
+
+    CPPUNIT_ASSERT(numberOfReferenceInside > 0);
+    const double dice = 2.0 * numberOfBothInside / (numberOfInside + numberOfReferenceInside);
+    MITK_INFO << "Dice of the compactly supported and the dense interpolation: " << dice;
+    CPPUNIT_ASSERT_MESSAGE("Compactly supported interpolation deviates from the dense interpolation!", dice >= 0.9);
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkCreateDistanceImageFromSurfaceFilter)
@@ -15,11 +15,14 @@ found in the LICENSE file.
 #include <mitkTestingMacros.h>
 
 #include <vtkDebugLeaks.h>
+#include <vtkPolyData.h>
 #include <vtkRegularPolygonSource.h>
 
 #include "mitkImagePixelWriteAccessor.h"
 #include "mitkImageTimeSelector.h"
 
+#include <cmath>
+
 class mitkSurfaceInterpolationControllerTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkSurfaceInterpolationControllerTestSuite);
@@ -41,6 +44,7 @@ class mitkSurfaceInterpolationControllerTestSuite : public mitk::TestFixture
 
   MITK_TEST(TestAddNewContour);
   MITK_TEST(TestRemoveContour);
+  MITK_TEST(TestInterpolateWithCompactSupport);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -553,6 +557,78 @@ public:
     return true;
   }
 
+  void TestInterpolateWithCompactSupport()
+  {
+    CPPUNIT_ASSERT_MESSAGE("Compact support is disabled by default",
+                           m_Controller->GetCompactSupportContourThreshold() > 0);
+
+    // Segmentation of a sphere
+    unsigned int dimensions[] = {20, 20, 20};
+    mitk::Image::Pointer segmentation = createImage(dimensions);
+    {
+      mitk::ImagePixelWriteAccessor<unsigned char, 3> accessor(segmentation);
+      itk::Index<3> index;
+      for (index[2] = 0; index[2] < 20; ++index[2])
+        for (index[1] = 0; index[1] < 20; ++index[1])
+          for (index[0] = 0; index[0] < 20; ++index[0])
+          {
+            const long dx = index[0] - 10, dy = index[1] - 10, dz = index[2] - 10;
+            accessor.SetPixelByIndex(index, dx * dx + dy * dy + dz * dz <= 49 ? 1 : 0);
+          }
+    }
+    m_Controller->SetCurrentInterpolationSession(segmentation);
+    m_Controller->SetMinSpacing(1.0);
+    m_Controller->SetMaxSpacing(1.0);
+    m_Controller->SetDistanceImageVolume(50000);
+
+    // Axial contours of the sphere
+    double normal[3] = {0.0, 0.0, 1.0};
+    for (double z : {5.0, 8.0, 11.0, 14.0})
+    {
+      double center[3] = {10.0, 10.0, z};
+      vtkSmartPointer<vtkRegularPolygonSource> polygonSource = vtkSmartPointer<vtkRegularPolygonSource>::New();
+      polygonSource->SetNumberOfSides(20);
+      polygonSource->SetCenter(center);
+      polygonSource->SetRadius(std::sqrt(49.0 - (z - 10.0) * (z - 10.0)));
+      polygonSource->SetNormal(normal);
+      polygonSource->GeneratePolylineOff();
+      polygonSource->Update();
+      mitk::Surface::Pointer contour = mitk::Surface::New();
+      contour->SetVtkPolyData(polygonSource->GetOutput());
+      m_Controller->AddNewContour(contour);
+    }
+
+    const unsigned int defaultThreshold = m_Controller->GetCompactSupportContourThreshold();
+    m_Controller->SetCompactSupportContourThreshold(0);
+    m_Controller->Interpolate();
+    mitk::Surface::Pointer denseResult = m_Controller->GetInterpolationResult();
+
+    // More contours than the threshold are interpolated with compact support
+    m_Controller->SetCompactSupportContourThreshold(1);
+    m_Controller->Interpolate();
+    mitk::Surface::Pointer compactSupportResult = m_Controller->GetInterpolationResult();
+
+    m_Controller->SetCompactSupportContourThreshold(defaultThreshold);
+    m_Controller->RemoveInterpolationSession(segmentation);
+
+    CPPUNIT_ASSERT_MESSAGE("No dense interpolation result",
+                           denseResult.IsNotNull() && denseResult->GetVtkPolyData()->GetNumberOfPoints() > 0);
+    CPPUNIT_ASSERT_MESSAGE("No compactly supported interpolation result",
+                           compactSupportResult.IsNotNull() &&
+                             compactSupportResult->GetVtkPolyData()->GetNumberOfPoints() > 0);
+
+    // The compactly supported interpolation only approximates the dense one, both must enclose the same sphere
+    double denseBounds[6];
+    double compactSupportBounds[6];
+    denseResult->GetVtkPolyData()->GetBounds(denseBounds);
+    compactSupportResult->GetVtkPolyData()->GetBounds(compactSupportBounds);
+    for (int i = 0; i < 6; ++i)
+    {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Bounds of the interpolation results differ",
+                                           denseBounds[i], compactSupportBounds[i], 2.0);
+    }
+  }
+
   void TestSetCurrentInterpolationSession4D()
   {
     /*unsigned int testDimensions[] = {10, 10, 10, 5};
@@ -20,9 +20,58 @@ found in the LICENSE file.
 #include "vtkSmartPointer.h"
 
 #include "itkImageRegionIteratorWithIndex.h"
-#include "itkNeighborhoodIterator.h"
+#include "itkMultiThreader.h"
 
-#include <queue>
+#include <Eigen/IterativeLinearSolvers>
+#include <Eigen/SparseCholesky>
+
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <set>
+#include <thread>
+
+namespace
+{
+  // Calls function(begin, end) for consecutive ranges of [0, count) in up to numberOfThreads threads
+  void ParallelFor(std::size_t count,
+                   unsigned int numberOfThreads,
+                   const std::function<void(std::size_t, std::size_t)> &function)
+  {
+    if (numberOfThreads == 0)
+      numberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+
+    // Small amounts of work are not worth starting threads for
+    const std::size_t minimumPerThread = 64;
+    std::size_t threads = std::max<std::size_t>(1, std::min<std::size_t>(numberOfThreads, count / minimumPerThread));
+
+    if (threads == 1)
+    {
+      function(0, count);
+      return;
+    }
+
+    std::vector<std::thread> workers;
+    std::size_t chunkSize = (count + threads - 1) / threads;
+    for (std::size_t begin = chunkSize; begin < count; begin += chunkSize)
+      workers.emplace_back(function, begin, std::min(begin + chunkSize, count));
+    function(0, std::min(chunkSize, count));
+
+    for (auto &worker : workers)
+      worker.join();
+  }
+
+  // Wendland's compactly supported function, positive definite in 3D
+  inline double WendlandPhi(double r, double supportRadius)
+  {
+    double q = r / supportRadius;
+    if (q >= 1.0)
+      return 0.0;
+    double oneMinusQ = 1.0 - q;
+    oneMinusQ *= oneMinusQ;
+    return oneMinusQ * oneMinusQ * (4.0 * q + 1.0);
+  }
+}
 
 void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 {
@@ -105,7 +154,13 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 }
 
 mitk::CreateDistanceImageFromSurfaceFilter::CreateDistanceImageFromSurfaceFilter()
-  : m_DistanceImageSpacing(0.0), m_DistanceImageDefaultBufferValue(0.0)
+  : m_UseCompactSupport(false),
+    m_SupportRadius(0.0),
+    m_CurrentSupportRadius(0.0),
+    m_BandRadius(0.0),
+    m_NumberOfThreads(0),
+    m_DistanceImageSpacing(0.0),
+    m_DistanceImageDefaultBufferValue(0.0)
 {
   m_DistanceImageVolume = 50000;
   this->m_UseProgressBar = false;
@@ -130,7 +185,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(1);
 
-  m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+  this->SolveEquationSystem();
 
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(2);
@@ -143,6 +198,41 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
 
   m_Centers.clear();
   m_Normals.clear();
+  m_ContourIndices.clear();
+  m_CenterGrid.clear();
+  m_ContourPointGrid.clear();
+  m_SparseSolutionMatrix.resize(0, 0);
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::SolveEquationSystem()
+{
+  if (!m_UseCompactSupport)
+  {
+    m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+
+    m_CenterMatrix.resize(3, m_Centers.size());
+    for (unsigned int i = 0; i < m_Centers.size(); ++i)
+    {
+      m_CenterMatrix(0, i) = m_Centers[i][0];
+      m_CenterMatrix(1, i) = m_Centers[i][1];
+      m_CenterMatrix(2, i) = m_Centers[i][2];
+    }
+    return;
+  }
+
+  Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower | Eigen::Upper> conjugateGradient;
+  conjugateGradient.setTolerance(1e-10);
+  conjugateGradient.compute(m_SparseSolutionMatrix);
+  m_Weights = conjugateGradient.solve(m_FunctionValues);
+
+  if (conjugateGradient.info() != Eigen::Success)
+  {
+    MITK_WARN << "mitk::CreateDistanceImageFromSurfaceFilter: Conjugate gradient did not converge after "
+              << conjugateGradient.iterations() << " iterations (error " << conjugateGradient.error()
+              << "), solving the equation system directly.";
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> ldlt(m_SparseSolutionMatrix);
+    m_Weights = ldlt.solve(m_FunctionValues);
+  }
 }
 
 void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
@@ -168,6 +258,9 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
   PointType currentPoint;
   PointType normal;
 
+  // Already added points, to eliminate duplicates without searching m_Centers
+  std::set<std::array<double, 3>> addedPoints;
+
   for (unsigned int i = 0; i < numberOfInputs; i++)
   {
     auto currentSurface = this->GetInput(i);
@@ -199,9 +292,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
 
         currentPoint.copy_in(p);
 
-        int count = std::count(m_Centers.begin(), m_Centers.end(), currentPoint);
-
-        if (count == 0)
+        if (addedPoints.insert({{p[0], p[1], p[2]}}).second)
         {
           double currentNormal[3];
           currentCellNormals->GetTuple(cell[j], currentNormal);
@@ -211,6 +302,8 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
           m_Normals.push_back(normal);
 
           m_Centers.push_back(currentPoint);
+
+          m_ContourIndices.push_back(i);
         }
 
       } // end for all points
@@ -262,6 +355,12 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunction
   }
 
   // Now we have created all centers and all function values. Next step is to create the solution matrix
+  if (m_UseCompactSupport)
+  {
+    this->CreateSparseSolutionMatrix();
+    return;
+  }
+
   numberOfCenters = m_Centers.size();
 
   m_SolutionMatrix.resize(numberOfCenters, numberOfCenters);
@@ -286,6 +385,176 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunction
   }
 }
 
+double mitk::CreateDistanceImageFromSurfaceFilter::EstimateLargestContourGap() const
+{
+  // Only the contour points are considered, not the inner and outer points
+  const std::size_t numberOfContourPoints = m_ContourIndices.size();
+  if (numberOfContourPoints == 0)
+    return 0.0;
+
+  // Sort the contour points into a grid with about one point per cell and search the cells in growing
+  // shells around each point, until no closer point of another contour can be found
+  PointType minPoint = m_Centers[0];
+  PointType maxPoint = m_Centers[0];
+  for (std::size_t i = 1; i < numberOfContourPoints; ++i)
+  {
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      minPoint[dim] = std::min(minPoint[dim], m_Centers[i][dim]);
+      maxPoint[dim] = std::max(maxPoint[dim], m_Centers[i][dim]);
+    }
+  }
+  const double largestExtent = (maxPoint - minPoint).max_value();
+  const double cellSize =
+    std::max(largestExtent / std::cbrt(static_cast<double>(numberOfContourPoints)), m_DistanceImageSpacing);
+  const long maximumShell = static_cast<long>(std::ceil(largestExtent / cellSize)) + 1;
+
+  CenterGridType grid;
+  for (unsigned int i = 0; i < numberOfContourPoints; ++i)
+    grid[GetGridCell(m_Centers[i], cellSize)].push_back(i);
+
+  std::vector<double> nearestDistances(numberOfContourPoints, 0.0);
+
+  ParallelFor(numberOfContourPoints, m_NumberOfThreads, [&](std::size_t begin, std::size_t end) {
+    GridCellType neighborCell;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      const GridCellType cell = GetGridCell(m_Centers[i], cellSize);
+      double nearest = std::numeric_limits<double>::max();
+
+      for (long shell = 0; shell <= maximumShell; ++shell)
+      {
+        // Points in this shell are at least (shell - 1) cells away
+        if (shell > 0 && (shell - 1) * cellSize >= nearest)
+          break;
+
+        for (long dx = -shell; dx <= shell; ++dx)
+          for (long dy = -shell; dy <= shell; ++dy)
+            for (long dz = -shell; dz <= shell; ++dz)
+            {
+              if (std::max(std::abs(dx), std::max(std::abs(dy), std::abs(dz))) != shell)
+                continue;
+
+              neighborCell[0] = cell[0] + dx;
+              neighborCell[1] = cell[1] + dy;
+              neighborCell[2] = cell[2] + dz;
+              auto points = grid.find(neighborCell);
+              if (points == grid.end())
+                continue;
+
+              for (unsigned int j : points->second)
+              {
+                if (m_ContourIndices[j] != m_ContourIndices[i])
+                  nearest = std::min(nearest, (m_Centers[i] - m_Centers[j]).two_norm());
+              }
+            }
+      }
+      nearestDistances[i] = nearest == std::numeric_limits<double>::max() ? 0.0 : nearest;
+    }
+  });
+
+  double largestGap = 0.0;
+  for (double distance : nearestDistances)
+    largestGap = std::max(largestGap, distance);
+
+  return largestGap;
+}
+
+mitk::CreateDistanceImageFromSurfaceFilter::GridCellType mitk::CreateDistanceImageFromSurfaceFilter::GetGridCell(
+  const PointType &p, double cellSize)
+{
+  GridCellType cell;
+  for (unsigned int dim = 0; dim < 3; ++dim)
+    cell[dim] = static_cast<long>(std::floor(p[dim] / cellSize));
+  return cell;
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::CreateSparseSolutionMatrix()
+{
+  /*
+  * The interpolant of compactly supported functions decays to zero towards the border of the support, so far
+  * from the contours it is small in magnitude and may change its sign. Therefore the narrow band is restricted
+  * to pixels close to the contour points: at most half the largest gap between neighboring contours (which
+  * reaches the interpolated surface between them) plus the band width. The default support radius is four times
+  * this distance, so the band stays in the inner quarter of the support, where the interpolant follows the
+  * off-surface constraints and only changes its sign at the surface.
+  */
+  const double largestGap = this->EstimateLargestContourGap();
+  const double bandRadius = 0.5 * largestGap + 2.0 * m_DistanceImageSpacing;
+  m_CurrentSupportRadius = m_SupportRadius > 0 ? m_SupportRadius : 4.0 * bandRadius;
+  m_BandRadius = std::min(bandRadius, 0.25 * m_CurrentSupportRadius);
+  MITK_DEBUG << "Support radius of the compactly supported RBF: " << m_CurrentSupportRadius
+             << ", band radius: " << m_BandRadius;
+
+  m_ContourPointGrid.clear();
+  for (unsigned int i = 0; i < m_ContourIndices.size(); ++i)
+    m_ContourPointGrid[GetGridCell(m_Centers[i], m_BandRadius)].push_back(i);
+
+  // As the cells are as large as the support radius, all centers within the support of a point are
+  // found in the cell of the point and its 26 neighbors
+  m_CenterGrid.clear();
+  for (unsigned int i = 0; i < m_Centers.size(); ++i)
+    m_CenterGrid[GetGridCell(m_Centers[i], m_CurrentSupportRadius)].push_back(i);
+
+  const unsigned int numberOfCenters = m_Centers.size();
+  std::vector<Eigen::Triplet<double>> entries;
+  entries.reserve(numberOfCenters * 27);
+
+  for (unsigned int i = 0; i < numberOfCenters; ++i)
+  {
+    GridCellType cell = GetGridCell(m_Centers[i], m_CurrentSupportRadius);
+    GridCellType neighborCell;
+    for (long dx = -1; dx <= 1; ++dx)
+      for (long dy = -1; dy <= 1; ++dy)
+        for (long dz = -1; dz <= 1; ++dz)
+        {
+          neighborCell[0] = cell[0] + dx;
+          neighborCell[1] = cell[1] + dy;
+          neighborCell[2] = cell[2] + dz;
+          auto neighbors = m_CenterGrid.find(neighborCell);
+          if (neighbors == m_CenterGrid.end())
+            continue;
+
+          for (unsigned int j : neighbors->second)
+          {
+            double phi = WendlandPhi((m_Centers[i] - m_Centers[j]).two_norm(), m_CurrentSupportRadius);
+            if (phi > 0)
+              entries.push_back(Eigen::Triplet<double>(i, j, phi));
+          }
+        }
+  }
+
+  m_SparseSolutionMatrix.resize(numberOfCenters, numberOfCenters);
+  m_SparseSolutionMatrix.setFromTriplets(entries.begin(), entries.end());
+  m_Weights.resize(numberOfCenters);
+}
+
+bool mitk::CreateDistanceImageFromSurfaceFilter::IsWithinCompactBand(const PointType &p) const
+{
+  const double squaredBandRadius = m_BandRadius * m_BandRadius;
+
+  GridCellType cell = GetGridCell(p, m_BandRadius);
+  GridCellType neighborCell;
+  for (long dx = -1; dx <= 1; ++dx)
+    for (long dy = -1; dy <= 1; ++dy)
+      for (long dz = -1; dz <= 1; ++dz)
+      {
+        neighborCell[0] = cell[0] + dx;
+        neighborCell[1] = cell[1] + dy;
+        neighborCell[2] = cell[2] + dz;
+        auto points = m_ContourPointGrid.find(neighborCell);
+        if (points == m_ContourPointGrid.end())
+          continue;
+
+        for (unsigned int i : points->second)
+        {
+          if ((p - m_Centers[i]).squared_magnitude() <= squaredBandRadius)
+            return true;
+        }
+      }
+  return false;
+}
+
 void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
 {
   /*
@@ -300,11 +569,13 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   */
 
   typedef itk::ImageRegionIteratorWithIndex<DistanceImageType> ImageIterator;
-  typedef itk::NeighborhoodIterator<DistanceImageType> NeighborhoodImageIterator;
 
-  std::queue<DistanceImageType::IndexType> narrowbandPoints;
   PointType currentPoint = m_Centers.at(0);
-  double distance = this->CalculateDistanceValue(currentPoint);
+  double distance = 0.0;
+  if (m_UseCompactSupport)
+    this->CalculateCompactDistanceValue(currentPoint, distance);
+  else
+    distance = this->CalculateDistanceValue(currentPoint);
 
   // create itk::Point from vnl_vector
   DistanceImageType::PointType currentPointAsPoint;
@@ -316,49 +587,82 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   DistanceImageType::IndexType currentIndex;
   m_DistanceImageITK->TransformPhysicalPointToIndex(currentPointAsPoint, currentIndex);
 
-  assert(
-    m_DistanceImageITK->GetLargestPossibleRegion().IsInside(currentIndex)); // we are quite certain this should hold
+  const DistanceImageType::RegionType region = m_DistanceImageITK->GetLargestPossibleRegion();
+  assert(region.IsInside(currentIndex)); // we are quite certain this should hold
 
-  narrowbandPoints.push(currentIndex);
   m_DistanceImageITK->SetPixel(currentIndex, distance);
 
-  NeighborhoodImageIterator::RadiusType radius;
-  radius.Fill(1);
-  NeighborhoodImageIterator nIt(radius, m_DistanceImageITK, m_DistanceImageITK->GetLargestPossibleRegion());
-  unsigned int relativeNbIdx[] = {4, 10, 12, 14, 16, 22};
+  /*
+  * The narrow band grows in waves: all not yet visited 6-neighbors of the current wave are evaluated in
+  * parallel, those within the band form the next wave. This visits the same pixels as growing pixel by pixel.
+  */
+  std::vector<bool> visited(region.GetNumberOfPixels(), false);
+  visited[m_DistanceImageITK->ComputeOffset(currentIndex)] = true;
 
-  bool isInBounds = false;
-  while (!narrowbandPoints.empty())
-  {
-    nIt.SetLocation(narrowbandPoints.front());
-    narrowbandPoints.pop();
+  std::vector<DistanceImageType::IndexType> wave(1, currentIndex);
+  std::vector<DistanceImageType::IndexType> candidates;
+  std::vector<double> candidateDistances;
+  std::vector<char> candidateInBand;
 
-    unsigned int *relativeNb = &relativeNbIdx[0];
-    for (int i = 0; i < 6; i++)
+  while (!wave.empty())
+  {
+    candidates.clear();
+    for (const auto &index : wave)
     {
-      nIt.GetPixel(*relativeNb, isInBounds);
-      if (isInBounds && nIt.GetPixel(*relativeNb) == m_DistanceImageDefaultBufferValue)
+      for (unsigned int dim = 0; dim < 3; ++dim)
       {
-        currentIndex = nIt.GetIndex(*relativeNb);
-
-        // Transform the currently checked point from index-coordinates to
-        // world-coordinates
-        m_DistanceImageITK->TransformIndexToPhysicalPoint(currentIndex, currentPointAsPoint);
+        for (int step = -1; step <= 1; step += 2)
+        {
+          DistanceImageType::IndexType neighbor = index;
+          neighbor[dim] += step;
+          if (!region.IsInside(neighbor))
+            continue;
+
+          auto offset = m_DistanceImageITK->ComputeOffset(neighbor);
+          if (!visited[offset])
+          {
+            visited[offset] = true;
+            candidates.push_back(neighbor);
+          }
+        }
+      }
+    }
 
-        // create a vnl_vector
-        currentPoint[0] = currentPointAsPoint[0];
-        currentPoint[1] = currentPointAsPoint[1];
-        currentPoint[2] = currentPointAsPoint[2];
+    candidateDistances.resize(candidates.size());
+    candidateInBand.resize(candidates.size());
+    ParallelFor(candidates.size(), m_NumberOfThreads, [&](std::size_t begin, std::size_t end) {
+      DistanceImageType::PointType candidatePointAsPoint;
+      PointType candidatePoint;
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        // Transform the currently checked point from index-coordinates to world-coordinates
+        m_DistanceImageITK->TransformIndexToPhysicalPoint(candidates[i], candidatePointAsPoint);
+        candidatePoint[0] = candidatePointAsPoint[0];
+        candidatePoint[1] = candidatePointAsPoint[1];
+        candidatePoint[2] = candidatePointAsPoint[2];
 
         // and check the distance
-        distance = this->CalculateDistanceValue(currentPoint);
-        if (std::fabs(distance) <= m_DistanceImageSpacing * 2)
-        {
-          nIt.SetPixel(*relativeNb, distance);
-          narrowbandPoints.push(currentIndex);
-        }
+        double candidateDistance = 0.0;
+        bool supported = true;
+        if (m_UseCompactSupport)
+          supported = this->IsWithinCompactBand(candidatePoint) &&
+                      this->CalculateCompactDistanceValue(candidatePoint, candidateDistance);
+        else
+          candidateDistance = this->CalculateDistanceValue(candidatePoint);
+
+        candidateDistances[i] = candidateDistance;
+        candidateInBand[i] = supported && std::fabs(candidateDistance) <= m_DistanceImageSpacing * 2;
+      }
+    });
+
+    wave.clear();
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+    {
+      if (candidateInBand[i])
+      {
+        m_DistanceImageITK->SetPixel(candidates[i], candidateDistances[i]);
+        wave.push_back(candidates[i]);
       }
-      relativeNb++;
     }
   }
 
@@ -419,25 +723,43 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   CastToMitkImage(m_DistanceImageITK, resultImage);
 }
 
-double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(PointType p)
+double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(const PointType &p) const
 {
-  double distanceValue(0);
-  PointType p1;
-  PointType p2;
-  double norm;
-
-  CenterList::iterator centerIter;
+  // Sum of the weighted euclidian distances to all centers
+  const Eigen::Vector3d point(p[0], p[1], p[2]);
+  return (m_CenterMatrix.colwise() - point).colwise().norm().dot(m_Weights);
+}
 
-  unsigned int count(0);
-  for (centerIter = m_Centers.begin(); centerIter != m_Centers.end(); centerIter++)
-  {
-    p1 = *centerIter;
-    p2 = p - p1;
-    norm = p2.two_norm();
-    distanceValue = distanceValue + (norm * m_Weights[count]);
-    ++count;
-  }
-  return distanceValue;
+bool mitk::CreateDistanceImageFromSurfaceFilter::CalculateCompactDistanceValue(const PointType &p,
+                                                                               double &distanceValue) const
+{
+  distanceValue = 0.0;
+  bool supported = false;
+
+  GridCellType cell = GetGridCell(p, m_CurrentSupportRadius);
+  GridCellType neighborCell;
+  for (long dx = -1; dx <= 1; ++dx)
+    for (long dy = -1; dy <= 1; ++dy)
+      for (long dz = -1; dz <= 1; ++dz)
+      {
+        neighborCell[0] = cell[0] + dx;
+        neighborCell[1] = cell[1] + dy;
+        neighborCell[2] = cell[2] + dz;
+        auto centers = m_CenterGrid.find(neighborCell);
+        if (centers == m_CenterGrid.end())
+          continue;
+
+        for (unsigned int i : centers->second)
+        {
+          double phi = WendlandPhi((p - m_Centers[i]).two_norm(), m_CurrentSupportRadius);
+          if (phi > 0)
+          {
+            distanceValue += phi * m_Weights[i];
+            supported = true;
+          }
+        }
+      }
+  return supported;
 }
 
 void mitk::CreateDistanceImageFromSurfaceFilter::GenerateOutputInformation()
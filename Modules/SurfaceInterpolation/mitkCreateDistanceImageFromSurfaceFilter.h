@@ -24,6 +24,10 @@ found in the LICENSE file.
 #include "itkImageBase.h"
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include <array>
+#include <map>
 
 namespace mitk
 {
@@ -120,6 +124,39 @@ namespace mitk
 
     void SetReferenceImage(itk::ImageBase<3>::Pointer referenceImage);
 
+    /**
+    \brief Use a compactly supported radial basis function instead of Phi(r) = r.
+
+    By default, the dense equation system with one row for each center (three for each contour point) is solved
+    directly and the distance of every evaluated pixel is calculated from all centers, which gets slow for many
+    contours. With compact support, Wendland's function Phi(r) = (1 - r/s)^4 * (4r/s + 1) for r < s (0 otherwise)
+    is used. The equation system is then sparse and positive definite and is solved by the conjugate gradient
+    method, and each pixel only evaluates the centers within the support radius s. Only pixels close to the
+    contour points (half the largest gap between neighboring contours plus the band width, at most s/4) are
+    evaluated, because the interpolant decays towards zero farther away. The result approximates the one of the
+    dense interpolation, so this mode is off by default.
+    */
+    itkSetMacro(UseCompactSupport, bool);
+    itkGetMacro(UseCompactSupport, bool);
+    itkBooleanMacro(UseCompactSupport);
+
+    /**
+    \brief Set the support radius s (in mm) of the compactly supported radial basis function.
+
+    If it is 0 (default), twice the largest distance between a contour point and the closest point of another
+    contour plus eight times the spacing of the distance image is used, so that the gaps between neighboring
+    contours are bridged and the narrow band lies in the inner quarter of the support.
+    */
+    itkSetMacro(SupportRadius, double);
+    itkGetMacro(SupportRadius, double);
+
+    /**
+    \brief Set the number of threads that evaluate the distance function. If it is 0 (default), the global
+           default number of ITK threads is used.
+    */
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetMacro(NumberOfThreads, unsigned int);
+
   protected:
     CreateDistanceImageFromSurfaceFilter();
     ~CreateDistanceImageFromSurfaceFilter() override;
@@ -127,8 +164,31 @@ namespace mitk
     void GenerateOutputInformation() override;
 
   private:
+    typedef std::array<long, 3> GridCellType;
+    typedef std::map<GridCellType, std::vector<unsigned int>> CenterGridType;
+
     void CreateSolutionMatrixAndFunctionValues();
-    double CalculateDistanceValue(PointType p);
+    void CreateSparseSolutionMatrix();
+    void SolveEquationSystem();
+    double CalculateDistanceValue(const PointType &p) const;
+
+    /**
+    \brief Calculates the distance value with the compactly supported radial basis function.
+            Returns false if no center lies within the support radius of p.
+    */
+    bool CalculateCompactDistanceValue(const PointType &p, double &distanceValue) const;
+
+    /**
+    \brief The largest distance between a contour point and the closest point of another contour.
+    */
+    double EstimateLargestContourGap() const;
+
+    /**
+    \brief Whether a contour point lies within the band radius of p (compact support only).
+    */
+    bool IsWithinCompactBand(const PointType &p) const;
+
+    static GridCellType GetGridCell(const PointType &p, double cellSize);
 
     void FillDistanceImage();
 
@@ -157,11 +217,28 @@ namespace mitk
     // Datastructures for the interpolation
     CenterList m_Centers;
     NormalList m_Normals;
+    std::vector<unsigned int> m_ContourIndices; // index of the input of each contour point
 
     Eigen::MatrixXd m_SolutionMatrix;
+    Eigen::SparseMatrix<double> m_SparseSolutionMatrix;
     Eigen::VectorXd m_FunctionValues;
     Eigen::VectorXd m_Weights;
 
+    // Centers as matrix columns for the evaluation with Phi(r) = r
+    Eigen::Matrix3Xd m_CenterMatrix;
+
+    // Centers sorted into cubic cells with the edge length of the support radius (compact support only)
+    CenterGridType m_CenterGrid;
+
+    // Contour points sorted into cubic cells with the edge length of the band radius (compact support only)
+    CenterGridType m_ContourPointGrid;
+
+    bool m_UseCompactSupport;
+    double m_SupportRadius;
+    double m_CurrentSupportRadius;
+    double m_BandRadius;
+    unsigned int m_NumberOfThreads;
+
     DistanceImageType::Pointer m_DistanceImageITK;
     itk::ImageBase<3>::Pointer m_ReferenceImage;
 
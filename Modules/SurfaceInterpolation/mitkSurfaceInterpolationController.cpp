@@ -97,6 +97,8 @@ mitk::SurfaceInterpolationController::SurfaceInterpolationController()
 
   m_InterpolationResult = nullptr;
   m_CurrentNumberOfReducedContours = 0;
+  // the dense equation system gets slow for interactive use above about as many contours
+  m_CompactSupportContourThreshold = 50;
 }
 
 mitk::SurfaceInterpolationController::~SurfaceInterpolationController()
@@ -296,6 +298,9 @@ void mitk::SurfaceInterpolationController::Interpolate()
     return;
   }
 
+  m_InterpolateSurfaceFilter->SetUseCompactSupport(m_CompactSupportContourThreshold > 0 &&
+                                                   m_CurrentNumberOfReducedContours > m_CompactSupportContourThreshold);
+
   // Setting up progress bar
   mitk::ProgressBar::GetInstance()->AddStepsToDo(10);
 
@@ -359,6 +364,16 @@ void mitk::SurfaceInterpolationController::SetDistanceImageVolume(unsigned int d
   m_InterpolateSurfaceFilter->SetDistanceImageVolume(distImgVolume);
 }
 
+void mitk::SurfaceInterpolationController::SetCompactSupportContourThreshold(unsigned int threshold)
+{
+  m_CompactSupportContourThreshold = threshold;
+}
+
+unsigned int mitk::SurfaceInterpolationController::GetCompactSupportContourThreshold() const
+{
+  return m_CompactSupportContourThreshold;
+}
+
 mitk::Image::Pointer mitk::SurfaceInterpolationController::GetCurrentSegmentation()
 {
   return m_SelectedSegmentation;
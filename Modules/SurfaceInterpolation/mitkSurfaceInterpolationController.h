@@ -140,6 +140,16 @@ namespace mitk
      */
     void SetDistanceImageVolume(unsigned int distImageVolume);
 
+    /**
+     * Sets the number of contours above which the interpolation uses compactly supported
+     * radial basis functions (see CreateDistanceImageFromSurfaceFilter::SetUseCompactSupport()).
+     * The dense equation system becomes too slow for interactive use with many contours, but the compactly
+     * supported interpolation only approximates its result. Default is 50, 0 disables the compact support.
+     */
+    void SetCompactSupportContourThreshold(unsigned int threshold);
+
+    unsigned int GetCompactSupportContourThreshold() const;
+
     /**
      * @brief Get the current selected segmentation for which the interpolation is performed
      * @return the current segmentation image
@@ -240,6 +250,8 @@ namespace mitk
 
     unsigned int m_CurrentNumberOfReducedContours;
 
+    unsigned int m_CompactSupportContourThreshold;
+
     mitk::Image *m_SelectedSegmentation;
 
     std::map<mitk::Image *, unsigned long> m_SegmentationObserverTags;
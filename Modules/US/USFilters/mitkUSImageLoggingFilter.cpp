@@ -22,7 +22,9 @@ found in the LICENSE file.
 
 
 mitk::USImageLoggingFilter::USImageLoggingFilter() : m_SystemTimeClock(RealTimeClock::New()),
-                                                     m_ImageExtension(".nrrd")
+                                                     m_ImageExtension(".nrrd"),
+                                                     m_StreamRecordingWriter(nullptr),
+                                                     m_LastStreamedImage(-1)
 {
 }
 
@@ -41,6 +43,14 @@ void mitk::USImageLoggingFilter::GenerateData()
     return;
     }
 
+  //the writer serializes the image, so no clone is kept in memory
+  if (m_StreamRecordingWriter.IsNotNull() && m_StreamRecordingWriter->IsOpen())
+    {
+    m_LastStreamedImage = static_cast<long>(
+      m_StreamRecordingWriter->AddImage(inputImage, m_SystemTimeClock->GetCurrentStamp()));
+    return;
+    }
+
   //a clone is needed for a output and to store it.
   mitk::Image::Pointer inputClone = inputImage->Clone();
 
@@ -79,6 +89,13 @@ void mitk::USImageLoggingFilter::GenerateData()
 
 void mitk::USImageLoggingFilter::AddMessageToCurrentImage(std::string message)
 {
+  if (m_StreamRecordingWriter.IsNotNull() && m_StreamRecordingWriter->IsOpen())
+    {
+    if (m_LastStreamedImage >= 0)
+      m_StreamRecordingWriter->AddMessage(static_cast<unsigned long>(m_LastStreamedImage), message,
+                                          m_SystemTimeClock->GetCurrentStamp());
+    return;
+    }
   m_LoggedMessages.insert(std::make_pair(static_cast<int>(m_LoggedImages.size()-1),message));
 }
 
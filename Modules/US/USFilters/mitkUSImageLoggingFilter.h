@@ -17,6 +17,7 @@ found in the LICENSE file.
 #include <MitkUSExports.h>
 #include <mitkImageToImageFilter.h>
 #include <mitkRealTimeClock.h>
+#include <mitkStreamRecordingWriter.h>
 
 
 namespace mitk {
@@ -25,6 +26,10 @@ namespace mitk {
    *  add messages. All data (images, timestamps and messages) is written to the harddisc when
    *  the method SaveImages(...) is called.
    *
+   *  If a mitk::StreamRecordingWriter is set and open, the images and messages are appended to the
+   *  writer's file instead and are not kept in memory. SaveImages(...) only writes the images which
+   *  were logged while no writer was open.
+   *
    *  Caution: only supports logging of one input at the moment, multiple inputs are ignored!
    *
    *  \ingroup US
@@ -72,6 +77,13 @@ namespace mitk {
      */
     bool SetImageFilesExtension(std::string extension);
 
+    /** Sets a writer which streams the logged images and messages to a file. The writer has to be opened
+     *  and closed by the caller and may be shared with a mitk::NavigationDataRecorder. Set to nullptr to
+     *  log into memory again.
+     */
+    itkSetObjectMacro(StreamRecordingWriter, mitk::StreamRecordingWriter);
+    itkGetObjectMacro(StreamRecordingWriter, mitk::StreamRecordingWriter);
+
 
   protected:
     USImageLoggingFilter();
@@ -85,6 +97,9 @@ namespace mitk {
     std::vector<double> m_LoggedMITKSystemTimes; ///< Logged system times for every logged image
     std::string m_ImageExtension; ///< stores the image extension, default is ".nrrd"
 
+    mitk::StreamRecordingWriter::Pointer m_StreamRecordingWriter; ///< if set and open, images are streamed to its file
+    long m_LastStreamedImage; ///< index of the last image passed to m_StreamRecordingWriter, -1 if there is none
+
   };
 } // namespace mitk
 #endif /* MITKUSImageSource_H_HEADER_INCLUDED_ */
@@ -261,6 +261,12 @@ void QmitkImageStatisticsView::CalculateOrGetStatistics()
     this->m_selectedPlanarFigure = nullptr;
   }
 
+  if (this->m_ObservedMask)
+  {
+    m_StatisticsManager.StopObservingMask(this->m_ObservedMask);
+    this->m_ObservedMask = nullptr;
+  }
+
   m_Controls.groupBox_intensityProfile->setVisible(false);
   m_Controls.widget_statistics->setEnabled(m_selectedImageNode.IsNotNull());
 
@@ -294,6 +300,14 @@ void QmitkImageStatisticsView::CalculateOrGetStatistics()
     if (mask)
     {
       imageStatistics = mitk::ImageStatisticsContainerManager::GetImageStatistics(this->GetDataStorage(), image, mask);
+
+      // slices changed by the segmentation tools (or their undo) only update the statistics of these slices,
+      // incremental statistics do not support ignoring zero valued voxels
+      if (!this->m_CalculationJob->GetIgnoreZeroValueVoxel())
+      {
+        m_StatisticsManager.ObserveMask(this->GetDataStorage(), image, mask);
+        this->m_ObservedMask = mask;
+      }
     }
     else if (maskPlanarFigure)
     {
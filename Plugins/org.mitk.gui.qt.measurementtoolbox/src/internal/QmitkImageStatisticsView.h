@@ -19,6 +19,7 @@ found in the LICENSE file.
 #include <QmitkAbstractView.h>
 #include <QmitkImageStatisticsCalculationJob.h>
 #include <mitkImageStatisticsContainer.h>
+#include <mitkImageStatisticsContainerManager.h>
 
 #include <mitkILifecycleAwarePart.h>
 #include <berryIPartListener.h>
@@ -116,5 +117,9 @@ private:
   mitk::PlanarFigure::Pointer m_selectedPlanarFigure=nullptr;
   long m_PlanarFigureObserverTag;
   bool m_ForceRecompute = false;
+
+  /** Updates the statistics of the selected mask for the slices changed by the segmentation tools. */
+  mitk::ImageStatisticsContainerManager m_StatisticsManager;
+  const mitk::Image *m_ObservedMask = nullptr;
 };
 #endif // QmitkImageStatisticsView_H__INCLUDED